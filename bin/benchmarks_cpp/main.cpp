@@ -0,0 +1,523 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/Api.h>
+#include <aws/crt/JsonObject.h>
+#include <aws/crt/auth/Credentials.h>
+#include <aws/crt/auth/Sigv4Signing.h>
+#include <aws/crt/crypto/HMAC.h>
+#include <aws/crt/crypto/Hash.h>
+#include <aws/crt/http/HttpRequestResponse.h>
+#include <aws/crt/io/HostResolver.h>
+#include <aws/crt/io/Stream.h>
+#include <aws/crt/mqtt/MqttClient.h>
+#include <aws/crt/mqtt/TopicRouter.h>
+
+#include <aws/common/clock.h>
+#include <aws/common/command_line_parser.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+using namespace Aws::Crt;
+
+/*
+ * Microbenchmarks of the hot paths of the C++ wrappers. Every input is generated from fixed values, so two runs of
+ * the same build do the same work, and results can be compared between builds with --json.
+ */
+
+/* Runs iterations operations, returns false if one failed. */
+using BenchmarkBody = std::function<bool(uint64_t iterations)>;
+
+struct Benchmark
+{
+    const char *Name;
+    /* bytes processed by one operation, zero if throughput in bytes means nothing for it */
+    uint64_t BytesPerOp;
+    /* 0 for no limit; operations that queue work and cannot undo it stop here */
+    uint64_t MaxIterations;
+    BenchmarkBody Body;
+};
+
+struct BenchmarkResult
+{
+    String Name;
+    uint64_t Iterations = 0;
+    uint64_t ElapsedNs = 0;
+    uint64_t BytesPerOp = 0;
+    bool Failed = false;
+};
+
+struct BenchmarkCtx
+{
+    Allocator *allocator = nullptr;
+    const char *Filter = nullptr;
+    const char *JsonFile = nullptr;
+    uint64_t MinTimeMs = 500;
+    bool List = false;
+};
+
+static void s_Usage(int exit_code)
+{
+    std::cerr << "usage: benchmarks_cpp [options]\n";
+    std::cerr << "\n Options:\n\n";
+    std::cerr << "  -f, --filter STRING: only run benchmarks whose name contains STRING.\n";
+    std::cerr << "  -m, --min-time INT: milliseconds each benchmark runs for at least. Default is 500.\n";
+    std::cerr << "  -j, --json FILE: also write the results to FILE as JSON.\n";
+    std::cerr << "  -l, --list: list the benchmarks and quit.\n";
+    std::cerr << "  -h, --help\n";
+    std::cerr << "            Display this message and quit.\n";
+    exit(exit_code);
+}
+
+static struct aws_cli_option s_LongOptions[] = {
+    {"filter", AWS_CLI_OPTIONS_REQUIRED_ARGUMENT, nullptr, 'f'},
+    {"min-time", AWS_CLI_OPTIONS_REQUIRED_ARGUMENT, nullptr, 'm'},
+    {"json", AWS_CLI_OPTIONS_REQUIRED_ARGUMENT, nullptr, 'j'},
+    {"list", AWS_CLI_OPTIONS_NO_ARGUMENT, nullptr, 'l'},
+    {"help", AWS_CLI_OPTIONS_NO_ARGUMENT, nullptr, 'h'},
+    /* Per getopt(3) the last element of the array has to be filled with all zeros */
+    {nullptr, AWS_CLI_OPTIONS_NO_ARGUMENT, nullptr, 0},
+};
+
+static void s_ParseOptions(int argc, char **argv, BenchmarkCtx &ctx)
+{
+    while (true)
+    {
+        int option_index = 0;
+        int c = aws_cli_getopt_long(argc, argv, "f:m:j:lh", s_LongOptions, &option_index);
+        if (c == -1)
+        {
+            /* finished parsing */
+            break;
+        }
+
+        switch (c)
+        {
+            case 0:
+                /* getopt_long() returns 0 if an option.flag is non-null */
+                break;
+            case 'f':
+                ctx.Filter = aws_cli_optarg;
+                break;
+            case 'm':
+                ctx.MinTimeMs = static_cast<uint64_t>(atoll(aws_cli_optarg));
+                break;
+            case 'j':
+                ctx.JsonFile = aws_cli_optarg;
+                break;
+            case 'l':
+                ctx.List = true;
+                break;
+            case 'h':
+                s_Usage(0);
+                break;
+            default:
+                std::cerr << "Unknown option\n";
+                s_Usage(1);
+        }
+    }
+}
+
+static uint64_t s_Now()
+{
+    uint64_t now = 0;
+    aws_high_res_clock_get_ticks(&now);
+    return now;
+}
+
+/* Doubles the iterations until a run lasts MinTimeMs, reports the last run. */
+static BenchmarkResult s_Run(const Benchmark &benchmark, const BenchmarkCtx &ctx)
+{
+    BenchmarkResult result;
+    result.Name = benchmark.Name;
+    result.BytesPerOp = benchmark.BytesPerOp;
+
+    const uint64_t minTimeNs = ctx.MinTimeMs * 1000000;
+    uint64_t iterations = 1;
+    while (true)
+    {
+        uint64_t start = s_Now();
+        if (!benchmark.Body(iterations))
+        {
+            result.Failed = true;
+            return result;
+        }
+        uint64_t elapsed = s_Now() - start;
+
+        result.Iterations = iterations;
+        result.ElapsedNs = elapsed;
+        bool capped = benchmark.MaxIterations != 0 && iterations * 2 > benchmark.MaxIterations;
+        if (elapsed >= minTimeNs || capped)
+        {
+            return result;
+        }
+
+        iterations *= 2;
+    }
+}
+
+static String s_MakeJsonDocument()
+{
+    std::ostringstream document;
+    document << "{\"requestId\":\"0c2a6f4e-19d8-4b5e-8f1a-7e3d2c1b0a99\",\"items\":[";
+    for (int i = 0; i < 32; ++i)
+    {
+        document << (i ? "," : "") << "{\"id\":" << i << ",\"name\":\"item-" << i
+                 << "\",\"price\":" << (i * 1.25) << ",\"tags\":[\"a\",\"b\",\"c\"],\"inStock\":"
+                 << (i % 2 ? "true" : "false") << "}";
+    }
+    document << "],\"next\":null}";
+    return document.str().c_str();
+}
+
+static Vector<uint8_t> s_MakePayload(size_t size)
+{
+    Vector<uint8_t> payload(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        payload[i] = static_cast<uint8_t>((i * 131 + 7) & 0xff);
+    }
+    return payload;
+}
+
+static std::shared_ptr<Http::HttpRequest> s_MakeRequest(Allocator *allocator)
+{
+    auto request = MakeShared<Http::HttpRequest>(allocator, allocator);
+    request->SetMethod(ByteCursorFromCString("GET"));
+    request->SetPath(ByteCursorFromCString("/bucket/key-0001?list-type=2&prefix=photos%2F2024"));
+
+    const char *headers[][2] = {
+        {"host", "examplebucket.s3.us-east-1.amazonaws.com"},
+        {"user-agent", "benchmarks_cpp"},
+        {"accept", "*/*"},
+        {"x-amz-content-sha256", "UNSIGNED-PAYLOAD"},
+        {"range", "bytes=0-1048575"},
+    };
+    for (const auto &header : headers)
+    {
+        Http::HttpHeader httpHeader;
+        httpHeader.name = ByteCursorFromCString(header[0]);
+        httpHeader.value = ByteCursorFromCString(header[1]);
+        request->AddHeader(httpHeader);
+    }
+    return request;
+}
+
+static void s_PrintResult(const BenchmarkResult &result)
+{
+    std::cout << std::left << std::setw(28) << result.Name;
+    if (result.Failed)
+    {
+        std::cout << "FAILED: " << aws_error_debug_str(LastError()) << std::endl;
+        return;
+    }
+
+    double nsPerOp = static_cast<double>(result.ElapsedNs) / static_cast<double>(result.Iterations);
+    std::cout << std::right << std::setw(12) << result.Iterations << " ops " << std::setw(12) << std::fixed
+              << std::setprecision(1) << nsPerOp << " ns/op " << std::setw(14) << std::setprecision(0)
+              << (1e9 / nsPerOp) << " ops/s";
+    if (result.BytesPerOp)
+    {
+        std::cout << std::setw(10) << std::setprecision(1)
+                  << (static_cast<double>(result.BytesPerOp) * 1e9 / nsPerOp / (1024 * 1024)) << " MiB/s";
+    }
+    std::cout << std::endl;
+}
+
+static bool s_WriteJson(const char *path, const Vector<BenchmarkResult> &results)
+{
+    Vector<JsonObject> entries;
+    for (const auto &result : results)
+    {
+        JsonObject entry;
+        entry.WithString("name", result.Name);
+        entry.WithBool("failed", result.Failed);
+        entry.WithInt64("iterations", static_cast<int64_t>(result.Iterations));
+        entry.WithInt64("elapsedNs", static_cast<int64_t>(result.ElapsedNs));
+        if (!result.Failed)
+        {
+            double nsPerOp = static_cast<double>(result.ElapsedNs) / static_cast<double>(result.Iterations);
+            entry.WithDouble("nsPerOp", nsPerOp);
+            if (result.BytesPerOp)
+            {
+                entry.WithDouble("bytesPerSecond", static_cast<double>(result.BytesPerOp) * 1e9 / nsPerOp);
+            }
+        }
+        entries.push_back(std::move(entry));
+    }
+
+    JsonObject document;
+    document.WithArray("benchmarks", std::move(entries));
+
+    std::ofstream output(path, std::ios::out | std::ios::trunc);
+    output << document.View().WriteReadable() << std::endl;
+    return output.good();
+}
+
+int main(int argc, char **argv)
+{
+    struct aws_allocator *allocator = aws_default_allocator();
+
+    BenchmarkCtx ctx;
+    ctx.allocator = allocator;
+    s_ParseOptions(argc, argv, ctx);
+
+    ApiHandle apiHandle(allocator);
+
+    /* inputs shared by the benchmarks */
+    const Vector<uint8_t> payload4k = s_MakePayload(4096);
+    const ByteCursor payload4kCursor = ByteCursorFromArray(payload4k.data(), payload4k.size());
+    const Vector<uint8_t> payload256 = s_MakePayload(256);
+    const ByteCursor payload256Cursor = ByteCursorFromArray(payload256.data(), payload256.size());
+    const ByteCursor hmacSecret = ByteCursorFromCString("wJalrXUtnFEMI/K7MDENG/bPxRfiCYEXAMPLEKEY");
+    const String jsonDocument = s_MakeJsonDocument();
+    const JsonObject jsonObject(jsonDocument);
+    const String streamContents(64 * 1024, 'x');
+
+    size_t base64Length = 0;
+    Base64ComputeEncodedLength(payload4k.size(), base64Length);
+    ByteBuf base64Output;
+    aws_byte_buf_init(&base64Output, allocator, base64Length);
+
+    Io::EventLoopGroup eventLoopGroup(1, allocator);
+    Io::DefaultHostResolver hostResolver(eventLoopGroup, 8, 30, allocator);
+    Io::ClientBootstrap bootstrap(eventLoopGroup, hostResolver, allocator);
+    Mqtt::MqttClient mqttClient(bootstrap, allocator);
+    Io::SocketOptions socketOptions;
+    /* never connected: publishes are queued, which is where the C++ side of Publish() ends anyway */
+    std::shared_ptr<Mqtt::MqttConnection> mqttConnection =
+        mqttClient ? mqttClient.NewConnection("localhost", 1883, socketOptions) : nullptr;
+
+    /* 64 routes, of which a message to devices/17/state/telemetry matches two */
+    auto router = MakeShared<Mqtt::TopicRouter>(allocator, allocator);
+    auto onMessage = [](Mqtt::MqttConnection &, StringView, const ByteCursor &, bool, Mqtt::QOS, bool) {};
+    for (int i = 0; i < 63; ++i)
+    {
+        String filter = "devices/" + String(std::to_string(i).c_str()) + "/+/telemetry";
+        router->AddRoute(StringView(filter.data(), filter.size()), onMessage);
+    }
+    router->AddRoute("devices/#", onMessage);
+
+    Auth::Sigv4HttpRequestSigner signer(allocator);
+    Auth::AwsSigningConfig signingConfig(allocator);
+    signingConfig.SetSigningTimepoint(DateTime(static_cast<uint64_t>(1700000000000ULL)));
+    signingConfig.SetRegion("us-east-1");
+    signingConfig.SetService("s3");
+    signingConfig.SetCredentials(MakeShared<Auth::Credentials>(
+        allocator,
+        ByteCursorFromCString("AKIDEXAMPLE"),
+        ByteCursorFromCString("wJalrXUtnFEMI/K7MDENG+bPxRfiCYEXAMPLEKEY"),
+        ByteCursorFromCString(""),
+        UINT64_MAX,
+        allocator));
+
+    Vector<Benchmark> benchmarks = {
+        {"base64_encode_4k",
+         payload4k.size(),
+         0,
+         [&](uint64_t iterations) {
+             for (uint64_t i = 0; i < iterations; ++i)
+             {
+                 base64Output.len = 0;
+                 if (!Base64Encode(payload4kCursor, base64Output))
+                 {
+                     return false;
+                 }
+             }
+             return true;
+         }},
+        {"sha256_4k",
+         payload4k.size(),
+         0,
+         [&](uint64_t iterations) {
+             Crypto::SHA256Digest digest;
+             for (uint64_t i = 0; i < iterations; ++i)
+             {
+                 if (!Crypto::ComputeSHA256(allocator, payload4kCursor, digest))
+                 {
+                     return false;
+                 }
+             }
+             return true;
+         }},
+        {"hmac_sha256_256",
+         payload256.size(),
+         0,
+         [&](uint64_t iterations) {
+             Crypto::SHA256HMACDigest digest;
+             for (uint64_t i = 0; i < iterations; ++i)
+             {
+                 if (!Crypto::ComputeSHA256HMAC(allocator, hmacSecret, payload256Cursor, digest))
+                 {
+                     return false;
+                 }
+             }
+             return true;
+         }},
+        {"json_parse",
+         jsonDocument.size(),
+         0,
+         [&](uint64_t iterations) {
+             for (uint64_t i = 0; i < iterations; ++i)
+             {
+                 JsonObject parsed(jsonDocument);
+                 if (!parsed.WasParseSuccessful())
+                 {
+                     return false;
+                 }
+             }
+             return true;
+         }},
+        {"json_write",
+         jsonDocument.size(),
+         0,
+         [&](uint64_t iterations) {
+             for (uint64_t i = 0; i < iterations; ++i)
+             {
+                 if (jsonObject.View().WriteCompact().empty())
+                 {
+                     return false;
+                 }
+             }
+             return true;
+         }},
+        {"stdio_stream_read_64k",
+         streamContents.size(),
+         0,
+         [&](uint64_t iterations) {
+             auto source = MakeShared<StringStream>(allocator, streamContents);
+             Io::StdIOStreamInputStream stream(source, allocator);
+             uint8_t chunk[16 * 1024];
+             for (uint64_t i = 0; i < iterations; ++i)
+             {
+                 if (!stream.Seek(0, Io::StreamSeekBasis::Begin))
+                 {
+                     return false;
+                 }
+                 for (size_t read = 0; read < streamContents.size();)
+                 {
+                     ByteBuf buffer = ByteBufFromEmptyArray(chunk, sizeof(chunk));
+                     if (!stream.Read(buffer) || buffer.len == 0)
+                     {
+                         return false;
+                     }
+                     read += buffer.len;
+                 }
+             }
+             return true;
+         }},
+        {"http_request_build",
+         0,
+         0,
+         [&](uint64_t iterations) {
+             for (uint64_t i = 0; i < iterations; ++i)
+             {
+                 if (!s_MakeRequest(allocator))
+                 {
+                     return false;
+                 }
+             }
+             return true;
+         }},
+        {"sigv4_sign_request",
+         0,
+         0,
+         [&](uint64_t iterations) {
+             for (uint64_t i = 0; i < iterations; ++i)
+             {
+                 auto request = s_MakeRequest(allocator);
+                 if (!signer.SignRequestNow(*request, signingConfig))
+                 {
+                     return false;
+                 }
+             }
+             return true;
+         }},
+        {"mqtt_publish_256",
+         payload256.size(),
+         1 << 17,
+         [&](uint64_t iterations) {
+             if (!mqttConnection)
+             {
+                 return false;
+             }
+             ByteBuf payload = ByteBufFromArray(payload256.data(), payload256.size());
+             for (uint64_t i = 0; i < iterations; ++i)
+             {
+                 if (mqttConnection->Publish(
+                         "devices/0001/state/telemetry", AWS_MQTT_QOS_AT_LEAST_ONCE, false, payload, nullptr) == 0)
+                 {
+                     return false;
+                 }
+             }
+             return true;
+         }},
+        {"mqtt_dispatch",
+         payload256.size(),
+         0,
+         [&](uint64_t iterations) {
+             if (!mqttConnection)
+             {
+                 return false;
+             }
+             for (uint64_t i = 0; i < iterations; ++i)
+             {
+                 if (router->Dispatch(
+                         *mqttConnection,
+                         "devices/17/state/telemetry",
+                         payload256Cursor,
+                         false,
+                         AWS_MQTT_QOS_AT_LEAST_ONCE,
+                         false) != 2)
+                 {
+                     return false;
+                 }
+             }
+             return true;
+         }},
+    };
+
+    Vector<BenchmarkResult> results;
+    for (const auto &benchmark : benchmarks)
+    {
+        if (ctx.Filter && !strstr(benchmark.Name, ctx.Filter))
+        {
+            continue;
+        }
+
+        if (ctx.List)
+        {
+            std::cout << benchmark.Name << std::endl;
+            continue;
+        }
+
+        results.push_back(s_Run(benchmark, ctx));
+        s_PrintResult(results.back());
+    }
+
+    aws_byte_buf_clean_up(&base64Output);
+    mqttConnection = nullptr;
+
+    if (ctx.JsonFile && !s_WriteJson(ctx.JsonFile, results))
+    {
+        std::cerr << "failed to write " << ctx.JsonFile << std::endl;
+        return 1;
+    }
+
+    for (const auto &result : results)
+    {
+        if (result.Failed)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -5,15 +5,33 @@
 #include <aws/crt/Api.h>
 #include <aws/crt/crypto/Hash.h>
 #include <aws/crt/http/HttpConnection.h>
+#include <aws/crt/http/HttpConnectionManager.h>
 #include <aws/crt/http/HttpRequestResponse.h>
 #include <aws/crt/io/Uri.h>
 
+#include <aws/common/clock.h>
 #include <aws/common/command_line_parser.h>
 
+#ifdef _WIN32
+#    ifndef WIN32_LEAN_AND_MEAN
+#        define WIN32_LEAN_AND_MEAN
+#    endif
+#    include <windows.h>
+#else
+#    include <cerrno>
+#    include <fcntl.h>
+#    include <unistd.h>
+#endif
+
+#include <algorithm>
 #include <condition_variable>
+#include <cstring>
 #include <fstream>
 #include <future>
+#include <iomanip>
 #include <iostream>
+#include <mutex>
+#include <sstream>
 
 using namespace Aws::Crt;
 
@@ -41,6 +59,16 @@ struct ElasticurlCtx
 
     std::shared_ptr<Io::IStream> InputBody = nullptr;
     std::ofstream Output;
+    const char *OutputPath = nullptr;
+
+    bool Benchmark = false;
+    size_t Concurrency = 10;
+    uint64_t TotalRequests = 0;
+    uint64_t DurationSecs = 0;
+    size_t PoolSize = 0;
+
+    size_t ParallelRanges = 0;
+    uint64_t PartSize = 8 * 1024 * 1024;
 };
 
 static void s_Usage(int exit_code)
@@ -69,6 +97,17 @@ static void s_Usage(int exit_code)
     std::cerr << "      --version: print the version of elasticurl.\n";
     std::cerr << "      --http2: HTTP/2 connection required\n";
     std::cerr << "      --http1_1: HTTP/1.1 connection required\n";
+    std::cerr << "      --bench: load-generation mode. Sends the request over and over, discarding the responses,\n";
+    std::cerr << "            and reports throughput and latency percentiles. Uses HTTP/1.1 unless --http2 is given.\n";
+    std::cerr << "      --concurrency INT: requests in flight at once in --bench mode. Default is 10.\n";
+    std::cerr << "      --requests INT: requests to send in --bench mode. Default is 1000 unless --duration is set.\n";
+    std::cerr << "      --duration INT: seconds to keep sending in --bench mode.\n";
+    std::cerr << "      --pool-size INT: connections in --bench mode. Default is --concurrency for HTTP/1.1,\n";
+    std::cerr << "            where a connection carries one request at a time, and 1 for HTTP/2, where streams\n";
+    std::cerr << "            share them.\n";
+    std::cerr << "      --parallel INT: downloads into the --output file with INT Range requests in flight at once,\n";
+    std::cerr << "            each on its own connection, writing every part at its offset as it arrives.\n";
+    std::cerr << "      --part-size INT: bytes per Range request with --parallel. Default is 8388608 (8 MiB).\n";
     std::cerr << "  -h, --help\n";
     std::cerr << "            Display this message and quit.\n";
     exit(exit_code);
@@ -95,17 +134,47 @@ static struct aws_cli_option s_LongOptions[] = {
     {"version", AWS_CLI_OPTIONS_NO_ARGUMENT, nullptr, 'V'},
     {"http2", AWS_CLI_OPTIONS_NO_ARGUMENT, nullptr, 'w'},
     {"http1_1", AWS_CLI_OPTIONS_NO_ARGUMENT, nullptr, 'W'},
+    {"bench", AWS_CLI_OPTIONS_NO_ARGUMENT, nullptr, 'B'},
+    {"concurrency", AWS_CLI_OPTIONS_REQUIRED_ARGUMENT, nullptr, 'C'},
+    {"requests", AWS_CLI_OPTIONS_REQUIRED_ARGUMENT, nullptr, 'n'},
+    {"duration", AWS_CLI_OPTIONS_REQUIRED_ARGUMENT, nullptr, 'D'},
+    {"pool-size", AWS_CLI_OPTIONS_REQUIRED_ARGUMENT, nullptr, 'p'},
+    {"parallel", AWS_CLI_OPTIONS_REQUIRED_ARGUMENT, nullptr, 'R'},
+    {"part-size", AWS_CLI_OPTIONS_REQUIRED_ARGUMENT, nullptr, 'Z'},
     {"help", AWS_CLI_OPTIONS_NO_ARGUMENT, nullptr, 'h'},
     /* Per getopt(3) the last element of the array has to be filled with all zeros */
     {nullptr, AWS_CLI_OPTIONS_NO_ARGUMENT, nullptr, 0},
 };
 
+/* Parses the argument of an option that takes a positive integer, exiting with the usage on anything else. */
+static uint64_t s_ParsePositiveInteger(const char *option, const char *value)
+{
+    uint64_t parsed = 0;
+    for (const char *digit = value; *digit != '\0'; ++digit)
+    {
+        if (*digit < '0' || *digit > '9' || parsed > (UINT64_MAX - 9) / 10)
+        {
+            parsed = 0;
+            break;
+        }
+        parsed = parsed * 10 + static_cast<uint64_t>(*digit - '0');
+    }
+
+    if (parsed == 0)
+    {
+        std::cerr << "--" << option << " must be a positive integer, not \"" << value << "\".\n";
+        s_Usage(1);
+    }
+    return parsed;
+}
+
 static void s_ParseOptions(int argc, char **argv, ElasticurlCtx &ctx)
 {
     while (true)
     {
         int option_index = 0;
-        int c = aws_cli_getopt_long(argc, argv, "a:b:c:e:f:H:d:g:M:GPHiko:t:v:VwWh", s_LongOptions, &option_index);
+        int c = aws_cli_getopt_long(
+            argc, argv, "a:b:c:e:f:H:d:g:M:GPHiko:t:v:VwWBC:n:D:p:R:Z:h", s_LongOptions, &option_index);
         if (c == -1)
         {
             /* finished parsing */
@@ -169,6 +238,7 @@ static void s_ParseOptions(int argc, char **argv, ElasticurlCtx &ctx)
                 ctx.Insecure = true;
                 break;
             case 'o':
+                ctx.OutputPath = aws_cli_optarg;
                 ctx.Output.open(aws_cli_optarg, std::ios::out | std::ios::binary);
                 break;
             case 't':
@@ -208,6 +278,27 @@ static void s_ParseOptions(int argc, char **argv, ElasticurlCtx &ctx)
                 ctx.Alpn = "http/1.1";
                 ctx.RequiredHttpVersion = Http::HttpVersion::Http1_1;
                 break;
+            case 'B':
+                ctx.Benchmark = true;
+                break;
+            case 'C':
+                ctx.Concurrency = static_cast<size_t>(s_ParsePositiveInteger("concurrency", aws_cli_optarg));
+                break;
+            case 'n':
+                ctx.TotalRequests = s_ParsePositiveInteger("requests", aws_cli_optarg);
+                break;
+            case 'D':
+                ctx.DurationSecs = s_ParsePositiveInteger("duration", aws_cli_optarg);
+                break;
+            case 'p':
+                ctx.PoolSize = static_cast<size_t>(s_ParsePositiveInteger("pool-size", aws_cli_optarg));
+                break;
+            case 'R':
+                ctx.ParallelRanges = static_cast<size_t>(atoll(aws_cli_optarg));
+                break;
+            case 'Z':
+                ctx.PartSize = static_cast<uint64_t>(atoll(aws_cli_optarg));
+                break;
             case 'h':
                 s_Usage(0);
                 break;
@@ -217,6 +308,38 @@ static void s_ParseOptions(int argc, char **argv, ElasticurlCtx &ctx)
         }
     }
 
+    if (ctx.ParallelRanges != 0)
+    {
+        if (ctx.OutputPath == nullptr || ctx.PartSize == 0 || ctx.Benchmark)
+        {
+            std::cerr << "--parallel needs --output, a non-zero --part-size, and no --bench.\n";
+            s_Usage(1);
+        }
+        /* the parts are written through their own handle */
+        ctx.Output.close();
+        if (ctx.RequiredHttpVersion == Http::HttpVersion::Unknown)
+        {
+            ctx.Alpn = "http/1.1";
+        }
+    }
+
+    if (ctx.Benchmark)
+    {
+        if (ctx.TotalRequests == 0 && ctx.DurationSecs == 0)
+        {
+            ctx.TotalRequests = 1000;
+        }
+        if (ctx.RequiredHttpVersion == Http::HttpVersion::Unknown)
+        {
+            /* a pool of HTTP/1.1 connections, unless HTTP/2 was asked for */
+            ctx.Alpn = "http/1.1";
+        }
+        if (ctx.PoolSize == 0)
+        {
+            ctx.PoolSize = ctx.RequiredHttpVersion == Http::HttpVersion::Http2 ? 1 : ctx.Concurrency;
+        }
+    }
+
     if (ctx.InputBody == nullptr)
     {
         ctx.InputBody = std::make_shared<std::stringstream>("");
@@ -241,6 +364,896 @@ static void s_ParseOptions(int argc, char **argv, ElasticurlCtx &ctx)
     }
 }
 
+/* Adds the host, user-agent and --header headers. Returns false if a --header line is malformed. */
+static bool s_AddRequestHeaders(ElasticurlCtx &ctx, Http::HttpRequest &request)
+{
+    Http::HttpHeader hostHeader;
+    hostHeader.name = ByteCursorFromCString("host");
+    hostHeader.value = ctx.uri.GetHostName();
+    request.AddHeader(hostHeader);
+
+    Http::HttpHeader userAgentHeader;
+    userAgentHeader.name = ByteCursorFromCString("user-agent");
+    userAgentHeader.value = ByteCursorFromCString("elasticurl_cpp 1.0, Powered by the AWS Common Runtime.");
+    request.AddHeader(userAgentHeader);
+
+    for (auto headerLine : ctx.HeaderLines)
+    {
+        char *delimiter = (char *)memchr(headerLine, ':', strlen(headerLine));
+
+        if (!delimiter)
+        {
+            std::cerr << "invalid header line " << headerLine << " configured." << std::endl;
+            return false;
+        }
+
+        Http::HttpHeader userHeader;
+        userHeader.name = ByteCursorFromArray((uint8_t *)headerLine, delimiter - headerLine);
+        userHeader.value = ByteCursorFromCString(delimiter + 1);
+        request.AddHeader(userHeader);
+    }
+
+    return true;
+}
+
+static uint64_t s_Now()
+{
+    uint64_t now = 0;
+    aws_high_res_clock_get_ticks(&now);
+    return now;
+}
+
+/* Shared by every request of a --bench run. */
+struct BenchmarkState
+{
+    ElasticurlCtx *ctx = nullptr;
+    /* where a worker moves on from after a request fails before its stream is activated */
+    Io::EventLoopGroup *eventLoopGroup = nullptr;
+    std::shared_ptr<Http::HttpClientConnectionManager> manager;
+    /* HTTP/2 only: connections held for the whole run, streams are spread across them */
+    Vector<std::shared_ptr<Http::HttpClientConnection>> http2Connections;
+    String body;
+    uint64_t deadlineNs = 0;
+
+    std::mutex lock;
+    std::condition_variable done;
+    size_t activeWorkers = 0;
+    uint64_t issued = 0;
+    uint64_t succeeded = 0;
+    uint64_t failed = 0;
+    uint64_t errorResponses = 0;
+    uint64_t bodyBytes = 0;
+    int firstErrorCode = AWS_ERROR_SUCCESS;
+    Vector<uint64_t> latenciesNs;
+};
+
+/* One request of a --bench run, from the moment it is issued until its stream completes. */
+struct BenchmarkRequest
+{
+    explicit BenchmarkRequest(BenchmarkState *state) : state(state) {}
+    BenchmarkState *state;
+    std::shared_ptr<Http::HttpRequest> request;
+    std::shared_ptr<Http::HttpClientStream> stream;
+    uint64_t startNs = 0;
+    uint64_t bodyBytes = 0;
+    int statusCode = 0;
+};
+
+static std::shared_ptr<Http::HttpRequest> s_MakeBenchmarkRequest(BenchmarkState &state)
+{
+    ElasticurlCtx &ctx = *state.ctx;
+    auto request = MakeShared<Http::HttpRequest>(ctx.allocator, ctx.allocator);
+    request->SetMethod(ByteCursorFromCString(ctx.verb));
+    request->SetPath(ctx.uri.GetPathAndQuery());
+    if (!s_AddRequestHeaders(ctx, *request))
+    {
+        return nullptr;
+    }
+
+    if (!state.body.empty())
+    {
+        std::string contentLength = std::to_string(state.body.size());
+        Http::HttpHeader contentLengthHeader;
+        contentLengthHeader.name = ByteCursorFromCString("content-length");
+        contentLengthHeader.value = ByteCursorFromCString(contentLength.c_str());
+        request->AddHeader(contentLengthHeader);
+        request->SetBody(MakeShared<StringStream>(ctx.allocator, state.body));
+    }
+
+    return request;
+}
+
+static void s_BenchmarkNext(BenchmarkState *state);
+
+/* Counts a finished request and frees it. On HTTP/1.1 this hands its connection back to the pool. */
+static void s_BenchmarkRecord(BenchmarkRequest *request, int errorCode)
+{
+    uint64_t latencyNs = s_Now() - request->startNs;
+    BenchmarkState *state = request->state;
+    {
+        std::lock_guard<std::mutex> lock(state->lock);
+        if (errorCode)
+        {
+            ++state->failed;
+            if (state->firstErrorCode == AWS_ERROR_SUCCESS)
+            {
+                state->firstErrorCode = errorCode;
+            }
+        }
+        else
+        {
+            ++state->succeeded;
+            state->bodyBytes += request->bodyBytes;
+            state->latenciesNs.push_back(latencyNs);
+            if (request->statusCode >= 400)
+            {
+                ++state->errorResponses;
+            }
+        }
+    }
+
+    Delete(request, state->ctx->allocator);
+}
+
+static void s_BenchmarkRetireWorker(BenchmarkState *state)
+{
+    std::lock_guard<std::mutex> lock(state->lock);
+    if (--state->activeWorkers == 0)
+    {
+        state->done.notify_all();
+    }
+}
+
+/* Invoked when a request's stream completes, on the connection's event loop. */
+static void s_BenchmarkComplete(BenchmarkRequest *request, int errorCode)
+{
+    BenchmarkState *state = request->state;
+    s_BenchmarkRecord(request, errorCode);
+    s_BenchmarkNext(state);
+}
+
+/*
+ * Invoked when a request fails before its stream is activated, possibly from within s_BenchmarkNext(). The worker
+ * moves on from a task of its own, so a run of such failures doesn't recurse.
+ */
+static void s_BenchmarkFailed(BenchmarkRequest *request, int errorCode)
+{
+    BenchmarkState *state = request->state;
+    s_BenchmarkRecord(request, errorCode != AWS_ERROR_SUCCESS ? errorCode : AWS_ERROR_UNKNOWN);
+
+    bool scheduled = state->eventLoopGroup->Schedule([state](Io::TaskStatus status) {
+        if (status == Io::TaskStatus::RunReady)
+        {
+            s_BenchmarkNext(state);
+        }
+        else
+        {
+            s_BenchmarkRetireWorker(state);
+        }
+    });
+    if (!scheduled)
+    {
+        s_BenchmarkRetireWorker(state);
+    }
+}
+
+static void s_BenchmarkSend(BenchmarkRequest *request, const std::shared_ptr<Http::HttpClientConnection> &connection)
+{
+    Http::HttpRequestOptions requestOptions;
+    requestOptions.request = request->request.get();
+    requestOptions.onIncomingHeaders =
+        [request](Http::HttpStream &stream, enum aws_http_header_block headerBlock, const Http::HttpHeader *, size_t) {
+            if (headerBlock == AWS_HTTP_HEADER_BLOCK_MAIN)
+            {
+                request->statusCode = stream.GetResponseStatusCode();
+            }
+        };
+    requestOptions.onIncomingBody = [request](Http::HttpStream &, const ByteCursor &data) {
+        request->bodyBytes += data.len;
+    };
+    requestOptions.onStreamComplete = [request](Http::HttpStream &, int errorCode) {
+        s_BenchmarkComplete(request, errorCode);
+    };
+
+    request->stream = connection->NewClientStream(requestOptions);
+    if (!request->stream)
+    {
+        s_BenchmarkFailed(request, connection->LastError());
+        return;
+    }
+
+    if (!request->stream->Activate())
+    {
+        s_BenchmarkFailed(request, aws_last_error());
+    }
+}
+
+/* Issues the next request of a worker, or retires the worker once the run is over. */
+static void s_BenchmarkNext(BenchmarkState *state)
+{
+    ElasticurlCtx &ctx = *state->ctx;
+    uint64_t now = s_Now();
+    uint64_t sequence = 0;
+    bool finished = false;
+    {
+        std::lock_guard<std::mutex> lock(state->lock);
+        finished = (ctx.TotalRequests != 0 && state->issued >= ctx.TotalRequests) ||
+                   (state->deadlineNs != 0 && now >= state->deadlineNs);
+        if (!finished)
+        {
+            sequence = state->issued++;
+        }
+    }
+
+    /* latency is what a caller sees: time waiting for a pooled connection included */
+    auto *request = finished ? nullptr : New<BenchmarkRequest>(ctx.allocator, state);
+    if (request == nullptr)
+    {
+        if (!finished)
+        {
+            std::lock_guard<std::mutex> lock(state->lock);
+            ++state->failed;
+            if (state->firstErrorCode == AWS_ERROR_SUCCESS)
+            {
+                state->firstErrorCode = aws_last_error();
+            }
+        }
+        s_BenchmarkRetireWorker(state);
+        return;
+    }
+
+    request->startNs = now;
+    request->request = s_MakeBenchmarkRequest(*state);
+    if (!request->request)
+    {
+        s_BenchmarkFailed(request, aws_last_error());
+        return;
+    }
+
+    if (!state->http2Connections.empty())
+    {
+        s_BenchmarkSend(request, state->http2Connections[sequence % state->http2Connections.size()]);
+        return;
+    }
+
+    bool queued = state->manager->AcquireConnection(
+        [request](std::shared_ptr<Http::HttpClientConnection> connection, int errorCode) {
+            if (errorCode)
+            {
+                s_BenchmarkFailed(request, errorCode);
+                return;
+            }
+
+            s_BenchmarkSend(request, connection);
+        });
+    if (!queued)
+    {
+        s_BenchmarkFailed(request, aws_last_error());
+    }
+}
+
+/* Nearest-rank percentile of sorted latencies, in milliseconds. */
+static double s_PercentileMs(const Vector<uint64_t> &sortedNs, double percentile)
+{
+    size_t rank = static_cast<size_t>(percentile / 100.0 * static_cast<double>(sortedNs.size()) + 0.999999);
+    size_t index = rank == 0 ? 0 : rank - 1;
+    return static_cast<double>(sortedNs[(std::min)(index, sortedNs.size() - 1)]) / 1e6;
+}
+
+static void s_PrintBenchmarkReport(BenchmarkState &state, uint64_t elapsedNs)
+{
+    double seconds = static_cast<double>(elapsedNs) / 1e9;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Requests:     " << state.succeeded << " completed, " << state.failed << " failed, "
+              << state.errorResponses << " with a 4xx/5xx status" << std::endl;
+    std::cout << "Duration:     " << seconds << " s" << std::endl;
+    std::cout << "Throughput:   " << static_cast<double>(state.succeeded) / seconds << " requests/s, "
+              << static_cast<double>(state.bodyBytes) / seconds / (1024 * 1024) << " MiB/s of body" << std::endl;
+
+    if (!state.latenciesNs.empty())
+    {
+        Vector<uint64_t> &latencies = state.latenciesNs;
+        std::sort(latencies.begin(), latencies.end());
+        uint64_t totalNs = 0;
+        for (uint64_t latency : latencies)
+        {
+            totalNs += latency;
+        }
+
+        std::cout << "Latency (ms): min " << static_cast<double>(latencies.front()) / 1e6 << ", mean "
+                  << static_cast<double>(totalNs) / static_cast<double>(latencies.size()) / 1e6 << ", p50 "
+                  << s_PercentileMs(latencies, 50) << ", p90 " << s_PercentileMs(latencies, 90) << ", p99 "
+                  << s_PercentileMs(latencies, 99) << ", p99.9 " << s_PercentileMs(latencies, 99.9) << ", max "
+                  << static_cast<double>(latencies.back()) / 1e6 << std::endl;
+    }
+
+    if (state.failed)
+    {
+        std::cout << "First error:  " << aws_error_debug_str(state.firstErrorCode) << std::endl;
+    }
+}
+
+static int s_RunBenchmark(
+    ElasticurlCtx &ctx,
+    const Http::HttpClientConnectionOptions &connectionOptions,
+    Io::EventLoopGroup &eventLoopGroup)
+{
+    BenchmarkState state;
+    state.ctx = &ctx;
+    state.eventLoopGroup = &eventLoopGroup;
+
+    /* every request gets its own copy of the body to read from */
+    std::stringstream bodyContents;
+    bodyContents << ctx.InputBody->rdbuf();
+    std::string body = bodyContents.str();
+    state.body = String(body.data(), body.size());
+
+    if (!s_MakeBenchmarkRequest(state))
+    {
+        exit(1);
+    }
+
+    Http::HttpClientConnectionManagerOptions managerOptions;
+    managerOptions.ConnectionOptions = connectionOptions;
+    managerOptions.MaxConnections = ctx.PoolSize;
+    managerOptions.EnableBlockingShutdown = true;
+    state.manager = Http::HttpClientConnectionManager::NewClientConnectionManager(managerOptions, ctx.allocator);
+    if (!state.manager)
+    {
+        std::cerr << "Failed to create connection manager with error " << aws_error_debug_str(aws_last_error())
+                  << std::endl;
+        exit(1);
+    }
+
+    ByteCursor hostName = ctx.uri.GetHostName();
+    String host((const char *)hostName.ptr, hostName.len);
+
+    /* connect up front, so handshakes do not count towards the latencies */
+    size_t connected = state.manager->Prewarm(ctx.PoolSize).get();
+    if (connected == 0)
+    {
+        std::cerr << "Failed to connect to " << host << std::endl;
+        exit(1);
+    }
+
+    if (ctx.RequiredHttpVersion == Http::HttpVersion::Http2)
+    {
+        for (size_t i = 0; i < connected; ++i)
+        {
+            Http::HttpClientConnectionAcquisition acquisition = state.manager->AcquireConnection().get();
+            if (acquisition.ErrorCode)
+            {
+                std::cerr << "Connection failed with error " << aws_error_debug_str(acquisition.ErrorCode)
+                          << std::endl;
+                exit(1);
+            }
+            if (acquisition.Connection->GetVersion() != Http::HttpVersion::Http2)
+            {
+                std::cerr << "Error. The requested HTTP version, " << ctx.Alpn << ", is not supported by the peer."
+                          << std::endl;
+                exit(1);
+            }
+            state.http2Connections.push_back(acquisition.Connection);
+        }
+    }
+
+    std::cout << "Sending " << ctx.verb << " " << host << " with " << ctx.Concurrency
+              << " in flight over " << connected << (state.http2Connections.empty() ? " HTTP/1.1" : " HTTP/2")
+              << " connection(s)" << std::endl;
+
+    uint64_t startNs = s_Now();
+    {
+        std::lock_guard<std::mutex> lock(state.lock);
+        state.activeWorkers = ctx.Concurrency;
+        if (ctx.DurationSecs != 0)
+        {
+            state.deadlineNs = startNs + ctx.DurationSecs * 1000000000ULL;
+        }
+    }
+
+    for (size_t i = 0; i < ctx.Concurrency; ++i)
+    {
+        s_BenchmarkNext(&state);
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(state.lock);
+        state.done.wait(lock, [&state]() { return state.activeWorkers == 0; });
+    }
+    uint64_t elapsedNs = s_Now() - startNs;
+
+    state.http2Connections.clear();
+    s_PrintBenchmarkReport(state, elapsedNs);
+    state.manager->InitiateShutdown().get();
+
+    return state.failed ? 1 : 0;
+}
+
+/* An output file written at arbitrary offsets, from any thread. */
+class OutputFile
+{
+  public:
+    OutputFile() = default;
+    OutputFile(const OutputFile &) = delete;
+    OutputFile &operator=(const OutputFile &) = delete;
+    ~OutputFile() { Close(); }
+
+    bool Open(const char *path)
+    {
+#ifdef _WIN32
+        m_file = CreateFileA(path, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        return m_file != INVALID_HANDLE_VALUE;
+#else
+        m_file = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        return m_file >= 0;
+#endif
+    }
+
+    bool WriteAt(uint64_t offset, const uint8_t *data, size_t length)
+    {
+        while (length > 0)
+        {
+#ifdef _WIN32
+            OVERLAPPED position;
+            memset(&position, 0, sizeof(position));
+            position.Offset = static_cast<DWORD>(offset);
+            position.OffsetHigh = static_cast<DWORD>(offset >> 32);
+            DWORD toWrite = static_cast<DWORD>((std::min)(length, static_cast<size_t>(1u << 30)));
+            DWORD written = 0;
+            if (!WriteFile(m_file, data, toWrite, &written, &position))
+            {
+                return false;
+            }
+#else
+            ssize_t written = pwrite(m_file, data, length, static_cast<off_t>(offset));
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+#endif
+            data += written;
+            offset += static_cast<uint64_t>(written);
+            length -= static_cast<size_t>(written);
+        }
+
+        return true;
+    }
+
+    void Close()
+    {
+#ifdef _WIN32
+        if (m_file != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(m_file);
+            m_file = INVALID_HANDLE_VALUE;
+        }
+#else
+        if (m_file >= 0)
+        {
+            close(m_file);
+            m_file = -1;
+        }
+#endif
+    }
+
+  private:
+#ifdef _WIN32
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+#else
+    int m_file = -1;
+#endif
+};
+
+/* Shared by every part of a --parallel download. */
+struct RangedDownloadState
+{
+    ElasticurlCtx *ctx = nullptr;
+    std::shared_ptr<Http::HttpClientConnectionManager> manager;
+    OutputFile file;
+    std::promise<void> firstPartDone;
+
+    std::mutex lock;
+    std::condition_variable done;
+    size_t activeWorkers = 0;
+    /* unknown until the first part's Content-Range arrives */
+    uint64_t totalSize = 0;
+    uint64_t nextOffset = 0;
+    uint64_t partCount = 0;
+    uint64_t bytesWritten = 0;
+    String failure;
+    /* pins every later part to the version of the object the first part came from, set once the first part is in */
+    String validatorHeader;
+    String validator;
+};
+
+/* One Range request, from the moment it is issued until its stream completes. */
+struct RangedPart
+{
+    RangedPart(RangedDownloadState *state, uint64_t offset, uint64_t length)
+        : state(state), offset(offset), length(length)
+    {
+    }
+    RangedDownloadState *state;
+    uint64_t offset;
+    uint64_t length;
+    uint64_t received = 0;
+    int statusCode = 0;
+    String contentRange;
+    String etag;
+    String lastModified;
+    bool overrun = false;
+    bool writeFailed = false;
+    std::shared_ptr<Http::HttpRequest> request;
+    std::shared_ptr<Http::HttpClientStream> stream;
+};
+
+static void s_FailDownload(RangedDownloadState *state, const String &failure)
+{
+    std::lock_guard<std::mutex> lock(state->lock);
+    if (state->failure.empty())
+    {
+        state->failure = failure;
+    }
+}
+
+/* Parses a run of decimal digits ending in terminator, leaving cursor just past the terminator. */
+static bool s_ParseContentRangeNumber(const char *&cursor, char terminator, uint64_t &value)
+{
+    if (*cursor < '0' || *cursor > '9')
+    {
+        return false;
+    }
+
+    char *end = nullptr;
+    unsigned long long parsed = strtoull(cursor, &end, 10);
+    if (*end != terminator)
+    {
+        return false;
+    }
+
+    value = static_cast<uint64_t>(parsed);
+    cursor = end + 1;
+    return true;
+}
+
+/* Parses "bytes first-last/complete". A complete length of "*" (unknown) is reported as UINT64_MAX. */
+static bool s_ParseContentRange(const String &contentRange, uint64_t &first, uint64_t &last, uint64_t &total)
+{
+    if (contentRange.compare(0, 6, "bytes ") != 0)
+    {
+        return false;
+    }
+
+    const char *cursor = contentRange.c_str() + 6;
+    if (!s_ParseContentRangeNumber(cursor, '-', first) || !s_ParseContentRangeNumber(cursor, '/', last) ||
+        last < first)
+    {
+        return false;
+    }
+
+    if (strcmp(cursor, "*") == 0)
+    {
+        total = UINT64_MAX;
+        return true;
+    }
+
+    return s_ParseContentRangeNumber(cursor, '\0', total) && total > last;
+}
+
+static void s_DownloadNext(RangedDownloadState *state);
+
+/* Checks a completed part and hands its worker the next one. */
+static void s_RangedPartComplete(RangedPart *part, int errorCode)
+{
+    RangedDownloadState *state = part->state;
+    bool first = part->offset == 0;
+    uint64_t rangeFirst = 0;
+    uint64_t rangeLast = 0;
+    uint64_t total = 0;
+
+    if (errorCode)
+    {
+        s_FailDownload(state, String("request failed with error ") + aws_error_debug_str(errorCode));
+    }
+    else if (part->overrun)
+    {
+        /* the server sent more than the range asked for, which is its fault rather than the output file's */
+        s_FailDownload(
+            state,
+            String("part at offset ") + std::to_string(part->offset).c_str() + " failed with error " +
+                aws_error_debug_str(AWS_ERROR_HTTP_PROTOCOL_ERROR) + ": body overran the requested range");
+    }
+    else if (part->writeFailed)
+    {
+        s_FailDownload(state, String("failed to write to ") + state->ctx->OutputPath);
+    }
+    else if (first && part->statusCode == 200)
+    {
+        /* the server ignored the range and sent the whole object */
+        std::lock_guard<std::mutex> lock(state->lock);
+        state->totalSize = part->received;
+        state->nextOffset = part->received;
+    }
+    else if (first && part->statusCode == 416)
+    {
+        /* nothing to download: the object is empty */
+        std::lock_guard<std::mutex> lock(state->lock);
+        state->totalSize = 0;
+        state->nextOffset = 0;
+    }
+    else if (!first && (part->statusCode == 412 || part->statusCode == 200) && !state->validatorHeader.empty())
+    {
+        /* a failed If-Match, or an If-Range that no longer matches and so got the whole object */
+        s_FailDownload(state, "object changed during the download");
+    }
+    else if (part->statusCode != 206)
+    {
+        s_FailDownload(state, String("unexpected response status ") + std::to_string(part->statusCode).c_str());
+    }
+    else if (
+        !s_ParseContentRange(part->contentRange, rangeFirst, rangeLast, total) || rangeFirst != part->offset ||
+        (first && total == UINT64_MAX))
+    {
+        s_FailDownload(
+            state,
+            String("part at offset ") + std::to_string(part->offset).c_str() + " got unusable Content-Range \"" +
+                part->contentRange + "\"");
+    }
+    else if (first)
+    {
+        if (part->received != (std::min)(part->length, total))
+        {
+            s_FailDownload(state, "first part is short");
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(state->lock);
+            state->totalSize = total;
+            state->nextOffset = part->received;
+
+            /* a weak ETag can not be used with If-Match, Last-Modified is the fallback */
+            if (!part->etag.empty() && part->etag.compare(0, 2, "W/") != 0)
+            {
+                state->validatorHeader = "if-match";
+                state->validator = part->etag;
+            }
+            else if (!part->lastModified.empty())
+            {
+                state->validatorHeader = "if-range";
+                state->validator = part->lastModified;
+            }
+        }
+    }
+    else if (part->received != part->length)
+    {
+        s_FailDownload(state, String("part at offset ") + std::to_string(part->offset).c_str() + " is short");
+    }
+
+    Delete(part, state->ctx->allocator);
+    if (first)
+    {
+        state->firstPartDone.set_value();
+        return;
+    }
+
+    s_DownloadNext(state);
+}
+
+static void s_FetchRangedPart(RangedPart *part)
+{
+    RangedDownloadState *state = part->state;
+    ElasticurlCtx &ctx = *state->ctx;
+
+    part->request = MakeShared<Http::HttpRequest>(ctx.allocator, ctx.allocator);
+    part->request->SetMethod(ByteCursorFromCString("GET"));
+    part->request->SetPath(ctx.uri.GetPathAndQuery());
+    s_AddRequestHeaders(ctx, *part->request);
+
+    std::string range =
+        "bytes=" + std::to_string(part->offset) + "-" + std::to_string(part->offset + part->length - 1);
+    Http::HttpHeader rangeHeader;
+    rangeHeader.name = ByteCursorFromCString("range");
+    rangeHeader.value = ByteCursorFromCString(range.c_str());
+    part->request->AddHeader(rangeHeader);
+
+    /* the first part has completed before any other is fetched, so the validator no longer changes */
+    if (!state->validatorHeader.empty())
+    {
+        Http::HttpHeader validatorHeader;
+        validatorHeader.name = ByteCursorFromCString(state->validatorHeader.c_str());
+        validatorHeader.value = ByteCursorFromCString(state->validator.c_str());
+        part->request->AddHeader(validatorHeader);
+    }
+
+    bool queued = state->manager->AcquireConnection(
+        [part](std::shared_ptr<Http::HttpClientConnection> connection, int errorCode) {
+            if (errorCode)
+            {
+                s_RangedPartComplete(part, errorCode);
+                return;
+            }
+
+            Http::HttpRequestOptions requestOptions;
+            requestOptions.request = part->request.get();
+            requestOptions.onIncomingHeaders = [part](
+                                                   Http::HttpStream &stream,
+                                                   enum aws_http_header_block headerBlock,
+                                                   const Http::HttpHeader *headers,
+                                                   size_t headersCount) {
+                if (headerBlock != AWS_HTTP_HEADER_BLOCK_MAIN)
+                {
+                    return;
+                }
+
+                part->statusCode = stream.GetResponseStatusCode();
+                for (size_t i = 0; i < headersCount; ++i)
+                {
+                    ByteCursor name = headers[i].name;
+                    String value((const char *)headers[i].value.ptr, headers[i].value.len);
+                    if (aws_byte_cursor_eq_c_str_ignore_case(&name, "content-range"))
+                    {
+                        part->contentRange = value;
+                    }
+                    else if (aws_byte_cursor_eq_c_str_ignore_case(&name, "etag"))
+                    {
+                        part->etag = value;
+                    }
+                    else if (aws_byte_cursor_eq_c_str_ignore_case(&name, "last-modified"))
+                    {
+                        part->lastModified = value;
+                    }
+                }
+            };
+            requestOptions.onIncomingBody = [part](Http::HttpStream &, const ByteCursor &data) {
+                /* only a 206, or a 200 to the first part carrying the whole object, is content to keep */
+                bool wholeObject = part->statusCode == 200 && part->offset == 0;
+                if (part->statusCode != 206 && !wholeObject)
+                {
+                    return;
+                }
+
+                if (part->overrun || part->writeFailed)
+                {
+                    return;
+                }
+
+                if (!wholeObject && part->received + data.len > part->length)
+                {
+                    part->overrun = true;
+                    return;
+                }
+
+                if (!part->state->file.WriteAt(part->offset + part->received, data.ptr, data.len))
+                {
+                    part->writeFailed = true;
+                    return;
+                }
+
+                part->received += data.len;
+                std::lock_guard<std::mutex> lock(part->state->lock);
+                part->state->bytesWritten += data.len;
+            };
+            requestOptions.onStreamComplete = [part](Http::HttpStream &, int streamErrorCode) {
+                s_RangedPartComplete(part, streamErrorCode);
+            };
+
+            part->stream = connection->NewClientStream(requestOptions);
+            if (!part->stream)
+            {
+                s_RangedPartComplete(part, connection->LastError());
+                return;
+            }
+
+            if (!part->stream->Activate())
+            {
+                s_RangedPartComplete(part, aws_last_error());
+            }
+        });
+    if (!queued)
+    {
+        s_RangedPartComplete(part, aws_last_error());
+    }
+}
+
+/* Fetches the next part for a worker, or retires the worker once every part is taken or the download failed. */
+static void s_DownloadNext(RangedDownloadState *state)
+{
+    ElasticurlCtx &ctx = *state->ctx;
+    uint64_t offset = 0;
+    uint64_t length = 0;
+    {
+        std::lock_guard<std::mutex> lock(state->lock);
+        if (!state->failure.empty() || state->nextOffset >= state->totalSize)
+        {
+            if (--state->activeWorkers == 0)
+            {
+                state->done.notify_all();
+            }
+            return;
+        }
+
+        offset = state->nextOffset;
+        length = (std::min)(ctx.PartSize, state->totalSize - offset);
+        state->nextOffset += length;
+        ++state->partCount;
+    }
+
+    s_FetchRangedPart(New<RangedPart>(ctx.allocator, state, offset, length));
+}
+
+static int s_RunRangedDownload(ElasticurlCtx &ctx, const Http::HttpClientConnectionOptions &connectionOptions)
+{
+    RangedDownloadState state;
+    state.ctx = &ctx;
+
+    Http::HttpRequest probe(ctx.allocator);
+    if (!s_AddRequestHeaders(ctx, probe))
+    {
+        exit(1);
+    }
+
+    if (!state.file.Open(ctx.OutputPath))
+    {
+        std::cerr << "unable to open file " << ctx.OutputPath << std::endl;
+        exit(1);
+    }
+
+    Http::HttpClientConnectionManagerOptions managerOptions;
+    managerOptions.ConnectionOptions = connectionOptions;
+    managerOptions.MaxConnections = ctx.ParallelRanges;
+    managerOptions.EnableBlockingShutdown = true;
+    state.manager = Http::HttpClientConnectionManager::NewClientConnectionManager(managerOptions, ctx.allocator);
+    if (!state.manager)
+    {
+        std::cerr << "Failed to create connection manager with error " << aws_error_debug_str(aws_last_error())
+                  << std::endl;
+        exit(1);
+    }
+
+    uint64_t startNs = s_Now();
+
+    /* the first part tells how large the object is; the other connections open meanwhile */
+    state.manager->Prewarm(ctx.ParallelRanges - 1);
+    state.partCount = 1;
+    s_FetchRangedPart(New<RangedPart>(ctx.allocator, &state, 0, ctx.PartSize));
+    state.firstPartDone.get_future().wait();
+
+    {
+        std::lock_guard<std::mutex> lock(state.lock);
+        state.activeWorkers = ctx.ParallelRanges;
+    }
+    for (size_t i = 0; i < ctx.ParallelRanges; ++i)
+    {
+        s_DownloadNext(&state);
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(state.lock);
+        state.done.wait(lock, [&state]() { return state.activeWorkers == 0; });
+    }
+    uint64_t elapsedNs = s_Now() - startNs;
+    state.file.Close();
+    state.manager->InitiateShutdown().get();
+
+    if (!state.failure.empty())
+    {
+        std::cerr << "Download failed: " << state.failure << std::endl;
+        return 1;
+    }
+
+    double seconds = static_cast<double>(elapsedNs) / 1e9;
+    std::cerr << "Downloaded " << state.bytesWritten << " bytes in " << state.partCount << " part(s) over up to "
+              << ctx.ParallelRanges << " connection(s) in " << std::fixed << std::setprecision(3) << seconds
+              << " s, " << static_cast<double>(state.bytesWritten) / seconds / (1024 * 1024) << " MiB/s"
+              << std::endl;
+
+    return 0;
+}
+
 int main(int argc, char **argv)
 {
     struct aws_allocator *allocator = aws_default_allocator();
@@ -374,6 +1387,26 @@ int main(int argc, char **argv)
     }
     clientBootstrap.EnableBlockingShutdown();
 
+    Http::HttpClientConnectionOptions httpClientConnectionOptions;
+    httpClientConnectionOptions.Bootstrap = &clientBootstrap;
+    httpClientConnectionOptions.SocketOptions = socketOptions;
+    if (useTls)
+    {
+        httpClientConnectionOptions.TlsOptions = tlsConnectionOptions;
+    }
+    httpClientConnectionOptions.HostName = String((const char *)hostName.ptr, hostName.len);
+    httpClientConnectionOptions.Port = port;
+
+    if (appCtx.Benchmark)
+    {
+        return s_RunBenchmark(appCtx, httpClientConnectionOptions, eventLoopGroup);
+    }
+
+    if (appCtx.ParallelRanges != 0)
+    {
+        return s_RunRangedDownload(appCtx, httpClientConnectionOptions);
+    }
+
     std::promise<std::shared_ptr<Http::HttpClientConnection>> connectionPromise;
     std::promise<void> shutdownPromise;
 
@@ -409,17 +1442,8 @@ int main(int argc, char **argv)
         shutdownPromise.set_value();
     };
 
-    Http::HttpClientConnectionOptions httpClientConnectionOptions;
-    httpClientConnectionOptions.Bootstrap = &clientBootstrap;
     httpClientConnectionOptions.OnConnectionSetupCallback = onConnectionSetup;
     httpClientConnectionOptions.OnConnectionShutdownCallback = onConnectionShutdown;
-    httpClientConnectionOptions.SocketOptions = socketOptions;
-    if (useTls)
-    {
-        httpClientConnectionOptions.TlsOptions = tlsConnectionOptions;
-    }
-    httpClientConnectionOptions.HostName = String((const char *)hostName.ptr, hostName.len);
-    httpClientConnectionOptions.Port = port;
 
     Http::HttpClientConnection::CreateConnection(httpClientConnectionOptions, allocator);
 
@@ -483,16 +1507,10 @@ int main(int argc, char **argv)
 
     request.SetMethod(ByteCursorFromCString(appCtx.verb));
     request.SetPath(appCtx.uri.GetPathAndQuery());
-
-    Http::HttpHeader hostHeader;
-    hostHeader.name = ByteCursorFromCString("host");
-    hostHeader.value = appCtx.uri.GetHostName();
-    request.AddHeader(hostHeader);
-
-    Http::HttpHeader userAgentHeader;
-    userAgentHeader.name = ByteCursorFromCString("user-agent");
-    userAgentHeader.value = ByteCursorFromCString("elasticurl_cpp 1.0, Powered by the AWS Common Runtime.");
-    request.AddHeader(userAgentHeader);
+    if (!s_AddRequestHeaders(appCtx, request))
+    {
+        exit(1);
+    }
 
     std::shared_ptr<Io::StdIOStreamInputStream> bodyStream =
         MakeShared<Io::StdIOStreamInputStream>(allocator, appCtx.InputBody, allocator);
@@ -512,22 +1530,6 @@ int main(int argc, char **argv)
         request.SetBody(bodyStream);
     }
 
-    for (auto headerLine : appCtx.HeaderLines)
-    {
-        char *delimiter = (char *)memchr(headerLine, ':', strlen(headerLine));
-
-        if (!delimiter)
-        {
-            std::cerr << "invalid header line " << headerLine << " configured." << std::endl;
-            exit(1);
-        }
-
-        Http::HttpHeader userHeader;
-        userHeader.name = ByteCursorFromArray((uint8_t *)headerLine, delimiter - headerLine);
-        userHeader.value = ByteCursorFromCString(delimiter + 1);
-        request.AddHeader(userHeader);
-    }
-
     auto stream = connection->NewClientStream(requestOptions);
     stream->Activate();
 
@@ -6,6 +6,10 @@ find_dependency(aws-c-cal)
 find_dependency(aws-c-auth)
 find_dependency(aws-c-event-stream)
 
+if (@USE_ZLIB@)
+    find_dependency(ZLIB)
+endif()
+
 if (BUILD_SHARED_LIBS)
     include(${CMAKE_CURRENT_LIST_DIR}/shared/@PROJECT_NAME@-targets.cmake)
 else ()
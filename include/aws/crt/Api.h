@@ -3,6 +3,10 @@
  * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
  * SPDX-License-Identifier: Apache-2.0.
  */
+#include <aws/crt/AsyncLogger.h>
+#include <aws/crt/EventTracer.h>
+#include <aws/crt/PoolAllocator.h>
+#include <aws/crt/TracingAllocator.h>
 #include <aws/crt/Types.h>
 #include <aws/crt/crypto/HMAC.h>
 #include <aws/crt/crypto/Hash.h>
@@ -30,17 +34,86 @@ namespace Aws
             Count
         };
 
+        /**
+         * CRT libraries an ApiHandle initializes, see ApiHandleOptions::LazySubsystemInitialization. Hashing, HMAC
+         * and JSON are always available.
+         */
+        enum class ApiSubsystem
+        {
+            /**
+             * Event loops, sockets, host resolution, TLS and streams.
+             */
+            Io,
+            /**
+             * HTTP connections and messages. Depends on Io.
+             */
+            Http,
+            /**
+             * MQTT clients. Depends on Http.
+             */
+            Mqtt,
+            /**
+             * Credentials providers and signing. Depends on Http.
+             */
+            Auth,
+            /**
+             * Event-stream messages and RPC. Depends on Io.
+             */
+            EventStream,
+
+            Count
+        };
+
         enum class ApiHandleShutdownBehavior
         {
             Blocking,
             NonBlocking
         };
 
+        /**
+         * Configuration for an ApiHandle, covering choices that must be made before the CRT libraries are
+         * initialized.
+         */
+        class AWS_CRT_CPP_API ApiHandleOptions
+        {
+          public:
+            ApiHandleOptions() noexcept;
+            ApiHandleOptions(const ApiHandleOptions &rhs) = default;
+            ApiHandleOptions(ApiHandleOptions &&rhs) = default;
+
+            ApiHandleOptions &operator=(const ApiHandleOptions &rhs) = default;
+            ApiHandleOptions &operator=(ApiHandleOptions &&rhs) = default;
+
+            /**
+             * If set, the ApiHandle layers a PoolAllocator over the allocator it is given and installs it as the
+             * global allocator, so small allocations made on event-loop threads are served from per-thread free
+             * lists instead of the shared heap. Defaults to false.
+             */
+            bool EnableThreadCachingPool;
+
+            /**
+             * If set, the ApiHandle wraps its allocator in a TracingAllocator and hands each CRT library its own
+             * view of it, so live bytes, allocation counts and high-water marks can be read per subsystem through
+             * GetTracingAllocator(). The tracer is destroyed with the ApiHandle, so with NonBlocking shutdown make
+             * sure no CRT threads outlive it. Defaults to false.
+             */
+            bool EnableAllocationTracing;
+
+            /**
+             * If set, the ApiHandle only initializes the CRT core, hashing and JSON itself, and each ApiSubsystem is
+             * initialized the first time one of its wrappers is created, or by ApiHandle::InitializeSubsystem().
+             * Processes that only use a few subsystems start faster and use less memory, TLS setup in particular is
+             * skipped unless Io is used. Defaults to false.
+             */
+            bool LazySubsystemInitialization;
+        };
+
         class AWS_CRT_CPP_API ApiHandle
         {
           public:
             ApiHandle(Allocator *allocator) noexcept;
             ApiHandle() noexcept;
+            ApiHandle(Allocator *allocator, const ApiHandleOptions &options) noexcept;
             ~ApiHandle();
             ApiHandle(const ApiHandle &) = delete;
             ApiHandle(ApiHandle &&) = delete;
@@ -61,6 +134,57 @@ namespace Aws
              */
             void InitializeLogging(LogLevel level, FILE *fp);
 
+            /**
+             * Initialize logging in awscrt through an AsyncLogger: lines are handed to a background writer instead
+             * of being written by the thread that logs them, and dropped if that thread's ring is full. Replaces
+             * any logger installed by InitializeLogging() or a previous call.
+             * @param level: Display messages of this importance and higher. LogLevel.NoLogs will disable
+             * logging.
+             * @param filename: Logging destination, a file path from the disk.
+             * @param options: Sizing of the per-thread rings and how often they are drained.
+             */
+            void InitializeAsyncLogging(
+                LogLevel level,
+                const char *filename,
+                const AsyncLoggerOptions &options = AsyncLoggerOptions());
+            /**
+             * Initialize logging in awscrt through an AsyncLogger.
+             * @param level: Display messages of this importance and higher. LogLevel.NoLogs will disable
+             * logging.
+             * @param fp: The FILE object for logging destination. It must stay open for the lifetime of this
+             * ApiHandle, or until logging is initialized again.
+             * @param options: Sizing of the per-thread rings and how often they are drained.
+             */
+            void InitializeAsyncLogging(
+                LogLevel level,
+                FILE *fp,
+                const AsyncLoggerOptions &options = AsyncLoggerOptions());
+
+            /**
+             * @return the logger installed by InitializeAsyncLogging(), e.g. to read its drop count, or nullptr.
+             */
+            AsyncLogger *GetAsyncLogger() const noexcept { return m_asyncLogger; }
+
+            /**
+             * Starts recording connection setup, TLS negotiation, HTTP stream, MQTT publish and credentials fetch
+             * events into an EventTracer owned by this ApiHandle. Calling it again resumes recording into the same
+             * tracer, keeping the events it already holds.
+             * @param eventsPerThread: events each thread keeps before overwriting its oldest ones. Only used the
+             * first time.
+             * @return the tracer, or nullptr if it could not be created.
+             */
+            EventTracer *EnableEventTracing(size_t eventsPerThread = 4096);
+
+            /**
+             * Stops recording events. The tracer and its events stay readable until this ApiHandle is destroyed.
+             */
+            void DisableEventTracing();
+
+            /**
+             * @return the tracer created by EnableEventTracing(), or nullptr.
+             */
+            EventTracer *GetEventTracer() const noexcept { return m_eventTracer; }
+
             /**
              * Configures the shutdown behavior of the api handle instance
              * @param shutdownBehavior desired shutdown behavior
@@ -106,6 +230,24 @@ namespace Aws
                 Io::DeleteTlsContextImplCallback &&deleteCallback,
                 Io::IsTlsAlpnSupportedCallback &&alpnCallback);
 
+            /**
+             * @return the tracer installed by ApiHandleOptions::EnableAllocationTracing, or nullptr if tracing was
+             * not enabled. Its counters may be read from any thread for the lifetime of this ApiHandle.
+             */
+            const TracingAllocator *GetTracingAllocator() const noexcept { return m_tracingAllocator; }
+
+            /**
+             * Initializes subsystem, and the subsystems it depends on, unless that was already done. Wrappers do this
+             * themselves when they are created; call it to pay the cost up front instead, e.g. before
+             * latency-sensitive work. Thread-safe, and does nothing without a live ApiHandle.
+             */
+            static void InitializeSubsystem(ApiSubsystem subsystem) noexcept;
+
+            /**
+             * @return whether subsystem has been initialized by the live ApiHandle.
+             */
+            static bool IsSubsystemInitialized(ApiSubsystem subsystem) noexcept;
+
             /// @private
             static const Io::NewTlsContextImplCallback &GetBYOCryptoNewTlsContextImplCallback();
             /// @private
@@ -115,10 +257,20 @@ namespace Aws
 
           private:
             void InitializeLoggingCommon(struct aws_logger_standard_options &options);
+            void InstallAsyncLogger(AsyncLogger *logger);
+            void ShutDownLogging();
 
             aws_logger m_logger;
+            AsyncLogger *m_asyncLogger;
+
+            EventTracer *m_eventTracer;
 
             ApiHandleShutdownBehavior m_shutdownBehavior;
+
+            PoolAllocator *m_poolAllocator;
+
+            Allocator *m_tracingParent;
+            TracingAllocator *m_tracingAllocator;
         };
 
         AWS_CRT_CPP_API const char *ErrorDebugString(int error) noexcept;
@@ -0,0 +1,121 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/Exports.h>
+#include <aws/crt/StlAllocator.h>
+
+#include <cstddef>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        /**
+         * Monotonic (bump-pointer) allocator. Memory is carved out of large blocks acquired from a parent allocator,
+         * individual releases are no-ops, and everything is returned to the parent in one shot by Reset() or
+         * destruction.
+         *
+         * Use GetUnderlyingHandle() anywhere the CRT accepts an Allocator *, including StlAllocator, String and
+         * Vector. The arena is not thread-safe: use one per thread (or per request), and make sure nothing allocated
+         * from it outlives it.
+         */
+        class AWS_CRT_CPP_API ArenaAllocator final
+        {
+          public:
+            static const size_t DefaultBlockSize = 16 * 1024;
+
+            /**
+             * @param blockSize: size of each block requested from the parent allocator. Allocations larger than this
+             * get a dedicated block.
+             * @param parent: allocator the blocks are acquired from.
+             */
+            ArenaAllocator(size_t blockSize = DefaultBlockSize, Allocator *parent = g_allocator) noexcept;
+            ~ArenaAllocator();
+            ArenaAllocator(const ArenaAllocator &) = delete;
+            ArenaAllocator(ArenaAllocator &&) = delete;
+            ArenaAllocator &operator=(const ArenaAllocator &) = delete;
+            ArenaAllocator &operator=(ArenaAllocator &&) = delete;
+
+            /**
+             * Releases every block back to the parent allocator. All memory handed out by this arena becomes
+             * invalid.
+             */
+            void Reset() noexcept;
+
+            /**
+             * @return number of bytes handed out since construction or the last Reset().
+             */
+            size_t BytesAllocated() const noexcept { return m_bytesAllocated; }
+
+            /**
+             * @return number of bytes currently held from the parent allocator, including block headers.
+             */
+            size_t BytesReserved() const noexcept { return m_bytesReserved; }
+
+            /**
+             * @return the arena as an Allocator *, usable anywhere the CRT takes an allocator.
+             */
+            Allocator *GetUnderlyingHandle() noexcept { return &m_allocator; }
+
+          private:
+            struct Block;
+
+            /**
+             * Position in the arena, used by ArenaScope to rewind.
+             */
+            struct Mark
+            {
+                Block *block;
+                size_t used;
+                size_t bytesAllocated;
+            };
+
+            void *Acquire(size_t size) noexcept;
+            void *Realloc(void *ptr, size_t oldSize, size_t newSize) noexcept;
+            Mark GetMark() const noexcept;
+            void Rewind(const Mark &mark) noexcept;
+
+            static void *s_MemAcquire(Allocator *allocator, size_t size);
+            static void s_MemRelease(Allocator *allocator, void *ptr);
+            static void *s_MemRealloc(Allocator *allocator, void *ptr, size_t oldSize, size_t newSize);
+            static void *s_MemCalloc(Allocator *allocator, size_t num, size_t size);
+
+            Allocator m_allocator;
+            Allocator *m_parent;
+            size_t m_blockSize;
+            Block *m_head;
+            void *m_lastAllocation;
+            size_t m_bytesAllocated;
+            size_t m_bytesReserved;
+
+            friend class ArenaScope;
+        };
+
+        /**
+         * RAII scope over an ArenaAllocator. Everything allocated from the arena while the scope is alive is
+         * released when the scope is destroyed; memory allocated before the scope was opened is left untouched.
+         * Scopes may be nested but must be destroyed in reverse order of creation.
+         */
+        class AWS_CRT_CPP_API ArenaScope final
+        {
+          public:
+            explicit ArenaScope(ArenaAllocator &arena) noexcept;
+            ~ArenaScope();
+            ArenaScope(const ArenaScope &) = delete;
+            ArenaScope(ArenaScope &&) = delete;
+            ArenaScope &operator=(const ArenaScope &) = delete;
+            ArenaScope &operator=(ArenaScope &&) = delete;
+
+            /**
+             * @return the scoped arena as an Allocator *.
+             */
+            Allocator *GetAllocator() noexcept { return m_arena.GetUnderlyingHandle(); }
+
+          private:
+            ArenaAllocator &m_arena;
+            ArenaAllocator::Mark m_mark;
+        };
+    } // namespace Crt
+} // namespace Aws
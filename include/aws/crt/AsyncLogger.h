@@ -0,0 +1,171 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/Exports.h>
+#include <aws/crt/StlAllocator.h>
+
+#include <aws/common/logging.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        enum class LogLevel;
+
+        struct AsyncLogRing;
+
+        /**
+         * Sizing of an AsyncLogger.
+         */
+        struct AWS_CRT_CPP_API AsyncLoggerOptions
+        {
+            /**
+             * Lines each logging thread can have waiting on the writer, rounded up to a power of two. A thread that
+             * logs faster than the writer drains drops lines once its ring is full.
+             */
+            size_t RingCapacity = 1024;
+
+            /**
+             * Bytes reserved per line, prefix included. Longer lines are truncated.
+             */
+            size_t MaxLineLength = 512;
+
+            /**
+             * How often the writer drains the rings, in milliseconds. It also wakes early for a ring that is three
+             * quarters full.
+             */
+            uint64_t FlushIntervalMs = 10;
+        };
+
+        /**
+         * An aws_logger that takes file I/O off the logging threads, so Debug or Trace logging can stay on under
+         * load.
+         *
+         * Each thread formats its lines into a ring buffer of its own, a single-producer single-consumer queue that
+         * takes no lock, and a background thread writes the rings out. When a thread's ring is full its lines are
+         * dropped rather than waited on; drops are counted, and the writer notes them in the log as it catches up.
+         * Lines from one thread stay in order, lines from different threads are only ordered by their timestamps.
+         *
+         * ApiHandle::InitializeAsyncLogging() installs one of these as the process' logger.
+         */
+        class AWS_CRT_CPP_API AsyncLogger final
+        {
+          public:
+            /**
+             * Creates a logger appending to filename.
+             * @return the logger, or nullptr if filename could not be opened.
+             */
+            static AsyncLogger *Create(
+                LogLevel level,
+                const char *filename,
+                const AsyncLoggerOptions &options = AsyncLoggerOptions(),
+                Allocator *allocator = g_allocator) noexcept;
+
+            /**
+             * Creates a logger writing to fp, which must stay open until the logger is destroyed.
+             */
+            static AsyncLogger *Create(
+                LogLevel level,
+                FILE *fp,
+                const AsyncLoggerOptions &options = AsyncLoggerOptions(),
+                Allocator *allocator = g_allocator) noexcept;
+
+            /**
+             * Writes out every line logged so far, stops the writer and frees the logger. It must no longer be
+             * installed with aws_logger_set().
+             */
+            static void Destroy(AsyncLogger *logger) noexcept;
+
+            AsyncLogger(const AsyncLogger &) = delete;
+            AsyncLogger(AsyncLogger &&) = delete;
+            AsyncLogger &operator=(const AsyncLogger &) = delete;
+            AsyncLogger &operator=(AsyncLogger &&) = delete;
+
+            /**
+             * @return the logger to install with aws_logger_set().
+             */
+            aws_logger *GetUnderlyingHandle() noexcept { return &m_logger; }
+
+            LogLevel GetLogLevel() const noexcept;
+            void SetLogLevel(LogLevel level) noexcept;
+
+            /**
+             * @return the number of lines dropped so far because their thread's ring was full.
+             */
+            uint64_t GetDroppedCount() const noexcept;
+
+            /**
+             * Wakes the writer and waits until everything logged before the call has been written and flushed.
+             */
+            void Flush() noexcept;
+
+          private:
+            AsyncLogger(
+                LogLevel level,
+                FILE *fp,
+                bool ownsFile,
+                const AsyncLoggerOptions &options,
+                Allocator *allocator) noexcept;
+            ~AsyncLogger();
+
+            static AsyncLogger *s_Create(
+                LogLevel level,
+                FILE *fp,
+                bool ownsFile,
+                const AsyncLoggerOptions &options,
+                Allocator *allocator) noexcept;
+
+            AsyncLogRing *GetThreadRing() noexcept;
+            void RunWriter() noexcept;
+            void DrainRings() noexcept;
+
+            static int s_Log(
+                aws_logger *logger,
+                enum aws_log_level logLevel,
+                aws_log_subject_t subject,
+                const char *format,
+                ...);
+            static enum aws_log_level s_GetLogLevel(aws_logger *logger, aws_log_subject_t subject);
+            static void s_CleanUp(aws_logger *logger);
+
+            static aws_logger_vtable s_vtable;
+
+            aws_logger m_logger;
+            Allocator *m_allocator;
+            uint64_t m_id;
+            FILE *m_file;
+            bool m_ownsFile;
+            size_t m_ringCapacity;
+            size_t m_lineLength;
+            uint64_t m_flushIntervalMs;
+            std::atomic<int> m_level;
+
+            /* rings of the threads that logged; m_ringsLock guards the links, not the lines the writer drains */
+            mutable std::mutex m_ringsLock;
+            AsyncLogRing *m_rings;
+            std::atomic<uint64_t> m_retiredDrops;
+
+            /* wakes the writer; m_flushRequests and m_flushesDone count Flush() calls */
+            std::mutex m_writerLock;
+            std::condition_variable m_writerSignal;
+            std::condition_variable m_flushSignal;
+            bool m_stopping;
+            uint64_t m_flushRequests;
+            uint64_t m_flushesDone;
+            std::thread m_writer;
+
+            /* live loggers, so a thread exiting can tell whether its ring still has an owner */
+            AsyncLogger *m_nextLive;
+
+            friend struct AsyncLogThreadState;
+        };
+    } // namespace Crt
+} // namespace Aws
@@ -116,10 +116,33 @@ namespace Aws
             bool ToLocalTimeString(DateFormat format, ByteBuf &outputBuf) const noexcept;
 
             /**
-             * Convert dateTime to GMT time string using predefined format.
+             * The longest string ToGmtString() produces: RFC822, e.g. "Wed, 02 Oct 2002 08:05:09 GMT".
+             */
+            static const size_t MaxGmtStringLength = 29;
+
+            /**
+             * Convert dateTime to GMT time string using predefined format. The string is appended to outputBuf.
              */
             bool ToGmtString(DateFormat format, ByteBuf &outputBuf) const noexcept;
 
+            /**
+             * Convert dateTime to GMT time string using predefined format, into a fixed buffer, e.g. for a Date or
+             * x-amz-date header. Nothing is allocated and the string is not NUL-terminated.
+             *
+             * RFC822 and ISO_8601 strings are rendered from a per-thread cache of the current minute, so formatting
+             * a time in the same minute as the previous call on the thread only writes the seconds.
+             *
+             * @return true with the string's length in length, false if the format is not RFC822 or ISO_8601 or
+             * the buffer is too small (MaxGmtStringLength is always enough).
+             */
+            bool ToGmtString(DateFormat format, char *buffer, size_t bufferSize, size_t &length) const noexcept;
+
+            /**
+             * Formats this very instant like ToGmtString(format, buffer, bufferSize, length), without building a
+             * DateTime, which converts to local time as well.
+             */
+            static bool NowToGmtString(DateFormat format, char *buffer, size_t bufferSize, size_t &length) noexcept;
+
             /**
              * Get the representation of this datetime as seconds.milliseconds since epoch
              */
@@ -0,0 +1,169 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/Exports.h>
+#include <aws/crt/StlAllocator.h>
+#include <aws/crt/Types.h>
+
+#include <atomic>
+#include <mutex>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        struct EventTraceRing;
+
+        /**
+         * What a TraceEvent records. Events of one operation share their Id, which is only unique among operations
+         * in flight at the same time.
+         */
+        enum class TraceEventType : uint8_t
+        {
+            /**
+             * An HTTP client connection, from the connect call to its setup callback. Value is the error code of
+             * the End event.
+             */
+            ConnectionSetup,
+            /**
+             * TLS negotiation of an HTTP client connection finished, an Instant event with the Id of its
+             * ConnectionSetup. Value is the error code.
+             */
+            TlsNegotiated,
+            /**
+             * An HTTP client connection shut down, an Instant event with the Id of its ConnectionSetup. Value is
+             * the error code.
+             */
+            ConnectionShutdown,
+            /**
+             * An HTTP stream, from activation to completion. Value is the error code of the End event.
+             */
+            HttpStream,
+            /**
+             * An MQTT publish, from the call until it completes: once acknowledged for QoS 1, once written for QoS
+             * 0. Value is the payload size on the Begin event and the error code on the End event.
+             */
+            MqttPublish,
+            /**
+             * A credentials fetch of a CredentialsProvider, from the call until it resolves. Value is the error code
+             * of the End event.
+             */
+            CredentialsFetch,
+
+            Count
+        };
+
+        enum class TraceEventPhase : uint8_t
+        {
+            Instant,
+            Begin,
+            End,
+        };
+
+        /**
+         * An event read back from an EventTracer.
+         */
+        struct AWS_CRT_CPP_API TraceEvent
+        {
+            /**
+             * When the event was recorded, in aws_high_res_clock_get_ticks() nanoseconds.
+             */
+            uint64_t TimestampNs;
+            uint64_t Id;
+            int64_t Value;
+            /**
+             * Numbers the threads in the order they first recorded an event, starting at 1.
+             */
+            uint32_t ThreadIndex;
+            TraceEventType Type;
+            TraceEventPhase Phase;
+        };
+
+        /**
+         * Flight recorder for connection, stream, publish and credentials events of the CRT. Each thread records
+         * into a ring of fixed-size binary events of its own, without taking a lock or allocating, and once the
+         * ring is full the oldest events are overwritten. The rings can be read back, or exported as a Chrome trace,
+         * from any thread while events are being recorded.
+         *
+         * Events are recorded into the active tracer, if there is one; ApiHandle::EnableEventTracing() creates and
+         * activates one. Without an active tracer recording costs an atomic load.
+         */
+        class AWS_CRT_CPP_API EventTracer final
+        {
+          public:
+            /**
+             * @param eventsPerThread events each thread's ring holds, rounded up to a power of two.
+             */
+            static EventTracer *Create(size_t eventsPerThread = 4096, Allocator *allocator = g_allocator) noexcept;
+
+            /**
+             * Frees the tracer, which must not be active any more.
+             */
+            static void Destroy(EventTracer *tracer) noexcept;
+
+            /**
+             * Makes tracer, or nothing if nullptr, the tracer events are recorded into. When this replaces another
+             * tracer, it waits for every Record() that may still be writing into that one to finish, so the
+             * replaced tracer can be destroyed as soon as it returns.
+             */
+            static void SetActive(EventTracer *tracer) noexcept;
+            static EventTracer *GetActive() noexcept;
+
+            /**
+             * Records an event into the active tracer, if there is one.
+             */
+            static void Record(TraceEventType type, TraceEventPhase phase, uint64_t id, int64_t value = 0) noexcept;
+            static void Record(TraceEventType type, TraceEventPhase phase, const void *id, int64_t value = 0) noexcept
+            {
+                Record(type, phase, static_cast<uint64_t>(reinterpret_cast<uintptr_t>(id)), value);
+            }
+
+            EventTracer(const EventTracer &) = delete;
+            EventTracer(EventTracer &&) = delete;
+            EventTracer &operator=(const EventTracer &) = delete;
+            EventTracer &operator=(EventTracer &&) = delete;
+
+            /**
+             * @return the events still held by the rings, ordered by timestamp.
+             */
+            Vector<TraceEvent> GetEvents() const;
+
+            /**
+             * @return the number of events lost so far because a thread's ring was full.
+             */
+            uint64_t GetOverwrittenCount() const noexcept;
+
+            /**
+             * Appends the events still held by the rings to output as a JSON object in the Chrome Trace Event
+             * Format, which chrome://tracing and Perfetto open. Operations show up as async slices, timestamps are
+             * microseconds since the tracer was created.
+             * @return false with aws_last_error() set if output could not take the trace.
+             */
+            bool ExportChromeTrace(ByteBuf &output) const;
+
+            /**
+             * @return the name events of type are exported under.
+             */
+            static const char *GetEventName(TraceEventType type) noexcept;
+
+          private:
+            EventTracer(size_t eventsPerThread, Allocator *allocator) noexcept;
+            ~EventTracer();
+
+            EventTraceRing *GetThreadRing() noexcept;
+            void Append(TraceEventType type, TraceEventPhase phase, uint64_t id, int64_t value) noexcept;
+
+            Allocator *m_allocator;
+            uint64_t m_id;
+            size_t m_ringCapacity;
+            uint64_t m_createdTimestampNs;
+
+            /* rings of the threads that recorded, guarded by m_ringsLock; they live as long as the tracer */
+            mutable std::mutex m_ringsLock;
+            EventTraceRing *m_rings;
+            uint32_t m_ringCount;
+        };
+    } // namespace Crt
+} // namespace Aws
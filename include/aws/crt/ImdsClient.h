@@ -7,8 +7,12 @@
 #include <aws/crt/DateTime.h>
 #include <aws/crt/Exports.h>
 #include <aws/crt/Types.h>
+
+#include <chrono>
 #include <functional>
+#include <future>
 
+struct aws_auth_http_system_vtable;
 struct aws_credentials;
 struct aws_imds_client;
 struct aws_imds_instance_info;
@@ -35,7 +39,11 @@ namespace Aws
 
             struct AWS_CRT_CPP_API ImdsClientConfig
             {
-                ImdsClientConfig() : Bootstrap(nullptr) {}
+                ImdsClientConfig()
+                    : Bootstrap(nullptr), CacheResources(false), ResourceCacheTtl(std::chrono::minutes(5)),
+                      FunctionTable(nullptr)
+                {
+                }
 
                 /**
                  * Connection bootstrap to use to create the http connection required to
@@ -43,6 +51,28 @@ namespace Aws
                  */
                 Io::ClientBootstrap *Bootstrap;
 
+                /**
+                 * Keep the resources queried through the client in memory, so that the components of a process
+                 * asking for the same metadata do not each make a round trip to the instance metadata service.
+                 * Resources that do not change while the instance runs, such as its id, type or availability zone,
+                 * are kept for the life of the client, and the others for ResourceCacheTtl. Credentials are never
+                 * cached.
+                 */
+                bool CacheResources;
+
+                /**
+                 * How long a cached resource that may change, such as the security groups or the user data, is
+                 * served before it is queried again.
+                 */
+                std::chrono::milliseconds ResourceCacheTtl;
+
+                /**
+                 * Replaces the HTTP functions the client queries the instance metadata service with, as the
+                 * function_table of aws_imds_client_options does. Only meant for tests, which answer the queries
+                 * without an instance metadata service; leave it null otherwise.
+                 */
+                const struct aws_auth_http_system_vtable *FunctionTable;
+
                 /* Should add retry strategy support once that is available */
             };
 
@@ -124,15 +154,40 @@ namespace Aws
                 String region;
             };
 
-            using OnResourceAcquired = std::function<void(const StringView &resource, int errorCode, void *userData)>;
+            /**
+             * The outcome of querying one of the resources of ImdsClient::GetMany().
+             */
+            struct AWS_CRT_CPP_API ImdsResourceResult
+            {
+                String resourcePath;
+                String resource;
+                int errorCode = AWS_ERROR_SUCCESS;
+            };
+
+            /**
+             * The outcome of a future-returning ImdsClient query: the resource, copied out of the response so it
+             * can be kept, and AWS_ERROR_SUCCESS or the reason the query failed, in which case Value is empty.
+             */
+            template <typename T> struct ImdsResult
+            {
+                ImdsResult() : Value(), ErrorCode(AWS_ERROR_SUCCESS) {}
+
+                T Value;
+                int ErrorCode;
+            };
+
+            using OnResourceAcquired = Function<void(const StringView &resource, int errorCode, void *userData)>;
             using OnVectorResourceAcquired =
-                std::function<void(const Vector<StringView> &resource, int errorCode, void *userData)>;
+                Function<void(const Vector<StringView> &resource, int errorCode, void *userData)>;
             using OnCredentialsAcquired =
-                std::function<void(const Auth::Credentials &credentials, int errorCode, void *userData)>;
+                Function<void(const Auth::Credentials &credentials, int errorCode, void *userData)>;
             using OnIamProfileAcquired =
-                std::function<void(const IamProfileView &iamProfile, int errorCode, void *userData)>;
+                Function<void(const IamProfileView &iamProfile, int errorCode, void *userData)>;
             using OnInstanceInfoAcquired =
-                std::function<void(const InstanceInfoView &instanceInfo, int errorCode, void *userData)>;
+                Function<void(const InstanceInfoView &instanceInfo, int errorCode, void *userData)>;
+            using OnResourcesAcquired = Function<void(const Vector<ImdsResourceResult> &results, void *userData)>;
+
+            struct ImdsResourceCache;
 
             class AWS_CRT_CPP_API ImdsClient
             {
@@ -158,6 +213,19 @@ namespace Aws
                  */
                 int GetResource(const StringView &resourcePath, OnResourceAcquired callback, void *userData);
 
+                /**
+                 * Queries several generic resources at once. The queries are all started together and share the
+                 * client's connections and its IMDSv2 session token, so a batch costs about as long as its slowest
+                 * resource rather than the sum of them; resources in the cache are answered from it.
+                 *
+                 * @param resourcePaths paths of the resources to query
+                 * @param callback callback function to invoke once every resource has been queried, with one result
+                 * per path, in the order of resourcePaths
+                 * @param userData opaque data to invoke the completion callback with
+                 * @return AWS_OP_SUCCESS if the queries were started, AWS_OP_ERR otherwise
+                 */
+                int GetMany(const Vector<StringView> &resourcePaths, OnResourcesAcquired callback, void *userData);
+
                 /**
                  * Gets the ami id of the ec2 instance from the instance metadata document
                  *
@@ -357,7 +425,63 @@ namespace Aws
                  */
                 int GetInstanceInfo(OnInstanceInfoAcquired callback, void *userData);
 
+                /*
+                 * Future-returning forms of the queries above. They take no callback or user data: each future is
+                 * satisfied with an owned copy of the resource, or the error the query failed with, including the
+                 * failure to start it. Failed credentials queries yield a null Value.
+                 *
+                 * Waiting on one of these futures from an event-loop thread of the client's bootstrap will
+                 * deadlock.
+                 */
+
+                std::future<ImdsResult<String>> GetResource(const StringView &resourcePath);
+                std::future<ImdsResult<String>> GetAmiId();
+                std::future<ImdsResult<String>> GetAmiLaunchIndex();
+                std::future<ImdsResult<String>> GetAmiManifestPath();
+                std::future<ImdsResult<Vector<String>>> GetAncestorAmiIds();
+                std::future<ImdsResult<String>> GetInstanceAction();
+                std::future<ImdsResult<String>> GetInstanceId();
+                std::future<ImdsResult<String>> GetInstanceType();
+                std::future<ImdsResult<String>> GetMacAddress();
+                std::future<ImdsResult<String>> GetPrivateIpAddress();
+                std::future<ImdsResult<String>> GetAvailabilityZone();
+                std::future<ImdsResult<String>> GetProductCodes();
+                std::future<ImdsResult<String>> GetPublicKey();
+                std::future<ImdsResult<String>> GetRamDiskId();
+                std::future<ImdsResult<String>> GetReservationId();
+                std::future<ImdsResult<Vector<String>>> GetSecurityGroups();
+                std::future<ImdsResult<Vector<String>>> GetBlockDeviceMapping();
+                std::future<ImdsResult<String>> GetAttachedIamRole();
+                std::future<ImdsResult<std::shared_ptr<Auth::Credentials>>> GetCredentials(
+                    const StringView &iamRoleName);
+                std::future<ImdsResult<IamProfile>> GetIamProfile();
+                std::future<ImdsResult<String>> GetUserData();
+                std::future<ImdsResult<String>> GetInstanceSignature();
+                std::future<ImdsResult<InstanceInfo>> GetInstanceInfo();
+
+                /**
+                 * Drops every cached resource, so the next query of each goes to the instance metadata service.
+                 * Does nothing unless the client was configured with CacheResources.
+                 */
+                void ClearCache() noexcept;
+
               private:
+                using ResourceQuery = int(aws_imds_client *, void (*)(const aws_byte_buf *, int, void *), void *);
+                using VectorResourceQuery =
+                    int(aws_imds_client *, void (*)(const aws_array_list *, int, void *), void *);
+
+                int GetCachedResource(
+                    const char *resourcePath,
+                    ResourceQuery *query,
+                    OnResourceAcquired callback,
+                    void *userData);
+
+                int GetCachedVectorResource(
+                    const char *resourcePath,
+                    VectorResourceQuery *query,
+                    OnVectorResourceAcquired callback,
+                    void *userData);
+
                 static void s_onResourceAcquired(const aws_byte_buf *resource, int erroCode, void *userData);
 
                 static void s_onVectorResourceAcquired(const aws_array_list *array, int errorCode, void *userData);
@@ -376,6 +500,8 @@ namespace Aws
 
                 aws_imds_client *m_client;
                 Allocator *m_allocator;
+                /* shared with the queries in flight, which may complete after the client is gone */
+                std::shared_ptr<ImdsResourceCache> m_cache;
             };
 
         } // namespace Imds
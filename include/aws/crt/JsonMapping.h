@@ -0,0 +1,277 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/JsonObject.h>
+#include <aws/crt/JsonWriter.h>
+#include <aws/crt/Optional.h>
+
+#include <climits>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        /**
+         * Describes the JSON shape of a struct, for JsonDeserialize() and JsonSerialize(). Specialize it with a
+         * Fields() that hands each field and its key to the visitor, once, and both directions are generated from
+         * that description:
+         *
+         *     template <> struct JsonMapping<Telemetry>
+         *     {
+         *         template <typename Visitor, typename Object> static void Fields(Visitor &visit, Object &object)
+         *         {
+         *             visit("id", object.Id);
+         *             visit("samples", object.Samples);
+         *         }
+         *     };
+         *
+         * Object is the struct when reading and the const struct when writing. Fields may be bool, int, int64_t,
+         * double, String, Vector and Optional of any of those, or other structs with a JsonMapping of their own.
+         */
+        template <typename T> struct JsonMapping;
+
+        /**
+         * Reads and writes one type of field. Only specialized here, for the types JsonMapping supports; the
+         * primary template handles structs that have a JsonMapping.
+         */
+        template <typename T> struct JsonValueTraits
+        {
+            /* hands one member of the object to the field with its key, comparing keys in place */
+            struct FieldReader
+            {
+                StringView key;
+                JsonView value;
+                bool matched;
+                bool ok;
+
+                template <typename M> void operator()(const char *name, M &member)
+                {
+                    if (!matched && key.compare(name) == 0)
+                    {
+                        matched = true;
+                        ok = JsonValueTraits<M>::Read(value, member);
+                    }
+                }
+            };
+
+            struct FieldWriter
+            {
+                JsonWriter &writer;
+
+                template <typename M> void operator()(const char *name, const M &member)
+                {
+                    if (JsonValueTraits<M>::IsPresent(member))
+                    {
+                        writer.Key(name);
+                        JsonValueTraits<M>::Write(writer, member);
+                    }
+                }
+            };
+
+            static bool Read(const JsonView &view, T &value)
+            {
+                if (!view.IsObject())
+                {
+                    return false;
+                }
+
+                JsonViewRange members = view.GetChildren();
+                for (auto iter = members.begin(); iter != members.end(); ++iter)
+                {
+                    FieldReader reader{iter.Key(), *iter, false, true};
+                    JsonMapping<T>::Fields(reader, value);
+                    if (!reader.ok)
+                    {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+            static void Write(JsonWriter &writer, const T &value)
+            {
+                writer.BeginObject();
+                FieldWriter fieldWriter{writer};
+                JsonMapping<T>::Fields(fieldWriter, value);
+                writer.EndObject();
+            }
+
+            static bool IsPresent(const T &) { return true; }
+        };
+
+        template <> struct JsonValueTraits<bool>
+        {
+            static bool Read(const JsonView &view, bool &value)
+            {
+                if (!view.IsBool())
+                {
+                    return false;
+                }
+                value = view.AsBool();
+                return true;
+            }
+
+            static void Write(JsonWriter &writer, bool value) { writer.WriteBool(value); }
+            static bool IsPresent(bool) { return true; }
+        };
+
+        template <> struct JsonValueTraits<int>
+        {
+            static bool Read(const JsonView &view, int &value)
+            {
+                if (!view.IsIntegerType() || view.AsDouble() < INT_MIN || view.AsDouble() > INT_MAX)
+                {
+                    return false;
+                }
+                value = view.AsInteger();
+                return true;
+            }
+
+            static void Write(JsonWriter &writer, int value) { writer.WriteInt64(value); }
+            static bool IsPresent(int) { return true; }
+        };
+
+        template <> struct JsonValueTraits<int64_t>
+        {
+            static bool Read(const JsonView &view, int64_t &value)
+            {
+                if (!view.IsIntegerType())
+                {
+                    return false;
+                }
+                value = view.AsInt64();
+                return true;
+            }
+
+            static void Write(JsonWriter &writer, int64_t value) { writer.WriteInt64(value); }
+            static bool IsPresent(int64_t) { return true; }
+        };
+
+        template <> struct JsonValueTraits<double>
+        {
+            static bool Read(const JsonView &view, double &value)
+            {
+                if (!view.IsIntegerType() && !view.IsFloatingPointType())
+                {
+                    return false;
+                }
+                value = view.AsDouble();
+                return true;
+            }
+
+            static void Write(JsonWriter &writer, double value) { writer.WriteDouble(value); }
+            static bool IsPresent(double) { return true; }
+        };
+
+        template <> struct JsonValueTraits<String>
+        {
+            static bool Read(const JsonView &view, String &value)
+            {
+                if (!view.IsString())
+                {
+                    return false;
+                }
+                StringView text = view.AsStringView();
+                value.assign(text.data(), text.size());
+                return true;
+            }
+
+            static void Write(JsonWriter &writer, const String &value)
+            {
+                writer.WriteString(StringView(value.data(), value.size()));
+            }
+            static bool IsPresent(const String &) { return true; }
+        };
+
+        template <typename U> struct JsonValueTraits<Vector<U>>
+        {
+            static bool Read(const JsonView &view, Vector<U> &value)
+            {
+                if (!view.IsListType())
+                {
+                    return false;
+                }
+
+                value.clear();
+                for (auto element : view.GetChildren())
+                {
+                    value.emplace_back();
+                    if (!JsonValueTraits<U>::Read(element, value.back()))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            static void Write(JsonWriter &writer, const Vector<U> &value)
+            {
+                writer.BeginArray();
+                for (const auto &element : value)
+                {
+                    JsonValueTraits<U>::Write(writer, element);
+                }
+                writer.EndArray();
+            }
+
+            static bool IsPresent(const Vector<U> &) { return true; }
+        };
+
+        /* an empty Optional is left out of the object, and null reads as one */
+        template <typename U> struct JsonValueTraits<Optional<U>>
+        {
+            static bool Read(const JsonView &view, Optional<U> &value)
+            {
+                if (view.IsNull())
+                {
+                    value = Optional<U>();
+                    return true;
+                }
+
+                U read{};
+                if (!JsonValueTraits<U>::Read(view, read))
+                {
+                    return false;
+                }
+                value = std::move(read);
+                return true;
+            }
+
+            static void Write(JsonWriter &writer, const Optional<U> &value)
+            {
+                if (value)
+                {
+                    JsonValueTraits<U>::Write(writer, *value);
+                }
+                else
+                {
+                    writer.WriteNull();
+                }
+            }
+
+            static bool IsPresent(const Optional<U> &value) { return value.has_value(); }
+        };
+
+        /**
+         * Reads the object view refers to into value in one pass over its members, using JsonMapping<T>. Members
+         * without a field are skipped, and fields without a member keep their value.
+         * @return false if view is not an object, or a member does not have the type of its field. value may have
+         * been partly updated by then.
+         */
+        template <typename T> bool JsonDeserialize(const JsonView &view, T &value)
+        {
+            return JsonValueTraits<T>::Read(view, value);
+        }
+
+        /**
+         * Writes value as a JSON object using JsonMapping<T>, straight into writer.
+         */
+        template <typename T> void JsonSerialize(JsonWriter &writer, const T &value)
+        {
+            JsonValueTraits<T>::Write(writer, value);
+        }
+    } // namespace Crt
+} // namespace Aws
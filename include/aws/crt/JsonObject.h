@@ -6,6 +6,8 @@
 #include <aws/crt/StlAllocator.h>
 #include <aws/crt/Types.h>
 
+#include <iterator>
+
 namespace Aws
 {
     struct cJSON;
@@ -13,9 +15,35 @@ namespace Aws
     namespace Crt
     {
         class JsonView;
+        class JsonViewRange;
+
+        /**
+         * Parsers a JsonObject can be built with.
+         */
+        enum class JsonParserBackend
+        {
+            /**
+             * The vendored cJSON parser, which JsonObject(const String &) uses.
+             */
+            CJson,
+            /**
+             * Finds every structural character of the document up front, 64 bytes at a time with SSE2 where it is
+             * available, then builds the same tree straight from that index. It is stricter than cJSON, as
+             * RFC 8259 is: anything but whitespace after the value, and unescaped control characters in strings,
+             * fail the parse. Each value shares one allocation with its key and, for strings, its text.
+             */
+            Indexed,
+        };
+
         /**
          * JSON DOM manipulation class.
          * To read or serialize use @ref View function.
+         *
+         * The nodes of a JsonObject come from the allocator it was constructed with, or the one ApiHandle set up for
+         * JSON if it was not given one. Built with an ArenaAllocator, a whole document is freed in one shot by the
+         * arena's Reset(), which must only happen once the JsonObject is gone. Copy construction keeps the
+         * allocator of the copied object, and move construction and assignment carry it over along with the nodes.
+         * Nodes moved in from an object with another allocator are copied instead.
          */
         class AWS_CRT_CPP_API JsonObject
         {
@@ -25,11 +53,27 @@ namespace Aws
              */
             JsonObject();
 
+            /**
+             * Constructs empty JSON DOM whose nodes come from allocator.
+             */
+            explicit JsonObject(Allocator *allocator);
+
             /**
              * Constructs a JSON DOM by parsing the input string.
              */
             JsonObject(const String &value);
 
+            /**
+             * Constructs a JSON DOM by parsing the input string, with nodes that come from allocator.
+             */
+            JsonObject(const String &value, Allocator *allocator);
+
+            /**
+             * Constructs a JSON DOM by parsing the input string with the given parser, with nodes that come from
+             * allocator if one is given.
+             */
+            JsonObject(const String &value, JsonParserBackend backend, Allocator *allocator = nullptr);
+
             /**
              * Performs a deep copy of the JSON DOM parameter.
              * Prefer using a @ref JsonView if copying is not needed.
@@ -127,12 +171,14 @@ namespace Aws
              * The values in the array parameter will be deep-copied.
              */
             JsonObject &WithArray(const String &key, const Vector<JsonObject> &array);
+            JsonObject &WithArray(const char *key, const Vector<JsonObject> &array);
 
             /**
              * Adds an array of arbitrary JSON objects to the top level of this node at key.
              * The values in the array parameter will be moved-from.
              */
             JsonObject &WithArray(const String &key, Vector<JsonObject> &&array);
+            JsonObject &WithArray(const char *key, Vector<JsonObject> &&array);
 
             /**
              * Converts the current JSON node to an array whose values are deep-copied from the array parameter.
@@ -172,6 +218,24 @@ namespace Aws
              */
             JsonObject &AsObject(JsonObject &&value);
 
+            /**
+             * Sets the value at pointer, an RFC 6901 JSON Pointer such as "/state/reported/color", in place, without
+             * copying the rest of the document. Objects missing along the way are created, and members along the way
+             * that are not objects or arrays are replaced by objects. Within an array, a segment must be the index
+             * of an element, or for the last segment the array's size or "-", which append. An empty pointer
+             * replaces the whole document.
+             * The value parameter is moved-from, unless the call fails.
+             * @return false, with AWS_ERROR_INVALID_ARGUMENT raised, if pointer is malformed or leads through an
+             * element that does not exist or through something that is neither an object nor an array at the top
+             * level. The document is unchanged then.
+             */
+            bool SetAtPath(const StringView &pointer, JsonObject &&value);
+
+            /**
+             * Sets the value at pointer like the other overload does, with a deep copy of the value parameter.
+             */
+            bool SetAtPath(const StringView &pointer, const JsonObject &value);
+
             /**
              * Returns true if the last parse request was successful. If this returns false,
              * you can call GetErrorMessage() to find the cause.
@@ -188,10 +252,18 @@ namespace Aws
              */
             JsonView View() const;
 
+            /**
+             * Returns the allocator this object's nodes come from, or nullptr for the one ApiHandle set up for JSON.
+             */
+            inline Allocator *GetAllocator() const { return m_allocator; }
+
           private:
             void Destroy();
+            cJSON *TakeValue(JsonObject &value);
             JsonObject(cJSON *value);
+            static cJSON *s_ParseIndexed(const char *json, size_t length, size_t &errorOffset) noexcept;
             cJSON *m_value;
+            Allocator *m_allocator;
             bool m_wasParseSuccessful;
             String m_errorMessage;
             friend class JsonView;
@@ -226,6 +298,25 @@ namespace Aws
              */
             String AsString() const;
 
+            /**
+             * Gets a string from this node by its key, without copying it.
+             * The view is only valid for as long as the value it was read from.
+             * Returns an empty view if there is no string under key.
+             */
+            StringView GetStringView(const String &key) const;
+            /**
+             * Gets a string from this node by its key, without copying it.
+             * The view is only valid for as long as the value it was read from.
+             * Returns an empty view if there is no string under key.
+             */
+            StringView GetStringView(const char *key) const;
+
+            /**
+             * Returns the value of this node as a string, without copying it.
+             * Returns an empty view if the node is not of type string.
+             */
+            StringView AsStringView() const;
+
             /**
              * Gets a boolean value from this node by its key.
              */
@@ -324,6 +415,24 @@ namespace Aws
              */
             Map<String, JsonView> GetAllObjects() const;
 
+            /**
+             * Iterates over the elements of this array, or the members of this object, in document order and
+             * without collecting them first. Each member's key is available from the iterator.
+             * The range is empty if this node is neither an array nor an object.
+             */
+            JsonViewRange GetChildren() const;
+
+            /**
+             * Iterates over the elements of the array, or the members of the object, found under key.
+             * See GetChildren() above.
+             */
+            JsonViewRange GetChildren(const String &key) const;
+            /**
+             * Iterates over the elements of the array, or the members of the object, found under key.
+             * See GetChildren() above.
+             */
+            JsonViewRange GetChildren(const char *key) const;
+
             /**
              * Tests whether a value exists at the current node level for the given key.
              * Returns true if a value has been found and its value is not null, false otherwise.
@@ -401,6 +510,123 @@ namespace Aws
             JsonView(cJSON *val);
             JsonView &operator=(cJSON *val);
             cJSON *m_value;
+            friend class JsonViewIterator;
+            friend class JsonKeyIndex;
+        };
+
+        /**
+         * Forward iterator over the children of a JsonView. See JsonView::GetChildren().
+         */
+        class AWS_CRT_CPP_API JsonViewIterator
+        {
+          public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = JsonView;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const JsonView *;
+            using reference = JsonView;
+
+            JsonViewIterator() noexcept : m_value(nullptr) {}
+
+            JsonView operator*() const noexcept;
+
+            /**
+             * The key of the current object member, without copying it. Empty for array elements.
+             */
+            StringView Key() const noexcept;
+
+            JsonViewIterator &operator++() noexcept;
+            JsonViewIterator operator++(int) noexcept;
+
+            bool operator==(const JsonViewIterator &other) const noexcept { return m_value == other.m_value; }
+            bool operator!=(const JsonViewIterator &other) const noexcept { return m_value != other.m_value; }
+
+          private:
+            explicit JsonViewIterator(cJSON *value) noexcept : m_value(value) {}
+            cJSON *m_value;
+            friend class JsonViewRange;
+        };
+
+        /**
+         * The children of a JsonView, for use in range-based for loops.
+         */
+        class AWS_CRT_CPP_API JsonViewRange
+        {
+          public:
+            JsonViewIterator begin() const noexcept { return JsonViewIterator(m_first); }
+            JsonViewIterator end() const noexcept { return JsonViewIterator(); }
+            bool empty() const noexcept { return m_first == nullptr; }
+
+          private:
+            explicit JsonViewRange(cJSON *first) noexcept : m_first(first) {}
+            cJSON *m_first;
+            friend class JsonView;
+        };
+
+        /**
+         * Constant-time lookup of the members of one JSON object, for code that reads many fields from wide
+         * objects. JsonView's lookups walk the object's members one by one.
+         *
+         * Objects with fewer members than the threshold are not worth hashing and are searched like JsonView does;
+         * larger ones are hashed once, when the index is constructed. As with JsonView, a key that appears more than
+         * once finds its first occurrence. The index is a snapshot: it must not outlive the JsonObject it was built
+         * from, nor be used once that object is modified.
+         */
+        class AWS_CRT_CPP_API JsonKeyIndex final
+        {
+          public:
+            /**
+             * The number of members from which an object is hashed by default.
+             */
+            static const size_t DefaultThreshold = 16;
+
+            /**
+             * Indexes the members of object. An index of anything but an object finds nothing.
+             */
+            explicit JsonKeyIndex(
+                const JsonView &object,
+                size_t threshold = DefaultThreshold,
+                Allocator *allocator = g_allocator) noexcept;
+
+            /**
+             * Gets the value of the member with key, or, if there is none, the same empty view
+             * JsonView::GetJsonObject() returns for a missing key.
+             */
+            JsonView Get(const StringView &key) const noexcept;
+
+            /**
+             * Gets the string under key, without copying it. Returns an empty view if there is no string under key.
+             */
+            StringView GetStringView(const StringView &key) const noexcept;
+
+            /**
+             * Tests whether a member with key exists and its value is not null.
+             */
+            bool ValueExists(const StringView &key) const noexcept;
+
+            /**
+             * Tests whether a member with key exists.
+             */
+            bool KeyExists(const StringView &key) const noexcept;
+
+            /**
+             * @return true if the object was large enough to be hashed.
+             */
+            bool IsHashed() const noexcept { return !m_slots.empty(); }
+
+          private:
+            struct Slot
+            {
+                cJSON *node;
+                uint32_t hash;
+                uint32_t keyLength;
+            };
+
+            cJSON *Find(const StringView &key) const noexcept;
+
+            cJSON *m_object;
+            /* open addressing with linear probing, a power of two in size and never more than half full */
+            Vector<Slot> m_slots;
         };
     } // namespace Crt
 } // namespace Aws
@@ -0,0 +1,204 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/SmallVector.h>
+#include <aws/crt/Types.h>
+#include <aws/crt/http/HttpBodySink.h>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        enum class JsonReaderEventType
+        {
+            BeginObject,
+            EndObject,
+            BeginArray,
+            EndArray,
+            Key,
+            String,
+            Number,
+            Bool,
+            Null,
+        };
+
+        /**
+         * One step through a JSON document, as reported by JsonStreamReader.
+         */
+        struct AWS_CRT_CPP_API JsonReaderEvent
+        {
+            JsonReaderEventType Type = JsonReaderEventType::Null;
+            /**
+             * The unescaped text of a Key or String, or a Number as it was written. Empty for everything else.
+             * Only valid for the duration of the callback.
+             */
+            StringView Text;
+            /**
+             * The value of a Number.
+             */
+            double Number = 0;
+            /**
+             * The value of a Bool.
+             */
+            bool Bool = false;
+            /**
+             * How many arrays and objects enclose the event. A member's Key is at the same depth as its value, and
+             * the BeginObject and EndObject of the document's root are at depth 0.
+             */
+            size_t Depth = 0;
+        };
+
+        using OnJsonReaderEvent = Function<void(const JsonReaderEvent &event)>;
+
+        /**
+         * Reads one JSON document handed over in arbitrary chunks, such as a response body as it arrives, reporting
+         * each key, value and bracket as it is read. Nothing is kept of the document but the nesting of the arrays
+         * and objects the reader is in, and the key, string or number being read when a chunk ends in the middle of
+         * it, so memory is bounded by the depth of the document and its longest token, whatever its size.
+         *
+         * Parsing is as strict as RFC 8259. The first malformed byte, token over the length limit or container past
+         * MaxDepth breaks the reader: Feed() and Finish() fail from then on with AWS_ERROR_MALFORMED_INPUT_STRING.
+         */
+        class AWS_CRT_CPP_API JsonStreamReader final
+        {
+          public:
+            /**
+             * The longest key, string or number a reader accepts by default.
+             */
+            static const size_t DefaultMaxTokenLength = 1024 * 1024;
+
+            /**
+             * The deepest nesting a reader accepts, the same as JsonObject's.
+             */
+            static const size_t MaxDepth = 1000;
+
+            /**
+             * @param maxTokenLength keys, strings and numbers longer than this, escaped, break the reader rather
+             * than being buffered.
+             */
+            JsonStreamReader(
+                OnJsonReaderEvent &&onEvent,
+                size_t maxTokenLength = DefaultMaxTokenLength,
+                Allocator *allocator = g_allocator) noexcept;
+            ~JsonStreamReader();
+            JsonStreamReader(const JsonStreamReader &) = delete;
+            JsonStreamReader(JsonStreamReader &&) = delete;
+            JsonStreamReader &operator=(const JsonStreamReader &) = delete;
+            JsonStreamReader &operator=(JsonStreamReader &&) = delete;
+
+            /**
+             * Reads the next chunk of the document, invoking the event callback for everything it completes.
+             * @return false, with the error raised, once the document has turned out to be malformed.
+             */
+            bool Feed(const ByteCursor &data) noexcept;
+
+            /**
+             * Signals the end of the document, which completes a number at the very end of it.
+             * @return false, with the error raised, if the document is malformed or incomplete.
+             */
+            bool Finish() noexcept;
+
+            /**
+             * @return true once a whole value has been read. A number at the end of the document only counts once
+             * Finish() is called.
+             */
+            bool IsComplete() const noexcept { return m_state == ReaderState::Done && m_token == TokenKind::None; }
+
+            /**
+             * @return false once the reader is broken.
+             */
+            explicit operator bool() const noexcept { return m_lastError == AWS_ERROR_SUCCESS; }
+
+            /**
+             * @return the error that broke the reader.
+             */
+            int LastError() const noexcept { return m_lastError; }
+
+            /**
+             * @return how many arrays and objects the reader is in.
+             */
+            size_t GetDepth() const noexcept { return m_containers.size(); }
+
+            /**
+             * @return the size of the buffers used for tokens split across chunks and for unescaped text.
+             */
+            size_t GetBufferCapacity() const noexcept { return m_tokenBuffer.capacity + m_text.capacity; }
+
+          private:
+            enum class ReaderState : uint8_t
+            {
+                Value,
+                ValueOrEnd,
+                Key,
+                KeyOrEnd,
+                Colon,
+                CommaOrEnd,
+                Done,
+            };
+
+            enum class TokenKind : uint8_t
+            {
+                None,
+                String,
+                Key,
+                Atom,
+            };
+
+            bool ReadStructural(const uint8_t *&cursor) noexcept;
+            bool ReadToken(const uint8_t *&cursor, const uint8_t *end) noexcept;
+            bool EmitToken(TokenKind kind, const uint8_t *begin, const uint8_t *end) noexcept;
+            bool Open(uint8_t bracket) noexcept;
+            bool Close(uint8_t bracket) noexcept;
+            void Emit(JsonReaderEventType type, size_t depth) noexcept;
+            void FinishValue() noexcept;
+            bool Fail(int errorCode) noexcept;
+
+            Allocator *m_allocator;
+            OnJsonReaderEvent m_onEvent;
+            size_t m_maxTokenLength;
+            /* '{' or '[' for each container the reader is in */
+            SmallVector<uint8_t, 32> m_containers;
+            ReaderState m_state;
+            TokenKind m_token;
+            /* the last byte of the string being read was an unpaired backslash */
+            bool m_escaped;
+            /* the part of the token being read that arrived in earlier chunks */
+            ByteBuf m_tokenBuffer;
+            ByteBuf m_text;
+            JsonReaderEvent m_event;
+            int m_lastError;
+        };
+
+        /**
+         * HttpBodySink that reads a JSON response body with a JsonStreamReader as it arrives. Install it by
+         * assigning GetOnIncomingBody() to HttpRequestOptions::onIncomingBody, and call Finish() on its reader once
+         * the stream completes.
+         *
+         * Events are handed to the callback on the connection's event-loop thread, and each chunk is consumed as
+         * soon as it has been read.
+         */
+        class AWS_CRT_CPP_API JsonBodySink final : public Http::HttpBodySink
+        {
+          public:
+            explicit JsonBodySink(
+                OnJsonReaderEvent &&onEvent,
+                size_t maxTokenLength = JsonStreamReader::DefaultMaxTokenLength,
+                Allocator *allocator = g_allocator) noexcept;
+
+            JsonStreamReader &GetReader() noexcept { return m_reader; }
+
+            /**
+             * Invoked once if the body turns out to be malformed. The rest of the body is ignored.
+             */
+            Function<void(int errorCode)> OnParseError;
+
+          protected:
+            size_t OnBodyData(const ByteCursor &data) noexcept override;
+
+          private:
+            JsonStreamReader m_reader;
+        };
+    } // namespace Crt
+} // namespace Aws
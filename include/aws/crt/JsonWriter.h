@@ -0,0 +1,96 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/SmallVector.h>
+#include <aws/crt/Types.h>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        /**
+         * Writes compact JSON straight into a ByteBuf, in one pass and without building a JsonObject first, for
+         * payloads serialized from data that already exists. Calls chain:
+         *
+         *     writer.BeginObject().Key("id").WriteInt64(id).Key("tags").BeginArray().WriteString(tag).EndArray()
+         *         .EndObject();
+         *
+         * Output that does not fit is appended with aws_byte_buf_append_dynamic() if the buffer has an allocator,
+         * so reserving capacity up front avoids every reallocation, and fails with AWS_ERROR_SHORT_BUFFER if it
+         * does not. A call out of place, such as a value where a key is due or an EndArray() closing an object,
+         * fails with AWS_ERROR_INVALID_STATE. The first failure breaks the writer: everything after it is ignored,
+         * and what was written so far is left in the buffer.
+         *
+         * Strings are escaped and numbers formatted the way JsonView::WriteCompact() does it.
+         */
+        class AWS_CRT_CPP_API JsonWriter final
+        {
+          public:
+            /**
+             * The writer appends to output, which must outlive it.
+             */
+            explicit JsonWriter(ByteBuf &output) noexcept;
+            JsonWriter(const JsonWriter &) = delete;
+            JsonWriter(JsonWriter &&) = delete;
+            JsonWriter &operator=(const JsonWriter &) = delete;
+            JsonWriter &operator=(JsonWriter &&) = delete;
+
+            JsonWriter &BeginObject() noexcept;
+            JsonWriter &EndObject() noexcept;
+            JsonWriter &BeginArray() noexcept;
+            JsonWriter &EndArray() noexcept;
+
+            /**
+             * Writes the key of the next member of the current object.
+             */
+            JsonWriter &Key(const StringView &key) noexcept;
+
+            JsonWriter &WriteString(const StringView &value) noexcept;
+            JsonWriter &WriteBool(bool value) noexcept;
+            JsonWriter &WriteInt64(int64_t value) noexcept;
+            /**
+             * Non-finite values are written as null, like JsonView::WriteCompact() does.
+             */
+            JsonWriter &WriteDouble(double value) noexcept;
+            JsonWriter &WriteNull() noexcept;
+
+            /**
+             * Writes json, which must already be a whole, valid JSON value, as is.
+             */
+            JsonWriter &WriteRaw(const StringView &json) noexcept;
+
+            /**
+             * @return true once a whole value has been written.
+             */
+            bool IsComplete() const noexcept { return m_containers.empty() && m_wroteValue; }
+
+            /**
+             * @return false once the writer is broken.
+             */
+            explicit operator bool() const noexcept { return m_lastError == AWS_ERROR_SUCCESS; }
+
+            /**
+             * @return the error that broke the writer.
+             */
+            int LastError() const noexcept { return m_lastError; }
+
+          private:
+            bool BeginValue() noexcept;
+            bool Append(const void *data, size_t length) noexcept;
+            bool AppendString(const StringView &value) noexcept;
+            void Fail(int errorCode) noexcept;
+
+            ByteBuf &m_output;
+            /* '{' or '[' for each container being written */
+            SmallVector<uint8_t, 32> m_containers;
+            /* the current container already has a member or element, so the next one needs a comma */
+            bool m_needComma;
+            /* a key was written, and its value is due */
+            bool m_afterKey;
+            bool m_wroteValue;
+            int m_lastError;
+        };
+    } // namespace Crt
+} // namespace Aws
@@ -0,0 +1,97 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/Exports.h>
+#include <aws/crt/StlAllocator.h>
+
+#include <atomic>
+#include <cstddef>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        /**
+         * Size-class pool allocator with per-thread free lists.
+         *
+         * Allocations up to MaxPooledSize bytes are rounded up to a size class and, once released on a thread that
+         * allocates from the pool, are kept on a free list owned by that thread so the next allocation of that class
+         * on the same thread is served without touching the parent allocator or taking any lock. Larger allocations
+         * go straight to the parent.
+         *
+         * The pool is reference counted: Create() returns it with one reference owned by the caller, every thread
+         * that allocates through it holds one more until the thread exits or calls TrimThreadCache(), and so does
+         * every block until it is released. The pool is destroyed when the last reference is dropped, so it is safe
+         * for event-loop threads, and blocks still in use, to outlive the caller's Release().
+         *
+         * ApiHandle installs one of these as the global allocator when ApiHandleOptions::EnableThreadCachingPool is
+         * set.
+         */
+        class AWS_CRT_CPP_API PoolAllocator final
+        {
+          public:
+            /**
+             * Largest allocation size served from the per-thread free lists.
+             */
+            static const size_t MaxPooledSize = 512;
+
+            /**
+             * Maximum number of free blocks, per size class, a single thread keeps cached before returning them to
+             * the parent allocator.
+             */
+            static const size_t MaxCachedBlocksPerClass = 256;
+
+            /**
+             * Creates a new pool on top of parent. The caller owns one reference and must call Release() when
+             * finished with it.
+             */
+            static PoolAllocator *Create(Allocator *parent = g_allocator) noexcept;
+
+            PoolAllocator(const PoolAllocator &) = delete;
+            PoolAllocator(PoolAllocator &&) = delete;
+            PoolAllocator &operator=(const PoolAllocator &) = delete;
+            PoolAllocator &operator=(PoolAllocator &&) = delete;
+
+            /**
+             * Trims the calling thread's cache and drops the reference obtained from Create().
+             */
+            void Release() noexcept;
+
+            /**
+             * Returns every block cached by the calling thread to the parent allocator and detaches the thread from
+             * the pool.
+             */
+            void TrimThreadCache() noexcept;
+
+            /**
+             * @return the pool as an Allocator *, usable anywhere the CRT takes an allocator.
+             */
+            Allocator *GetUnderlyingHandle() noexcept { return &m_allocator; }
+
+            /**
+             * @return the allocator blocks are acquired from.
+             */
+            Allocator *GetParent() const noexcept { return m_parent; }
+
+          private:
+            explicit PoolAllocator(Allocator *parent) noexcept;
+            ~PoolAllocator() = default;
+
+            void Acquire() noexcept;
+            void Unref() noexcept;
+
+            static void *s_MemAcquire(Allocator *allocator, size_t size);
+            static void s_MemRelease(Allocator *allocator, void *ptr);
+            static void *s_MemRealloc(Allocator *allocator, void *ptr, size_t oldSize, size_t newSize);
+            static void *s_MemCalloc(Allocator *allocator, size_t num, size_t size);
+
+            Allocator m_allocator;
+            Allocator *m_parent;
+            std::atomic<size_t> m_refCount;
+
+            friend struct PoolThreadCache;
+        };
+    } // namespace Crt
+} // namespace Aws
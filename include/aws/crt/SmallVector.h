@@ -0,0 +1,255 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/StlAllocator.h>
+
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        /**
+         * Contiguous container with room for N elements inline. Until it grows past N elements it never touches the
+         * heap; after that it spills to storage obtained through StlAllocator<T> on the allocator it was constructed
+         * with, behaving like Crt::Vector from then on.
+         *
+         * The interface is the commonly used subset of std::vector. Iterators are raw pointers and, as with
+         * std::vector, are invalidated by anything that changes capacity. Moving a SmallVector that is still inline
+         * moves its elements one at a time rather than stealing a buffer.
+         */
+        template <typename T, size_t N> class SmallVector
+        {
+            static_assert(N > 0, "SmallVector needs an inline capacity of at least one element");
+
+          public:
+            using value_type = T;
+            using size_type = size_t;
+            using reference = T &;
+            using const_reference = const T &;
+            using pointer = T *;
+            using const_pointer = const T *;
+            using iterator = T *;
+            using const_iterator = const T *;
+
+            static const size_t InlineCapacity = N;
+
+            explicit SmallVector(Allocator *allocator = g_allocator) noexcept
+                : m_allocator(allocator), m_data(InlineData()), m_size(0), m_capacity(N)
+            {
+            }
+
+            SmallVector(std::initializer_list<T> init, Allocator *allocator = g_allocator)
+                : SmallVector(allocator)
+            {
+                reserve(init.size());
+                for (const T &value : init)
+                {
+                    new (m_data + m_size) T(value);
+                    ++m_size;
+                }
+            }
+
+            SmallVector(const SmallVector &other) : SmallVector(other.m_allocator) { CopyFrom(other); }
+
+            SmallVector(SmallVector &&other) noexcept(std::is_nothrow_move_constructible<T>::value)
+                : SmallVector(other.m_allocator)
+            {
+                MoveFrom(other);
+            }
+
+            ~SmallVector()
+            {
+                clear();
+                ReleaseHeap();
+            }
+
+            SmallVector &operator=(const SmallVector &other)
+            {
+                if (this != &other)
+                {
+                    clear();
+                    CopyFrom(other);
+                }
+
+                return *this;
+            }
+
+            SmallVector &operator=(SmallVector &&other) noexcept(std::is_nothrow_move_constructible<T>::value)
+            {
+                if (this != &other)
+                {
+                    clear();
+                    ReleaseHeap();
+                    m_allocator = other.m_allocator;
+                    MoveFrom(other);
+                }
+
+                return *this;
+            }
+
+            T *begin() noexcept { return m_data; }
+            const T *begin() const noexcept { return m_data; }
+            T *end() noexcept { return m_data + m_size; }
+            const T *end() const noexcept { return m_data + m_size; }
+
+            T *data() noexcept { return m_data; }
+            const T *data() const noexcept { return m_data; }
+
+            T &operator[](size_t index) noexcept { return m_data[index]; }
+            const T &operator[](size_t index) const noexcept { return m_data[index]; }
+
+            T &front() noexcept { return m_data[0]; }
+            const T &front() const noexcept { return m_data[0]; }
+            T &back() noexcept { return m_data[m_size - 1]; }
+            const T &back() const noexcept { return m_data[m_size - 1]; }
+
+            size_t size() const noexcept { return m_size; }
+            size_t capacity() const noexcept { return m_capacity; }
+            bool empty() const noexcept { return m_size == 0; }
+
+            /**
+             * @return true while the elements still live in the inline buffer.
+             */
+            bool IsInline() const noexcept { return m_data == InlineData(); }
+
+            /**
+             * @return the allocator used if the container spills out of its inline buffer.
+             */
+            Allocator *GetAllocator() const noexcept { return m_allocator; }
+
+            void reserve(size_t newCapacity)
+            {
+                if (newCapacity > m_capacity)
+                {
+                    Reallocate(newCapacity);
+                }
+            }
+
+            void push_back(const T &value) { emplace_back(value); }
+            void push_back(T &&value) { emplace_back(std::move(value)); }
+
+            template <typename... Args> T &emplace_back(Args &&... args)
+            {
+                if (m_size == m_capacity)
+                {
+                    /* construct first, arguments may alias an element that the reallocation would move */
+                    T value(std::forward<Args>(args)...);
+                    Reallocate(m_capacity * 2);
+                    new (m_data + m_size) T(std::move(value));
+                }
+                else
+                {
+                    new (m_data + m_size) T(std::forward<Args>(args)...);
+                }
+
+                return m_data[m_size++];
+            }
+
+            void pop_back() noexcept
+            {
+                --m_size;
+                m_data[m_size].~T();
+            }
+
+            void resize(size_t newSize)
+            {
+                reserve(newSize);
+                while (m_size > newSize)
+                {
+                    pop_back();
+                }
+                while (m_size < newSize)
+                {
+                    new (m_data + m_size) T();
+                    ++m_size;
+                }
+            }
+
+            void clear() noexcept
+            {
+                while (m_size > 0)
+                {
+                    pop_back();
+                }
+            }
+
+          private:
+            T *InlineData() noexcept { return reinterpret_cast<T *>(&m_inline); }
+            const T *InlineData() const noexcept { return reinterpret_cast<const T *>(&m_inline); }
+
+            void Reallocate(size_t newCapacity)
+            {
+                StlAllocator<T> allocator(m_allocator);
+                T *newData = allocator.allocate(newCapacity);
+                AWS_FATAL_ASSERT(newData != nullptr);
+
+                for (size_t i = 0; i < m_size; ++i)
+                {
+                    new (newData + i) T(std::move_if_noexcept(m_data[i]));
+                    m_data[i].~T();
+                }
+
+                ReleaseHeap();
+                m_data = newData;
+                m_capacity = newCapacity;
+            }
+
+            void ReleaseHeap() noexcept
+            {
+                if (!IsInline())
+                {
+                    StlAllocator<T>(m_allocator).deallocate(m_data, m_capacity);
+                    m_data = InlineData();
+                    m_capacity = N;
+                }
+            }
+
+            void CopyFrom(const SmallVector &other)
+            {
+                reserve(other.m_size);
+                for (const T &value : other)
+                {
+                    new (m_data + m_size) T(value);
+                    ++m_size;
+                }
+            }
+
+            /* expects this to be empty and inline */
+            void MoveFrom(SmallVector &other)
+            {
+                if (!other.IsInline())
+                {
+                    m_data = other.m_data;
+                    m_size = other.m_size;
+                    m_capacity = other.m_capacity;
+                    other.m_data = other.InlineData();
+                    other.m_size = 0;
+                    other.m_capacity = N;
+                    return;
+                }
+
+                for (T &value : other)
+                {
+                    new (m_data + m_size) T(std::move(value));
+                    ++m_size;
+                }
+                other.clear();
+            }
+
+            Allocator *m_allocator;
+            T *m_data;
+            size_t m_size;
+            size_t m_capacity;
+            typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type m_inline;
+        };
+
+        template <typename T, size_t N> const size_t SmallVector<T, N>::InlineCapacity;
+    } // namespace Crt
+} // namespace Aws
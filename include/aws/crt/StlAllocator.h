@@ -42,6 +42,16 @@ namespace Aws
                 typedef StlAllocator<U> other;
             };
 
+            /*
+             * Allocators compare equal when they share an underlying Allocator. Containers steal the allocator along
+             * with the storage on move assignment and swap, so moves are always O(1) pointer swaps, never
+             * element-wise copies. Copy assignment keeps the destination's allocator.
+             */
+            using propagate_on_container_copy_assignment = std::false_type;
+            using propagate_on_container_move_assignment = std::true_type;
+            using propagate_on_container_swap = std::true_type;
+            using is_always_equal = std::false_type;
+
             using RawPointer = typename std::allocator_traits<std::allocator<T>>::pointer;
 
             RawPointer allocate(size_type n, const void *hint = nullptr)
@@ -59,5 +69,17 @@ namespace Aws
 
             Allocator *m_allocator;
         };
+
+        template <typename T, typename U>
+        bool operator==(const StlAllocator<T> &lhs, const StlAllocator<U> &rhs) noexcept
+        {
+            return lhs.m_allocator == rhs.m_allocator;
+        }
+
+        template <typename T, typename U>
+        bool operator!=(const StlAllocator<T> &lhs, const StlAllocator<U> &rhs) noexcept
+        {
+            return !(lhs == rhs);
+        }
     } // namespace Crt
 } // namespace Aws
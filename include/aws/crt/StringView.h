@@ -10,14 +10,23 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <iterator>
 #include <stddef.h>
+#include <string>
 #include <type_traits>
 
 #if __cplusplus >= 201703L || (defined(_MSC_LANG) && _MSC_LANG >= 201703L)
 #    include <string_view>
 #endif
 
+/* loops in constexpr functions need C++14 */
+#if __cplusplus >= 201402L || (defined(_MSC_LANG) && _MSC_LANG >= 201402L)
+#    define AWS_CRT_CPP_CONSTEXPR14 constexpr
+#else
+#    define AWS_CRT_CPP_CONSTEXPR14 inline
+#endif
+
 namespace Aws
 {
     namespace Crt
@@ -813,22 +822,22 @@ namespace Aws
         {
             inline namespace string_view_literals
             {
-                inline basic_string_view<char> operator"" _sv(const char *s, size_t length) noexcept
+                constexpr basic_string_view<char> operator"" _sv(const char *s, size_t length) noexcept
                 {
                     return basic_string_view<char>(s, length);
                 }
 
-                inline basic_string_view<wchar_t> operator"" _sv(const wchar_t *s, size_t length) noexcept
+                constexpr basic_string_view<wchar_t> operator"" _sv(const wchar_t *s, size_t length) noexcept
                 {
                     return basic_string_view<wchar_t>(s, length);
                 }
 
-                inline basic_string_view<char16_t> operator"" _sv(const char16_t *s, size_t length) noexcept
+                constexpr basic_string_view<char16_t> operator"" _sv(const char16_t *s, size_t length) noexcept
                 {
                     return basic_string_view<char16_t>(s, length);
                 }
 
-                inline basic_string_view<char32_t> operator"" _sv(const char32_t *s, size_t length) noexcept
+                constexpr basic_string_view<char32_t> operator"" _sv(const char32_t *s, size_t length) noexcept
                 {
                     return basic_string_view<char32_t>(s, length);
                 }
@@ -837,6 +846,154 @@ namespace Aws
         } // namespace literals
 
         using StringView = string_view;
+
+        /**
+         * @return c in lower case if it is an ASCII upper-case letter, otherwise c. Bytes of multi-byte UTF-8
+         * sequences are left alone.
+         */
+        constexpr char ToLowerAscii(char c) noexcept
+        {
+            return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+        }
+
+        /**
+         * 64-bit FNV-1a hash of the bytes of str. Unlike std::hash it never copies str, and from C++14 on it can be
+         * evaluated at compile time, e.g. HashStringView("content-type"_sv) as a case label.
+         */
+        AWS_CRT_CPP_CONSTEXPR14 uint64_t HashStringView(StringView str) noexcept
+        {
+            uint64_t hash = 14695981039346656037ULL;
+            for (size_t i = 0; i < str.size(); ++i)
+            {
+                hash ^= static_cast<uint8_t>(str.data()[i]);
+                hash *= 1099511628211ULL;
+            }
+
+            return hash;
+        }
+
+        /**
+         * HashStringView() of str with ASCII letters in lower case, so strings that EqualsCaseInsensitive() hash
+         * alike.
+         */
+        AWS_CRT_CPP_CONSTEXPR14 uint64_t HashStringViewCaseInsensitive(StringView str) noexcept
+        {
+            uint64_t hash = 14695981039346656037ULL;
+            for (size_t i = 0; i < str.size(); ++i)
+            {
+                hash ^= static_cast<uint8_t>(ToLowerAscii(str.data()[i]));
+                hash *= 1099511628211ULL;
+            }
+
+            return hash;
+        }
+
+        /**
+         * Compares lhs and rhs like StringView::compare(), ignoring the case of ASCII letters, as HTTP header names
+         * are compared.
+         * @return a negative value, zero or a positive value if lhs sorts before, with or after rhs.
+         */
+        AWS_CRT_CPP_CONSTEXPR14 int CompareCaseInsensitive(StringView lhs, StringView rhs) noexcept
+        {
+            const size_t compareLen = lhs.size() < rhs.size() ? lhs.size() : rhs.size();
+            for (size_t i = 0; i < compareLen; ++i)
+            {
+                const auto l = static_cast<uint8_t>(ToLowerAscii(lhs.data()[i]));
+                const auto r = static_cast<uint8_t>(ToLowerAscii(rhs.data()[i]));
+                if (l != r)
+                {
+                    return l < r ? -1 : 1;
+                }
+            }
+
+            if (lhs.size() == rhs.size())
+            {
+                return 0;
+            }
+
+            return lhs.size() < rhs.size() ? -1 : 1;
+        }
+
+        AWS_CRT_CPP_CONSTEXPR14 bool EqualsCaseInsensitive(StringView lhs, StringView rhs) noexcept
+        {
+            return lhs.size() == rhs.size() && CompareCaseInsensitive(lhs, rhs) == 0;
+        }
+
+        namespace Detail
+        {
+            inline StringView ViewOf(StringView str) noexcept { return str; }
+
+            template <typename Allocator>
+            StringView ViewOf(const std::basic_string<char, std::char_traits<char>, Allocator> &str) noexcept
+            {
+                return StringView(str.data(), str.size());
+            }
+        } // namespace Detail
+
+        /**
+         * Hash and equality for unordered containers keyed by StringView, or by String: a lookup by StringView
+         * neither allocates nor copies.
+         *
+         *     std::unordered_map<StringView, int, StringViewHash, StringViewEqual, StlAllocator<...>> routes;
+         *
+         * They are transparent, so from C++20 on a container keyed by String can be searched with a StringView as
+         * well. Keys may also be String or const char *.
+         */
+        struct StringViewHash
+        {
+            using is_transparent = void;
+
+            template <typename Key> size_t operator()(const Key &key) const noexcept
+            {
+                return static_cast<size_t>(HashStringView(Detail::ViewOf(key)));
+            }
+        };
+
+        struct StringViewEqual
+        {
+            using is_transparent = void;
+
+            template <typename Lhs, typename Rhs> bool operator()(const Lhs &lhs, const Rhs &rhs) const noexcept
+            {
+                return Detail::ViewOf(lhs) == Detail::ViewOf(rhs);
+            }
+        };
+
+        /**
+         * Case-insensitive counterparts of StringViewHash and StringViewEqual, for HTTP header names and the like.
+         */
+        struct StringViewCaseInsensitiveHash
+        {
+            using is_transparent = void;
+
+            template <typename Key> size_t operator()(const Key &key) const noexcept
+            {
+                return static_cast<size_t>(HashStringViewCaseInsensitive(Detail::ViewOf(key)));
+            }
+        };
+
+        struct StringViewCaseInsensitiveEqual
+        {
+            using is_transparent = void;
+
+            template <typename Lhs, typename Rhs> bool operator()(const Lhs &lhs, const Rhs &rhs) const noexcept
+            {
+                return EqualsCaseInsensitive(Detail::ViewOf(lhs), Detail::ViewOf(rhs));
+            }
+        };
+
+        /**
+         * Case-insensitive ordering, for ordered containers such as Map.
+         */
+        struct StringViewCaseInsensitiveLess
+        {
+            using is_transparent = void;
+
+            template <typename Lhs, typename Rhs> bool operator()(const Lhs &lhs, const Rhs &rhs) const noexcept
+            {
+                return CompareCaseInsensitive(Detail::ViewOf(lhs), Detail::ViewOf(rhs)) < 0;
+            }
+        };
     } // namespace Crt
 } // namespace Aws
 
@@ -852,7 +1009,13 @@ namespace std
     size_t hash<Aws::Crt::basic_string_view<CharT, Traits>>::operator()(
         const Aws::Crt::basic_string_view<CharT, Traits> &val) const noexcept
     {
+#if __cplusplus >= 201703L || (defined(_MSC_LANG) && _MSC_LANG >= 201703L)
+        /* hashes like std::hash<std::basic_string>, without the copy */
+        return std::hash<std::basic_string_view<CharT, Traits>>()(
+            std::basic_string_view<CharT, Traits>(val.data(), val.size()));
+#else
         auto str = std::basic_string<CharT, Traits>(val.data(), val.size());
         return std::hash<std::basic_string<CharT, Traits>>()(str);
+#endif
     }
 } // namespace std
@@ -0,0 +1,124 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/Exports.h>
+#include <aws/crt/StlAllocator.h>
+
+#include <atomic>
+#include <cstddef>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        /**
+         * Subsystems allocations are attributed to by a TracingAllocator.
+         */
+        enum class AllocationSubsystem
+        {
+            /**
+             * The C++ bindings themselves: StlAllocator, New<T>/Delete<T>, String and friends.
+             */
+            Crt,
+            Http,
+            Mqtt,
+            Auth,
+            Json,
+            EventStream,
+
+            Count
+        };
+
+        /**
+         * Point-in-time counters for allocations made through a TracingAllocator.
+         */
+        struct AWS_CRT_CPP_API AllocationStats
+        {
+            AllocationStats() noexcept;
+
+            /**
+             * Total number of allocations made.
+             */
+            size_t TotalAllocations;
+            /**
+             * Total number of bytes requested.
+             */
+            size_t TotalBytes;
+            /**
+             * Number of allocations not yet released.
+             */
+            size_t LiveAllocations;
+            /**
+             * Number of bytes not yet released.
+             */
+            size_t LiveBytes;
+            /**
+             * Largest value LiveBytes has reached.
+             */
+            size_t HighWaterBytes;
+        };
+
+        /**
+         * Allocator wrapper that counts bytes and allocations, attributing each allocation to the subsystem whose
+         * allocator it was made through. Counters are updated with relaxed atomics, so it is cheap enough to leave
+         * on in production.
+         *
+         * Enable it for the whole process with ApiHandleOptions::EnableAllocationTracing and read it back through
+         * ApiHandle::GetTracingAllocator().
+         */
+        class AWS_CRT_CPP_API TracingAllocator final
+        {
+          public:
+            explicit TracingAllocator(Allocator *parent = g_allocator) noexcept;
+            ~TracingAllocator() = default;
+            TracingAllocator(const TracingAllocator &) = delete;
+            TracingAllocator(TracingAllocator &&) = delete;
+            TracingAllocator &operator=(const TracingAllocator &) = delete;
+            TracingAllocator &operator=(TracingAllocator &&) = delete;
+
+            /**
+             * @return an allocator that attributes its allocations to subsystem. Memory may be released through
+             * any of this tracer's allocators.
+             */
+            Allocator *GetAllocator(AllocationSubsystem subsystem = AllocationSubsystem::Crt) noexcept;
+
+            /**
+             * @return counters for a single subsystem.
+             */
+            AllocationStats GetStats(AllocationSubsystem subsystem) const noexcept;
+
+            /**
+             * @return counters summed over every subsystem. HighWaterBytes is the high-water mark of the sum.
+             */
+            AllocationStats GetTotalStats() const noexcept;
+
+          private:
+            struct Counters
+            {
+                std::atomic<size_t> totalAllocations;
+                std::atomic<size_t> totalBytes;
+                std::atomic<size_t> liveAllocations;
+                std::atomic<size_t> liveBytes;
+                std::atomic<size_t> highWaterBytes;
+            };
+
+            static const size_t SubsystemCount = static_cast<size_t>(AllocationSubsystem::Count);
+
+            void RecordAcquire(size_t subsystem, size_t size) noexcept;
+            void RecordRelease(size_t subsystem, size_t size) noexcept;
+            static AllocationStats s_ToStats(const Counters &counters) noexcept;
+
+            static void *s_MemAcquire(Allocator *allocator, size_t size);
+            static void s_MemRelease(Allocator *allocator, void *ptr);
+            static void *s_MemRealloc(Allocator *allocator, void *ptr, size_t oldSize, size_t newSize);
+            static void *s_MemCalloc(Allocator *allocator, size_t num, size_t size);
+
+            Allocator *m_parent;
+            Allocator m_allocators[SubsystemCount];
+            Counters m_counters[SubsystemCount];
+            Counters m_total;
+        };
+    } // namespace Crt
+} // namespace Aws
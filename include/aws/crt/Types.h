@@ -6,15 +6,21 @@
 #include <aws/common/common.h>
 #include <aws/crt/Exports.h>
 #include <aws/crt/Optional.h>
+#include <aws/crt/SmallVector.h>
 #include <aws/crt/StlAllocator.h>
 #include <aws/crt/StringView.h>
 #include <aws/io/socket.h>
 #include <aws/mqtt/mqtt.h>
+#include <cstddef>
+#include <cstring>
 #include <functional>
 #include <list>
 #include <map>
+#include <memory>
+#include <new>
 #include <sstream>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -66,12 +72,98 @@ namespace Aws
         AWS_CRT_CPP_API ByteCursor ByteCursorFromString(const Crt::String &str) noexcept;
         AWS_CRT_CPP_API ByteCursor ByteCursorFromByteBuf(const ByteBuf &) noexcept;
         AWS_CRT_CPP_API ByteCursor ByteCursorFromArray(const uint8_t *array, size_t len) noexcept;
+        AWS_CRT_CPP_API ByteCursor ByteCursorFromStringView(const StringView &str) noexcept;
+        AWS_CRT_CPP_API ByteCursor ByteCursorFromVector(const Vector<uint8_t> &vec) noexcept;
 
         AWS_CRT_CPP_API Vector<uint8_t> Base64Decode(const String &decode);
         AWS_CRT_CPP_API String Base64Encode(const Vector<uint8_t> &encode);
 
+        /**
+         * Computes the space Base64Encode() needs available in its output buffer to encode inputLen bytes. This
+         * includes room for the null terminator the encoder writes after the encoded data.
+         * Returns false and raises an error if the length overflows.
+         */
+        AWS_CRT_CPP_API bool Base64ComputeEncodedLength(size_t inputLen, size_t &outputLen) noexcept;
+
+        /**
+         * Computes the number of bytes decoding encoded will produce.
+         * Returns false and raises an error if encoded is not valid base64.
+         */
+        AWS_CRT_CPP_API bool Base64ComputeDecodedLength(const ByteCursor &encoded, size_t &outputLen) noexcept;
+
+        /**
+         * Base64 encodes toEncode and appends the result to output without allocating. output must have at least
+         * Base64ComputeEncodedLength() bytes of unused capacity. The terminator is written past output.len but is not
+         * counted in it. Large inputs take the vectorized path in aws-c-common when the CPU supports it.
+         * Returns false and raises an error on failure, in which case output is unchanged.
+         */
+        AWS_CRT_CPP_API bool Base64Encode(const ByteCursor &toEncode, ByteBuf &output) noexcept;
+
+        /**
+         * Decodes base64 encoded data in toDecode and appends the result to output without allocating. output must
+         * have at least Base64ComputeDecodedLength() bytes of unused capacity.
+         * Returns false and raises an error on failure, in which case output.len is unchanged.
+         */
+        AWS_CRT_CPP_API bool Base64Decode(const ByteCursor &toDecode, ByteBuf &output) noexcept;
+
         template <typename RawType, typename TargetType> using TypeConvertor = std::function<TargetType(RawType)>;
 
+        /**
+         * Non-owning, read-only view over the elements of an aws_array_list of T. Lets callers iterate a list
+         * owned by the C layer without copying it into a Vector. The view is only valid as long as the list is
+         * alive and unmodified.
+         */
+        template <typename T> class ArrayListView
+        {
+          public:
+            using value_type = T;
+            using size_type = size_t;
+            using const_reference = const T &;
+            using const_pointer = const T *;
+            using const_iterator = const T *;
+
+            ArrayListView() noexcept : m_data(nullptr), m_size(0) {}
+            explicit ArrayListView(const aws_array_list *array) noexcept : m_data(nullptr), m_size(0)
+            {
+                if (array != nullptr)
+                {
+                    AWS_FATAL_ASSERT(array->length == 0 || array->item_size == sizeof(T));
+                    m_data = static_cast<const T *>(array->data);
+                    m_size = aws_array_list_length(array);
+                }
+            }
+
+            size_t size() const noexcept { return m_size; }
+            bool empty() const noexcept { return m_size == 0; }
+            const T *data() const noexcept { return m_data; }
+            const T &operator[](size_t index) const noexcept { return m_data[index]; }
+            const T *begin() const noexcept { return m_data; }
+            const T *end() const noexcept { return m_data + m_size; }
+
+          private:
+            const T *m_data;
+            size_t m_size;
+        };
+
+        namespace Detail
+        {
+            template <typename Type>
+            void CopyArrayList(const ArrayListView<Type> &view, Vector<Type> &v, std::true_type /*trivial*/)
+            {
+                v.resize(view.size());
+                if (!view.empty())
+                {
+                    memcpy(v.data(), view.data(), view.size() * sizeof(Type));
+                }
+            }
+
+            template <typename Type>
+            void CopyArrayList(const ArrayListView<Type> &view, Vector<Type> &v, std::false_type /*trivial*/)
+            {
+                v.assign(view.begin(), view.end());
+            }
+        } // namespace Detail
+
         /**
          * Template function to convert an aws_array_list of RawType to a C++ like Vector of TargetType.
          * A conversion function should be provided to do the type conversion
@@ -79,12 +171,11 @@ namespace Aws
         template <typename RawType, typename TargetType>
         Vector<TargetType> ArrayListToVector(const aws_array_list *array, TypeConvertor<RawType, TargetType> conv)
         {
+            ArrayListView<RawType> view(array);
             Vector<TargetType> v;
-            size_t cnt = aws_array_list_length(array);
-            for (size_t i = 0; i < cnt; i++)
+            v.reserve(view.size());
+            for (const RawType &t : view)
             {
-                RawType t;
-                aws_array_list_get_at(array, &t, i);
                 v.emplace_back(conv(t));
             }
             return v;
@@ -97,12 +188,11 @@ namespace Aws
         template <typename RawType, typename TargetType>
         Vector<TargetType> ArrayListToVector(const aws_array_list *array)
         {
+            ArrayListView<RawType> view(array);
             Vector<TargetType> v;
-            size_t cnt = aws_array_list_length(array);
-            for (size_t i = 0; i < cnt; i++)
+            v.reserve(view.size());
+            for (const RawType &t : view)
             {
-                RawType t;
-                aws_array_list_get_at(array, &t, i);
                 v.emplace_back(TargetType(t));
             }
             return v;
@@ -110,17 +200,13 @@ namespace Aws
 
         /**
          * Template function to convert an aws_array_list of Type to a C++ like Vector of Type.
+         * Trivially copyable types are copied in a single memcpy.
          */
         template <typename Type> Vector<Type> ArrayListToVector(const aws_array_list *array)
         {
+            ArrayListView<Type> view(array);
             Vector<Type> v;
-            size_t cnt = aws_array_list_length(array);
-            for (size_t i = 0; i < cnt; i++)
-            {
-                Type t;
-                aws_array_list_get_at(array, &t, i);
-                v.emplace_back(t);
-            }
+            Detail::CopyArrayList(view, v, std::integral_constant<bool, std::is_trivially_copyable<Type>::value>());
             return v;
         }
 
@@ -163,5 +249,342 @@ namespace Aws
 
         template <typename T> using ScopedResource = std::unique_ptr<T, std::function<void(T *)>>;
 
+        template <typename Signature, bool Copyable = true> class Function;
+
+        /**
+         * Function that accepts move-only callables and cannot itself be copied.
+         */
+        template <typename Signature> using MoveOnlyFunction = Function<Signature, false>;
+
+        /**
+         * Type-erased callable, used for the per-operation callback types in the bindings in place of std::function.
+         *
+         * Callables up to InlineSize bytes that are nothrow-move-constructible are stored inline, so wrapping the
+         * typical lambda (a few pointers or a shared_ptr) never allocates. Larger callables spill to the heap
+         * through a CRT allocator (g_allocator unless one is passed in) rather than global operator new. Failing to
+         * allocate that storage, when assigning or copying, is fatal, as elsewhere in the CRT.
+         *
+         * A Function only accepts copy-constructible callables, so copying one always works. Move-only callables
+         * need a MoveOnlyFunction, and copying a MoveOnlyFunction fails to compile.
+         */
+        template <typename R, typename... Args, bool Copyable> class Function<R(Args...), Copyable>
+        {
+          private:
+            template <typename F, typename = void> struct IsCallable : std::false_type
+            {
+            };
+
+            template <typename F>
+            struct IsCallable<
+                F,
+                typename std::enable_if<
+                    std::is_void<R>::value ||
+                    std::is_convertible<decltype(std::declval<F &>()(std::declval<Args>()...)), R>::value>::type>
+                : std::true_type
+            {
+            };
+
+            template <typename F>
+            using EnableIfCallable = typename std::enable_if<
+                !std::is_same<typename std::decay<F>::type, Function>::value &&
+                IsCallable<typename std::decay<F>::type>::value &&
+                (!Copyable || std::is_copy_constructible<typename std::decay<F>::type>::value)>::type;
+
+          public:
+            static const size_t InlineSize = 6 * sizeof(void *);
+
+            Function() noexcept : m_ops(nullptr), m_allocator(nullptr) {}
+            Function(std::nullptr_t) noexcept : m_ops(nullptr), m_allocator(nullptr) {}
+
+            template <typename F, typename = EnableIfCallable<F>>
+            Function(F &&f, Allocator *allocator = g_allocator) : m_ops(nullptr), m_allocator(allocator)
+            {
+                Assign(std::forward<F>(f));
+            }
+
+            Function(const Function &other) : m_ops(nullptr), m_allocator(other.m_allocator)
+            {
+                static_assert(Copyable, "A MoveOnlyFunction cannot be copied");
+                if (other.m_ops)
+                {
+                    other.m_ops->copy(other, *this);
+                }
+            }
+
+            Function(Function &&other) noexcept : m_ops(nullptr), m_allocator(other.m_allocator)
+            {
+                if (other.m_ops)
+                {
+                    other.m_ops->move(other, *this);
+                }
+            }
+
+            ~Function() { Reset(); }
+
+            Function &operator=(const Function &other)
+            {
+                static_assert(Copyable, "A MoveOnlyFunction cannot be copied");
+                if (this != &other)
+                {
+                    Function copy(other);
+                    *this = std::move(copy);
+                }
+                return *this;
+            }
+
+            Function &operator=(Function &&other) noexcept
+            {
+                if (this != &other)
+                {
+                    Reset();
+                    m_allocator = other.m_allocator;
+                    if (other.m_ops)
+                    {
+                        other.m_ops->move(other, *this);
+                    }
+                }
+                return *this;
+            }
+
+            Function &operator=(std::nullptr_t) noexcept
+            {
+                Reset();
+                return *this;
+            }
+
+            template <typename F, typename = EnableIfCallable<F>> Function &operator=(F &&f)
+            {
+                Reset();
+                if (m_allocator == nullptr)
+                {
+                    m_allocator = g_allocator;
+                }
+                Assign(std::forward<F>(f));
+                return *this;
+            }
+
+            /**
+             * Invokes the stored callable. Invoking an empty Function is a fatal error.
+             */
+            R operator()(Args... args) const
+            {
+                AWS_FATAL_ASSERT(m_ops != nullptr);
+                return m_ops->invoke(const_cast<Function &>(*this), std::forward<Args>(args)...);
+            }
+
+            /**
+             * @return true if a callable is stored.
+             */
+            explicit operator bool() const noexcept { return m_ops != nullptr; }
+
+            void swap(Function &other) noexcept
+            {
+                Function tmp(std::move(other));
+                other = std::move(*this);
+                *this = std::move(tmp);
+            }
+
+          private:
+            struct Ops
+            {
+                R (*invoke)(Function &self, Args &&... args);
+                void (*copy)(const Function &src, Function &dst);
+                void (*move)(Function &src, Function &dst) noexcept;
+                void (*destroy)(Function &self) noexcept;
+            };
+
+            template <typename F> struct InlinePolicy
+            {
+                static const bool value = sizeof(F) <= InlineSize && alignof(F) <= alignof(std::max_align_t) &&
+                                          std::is_nothrow_move_constructible<F>::value;
+            };
+
+            template <typename F, bool CopyConstructible> struct CopyHelper
+            {
+                static void Copy(const F &src, void *dst) { new (dst) F(src); }
+            };
+
+            /* only a MoveOnlyFunction stores these, and copying one does not compile, so this is never called */
+            template <typename F> struct CopyHelper<F, false>
+            {
+                static void Copy(const F &, void *) {}
+            };
+
+            template <typename F, typename Ret> struct Invoker
+            {
+                static R Invoke(F &f, Args &&... args) { return f(std::forward<Args>(args)...); }
+            };
+
+            template <typename F> struct Invoker<F, void>
+            {
+                static void Invoke(F &f, Args &&... args) { f(std::forward<Args>(args)...); }
+            };
+
+            template <typename F> struct InlineOps
+            {
+                static F &Target(Function &self) noexcept { return *reinterpret_cast<F *>(&self.m_storage); }
+
+                static R Invoke(Function &self, Args &&... args)
+                {
+                    return Invoker<F, R>::Invoke(Target(self), std::forward<Args>(args)...);
+                }
+
+                static void Copy(const Function &src, Function &dst)
+                {
+                    CopyHelper<F, std::is_copy_constructible<F>::value>::Copy(
+                        Target(const_cast<Function &>(src)), &dst.m_storage);
+                    dst.m_ops = src.m_ops;
+                }
+
+                static void Move(Function &src, Function &dst) noexcept
+                {
+                    new (&dst.m_storage) F(std::move(Target(src)));
+                    dst.m_ops = src.m_ops;
+                    Destroy(src);
+                }
+
+                static void Destroy(Function &self) noexcept
+                {
+                    Target(self).~F();
+                    self.m_ops = nullptr;
+                }
+
+                static const Ops s_ops;
+            };
+
+            template <typename F> struct HeapOps
+            {
+                static F &Target(Function &self) noexcept { return *static_cast<F *>(self.m_heap); }
+
+                static R Invoke(Function &self, Args &&... args)
+                {
+                    return Invoker<F, R>::Invoke(Target(self), std::forward<Args>(args)...);
+                }
+
+                static void Copy(const Function &src, Function &dst)
+                {
+                    /* an empty copy would only fail later, when invoked, far from the cause */
+                    void *mem = aws_mem_acquire(dst.m_allocator, sizeof(F));
+                    AWS_FATAL_ASSERT(mem != nullptr);
+                    CopyHelper<F, std::is_copy_constructible<F>::value>::Copy(
+                        Target(const_cast<Function &>(src)), mem);
+                    dst.m_heap = mem;
+                    dst.m_ops = src.m_ops;
+                }
+
+                static void Move(Function &src, Function &dst) noexcept
+                {
+                    dst.m_heap = src.m_heap;
+                    dst.m_ops = src.m_ops;
+                    src.m_heap = nullptr;
+                    src.m_ops = nullptr;
+                }
+
+                static void Destroy(Function &self) noexcept
+                {
+                    Target(self).~F();
+                    aws_mem_release(self.m_allocator, self.m_heap);
+                    self.m_heap = nullptr;
+                    self.m_ops = nullptr;
+                }
+
+                static const Ops s_ops;
+            };
+
+            template <typename F> void Assign(F &&f)
+            {
+                using Decayed = typename std::decay<F>::type;
+                if (IsNull(f))
+                {
+                    return;
+                }
+
+                if (InlinePolicy<Decayed>::value)
+                {
+                    new (&m_storage) Decayed(std::forward<F>(f));
+                    m_ops = &InlineOps<Decayed>::s_ops;
+                    return;
+                }
+
+                if (m_allocator == nullptr)
+                {
+                    m_allocator = DefaultAllocator();
+                }
+
+                void *mem = aws_mem_acquire(m_allocator, sizeof(Decayed));
+                AWS_FATAL_ASSERT(mem != nullptr);
+
+                new (mem) Decayed(std::forward<F>(f));
+                m_heap = mem;
+                m_ops = &HeapOps<Decayed>::s_ops;
+            }
+
+            /* empty std::function and null function pointers produce an empty Function */
+            template <typename F> static bool IsNull(const F &) noexcept { return false; }
+            template <typename Sig> static bool IsNull(const std::function<Sig> &f) noexcept { return !f; }
+            template <typename Ret, typename... FArgs> static bool IsNull(Ret (*f)(FArgs...)) noexcept
+            {
+                return f == nullptr;
+            }
+
+            void Reset() noexcept
+            {
+                if (m_ops)
+                {
+                    m_ops->destroy(*this);
+                }
+            }
+
+            union
+            {
+                typename std::aligned_storage<InlineSize, alignof(std::max_align_t)>::type m_storage;
+                void *m_heap;
+            };
+            const Ops *m_ops;
+            Allocator *m_allocator;
+        };
+
+        template <typename R, typename... Args, bool Copyable> const size_t Function<R(Args...), Copyable>::InlineSize;
+
+        template <typename R, typename... Args, bool Copyable>
+        template <typename F>
+        const typename Function<R(Args...), Copyable>::Ops Function<R(Args...), Copyable>::InlineOps<F>::s_ops = {
+            &Function<R(Args...), Copyable>::InlineOps<F>::Invoke,
+            &Function<R(Args...), Copyable>::InlineOps<F>::Copy,
+            &Function<R(Args...), Copyable>::InlineOps<F>::Move,
+            &Function<R(Args...), Copyable>::InlineOps<F>::Destroy};
+
+        template <typename R, typename... Args, bool Copyable>
+        template <typename F>
+        const typename Function<R(Args...), Copyable>::Ops Function<R(Args...), Copyable>::HeapOps<F>::s_ops = {
+            &Function<R(Args...), Copyable>::HeapOps<F>::Invoke,
+            &Function<R(Args...), Copyable>::HeapOps<F>::Copy,
+            &Function<R(Args...), Copyable>::HeapOps<F>::Move,
+            &Function<R(Args...), Copyable>::HeapOps<F>::Destroy};
+
+        template <typename R, typename... Args, bool Copyable>
+        bool operator==(const Function<R(Args...), Copyable> &f, std::nullptr_t) noexcept
+        {
+            return !f;
+        }
+
+        template <typename R, typename... Args, bool Copyable>
+        bool operator==(std::nullptr_t, const Function<R(Args...), Copyable> &f) noexcept
+        {
+            return !f;
+        }
+
+        template <typename R, typename... Args, bool Copyable>
+        bool operator!=(const Function<R(Args...), Copyable> &f, std::nullptr_t) noexcept
+        {
+            return static_cast<bool>(f);
+        }
+
+        template <typename R, typename... Args, bool Copyable>
+        bool operator!=(std::nullptr_t, const Function<R(Args...), Copyable> &f) noexcept
+        {
+            return static_cast<bool>(f);
+        }
+
     } // namespace Crt
 } // namespace Aws
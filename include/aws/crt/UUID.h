@@ -35,5 +35,61 @@ namespace Aws
             aws_uuid m_uuid;
             bool m_good;
         };
+
+        /**
+         * Generates random (version 4) UUIDs in bulk, for callers that need a great many of them, such as one per
+         * message. Randomness is drawn from the system in blocks of RandomBlockSize bytes rather than once per UUID,
+         * and strings are formatted straight into caller-provided buffers, with SSE2 where it is available. Nothing
+         * is allocated after construction.
+         *
+         * Not thread-safe; give each thread its own, e.g. a thread_local one.
+         */
+        class AWS_CRT_CPP_API UUIDGenerator final
+        {
+          public:
+            /**
+             * Length of a formatted UUID, e.g. "2e6f8b2c-3a4d-4c1e-9f0a-5b6c7d8e9f01", without a NUL terminator.
+             */
+            static const size_t StringLength = 36;
+
+            /**
+             * Random bytes drawn from the system at a time, enough for 256 UUIDs.
+             */
+            static const size_t RandomBlockSize = 4096;
+
+            UUIDGenerator() noexcept;
+            UUIDGenerator(const UUIDGenerator &) = delete;
+            UUIDGenerator &operator=(const UUIDGenerator &) = delete;
+
+            /**
+             * Generates a UUID.
+             * @return true on success, false if the system could not provide randomness.
+             */
+            bool Generate(aws_uuid &uuid) noexcept;
+
+            /**
+             * Generates a UUID and formats it into out, which must have room for StringLength chars. No NUL
+             * terminator is written.
+             */
+            bool Generate(char *out) noexcept;
+
+            /**
+             * Generates count UUIDs, formatted back to back into out, which must have room for count *
+             * StringLength chars.
+             */
+            bool Generate(char *out, size_t count) noexcept;
+
+            /**
+             * Formats uuid into out, which must have room for StringLength chars, in lowercase hex. No NUL
+             * terminator is written.
+             */
+            static void Format(const aws_uuid &uuid, char *out) noexcept;
+
+          private:
+            bool Refill() noexcept;
+
+            uint8_t m_random[RandomBlockSize];
+            size_t m_offset;
+        };
     } // namespace Crt
 } // namespace Aws
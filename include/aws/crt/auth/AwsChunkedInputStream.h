@@ -0,0 +1,106 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/auth/Sigv4Signing.h>
+#include <aws/crt/crypto/HMAC.h>
+#include <aws/crt/io/Stream.h>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Auth
+        {
+            /**
+             * InputStream decorator that turns another stream into an aws-chunked body signed chunk by chunk
+             * (STREAMING-AWS4-HMAC-SHA256-PAYLOAD), as it is read. Each chunk is framed as
+             *
+             *     hex(size);chunk-signature=<signature>\r\n<data>\r\n
+             *
+             * with every signature chained to the one before it, starting from the signature of the request, and
+             * an empty chunk ends the body. Large uploads are then signed in the same pass that sends them, rather
+             * than hashed in full before the request can be signed.
+             *
+             * To use it, set Content-Encoding: aws-chunked, x-amz-decoded-content-length to the length of the
+             * payload and Content-Length to GetEncodedLength() on the request, sign it with a config whose signed
+             * body value is SignedBodyValue::StreamingAws4HmacSha256Payload, then wrap the payload with the same
+             * config and GetRequestSignature() of the signed request.
+             *
+             * Rewinding to the beginning, as a retried request does, restarts the chain of signatures. Any other
+             * seek fails with AWS_ERROR_STREAM_UNSEEKABLE.
+             */
+            class AWS_CRT_CPP_API AwsChunkedInputStream final : public Io::InputStream
+            {
+              public:
+                static const size_t DefaultChunkSize = 64 * 1024;
+
+                /**
+                 * Signs the chunks of source, which must be positioned at its beginning, for the time, region and
+                 * service of config with the credentials config carries; a config that only has a credentials
+                 * provider is not valid here. seedSignature is the hex signature of the request the stream is the
+                 * body of. Every chunk but the last holds chunkSize bytes of source. The signing key is derived once,
+                 * here, and keys every chunk signature of the stream.
+                 */
+                AwsChunkedInputStream(
+                    const std::shared_ptr<Io::InputStream> &source,
+                    const AwsSigningConfig &config,
+                    const ByteCursor &seedSignature,
+                    size_t chunkSize = DefaultChunkSize,
+                    Allocator *allocator = g_allocator) noexcept;
+                ~AwsChunkedInputStream();
+
+                bool IsValid() const noexcept override;
+
+                /**
+                 * @return how long the aws-chunked body of payloadLength bytes is, for its Content-Length.
+                 */
+                static uint64_t GetEncodedLength(uint64_t payloadLength, size_t chunkSize = DefaultChunkSize) noexcept;
+
+                /**
+                 * Finds the hex signature in the Authorization header of a signed request, to seed the chunk
+                 * signatures with.
+                 * @return the signature, or an empty Optional if request does not have one.
+                 */
+                static Optional<ByteCursor> GetRequestSignature(const Http::HttpRequest &request) noexcept;
+
+                /**
+                 * @return the signature of the last chunk framed so far, or the seed signature before the first.
+                 */
+                ByteCursor GetPreviousSignature() const noexcept;
+
+                /**
+                 * Returns the value of the last aws error encountered by operations on this instance.
+                 */
+                int LastError() const noexcept { return m_lastError; }
+
+              protected:
+                bool ReadImpl(ByteBuf &buffer) noexcept override;
+                Io::StreamStatus GetStatusImpl() const noexcept override;
+                int64_t GetLengthImpl() const noexcept override;
+                bool SeekImpl(Io::OffsetType offset, Io::StreamSeekBasis seekBasis) noexcept override;
+
+              private:
+                bool FrameNextChunk() noexcept;
+                void Restart() noexcept;
+                bool Fail(int errorCode) noexcept;
+
+                std::shared_ptr<Io::InputStream> m_source;
+                size_t m_chunkSize;
+                Crypto::SHA256HMACDigest m_signingKey;
+                /* "AWS4-HMAC-SHA256-PAYLOAD\n<date>\n<scope>\n", then the parts of the chunk being signed */
+                ByteBuf m_stringToSign;
+                size_t m_stringToSignPrefixLength;
+                uint8_t m_seedSignature[2 * Crypto::SHA256_HMAC_DIGEST_SIZE];
+                uint8_t m_previousSignature[2 * Crypto::SHA256_HMAC_DIGEST_SIZE];
+                /* the framed chunk: room for the longest chunk header, the data, and its "\r\n" */
+                ByteBuf m_frame;
+                size_t m_frameOffset;
+                bool m_sourceEnded;
+                bool m_finished;
+                int m_lastError;
+            };
+        } // namespace Auth
+    }     // namespace Crt
+} // namespace Aws
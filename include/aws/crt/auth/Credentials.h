@@ -11,6 +11,7 @@
 
 #include <chrono>
 #include <functional>
+#include <mutex>
 
 struct aws_credentials;
 struct aws_credentials_provider;
@@ -90,12 +91,12 @@ namespace Aws
              * Callback invoked by credentials providers when resolution succeeds (credentials will be non-null)
              * or fails (credentials will be null)
              */
-            using OnCredentialsResolved = std::function<void(std::shared_ptr<Credentials>, int errorCode)>;
+            using OnCredentialsResolved = Function<void(std::shared_ptr<Credentials>, int errorCode)>;
 
             /**
              * Invoked when the native delegate credentials provider needs to fetch a credential.
              */
-            using GetCredentialsHandler = std::function<std::shared_ptr<Credentials>()>;
+            using GetCredentialsHandler = Function<std::shared_ptr<Credentials>()>;
 
             /**
              * Base interface for all credentials providers.  Credentials providers are objects that
@@ -246,6 +247,35 @@ namespace Aws
                 std::chrono::milliseconds CachedCredentialTTL;
             };
 
+            /**
+             * Configuration options for a provider that renews the credentials of another provider before they
+             * expire
+             */
+            struct AWS_CRT_CPP_API CredentialsProviderRefreshAheadConfig
+            {
+                CredentialsProviderRefreshAheadConfig()
+                    : Provider(), RefreshFraction(0.75), RetryInterval(std::chrono::seconds(10))
+                {
+                }
+
+                /**
+                 * The provider to source credentials from
+                 */
+                std::shared_ptr<ICredentialsProvider> Provider;
+
+                /**
+                 * How far into the lifetime of a credential set, between 0 and 1, its replacement is fetched.
+                 * Credentials without an expiration are never refreshed.
+                 */
+                double RefreshFraction;
+
+                /**
+                 * How long to wait before trying again after a refresh failed, while the current credentials are
+                 * still good
+                 */
+                std::chrono::milliseconds RetryInterval;
+            };
+
             /**
              * Configuration options for a provider that implements a cached provider chain
              * based on the AWS SDK defaults:
@@ -339,6 +369,9 @@ namespace Aws
 
                 /**
                  * Asynchronous method to query for AWS credentials based on the internal provider implementation.
+                 * Queries made while another one is still in flight do not start a fetch of their own: they are
+                 * all resolved with the result of the one in flight, so a crowd of threads asking a cold provider
+                 * at once costs a single round trip to IMDS, STS, or whatever the provider sources from.
                  */
                 virtual bool GetCredentials(const OnCredentialsResolved &onCredentialsResolved) const override;
 
@@ -401,6 +434,16 @@ namespace Aws
                     const CredentialsProviderCachedConfig &config,
                     Allocator *allocator = g_allocator);
 
+                /**
+                 * Creates a provider that keeps the credentials of its subordinate provider and renews them in the
+                 * background, once RefreshFraction of their lifetime has passed, while handing out the current ones.
+                 * Unlike the cached provider, a query only waits on the subordinate provider when there are no
+                 * unexpired credentials at all, as for the first one: the first fetch starts right away.
+                 */
+                static std::shared_ptr<ICredentialsProvider> CreateCredentialsProviderRefreshAhead(
+                    const CredentialsProviderRefreshAheadConfig &config,
+                    Allocator *allocator = g_allocator);
+
                 /**
                  * Creates the SDK-standard default credentials provider which is a cache-fronted chain of:
                  *
@@ -430,8 +473,15 @@ namespace Aws
               private:
                 static void s_onCredentialsResolved(aws_credentials *credentials, int error_code, void *user_data);
 
+                void CompletePendingQueries(aws_credentials *credentials, int errorCode) const noexcept;
+
                 Allocator *m_allocator;
                 aws_credentials_provider *m_provider;
+
+                /* the queries waiting on the fetch in flight, if any */
+                mutable std::mutex m_pendingLock;
+                mutable Vector<OnCredentialsResolved> m_pendingQueries;
+                mutable bool m_fetchInFlight;
             };
         } // namespace Auth
     }     // namespace Crt
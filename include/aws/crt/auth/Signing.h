@@ -32,7 +32,7 @@ namespace Aws
              * iff the error code is AWS_ERROR_SUCCESS.
              */
             using OnHttpRequestSigningComplete =
-                std::function<void(const std::shared_ptr<Aws::Crt::Http::HttpRequest> &, int)>;
+                Function<void(const std::shared_ptr<Aws::Crt::Http::HttpRequest> &, int)>;
 
             /**
              * Base class for all different signing configurations.  Type functions as a
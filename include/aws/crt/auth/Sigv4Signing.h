@@ -180,6 +180,24 @@ namespace Aws
                  */
                 void SetShouldSignHeaderCallback(ShouldSignHeaderCb shouldSignHeaderCb) noexcept;
 
+                /**
+                 * Filters the headers to sign down to those named in headerNames, ignoring case: typically the
+                 * static headers of an HttpRequestTemplate and the few that vary per request. This is only a
+                 * should-sign-header filter, not a precomputed canonical header set: the signer still lowercases,
+                 * sorts and formats the request's headers on every signing, and asks the filter about each one.
+                 * What is saved is the cost of that question, a binary search over names lowercased and sorted once
+                 * here instead of a user callback. A named header missing from the request is simply not signed.
+                 *
+                 * This takes the place of any callback set with SetShouldSignHeaderCallback(), and an empty list
+                 * goes back to signing all headers.
+                 */
+                void SetSignedHeaderNames(const Vector<Crt::String> &headerNames) noexcept;
+
+                /**
+                 * @return the names set with SetSignedHeaderNames(), lowercased and sorted.
+                 */
+                const Vector<Crt::String> &GetSignedHeaderNames() const noexcept { return m_signedHeaderNames; }
+
                 /**
                  * Gets the string used as the canonical request's body value.
                  * If string is empty, a value is be calculated from the payload during signing.
@@ -251,6 +269,7 @@ namespace Aws
                 Crt::String m_signingRegion;
                 Crt::String m_serviceName;
                 Crt::String m_signedBodyValue;
+                Vector<Crt::String> m_signedHeaderNames;
             };
 
             /**
@@ -271,6 +290,32 @@ namespace Aws
                     const ISigningConfig &config,
                     const OnHttpRequestSigningComplete &completionCallback) override;
 
+                /**
+                 * Signs an http request with AWS-auth sigv4 before returning, for configs that carry their
+                 * credentials (AwsSigningConfig::SetCredentials()): with nothing to wait for, the request is signed
+                 * without a completion callback. Configs that only have a credentials provider fail with
+                 * AWS_ERROR_INVALID_ARGUMENT, and have to be signed with SignRequest(). Should the signer still not
+                 * complete before returning, the request is left unsigned and this fails with
+                 * AWS_ERROR_INVALID_STATE.
+                 * Returns true on success. If this function fails, Aws::Crt::LastError() will contain the error
+                 * that occurred.
+                 */
+                bool SignRequestNow(Aws::Crt::Http::HttpRequest &request, const ISigningConfig &config) noexcept;
+
+                /**
+                 * Signs every one of requests with config, such as a batch of presigned urls, across threadCount
+                 * threads including the calling one (zero picks the number of cores). Credentials are resolved once
+                 * for the whole batch, blocking the calling thread if they come from a provider, so this must not
+                 * be called from an event loop thread. The first failure stops the signing of requests not started
+                 * yet, which are left unsigned. An empty batch succeeds without resolving any credentials.
+                 * Returns true once every request was signed. If this function fails, Aws::Crt::LastError() will
+                 * contain the error that occurred.
+                 */
+                bool SignRequests(
+                    const Vector<std::shared_ptr<Aws::Crt::Http::HttpRequest>> &requests,
+                    const ISigningConfig &config,
+                    size_t threadCount = 0) noexcept;
+
               private:
                 Allocator *m_allocator;
             };
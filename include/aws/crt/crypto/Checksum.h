@@ -0,0 +1,98 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/Exports.h>
+#include <aws/crt/Types.h>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Crypto
+        {
+            static const size_t CRC32_DIGEST_SIZE = 4;
+
+            /**
+             * Computes the CRC32 (the one in zlib and gzip) of input, continuing from previousCrc, which is the CRC
+             * of the data before input, or 0 to start. Uses the hardware CRC instructions where the CPU has them.
+             */
+            uint32_t AWS_CRT_CPP_API ComputeCRC32(const ByteCursor &input, uint32_t previousCrc = 0) noexcept;
+
+            /**
+             * Computes the CRC32C (the Castagnoli polynomial, as used by S3 and iSCSI) of input, continuing from
+             * previousCrc, which is the CRC of the data before input, or 0 to start. Uses the hardware CRC
+             * instructions where the CPU has them.
+             */
+            uint32_t AWS_CRT_CPP_API ComputeCRC32C(const ByteCursor &input, uint32_t previousCrc = 0) noexcept;
+
+            enum class ChecksumAlgorithm
+            {
+                Crc32,
+                Crc32c,
+            };
+
+            /**
+             * Streaming CRC object, the counterpart of Hash for checksums that are much cheaper to compute than a
+             * digest. Call Update() for each chunk of the data, and Digest() or GetValue() once it has all been seen.
+             * Unlike a Hash, a Checksum stays usable after Digest(): more data can follow, and the checksum can be
+             * read again.
+             */
+            class AWS_CRT_CPP_API Checksum final
+            {
+              public:
+                Checksum(const Checksum &) = default;
+                Checksum &operator=(const Checksum &) = default;
+
+                /**
+                 * Always true: a checksum needs no resources, so it cannot fail to be created.
+                 */
+                inline operator bool() const noexcept { return true; }
+
+                /**
+                 * Returns the value of the last aws error encountered by operations on this instance.
+                 */
+                inline int LastError() const noexcept { return m_lastError; }
+
+                /**
+                 * Creates an instance of a Streaming CRC32 checksum.
+                 */
+                static Checksum CreateCRC32() noexcept;
+
+                /**
+                 * Creates an instance of a Streaming CRC32C checksum.
+                 */
+                static Checksum CreateCRC32C() noexcept;
+
+                ChecksumAlgorithm GetAlgorithm() const noexcept { return m_algorithm; }
+
+                /**
+                 * Updates the running checksum with the data in toChecksum. Always returns true; it returns a bool
+                 * to match Hash::Update().
+                 */
+                bool Update(const ByteCursor &toChecksum) noexcept;
+
+                /**
+                 * Writes the checksum of the data so far into output, big endian as it is transmitted, e.g. in the
+                 * x-amz-checksum-crc32 header once base64 encoded. The available capacity of output must be at least
+                 * CRC32_DIGEST_SIZE. Returns true on success. Call LastError() for the reason this call failed.
+                 */
+                bool Digest(ByteBuf &output) noexcept;
+
+                /**
+                 * Returns the checksum of the data so far.
+                 */
+                inline uint32_t GetValue() const noexcept { return m_crc; }
+
+              private:
+                explicit Checksum(ChecksumAlgorithm algorithm) noexcept;
+                Checksum() = delete;
+
+                ChecksumAlgorithm m_algorithm;
+                uint32_t m_crc;
+                int m_lastError;
+            };
+        } // namespace Crypto
+    }     // namespace Crt
+} // namespace Aws
@@ -7,6 +7,8 @@
 #include <aws/crt/Exports.h>
 #include <aws/crt/Types.h>
 
+#include <array>
+
 struct aws_hmac;
 namespace Aws
 {
@@ -16,6 +18,11 @@ namespace Aws
         {
             static const size_t SHA256_HMAC_DIGEST_SIZE = 32;
 
+            /**
+             * A fixed-size SHA256 HMAC digest, for keeping it on the stack without a ByteBuf around it.
+             */
+            using SHA256HMACDigest = std::array<uint8_t, SHA256_HMAC_DIGEST_SIZE>;
+
             /**
              * Computes a SHA256 HMAC with secret over input, and writes the digest to output. If truncateTo is
              * non-zero, the digest will be truncated to the value of truncateTo. Returns true on success. If this
@@ -40,10 +47,31 @@ namespace Aws
                 const ByteCursor &input,
                 ByteBuf &output,
                 size_t truncateTo = 0) noexcept;
+
+            /**
+             * Computes a SHA256 HMAC with secret over input, and writes the digest to output, which always has room
+             * for it. Returns true on success. If this function fails, Aws::Crt::LastError() will contain the error
+             * that occurred.
+             */
+            bool AWS_CRT_CPP_API ComputeSHA256HMAC(
+                Allocator *allocator,
+                const ByteCursor &secret,
+                const ByteCursor &input,
+                SHA256HMACDigest &output) noexcept;
+
+            /**
+             * Computes a SHA256 HMAC using the default allocator with secret over input, and writes the digest to
+             * output, which always has room for it. Returns true on success. If this function fails,
+             * Aws::Crt::LastError() will contain the error that occurred.
+             */
+            bool AWS_CRT_CPP_API
+                ComputeSHA256HMAC(const ByteCursor &secret, const ByteCursor &input, SHA256HMACDigest &output) noexcept;
+
             /**
              * Streaming HMAC object. The typical use case is for computing the HMAC of an object that is too large to
              * load into memory. You can call Update() multiple times as you load chunks of data into memory. When
-             * you're finished simply call Digest(). After Digest() is called, this object is no longer usable.
+             * you're finished simply call Digest(). After Digest() is called, this object is no longer usable until
+             * Reset() is called.
              */
             class AWS_CRT_CPP_API HMAC final
             {
@@ -88,11 +116,28 @@ namespace Aws
                  */
                 bool Digest(ByteBuf &output, size_t truncateTo = 0) noexcept;
 
+                /**
+                 * Finishes the running HMAC operation and writes the digest into output, which always has room for
+                 * it. Returns true on success. Call LastError() for the reason this call failed.
+                 */
+                bool Digest(SHA256HMACDigest &output) noexcept;
+
+                /**
+                 * Starts the HMAC over with secret, whether or not Digest() has been called, so that one instance
+                 * (e.g. a thread_local one) can authenticate any number of messages. Pass the secret the HMAC was
+                 * created with to keep the key, or another one to re-key; the instance itself never keeps a copy of
+                 * it. The underlying HMAC is created again from the same allocator, which a PoolAllocator makes
+                 * cheap. Returns true on success. Call LastError() for the reason this call failed.
+                 */
+                bool Reset(const ByteCursor &secret) noexcept;
+
               private:
-                HMAC(aws_hmac *hmac) noexcept;
+                HMAC(aws_hmac *hmac, aws_hmac_new_fn *create, Allocator *allocator) noexcept;
                 HMAC() = delete;
 
                 aws_hmac *m_hmac;
+                aws_hmac_new_fn *m_create;
+                Allocator *m_allocator;
                 bool m_good;
                 int m_lastError;
             };
@@ -8,6 +8,8 @@
 
 #include <aws/cal/hash.h>
 
+#include <array>
+
 struct aws_hash;
 namespace Aws
 {
@@ -18,6 +20,12 @@ namespace Aws
             static const size_t SHA256_DIGEST_SIZE = 32;
             static const size_t MD5_DIGEST_SIZE = 16;
 
+            /**
+             * Fixed-size digests, for keeping them on the stack without a ByteBuf around them.
+             */
+            using SHA256Digest = std::array<uint8_t, SHA256_DIGEST_SIZE>;
+            using MD5Digest = std::array<uint8_t, MD5_DIGEST_SIZE>;
+
             /**
              * Computes a SHA256 Hash over input, and writes the digest to output. If truncateTo is non-zero, the digest
              * will be truncated to the value of truncateTo. Returns true on success. If this function fails,
@@ -39,6 +47,46 @@ namespace Aws
             bool AWS_CRT_CPP_API
                 ComputeSHA256(const ByteCursor &input, ByteBuf &output, size_t truncateTo = 0) noexcept;
 
+            /**
+             * Computes a SHA256 Hash over input, and writes the digest to output, which always has room for it.
+             * Returns true on success. If this function fails, Aws::Crt::LastError() will contain the error that
+             * occurred.
+             */
+            bool AWS_CRT_CPP_API
+                ComputeSHA256(Allocator *allocator, const ByteCursor &input, SHA256Digest &output) noexcept;
+
+            /**
+             * Computes a SHA256 Hash using the default allocator over input, and writes the digest to output, which
+             * always has room for it. Returns true on success. If this function fails, Aws::Crt::LastError() will
+             * contain the error that occurred.
+             */
+            bool AWS_CRT_CPP_API ComputeSHA256(const ByteCursor &input, SHA256Digest &output) noexcept;
+
+            /**
+             * Computes the SHA256 Hash of each of count inputs, and writes their digests to the matching outputs, as
+             * ComputeSHA256() would one at a time. Each input still gets a hash of its own, since the underlying
+             * implementation can not restart a finished one. If truncateTo is non-zero, the digests will be truncated
+             * to the value of truncateTo. Returns true on success. If this function fails, Aws::Crt::LastError() will
+             * contain the error that occurred; the outputs before the failing one have been written by then. Unless
+             * you're using 'truncateTo', each output should have a minimum capacity of SHA256_DIGEST_SIZE.
+             */
+            bool AWS_CRT_CPP_API ComputeSHA256Batch(
+                Allocator *allocator,
+                const ByteCursor *inputs,
+                ByteBuf *outputs,
+                size_t count,
+                size_t truncateTo = 0) noexcept;
+
+            /**
+             * Computes the SHA256 Hash of each of count inputs using the default allocator, and writes their digests
+             * to the matching outputs. See the other overload.
+             */
+            bool AWS_CRT_CPP_API ComputeSHA256Batch(
+                const ByteCursor *inputs,
+                ByteBuf *outputs,
+                size_t count,
+                size_t truncateTo = 0) noexcept;
+
             /**
              * Computes a MD5 Hash over input, and writes the digest to output. If truncateTo is non-zero, the digest
              * will be truncated to the value of truncateTo. Returns true on success. If this function fails,
@@ -59,10 +107,24 @@ namespace Aws
              */
             bool AWS_CRT_CPP_API ComputeMD5(const ByteCursor &input, ByteBuf &output, size_t truncateTo = 0) noexcept;
 
+            /**
+             * Computes a MD5 Hash over input, and writes the digest to output, which always has room for it. Returns
+             * true on success. If this function fails, Aws::Crt::LastError() will contain the error that occurred.
+             */
+            bool AWS_CRT_CPP_API ComputeMD5(Allocator *allocator, const ByteCursor &input, MD5Digest &output) noexcept;
+
+            /**
+             * Computes a MD5 Hash using the default allocator over input, and writes the digest to output, which always
+             * has room for it. Returns true on success. If this function fails, Aws::Crt::LastError() will contain the
+             * error that occurred.
+             */
+            bool AWS_CRT_CPP_API ComputeMD5(const ByteCursor &input, MD5Digest &output) noexcept;
+
             /**
              * Streaming Hash object. The typical use case is for computing the hash of an object that is too large to
              * load into memory. You can call Update() multiple times as you load chunks of data into memory. When
-             * you're finished simply call Digest(). After Digest() is called, this object is no longer usable.
+             * you're finished simply call Digest(). After Digest() is called, this object is no longer usable until
+             * Reset() is called.
              */
             class AWS_CRT_CPP_API Hash final
             {
@@ -107,11 +169,36 @@ namespace Aws
                  */
                 bool Digest(ByteBuf &output, size_t truncateTo = 0) noexcept;
 
+                /**
+                 * Finishes the running hash operation of a SHA256 Hash and writes the digest into output. Fails
+                 * with AWS_ERROR_INVALID_ARGUMENT, leaving the hash running, if this is not a SHA256 Hash. Returns
+                 * true on success. Call LastError() for the reason this call failed.
+                 */
+                bool Digest(SHA256Digest &output) noexcept;
+
+                /**
+                 * Finishes the running hash operation of a MD5 Hash and writes the digest into output. Fails with
+                 * AWS_ERROR_INVALID_ARGUMENT, leaving the hash running, if this is not a MD5 Hash. Returns true on
+                 * success. Call LastError() for the reason this call failed.
+                 */
+                bool Digest(MD5Digest &output) noexcept;
+
+                /**
+                 * Starts the hash over, whether or not Digest() has been called, so that one instance (e.g. a
+                 * thread_local one) can hash any number of messages. The underlying hash is created again from the
+                 * same allocator, which a PoolAllocator makes cheap. Returns true on success. Call LastError() for the
+                 * reason this call failed.
+                 */
+                bool Reset() noexcept;
+
               private:
-                Hash(aws_hash *hash) noexcept;
+                Hash(aws_hash *hash, aws_hash_new_fn *create, Allocator *allocator) noexcept;
+                bool DigestInto(uint8_t *output, size_t size) noexcept;
                 Hash() = delete;
 
                 aws_hash *m_hash;
+                aws_hash_new_fn *m_create;
+                Allocator *m_allocator;
                 bool m_good;
                 int m_lastError;
             };
@@ -0,0 +1,116 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/crypto/Hash.h>
+#include <aws/crt/io/Stream.h>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Crypto
+        {
+            enum class HashAlgorithm
+            {
+                Sha256,
+                Md5,
+            };
+
+            struct AWS_CRT_CPP_API PartDigestOptions
+            {
+                HashAlgorithm Algorithm = HashAlgorithm::Sha256;
+                /**
+                 * Size of each part. Only the last part may be shorter.
+                 */
+                size_t PartSize = 8 * 1024 * 1024;
+                /**
+                 * Number of threads hashing parts, including the calling thread. Zero picks the number of cores.
+                 */
+                size_t ThreadCount = 0;
+            };
+
+            /**
+             * The digests of the fixed-size parts of some data, as multipart uploads checksum it, computed across
+             * threads. A single Hash is serial, but the parts are independent, so hashing them scales with cores;
+             * the composite and tree digests then combine the part digests into one for the whole of the data.
+             *
+             * Data without a byte still has one, empty, part.
+             */
+            class AWS_CRT_CPP_API PartDigests final
+            {
+              public:
+                explicit PartDigests(Allocator *allocator = g_allocator) noexcept;
+
+                /**
+                 * Hashes the parts of data, which must stay unchanged until the call returns. The threads hash
+                 * their parts straight from data, so this is the fastest way in for data that is in memory or
+                 * mapped from a file.
+                 * Returns true on success. Call LastError() for the reason this call failed.
+                 */
+                bool Compute(const ByteCursor &data, const PartDigestOptions &options = PartDigestOptions()) noexcept;
+
+                /**
+                 * Hashes the parts of everything left in input. The calling thread reads the parts in order while
+                 * the other threads hash them, with at most two parts per thread in memory.
+                 * Returns true on success. Call LastError() for the reason this call failed.
+                 */
+                bool Compute(Io::InputStream &input, const PartDigestOptions &options = PartDigestOptions()) noexcept;
+
+                /**
+                 * Returns the value of the last aws error encountered by operations on this instance.
+                 */
+                inline int LastError() const noexcept { return m_lastError; }
+
+                HashAlgorithm GetAlgorithm() const noexcept { return m_algorithm; }
+
+                /**
+                 * @return SHA256_DIGEST_SIZE or MD5_DIGEST_SIZE.
+                 */
+                size_t GetDigestSize() const noexcept { return m_digestSize; }
+
+                size_t GetPartCount() const noexcept { return m_digestSize ? m_digests.size() / m_digestSize : 0; }
+
+                /**
+                 * @return how many bytes of data were hashed.
+                 */
+                uint64_t GetTotalLength() const noexcept { return m_totalLength; }
+
+                /**
+                 * @return the digest of part index, valid until the next Compute().
+                 */
+                ByteCursor GetPartDigest(size_t index) const noexcept;
+
+                /**
+                 * Writes the digest of the part digests, one after the other, into output: the checksum of a
+                 * multipart object that S3 reports with a "-<part count>" suffix. The available capacity of output
+                 * must be at least GetDigestSize().
+                 * Returns true on success. Call LastError() for the reason this call failed.
+                 */
+                bool ComputeCompositeDigest(ByteBuf &output) noexcept;
+
+                /**
+                 * Writes the root of the binary tree over the part digests into output: each level hashes adjacent
+                 * pairs of digests together, and the odd digest out moves up as is. With 1 MiB parts and SHA256 this
+                 * is the Glacier tree hash. The available capacity of output must be at least GetDigestSize().
+                 * Returns true on success. Call LastError() for the reason this call failed.
+                 */
+                bool ComputeTreeDigest(ByteBuf &output) noexcept;
+
+              private:
+                bool Start(const PartDigestOptions &options, size_t &threadCount) noexcept;
+                bool WriteDigest(const uint8_t *digest, ByteBuf &output) noexcept;
+                bool Fail(int errorCode) noexcept;
+
+                Allocator *m_allocator;
+                HashAlgorithm m_algorithm;
+                size_t m_digestSize;
+                /* the part digests, one after the other */
+                Vector<uint8_t> m_digests;
+                uint64_t m_totalLength;
+                int m_lastError;
+            };
+        } // namespace Crypto
+    }     // namespace Crt
+} // namespace Aws
@@ -0,0 +1,216 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/DateTime.h>
+#include <aws/crt/Types.h>
+
+#include <aws/event-stream/event_stream.h>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Eventstream
+        {
+            enum class EventStreamHeaderValueType
+            {
+                BoolTrue = AWS_EVENT_STREAM_HEADER_BOOL_TRUE,
+                BoolFalse = AWS_EVENT_STREAM_HEADER_BOOL_FALSE,
+                Byte = AWS_EVENT_STREAM_HEADER_BYTE,
+                Int16 = AWS_EVENT_STREAM_HEADER_INT16,
+                Int32 = AWS_EVENT_STREAM_HEADER_INT32,
+                Int64 = AWS_EVENT_STREAM_HEADER_INT64,
+                ByteBuf = AWS_EVENT_STREAM_HEADER_BYTE_BUF,
+                String = AWS_EVENT_STREAM_HEADER_STRING,
+                Timestamp = AWS_EVENT_STREAM_HEADER_TIMESTAMP,
+                Uuid = AWS_EVENT_STREAM_HEADER_UUID,
+            };
+
+            /**
+             * A view of one header of an event-stream message. The name and value point into the memory the
+             * header was read from, so the view must not outlive it.
+             *
+             * Each GetValueAs* accessor is only meaningful for the matching type, and returns a zero or empty
+             * value for any other.
+             */
+            class AWS_CRT_CPP_API EventStreamHeaderView final
+            {
+              public:
+                EventStreamHeaderView() noexcept;
+
+                /**
+                 * @param value the value in its wire encoding: big-endian for the integer and timestamp types,
+                 * the raw bytes for the others.
+                 */
+                EventStreamHeaderView(StringView name, EventStreamHeaderValueType type, ByteCursor value) noexcept;
+
+                /**
+                 * Views a header from aws-c-event-stream, such as those handed to RPC callbacks.
+                 */
+                explicit EventStreamHeaderView(const aws_event_stream_header_value_pair &header) noexcept;
+
+                StringView GetName() const noexcept { return m_name; }
+                EventStreamHeaderValueType GetType() const noexcept { return m_type; }
+
+                bool GetValueAsBool() const noexcept;
+                int8_t GetValueAsByte() const noexcept;
+                int16_t GetValueAsInt16() const noexcept;
+                int32_t GetValueAsInt32() const noexcept;
+                int64_t GetValueAsInt64() const noexcept;
+                DateTime GetValueAsTimestamp() const noexcept;
+                StringView GetValueAsString() const noexcept;
+                ByteCursor GetValueAsBytes() const noexcept;
+
+                /**
+                 * @return the 16 bytes of a Uuid header.
+                 */
+                ByteCursor GetValueAsUuid() const noexcept;
+
+              private:
+                bool IsType(EventStreamHeaderValueType type, size_t length) const noexcept;
+
+                StringView m_name;
+                EventStreamHeaderValueType m_type;
+                ByteCursor m_value;
+            };
+
+            /**
+             * Headers for an event-stream message about to be encoded or sent. Names are copied into the list,
+             * string and byte values are only referenced, so they must stay available until the message has been
+             * encoded or the send call has returned.
+             */
+            class AWS_CRT_CPP_API EventStreamHeaders final
+            {
+              public:
+                EventStreamHeaders(Allocator *allocator = g_allocator) noexcept;
+                ~EventStreamHeaders();
+                EventStreamHeaders(const EventStreamHeaders &) = delete;
+                EventStreamHeaders(EventStreamHeaders &&) noexcept;
+                EventStreamHeaders &operator=(const EventStreamHeaders &) = delete;
+                EventStreamHeaders &operator=(EventStreamHeaders &&) noexcept;
+
+                /**
+                 * @return true if the list is usable.
+                 */
+                explicit operator bool() const noexcept { return m_lastError == AWS_ERROR_SUCCESS; }
+
+                /**
+                 * @return the error that kept the list from being set up.
+                 */
+                int LastError() const noexcept { return m_lastError; }
+
+                /**
+                 * Each Add* appends one header.
+                 * @return false, with the error raised, if the name or value does not fit the encoding.
+                 */
+                bool AddBool(StringView name, bool value) noexcept;
+                bool AddByte(StringView name, int8_t value) noexcept;
+                bool AddInt16(StringView name, int16_t value) noexcept;
+                bool AddInt32(StringView name, int32_t value) noexcept;
+                bool AddInt64(StringView name, int64_t value) noexcept;
+                bool AddTimestamp(StringView name, const DateTime &value) noexcept;
+                bool AddString(StringView name, StringView value) noexcept;
+                bool AddBytes(StringView name, ByteCursor value) noexcept;
+
+                /**
+                 * @param value exactly 16 bytes.
+                 */
+                bool AddUuid(StringView name, ByteCursor value) noexcept;
+
+                size_t GetCount() const noexcept;
+                EventStreamHeaderView GetHeader(size_t index) const noexcept;
+
+                /**
+                 * @return the underlying list of aws_event_stream_header_value_pair.
+                 */
+                aws_array_list *GetUnderlyingHandle() noexcept { return &m_headers; }
+                const aws_array_list *GetUnderlyingHandle() const noexcept { return &m_headers; }
+
+              private:
+                bool CheckName(StringView name) const noexcept;
+
+                Allocator *m_allocator;
+                aws_array_list m_headers;
+                int m_lastError;
+            };
+
+            /**
+             * Invoked for each header of a message, in order. Return false to stop early.
+             */
+            using OnEventStreamHeader = Function<bool(const EventStreamHeaderView &header)>;
+
+            /**
+             * One event-stream message, that is a prelude, headers, a payload and the CRC32 checksums of the
+             * prelude and of the whole message, all in one contiguous buffer.
+             *
+             * A decoded message is a view over the buffer it was decoded from, nothing is copied, and header views
+             * and the payload cursor point straight into it.
+             */
+            class AWS_CRT_CPP_API EventStreamMessage final
+            {
+              public:
+                EventStreamMessage(Allocator *allocator = g_allocator) noexcept;
+                ~EventStreamMessage();
+                EventStreamMessage(const EventStreamMessage &) = delete;
+                EventStreamMessage(EventStreamMessage &&) noexcept;
+                EventStreamMessage &operator=(const EventStreamMessage &) = delete;
+                EventStreamMessage &operator=(EventStreamMessage &&) noexcept;
+
+                /**
+                 * Encodes headers and payload into a newly allocated buffer owned by the message.
+                 */
+                bool Encode(const EventStreamHeaders &headers, const ByteCursor &payload) noexcept;
+
+                /**
+                 * Decodes the single complete message in buffer, checking both CRCs. The message points into
+                 * buffer, which must outlive it unless copy is set, in which case the message owns a copy.
+                 */
+                bool Decode(const ByteCursor &buffer, bool copy = false) noexcept;
+
+                /**
+                 * @return true once the message has been encoded or decoded.
+                 */
+                explicit operator bool() const noexcept { return m_hasMessage; }
+                int LastError() const noexcept { return m_lastError; }
+
+                /**
+                 * @return the whole message in its wire encoding.
+                 */
+                ByteCursor GetEncoded() const noexcept;
+                ByteCursor GetPayload() const noexcept;
+                uint32_t GetPreludeCrc() const noexcept;
+                uint32_t GetMessageCrc() const noexcept;
+
+                /**
+                 * Walks the headers without copying any of them.
+                 * @return false if the headers are malformed.
+                 */
+                bool ForEachHeader(const OnEventStreamHeader &onHeader) const noexcept;
+
+                /**
+                 * Looks for the first header called name.
+                 * @return false if there was none, or the headers are malformed.
+                 */
+                bool FindHeader(StringView name, EventStreamHeaderView &header) const noexcept;
+
+                /**
+                 * Walks the encoded headers block of a message, without copying any of them.
+                 * @return false if the headers are malformed.
+                 */
+                static bool ForEachHeader(ByteCursor headers, const OnEventStreamHeader &onHeader) noexcept;
+
+                aws_event_stream_message *GetUnderlyingHandle() noexcept { return &m_message; }
+
+              private:
+                void CleanUp() noexcept;
+
+                Allocator *m_allocator;
+                aws_event_stream_message m_message;
+                bool m_hasMessage;
+                int m_lastError;
+            };
+        } // namespace Eventstream
+    }     // namespace Crt
+} // namespace Aws
@@ -0,0 +1,130 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/eventstream/EventStream.h>
+#include <aws/crt/http/HttpBodySink.h>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Eventstream
+        {
+            /**
+             * Invoked for each complete message. The message, and any views taken from it, are only valid for the
+             * duration of the call.
+             */
+            using OnEventStreamMessage = Function<void(const EventStreamMessage &message)>;
+
+            /**
+             * Splits a stream of bytes arriving in arbitrary chunks, such as an application/vnd.amazon.eventstream
+             * response body, into event-stream messages.
+             *
+             * Messages that arrive whole within a chunk are decoded straight from it. Only a message split across
+             * chunks is gathered in a buffer of the decoder's, which is reused from one message to the next, so
+             * memory is bounded by the largest message seen. The prelude CRC is checked as soon as a prelude is
+             * in, before anything is buffered for its message, and the message CRC once the message is complete.
+             *
+             * The first malformed message breaks the stream: Decode() fails from then on.
+             */
+            class AWS_CRT_CPP_API EventStreamDecoder final
+            {
+              public:
+                /**
+                 * The largest message the event-stream format allows.
+                 */
+                static const size_t DefaultMaxMessageLength = 16 * 1024 * 1024;
+
+                /**
+                 * @param maxMessageLength messages announcing a larger total length are rejected before anything is
+                 * buffered for them.
+                 */
+                EventStreamDecoder(
+                    OnEventStreamMessage &&onMessage,
+                    size_t maxMessageLength = DefaultMaxMessageLength,
+                    Allocator *allocator = g_allocator) noexcept;
+                ~EventStreamDecoder();
+                EventStreamDecoder(const EventStreamDecoder &) = delete;
+                EventStreamDecoder(EventStreamDecoder &&) = delete;
+                EventStreamDecoder &operator=(const EventStreamDecoder &) = delete;
+                EventStreamDecoder &operator=(EventStreamDecoder &&) = delete;
+
+                /**
+                 * Decodes the next chunk of the stream, invoking the message callback for each message it
+                 * completes.
+                 * @return false, with the error raised, once a message has turned out to be malformed.
+                 */
+                bool Decode(const ByteCursor &data) noexcept;
+
+                /**
+                 * @return false once the stream is broken.
+                 */
+                explicit operator bool() const noexcept { return m_lastError == AWS_ERROR_SUCCESS; }
+
+                /**
+                 * @return the error that broke the stream.
+                 */
+                int LastError() const noexcept { return m_lastError; }
+
+                /**
+                 * @return true if part of a message has been received but not the rest, which once the stream has
+                 * ended means it was cut short.
+                 */
+                bool HasPartialMessage() const noexcept { return m_buffer.len > 0; }
+
+                /**
+                 * @return the size of the buffer used for messages split across chunks.
+                 */
+                size_t GetBufferCapacity() const noexcept { return m_buffer.capacity; }
+
+                uint64_t GetMessageCount() const noexcept { return m_messageCount; }
+
+              private:
+                bool ReadPrelude(const uint8_t *prelude, uint32_t &messageLength) noexcept;
+                bool Emit(const ByteCursor &encoded) noexcept;
+                bool Fail() noexcept;
+
+                Allocator *m_allocator;
+                OnEventStreamMessage m_onMessage;
+                size_t m_maxMessageLength;
+                ByteBuf m_buffer;
+                /* total length of the message being buffered, 0 until its prelude is in */
+                uint32_t m_messageLength;
+                EventStreamMessage m_message;
+                uint64_t m_messageCount;
+                int m_lastError;
+            };
+
+            /**
+             * HttpBodySink that decodes an event-stream response body as it arrives. Install it by assigning
+             * GetOnIncomingBody() to HttpRequestOptions::onIncomingBody.
+             *
+             * Messages are handed to the callback on the connection's event-loop thread, and each chunk is consumed
+             * as soon as it has been decoded.
+             */
+            class AWS_CRT_CPP_API EventStreamBodySink final : public Http::HttpBodySink
+            {
+              public:
+                explicit EventStreamBodySink(
+                    OnEventStreamMessage &&onMessage,
+                    size_t maxMessageLength = EventStreamDecoder::DefaultMaxMessageLength,
+                    Allocator *allocator = g_allocator) noexcept;
+
+                const EventStreamDecoder &GetDecoder() const noexcept { return m_decoder; }
+
+                /**
+                 * Invoked once if the body turns out to be malformed. The rest of the body is ignored.
+                 */
+                Function<void(int errorCode)> OnDecodeError;
+
+              protected:
+                size_t OnBodyData(const ByteCursor &data) noexcept override;
+
+              private:
+                EventStreamDecoder m_decoder;
+            };
+        } // namespace Eventstream
+    }     // namespace Crt
+} // namespace Aws
@@ -0,0 +1,258 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/eventstream/EventStream.h>
+#include <aws/crt/io/Bootstrap.h>
+#include <aws/crt/io/SocketOptions.h>
+#include <aws/crt/io/TlsOptions.h>
+
+#include <aws/event-stream/event_stream_rpc_client.h>
+
+#include <atomic>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Eventstream
+        {
+            enum class EventStreamRpcMessageType
+            {
+                ApplicationMessage = AWS_EVENT_STREAM_RPC_MESSAGE_TYPE_APPLICATION_MESSAGE,
+                ApplicationError = AWS_EVENT_STREAM_RPC_MESSAGE_TYPE_APPLICATION_ERROR,
+                Ping = AWS_EVENT_STREAM_RPC_MESSAGE_TYPE_PING,
+                PingResponse = AWS_EVENT_STREAM_RPC_MESSAGE_TYPE_PING_RESPONSE,
+                Connect = AWS_EVENT_STREAM_RPC_MESSAGE_TYPE_CONNECT,
+                ConnectAck = AWS_EVENT_STREAM_RPC_MESSAGE_TYPE_CONNECT_ACK,
+                ProtocolError = AWS_EVENT_STREAM_RPC_MESSAGE_TYPE_PROTOCOL_ERROR,
+                InternalError = AWS_EVENT_STREAM_RPC_MESSAGE_TYPE_INTERNAL_ERROR,
+            };
+
+            /**
+             * A message received over an RPC connection. Its headers and payload belong to the connection and are
+             * only valid for the duration of the callback it was handed to.
+             */
+            class AWS_CRT_CPP_API EventStreamRpcMessageView final
+            {
+              public:
+                explicit EventStreamRpcMessageView(const aws_event_stream_rpc_message_args &message) noexcept;
+
+                EventStreamRpcMessageType GetType() const noexcept;
+
+                /**
+                 * @return the AWS_EVENT_STREAM_RPC_MESSAGE_FLAG_* bits of the message.
+                 */
+                uint32_t GetFlags() const noexcept { return m_message->message_flags; }
+
+                size_t GetHeaderCount() const noexcept { return m_message->headers_count; }
+                EventStreamHeaderView GetHeader(size_t index) const noexcept;
+
+                /**
+                 * Looks for the first header called name.
+                 * @return false if there was none.
+                 */
+                bool FindHeader(StringView name, EventStreamHeaderView &header) const noexcept;
+
+                ByteCursor GetPayload() const noexcept;
+
+              private:
+                const aws_event_stream_rpc_message_args *m_message;
+            };
+
+            /**
+             * Content of a message to send over an RPC connection. Headers and payload are encoded before the send
+             * call returns, so they only need to outlive the call.
+             */
+            struct AWS_CRT_CPP_API EventStreamRpcMessage
+            {
+                const EventStreamHeaders *Headers = nullptr;
+                ByteCursor Payload = {0, nullptr};
+                EventStreamRpcMessageType Type = EventStreamRpcMessageType::ApplicationMessage;
+                uint32_t Flags = 0;
+            };
+
+            class EventStreamRpcClientConnection;
+            class EventStreamRpcClientContinuation;
+
+            /**
+             * Invoked once the connection has been established, or has failed to be. On failure connection is
+             * null.
+             */
+            using OnEventStreamRpcConnectionSetup =
+                Function<void(const std::shared_ptr<EventStreamRpcClientConnection> &connection, int errorCode)>;
+
+            /**
+             * Invoked once a connection that was set up has shut down.
+             */
+            using OnEventStreamRpcConnectionShutdown =
+                Function<void(EventStreamRpcClientConnection &connection, int errorCode)>;
+
+            /**
+             * Invoked for each message received outside of any stream, such as a ConnectAck or a PingResponse.
+             */
+            using OnEventStreamRpcProtocolMessage = Function<
+                void(EventStreamRpcClientConnection &connection, const EventStreamRpcMessageView &message)>;
+
+            /**
+             * Invoked for each message received on a stream.
+             */
+            using OnEventStreamRpcContinuationMessage = Function<
+                void(EventStreamRpcClientContinuation &continuation, const EventStreamRpcMessageView &message)>;
+
+            /**
+             * Invoked once a stream has been closed, by either side or by the connection shutting down.
+             */
+            using OnEventStreamRpcContinuationClosed = Function<void(EventStreamRpcClientContinuation &continuation)>;
+
+            /**
+             * Invoked once a message has been written to the socket, or has failed to be.
+             */
+            using OnEventStreamRpcMessageFlushed = Function<void(int errorCode)>;
+
+            struct AWS_CRT_CPP_API EventStreamRpcClientConnectionOptions
+            {
+                String HostName;
+                uint16_t Port = 0;
+                Io::SocketOptions SocketOptions;
+                /**
+                 * Unset connects over plain text.
+                 */
+                Optional<Io::TlsConnectionOptions> TlsOptions;
+                Io::ClientBootstrap *Bootstrap = nullptr;
+
+                OnEventStreamRpcConnectionSetup OnConnectionSetup;
+                OnEventStreamRpcProtocolMessage OnProtocolMessage;
+                OnEventStreamRpcConnectionShutdown OnConnectionShutdown;
+            };
+
+            struct EventStreamRpcConnectionCallbackData;
+            struct EventStreamRpcContinuationCallbackData;
+
+            /**
+             * A client connection speaking the event-stream RPC protocol: framed event-stream messages over a
+             * socket, with any number of streams (continuations) multiplexed on it.
+             *
+             * A connection is handed out through OnConnectionSetup. Dropping the last reference closes it, and
+             * callbacks stop being invoked on it once it is gone.
+             */
+            class AWS_CRT_CPP_API EventStreamRpcClientConnection final
+                : public std::enable_shared_from_this<EventStreamRpcClientConnection>
+            {
+              public:
+                ~EventStreamRpcClientConnection();
+                EventStreamRpcClientConnection(const EventStreamRpcClientConnection &) = delete;
+                EventStreamRpcClientConnection(EventStreamRpcClientConnection &&) = delete;
+                EventStreamRpcClientConnection &operator=(const EventStreamRpcClientConnection &) = delete;
+                EventStreamRpcClientConnection &operator=(EventStreamRpcClientConnection &&) = delete;
+
+                /**
+                 * Starts connecting to options.HostName. options.OnConnectionSetup is invoked with the result,
+                 * unless this returns false.
+                 */
+                static bool CreateConnection(
+                    const EventStreamRpcClientConnectionOptions &options,
+                    Allocator *allocator = g_allocator) noexcept;
+
+                bool IsOpen() const noexcept;
+
+                /**
+                 * Closes the connection. OnConnectionShutdown is invoked with errorCode once it is done.
+                 */
+                void Close(int errorCode = AWS_ERROR_SUCCESS) noexcept;
+
+                /**
+                 * Sends a message outside of any stream, such as the Connect message that has to go out first.
+                 */
+                bool SendProtocolMessage(
+                    const EventStreamRpcMessage &message,
+                    OnEventStreamRpcMessageFlushed &&onFlushed = nullptr) noexcept;
+
+                /**
+                 * Creates a stream on the connection. Nothing is sent until the stream is activated.
+                 * @return the stream, or null on failure.
+                 */
+                std::shared_ptr<EventStreamRpcClientContinuation> NewStream(
+                    OnEventStreamRpcContinuationMessage &&onMessage,
+                    OnEventStreamRpcContinuationClosed &&onClosed = nullptr) noexcept;
+
+                aws_event_stream_rpc_client_connection *GetUnderlyingHandle() const noexcept { return m_connection; }
+
+              private:
+                EventStreamRpcClientConnection(
+                    aws_event_stream_rpc_client_connection *connection,
+                    Allocator *allocator) noexcept;
+
+                static void s_onConnectionSetup(
+                    aws_event_stream_rpc_client_connection *connection,
+                    int errorCode,
+                    void *userData);
+                static void s_onProtocolMessage(
+                    aws_event_stream_rpc_client_connection *connection,
+                    const aws_event_stream_rpc_message_args *message,
+                    void *userData);
+                static void s_onConnectionShutdown(
+                    aws_event_stream_rpc_client_connection *connection,
+                    int errorCode,
+                    void *userData);
+
+                Allocator *m_allocator;
+                aws_event_stream_rpc_client_connection *m_connection;
+            };
+
+            /**
+             * One stream on an EventStreamRpcClientConnection, started by Activate() with the operation it
+             * carries. The stream keeps its connection alive.
+             */
+            class AWS_CRT_CPP_API EventStreamRpcClientContinuation final
+            {
+              public:
+                ~EventStreamRpcClientContinuation();
+                EventStreamRpcClientContinuation(const EventStreamRpcClientContinuation &) = delete;
+                EventStreamRpcClientContinuation(EventStreamRpcClientContinuation &&) = delete;
+                EventStreamRpcClientContinuation &operator=(const EventStreamRpcClientContinuation &) = delete;
+                EventStreamRpcClientContinuation &operator=(EventStreamRpcClientContinuation &&) = delete;
+
+                /**
+                 * Starts the stream for operationName, sending message as its first message.
+                 */
+                bool Activate(
+                    StringView operationName,
+                    const EventStreamRpcMessage &message,
+                    OnEventStreamRpcMessageFlushed &&onFlushed = nullptr) noexcept;
+
+                /**
+                 * Sends a further message on an activated stream. Setting
+                 * AWS_EVENT_STREAM_RPC_MESSAGE_FLAG_TERMINATE_STREAM in its flags closes the stream.
+                 */
+                bool SendMessage(
+                    const EventStreamRpcMessage &message,
+                    OnEventStreamRpcMessageFlushed &&onFlushed = nullptr) noexcept;
+
+                bool IsClosed() const noexcept;
+
+                EventStreamRpcClientConnection &GetConnection() const noexcept { return *m_connection; }
+
+              private:
+                friend class EventStreamRpcClientConnection;
+
+                EventStreamRpcClientContinuation(
+                    const std::shared_ptr<EventStreamRpcClientConnection> &connection,
+                    EventStreamRpcContinuationCallbackData *callbackData,
+                    Allocator *allocator) noexcept;
+
+                static void s_onMessage(
+                    aws_event_stream_rpc_client_continuation_token *token,
+                    const aws_event_stream_rpc_message_args *message,
+                    void *userData);
+                static void s_onClosed(aws_event_stream_rpc_client_continuation_token *token, void *userData);
+
+                Allocator *m_allocator;
+                std::shared_ptr<EventStreamRpcClientConnection> m_connection;
+                EventStreamRpcContinuationCallbackData *m_callbackData;
+                aws_event_stream_rpc_client_continuation_token *m_token;
+            };
+        } // namespace Eventstream
+    }     // namespace Crt
+} // namespace Aws
@@ -0,0 +1,85 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/Exports.h>
+#include <aws/crt/Types.h>
+
+#include <memory>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Http
+        {
+            /**
+             * Content codings a response body can be decoded from.
+             */
+            enum class HttpContentEncoding
+            {
+                Identity,
+                Gzip,
+                Deflate,
+            };
+
+            /**
+             * Invoked with each piece of decoded output. data is only valid for the duration of the call. Return
+             * false to abort decoding.
+             */
+            using OnDecodedBody = Function<bool(const ByteCursor &data)>;
+
+            /**
+             * Incremental decoder for a content-coded body. Input can be fed in arbitrarily sized pieces as it
+             * arrives from the wire; output is produced through a fixed-size internal buffer, so memory use does not
+             * depend on the size of the body.
+             *
+             * gzip and deflate are backed by zlib and are only available if the library was built with USE_ZLIB.
+             * Use IsSupported() to decide whether to advertise them in Accept-Encoding.
+             */
+            class AWS_CRT_CPP_API HttpBodyDecoder
+            {
+              public:
+                virtual ~HttpBodyDecoder() = default;
+                HttpBodyDecoder(const HttpBodyDecoder &) = delete;
+                HttpBodyDecoder(HttpBodyDecoder &&) = delete;
+                HttpBodyDecoder &operator=(const HttpBodyDecoder &) = delete;
+                HttpBodyDecoder &operator=(HttpBodyDecoder &&) = delete;
+
+                /**
+                 * Decodes input, invoking onDecoded as output becomes available. Returns false and raises an error
+                 * if the input is malformed or onDecoded returned false.
+                 */
+                virtual bool Decode(const ByteCursor &input, const OnDecodedBody &onDecoded) noexcept = 0;
+
+                /**
+                 * @return true once the end of the coded stream has been seen, i.e. the body was not truncated.
+                 */
+                virtual bool IsComplete() const noexcept = 0;
+
+                /**
+                 * Maps a Content-Encoding header value to an encoding. Returns false for codings this library does
+                 * not know about.
+                 */
+                static bool ParseContentEncoding(const ByteCursor &value, HttpContentEncoding &outEncoding) noexcept;
+
+                /**
+                 * @return true if NewDecoder() can create a decoder for encoding in this build.
+                 */
+                static bool IsSupported(HttpContentEncoding encoding) noexcept;
+
+                /**
+                 * Creates a decoder for encoding. Returns nullptr, raising AWS_ERROR_UNSUPPORTED_OPERATION, if the
+                 * encoding is not supported in this build.
+                 */
+                static std::shared_ptr<HttpBodyDecoder> NewDecoder(
+                    HttpContentEncoding encoding,
+                    Allocator *allocator = g_allocator) noexcept;
+
+              protected:
+                HttpBodyDecoder() = default;
+            };
+        } // namespace Http
+    }     // namespace Crt
+} // namespace Aws
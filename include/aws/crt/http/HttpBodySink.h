@@ -0,0 +1,160 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/http/HttpConnection.h>
+#include <aws/crt/io/ChannelHandler.h>
+#include <aws/crt/io/ThrottledInputStream.h>
+
+#include <chrono>
+#include <mutex>
+#include <ostream>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Http
+        {
+            /**
+             * Destination for a response body that takes part in read-window flow control. Bytes handed to the sink
+             * count against the stream's read window until the sink reports them drained, at which point the window
+             * is reopened for them. With HttpClientConnectionOptions::ManualWindowManagement enabled, memory held by
+             * a slow consumer is therefore bounded by the connection's InitialWindowSize.
+             *
+             * Without ManualWindowManagement, a sink on a connection with AdaptiveReadWindow takes reopening the
+             * window of its stream over from the connection, so each byte is handed back once, when it is drained.
+             * On any other connection the window is reopened as bodies arrive and the sink leaves it alone.
+             *
+             * Subclasses implement OnBodyData(). Sinks that consume synchronously simply return the length they were
+             * given; sinks that queue data for another thread return what they could not hang on to and call
+             * Drained() as the consumer catches up.
+             *
+             * Install a sink by assigning GetOnIncomingBody() to HttpRequestOptions::onIncomingBody.
+             */
+            class AWS_CRT_CPP_API HttpBodySink : public std::enable_shared_from_this<HttpBodySink>
+            {
+              public:
+                virtual ~HttpBodySink() = default;
+                HttpBodySink(const HttpBodySink &) = delete;
+                HttpBodySink(HttpBodySink &&) = delete;
+                HttpBodySink &operator=(const HttpBodySink &) = delete;
+                HttpBodySink &operator=(HttpBodySink &&) = delete;
+
+                /**
+                 * @return a body callback that feeds this sink. The callback holds a reference to the sink.
+                 */
+                OnIncomingBody GetOnIncomingBody() noexcept;
+
+                /**
+                 * Reports that size bytes the sink held on to have been consumed, and reopens the stream's read window
+                 * accordingly. Safe to call from any thread, including after the stream has completed.
+                 */
+                void Drained(size_t size) noexcept;
+
+                /**
+                 * @return bytes accepted from the stream that have not been drained yet.
+                 */
+                size_t GetBufferedBytes() const noexcept;
+
+                /**
+                 * @return total body bytes delivered to the sink.
+                 */
+                uint64_t GetTotalBytes() const noexcept;
+
+              protected:
+                /**
+                 * windowUpdateThreshold batches window updates so that a consumer draining a few bytes at a time
+                 * does not produce a WINDOW_UPDATE per call. Pending updates are always flushed once nothing is left
+                 * buffered, so the threshold can never stall the stream.
+                 */
+                explicit HttpBodySink(size_t windowUpdateThreshold = 0) noexcept;
+
+                /**
+                 * Called on the connection's event-loop thread for each chunk of the body. data is only valid for the
+                 * duration of the call. Returns how many bytes were consumed outright; the remainder is considered
+                 * held by the sink until passed to Drained().
+                 */
+                virtual size_t OnBodyData(const ByteCursor &data) noexcept = 0;
+
+                /**
+                 * Schedules task on the event loop of the connection the body arrives on, runIn from now. The task
+                 * runs with the 'Canceled' status if the connection shuts down first. Returns false if no body has
+                 * arrived yet, or its stream is gone.
+                 */
+                bool ScheduleTask(std::function<void(Io::TaskStatus)> &&task, std::chrono::nanoseconds runIn) noexcept;
+
+              private:
+                void OnIncomingData(HttpStream &stream, const ByteCursor &data) noexcept;
+                void ReleaseWindow(size_t size) noexcept;
+
+                mutable std::mutex m_lock;
+                std::weak_ptr<HttpStream> m_stream;
+                /* whether this sink, rather than the connection, reopens the window of m_stream */
+                bool m_ownsWindow;
+                size_t m_windowUpdateThreshold;
+                size_t m_pendingWindowUpdate;
+                size_t m_bufferedBytes;
+                uint64_t m_totalBytes;
+            };
+
+            /**
+             * HttpBodySink that writes the body to a std::ostream as it arrives, e.g. a std::ofstream for downloads
+             * to disk. The window is reopened as soon as each write returns.
+             */
+            class AWS_CRT_CPP_API HttpOStreamBodySink final : public HttpBodySink
+            {
+              public:
+                explicit HttpOStreamBodySink(std::ostream &output) noexcept;
+
+                /**
+                 * @return false if a write to the output stream has failed.
+                 */
+                bool IsGood() const noexcept { return m_good; }
+
+              protected:
+                size_t OnBodyData(const ByteCursor &data) noexcept override;
+
+              private:
+                std::ostream &m_output;
+                bool m_good;
+            };
+
+            /**
+             * HttpBodySink that paces a download to the rate of an Io::TokenBucket, which may be shared with other
+             * downloads. Each chunk is handed to onData as it arrives, but the read window is only reopened for it
+             * as tokens become available, by timer tasks on the connection's event loop; the server is throttled by
+             * flow control and no thread ever waits.
+             *
+             * This needs HttpClientConnectionOptions::ManualWindowManagement or AdaptiveReadWindow. Without either the
+             * connection reopens the window by itself, and nothing is throttled.
+             */
+            class AWS_CRT_CPP_API HttpThrottledBodySink final : public HttpBodySink
+            {
+              public:
+                HttpThrottledBodySink(
+                    const std::shared_ptr<Io::TokenBucket> &bucket,
+                    std::function<void(const ByteCursor &)> &&onData) noexcept;
+
+                /**
+                 * @return bytes received whose window is being held back until the bucket allows it.
+                 */
+                size_t GetThrottledBytes() const noexcept;
+
+              protected:
+                size_t OnBodyData(const ByteCursor &data) noexcept override;
+
+              private:
+                void ScheduleRelease() noexcept;
+                void OnReleaseTask(Io::TaskStatus status) noexcept;
+
+                std::shared_ptr<Io::TokenBucket> m_bucket;
+                std::function<void(const ByteCursor &)> m_onData;
+                mutable std::mutex m_throttleLock;
+                size_t m_throttledBytes;
+                bool m_releaseScheduled;
+            };
+        } // namespace Http
+    }     // namespace Crt
+} // namespace Aws
@@ -0,0 +1,152 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/http/HttpConnectionManager.h>
+
+#include <future>
+#include <mutex>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Http
+        {
+            /**
+             * Configuration for an HttpClientConnectionPool.
+             */
+            class AWS_CRT_CPP_API HttpClientConnectionPoolOptions
+            {
+              public:
+                HttpClientConnectionPoolOptions() noexcept;
+                HttpClientConnectionPoolOptions(const HttpClientConnectionPoolOptions &rhs) = default;
+                HttpClientConnectionPoolOptions(HttpClientConnectionPoolOptions &&rhs) = default;
+
+                HttpClientConnectionPoolOptions &operator=(const HttpClientConnectionPoolOptions &rhs) = default;
+                HttpClientConnectionPoolOptions &operator=(HttpClientConnectionPoolOptions &&rhs) = default;
+
+                /**
+                 * Options every connection is made with. HostName, Port and TlsOptions are ignored and taken from
+                 * each AcquireConnection() call instead.
+                 */
+                HttpClientConnectionOptions ConnectionOptions;
+
+                /**
+                 * Total number of connections, across every endpoint, that may be leased or being acquired at once.
+                 * Acquisitions beyond this are queued in order until a connection is released.
+                 */
+                size_t MaxConnections;
+
+                /**
+                 * Maximum number of connections to any single endpoint.
+                 */
+                size_t MaxConnectionsPerHost;
+
+                /**
+                 * See HttpClientConnectionManagerOptions::MaxConnectionIdleInMilliseconds.
+                 */
+                uint64_t MaxConnectionIdleInMilliseconds;
+
+                /**
+                 * See HttpClientConnectionManagerOptions::EnableBlockingShutdown. If set, InitiateShutdown() must be
+                 * called before the last reference to the pool is released.
+                 */
+                bool EnableBlockingShutdown;
+            };
+
+            /**
+             * Connection pool spanning many endpoints. Each distinct (host, port, TLS options) gets its own
+             * HttpClientConnectionManager, created on first use and capped at MaxConnectionsPerHost, while the pool
+             * enforces MaxConnections across all of them so fan-out workloads cannot over-subscribe sockets.
+             */
+            class AWS_CRT_CPP_API HttpClientConnectionPool final
+                : public std::enable_shared_from_this<HttpClientConnectionPool>
+            {
+              public:
+                ~HttpClientConnectionPool() = default;
+                HttpClientConnectionPool(const HttpClientConnectionPool &) = delete;
+                HttpClientConnectionPool(HttpClientConnectionPool &&) = delete;
+                HttpClientConnectionPool &operator=(const HttpClientConnectionPool &) = delete;
+                HttpClientConnectionPool &operator=(HttpClientConnectionPool &&) = delete;
+
+                /**
+                 * Acquires a connection to hostName:port, using tlsOptions if set. Connections made with a different
+                 * TLS context, server name or ALPN list are pooled separately. onClientConnectionAvailable is invoked
+                 * once a connection is available or acquisition fails; the connection goes back to the pool when the
+                 * last reference to it, including those held by its streams, is released.
+                 *
+                 * Returns true if the request was queued. On failure, onClientConnectionAvailable will not be
+                 * invoked.
+                 */
+                bool AcquireConnection(
+                    const String &hostName,
+                    uint16_t port,
+                    const Optional<Io::TlsConnectionOptions> &tlsOptions,
+                    const OnClientConnectionAvailable &onClientConnectionAvailable) noexcept;
+
+                /**
+                 * @return the number of connections currently leased or being acquired, across every endpoint.
+                 */
+                size_t GetLeasedConnectionCount() const noexcept;
+
+                /**
+                 * @return the number of acquisitions waiting on the global MaxConnections budget.
+                 */
+                size_t GetQueuedAcquisitionCount() const noexcept;
+
+                /**
+                 * Starts shutdown of every endpoint's connection manager. If EnableBlockingShutdown was set, get() on
+                 * the returned future blocks until all of them have released their resources.
+                 */
+                std::future<void> InitiateShutdown() noexcept;
+
+                /**
+                 * Factory function for connection pools
+                 */
+                static std::shared_ptr<HttpClientConnectionPool> NewClientConnectionPool(
+                    const HttpClientConnectionPoolOptions &options,
+                    Allocator *allocator = g_allocator) noexcept;
+
+              private:
+                HttpClientConnectionPool(const HttpClientConnectionPoolOptions &options, Allocator *allocator) noexcept;
+
+                struct EndpointKey
+                {
+                    String hostName;
+                    uint16_t port;
+                    const void *tlsContext;
+                    String serverName;
+                    String alpnList;
+
+                    bool operator<(const EndpointKey &other) const noexcept;
+                };
+
+                struct QueuedAcquisition
+                {
+                    std::shared_ptr<HttpClientConnectionManager> manager;
+                    OnClientConnectionAvailable onClientConnectionAvailable;
+                };
+
+                std::shared_ptr<HttpClientConnectionManager> GetOrCreateManager(
+                    const String &hostName,
+                    uint16_t port,
+                    const Optional<Io::TlsConnectionOptions> &tlsOptions) noexcept;
+                bool Dispatch(
+                    const std::shared_ptr<HttpClientConnectionManager> &manager,
+                    const OnClientConnectionAvailable &onClientConnectionAvailable) noexcept;
+                void ReleaseSlot() noexcept;
+
+                Allocator *m_allocator;
+                HttpClientConnectionPoolOptions m_options;
+
+                mutable std::mutex m_lock;
+                Map<EndpointKey, std::shared_ptr<HttpClientConnectionManager>> m_managers;
+                List<QueuedAcquisition> m_queue;
+                size_t m_leasedConnections;
+                bool m_shutdown;
+            };
+        } // namespace Http
+    }     // namespace Crt
+} // namespace Aws
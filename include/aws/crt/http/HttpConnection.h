@@ -8,12 +8,18 @@
 #include <aws/http/request_response.h>
 
 #include <aws/crt/Types.h>
+#include <aws/crt/http/HttpBodyDecoder.h>
 #include <aws/crt/io/Bootstrap.h>
+#include <aws/crt/io/ChannelStatistics.h>
+#include <aws/crt/io/HostResolver.h>
+#include <aws/crt/io/ReadWindowTuner.h>
 #include <aws/crt/io/SocketOptions.h>
 #include <aws/crt/io/TlsOptions.h>
 
+#include <atomic>
 #include <functional>
 #include <memory>
+#include <mutex>
 
 namespace Aws
 {
@@ -22,15 +28,18 @@ namespace Aws
         namespace Io
         {
             class ClientBootstrap;
+            class HostAddressSelector;
         }
 
         namespace Http
         {
             class HttpClientConnection;
+            class Http2ClientConnection;
             class HttpStream;
             class HttpClientStream;
             class HttpRequest;
             class HttpProxyStrategy;
+            struct HttpStreamPool;
             using HttpHeader = aws_http_header;
 
             /**
@@ -40,7 +49,7 @@ namespace Aws
              * failure.
              */
             using OnConnectionSetup =
-                std::function<void(const std::shared_ptr<HttpClientConnection> &connection, int errorCode)>;
+                Function<void(const std::shared_ptr<HttpClientConnection> &connection, int errorCode)>;
 
             /**
              * Invoked upon connection shutdown. `connection` will always be a valid pointer. `errorCode` will specify
@@ -50,7 +59,7 @@ namespace Aws
              * memory is released. If you never took a reference to it, the resources for the connection will be
              * immediately released after completion of this callback.
              */
-            using OnConnectionShutdown = std::function<void(HttpClientConnection &connection, int errorCode)>;
+            using OnConnectionShutdown = Function<void(HttpClientConnection &connection, int errorCode)>;
 
             /**
              * Called as headers are received from the peer. `headersArray` will contain the header value
@@ -60,7 +69,7 @@ namespace Aws
              *
              * On HttpStream, this function must be set.
              */
-            using OnIncomingHeaders = std::function<void(
+            using OnIncomingHeaders = Function<void(
                 HttpStream &stream,
                 enum aws_http_header_block headerBlock,
                 const HttpHeader *headersArray,
@@ -73,7 +82,7 @@ namespace Aws
              * On HttpStream, this function can be empty.
              */
             using OnIncomingHeadersBlockDone =
-                std::function<void(HttpStream &stream, enum aws_http_header_block block)>;
+                Function<void(HttpStream &stream, enum aws_http_header_block block)>;
 
             /**
              * Invoked as chunks of the body are read. `data` contains the data read from the wire. If chunked encoding
@@ -81,7 +90,7 @@ namespace Aws
              *
              * On HttpStream, this function can be empty if you are not expecting a body (e.g. a HEAD request).
              */
-            using OnIncomingBody = std::function<void(HttpStream &stream, const ByteCursor &data)>;
+            using OnIncomingBody = Function<void(HttpStream &stream, const ByteCursor &data)>;
 
             /**
              * Invoked upon completion of the stream. This means the request has been sent and a completed response
@@ -91,7 +100,7 @@ namespace Aws
              *
              * On HttpStream, this function must be set.
              */
-            using OnStreamComplete = std::function<void(HttpStream &stream, int errorCode)>;
+            using OnStreamComplete = Function<void(HttpStream &stream, int errorCode)>;
 
             /**
              * POD structure used for setting up an Http Request
@@ -113,6 +122,101 @@ namespace Aws
                  * See `OnStreamComplete` for more info. This value can be empty.
                  */
                 OnStreamComplete onStreamComplete;
+                /**
+                 * If set, the response body is appended to this buffer as it arrives, before `onIncomingBody` (if any)
+                 * sees it. A buffer with an allocator grows as needed and is reserved up front from the response's
+                 * Content-Length, so the body is copied exactly once. A buffer without one must already have room for
+                 * the body, or the stream fails with AWS_ERROR_DEST_COPY_TOO_SMALL. The buffer must outlive the
+                 * stream.
+                 */
+                ByteBuf *responseBody = nullptr;
+                /**
+                 * Upper bound on how much of `responseBody` is reserved from Content-Length, so a bogus or hostile
+                 * length cannot force a huge allocation. Anything beyond it is still received, growing as it comes.
+                 */
+                size_t responseBodyPreallocationLimit = 64 * 1024 * 1024;
+                /**
+                 * If set, a response with a supported Content-Encoding (see HttpBodyDecoder::IsSupported()) is decoded
+                 * as it arrives, and `onIncomingBody` and `responseBody` see the decoded body. Nothing is added to
+                 * the request, so advertise the codings you want in an Accept-Encoding header yourself. Responses in
+                 * codings that cannot be decoded are delivered as received.
+                 *
+                 * With HttpClientConnectionOptions::ManualWindowManagement, pass `UpdateWindow()` the number of
+                 * decoded bytes consumed, and the window is reopened for the share of the coded body they were
+                 * decoded from. Without it the connection reopens the window itself, and `UpdateWindow()` does nothing
+                 * while a body is being decoded.
+                 */
+                bool decodeResponseBody = false;
+                /**
+                 * If set, the stream timestamps each phase of the exchange, see HttpStream::GetTimings(), and adds the
+                 * result to its connection's HttpClientConnectionStreamMetrics when it completes.
+                 */
+                bool recordTimings = false;
+            };
+
+            /**
+             * Where the time went in a single request/response exchange. Timestamps come from
+             * aws_high_res_clock_get_ticks() and are in nanoseconds; a phase the stream has not reached is zero.
+             */
+            struct AWS_CRT_CPP_API HttpStreamTimings
+            {
+                HttpStreamTimings() noexcept;
+
+                /**
+                 * When the stream was created by HttpClientConnection::NewClientStream().
+                 */
+                uint64_t CreatedTimestampNs;
+
+                /**
+                 * When HttpClientStream::Activate() was called.
+                 */
+                uint64_t ActivatedTimestampNs;
+
+                /**
+                 * When the first response header arrived, informational (1xx) responses included.
+                 */
+                uint64_t FirstHeaderTimestampNs;
+
+                /**
+                 * When the main header block was done.
+                 */
+                uint64_t HeadersDoneTimestampNs;
+
+                /**
+                 * When the first chunk of the body arrived, zero for a response without one.
+                 */
+                uint64_t FirstBodyTimestampNs;
+
+                /**
+                 * When the stream completed, successfully or not.
+                 */
+                uint64_t CompletedTimestampNs;
+
+                /**
+                 * Body bytes received, as they were on the wire.
+                 */
+                uint64_t BodyBytes;
+
+                /**
+                 * Activation to first response header. This covers sending the request, the server's think time and,
+                 * on HTTP/2, waiting behind other streams for a concurrency slot.
+                 */
+                uint64_t GetTimeToFirstByteNs() const noexcept;
+
+                /**
+                 * First response header to the end of the main header block.
+                 */
+                uint64_t GetHeaderDurationNs() const noexcept;
+
+                /**
+                 * End of the main header block to completion.
+                 */
+                uint64_t GetBodyDurationNs() const noexcept;
+
+                /**
+                 * Activation to completion.
+                 */
+                uint64_t GetTotalDurationNs() const noexcept;
             };
 
             /**
@@ -142,13 +246,25 @@ namespace Aws
                  * You do not need to call this unless you utilized the `outWindowUpdateSize` in `OnIncomingBody`.
                  * See `OnIncomingBody` for more information.
                  *
-                 * `incrementSize` is the amount to update the read window by.
+                 * `incrementSize` is the amount to update the read window by. On an HTTP/1.1 connection with
+                 * HttpClientConnectionOptions::AdaptiveReadWindow it is the amount consumed, and the window is updated
+                 * by what the connection's tuner makes of it. For a body decoded because of
+                 * HttpRequestOptions::decodeResponseBody, it counts decoded bytes.
                  */
                 void UpdateWindow(std::size_t incrementSize) noexcept;
 
+                /**
+                 * @return the timings recorded so far if the stream was created with
+                 * HttpRequestOptions::recordTimings, all zero otherwise. They are final by the time `OnStreamComplete`
+                 * is invoked. Only meaningful on the connection's event-loop thread until the stream has completed.
+                 */
+                const HttpStreamTimings &GetTimings() const noexcept { return m_timings; }
+
               protected:
                 aws_http_stream *m_stream;
                 std::shared_ptr<HttpClientConnection> m_connection;
+                bool m_recordTimings;
+                HttpStreamTimings m_timings;
                 HttpStream(const std::shared_ptr<HttpClientConnection> &connection) noexcept;
 
               private:
@@ -156,6 +272,33 @@ namespace Aws
                 OnIncomingHeadersBlockDone m_onIncomingHeadersBlockDone;
                 OnIncomingBody m_onIncomingBody;
                 OnStreamComplete m_onStreamComplete;
+                Allocator *m_allocator;
+                ByteBuf *m_responseBody;
+                size_t m_responseBodyPreallocationLimit;
+                bool m_decodeResponseBody;
+                uint64_t m_responseContentLength;
+                bool m_hasResponseContentLength;
+                HttpContentEncoding m_responseEncoding;
+                std::shared_ptr<HttpBodyDecoder> m_bodyDecoder;
+                /* m_bodyDecoder is only touched on the event loop, UpdateWindow() checks this instead */
+                std::atomic<bool> m_decodingBody;
+                /* while decoding with manual window management, coded bytes received and decoded bytes delivered that
+                 * the caller has not released yet, so UpdateWindow() can map one onto the other */
+                std::mutex m_windowLock;
+                size_t m_codedBytesHeld;
+                size_t m_decodedBytesHeld;
+                /* an HttpBodySink reopens the window instead of the stream, see TakeOverWindow() */
+                std::atomic<bool> m_windowTakenOver;
+
+                void RecordBodyHeaders(const HttpHeader *headerArray, size_t numHeaders) noexcept;
+                bool PrepareForBody() noexcept;
+                bool DeliverBody(const ByteCursor &data) noexcept;
+                bool DeliverDecodedBody(const ByteCursor &decoded) noexcept;
+                /* makes the caller the one to reopen the window for delivered bodies, returns false if neither the
+                 * caller nor the stream does so but aws-c-http itself */
+                bool TakeOverWindow() noexcept;
+                bool CallerReleasesWindow() const noexcept;
+                void ReleaseWindow(size_t bytesConsumed) noexcept;
 
                 static int s_onIncomingHeaders(
                     struct aws_http_stream *stream,
@@ -174,6 +317,7 @@ namespace Aws
                 static void s_onStreamComplete(struct aws_http_stream *stream, int errorCode, void *userData) noexcept;
 
                 friend class HttpClientConnection;
+                friend class HttpBodySink;
             };
 
             struct ClientStreamCallbackData
@@ -330,6 +474,33 @@ namespace Aws
                 String BasicAuthPassword;
             };
 
+            /**
+             * Mirror of aws_http2_settings_id: the parameters exchanged in HTTP/2 SETTINGS frames.
+             */
+            enum class Http2SettingId
+            {
+                HeaderTableSize = AWS_HTTP2_SETTINGS_HEADER_TABLE_SIZE,
+                EnablePush = AWS_HTTP2_SETTINGS_ENABLE_PUSH,
+                MaxConcurrentStreams = AWS_HTTP2_SETTINGS_MAX_CONCURRENT_STREAMS,
+                InitialWindowSize = AWS_HTTP2_SETTINGS_INITIAL_WINDOW_SIZE,
+                MaxFrameSize = AWS_HTTP2_SETTINGS_MAX_FRAME_SIZE,
+                MaxHeaderListSize = AWS_HTTP2_SETTINGS_MAX_HEADER_LIST_SIZE,
+            };
+
+            using Http2Setting = aws_http2_setting;
+
+            /**
+             * Invoked when the peer acknowledges a settings change made with Http2ClientConnection::ChangeSettings().
+             */
+            using OnHttp2SettingsChangeComplete = Function<void(Http2ClientConnection &connection, int errorCode)>;
+
+            /**
+             * Invoked when the peer answers a PING sent with Http2ClientConnection::Ping(). `roundTripTimeNs` is only
+             * valid if errorCode is AWS_ERROR_SUCCESS.
+             */
+            using OnHttp2PingComplete =
+                Function<void(Http2ClientConnection &connection, uint64_t roundTripTimeNs, int errorCode)>;
+
             /**
              * Configuration structure holding all options relating to http connection establishment
              */
@@ -405,9 +576,31 @@ namespace Aws
                  * only use this if you're allowing http response body data to escape the callbacks. E.g. you're
                  * putting the data into a queue for another thread to process and need to make sure the memory
                  * usage is bounded. If this is enabled, you must call HttpStream::UpdateWindow() for every
-                 * byte read from the OnIncomingBody callback.
+                 * byte read from the OnIncomingBody callback, or let an HttpBodySink do it for you.
                  */
                 bool ManualWindowManagement;
+
+                /**
+                 * If set, the connection's read window is sized from how fast response bodies are consumed, see
+                 * Io::ReadWindowTuner, within these bounds, and InitialWindowSize is ignored. It grows on links with a
+                 * high bandwidth-delay product and shrinks when bodies are consumed slowly, and MaxWindowSize caps
+                 * what the connection buffers.
+                 *
+                 * With ManualWindowManagement, what is passed to HttpStream::UpdateWindow() goes through the tuner;
+                 * without it, bodies count as consumed once `OnIncomingBody` returns, or, for a stream whose body goes
+                 * to an HttpBodySink, once the sink has drained them. Only HTTP/1.1 connections are
+                 * tuned: an HTTP/2 connection ignores this, and its streams' windows are managed as they would be
+                 * without it.
+                 * Optional.
+                 */
+                Optional<Io::ReadWindowTunerOptions> AdaptiveReadWindow;
+
+                /**
+                 * Settings sent in the initial SETTINGS frame if the connection negotiates HTTP/2, e.g.
+                 * MaxConcurrentStreams or InitialWindowSize. Ignored for HTTP/1.x connections.
+                 * Optional.
+                 */
+                Vector<Http2Setting> Http2InitialSettings;
             };
             enum class HttpVersion
             {
@@ -416,6 +609,59 @@ namespace Aws
                 Http1_1 = AWS_HTTP_VERSION_1_1,
                 Http2 = AWS_HTTP_VERSION_2,
             };
+
+            /**
+             * Latency of the streams completed on a connection, see HttpClientConnection::GetStreamMetrics(). Only
+             * streams created with HttpRequestOptions::recordTimings are counted.
+             */
+            struct AWS_CRT_CPP_API HttpClientConnectionStreamMetrics
+            {
+                HttpClientConnectionStreamMetrics() noexcept;
+
+                /**
+                 * Number of buckets in each histogram. Bucket i counts streams that took less than 2^i milliseconds
+                 * and at least the previous bucket's bound; the last bucket also counts everything slower.
+                 */
+                static const size_t LatencyBucketCount = 16;
+
+                /**
+                 * Time taken to set the connection up (DNS, TCP and TLS), zero if the connection did not come from
+                 * HttpClientConnection::CreateConnection().
+                 */
+                uint64_t ConnectionSetupDurationNs;
+
+                /**
+                 * Streams that completed successfully.
+                 */
+                uint64_t CompletedStreams;
+
+                /**
+                 * Streams that completed with an error.
+                 */
+                uint64_t FailedStreams;
+
+                /**
+                 * See HttpStreamTimings::GetTimeToFirstByteNs(). On HTTP/2, a time to first byte that grows while
+                 * body durations stay flat points at head-of-line blocking on the connection.
+                 */
+                uint64_t TimeToFirstByteHistogram[LatencyBucketCount];
+
+                /**
+                 * See HttpStreamTimings::GetHeaderDurationNs().
+                 */
+                uint64_t HeaderDurationHistogram[LatencyBucketCount];
+
+                /**
+                 * See HttpStreamTimings::GetBodyDurationNs().
+                 */
+                uint64_t BodyDurationHistogram[LatencyBucketCount];
+
+                /**
+                 * See HttpStreamTimings::GetTotalDurationNs().
+                 */
+                uint64_t TotalDurationHistogram[LatencyBucketCount];
+            };
+
             /**
              * Represents a connection from a Http Client to a Server.
              */
@@ -460,11 +706,45 @@ namespace Aws
                  * @return protocol version the connection used
                  */
                 HttpVersion GetVersion() noexcept;
+
+                /**
+                 * @return this connection as an Http2ClientConnection if it negotiated HTTP/2, nullptr otherwise.
+                 */
+                virtual Http2ClientConnection *AsHttp2() noexcept { return nullptr; }
+
                 /**
                  * @return the value of the last aws error encountered by operations on this instance.
                  */
                 int LastError() const noexcept { return m_lastError; }
 
+                /**
+                 * @return latency histograms for the streams completed on this connection so far. Safe to call from
+                 * any thread.
+                 */
+                HttpClientConnectionStreamMetrics GetStreamMetrics() const noexcept;
+
+                /**
+                 * Reports the statistics of the handlers of this connection's channel (socket bytes, TLS handshake
+                 * and any C++ handlers) to callback, on the connection's event-loop thread, every reportInterval.
+                 *
+                 * This replaces the channel's statistics handler, so connections from a connection manager that
+                 * monitors connection health lose that monitoring.
+                 *
+                 * @return true if the callback is being installed, false otherwise.
+                 */
+                bool SetStatisticsCallback(
+                    std::chrono::milliseconds reportInterval,
+                    Io::OnChannelStatistics &&callback) noexcept;
+
+                /**
+                 * @return the tuner sizing the read window if this is an HTTP/1.1 connection created with
+                 * HttpClientConnectionOptions::AdaptiveReadWindow, nullptr otherwise.
+                 */
+                const std::shared_ptr<Io::ReadWindowTuner> &GetReadWindowTuner() const noexcept
+                {
+                    return m_readWindowTuner;
+                }
+
                 /**
                  * Create a new Https Connection to hostName:port, using `socketOptions` for tcp options and
                  * `tlsConnOptions` for TLS/SSL options. If `tlsConnOptions` is null http (plain-text) will be used.
@@ -477,14 +757,53 @@ namespace Aws
                     const HttpClientConnectionOptions &connectionOptions,
                     Allocator *allocator) noexcept;
 
+                /**
+                 * Connects to connectionOptions.HostName through one of addresses, which it resolved to, racing the
+                 * best IPv6 and the best IPv4 address in the order selector ranks them, as Happy Eyeballs does. The
+                 * first attempt to connect wins and is handed to OnConnectionSetupCallback; the other is closed
+                 * without ever being seen. Only once every attempt has failed is the callback invoked with the error
+                 * of the last. Each attempt's outcome and latency are recorded in selector, so later connections
+                 * start with what proved fastest. The addresses raced are copied, so addresses only has to stay valid
+                 * for the call, as is the case for those handed to a resolve callback.
+                 *
+                 * HostName stays the TLS server name, and the Host header of requests is up to the caller as usual.
+                 * Proxy options are not supported, since the proxy does the resolving.
+                 *
+                 * returns true if at least one attempt was started. If false is returned, `onConnectionSetup` will not
+                 * be invoked.
+                 */
+                static bool CreateConnectionToAddresses(
+                    const HttpClientConnectionOptions &connectionOptions,
+                    const Vector<Io::HostAddress> &addresses,
+                    const std::shared_ptr<Io::HostAddressSelector> &selector,
+                    Allocator *allocator) noexcept;
+
               protected:
                 HttpClientConnection(aws_http_connection *m_connection, Allocator *allocator) noexcept;
                 aws_http_connection *m_connection;
-
-              private:
                 Allocator *m_allocator;
                 int m_lastError;
 
+              private:
+                /* recycles the memory behind completed streams, see NewClientStream() */
+                std::shared_ptr<HttpStreamPool> m_streamPool;
+
+                uint64_t m_setupDurationNs;
+                std::shared_ptr<Io::ReadWindowTuner> m_readWindowTuner;
+                bool m_manualWindowManagement;
+                /* window management was turned on for AdaptiveReadWindow, not by the user, so bodies are handed back
+                 * as they are delivered */
+                bool m_releasesWindow;
+                std::atomic<uint64_t> m_completedStreams;
+                std::atomic<uint64_t> m_failedStreams;
+                std::atomic<uint64_t>
+                    m_timeToFirstByteHistogram[HttpClientConnectionStreamMetrics::LatencyBucketCount];
+                std::atomic<uint64_t> m_headerDurationHistogram[HttpClientConnectionStreamMetrics::LatencyBucketCount];
+                std::atomic<uint64_t> m_bodyDurationHistogram[HttpClientConnectionStreamMetrics::LatencyBucketCount];
+                std::atomic<uint64_t> m_totalDurationHistogram[HttpClientConnectionStreamMetrics::LatencyBucketCount];
+
+                void RecordStreamTimings(const HttpStreamTimings &timings, int errorCode) noexcept;
+
                 static void s_onClientConnectionSetup(
                     struct aws_http_connection *connection,
                     int error_code,
@@ -493,6 +812,100 @@ namespace Aws
                     struct aws_http_connection *connection,
                     int error_code,
                     void *user_data) noexcept;
+
+                friend class HttpStream;
+            };
+
+            /**
+             * A client connection that negotiated HTTP/2. Many streams can be in flight on it at once, bounded by the
+             * peer's MaxConcurrentStreams setting; streams beyond that are queued by the connection until a slot
+             * frees up.
+             *
+             * Connections made with HttpClientConnection::CreateConnection() that negotiate HTTP/2 are always of this
+             * type; use FromConnection() or AsHttp2() to get at it.
+             */
+            class AWS_CRT_CPP_API Http2ClientConnection : public HttpClientConnection
+            {
+              public:
+                /**
+                 * @return connection as an Http2ClientConnection sharing its ownership, or nullptr if connection did
+                 * not negotiate HTTP/2.
+                 */
+                static std::shared_ptr<Http2ClientConnection> FromConnection(
+                    const std::shared_ptr<HttpClientConnection> &connection) noexcept;
+
+                Http2ClientConnection *AsHttp2() noexcept override { return this; }
+
+                /**
+                 * Creates and activates a stream for every entry in requestOptions, appending them to outStreams in
+                 * the same order.
+                 *
+                 * Every stream is created before any is activated, so if creation fails nothing is sent and
+                 * outStreams is left untouched. If activation fails part way through, the streams activated so far are
+                 * already in flight and remain in outStreams.
+                 *
+                 * Returns true if every stream was created and activated.
+                 */
+                bool NewClientStreams(
+                    const Vector<HttpRequestOptions> &requestOptions,
+                    Vector<std::shared_ptr<HttpClientStream>> &outStreams) noexcept;
+
+                /**
+                 * Sends a SETTINGS frame changing the given settings. onComplete is invoked once the peer acknowledges
+                 * it and can be empty.
+                 *
+                 * Returns true if the frame was queued.
+                 */
+                bool ChangeSettings(
+                    const Vector<Http2Setting> &settings,
+                    OnHttp2SettingsChangeComplete &&onComplete = OnHttp2SettingsChangeComplete()) noexcept;
+
+                /**
+                 * Sends a PING frame. onComplete receives the measured round trip time.
+                 *
+                 * Returns true if the frame was queued.
+                 */
+                bool Ping(OnHttp2PingComplete &&onComplete) noexcept;
+
+                /**
+                 * @return the value of a setting as currently applied by this side of the connection.
+                 */
+                uint32_t GetLocalSetting(Http2SettingId id) const noexcept;
+
+                /**
+                 * @return the value of a setting as last announced by the peer.
+                 */
+                uint32_t GetRemoteSetting(Http2SettingId id) const noexcept;
+
+                /**
+                 * @return the number of streams the peer allows to be open at once.
+                 */
+                uint32_t GetMaxConcurrentStreams() const noexcept
+                {
+                    return GetRemoteSetting(Http2SettingId::MaxConcurrentStreams);
+                }
+
+                /**
+                 * @return the peer's initial flow-control window for new streams.
+                 */
+                uint32_t GetInitialWindowSize() const noexcept
+                {
+                    return GetRemoteSetting(Http2SettingId::InitialWindowSize);
+                }
+
+              protected:
+                Http2ClientConnection(aws_http_connection *connection, Allocator *allocator) noexcept;
+
+              private:
+                static void s_onSettingsChangeComplete(
+                    struct aws_http_connection *connection,
+                    int errorCode,
+                    void *userData) noexcept;
+                static void s_onPingComplete(
+                    struct aws_http_connection *connection,
+                    uint64_t roundTripTimeNs,
+                    int errorCode,
+                    void *userData) noexcept;
             };
 
         } // namespace Http
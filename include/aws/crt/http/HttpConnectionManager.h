@@ -24,7 +24,53 @@ namespace Aws
              * will be non-zero.
              */
             using OnClientConnectionAvailable =
-                std::function<void(std::shared_ptr<HttpClientConnection>, int errorCode)>;
+                Function<void(std::shared_ptr<HttpClientConnection>, int errorCode)>;
+
+            /**
+             * Outcome of HttpClientConnectionManager::AcquireConnection() in its future-returning form.
+             */
+            struct AWS_CRT_CPP_API HttpClientConnectionAcquisition
+            {
+                HttpClientConnectionAcquisition() noexcept : Connection(), ErrorCode(AWS_ERROR_SUCCESS) {}
+
+                /**
+                 * The acquired connection, nullptr on failure.
+                 */
+                std::shared_ptr<HttpClientConnection> Connection;
+
+                /**
+                 * AWS_ERROR_SUCCESS, or the reason no connection could be acquired.
+                 */
+                int ErrorCode;
+            };
+
+            /**
+             * A response collected in full by HttpClientConnectionManager::MakeRequest().
+             */
+            struct AWS_CRT_CPP_API HttpCollectedResponse
+            {
+                HttpCollectedResponse() noexcept : ErrorCode(AWS_ERROR_SUCCESS), StatusCode(0) {}
+
+                /**
+                 * AWS_ERROR_SUCCESS if the exchange completed. A completed exchange may still carry an error status.
+                 */
+                int ErrorCode;
+
+                /**
+                 * The response status, 0 if the response headers never arrived.
+                 */
+                int StatusCode;
+
+                /**
+                 * Headers of the main header block, in the order received.
+                 */
+                Vector<std::pair<String, String>> Headers;
+
+                /**
+                 * The response body.
+                 */
+                Vector<uint8_t> Body;
+            };
 
             /**
              * Configuration struct containing all options related to connection manager behavior
@@ -57,6 +103,72 @@ namespace Aws
                  * reference to the connection manager.
                  */
                 bool EnableBlockingShutdown;
+
+                /**
+                 * Number of connections to open as soon as the manager is created, so the first requests after
+                 * startup do not pay for TCP and TLS handshakes. Clamped to MaxConnections. These connections are
+                 * subject to MaxConnectionIdleInMilliseconds like any other; call
+                 * HttpClientConnectionManager::Prewarm() to top the pool back up later.
+                 */
+                size_t MinIdleConnections;
+
+                /**
+                 * If non-zero, idle connections are closed once they have gone unused for this long.
+                 * 0 keeps idle connections open indefinitely.
+                 */
+                uint64_t MaxConnectionIdleInMilliseconds;
+            };
+
+            /**
+             * Point-in-time view of a connection manager's usage, see HttpClientConnectionManager::GetMetrics().
+             */
+            struct AWS_CRT_CPP_API HttpClientConnectionManagerMetrics
+            {
+                HttpClientConnectionManagerMetrics() noexcept;
+
+                /**
+                 * Number of buckets in AcquireLatencyHistogram.
+                 */
+                static const size_t AcquireLatencyBucketCount = 12;
+
+                /**
+                 * The configured connection limit.
+                 */
+                size_t MaxConnections;
+
+                /**
+                 * Connections currently held by callers.
+                 */
+                size_t LeasedConnections;
+
+                /**
+                 * Acquisitions queued and not yet completed. If this stays above zero while LeasedConnections sits at
+                 * MaxConnections, the pool is the bottleneck.
+                 */
+                size_t PendingAcquisitions;
+
+                /**
+                 * Acquisitions that produced a connection.
+                 */
+                uint64_t SuccessfulAcquisitions;
+
+                /**
+                 * Acquisitions that completed with an error.
+                 */
+                uint64_t FailedAcquisitions;
+
+                /**
+                 * Leased connections that had already been closed when they were released, forcing the pool to open
+                 * a replacement.
+                 */
+                uint64_t ConnectionsClosedWhileLeased;
+
+                /**
+                 * Time spent waiting for acquisitions to complete. Bucket i counts acquisitions that took less than
+                 * 2^i milliseconds and at least the previous bucket's bound; the last bucket also counts everything
+                 * slower.
+                 */
+                uint64_t AcquireLatencyHistogram[AcquireLatencyBucketCount];
             };
 
             /**
@@ -76,6 +188,35 @@ namespace Aws
                  */
                 bool AcquireConnection(const OnClientConnectionAvailable &onClientConnectionAvailable) noexcept;
 
+                /**
+                 * Acquires a connection from the pool, returning a future satisfied once one is available or the
+                 * acquisition fails. Failure to queue the request is reported through the future as well.
+                 *
+                 * Waiting on the future from an event-loop thread of this manager's bootstrap will deadlock.
+                 */
+                std::future<HttpClientConnectionAcquisition> AcquireConnection() noexcept;
+
+                /**
+                 * Acquires a connection, sends request on it, and collects the status, headers and body of the
+                 * response. The returned future is satisfied once the stream completes, and the connection is returned
+                 * to the pool at that point. request is kept alive until then.
+                 *
+                 * This needs no callbacks of its own, so many requests can be outstanding from a single thread with
+                 * nothing but their futures to keep track of. Waiting on the future from an event-loop thread of this
+                 * manager's bootstrap will deadlock.
+                 */
+                std::future<HttpCollectedResponse> MakeRequest(const std::shared_ptr<HttpRequest> &request) noexcept;
+
+                /**
+                 * Opens up to connectionCount connections ahead of demand and returns each of them to the pool as an
+                 * idle connection as soon as it is acquired. connectionCount is clamped to the connections not leased
+                 * at the time of the call, i.e. MaxConnections minus GetMetrics().LeasedConnections; connections that
+                 * are already idle count towards it.
+                 *
+                 * The returned future yields the number of connections that were successfully acquired.
+                 */
+                std::future<size_t> Prewarm(size_t connectionCount) noexcept;
+
                 /**
                  * Starts shutdown of the connection manager. Returns a future to the connection manager's shutdown
                  * process. If EnableBlockingDestruct was enabled on the connection manager options, calling get() on
@@ -84,6 +225,12 @@ namespace Aws
                  */
                 std::future<void> InitiateShutdown() noexcept;
 
+                /**
+                 * @return a snapshot of the manager's pool occupancy and acquisition statistics. Counters are read
+                 * individually without a lock, so they may be very slightly out of step with each other.
+                 */
+                HttpClientConnectionManagerMetrics GetMetrics() const noexcept;
+
                 /**
                  * Factory function for connection managers
                  */
@@ -96,6 +243,14 @@ namespace Aws
                     const HttpClientConnectionManagerOptions &options,
                     Allocator *allocator = g_allocator) noexcept;
 
+                /**
+                 * As AcquireConnection() above, with onConnectionReleased invoked once the connection handed out has
+                 * gone back to the underlying manager, which is only after the caller and every stream on it let go.
+                 */
+                bool AcquireConnection(
+                    const OnClientConnectionAvailable &onClientConnectionAvailable,
+                    const Function<void()> &onConnectionReleased) noexcept;
+
                 Allocator *m_allocator;
 
                 aws_http_connection_manager *m_connectionManager;
@@ -104,6 +259,23 @@ namespace Aws
                 std::promise<void> m_shutdownPromise;
                 std::atomic<bool> m_releaseInvoked;
 
+                std::atomic<size_t> m_leasedConnections;
+                std::atomic<size_t> m_pendingAcquisitions;
+                std::atomic<uint64_t> m_successfulAcquisitions;
+                std::atomic<uint64_t> m_failedAcquisitions;
+                std::atomic<uint64_t> m_connectionsClosedWhileLeased;
+                std::atomic<uint64_t>
+                    m_acquireLatencyHistogram[HttpClientConnectionManagerMetrics::AcquireLatencyBucketCount];
+
+                /* connections whose socket has had SocketOptions tuning applied, with their local port */
+                std::mutex m_tunedConnectionsLock;
+                Map<aws_http_connection *, uint32_t> m_tunedConnections;
+
+                void RecordAcquisition(uint64_t startTimestampNs, bool succeeded) noexcept;
+                /* returns true if connection has not been tuned yet, and records that it is about to be */
+                bool MarkTuned(aws_http_connection *connection) noexcept;
+                void ForgetTuned(aws_http_connection *connection) noexcept;
+
                 static void s_onConnectionSetup(
                     aws_http_connection *connection,
                     int errorCode,
@@ -112,6 +284,7 @@ namespace Aws
                 static void s_shutdownCompleted(void *userData) noexcept;
 
                 friend class ManagedConnection;
+                friend class HttpClientConnectionPool;
             };
         } // namespace Http
     }     // namespace Crt
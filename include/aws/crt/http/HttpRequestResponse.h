@@ -43,7 +43,9 @@ namespace Aws
                 std::shared_ptr<Aws::Crt::Io::InputStream> GetBody() const noexcept;
 
                 /**
-                 * Sets the input stream representing the message body
+                 * Sets the input stream representing the message body. The body is read on the connection's
+                 * event-loop thread; use an Io::AsyncInputStream for bodies whose data may not be ready
+                 * immediately, so the read does not stall other connections on that loop.
                  */
                 bool SetBody(const std::shared_ptr<Aws::Crt::Io::IStream> &body) noexcept;
 
@@ -54,6 +56,29 @@ namespace Aws
                 bool AddHeader(const HttpHeader &header) noexcept;
                 bool EraseHeader(size_t index) noexcept;
 
+                /**
+                 * Gets the value of the first header whose name matches name, ignoring case. The returned cursor
+                 * points into the message and is valid until that header is modified or erased.
+                 */
+                Optional<ByteCursor> GetHeader(ByteCursor name) const noexcept;
+
+                /**
+                 * Replaces every header whose name matches header.name, ignoring case, with header. The header is
+                 * added if none matched.
+                 */
+                bool SetHeader(const HttpHeader &header) noexcept;
+
+                /**
+                 * Erases every header whose name matches name, ignoring case. Returns false if none did.
+                 */
+                bool EraseHeader(ByteCursor name) noexcept;
+
+                /**
+                 * Appends count headers in one call. If one of them can't be added, the ones added before it are
+                 * removed again.
+                 */
+                bool AddHeaders(const HttpHeader *headers, size_t count) noexcept;
+
                 operator bool() const noexcept { return m_message != nullptr; }
 
                 struct aws_http_message *GetUnderlyingMessage() const noexcept { return m_message; }
@@ -100,6 +125,76 @@ namespace Aws
                 HttpRequest(Allocator *allocator, struct aws_http_message *message);
             };
 
+            /**
+             * Pre-built request shape: method, path and a set of static headers, stored once in a single buffer.
+             * NewRequest() stamps out an HttpRequest carrying all of it with one bulk header insertion, so the only
+             * per-request work left is whatever actually varies.
+             */
+            class AWS_CRT_CPP_API HttpRequestTemplate final
+            {
+              public:
+                HttpRequestTemplate(Allocator *allocator = g_allocator) noexcept;
+                ~HttpRequestTemplate();
+
+                HttpRequestTemplate(const HttpRequestTemplate &) = delete;
+                HttpRequestTemplate(HttpRequestTemplate &&) = delete;
+                HttpRequestTemplate &operator=(const HttpRequestTemplate &) = delete;
+                HttpRequestTemplate &operator=(HttpRequestTemplate &&) = delete;
+
+                /**
+                 * Sets the Http method stamped onto every request
+                 */
+                bool SetMethod(ByteCursor method) noexcept;
+
+                /**
+                 * Sets the URI-path stamped onto every request. Requests can still override it with SetPath().
+                 */
+                bool SetPath(ByteCursor path) noexcept;
+
+                /**
+                 * Adds a header stamped onto every request. The name and value are copied.
+                 */
+                bool AddHeader(const HttpHeader &header) noexcept;
+
+                /**
+                 * @return the headers added so far. The pointers are valid until the next AddHeader() call.
+                 */
+                const Vector<HttpHeader> &GetHeaders() const noexcept { return m_headers; }
+
+                /**
+                 * Creates a request from the template. overrides, if given, replace any template headers with the
+                 * same name (ignoring case) or are appended otherwise.
+                 *
+                 * Returns nullptr on failure.
+                 */
+                std::shared_ptr<HttpRequest> NewRequest(
+                    const HttpHeader *overrides = nullptr,
+                    size_t overrideCount = 0) const noexcept;
+
+              private:
+                struct StoredHeader
+                {
+                    size_t nameOffset;
+                    size_t nameLength;
+                    size_t valueOffset;
+                    size_t valueLength;
+                };
+
+                bool Store(ByteCursor data, size_t &outOffset) noexcept;
+                ByteCursor StoredCursor(size_t offset, size_t length) const noexcept;
+
+                Allocator *m_allocator;
+                ByteBuf m_storage;
+                Vector<StoredHeader> m_storedHeaders;
+                Vector<HttpHeader> m_headers;
+                size_t m_methodOffset;
+                size_t m_methodLength;
+                size_t m_pathOffset;
+                size_t m_pathLength;
+                bool m_hasMethod;
+                bool m_hasPath;
+            };
+
             /**
              * Class representing a mutable http response.
              */
@@ -0,0 +1,132 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/io/Stream.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Io
+        {
+            /***
+             * Base class for streams whose data is produced somewhere other than the thread reading them: a worker
+             * reading a slow disk or a pipe, another network request, etc. Such a stream can be used as a message body
+             * with HttpMessage::SetBody() without stalling the connection's event loop.
+             *
+             * Reads never block. A read hands out whatever has been produced so far and, once there is room, asks the
+             * subclass for more through ReadAsyncImpl(). If nothing has been produced yet, the read succeeds without
+             * any data and the stream reports neither the end nor an error. The HTTP connection then carries on with
+             * its other streams and polls this one again on a later tick.
+             *
+             * Data is double buffered. The subclass fills one buffer of bufferSize bytes while the reader drains the
+             * other.
+             */
+            class AWS_CRT_CPP_API AsyncInputStream : public InputStream
+            {
+              public:
+                ~AsyncInputStream();
+
+                bool IsValid() const noexcept override;
+
+              protected:
+                AsyncInputStream(size_t bufferSize = 64 * 1024, Aws::Crt::Allocator *allocator = g_allocator) noexcept;
+
+                /**
+                 * Starts producing up to buffer.capacity - buffer.len bytes into buffer. The read may finish
+                 * synchronously or later from any thread, but it must finish with exactly one call to CompleteRead()
+                 * and must not touch buffer afterwards. Only one read is in flight at a time.
+                 *
+                 * A subclass must make sure no read is still in flight by the time it is destroyed.
+                 */
+                virtual void ReadAsyncImpl(ByteBuf &buffer) noexcept = 0;
+
+                /**
+                 * Finishes the read started by ReadAsyncImpl(). endOfStream marks what was just produced as the end
+                 * of the stream. A non-zero errorCode fails the stream; the reader sees it on its next read.
+                 */
+                void CompleteRead(bool endOfStream, int errorCode = AWS_ERROR_SUCCESS) noexcept;
+
+                /**
+                 * Repositions the producer. It is only called when no read is in flight, and everything buffered has
+                 * already been discarded. The default fails with AWS_ERROR_STREAM_UNSEEKABLE.
+                 */
+                virtual bool SeekAsyncImpl(OffsetType offset, StreamSeekBasis seekBasis) noexcept;
+
+                /**
+                 * @return true while a read started by ReadAsyncImpl() has not completed yet.
+                 */
+                bool IsReadInFlight() const noexcept;
+
+                bool ReadImpl(ByteBuf &buffer) noexcept override;
+                StreamStatus GetStatusImpl() const noexcept override;
+
+                /**
+                 * The default returns -1 (unknown length). In that case the body needs a Content-Length header set by
+                 * hand, or chunked transfer encoding.
+                 */
+                int64_t GetLengthImpl() const noexcept override;
+
+                /**
+                 * Fails with AWS_ERROR_STREAM_UNSEEKABLE while a read is in flight. Otherwise it discards everything
+                 * buffered and passes the seek on to SeekAsyncImpl().
+                 */
+                bool SeekImpl(OffsetType offset, StreamSeekBasis seekBasis) noexcept override;
+
+              private:
+                void DrainInto(ByteBuf &buffer) noexcept;
+
+                mutable std::mutex m_lock;
+                ByteBuf m_front;
+                size_t m_frontOffset;
+                ByteBuf m_back;
+                bool m_readInFlight;
+                bool m_producerDone;
+                int m_errorCode;
+            };
+
+            /***
+             * AsyncInputStream that runs the reads of an ordinary, blocking InputStream on a worker thread, started
+             * with the first read and kept for the life of the stream. This keeps a file on a slow disk, or a
+             * StdIOStreamInputStream over a pipe, off the event loop.
+             *
+             * A source read that returns nothing without reaching the end is retried by the worker after a short
+             * wait, growing from 1ms to 100ms while the source stays empty. The read stays in flight meanwhile.
+             */
+            class AWS_CRT_CPP_API AsyncInputStreamAdapter final : public AsyncInputStream
+            {
+              public:
+                AsyncInputStreamAdapter(
+                    const std::shared_ptr<InputStream> &source,
+                    size_t bufferSize = 64 * 1024,
+                    Aws::Crt::Allocator *allocator = g_allocator) noexcept;
+                ~AsyncInputStreamAdapter();
+
+                bool IsValid() const noexcept override;
+
+              protected:
+                void ReadAsyncImpl(ByteBuf &buffer) noexcept override;
+                int64_t GetLengthImpl() const noexcept override;
+                bool SeekAsyncImpl(OffsetType offset, StreamSeekBasis seekBasis) noexcept override;
+
+              private:
+                void ReadWorker() noexcept;
+
+                std::shared_ptr<InputStream> m_source;
+
+                std::mutex m_workerLock;
+                std::condition_variable m_workerSignal;
+                /* the buffer of the read waiting for the worker to pick it up */
+                ByteBuf *m_requestedBuffer;
+                bool m_stopWorker;
+                std::thread m_worker;
+            };
+        } // namespace Io
+    }     // namespace Crt
+} // namespace Aws
@@ -20,7 +20,7 @@ namespace Aws
     {
         namespace Io
         {
-            using OnClientBootstrapShutdownComplete = std::function<void()>;
+            using OnClientBootstrapShutdownComplete = Function<void()>;
 
             /**
              * A ClientBootstrap handles creation and setup of socket connections
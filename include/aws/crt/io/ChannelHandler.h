@@ -6,10 +6,12 @@
 
 #include <aws/crt/Exports.h>
 #include <aws/crt/Types.h>
+#include <aws/common/statistics.h>
 #include <aws/io/channel.h>
 
 #include <chrono>
 #include <cstddef>
+#include <functional>
 
 struct aws_array_list;
 struct aws_io_message;
@@ -20,6 +22,8 @@ namespace Aws
     {
         namespace Io
         {
+            class ReadWindowTuner;
+
             enum class ChannelDirection
             {
                 Read,
@@ -37,6 +41,54 @@ namespace Aws
                 Canceled,
             };
 
+            /**
+             * A piece of data to write with ChannelHandler::SendSegments(), which sends it without copying it when
+             * it is large enough.
+             */
+            struct AWS_CRT_CPP_API WriteSegment
+            {
+                /**
+                 * The data. It must stay valid and unchanged until OnRelease is called.
+                 */
+                ByteCursor Data;
+
+                /**
+                 * Called once, on the channel's thread, when the channel no longer needs Data: after it was
+                 * written, or copied into a message of its own, or with an error code when it will not be written.
+                 * May be empty.
+                 */
+                std::function<void(int errorCode)> OnRelease;
+            };
+
+            /**
+             * What a ChannelHandler reports about itself each time its channel samples statistics. The counts cover
+             * the messages handed to the handler since the previous sample.
+             */
+            struct AWS_CRT_CPP_API ChannelHandlerStatistics
+            {
+                /**
+                 * The name the handler reports itself by, see ChannelHandler::GetStatisticsName().
+                 */
+                String HandlerName;
+
+                /**
+                 * Messages, and the bytes in them, the handler accepted in ProcessReadMessage().
+                 */
+                uint64_t MessagesRead = 0;
+                uint64_t BytesRead = 0;
+
+                /**
+                 * Messages, and the bytes in them, the handler accepted in ProcessWriteMessage().
+                 */
+                uint64_t MessagesWritten = 0;
+                uint64_t BytesWritten = 0;
+
+                /**
+                 * Counters of the handler's own, added by ChannelHandler::AddStatistics().
+                 */
+                Map<String, uint64_t> Counters;
+            };
+
             /**
              * Wrapper for aws-c-io channel handlers. The semantics are identical as the functions on
              * aws_channel_handler.
@@ -118,24 +170,54 @@ namespace Aws
 
                 /**
                  * Directs the channel handler to reset all of the internal statistics it tracks about itself.
+                 * The message and byte counts of ChannelHandlerStatistics are reset before this is called.
                  */
                 virtual void ResetStatistics(){};
 
                 /**
                  * Adds a pointer to the handler's internal statistics (if they exist) to a list of statistics
                  * structures associated with the channel's handler chain.
+                 *
+                 * By default this adds the handler's ChannelHandlerStatistics, which a channel statistics callback
+                 * (see SetChannelStatisticsCallback()) receives. Overrides that add C statistics of their own should
+                 * call it too.
                  */
-                virtual void GatherStatistics(struct aws_array_list *) {}
+                virtual void GatherStatistics(struct aws_array_list *statsList);
+
+                /**
+                 * @return the name the handler's statistics are reported under.
+                 */
+                virtual String GetStatisticsName() const { return "cpp-crt-channel-handler"; }
+
+                /**
+                 * Called on the channel's thread each time statistics are sampled, to add counters of the
+                 * handler's own to statistics, such as frames decoded or bytes buffered. Reset them in
+                 * ResetStatistics().
+                 */
+                virtual void AddStatistics(ChannelHandlerStatistics &statistics) const { (void)statistics; }
 
               public:
                 /// @private
                 struct aws_channel_handler *SeatForCInterop(const std::shared_ptr<ChannelHandler> &selfRef);
 
+                /**
+                 * @return the handler that added record to a statistics list, or nullptr if it was not added by
+                 * a C++ handler.
+                 * @private
+                 */
+                static const ChannelHandler *FromStatisticsRecord(const struct aws_crt_statistics_base *record);
+
                 /**
                  * Return whether the caller is on the same thread as the handler's channel.
                  */
                 bool ChannelsThreadIsCallersThread() const;
 
+                /**
+                 * @return what the handler would report for the current sampling interval. Must be called from the
+                 * channel's thread.
+                 */
+                ChannelHandlerStatistics GetStatistics() const;
+
                 /**
                  * Initiate a shutdown of the handler's channel.
                  *
@@ -178,12 +260,55 @@ namespace Aws
                  */
                 bool SendMessage(struct aws_io_message *message, ChannelDirection direction);
 
+                /**
+                 * Segments at least this long are sent as messages of their own that point at their data, shorter
+                 * ones are copied together into pool messages.
+                 */
+                static const size_t SegmentCopyThreshold = 4096;
+
+                /**
+                 * Sends segments in the write direction, in order, such as a protocol header followed by a large
+                 * payload. Segments of SegmentCopyThreshold bytes or more are handed to the channel as they are,
+                 * in messages that point at their data, instead of being copied into pool messages; runs of smaller
+                 * segments are gathered into as few pool messages as fit them.
+                 *
+                 * Every segment's OnRelease is called exactly once, even when sending fails.
+                 * Must be called from the channel's thread.
+                 *
+                 * @return true if every segment was sent. If false is returned, the segments that were not sent
+                 * have been released with the error, and the ones before them are still written.
+                 */
+                bool SendSegments(Vector<WriteSegment> &&segments);
+
                 /**
                  * Issue a window update notification upstream.
                  * Returns true if successful.
                  */
                 bool IncrementUpstreamReadWindow(size_t windowUpdateSize);
 
+                /**
+                 * Sizes the handler's read window adaptively instead of handing every consumed byte back to it:
+                 * the tuner sees each message as it arrives and decides how much of what OnReadDataConsumed()
+                 * reports goes upstream. Set it before the handler is added to a slot and return the tuner's
+                 * GetWindowSize() from InitialWindowSize(). Passing nullptr turns it off.
+                 */
+                void SetReadWindowTuner(const std::shared_ptr<ReadWindowTuner> &tuner);
+
+                /**
+                 * @return the tuner set with SetReadWindowTuner(), if any.
+                 */
+                const std::shared_ptr<ReadWindowTuner> &GetReadWindowTuner() const noexcept
+                {
+                    return m_readWindowTuner;
+                }
+
+                /**
+                 * Reports read data the handler is done with and issues the window update for it: what the read
+                 * window tuner returns if one is set, bytesConsumed otherwise.
+                 * Returns true if successful.
+                 */
+                bool OnReadDataConsumed(size_t bytesConsumed);
+
                 /**
                  * Must be called by a handler once they have finished their shutdown in the 'dir' direction.
                  * Propagates the shutdown process to the next handler in the channel.
@@ -209,7 +334,20 @@ namespace Aws
                 Allocator *m_allocator;
 
               private:
+                /* what GatherStatistics() adds to the channel's list, with the category of C++ handlers */
+                struct StatisticsRecord
+                {
+                    struct aws_crt_statistics_base base;
+                    ChannelHandler *handler;
+                };
+
                 std::shared_ptr<ChannelHandler> m_selfReference;
+                std::shared_ptr<ReadWindowTuner> m_readWindowTuner;
+                StatisticsRecord m_statisticsRecord;
+                uint64_t m_messagesRead;
+                uint64_t m_bytesRead;
+                uint64_t m_messagesWritten;
+                uint64_t m_bytesWritten;
                 static struct aws_channel_handler_vtable s_vtable;
 
                 static void s_Destroy(struct aws_channel_handler *handler);
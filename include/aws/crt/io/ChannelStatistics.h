@@ -0,0 +1,96 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/Optional.h>
+#include <aws/crt/io/ChannelHandler.h>
+
+#include <chrono>
+#include <functional>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Io
+        {
+            /**
+             * Bytes the channel's socket moved during the sampling interval.
+             */
+            struct AWS_CRT_CPP_API SocketStatistics
+            {
+                uint64_t BytesRead = 0;
+                uint64_t BytesWritten = 0;
+            };
+
+            enum class TlsNegotiationStatus
+            {
+                None,
+                Ongoing,
+                Success,
+                Failure,
+            };
+
+            /**
+             * State of the channel's TLS handshake.
+             */
+            struct AWS_CRT_CPP_API TlsStatistics
+            {
+                TlsNegotiationStatus HandshakeStatus = TlsNegotiationStatus::None;
+
+                /**
+                 * Time the handshake took, zero until it has finished.
+                 */
+                std::chrono::nanoseconds HandshakeDuration = std::chrono::nanoseconds(0);
+            };
+
+            /**
+             * One sample of the statistics of a channel's handlers.
+             */
+            struct AWS_CRT_CPP_API ChannelStatistics
+            {
+                /**
+                 * Bounds of the sampling interval, in milliseconds of the channel's clock.
+                 */
+                uint64_t IntervalBeginMs = 0;
+                uint64_t IntervalEndMs = 0;
+
+                /**
+                 * Set if the channel has a socket handler.
+                 */
+                Optional<SocketStatistics> Socket;
+
+                /**
+                 * Set if the channel has a TLS handler.
+                 */
+                Optional<TlsStatistics> Tls;
+
+                /**
+                 * The C++ handlers of the channel, left to right.
+                 */
+                Vector<ChannelHandlerStatistics> Handlers;
+            };
+
+            /**
+             * Invoked on the channel's thread with each sample.
+             */
+            using OnChannelStatistics = std::function<void(const ChannelStatistics &statistics)>;
+
+            /**
+             * Samples the statistics of channel's handlers every reportInterval and passes them to callback, until
+             * the channel is destroyed or another statistics handler is set on it. Safe to call from any thread.
+             *
+             * A channel has one statistics handler, so this replaces any the channel had, such as the connection
+             * health monitoring of an HTTP connection manager.
+             *
+             * @return true if the callback is being installed, false otherwise.
+             */
+            AWS_CRT_CPP_API bool SetChannelStatisticsCallback(
+                struct aws_channel *channel,
+                std::chrono::milliseconds reportInterval,
+                OnChannelStatistics &&callback,
+                Allocator *allocator = g_allocator) noexcept;
+        } // namespace Io
+    }     // namespace Crt
+} // namespace Aws
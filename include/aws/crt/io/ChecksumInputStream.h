@@ -0,0 +1,99 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/Optional.h>
+#include <aws/crt/crypto/Checksum.h>
+#include <aws/crt/crypto/Hash.h>
+#include <aws/crt/io/Stream.h>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Io
+        {
+            enum class StreamChecksumAlgorithm
+            {
+                Crc32,
+                Crc32c,
+                Md5,
+                Sha256,
+            };
+
+            static const size_t CRC32_CHECKSUM_SIZE = Crypto::CRC32_DIGEST_SIZE;
+
+            /***
+             * InputStream decorator that checksums the bytes of another stream while they are read, e.g. by the
+             * HTTP layer sending a request body. Integrity checksums for an upload then cost no extra pass over
+             * the data.
+             *
+             * The checksum covers every byte read since the start of the stream. Rewinding to the beginning, as a
+             * retried request does, starts it over. Any other seek fails with AWS_ERROR_STREAM_UNSEEKABLE, since
+             * the skipped bytes could not be accounted for.
+             */
+            class AWS_CRT_CPP_API ChecksumInputStream final : public InputStream
+            {
+              public:
+                /**
+                 * Checksums source, which must be positioned at its beginning.
+                 */
+                ChecksumInputStream(
+                    const std::shared_ptr<InputStream> &source,
+                    StreamChecksumAlgorithm algorithm,
+                    Aws::Crt::Allocator *allocator = g_allocator) noexcept;
+
+                bool IsValid() const noexcept override;
+
+                /**
+                 * @return the algorithm the stream was created with.
+                 */
+                StreamChecksumAlgorithm GetAlgorithm() const noexcept { return m_algorithm; }
+
+                /**
+                 * @return the size of the checksum Digest() writes: CRC32_CHECKSUM_SIZE, MD5_DIGEST_SIZE or
+                 * SHA256_DIGEST_SIZE.
+                 */
+                size_t GetChecksumSize() const noexcept;
+
+                /**
+                 * @return the number of bytes checksummed so far.
+                 */
+                uint64_t GetBytesChecksummed() const noexcept { return m_bytesChecksummed; }
+
+                /**
+                 * Writes the checksum of everything read so far into output; CRCs are written big endian, the way
+                 * they are transmitted. Call it once the stream has reached its end.
+                 *
+                 * A CRC can be written any number of times. An MD5 or SHA256 digest finishes the hash: it can only be
+                 * written once, and further reads fail, until the stream is rewound. Returns true on success. Call
+                 * LastError() for the reason this call failed.
+                 */
+                bool Digest(ByteBuf &output) noexcept;
+
+                /**
+                 * Returns the value of the last aws error encountered by operations on this instance.
+                 */
+                int LastError() const noexcept { return m_lastError; }
+
+              protected:
+                bool ReadImpl(ByteBuf &buffer) noexcept override;
+                StreamStatus GetStatusImpl() const noexcept override;
+                int64_t GetLengthImpl() const noexcept override;
+                bool SeekImpl(OffsetType offset, StreamSeekBasis seekBasis) noexcept override;
+
+              private:
+                void Restart() noexcept;
+
+                std::shared_ptr<InputStream> m_source;
+                StreamChecksumAlgorithm m_algorithm;
+                Optional<Crypto::Hash> m_hash;
+                uint32_t m_crc;
+                uint64_t m_bytesChecksummed;
+                bool m_finished;
+                int m_lastError;
+            };
+        } // namespace Io
+    }     // namespace Crt
+} // namespace Aws
@@ -4,15 +4,20 @@
  * SPDX-License-Identifier: Apache-2.0.
  */
 #include <aws/crt/Types.h>
+#include <aws/crt/io/ChannelHandler.h>
 
 #include <aws/io/event_loop.h>
 
+#include <functional>
+
 namespace Aws
 {
     namespace Crt
     {
         namespace Io
         {
+            struct EventLoopGroupTaskQueues;
+
             /**
              * A collection of event loops.
              *
@@ -28,6 +33,10 @@ namespace Aws
              * want to peg different types of IO to different threads. In that case, you
              * may want to have one event loop group dedicated to one IO activity and another
              * dedicated to another type.
+             *
+             * On machines with several NUMA nodes, latency-sensitive applications can instead create one group per
+             * cpu group (see GetCpuGroupCount() and PinnedToCpuGroup()), with a ClientBootstrap over each.
+             * Connections made through a bootstrap then stay on the cores, and the memory, of its node.
              */
             class AWS_CRT_CPP_API EventLoopGroup final
             {
@@ -50,11 +59,71 @@ namespace Aws
                  * @return the value of the last aws error encountered by operations on this instance.
                  */
                 int LastError() const;
+
+                /**
+                 * Creates a group whose event-loop threads are pinned to one cpu group.
+                 * @param cpuGroup: The cpu group (NUMA node on most systems) to pin the event-loop threads to, from
+                 * 0 to GetCpuGroupCount() - 1.
+                 * @param threadCount: The number of event-loops to create, 0 lets the runtime size the group for the
+                 * processors of the cpu group.
+                 */
+                static EventLoopGroup PinnedToCpuGroup(
+                    uint16_t cpuGroup,
+                    uint16_t threadCount = 0,
+                    Allocator *allocator = g_allocator) noexcept;
+
+                /**
+                 * @return the number of cpu groups (NUMA nodes on most systems) on the machine.
+                 */
+                static uint16_t GetCpuGroupCount() noexcept;
+                /**
+                 * @return the number of processors in cpuGroup.
+                 */
+                static size_t GetCpuCountForGroup(uint16_t cpuGroup) noexcept;
+
+                /**
+                 * @return the number of event-loops in the group, 0 if it is not valid.
+                 */
+                size_t GetLoopCount() noexcept;
+                /**
+                 * Event-loop number index of the group, for work that has to stay on the same thread as something
+                 * else on it. nullptr if index is out of range.
+                 * @private
+                 */
+                aws_event_loop *GetLoopAt(size_t index) noexcept;
+                /**
+                 * The event-loop the group would hand the next connection, the least loaded of two picked at random.
+                 * @private
+                 */
+                aws_event_loop *GetNextLoop() noexcept;
+
+                /**
+                 * Queues task to run on event-loop number loopIndex of the group. Safe to call from any thread.
+                 *
+                 * Tasks queued from other threads are collected without locking and run in batches, in the order
+                 * they were queued: the loop is woken once for every batch rather than once per task. If the group
+                 * shuts down first, the task runs with the 'Canceled' status.
+                 *
+                 * @return true if the task was queued, false if the group is not valid or has no such loop.
+                 */
+                bool Schedule(std::function<void(TaskStatus)> &&task, size_t loopIndex) noexcept;
+
+                /**
+                 * Queues task to run on the loops of the group in turn, as Schedule(task, loopIndex) does.
+                 */
+                bool Schedule(std::function<void(TaskStatus)> &&task) noexcept;
+
                 /// @private
                 aws_event_loop_group *GetUnderlyingHandle() noexcept;
 
               private:
+                /* cpuGroup is null for a group that is not pinned */
+                EventLoopGroup(uint16_t threadCount, const uint16_t *cpuGroup, Allocator *allocator) noexcept;
+                void InitTaskQueues() noexcept;
+
                 aws_event_loop_group *m_eventLoopGroup;
+                /* freed by the C group once its loops have shut down */
+                EventLoopGroupTaskQueues *m_taskQueues;
                 int m_lastError;
             };
         } // namespace Io
@@ -0,0 +1,102 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/io/EventLoopGroup.h>
+
+#include <chrono>
+#include <memory>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Io
+        {
+            struct EventLoopMonitorState;
+
+            /**
+             * What an EventLoopMonitor has measured of one event-loop.
+             */
+            struct AWS_CRT_CPP_API EventLoopStatistics
+            {
+                static const size_t LatencyBucketCount = 20;
+
+                /**
+                 * The load factor the event-loop reports: the number of channels and socket handles registered with
+                 * it, which the group balances new connections on.
+                 */
+                size_t LoadFactor = 0;
+
+                /**
+                 * Number of probe tasks that have run.
+                 */
+                uint64_t Probes = 0;
+
+                /**
+                 * How late probe tasks ran after they were due: the time the loop spent on other tasks and I/O
+                 * callbacks before coming back to its task queue. A loop a slow handler or callback is starving
+                 * shows it here first.
+                 */
+                std::chrono::nanoseconds LastLatency = std::chrono::nanoseconds(0);
+                std::chrono::nanoseconds MaxLatency = std::chrono::nanoseconds(0);
+                std::chrono::nanoseconds TotalLatency = std::chrono::nanoseconds(0);
+
+                /**
+                 * Probe latencies by power of two of microseconds: bucket 0 counts those under 2us, bucket i those
+                 * from 2^i up to 2^(i+1) us, and the last bucket everything longer.
+                 */
+                uint64_t LatencyHistogram[LatencyBucketCount] = {};
+            };
+
+            /**
+             * Watches the event-loops of an EventLoopGroup for saturation, by scheduling a probe task on each of
+             * them every probe interval and measuring how long past its due time it runs.
+             *
+             * The probes are a few dozen bytes each and run for a few microseconds, so a monitor can be left on in
+             * production. The monitor holds a reference to the group's event-loops while it lives. Thread safe.
+             */
+            class AWS_CRT_CPP_API EventLoopMonitor final
+            {
+              public:
+                EventLoopMonitor(
+                    EventLoopGroup &eventLoopGroup,
+                    std::chrono::milliseconds probeInterval = std::chrono::seconds(1),
+                    Allocator *allocator = g_allocator) noexcept;
+                ~EventLoopMonitor();
+                EventLoopMonitor(const EventLoopMonitor &) = delete;
+                EventLoopMonitor &operator=(const EventLoopMonitor &) = delete;
+
+                /**
+                 * @return true if the instance is in a valid state, false otherwise.
+                 */
+                explicit operator bool() const noexcept { return m_state != nullptr; }
+                /**
+                 * @return the value of the last aws error encountered by operations on this instance.
+                 */
+                int LastError() const noexcept { return m_lastError; }
+
+                /**
+                 * @return the statistics of every event-loop, in the order of the group.
+                 */
+                Vector<EventLoopStatistics> GetStatistics() const noexcept;
+
+                /**
+                 * @return the statistics of event-loop number loopIndex of the group, all zero if there is no such
+                 * loop.
+                 */
+                EventLoopStatistics GetStatistics(size_t loopIndex) const noexcept;
+
+                /**
+                 * Clears the probe measurements gathered so far.
+                 */
+                void Reset() noexcept;
+
+              private:
+                std::shared_ptr<EventLoopMonitorState> m_state;
+                int m_lastError;
+            };
+        } // namespace Io
+    }     // namespace Crt
+} // namespace Aws
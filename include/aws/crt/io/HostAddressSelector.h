@@ -0,0 +1,105 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/io/HostResolver.h>
+
+#include <chrono>
+#include <mutex>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Io
+        {
+            /**
+             * What a HostAddressSelector has observed of connecting to one address.
+             */
+            struct AWS_CRT_CPP_API HostAddressStatistics
+            {
+                uint64_t ConnectAttempts = 0;
+                uint64_t ConnectFailures = 0;
+
+                /**
+                 * Failures since the last successful connect.
+                 */
+                uint64_t ConsecutiveFailures = 0;
+
+                /**
+                 * Smoothed time from starting a connect to a usable connection, over the successful attempts:
+                 * each new sample counts for one eighth, as TCP smooths its round trip time. Zero until the first
+                 * success.
+                 */
+                std::chrono::nanoseconds SmoothedConnectLatency = std::chrono::nanoseconds(0);
+            };
+
+            /**
+             * Ranks the addresses a host resolves to by how connecting to them has gone so far, so connection
+             * setup starts with the fastest address that works instead of taking them in resolver order.
+             *
+             * Order() puts healthy addresses first, fastest measured first and untried ones after them, and
+             * addresses that failed their last connect within the failure penalty last. It then interleaves the
+             * IPv6 and IPv4 addresses, starting with the family of the best one, as Happy Eyeballs (RFC 8305) does,
+             * so the top of each family can be raced against the other.
+             *
+             * Feed it with RecordConnectSuccess() and RecordConnectFailure(); failures are also reported to the
+             * resolver it was created with, which then lowers the address in its own answers. Thread safe.
+             */
+            class AWS_CRT_CPP_API HostAddressSelector final
+            {
+              public:
+                /**
+                 * @param resolver: resolver to report connect failures to, may be nullptr.
+                 * @param failurePenalty: how long an address that failed its last connect is ranked below the
+                 * others. It doubles with every further consecutive failure, up to 32 times its length.
+                 */
+                explicit HostAddressSelector(
+                    HostResolver *resolver = nullptr,
+                    std::chrono::milliseconds failurePenalty = std::chrono::seconds(30)) noexcept;
+
+                HostAddressSelector(const HostAddressSelector &) = delete;
+                HostAddressSelector &operator=(const HostAddressSelector &) = delete;
+
+                /**
+                 * Records a connect to address that succeeded after latency.
+                 */
+                void RecordConnectSuccess(const HostAddress &address, std::chrono::nanoseconds latency) noexcept;
+
+                /**
+                 * Records a connect to address that failed.
+                 */
+                void RecordConnectFailure(const HostAddress &address) noexcept;
+
+                /**
+                 * @return addresses, best first. The HostAddress values are copied as they are, so they refer to the
+                 * same memory as addresses.
+                 */
+                Vector<HostAddress> Order(const Vector<HostAddress> &addresses) const noexcept;
+
+                /**
+                 * @return what has been recorded for the address with text address, all zero if nothing has.
+                 */
+                HostAddressStatistics GetStatistics(const String &address) const noexcept;
+
+                /**
+                 * Forgets everything recorded so far.
+                 */
+                void Clear() noexcept;
+
+              private:
+                struct AddressEntry
+                {
+                    HostAddressStatistics statistics;
+                    std::chrono::steady_clock::time_point lastFailure;
+                };
+
+                HostResolver *m_resolver;
+                std::chrono::milliseconds m_failurePenalty;
+                mutable std::mutex m_lock;
+                Map<String, AddressEntry> m_addresses;
+            };
+        } // namespace Io
+    }     // namespace Crt
+} // namespace Aws
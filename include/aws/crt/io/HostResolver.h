@@ -7,6 +7,7 @@
 
 #include <aws/io/host_resolver.h>
 
+#include <chrono>
 #include <functional>
 
 namespace Aws
@@ -26,7 +27,46 @@ namespace Aws
              * operation failed.
              */
             using OnHostResolved =
-                std::function<void(HostResolver &resolver, const Vector<HostAddress> &addresses, int errorCode)>;
+                Function<void(HostResolver &resolver, const Vector<HostAddress> &addresses, int errorCode)>;
+
+            /**
+             * Counters of a DefaultHostResolver since it was created.
+             */
+            struct AWS_CRT_CPP_API HostResolverStatistics
+            {
+                /**
+                 * ResolveHost() calls that completed.
+                 */
+                uint64_t Resolutions = 0;
+
+                /**
+                 * ResolveHost() calls for a host that already had addresses in the cache, and so were answered
+                 * without waiting on DNS.
+                 */
+                uint64_t CacheHits = 0;
+
+                /**
+                 * ResolveHost() calls for a host without cached addresses, which had to wait on a DNS query.
+                 */
+                uint64_t CacheMisses = 0;
+
+                /**
+                 * Resolutions that completed with an error, including prefetches and refreshes.
+                 */
+                uint64_t Failures = 0;
+
+                /**
+                 * Resolutions started by Prefetch() and PinHost().
+                 */
+                uint64_t Prefetches = 0;
+
+                /**
+                 * Resolutions of pinned hosts started to keep them in the cache.
+                 */
+                uint64_t Refreshes = 0;
+            };
+
+            struct DefaultHostResolverState;
 
             class AWS_CRT_CPP_API HostResolver
             {
@@ -77,6 +117,38 @@ namespace Aws
                  */
                 bool ResolveHost(const String &host, const OnHostResolved &onResolved) noexcept override;
 
+                /**
+                 * Starts resolving each of hosts without waiting for the result, so that the addresses are cached by
+                 * the time they are first needed. Hosts that are already cached are left as they are.
+                 * @return False if some of the resolutions could not be started.
+                 */
+                bool Prefetch(const Vector<String> &hosts) noexcept;
+
+                /**
+                 * Prefetches host, then resolves it again every refreshInterval for as long as it stays pinned, so
+                 * its addresses never age out of the cache or get evicted for being idle. The interval should be
+                 * well short of the maxTTL the resolver was created with. Pinning a pinned host only updates its
+                 * interval.
+                 * @return False if the resolution could not be started.
+                 */
+                bool PinHost(const String &host, std::chrono::milliseconds refreshInterval) noexcept;
+
+                /**
+                 * Stops refreshing host. Its addresses stay in the cache until they expire as usual.
+                 */
+                void UnpinHost(const String &host) noexcept;
+
+                /**
+                 * @return the number of IPv4 and IPv6 addresses of host currently in the cache.
+                 */
+                size_t GetCachedAddressCount(const String &host) const noexcept;
+
+                /**
+                 * @return a snapshot of the resolver's counters. They are read one by one without a lock, so they
+                 * may be very slightly out of step with each other.
+                 */
+                HostResolverStatistics GetStatistics() const noexcept;
+
                 /// @private
                 aws_host_resolver *GetUnderlyingHandle() noexcept override { return m_resolver; }
                 /// @private
@@ -87,6 +159,8 @@ namespace Aws
                 aws_host_resolution_config m_config;
                 Allocator *m_allocator;
                 bool m_initialized;
+                /* shared with the resolutions and refreshes in flight, which may outlive the resolver */
+                std::shared_ptr<DefaultHostResolverState> m_state;
 
                 static void s_onHostResolved(
                     struct aws_host_resolver *resolver,
@@ -0,0 +1,99 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/io/Stream.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Io
+        {
+            /***
+             * InputStream decorator that reads another stream a block at a time, however small the reads made of
+             * it are. Each block is filled with as many reads of the source as it takes, so a slow source backed by
+             * the network or a decompressor does a few large reads instead of one per chunk the HTTP layer asks for.
+             *
+             * With prefetch enabled, the next block is read on a worker thread, started with the first read ahead
+             * and kept for the life of the stream, while the current one is being drained. A read that gets ahead of
+             * the prefetch does not wait for it: it hands out what it has, without reaching the end of the stream,
+             * and the next read picks the block up. An error reading ahead is reported once the data before it has
+             * been consumed.
+             *
+             * A source that returns no data without reaching its end (a non-blocking one with nothing ready) ends the
+             * block early, and the read hands out what it has.
+             */
+            class AWS_CRT_CPP_API ReadAheadInputStream final : public InputStream
+            {
+              public:
+                ReadAheadInputStream(
+                    const std::shared_ptr<InputStream> &source,
+                    size_t blockSize = 256 * 1024,
+                    bool prefetch = true,
+                    Aws::Crt::Allocator *allocator = g_allocator) noexcept;
+                ~ReadAheadInputStream();
+
+                bool IsValid() const noexcept override;
+
+                /**
+                 * @return the size of the blocks read from the source.
+                 */
+                size_t GetBlockSize() const noexcept { return m_blockSize; }
+
+                /**
+                 * Returns the value of the last aws error encountered by operations on this instance.
+                 */
+                int LastError() const noexcept { return m_lastError; }
+
+              protected:
+                bool ReadImpl(ByteBuf &buffer) noexcept override;
+                StreamStatus GetStatusImpl() const noexcept override;
+                int64_t GetLengthImpl() const noexcept override;
+
+                /**
+                 * Waits for any read ahead to finish, discards everything buffered and seeks the source.
+                 */
+                bool SeekImpl(OffsetType offset, StreamSeekBasis seekBasis) noexcept override;
+
+              private:
+                int FillBackBlock() noexcept;
+                bool NextBlock() noexcept;
+                void StartPrefetch() noexcept;
+                void WaitForPrefetch() noexcept;
+                void PrefetchWorker() noexcept;
+
+                enum class PrefetchState
+                {
+                    Idle,
+                    /* the worker owns the back block until the state moves on */
+                    Requested,
+                    Ready,
+                };
+
+                std::shared_ptr<InputStream> m_source;
+                size_t m_blockSize;
+                bool m_prefetchEnabled;
+                ByteBuf m_front;
+                size_t m_frontOffset;
+                ByteBuf m_back;
+                /* written by whoever fills the back block, only read once that fill has completed */
+                bool m_sourceDone;
+
+                mutable std::mutex m_prefetchLock;
+                std::condition_variable m_prefetchSignal;
+                PrefetchState m_prefetchState;
+                int m_prefetchError;
+                bool m_stopWorker;
+                std::thread m_worker;
+
+                int m_lastError;
+            };
+        } // namespace Io
+    }     // namespace Crt
+} // namespace Aws
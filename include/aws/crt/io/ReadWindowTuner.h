@@ -0,0 +1,115 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/Exports.h>
+#include <aws/crt/Types.h>
+
+#include <mutex>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Io
+        {
+            /**
+             * Bounds and starting point of a ReadWindowTuner.
+             */
+            struct AWS_CRT_CPP_API ReadWindowTunerOptions
+            {
+                /**
+                 * The window a connection starts out with.
+                 */
+                size_t InitialWindowSize = 64 * 1024;
+
+                /**
+                 * The window never shrinks below this, so a consumer that pauses is not starved once it resumes.
+                 */
+                size_t MinWindowSize = 16 * 1024;
+
+                /**
+                 * The memory budget of the connection: the window never grows beyond this, so at most this many
+                 * received bytes can be waiting on the consumer.
+                 */
+                size_t MaxWindowSize = 16 * 1024 * 1024;
+
+                /**
+                 * Round trip time assumed until one has been measured or set, in nanoseconds.
+                 */
+                uint64_t DefaultRoundTripTimeNs = 100 * 1000 * 1000;
+            };
+
+            /***
+             * Sizes a read window from how fast its data is consumed, like TCP receive buffer autotuning. Instead
+             * of handing every consumed byte straight back to the window, the consumer reports it to the tuner,
+             * which returns the increment to issue: more than was consumed while the window grows, less while it
+             * shrinks.
+             *
+             * Once every round trip the tuner looks at how much was consumed in it and aims the window at twice
+             * that, within the options' bounds. A consumer that keeps up with a window-limited sender consumes a
+             * full window per round trip, so the window doubles until the link or the budget is the limit; a
+             * consumer that falls behind lets it shrink, a quarter of the way to its target each round trip. The
+             * round trip time is measured as the time it takes a window's worth of data to arrive, unless a better
+             * estimate is set.
+             *
+             * Safe to use from any thread.
+             */
+            class AWS_CRT_CPP_API ReadWindowTuner final
+            {
+              public:
+                explicit ReadWindowTuner(const ReadWindowTunerOptions &options = ReadWindowTunerOptions()) noexcept;
+
+                /**
+                 * @return the window the tuner is aiming at, which is also where it starts.
+                 */
+                size_t GetWindowSize() const noexcept;
+
+                /**
+                 * @return the current round trip estimate in nanoseconds.
+                 */
+                uint64_t GetRoundTripTimeNs() const noexcept;
+
+                /**
+                 * Sets the round trip estimate, e.g. from a request's time to first byte. Measured samples keep
+                 * refining it.
+                 */
+                void SetRoundTripTimeNs(uint64_t roundTripTimeNs) noexcept;
+
+                /**
+                 * Reports bytes that arrived through the window, to measure the round trip.
+                 */
+                void OnBytesReceived(size_t bytes) noexcept;
+                void OnBytesReceived(size_t bytes, uint64_t nowNs) noexcept;
+
+                /**
+                 * Reports bytes the consumer is done with.
+                 * @return how much to increment the window by, possibly zero.
+                 */
+                size_t OnBytesConsumed(size_t bytes) noexcept;
+                size_t OnBytesConsumed(size_t bytes, uint64_t nowNs) noexcept;
+
+              private:
+                void Retune(uint64_t nowNs) noexcept;
+
+                mutable std::mutex m_lock;
+                ReadWindowTunerOptions m_options;
+                size_t m_windowSize;
+                uint64_t m_roundTripTimeNs;
+                bool m_hasRoundTripTime;
+
+                /* bytes received since m_sampleStartNs, a sample completes once a window's worth arrived */
+                uint64_t m_sampleStartNs;
+                uint64_t m_sampleBytes;
+
+                /* bytes consumed since m_epochStartNs, the window is retuned once an epoch lasted a round trip */
+                uint64_t m_epochStartNs;
+                uint64_t m_epochBytes;
+
+                /* what a shrink took off the window and has not yet been held back from increments */
+                size_t m_shrinkDebt;
+            };
+        } // namespace Io
+    }     // namespace Crt
+} // namespace Aws
@@ -8,6 +8,10 @@
 
 #include <aws/io/socket.h>
 
+#include <cstdint>
+
+struct aws_channel;
+
 namespace Aws
 {
     namespace Crt
@@ -104,6 +108,55 @@ namespace Aws
                  */
                 void SetKeepAlive(bool keepAlive) { options.keepalive = keepAlive; }
                 bool GetKeepAlive() const { return options.keepalive; }
+                /**
+                 * Set the kernel receive buffer size (SO_RCVBUF).
+                 *
+                 * The option is only applied once the socket is connected (see ApplyTuning()), after the TCP window
+                 * scale has been negotiated from the system limits, so it cannot raise the receive window past what
+                 * that scale allows. On Linux it also turns off receive buffer autotuning for the socket. To let a
+                 * single connection fill a link with a high bandwidth-delay product, raise the system limits
+                 * (e.g. net.ipv4.tcp_rmem) instead.
+                 * @param receiveBufferSize: size in bytes. If 0, the system default is kept.
+                 */
+                void SetReceiveBufferSize(uint32_t receiveBufferSize) { m_receiveBufferSize = receiveBufferSize; }
+                uint32_t GetReceiveBufferSize() const { return m_receiveBufferSize; }
+                /**
+                 * Set the kernel send buffer size (SO_SNDBUF).
+                 * @param sendBufferSize: size in bytes. If 0, the system default is kept.
+                 */
+                void SetSendBufferSize(uint32_t sendBufferSize) { m_sendBufferSize = sendBufferSize; }
+                uint32_t GetSendBufferSize() const { return m_sendBufferSize; }
+                /**
+                 * Set TCP_NODELAY.
+                 * @param noDelay: True, disable Nagle's algorithm so small writes, such as requests of small RPCs,
+                 * are sent at once instead of waiting for the previous segment to be acknowledged.
+                 */
+                void SetTcpNoDelay(bool noDelay) { m_tcpNoDelay = noDelay; }
+                bool GetTcpNoDelay() const { return m_tcpNoDelay; }
+                /**
+                 * Set SO_BUSY_POLL, Linux only; ignored elsewhere.
+                 * @param busyPollUs: how long, in microseconds, a read busy-polls the device queue for data
+                 * instead of sleeping on an interrupt, trading CPU for latency. If 0, busy polling is left off.
+                 */
+                void SetBusyPollUs(uint32_t busyPollUs) { m_busyPollUs = busyPollUs; }
+                uint32_t GetBusyPollUs() const { return m_busyPollUs; }
+                /**
+                 * @return whether any of the buffer size, TCP_NODELAY or busy-poll settings is set. Those are not
+                 * part of aws_socket_options, so they only reach the socket through ApplyTuning().
+                 */
+                bool HasTuning() const
+                {
+                    return m_receiveBufferSize != 0 || m_sendBufferSize != 0 || m_tcpNoDelay || m_busyPollUs != 0;
+                }
+                /**
+                 * Applies the buffer size, TCP_NODELAY and busy-poll settings to the socket of a channel set up by a
+                 * ClientBootstrap, whose first handler is the socket's. HTTP connections do this on their own, once
+                 * per connection. The socket is already connected by then, see SetReceiveBufferSize().
+                 *
+                 * @return true if every setting was applied (or there was nothing to apply), false otherwise, with
+                 * the error raised. Settings before the failed one stay applied.
+                 */
+                bool ApplyTuning(struct aws_channel *channel) const;
                 /// @private
                 aws_socket_options &GetImpl() { return options; }
                 /// @private
@@ -111,6 +164,10 @@ namespace Aws
 
               private:
                 aws_socket_options options;
+                uint32_t m_receiveBufferSize;
+                uint32_t m_sendBufferSize;
+                bool m_tcpNoDelay;
+                uint32_t m_busyPollUs;
             };
         } // namespace Io
     }     // namespace Crt
@@ -95,6 +95,20 @@ namespace Aws
                  */
                 virtual bool SeekImpl(OffsetType offset, StreamSeekBasis seekBasis) noexcept = 0;
 
+                /**
+                 * Helper for streams of a known length that follow the seek rules of aws-c-io's own streams: Begin
+                 * counts forward from the start, End counts backwards (offset <= 0) from the end, and neither may
+                 * leave the stream. On success, stores the resulting position in outPosition.
+                 *
+                 * @return true on success, false after raising AWS_IO_STREAM_INVALID_SEEK_POSITION (or
+                 * AWS_ERROR_INVALID_ARGUMENT for an unknown basis) otherwise.
+                 */
+                static bool ResolveSeekPosition(
+                    OffsetType offset,
+                    StreamSeekBasis seekBasis,
+                    int64_t length,
+                    int64_t &outPosition) noexcept;
+
               private:
                 static int s_Seek(aws_input_stream *stream, aws_off_t offset, enum aws_stream_seek_basis basis);
                 static int s_Read(aws_input_stream *stream, aws_byte_buf *dest);
@@ -126,6 +140,263 @@ namespace Aws
               private:
                 std::shared_ptr<Aws::Crt::Io::IStream> m_stream;
             };
+
+            /***
+             * Implementation of Aws::Crt::Io::InputStream that reads straight out of a span of memory, copying
+             * each byte once, into the destination buffer. Seeking and getting the length are O(1).
+             */
+            class AWS_CRT_CPP_API ByteCursorInputStream : public InputStream
+            {
+              public:
+                /**
+                 * Reads from data, which is not copied and must outlive the stream.
+                 */
+                ByteCursorInputStream(const ByteCursor &data, Aws::Crt::Allocator *allocator = g_allocator) noexcept;
+
+                /**
+                 * Reads from data, which owner keeps alive for as long as the stream holds on to it. For example,
+                 * pass a std::shared_ptr<String> as owner and a cursor over the string as data.
+                 */
+                ByteCursorInputStream(
+                    std::shared_ptr<const void> owner,
+                    const ByteCursor &data,
+                    Aws::Crt::Allocator *allocator = g_allocator) noexcept;
+
+                bool IsValid() const noexcept override;
+
+              protected:
+                bool ReadImpl(ByteBuf &buffer) noexcept override;
+                StreamStatus GetStatusImpl() const noexcept override;
+                int64_t GetLengthImpl() const noexcept override;
+                bool SeekImpl(OffsetType offset, StreamSeekBasis seekBasis) noexcept override;
+
+              private:
+                std::shared_ptr<const void> m_owner;
+                ByteCursor m_data;
+                int64_t m_position;
+            };
+
+            /***
+             * Input stream that concatenates a list of segments, each either a child InputStream or a span of
+             * memory, so that a body made of e.g. a header blob, a large file and a trailer can be streamed without
+             * first copying it into one buffer.
+             *
+             * The length is the sum of the segments' lengths, each taken when the segment is added, or -1 if any
+             * child could not report its length. Seeking requires every length to be known, except for seeking back
+             * to the beginning, which rewinds every child that was read.
+             */
+            class AWS_CRT_CPP_API ChainedInputStream : public InputStream
+            {
+              public:
+                explicit ChainedInputStream(Aws::Crt::Allocator *allocator = g_allocator) noexcept;
+
+                /**
+                 * Appends a span of memory. The bytes are not copied and must outlive the stream.
+                 */
+                void AddSegment(const ByteCursor &bytes) noexcept;
+
+                /**
+                 * Appends a child stream, which is read from its current position the first time through.
+                 */
+                void AddSegment(const std::shared_ptr<InputStream> &stream) noexcept;
+
+                /**
+                 * @return the number of segments added.
+                 */
+                size_t GetSegmentCount() const noexcept { return m_segments.size(); }
+
+                bool IsValid() const noexcept override;
+
+              protected:
+                bool ReadImpl(ByteBuf &buffer) noexcept override;
+                StreamStatus GetStatusImpl() const noexcept override;
+                int64_t GetLengthImpl() const noexcept override;
+                bool SeekImpl(OffsetType offset, StreamSeekBasis seekBasis) noexcept override;
+
+              private:
+                struct Segment
+                {
+                    ByteCursor bytes;
+                    std::shared_ptr<InputStream> stream;
+                    int64_t length;
+                    /* set once the child has been read from, so a later rewind knows to seek it back */
+                    bool rewindBeforeRead;
+                };
+
+                bool EnterSegment(size_t index, int64_t segmentOffset) noexcept;
+
+                Vector<Segment> m_segments;
+                size_t m_currentSegment;
+                size_t m_bytesOffset;
+                bool m_readFailed;
+            };
+
+            /***
+             * A source of bytes that can be read at any offset, from several threads at once. RangeInputStream uses
+             * it to let many streams read slices of one source in parallel.
+             */
+            class AWS_CRT_CPP_API PositionalInputSource
+            {
+              public:
+                virtual ~PositionalInputSource() = default;
+
+                /**
+                 * Reads up to buffer::capacity - buffer::len bytes starting at offset into buffer::buffer, and
+                 * increments buffer::len by the amount read. Reading at or past the end of the source reads nothing.
+                 *
+                 * @return true on success, false after raising an error otherwise.
+                 */
+                virtual bool ReadAt(int64_t offset, ByteBuf &buffer) const noexcept = 0;
+
+                /**
+                 * @return the total length of the source.
+                 */
+                virtual int64_t GetSourceLength() const noexcept = 0;
+            };
+
+            /***
+             * Implementation of Aws::Crt::Io::InputStream that reads a file with positioned reads (pread() on posix,
+             * ReadFile() with an offset on windows) straight into the destination buffer. Seeking only moves an
+             * offset, and the length is taken once when the file is opened, so both are O(1).
+             *
+             * Positioned reads do not move a shared file offset, so the stream is also a PositionalInputSource
+             * that many RangeInputStreams can read at once.
+             *
+             * The file must not shrink while the stream is in use; reading past its new end fails the read.
+             */
+            class AWS_CRT_CPP_API FileInputStream : public InputStream, public PositionalInputSource
+            {
+              public:
+                FileInputStream(const char *filePath, Aws::Crt::Allocator *allocator = g_allocator) noexcept;
+                ~FileInputStream();
+
+                bool IsValid() const noexcept override;
+
+                bool ReadAt(int64_t offset, ByteBuf &buffer) const noexcept override;
+                int64_t GetSourceLength() const noexcept override;
+
+                /**
+                 * @return the error raised while opening the file, if IsValid() is false.
+                 */
+                int LastError() const noexcept { return m_lastError; }
+
+              protected:
+                bool ReadImpl(ByteBuf &buffer) noexcept override;
+                StreamStatus GetStatusImpl() const noexcept override;
+                int64_t GetLengthImpl() const noexcept override;
+                bool SeekImpl(OffsetType offset, StreamSeekBasis seekBasis) noexcept override;
+
+              private:
+#ifdef _WIN32
+                void *m_file;
+#else
+                int m_file;
+#endif
+                int64_t m_length;
+                int64_t m_position;
+                bool m_readFailed;
+                int m_lastError;
+            };
+
+            /***
+             * Implementation of Aws::Crt::Io::InputStream that maps a file into memory and serves reads from the
+             * mapping, leaving paging to the OS. Seeking and getting the length are O(1), and GetContents() gives
+             * direct access to the mapped bytes. It is also a PositionalInputSource.
+             *
+             * The file must not be truncated while it is mapped; touching pages past the new end of the file is
+             * fatal on most platforms.
+             */
+            class AWS_CRT_CPP_API MmapFileInputStream : public InputStream, public PositionalInputSource
+            {
+              public:
+                MmapFileInputStream(const char *filePath, Aws::Crt::Allocator *allocator = g_allocator) noexcept;
+                ~MmapFileInputStream();
+
+                bool IsValid() const noexcept override;
+
+                bool ReadAt(int64_t offset, ByteBuf &buffer) const noexcept override;
+                int64_t GetSourceLength() const noexcept override;
+
+                /**
+                 * @return the error raised while mapping the file, if IsValid() is false.
+                 */
+                int LastError() const noexcept { return m_lastError; }
+
+                /**
+                 * @return the whole mapped file. Valid for the lifetime of the stream.
+                 */
+                ByteCursor GetContents() const noexcept;
+
+              protected:
+                bool ReadImpl(ByteBuf &buffer) noexcept override;
+                StreamStatus GetStatusImpl() const noexcept override;
+                int64_t GetLengthImpl() const noexcept override;
+                bool SeekImpl(OffsetType offset, StreamSeekBasis seekBasis) noexcept override;
+
+              private:
+                const uint8_t *m_data;
+                int64_t m_length;
+                int64_t m_position;
+                bool m_valid;
+                int m_lastError;
+            };
+
+            /***
+             * Input stream over the slice [offset, offset + length) of a shared PositionalInputSource. Each range
+             * keeps its own position, so it seeks independently, and starts back at its first byte when an upload is
+             * retried. Splitting a file into RangeInputStreams lets the parts of a multipart upload go out on parallel
+             * HttpClientStreams, sharing one open file and without copying it.
+             */
+            class AWS_CRT_CPP_API RangeInputStream : public InputStream
+            {
+              public:
+                /**
+                 * The range must lie within the source, otherwise the stream is invalid and LastError() is
+                 * AWS_ERROR_INVALID_ARGUMENT.
+                 */
+                RangeInputStream(
+                    const std::shared_ptr<PositionalInputSource> &source,
+                    int64_t offset,
+                    int64_t length,
+                    Aws::Crt::Allocator *allocator = g_allocator) noexcept;
+
+                /**
+                 * Cuts source into consecutive ranges of partSize bytes each (the last may be shorter), appending
+                 * them to outParts. An empty source gives a single empty range. Returns false, raising an error, if
+                 * partSize is not positive or a part cannot be allocated.
+                 */
+                static bool Split(
+                    const std::shared_ptr<PositionalInputSource> &source,
+                    int64_t partSize,
+                    Vector<std::shared_ptr<RangeInputStream>> &outParts,
+                    Aws::Crt::Allocator *allocator = g_allocator) noexcept;
+
+                bool IsValid() const noexcept override;
+
+                /**
+                 * @return AWS_ERROR_INVALID_ARGUMENT if the range did not fit the source.
+                 */
+                int LastError() const noexcept { return m_lastError; }
+
+                /**
+                 * @return where the range starts in the source.
+                 */
+                int64_t GetOffset() const noexcept { return m_offset; }
+
+              protected:
+                bool ReadImpl(ByteBuf &buffer) noexcept override;
+                StreamStatus GetStatusImpl() const noexcept override;
+                int64_t GetLengthImpl() const noexcept override;
+                bool SeekImpl(OffsetType offset, StreamSeekBasis seekBasis) noexcept override;
+
+              private:
+                std::shared_ptr<PositionalInputSource> m_source;
+                int64_t m_offset;
+                int64_t m_length;
+                int64_t m_position;
+                bool m_readFailed;
+                int m_lastError;
+            };
         } // namespace Io
     }     // namespace Crt
 } // namespace Aws
@@ -0,0 +1,98 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/io/Stream.h>
+
+#include <mutex>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Io
+        {
+            /***
+             * Token bucket that caps a byte rate. Tokens, one per byte, accumulate at bytesPerSecond up to
+             * burstBytes; spending is non-blocking and simply gets fewer tokens, possibly none, when the bucket
+             * runs dry. Share one bucket between streams (through a std::shared_ptr) to cap their combined rate,
+             * e.g. every upload of a process or of a connection manager. Safe to use from any thread.
+             */
+            class AWS_CRT_CPP_API TokenBucket final
+            {
+              public:
+                /**
+                 * burstBytes is the most that can be spent at once after the bucket has been idle. Zero picks 100ms
+                 * worth of bytesPerSecond. The bucket starts out full.
+                 */
+                explicit TokenBucket(uint64_t bytesPerSecond, uint64_t burstBytes = 0) noexcept;
+
+                /**
+                 * Takes up to requested tokens.
+                 * @return the number of tokens taken, zero if the bucket is empty.
+                 */
+                size_t TryAcquire(size_t requested) noexcept;
+
+                /**
+                 * Puts back tokens that were acquired but not spent, e.g. by a read that came up short.
+                 */
+                void Release(size_t unused) noexcept;
+
+                /**
+                 * @return how long, in nanoseconds, until min(bytes, burst) tokens are available. Zero if they are
+                 * available now.
+                 */
+                uint64_t GetDelayNs(size_t bytes) noexcept;
+
+                /**
+                 * Changes the rate, and burst (see the constructor), for everything sharing the bucket.
+                 */
+                void SetRate(uint64_t bytesPerSecond, uint64_t burstBytes = 0) noexcept;
+
+                /**
+                 * @return the rate in bytes per second.
+                 */
+                uint64_t GetRate() const noexcept;
+
+              private:
+                void Refill() noexcept;
+
+                mutable std::mutex m_lock;
+                double m_bytesPerSecond;
+                double m_burstBytes;
+                double m_tokens;
+                uint64_t m_lastRefillNs;
+            };
+
+            /***
+             * InputStream decorator that paces another stream, e.g. an upload body, to the rate of a TokenBucket.
+             *
+             * Reads never wait for tokens. A read is cut down to the tokens available and, when there are none,
+             * succeeds without any data while the stream reports neither the end nor an error. The HTTP connection
+             * then carries on with its other streams and polls this one again on a later tick, so throttling an
+             * upload blocks neither a thread nor the event loop.
+             */
+            class AWS_CRT_CPP_API ThrottledInputStream final : public InputStream
+            {
+              public:
+                ThrottledInputStream(
+                    const std::shared_ptr<InputStream> &source,
+                    const std::shared_ptr<TokenBucket> &bucket,
+                    Aws::Crt::Allocator *allocator = g_allocator) noexcept;
+
+                bool IsValid() const noexcept override;
+
+              protected:
+                bool ReadImpl(ByteBuf &buffer) noexcept override;
+                StreamStatus GetStatusImpl() const noexcept override;
+                int64_t GetLengthImpl() const noexcept override;
+                bool SeekImpl(OffsetType offset, StreamSeekBasis seekBasis) noexcept override;
+
+              private:
+                std::shared_ptr<InputStream> m_source;
+                std::shared_ptr<TokenBucket> m_bucket;
+            };
+        } // namespace Io
+    }     // namespace Crt
+} // namespace Aws
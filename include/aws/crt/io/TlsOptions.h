@@ -6,6 +6,7 @@
 
 #include <aws/crt/Types.h>
 #include <aws/crt/io/ChannelHandler.h>
+#include <aws/crt/io/TlsSessionCache.h>
 #include <aws/io/tls_channel_handler.h>
 
 #include <functional>
@@ -154,11 +155,29 @@ namespace Aws
                  */
                 bool OverrideDefaultTrustStore(const ByteCursor &ca) noexcept;
 
+                /**
+                 * BYO_CRYPTO: Sets the cache TLS sessions are kept in for resumption by connections made from the
+                 * TlsContext created with these options. The same cache may be given to several contexts.
+                 *
+                 * The cache is filled and consulted by the TLS implementation: the context impl gets it from
+                 * GetSessionCache() of the options it is created with, and its client handlers Store() the session
+                 * of each negotiated connection and Retrieve() one to offer before starting the next. The built-in
+                 * TLS implementations offer no way to hand them a session, so without BYO_CRYPTO this has no effect
+                 * and GetSessionCache() stays nullptr.
+                 */
+                void SetSessionCache(const std::shared_ptr<TlsSessionCache> &sessionCache) noexcept;
+
+                /**
+                 * @return the session cache set with SetSessionCache(), or nullptr.
+                 */
+                const std::shared_ptr<TlsSessionCache> &GetSessionCache() const noexcept { return m_sessionCache; }
+
                 /// @private
                 const aws_tls_ctx_options *GetUnderlyingHandle() const noexcept { return &m_options; }
 
               private:
                 aws_tls_ctx_options m_options;
+                std::shared_ptr<TlsSessionCache> m_sessionCache;
                 bool m_isInit;
             };
 
@@ -226,6 +245,28 @@ namespace Aws
                 TlsContext(TlsContext &&) noexcept = default;
                 TlsContext &operator=(TlsContext &&) noexcept = default;
 
+                /**
+                 * Returns a context for options and mode, shared with every other caller that asked for an
+                 * identical one while it is still in use. Contexts are identical when their options carry the same
+                 * trust store, certificate and private key, ALPN list, minimum TLS version, cipher preference,
+                 * peer verification, session cache and allocator. A context is built, and its certificates and keys
+                 * parsed, only when no live one matches; the cache only holds weak references, so a context is
+                 * still freed when the last copy of it goes away.
+                 *
+                 * A context that fails to build is returned as is and not cached. The cache is keyed by a SHA256 of
+                 * the options and keeps no copy of their secrets; where no SHA256 is available, nothing is cached.
+                 */
+                static TlsContext GetOrCreate(
+                    TlsContextOptions &options,
+                    TlsMode mode,
+                    Allocator *allocator = g_allocator) noexcept;
+
+                /**
+                 * Forgets every context GetOrCreate() has handed out, so later calls build new ones. Contexts
+                 * already handed out stay valid.
+                 */
+                static void ClearCache() noexcept;
+
                 TlsConnectionOptions NewConnectionOptions() const noexcept;
                 /**
                  * @return true if the instance is in a valid state, false otherwise.
@@ -236,12 +277,19 @@ namespace Aws
                  */
                 int GetInitializationError() const noexcept { return m_initializationError; }
 
+                /**
+                 * @return the session cache of the options this context was created with, shared with its copies,
+                 * or nullptr if they did not set one.
+                 */
+                const std::shared_ptr<TlsSessionCache> &GetSessionCache() const noexcept { return m_sessionCache; }
+
                 aws_tls_ctx *GetUnderlyingHandle() noexcept { return m_ctx.get(); }
 
               private:
                 bool isValid() const noexcept { return m_ctx && m_initializationError == AWS_ERROR_SUCCESS; }
 
                 std::shared_ptr<aws_tls_ctx> m_ctx;
+                std::shared_ptr<TlsSessionCache> m_sessionCache;
                 int m_initializationError;
             };
 
@@ -0,0 +1,108 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/Types.h>
+
+#include <chrono>
+#include <mutex>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Io
+        {
+            struct AWS_CRT_CPP_API TlsSessionCacheOptions
+            {
+                /**
+                 * Most sessions kept. Storing one more evicts the least recently used.
+                 */
+                size_t MaxEntries = 256;
+
+                /**
+                 * Longest a session is offered for resumption after it was stored. A shorter lifetime hint given
+                 * with the session wins over it.
+                 */
+                std::chrono::seconds SessionLifetime = std::chrono::hours(1);
+            };
+
+            struct AWS_CRT_CPP_API TlsSessionCacheStatistics
+            {
+                uint64_t Stores = 0;
+                uint64_t Hits = 0;
+                uint64_t Misses = 0;
+                uint64_t Evictions = 0;
+            };
+
+            /**
+             * BYO_CRYPTO: Keeps the serialized TLS session (a session ticket or session ID with its state) last
+             * negotiated with each server, so that a TLS implementation supplied with BYO_CRYPTO can offer it on the
+             * next connection to that server and complete an abbreviated handshake instead of a full one.
+             *
+             * A cache is attached to a TlsContext through TlsContextOptions::SetSessionCache() and shared by every
+             * connection made from that context, and by any other context given the same cache. Sessions are keyed
+             * by the server name of the connection. Thread safe.
+             *
+             * The cache does nothing by itself: it is only filled and consulted by ClientTlsChannelHandler
+             * implementations. The built-in TLS implementations manage resumption on their own, if at all, and
+             * never use it.
+             */
+            class AWS_CRT_CPP_API TlsSessionCache final
+            {
+              public:
+                explicit TlsSessionCache(const TlsSessionCacheOptions &options = TlsSessionCacheOptions()) noexcept;
+
+                TlsSessionCache(const TlsSessionCache &) = delete;
+                TlsSessionCache &operator=(const TlsSessionCache &) = delete;
+
+                /**
+                 * Stores a copy of session for serverName, replacing the one stored before.
+                 * @param lifetimeHint: lifetime the server gave the session, zero for none.
+                 */
+                void Store(
+                    const String &serverName,
+                    const ByteCursor &session,
+                    std::chrono::seconds lifetimeHint = std::chrono::seconds(0)) noexcept;
+
+                /**
+                 * Appends the session stored for serverName to session, growing it as needed.
+                 * @return true if an unexpired session was found, false otherwise.
+                 */
+                bool Retrieve(const String &serverName, ByteBuf &session) noexcept;
+
+                /**
+                 * Drops the session stored for serverName, for when the server refused to resume it.
+                 */
+                void Remove(const String &serverName) noexcept;
+
+                /**
+                 * Drops every stored session.
+                 */
+                void Clear() noexcept;
+
+                size_t GetSize() const noexcept;
+
+                TlsSessionCacheStatistics GetStatistics() const noexcept;
+
+              private:
+                struct Entry
+                {
+                    String serverName;
+                    Vector<uint8_t> session;
+                    std::chrono::steady_clock::time_point expiresAt;
+                };
+
+                void Erase(List<Entry>::iterator entry) noexcept;
+
+                TlsSessionCacheOptions m_options;
+                mutable std::mutex m_lock;
+                /* most recently used first */
+                List<Entry> m_entries;
+                Map<String, List<Entry>::iterator> m_index;
+                TlsSessionCacheStatistics m_statistics;
+            };
+        } // namespace Io
+    }     // namespace Crt
+} // namespace Aws
@@ -0,0 +1,156 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/mqtt/MqttClient.h>
+
+#include <condition_variable>
+#include <mutex>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Mqtt
+        {
+            /**
+             * What keeps messages in order when they are handed off to a MessageWorkerPool.
+             */
+            enum class MessageOrdering
+            {
+                /**
+                 * Messages on the same topic are handled one at a time, in the order they arrived.
+                 */
+                PerTopic,
+                /**
+                 * Messages delivered to the same wrapped handler are handled one at a time, in the order they
+                 * arrived.
+                 */
+                PerHandler,
+            };
+
+            /**
+             * What a MessageWorkerPool does with a message that arrives while its queue is full.
+             */
+            enum class MessageOverflowPolicy
+            {
+                /**
+                 * The message is dropped and counted in MessageWorkerPoolMetrics::Dropped.
+                 */
+                Drop,
+                /**
+                 * The event-loop thread waits for room. Reads on the connection, and on every other connection
+                 * sharing its event loop, stop meanwhile, which pushes back on the broker through TCP.
+                 */
+                Block,
+            };
+
+            struct AWS_CRT_CPP_API MessageWorkerPoolOptions
+            {
+                /**
+                 * Number of worker threads. Zero picks the number of cores.
+                 */
+                size_t ThreadCount = 0;
+                /**
+                 * Most messages queued but not handled yet, across all workers.
+                 */
+                size_t MaxQueuedMessages = 10000;
+                MessageOrdering Ordering = MessageOrdering::PerTopic;
+                MessageOverflowPolicy OverflowPolicy = MessageOverflowPolicy::Drop;
+            };
+
+            /**
+             * A snapshot of what a MessageWorkerPool has been through.
+             */
+            struct AWS_CRT_CPP_API MessageWorkerPoolMetrics
+            {
+                uint64_t Enqueued = 0;
+                uint64_t Handled = 0;
+                uint64_t Dropped = 0;
+                /**
+                 * Times the event-loop thread had to wait for room (MessageOverflowPolicy::Block).
+                 */
+                uint64_t Blocked = 0;
+                size_t QueuedMessages = 0;
+                size_t PeakQueuedMessages = 0;
+                /**
+                 * Total time handled messages spent queued, in nanoseconds.
+                 */
+                uint64_t TotalQueueDelayNs = 0;
+            };
+
+            struct MessageWorker;
+            struct MessageWorkerHandler;
+
+            /**
+             * Runs MQTT message handlers on a pool of worker threads instead of the connection's event-loop thread,
+             * so a slow handler does not hold up socket reads and keep-alives for every connection on that loop.
+             *
+             * Wrap() turns a handler into one that can be passed to MqttConnection::Subscribe() or
+             * SetOnMessageHandler(). Each message is copied and queued to the worker its ordering key (see
+             * MessageOrdering) hashes to, so messages sharing a key are handled in order while the others spread
+             * across the pool. The connection passed to the handler must outlive the pool's queued messages.
+             */
+            class AWS_CRT_CPP_API MessageWorkerPool final
+            {
+              public:
+                explicit MessageWorkerPool(
+                    const MessageWorkerPoolOptions &options = MessageWorkerPoolOptions(),
+                    Allocator *allocator = g_allocator) noexcept;
+
+                /**
+                 * Handles everything still queued, then stops the workers.
+                 */
+                ~MessageWorkerPool();
+                MessageWorkerPool(const MessageWorkerPool &) = delete;
+                MessageWorkerPool(MessageWorkerPool &&) = delete;
+                MessageWorkerPool &operator=(const MessageWorkerPool &) = delete;
+                MessageWorkerPool &operator=(MessageWorkerPool &&) = delete;
+
+                /**
+                 * @return false if the worker threads could not be started.
+                 */
+                explicit operator bool() const noexcept { return !m_workers.empty(); }
+
+                /**
+                 * @return a handler that queues each message it receives to the pool, where handler is invoked with
+                 * it. The returned handler refers to the pool, which must outlive it.
+                 */
+                OnMessageReceivedViewHandler Wrap(OnMessageReceivedHandler &&handler) noexcept;
+
+                /**
+                 * @return the pool's counters and queue depth so far.
+                 */
+                MessageWorkerPoolMetrics GetMetrics() const noexcept;
+
+                /**
+                 * Blocks until every message queued so far has been handled.
+                 */
+                void Drain() noexcept;
+
+              private:
+                void Enqueue(
+                    const std::shared_ptr<MessageWorkerHandler> &handler,
+                    MqttConnection &connection,
+                    StringView topic,
+                    const ByteCursor &payload,
+                    bool dup,
+                    QOS qos,
+                    bool retain) noexcept;
+                void RunWorker(MessageWorker &worker) noexcept;
+
+                Allocator *m_allocator;
+                MessageWorkerPoolOptions m_options;
+                Vector<MessageWorker *> m_workers;
+                std::atomic<uint64_t> m_nextHandlerId;
+
+                mutable std::mutex m_lock;
+                std::condition_variable m_spaceAvailable;
+                std::condition_variable m_drained;
+                MessageWorkerPoolMetrics m_metrics;
+                bool m_shuttingDown;
+            };
+        } // namespace Mqtt
+    }     // namespace Crt
+} // namespace Aws
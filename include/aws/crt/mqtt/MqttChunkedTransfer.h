@@ -0,0 +1,172 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/mqtt/MqttClient.h>
+
+#include <mutex>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Mqtt
+        {
+            /**
+             * Bytes each chunk of a chunked transfer spends on its header: a magic byte, a version byte, two
+             * reserved bytes, then the transfer id, the total payload length, the chunk size and the chunk index,
+             * all big-endian 32-bit.
+             */
+            static const size_t MQTT_CHUNK_HEADER_LENGTH = 20;
+
+            /**
+             * Invoked once every chunk of a transfer has been published, with the first error any of them hit.
+             */
+            using OnChunkedPublishCompleteHandler = Function<void(MqttConnection &connection, int errorCode)>;
+
+            /**
+             * Publishes payloads of any size, up to 4GB, as a sequence of chunks that each fit in an MQTT packet,
+             * to be put back together by an MqttChunkReassembler subscribed to the topic.
+             *
+             * All the chunks of a payload are laid out in a single buffer, headers included, and published straight
+             * from it.
+             */
+            class AWS_CRT_CPP_API MqttChunkedPublisher final
+            {
+              public:
+                /**
+                 * Payload bytes per chunk when none is given; with the header this stays well under the 256KB
+                 * packet limit most brokers enforce.
+                 */
+                static const size_t DefaultMaxChunkPayload = 128 * 1024;
+
+                MqttChunkedPublisher(
+                    const std::shared_ptr<MqttConnection> &connection,
+                    size_t maxChunkPayload = DefaultMaxChunkPayload,
+                    Allocator *allocator = g_allocator) noexcept;
+
+                MqttChunkedPublisher(const MqttChunkedPublisher &) = delete;
+                MqttChunkedPublisher(MqttChunkedPublisher &&) = delete;
+                MqttChunkedPublisher &operator=(const MqttChunkedPublisher &) = delete;
+                MqttChunkedPublisher &operator=(MqttChunkedPublisher &&) = delete;
+
+                /**
+                 * Publishes a copy of payload to topic, in chunks. Chunks are never retained, since only the last
+                 * one would be.
+                 * @return false if no chunk could be published, in which case onComplete is not invoked.
+                 */
+                bool Publish(
+                    const char *topic,
+                    QOS qos,
+                    const ByteCursor &payload,
+                    OnChunkedPublishCompleteHandler &&onComplete = nullptr) noexcept;
+
+                /**
+                 * @return how many chunks a payload of payloadLength bytes is split into.
+                 */
+                size_t GetChunkCount(size_t payloadLength) const noexcept;
+
+              private:
+                Allocator *m_allocator;
+                std::shared_ptr<MqttConnection> m_connection;
+                size_t m_maxChunkPayload;
+                std::atomic<uint32_t> m_nextTransferId;
+            };
+
+            /**
+             * Invoked with each payload an MqttChunkReassembler has put back together. payload is only valid for the
+             * duration of the call.
+             */
+            using OnChunkedMessageReceivedHandler =
+                Function<void(MqttConnection &connection, StringView topic, const ByteCursor &payload)>;
+
+            /**
+             * A snapshot of an MqttChunkReassembler's counters.
+             */
+            struct AWS_CRT_CPP_API MqttChunkReassemblerMetrics
+            {
+                size_t PendingTransfers = 0;
+                size_t PendingBytes = 0;
+                uint64_t CompletedTransfers = 0;
+                /**
+                 * Chunks that were malformed or announced a payload over the limit.
+                 */
+                uint64_t RejectedChunks = 0;
+                uint64_t DuplicateChunks = 0;
+                /**
+                 * Incomplete transfers dropped to make room for newer ones.
+                 */
+                uint64_t EvictedTransfers = 0;
+            };
+
+            struct ChunkedTransfer;
+
+            /**
+             * Puts payloads published by an MqttChunkedPublisher back together. Hand GetOnMessageHandler() to
+             * MqttConnection::Subscribe() for the topic, and keep the reassembler alive for as long as the
+             * subscription.
+             *
+             * The buffer of each transfer is allocated once, at the full payload length announced by its first
+             * chunk, and chunks are copied straight into place, whatever order they arrive in. A payload that fits
+             * in a single chunk is delivered straight from the message, without copying.
+             */
+            class AWS_CRT_CPP_API MqttChunkReassembler final
+            {
+              public:
+                /**
+                 * @param maxPayloadLength transfers announcing more are rejected.
+                 * @param maxPendingTransfers once this many transfers are incomplete, the one that has gone longest
+                 * without a chunk is dropped to make room for a new one.
+                 */
+                MqttChunkReassembler(
+                    OnChunkedMessageReceivedHandler &&onMessage,
+                    size_t maxPayloadLength = 64 * 1024 * 1024,
+                    size_t maxPendingTransfers = 16,
+                    Allocator *allocator = g_allocator) noexcept;
+
+                ~MqttChunkReassembler();
+                MqttChunkReassembler(const MqttChunkReassembler &) = delete;
+                MqttChunkReassembler(MqttChunkReassembler &&) = delete;
+                MqttChunkReassembler &operator=(const MqttChunkReassembler &) = delete;
+                MqttChunkReassembler &operator=(MqttChunkReassembler &&) = delete;
+
+                /**
+                 * @return a message handler that feeds the reassembler.
+                 */
+                OnMessageReceivedViewHandler GetOnMessageHandler() noexcept;
+
+                /**
+                 * Feeds one chunk received on topic.
+                 * @return false if the chunk was rejected.
+                 */
+                bool OnChunk(MqttConnection &connection, StringView topic, const ByteCursor &chunk) noexcept;
+
+                MqttChunkReassemblerMetrics GetMetrics() const noexcept;
+
+              private:
+                using PendingTransfers = std::unordered_map<
+                    uint64_t,
+                    std::shared_ptr<ChunkedTransfer>,
+                    std::hash<uint64_t>,
+                    std::equal_to<uint64_t>,
+                    StlAllocator<std::pair<const uint64_t, std::shared_ptr<ChunkedTransfer>>>>;
+
+                void EvictStalest() noexcept;
+
+                Allocator *m_allocator;
+                OnChunkedMessageReceivedHandler m_onMessage;
+                size_t m_maxPayloadLength;
+                size_t m_maxPendingTransfers;
+
+                mutable std::mutex m_lock;
+                PendingTransfers m_transfers;
+                /* the last few completed transfers, so late duplicates of their chunks do not start them again */
+                Vector<uint64_t> m_completedKeys;
+                size_t m_nextCompletedKey;
+                uint64_t m_sequence;
+                MqttChunkReassemblerMetrics m_metrics;
+            };
+        } // namespace Mqtt
+    }     // namespace Crt
+} // namespace Aws
@@ -38,40 +38,51 @@ namespace Aws
             /**
              * Invoked Upon Connection loss.
              */
-            using OnConnectionInterruptedHandler = std::function<void(MqttConnection &connection, int error)>;
+            using OnConnectionInterruptedHandler = Function<void(MqttConnection &connection, int error)>;
 
             /**
              * Invoked Upon Connection resumed.
              */
             using OnConnectionResumedHandler =
-                std::function<void(MqttConnection &connection, ReturnCode connectCode, bool sessionPresent)>;
+                Function<void(MqttConnection &connection, ReturnCode connectCode, bool sessionPresent)>;
 
             /**
              * Invoked when a connack message is received, or an error occurred.
              */
-            using OnConnectionCompletedHandler = std::function<
+            using OnConnectionCompletedHandler = Function<
                 void(MqttConnection &connection, int errorCode, ReturnCode returnCode, bool sessionPresent)>;
 
             /**
              * Invoked when a suback message is received.
              */
-            using OnSubAckHandler = std::function<
+            using OnSubAckHandler = Function<
                 void(MqttConnection &connection, uint16_t packetId, const String &topic, QOS qos, int errorCode)>;
 
             /**
              * Invoked when a suback message for multiple topics is received.
              */
-            using OnMultiSubAckHandler = std::function<void(
+            using OnMultiSubAckHandler = Function<void(
                 MqttConnection &connection,
                 uint16_t packetId,
                 const Vector<String> &topics,
                 QOS qos,
                 int errorCode)>;
 
+            /**
+             * Invoked when a suback message for multiple topics is received, with the QoS granted to each topic in
+             * the order of topics. A topic the server rejected is granted AWS_MQTT_QOS_FAILURE.
+             */
+            using OnMultiSubAckGrantsHandler = Function<void(
+                MqttConnection &connection,
+                uint16_t packetId,
+                const Vector<String> &topics,
+                const Vector<QOS> &grantedQos,
+                int errorCode)>;
+
             /**
              * Invoked when a disconnect message has been sent.
              */
-            using OnDisconnectHandler = std::function<void(MqttConnection &connection)>;
+            using OnDisconnectHandler = Function<void(MqttConnection &connection)>;
 
             /**
              * Invoked upon receipt of a Publish message on a subscribed topic.
@@ -84,7 +95,7 @@ namespace Aws
              * @param retain        Retain flag. If true, the message was sent as a result of
              *                      a new subscription being made by the client.
              */
-            using OnMessageReceivedHandler = std::function<void(
+            using OnMessageReceivedHandler = Function<void(
                 MqttConnection &connection,
                 const String &topic,
                 const ByteBuf &payload,
@@ -92,21 +103,104 @@ namespace Aws
                 QOS qos,
                 bool retain)>;
 
+            /**
+             * Invoked upon receipt of a Publish message on a subscribed topic, like OnMessageReceivedHandler, but
+             * topic and payload refer straight to the incoming packet instead of copies of it. They are only valid
+             * for the duration of the call; nothing is allocated per message to deliver them.
+             */
+            using OnMessageReceivedViewHandler = Function<void(
+                MqttConnection &connection,
+                StringView topic,
+                const ByteCursor &payload,
+                bool dup,
+                QOS qos,
+                bool retain)>;
+
             /**
              * @deprecated Use OnMessageReceivedHandler
              */
             using OnPublishReceivedHandler =
-                std::function<void(MqttConnection &connection, const String &topic, const ByteBuf &payload)>;
+                Function<void(MqttConnection &connection, const String &topic, const ByteBuf &payload)>;
 
             using OnOperationCompleteHandler =
-                std::function<void(MqttConnection &connection, uint16_t packetId, int errorCode)>;
+                Function<void(MqttConnection &connection, uint16_t packetId, int errorCode)>;
+
+            /**
+             * A message to publish with MqttConnection::PublishBatch().
+             */
+            struct AWS_CRT_CPP_API PublishBatchMessage
+            {
+                ByteCursor topic;
+                ByteCursor payload;
+                QOS qos;
+                bool retain;
+            };
+
+            /**
+             * Number of buckets in MqttConnectionStatistics::PublishLatencyBuckets.
+             */
+            static const size_t MQTT_PUBLISH_LATENCY_BUCKET_COUNT = 24;
+
+            /**
+             * A snapshot of the operations an MqttConnection has in flight, and of how they have gone so far.
+             */
+            struct AWS_CRT_CPP_API MqttConnectionStatistics
+            {
+                /**
+                 * Publishes, subscribes and unsubscribes queued but not completed yet.
+                 */
+                uint64_t IncompleteOperationCount = 0;
+                /**
+                 * Topic, topic filter and payload bytes of the incomplete operations.
+                 */
+                uint64_t IncompleteOperationBytes = 0;
+                /**
+                 * QoS 1 and 2 publishes waiting for the broker's acknowledgement.
+                 */
+                uint64_t UnackedPublishCount = 0;
+                uint64_t CompletedOperationCount = 0;
+                uint64_t FailedOperationCount = 0;
+                uint64_t InterruptionCount = 0;
+                uint64_t ResumptionCount = 0;
+                /**
+                 * Time from queueing a QoS 1 or 2 publish to its successful acknowledgement. Bucket 0 counts
+                 * latencies under a microsecond, bucket i those under 2^i microseconds but not under 2^(i-1), and
+                 * the last bucket everything longer.
+                 */
+                uint64_t PublishLatencyBuckets[MQTT_PUBLISH_LATENCY_BUCKET_COUNT] = {};
+                uint64_t TotalPublishLatencyNs = 0;
+
+                /**
+                 * @return the exclusive upper bound, in microseconds, of the latencies counted in bucket, or
+                 * UINT64_MAX for the last bucket.
+                 */
+                static uint64_t GetPublishLatencyBucketBoundUs(size_t bucket) noexcept;
+            };
+
+            /**
+             * The live counters behind MqttConnection::GetOperationStatistics().
+             */
+            struct AWS_CRT_CPP_API MqttConnectionCounters
+            {
+                MqttConnectionCounters() noexcept;
+
+                std::atomic<uint64_t> incompleteOperationCount;
+                std::atomic<uint64_t> incompleteOperationBytes;
+                std::atomic<uint64_t> unackedPublishCount;
+                std::atomic<uint64_t> completedOperationCount;
+                std::atomic<uint64_t> failedOperationCount;
+                std::atomic<uint64_t> interruptionCount;
+                std::atomic<uint64_t> resumptionCount;
+                std::atomic<uint64_t> publishLatencyBuckets[MQTT_PUBLISH_LATENCY_BUCKET_COUNT];
+                std::atomic<uint64_t> totalPublishLatencyNs;
+            };
 
             /**
              * Callback for users to invoke upon completion of, presumably asynchronous, OnWebSocketHandshakeIntercept
              * callback's initiated process.
              */
             using OnWebSocketHandshakeInterceptComplete =
-                std::function<void(const std::shared_ptr<Http::HttpRequest> &, int errorCode)>;
+                Function<void(const std::shared_ptr<Http::HttpRequest> &, int errorCode)>;
 
             /**
              * Invoked during websocket handshake to give users opportunity to transform an http request for purposes
@@ -114,7 +208,7 @@ namespace Aws
              * handshake since some work flows may be asynchronous. To accommodate that, onComplete must be invoked upon
              * completion of the signing process.
              */
-            using OnWebSocketHandshakeIntercept = std::function<
+            using OnWebSocketHandshakeIntercept = Function<
                 void(std::shared_ptr<Http::HttpRequest> req, const OnWebSocketHandshakeInterceptComplete &onComplete)>;
 
             /**
@@ -126,6 +220,7 @@ namespace Aws
             class AWS_CRT_CPP_API MqttConnection final
             {
                 friend class MqttClient;
+                friend class MqttSubscribeCoalescer;
 
               public:
                 ~MqttConnection();
@@ -205,6 +300,26 @@ namespace Aws
                     OnMessageReceivedHandler &&onMessage,
                     OnSubAckHandler &&onSubAck) noexcept;
 
+                /**
+                 * Subscribes to topicFilter, with a handler that receives each message without it being copied.
+                 * See OnMessageReceivedViewHandler.
+                 */
+                uint16_t Subscribe(
+                    const char *topicFilter,
+                    QOS qos,
+                    OnMessageReceivedViewHandler &&onMessage,
+                    OnSubAckHandler &&onSubAck) noexcept;
+
+                /**
+                 * Subscribes to topicFilter without a message handler, e.g. when SetOnMessageHandler() handles
+                 * everything. Lets nullptr be passed without naming a handler type.
+                 */
+                uint16_t Subscribe(
+                    const char *topicFilter,
+                    QOS qos,
+                    std::nullptr_t onMessage,
+                    OnSubAckHandler &&onSubAck) noexcept;
+
                 /**
                  * @deprecated Use alternate Subscribe()
                  */
@@ -224,6 +339,15 @@ namespace Aws
                     QOS qos,
                     OnMultiSubAckHandler &&onOpComplete) noexcept;
 
+                /**
+                 * Subscribes to multiple topicFilters, with handlers that receive each message without it being
+                 * copied. See OnMessageReceivedViewHandler.
+                 */
+                uint16_t Subscribe(
+                    const Vector<std::pair<const char *, OnMessageReceivedViewHandler>> &topicFilters,
+                    QOS qos,
+                    OnMultiSubAckHandler &&onOpComplete) noexcept;
+
                 /**
                  * @deprecated Use alternate Subscribe()
                  */
@@ -238,6 +362,17 @@ namespace Aws
                  */
                 bool SetOnMessageHandler(OnMessageReceivedHandler &&onMessage) noexcept;
 
+                /**
+                 * Installs a handler for all incoming publish messages that receives each message without it being
+                 * copied. See OnMessageReceivedViewHandler.
+                 */
+                bool SetOnMessageHandler(OnMessageReceivedViewHandler &&onMessage) noexcept;
+
+                /**
+                 * Removes the handler for all incoming publish messages.
+                 */
+                bool SetOnMessageHandler(std::nullptr_t onMessage) noexcept;
+
                 /**
                  * @deprecated Use alternate SetOnMessageHandler()
                  */
@@ -260,6 +395,54 @@ namespace Aws
                     const ByteBuf &payload,
                     OnOperationCompleteHandler &&onOpComplete) noexcept;
 
+                /**
+                 * Publishes to topic, taking a reference on payloadOwner, which keeps the memory payload points to
+                 * alive. The reference is dropped once onOpComplete has returned, or right away if the publish
+                 * could not be queued, so a pooled or shared buffer can be handed off without being copied or
+                 * tracked by the caller.
+                 */
+                uint16_t Publish(
+                    const char *topic,
+                    QOS qos,
+                    bool retain,
+                    std::shared_ptr<const void> payloadOwner,
+                    const ByteCursor &payload,
+                    OnOperationCompleteHandler &&onOpComplete) noexcept;
+
+                /**
+                 * Publishes count messages in one go. The callback state of the whole batch, copies of the topics
+                 * included, is a single allocation shared by its messages, rather than two allocations per message.
+                 * onOpComplete is invoked once for each message that was queued.
+                 *
+                 * The backing memory for a message's payload must stay available until onOpComplete has been
+                 * invoked for it. If outPacketIds is set, it receives count packet ids, 0 for a message that could
+                 * not be queued.
+                 *
+                 * @return the number of messages queued.
+                 */
+                size_t PublishBatch(
+                    const PublishBatchMessage *messages,
+                    size_t count,
+                    OnOperationCompleteHandler &&onOpComplete,
+                    uint16_t *outPacketIds = nullptr) noexcept;
+
+                /**
+                 * Publishes every message in messages, see PublishBatch() above.
+                 */
+                size_t PublishBatch(
+                    const Vector<PublishBatchMessage> &messages,
+                    OnOperationCompleteHandler &&onOpComplete,
+                    uint16_t *outPacketIds = nullptr) noexcept
+                {
+                    return PublishBatch(messages.data(), messages.size(), std::move(onOpComplete), outPacketIds);
+                }
+
+                /**
+                 * @return a snapshot of the connection's operation counters. They are updated independently, so
+                 * a snapshot taken while operations complete may be off by the operations in flight.
+                 */
+                MqttConnectionStatistics GetOperationStatistics() const noexcept;
+
                 OnConnectionInterruptedHandler OnConnectionInterrupted;
                 OnConnectionResumedHandler OnConnectionResumed;
                 OnConnectionCompletedHandler OnConnectionCompleted;
@@ -278,6 +461,7 @@ namespace Aws
                 void *m_onAnyCbData;
                 bool m_useTls;
                 bool m_useWebsocket;
+                MqttConnectionCounters m_counters;
 
                 MqttConnection(
                     aws_mqtt_client *client,
@@ -294,6 +478,16 @@ namespace Aws
                     const Io::SocketOptions &socketOptions,
                     bool useWebsocket) noexcept;
 
+                /**
+                 * Subscribes to multiple topicFilters, reporting the suback to whichever of onSubAck and
+                 * onSubAckGrants is set.
+                 */
+                uint16_t SubscribeMultiple(
+                    const Vector<std::pair<const char *, OnMessageReceivedViewHandler>> &topicFilters,
+                    QOS qos,
+                    OnMultiSubAckHandler &&onSubAck,
+                    OnMultiSubAckGrantsHandler &&onSubAckGrants) noexcept;
+
                 static void s_onConnectionInterrupted(aws_mqtt_client_connection *, int errorCode, void *userData);
                 static void s_onConnectionCompleted(
                     aws_mqtt_client_connection *,
@@ -335,6 +529,11 @@ namespace Aws
                     uint16_t packetId,
                     int errorCode,
                     void *userdata);
+                static void s_onBatchOpComplete(
+                    aws_mqtt_client_connection *connection,
+                    uint16_t packetId,
+                    int errorCode,
+                    void *userdata);
 
                 static void s_onWebsocketHandshake(
                     struct aws_http_message *request,
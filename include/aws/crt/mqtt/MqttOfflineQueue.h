@@ -0,0 +1,203 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/mqtt/MqttClient.h>
+
+#include <cstdio>
+#include <mutex>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Mqtt
+        {
+            /**
+             * What an MqttOfflineQueue does with a message on a given topic while the connection is down.
+             */
+            enum class OfflineTopicPolicy
+            {
+                /**
+                 * The message is queued behind the others.
+                 */
+                Queue,
+                /**
+                 * The message takes the place of the one queued earlier on the same topic, if any, so only the
+                 * latest value of the topic is sent once the connection is back.
+                 */
+                Replace,
+                /**
+                 * The message is dropped.
+                 */
+                Drop,
+            };
+
+            /**
+             * What an MqttOfflineQueue does with a message that does not fit within its budget.
+             */
+            enum class OfflineQueueOverflowPolicy
+            {
+                /**
+                 * The oldest messages queued in memory are dropped to make room.
+                 */
+                DropOldest,
+                /**
+                 * The message is dropped.
+                 */
+                DropNewest,
+            };
+
+            struct AWS_CRT_CPP_API MqttOfflineQueueOptions
+            {
+                /**
+                 * Most topic and payload bytes held in memory while the connection is down.
+                 */
+                size_t MaxQueuedBytes = 1024 * 1024;
+                OfflineQueueOverflowPolicy OverflowPolicy = OfflineQueueOverflowPolicy::DropOldest;
+                /**
+                 * Picks the policy for a topic. Unset queues every message.
+                 */
+                Function<OfflineTopicPolicy(StringView topic)> TopicPolicy;
+                /**
+                 * When set, messages arriving once the memory budget is used up are appended to a file at this
+                 * path instead, suffixed with a generation number, and published straight from a mapping of it
+                 * once the connection is back. Once a message has been spilled, later ones are spilled too, so
+                 * the order is kept. The file is removed once everything in it has been published.
+                 */
+                String SpillFilePath;
+                /**
+                 * Most bytes written to the spill file while the connection is down. Messages that find it full
+                 * are dropped.
+                 */
+                size_t MaxSpillBytes = 64 * 1024 * 1024;
+            };
+
+            /**
+             * A snapshot of an MqttOfflineQueue's counters.
+             */
+            struct AWS_CRT_CPP_API MqttOfflineQueueMetrics
+            {
+                size_t QueuedMessages = 0;
+                size_t QueuedBytes = 0;
+                size_t SpilledMessages = 0;
+                size_t SpilledBytes = 0;
+                uint64_t Dropped = 0;
+                uint64_t Replaced = 0;
+            };
+
+            /**
+             * Invoked once a message accepted by an MqttOfflineQueue has been published, or with an error if it was
+             * later dropped to make room, replaced, or could not be published. Messages that Publish() turned down
+             * are not reported.
+             */
+            using OnOfflinePublishCompleteHandler =
+                Function<void(MqttConnection &connection, StringView topic, int errorCode)>;
+
+            struct OfflinePublish;
+
+            /**
+             * Hashes a topic without copying it. See MqttOfflineQueue.
+             */
+            struct AWS_CRT_CPP_API OfflineTopicHash
+            {
+                size_t operator()(const StringView &topic) const noexcept;
+            };
+
+            /**
+             * Publishes on an MqttConnection, holding messages back while the connection is down within a bounded
+             * memory budget and an optional spill file, and sending them all as soon as it is back.
+             *
+             * The queue chains itself in front of the connection's OnConnectionCompleted,
+             * OnConnectionInterrupted, OnConnectionResumed and OnDisconnect handlers, so those should be installed
+             * before the queue is created. Until the connection completes, messages are queued.
+             */
+            class AWS_CRT_CPP_API MqttOfflineQueue final : public std::enable_shared_from_this<MqttOfflineQueue>
+            {
+              public:
+                static std::shared_ptr<MqttOfflineQueue> NewOfflineQueue(
+                    const std::shared_ptr<MqttConnection> &connection,
+                    const MqttOfflineQueueOptions &options = MqttOfflineQueueOptions(),
+                    Allocator *allocator = g_allocator) noexcept;
+
+                ~MqttOfflineQueue();
+                MqttOfflineQueue(const MqttOfflineQueue &) = delete;
+                MqttOfflineQueue(MqttOfflineQueue &&) = delete;
+                MqttOfflineQueue &operator=(const MqttOfflineQueue &) = delete;
+                MqttOfflineQueue &operator=(MqttOfflineQueue &&) = delete;
+
+                /**
+                 * Publishes a copy of payload to topic, or queues it if the connection is down.
+                 * @return false if the message was dropped.
+                 */
+                bool Publish(const char *topic, QOS qos, bool retain, const ByteCursor &payload) noexcept;
+
+                /**
+                 * Publishes payload to topic, or queues it if the connection is down, holding a reference on
+                 * payloadOwner instead of copying it. The reference is dropped once the message has been published,
+                 * dropped or spilled.
+                 * @return false if the message was dropped.
+                 */
+                bool Publish(
+                    const char *topic,
+                    QOS qos,
+                    bool retain,
+                    std::shared_ptr<const void> payloadOwner,
+                    const ByteCursor &payload) noexcept;
+
+                /**
+                 * @return true while the connection is up and messages are published right away.
+                 */
+                bool IsOnline() const noexcept;
+
+                MqttOfflineQueueMetrics GetMetrics() const noexcept;
+
+                /**
+                 * Invoked for each message handed to the queue, mostly from an event-loop thread. Set it before
+                 * publishing.
+                 */
+                OnOfflinePublishCompleteHandler OnPublishComplete;
+
+              private:
+                MqttOfflineQueue(
+                    const std::shared_ptr<MqttConnection> &connection,
+                    const MqttOfflineQueueOptions &options,
+                    Allocator *allocator) noexcept;
+
+                using DroppedPublishes = Vector<std::shared_ptr<OfflinePublish>>;
+                using QueuedPublishes = List<std::shared_ptr<OfflinePublish>>;
+                using LatestByTopic = std::unordered_map<
+                    StringView,
+                    QueuedPublishes::iterator,
+                    OfflineTopicHash,
+                    std::equal_to<StringView>,
+                    StlAllocator<std::pair<const StringView, QueuedPublishes::iterator>>>;
+
+                void InstallConnectionHandlers() noexcept;
+                void SetOnline(bool online) noexcept;
+                bool PublishNow(const std::shared_ptr<OfflinePublish> &message) noexcept;
+                bool Enqueue(const std::shared_ptr<OfflinePublish> &message, DroppedPublishes &dropped) noexcept;
+                bool Spill(const OfflinePublish &message) noexcept;
+                void DrainSpillFile(DroppedPublishes &failed) noexcept;
+                void Evict(DroppedPublishes &dropped) noexcept;
+                void CompleteDropped(const DroppedPublishes &dropped) noexcept;
+
+                Allocator *m_allocator;
+                std::shared_ptr<MqttConnection> m_connection;
+                MqttOfflineQueueOptions m_options;
+
+                mutable std::mutex m_lock;
+                QueuedPublishes m_queue;
+                /* messages on Replace topics, keyed by a view of their own topic */
+                LatestByTopic m_latestByTopic;
+                MqttOfflineQueueMetrics m_metrics;
+                bool m_online;
+
+                FILE *m_spillFile;
+                String m_spillFilePath;
+                uint64_t m_spillGeneration;
+            };
+        } // namespace Mqtt
+    }     // namespace Crt
+} // namespace Aws
@@ -0,0 +1,143 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/io/EventLoopGroup.h>
+#include <aws/crt/mqtt/MqttClient.h>
+
+#include <chrono>
+#include <mutex>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Mqtt
+        {
+            struct AWS_CRT_CPP_API MqttSubscribeCoalescerOptions
+            {
+                /**
+                 * How long a subscribe issued while the connection is up waits for others to share its SUBSCRIBE
+                 * packet.
+                 */
+                std::chrono::milliseconds CoalescingWindow = std::chrono::milliseconds(20);
+                /**
+                 * Most topic filters sent in one SUBSCRIBE packet. AWS IoT Core accepts up to 8.
+                 */
+                size_t MaxTopicsPerSubscribe = 8;
+                /**
+                 * Event loops the coalescing window is timed on. Unset, subscribes issued while the connection is
+                 * up are sent right away, and only those issued while it is down are coalesced.
+                 */
+                Io::EventLoopGroup *EventLoopGroup = nullptr;
+            };
+
+            /**
+             * A snapshot of an MqttSubscribeCoalescer's counters.
+             */
+            struct AWS_CRT_CPP_API MqttSubscribeCoalescerMetrics
+            {
+                size_t PendingSubscribes = 0;
+                uint64_t SubscribePackets = 0;
+                uint64_t SubscribedTopics = 0;
+            };
+
+            struct CoalescedSubscribe;
+
+            /**
+             * Subscribes on an MqttConnection, merging the subscribes issued within a short window of each other,
+             * or while the connection is down, into multi-topic SUBSCRIBE packets. Each topic's OnSubAckHandler is
+             * still invoked on its own, with the packet id of the SUBSCRIBE it went out in and the QoS granted to
+             * that topic, which is AWS_MQTT_QOS_FAILURE if the server rejected it.
+             *
+             * Topic filters of the same QoS share packets, in the order they were subscribed to. The coalescer
+             * chains itself in front of the connection's OnConnectionCompleted, OnConnectionInterrupted,
+             * OnConnectionResumed and OnDisconnect handlers, so those should be installed before it is created.
+             * Until the connection completes, subscribes are held back.
+             */
+            class AWS_CRT_CPP_API MqttSubscribeCoalescer final
+                : public std::enable_shared_from_this<MqttSubscribeCoalescer>
+            {
+              public:
+                static std::shared_ptr<MqttSubscribeCoalescer> NewSubscribeCoalescer(
+                    const std::shared_ptr<MqttConnection> &connection,
+                    const MqttSubscribeCoalescerOptions &options = MqttSubscribeCoalescerOptions(),
+                    Allocator *allocator = g_allocator) noexcept;
+
+                /**
+                 * Subscribes still held back are completed with AWS_ERROR_MQTT_NOT_CONNECTED.
+                 */
+                ~MqttSubscribeCoalescer();
+                MqttSubscribeCoalescer(const MqttSubscribeCoalescer &) = delete;
+                MqttSubscribeCoalescer(MqttSubscribeCoalescer &&) = delete;
+                MqttSubscribeCoalescer &operator=(const MqttSubscribeCoalescer &) = delete;
+                MqttSubscribeCoalescer &operator=(MqttSubscribeCoalescer &&) = delete;
+
+                /**
+                 * Subscribes to topicFilter along with whatever else is subscribed to within the window.
+                 * onSubAck is invoked once the SUBSCRIBE carrying topicFilter is acknowledged, or with an error
+                 * if it could not be sent.
+                 * @return false if topicFilter is empty or could not be queued.
+                 */
+                bool Subscribe(
+                    const char *topicFilter,
+                    QOS qos,
+                    OnMessageReceivedHandler &&onMessage,
+                    OnSubAckHandler &&onSubAck) noexcept;
+
+                /**
+                 * Subscribes to topicFilter with a handler that receives each message without it being copied.
+                 * See Subscribe() above.
+                 */
+                bool Subscribe(
+                    const char *topicFilter,
+                    QOS qos,
+                    OnMessageReceivedViewHandler &&onMessage,
+                    OnSubAckHandler &&onSubAck) noexcept;
+
+                /**
+                 * Subscribes to topicFilter without a message handler. See Subscribe() above.
+                 */
+                bool Subscribe(
+                    const char *topicFilter,
+                    QOS qos,
+                    std::nullptr_t onMessage,
+                    OnSubAckHandler &&onSubAck) noexcept;
+
+                /**
+                 * Sends everything held back right away, if the connection is up.
+                 * @return the number of SUBSCRIBE packets sent.
+                 */
+                size_t Flush() noexcept;
+
+                MqttSubscribeCoalescerMetrics GetMetrics() const noexcept;
+
+              private:
+                MqttSubscribeCoalescer(
+                    const std::shared_ptr<MqttConnection> &connection,
+                    const MqttSubscribeCoalescerOptions &options,
+                    Allocator *allocator) noexcept;
+
+                using PendingSubscribes = Vector<std::shared_ptr<CoalescedSubscribe>>;
+
+                void InstallConnectionHandlers() noexcept;
+                void SetOnline(bool online) noexcept;
+                void ScheduleFlush() noexcept;
+                size_t Send(PendingSubscribes &&pending) noexcept;
+
+                static void s_onFlushTask(aws_task *task, void *arg, aws_task_status status);
+
+                Allocator *m_allocator;
+                std::shared_ptr<MqttConnection> m_connection;
+                MqttSubscribeCoalescerOptions m_options;
+
+                mutable std::mutex m_lock;
+                PendingSubscribes m_pending;
+                MqttSubscribeCoalescerMetrics m_metrics;
+                bool m_online;
+                bool m_flushScheduled;
+            };
+        } // namespace Mqtt
+    }     // namespace Crt
+} // namespace Aws
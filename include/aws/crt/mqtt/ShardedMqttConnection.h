@@ -0,0 +1,163 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/mqtt/MqttClient.h>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Mqtt
+        {
+            class ShardedMqttConnection;
+
+            /**
+             * Invoked once every shard has finished connecting, with the number of shards the broker accepted.
+             */
+            using OnShardedConnectionCompletedHandler =
+                Function<void(ShardedMqttConnection &connection, size_t connectedShards)>;
+
+            /**
+             * Invoked once every shard has disconnected.
+             */
+            using OnShardedDisconnectHandler = Function<void(ShardedMqttConnection &connection)>;
+
+            /**
+             * Several connections to the same broker used as one, so that throughput is not bound by what a single
+             * connection, and the one event-loop thread it runs on, can push. Each shard is an MqttConnection of
+             * its own; the client's bootstrap hands each of them the next loop of its EventLoopGroup, so with as
+             * many shards as loops every loop carries one.
+             *
+             * A message is published on the shard its topic hashes to, so messages on one topic keep their order.
+             * A subscription is made on the shard its topic filter hashes to, so each message is only delivered
+             * once, and message handlers are invoked from whichever shard receives the message.
+             *
+             * The shards' OnConnectionCompleted and OnDisconnect handlers belong to the ShardedMqttConnection;
+             * their other handlers can be installed through GetShard().
+             */
+            class AWS_CRT_CPP_API ShardedMqttConnection final
+            {
+              public:
+                /**
+                 * Creates shardCount connections using TLS from client. The client must outlive them.
+                 */
+                ShardedMqttConnection(
+                    MqttClient &client,
+                    size_t shardCount,
+                    const char *hostName,
+                    uint16_t port,
+                    const Io::SocketOptions &socketOptions,
+                    const Crt::Io::TlsContext &tlsContext,
+                    bool useWebsocket = false) noexcept;
+
+                /**
+                 * Creates shardCount connections over plain text from client. The client must outlive them.
+                 */
+                ShardedMqttConnection(
+                    MqttClient &client,
+                    size_t shardCount,
+                    const char *hostName,
+                    uint16_t port,
+                    const Io::SocketOptions &socketOptions,
+                    bool useWebsocket = false) noexcept;
+
+                ~ShardedMqttConnection() = default;
+                ShardedMqttConnection(const ShardedMqttConnection &) = delete;
+                ShardedMqttConnection(ShardedMqttConnection &&) = delete;
+                ShardedMqttConnection &operator=(const ShardedMqttConnection &) = delete;
+                ShardedMqttConnection &operator=(ShardedMqttConnection &&) = delete;
+
+                /**
+                 * @return true if every shard was created.
+                 */
+                explicit operator bool() const noexcept { return m_lastError == AWS_ERROR_SUCCESS; }
+
+                /**
+                 * @return the error that kept a shard from being created.
+                 */
+                int LastError() const noexcept { return m_lastError; }
+
+                size_t GetShardCount() const noexcept { return m_shards.size(); }
+
+                /**
+                 * @return the connection backing shard index.
+                 */
+                const std::shared_ptr<MqttConnection> &GetShard(size_t index) const noexcept
+                {
+                    return m_shards[index];
+                }
+
+                /**
+                 * @return the index of the shard that topic, or a topic filter, maps to.
+                 */
+                size_t GetShardIndex(StringView topic) const noexcept;
+
+                /**
+                 * Connects every shard. Brokers need each connection to have a client id of its own, so
+                 * shard i connects as "<clientIdPrefix>-<i>". OnConnectionCompleted is invoked once all of them
+                 * are done.
+                 */
+                bool Connect(
+                    const char *clientIdPrefix,
+                    bool cleanSession,
+                    uint16_t keepAliveTimeSecs = 0,
+                    uint32_t pingTimeoutMs = 0,
+                    uint32_t protocolOperationTimeoutMs = 0) noexcept;
+
+                /**
+                 * Disconnects every shard. OnDisconnect is invoked once all of them are done.
+                 */
+                bool Disconnect() noexcept;
+
+                /**
+                 * Subscribes to topicFilter on the shard it maps to. onMessage is invoked from that shard's
+                 * event-loop thread.
+                 * @return the packet id of the subscribe on that shard, or 0 on failure.
+                 */
+                uint16_t Subscribe(
+                    const char *topicFilter,
+                    QOS qos,
+                    OnMessageReceivedViewHandler &&onMessage,
+                    OnSubAckHandler &&onSubAck) noexcept;
+
+                /**
+                 * Unsubscribes from topicFilter on the shard Subscribe() used for it.
+                 */
+                uint16_t Unsubscribe(const char *topicFilter, OnOperationCompleteHandler &&onOpComplete) noexcept;
+
+                /**
+                 * Installs onMessage on every shard, for all incoming publish messages.
+                 */
+                bool SetOnMessageHandler(const OnMessageReceivedViewHandler &onMessage) noexcept;
+
+                /**
+                 * Publishes to topic on the shard it maps to. The backing memory for payload must stay available
+                 * until onOpComplete has been invoked.
+                 * @return the packet id of the publish on that shard, or 0 on failure.
+                 */
+                uint16_t Publish(
+                    const char *topic,
+                    QOS qos,
+                    bool retain,
+                    const ByteBuf &payload,
+                    OnOperationCompleteHandler &&onOpComplete) noexcept;
+
+                OnShardedConnectionCompletedHandler OnConnectionCompleted;
+                OnShardedDisconnectHandler OnDisconnect;
+
+              private:
+                void AddShard(std::shared_ptr<MqttConnection> &&shard) noexcept;
+                void CompleteConnect(bool connected) noexcept;
+                void CompleteDisconnect() noexcept;
+
+                Vector<std::shared_ptr<MqttConnection>> m_shards;
+                std::atomic<size_t> m_pendingConnects;
+                std::atomic<size_t> m_connectedShards;
+                std::atomic<size_t> m_pendingDisconnects;
+                int m_lastError;
+            };
+        } // namespace Mqtt
+    }     // namespace Crt
+} // namespace Aws
@@ -0,0 +1,90 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/mqtt/MqttClient.h>
+
+#include <mutex>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Mqtt
+        {
+            struct TopicRouterNode;
+            struct TopicRoute;
+
+            /**
+             * Routes incoming messages to handlers registered by topic filter, '+' and '#' wildcards included. The
+             * filters are kept in a trie over topic levels, so routing a message costs O(levels in its topic)
+             * however many routes there are, and the handlers share one callback on the connection instead of
+             * each carrying its own subscription state.
+             *
+             * Install the router with MqttConnection::SetOnMessageHandler(router->GetOnMessageReceived()), and
+             * subscribe on the connection with an empty OnMessageReceivedViewHandler so that messages are only
+             * dispatched once. As in MQTT, wildcards at the first level do not match topics starting with '$'.
+             *
+             * Routes can be added and removed from any thread, including from a handler while dispatching.
+             */
+            class AWS_CRT_CPP_API TopicRouter final : public std::enable_shared_from_this<TopicRouter>
+            {
+              public:
+                explicit TopicRouter(Allocator *allocator = g_allocator) noexcept;
+                ~TopicRouter();
+                TopicRouter(const TopicRouter &) = delete;
+                TopicRouter(TopicRouter &&) = delete;
+                TopicRouter &operator=(const TopicRouter &) = delete;
+                TopicRouter &operator=(TopicRouter &&) = delete;
+
+                /**
+                 * Routes messages whose topic matches topicFilter to handler. Several routes may share a filter.
+                 * @return an id for RemoveRoute(), or 0 if topicFilter is not a valid filter.
+                 */
+                uint64_t AddRoute(StringView topicFilter, OnMessageReceivedViewHandler &&handler) noexcept;
+
+                /**
+                 * Removes the route with the given id. A dispatch already in progress may still invoke it.
+                 * @return false if there is no such route.
+                 */
+                bool RemoveRoute(uint64_t routeId) noexcept;
+
+                /**
+                 * @return the number of routes registered.
+                 */
+                size_t GetRouteCount() const noexcept;
+
+                /**
+                 * Invokes the handler of every route matching topic.
+                 * @return the number of handlers invoked.
+                 */
+                size_t Dispatch(
+                    MqttConnection &connection,
+                    StringView topic,
+                    const ByteCursor &payload,
+                    bool dup,
+                    QOS qos,
+                    bool retain) const noexcept;
+
+                /**
+                 * @return a message handler that dispatches through this router. It holds a reference to the
+                 * router.
+                 */
+                OnMessageReceivedViewHandler GetOnMessageReceived() noexcept;
+
+                /**
+                 * @return true if topicFilter is a valid MQTT topic filter.
+                 */
+                static bool IsValidTopicFilter(StringView topicFilter) noexcept;
+
+              private:
+                Allocator *m_allocator;
+                mutable std::mutex m_lock;
+                TopicRouterNode *m_root;
+                UnorderedMap<uint64_t, std::shared_ptr<TopicRoute>> m_routes;
+                uint64_t m_nextRouteId;
+            };
+        } // namespace Mqtt
+    }     // namespace Crt
+} // namespace Aws
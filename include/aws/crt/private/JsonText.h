@@ -0,0 +1,45 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/Types.h>
+
+/* Helpers shared by the JSON parsers, not part of the public API. */
+namespace Aws
+{
+    namespace Crt
+    {
+        /**
+         * Unescapes the bytes between the quotes of a JSON string into out, which must have room for as many bytes
+         * plus a NUL. Returns where the NUL was written, or nullptr on an invalid escape or a lone surrogate.
+         */
+        char *JsonUnescapeString(const uint8_t *begin, const uint8_t *end, char *out) noexcept;
+
+        /**
+         * Parses exactly the bytes of an RFC 8259 number, rounding like strtod. Returns false if they are not one.
+         */
+        bool JsonParseNumber(const uint8_t *begin, const uint8_t *end, double &value) noexcept;
+
+        /**
+         * While in scope, cJSON allocates from and frees to allocator on this thread, or the allocator ApiHandle set
+         * up for JSON if it is nullptr. Every JsonObject operation that creates or deletes nodes runs in one.
+         */
+        class JsonAllocatorScope
+        {
+          public:
+            explicit JsonAllocatorScope(Allocator *allocator) noexcept;
+            ~JsonAllocatorScope();
+            JsonAllocatorScope(const JsonAllocatorScope &) = delete;
+            JsonAllocatorScope &operator=(const JsonAllocatorScope &) = delete;
+
+            /**
+             * @return the allocator of the innermost scope on this thread, or nullptr outside of every scope.
+             */
+            static Allocator *Current() noexcept;
+
+          private:
+            Allocator *m_previous;
+        };
+    } // namespace Crt
+} // namespace Aws
@@ -0,0 +1,26 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/Types.h>
+
+#include <functional>
+#include <thread>
+
+/* Helpers shared by the code that spreads a batch of work across threads, not part of the public API. */
+namespace Aws
+{
+    namespace Crt
+    {
+        /**
+         * Starts up to count threads running work and adds them to threads. Returns how many it managed to start,
+         * which is fewer than count if the system runs out of threads; the caller is expected to do its share of
+         * the work either way and then join every thread started.
+         */
+        size_t StartWorkerThreads(
+            size_t count,
+            const std::function<void()> &work,
+            Vector<std::thread> &threads) noexcept;
+    } // namespace Crt
+} // namespace Aws
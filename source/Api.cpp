@@ -5,13 +5,20 @@
 #include <aws/crt/Api.h>
 #include <aws/crt/StlAllocator.h>
 #include <aws/crt/external/cJSON.h>
+#include <aws/crt/private/JsonText.h>
 #include <aws/crt/io/TlsOptions.h>
 
 #include <aws/auth/auth.h>
+#include <aws/cal/cal.h>
 #include <aws/common/ref_count.h>
+#include <aws/event-stream/event_stream.h>
 #include <aws/http/http.h>
+#include <aws/io/io.h>
 #include <aws/mqtt/mqtt.h>
 
+#include <atomic>
+#include <mutex>
+
 namespace Aws
 {
     namespace Crt
@@ -26,33 +33,208 @@ namespace Aws
         static Io::DeleteTlsContextImplCallback s_BYOCryptoDeleteTlsContextImplCallback;
         static Io::IsTlsAlpnSupportedCallback s_BYOCryptoIsTlsAlpnSupportedCallback;
 
-        static void *s_cJSONAlloc(size_t sz) { return aws_mem_acquire(g_allocator, sz); }
+        static Allocator *s_cJSONAllocator = nullptr;
+
+        /* JsonObjects built with an allocator of their own route their nodes to it through a JsonAllocatorScope */
+        static Allocator *s_cJSONCurrentAllocator()
+        {
+            Allocator *scoped = JsonAllocatorScope::Current();
+            return scoped != nullptr ? scoped : s_cJSONAllocator;
+        }
+
+        static void *s_cJSONAlloc(size_t sz) { return aws_mem_acquire(s_cJSONCurrentAllocator(), sz); }
 
-        static void s_cJSONFree(void *ptr) { return aws_mem_release(g_allocator, ptr); }
+        static void s_cJSONFree(void *ptr) { return aws_mem_release(s_cJSONCurrentAllocator(), ptr); }
 
-        static void s_initApi(Allocator *allocator)
+        static const size_t s_subsystemCount = static_cast<size_t>(ApiSubsystem::Count);
+
+        /* set while an ApiHandle is alive; s_subsystemLock serializes the library init and clean-up calls */
+        static Allocator *s_subsystemAllocators[s_subsystemCount] = {};
+        static std::atomic<uint32_t> s_initializedSubsystems(0);
+        static std::mutex s_subsystemLock;
+
+        static uint32_t s_subsystemBit(ApiSubsystem subsystem)
         {
-            // sets up the StlAllocator for use.
-            g_allocator = allocator;
-            aws_http_library_init(allocator);
-            aws_mqtt_library_init(allocator);
-            aws_auth_library_init(allocator);
+            return static_cast<uint32_t>(1) << static_cast<uint32_t>(subsystem);
+        }
+
+        static void s_initSubsystemLocked(ApiSubsystem subsystem)
+        {
+            if ((s_initializedSubsystems.load(std::memory_order_relaxed) & s_subsystemBit(subsystem)) != 0)
+            {
+                return;
+            }
+
+            Allocator *allocator = s_subsystemAllocators[static_cast<size_t>(subsystem)];
+            switch (subsystem)
+            {
+                case ApiSubsystem::Io:
+                    aws_io_library_init(allocator);
+                    break;
+                case ApiSubsystem::Http:
+                    s_initSubsystemLocked(ApiSubsystem::Io);
+                    aws_http_library_init(allocator);
+                    break;
+                case ApiSubsystem::Mqtt:
+                    s_initSubsystemLocked(ApiSubsystem::Http);
+                    aws_mqtt_library_init(allocator);
+                    break;
+                case ApiSubsystem::Auth:
+                    s_initSubsystemLocked(ApiSubsystem::Http);
+                    aws_auth_library_init(allocator);
+                    break;
+                case ApiSubsystem::EventStream:
+                    s_initSubsystemLocked(ApiSubsystem::Io);
+                    aws_event_stream_library_init(allocator);
+                    break;
+                default:
+                    return;
+            }
+
+            s_initializedSubsystems.fetch_or(s_subsystemBit(subsystem), std::memory_order_release);
+        }
+
+        /* dependents first, the reverse of ApiSubsystem's order */
+        static void s_cleanUpSubsystems()
+        {
+            std::lock_guard<std::mutex> lock(s_subsystemLock);
+            uint32_t initialized = s_initializedSubsystems.exchange(0);
+            for (size_t i = s_subsystemCount; i > 0; --i)
+            {
+                auto subsystem = static_cast<ApiSubsystem>(i - 1);
+                if ((initialized & s_subsystemBit(subsystem)) == 0)
+                {
+                    continue;
+                }
+
+                switch (subsystem)
+                {
+                    case ApiSubsystem::Io:
+                        aws_io_library_clean_up();
+                        break;
+                    case ApiSubsystem::Http:
+                        aws_http_library_clean_up();
+                        break;
+                    case ApiSubsystem::Mqtt:
+                        aws_mqtt_library_clean_up();
+                        break;
+                    case ApiSubsystem::Auth:
+                        aws_auth_library_clean_up();
+                        break;
+                    case ApiSubsystem::EventStream:
+                        aws_event_stream_library_clean_up();
+                        break;
+                    default:
+                        break;
+                }
+            }
+
+            aws_cal_library_clean_up();
+            for (auto &allocator : s_subsystemAllocators)
+            {
+                allocator = nullptr;
+            }
+        }
+
+        static void s_initCore(Allocator *allocator, bool lazySubsystems)
+        {
+            /* hashing and HMAC are always available, whichever subsystems end up being used */
+            aws_cal_library_init(allocator);
 
             cJSON_Hooks hooks;
             hooks.malloc_fn = s_cJSONAlloc;
             hooks.free_fn = s_cJSONFree;
             cJSON_InitHooks(&hooks);
+
+            if (!lazySubsystems)
+            {
+                std::lock_guard<std::mutex> lock(s_subsystemLock);
+                for (size_t i = 0; i < s_subsystemCount; ++i)
+                {
+                    s_initSubsystemLocked(static_cast<ApiSubsystem>(i));
+                }
+            }
+        }
+
+        static void s_initApi(Allocator *allocator, bool lazySubsystems)
+        {
+            // sets up the StlAllocator for use.
+            g_allocator = allocator;
+            s_cJSONAllocator = allocator;
+            for (auto &subsystemAllocator : s_subsystemAllocators)
+            {
+                subsystemAllocator = allocator;
+            }
+
+            s_initCore(allocator, lazySubsystems);
+        }
+
+        static void s_initApi(TracingAllocator &tracer, bool lazySubsystems)
+        {
+            g_allocator = tracer.GetAllocator(AllocationSubsystem::Crt);
+            s_cJSONAllocator = tracer.GetAllocator(AllocationSubsystem::Json);
+            /* io has no subsystem of its own, its allocations count towards http */
+            s_subsystemAllocators[static_cast<size_t>(ApiSubsystem::Io)] =
+                tracer.GetAllocator(AllocationSubsystem::Http);
+            s_subsystemAllocators[static_cast<size_t>(ApiSubsystem::Http)] =
+                tracer.GetAllocator(AllocationSubsystem::Http);
+            s_subsystemAllocators[static_cast<size_t>(ApiSubsystem::Mqtt)] =
+                tracer.GetAllocator(AllocationSubsystem::Mqtt);
+            s_subsystemAllocators[static_cast<size_t>(ApiSubsystem::Auth)] =
+                tracer.GetAllocator(AllocationSubsystem::Auth);
+            s_subsystemAllocators[static_cast<size_t>(ApiSubsystem::EventStream)] =
+                tracer.GetAllocator(AllocationSubsystem::EventStream);
+
+            s_initCore(g_allocator, lazySubsystems);
+        }
+
+        ApiHandleOptions::ApiHandleOptions() noexcept
+            : EnableThreadCachingPool(false), EnableAllocationTracing(false), LazySubsystemInitialization(false)
+        {
         }
 
         ApiHandle::ApiHandle(Allocator *allocator) noexcept
-            : m_logger(), m_shutdownBehavior(ApiHandleShutdownBehavior::Blocking)
+            : m_logger(), m_asyncLogger(nullptr), m_eventTracer(nullptr),
+              m_shutdownBehavior(ApiHandleShutdownBehavior::Blocking), m_poolAllocator(nullptr),
+              m_tracingParent(nullptr), m_tracingAllocator(nullptr)
         {
-            s_initApi(allocator);
+            s_initApi(allocator, false);
         }
 
-        ApiHandle::ApiHandle() noexcept : m_logger(), m_shutdownBehavior(ApiHandleShutdownBehavior::Blocking)
+        ApiHandle::ApiHandle() noexcept
+            : m_logger(), m_asyncLogger(nullptr), m_eventTracer(nullptr),
+              m_shutdownBehavior(ApiHandleShutdownBehavior::Blocking), m_poolAllocator(nullptr),
+              m_tracingParent(nullptr), m_tracingAllocator(nullptr)
         {
-            s_initApi(DefaultAllocator());
+            s_initApi(DefaultAllocator(), false);
+        }
+
+        ApiHandle::ApiHandle(Allocator *allocator, const ApiHandleOptions &options) noexcept
+            : m_logger(), m_asyncLogger(nullptr), m_eventTracer(nullptr),
+              m_shutdownBehavior(ApiHandleShutdownBehavior::Blocking), m_poolAllocator(nullptr),
+              m_tracingParent(nullptr), m_tracingAllocator(nullptr)
+        {
+            if (options.EnableThreadCachingPool)
+            {
+                m_poolAllocator = PoolAllocator::Create(allocator);
+                if (m_poolAllocator != nullptr)
+                {
+                    allocator = m_poolAllocator->GetUnderlyingHandle();
+                }
+            }
+
+            if (options.EnableAllocationTracing)
+            {
+                m_tracingAllocator = New<TracingAllocator>(allocator, allocator);
+                if (m_tracingAllocator != nullptr)
+                {
+                    m_tracingParent = allocator;
+                    s_initApi(*m_tracingAllocator, options.LazySubsystemInitialization);
+                    return;
+                }
+            }
+
+            s_initApi(allocator, options.LazySubsystemInitialization);
         }
 
         ApiHandle::~ApiHandle()
@@ -62,16 +244,33 @@ namespace Aws
                 aws_thread_join_all_managed();
             }
 
-            if (aws_logger_get() == &m_logger)
+            ShutDownLogging();
+
+            if (m_eventTracer != nullptr)
             {
-                aws_logger_set(NULL);
-                aws_logger_clean_up(&m_logger);
+                DisableEventTracing();
+                EventTracer::Destroy(m_eventTracer);
+                m_eventTracer = nullptr;
             }
 
+            Io::TlsContext::ClearCache();
+
             g_allocator = nullptr;
-            aws_auth_library_clean_up();
-            aws_mqtt_library_clean_up();
-            aws_http_library_clean_up();
+            s_cleanUpSubsystems();
+            s_cJSONAllocator = nullptr;
+
+            if (m_tracingAllocator != nullptr)
+            {
+                Delete(m_tracingAllocator, m_tracingParent);
+                m_tracingAllocator = nullptr;
+            }
+
+            if (m_poolAllocator != nullptr)
+            {
+                /* event-loop threads drop their references to the pool as they exit */
+                m_poolAllocator->Release();
+                m_poolAllocator = nullptr;
+            }
 
             s_BYOCryptoNewMD5Callback = nullptr;
             s_BYOCryptoNewSHA256Callback = nullptr;
@@ -105,24 +304,119 @@ namespace Aws
         }
 
         void ApiHandle::InitializeLoggingCommon(struct aws_logger_standard_options &options)
+        {
+            bool wasLogging = aws_logger_get() == &m_logger ||
+                              (m_asyncLogger != nullptr && aws_logger_get() == m_asyncLogger->GetUnderlyingHandle());
+            ShutDownLogging();
+            if (wasLogging && options.level == AWS_LL_NONE)
+            {
+                return;
+            }
+
+            if (aws_logger_init_standard(&m_logger, g_allocator, &options))
+            {
+                return;
+            }
+
+            aws_logger_set(&m_logger);
+        }
+
+        void ApiHandle::InitializeAsyncLogging(
+            Aws::Crt::LogLevel level,
+            const char *filename,
+            const AsyncLoggerOptions &options)
+        {
+            ShutDownLogging();
+            if (level != LogLevel::None)
+            {
+                InstallAsyncLogger(AsyncLogger::Create(level, filename, options, g_allocator));
+            }
+        }
+
+        void ApiHandle::InitializeAsyncLogging(Aws::Crt::LogLevel level, FILE *fp, const AsyncLoggerOptions &options)
+        {
+            ShutDownLogging();
+            if (level != LogLevel::None)
+            {
+                InstallAsyncLogger(AsyncLogger::Create(level, fp, options, g_allocator));
+            }
+        }
+
+        void ApiHandle::InstallAsyncLogger(AsyncLogger *logger)
+        {
+            if (logger == nullptr)
+            {
+                return;
+            }
+
+            m_asyncLogger = logger;
+            aws_logger_set(m_asyncLogger->GetUnderlyingHandle());
+        }
+
+        void ApiHandle::ShutDownLogging()
         {
             if (aws_logger_get() == &m_logger)
             {
                 aws_logger_set(NULL);
                 aws_logger_clean_up(&m_logger);
-                if (options.level == AWS_LL_NONE)
+                AWS_ZERO_STRUCT(m_logger);
+            }
+
+            if (m_asyncLogger != nullptr)
+            {
+                if (aws_logger_get() == m_asyncLogger->GetUnderlyingHandle())
                 {
-                    AWS_ZERO_STRUCT(m_logger);
-                    return;
+                    aws_logger_set(NULL);
                 }
+
+                /* writes out whatever is still queued */
+                AsyncLogger::Destroy(m_asyncLogger);
+                m_asyncLogger = nullptr;
             }
+        }
 
-            if (aws_logger_init_standard(&m_logger, g_allocator, &options))
+        EventTracer *ApiHandle::EnableEventTracing(size_t eventsPerThread)
+        {
+            if (m_eventTracer == nullptr)
+            {
+                m_eventTracer = EventTracer::Create(eventsPerThread, g_allocator);
+                if (m_eventTracer == nullptr)
+                {
+                    return nullptr;
+                }
+            }
+
+            EventTracer::SetActive(m_eventTracer);
+            return m_eventTracer;
+        }
+
+        void ApiHandle::DisableEventTracing()
+        {
+            if (m_eventTracer != nullptr && EventTracer::GetActive() == m_eventTracer)
+            {
+                EventTracer::SetActive(nullptr);
+            }
+        }
+
+        void ApiHandle::InitializeSubsystem(ApiSubsystem subsystem) noexcept
+        {
+            if (IsSubsystemInitialized(subsystem))
             {
                 return;
             }
 
-            aws_logger_set(&m_logger);
+            std::lock_guard<std::mutex> lock(s_subsystemLock);
+            if (s_subsystemAllocators[0] == nullptr || static_cast<size_t>(subsystem) >= s_subsystemCount)
+            {
+                return;
+            }
+
+            s_initSubsystemLocked(subsystem);
+        }
+
+        bool ApiHandle::IsSubsystemInitialized(ApiSubsystem subsystem) noexcept
+        {
+            return (s_initializedSubsystems.load(std::memory_order_acquire) & s_subsystemBit(subsystem)) != 0;
         }
 
         void ApiHandle::SetShutdownBehavior(ApiHandleShutdownBehavior behavior) { m_shutdownBehavior = behavior; }
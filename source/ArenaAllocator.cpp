@@ -0,0 +1,180 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/ArenaAllocator.h>
+
+#include <aws/common/math.h>
+
+#include <cstring>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        static const size_t s_arenaAlignment = alignof(std::max_align_t);
+
+        static size_t s_alignUp(size_t size) noexcept
+        {
+            return (size + s_arenaAlignment - 1) & ~(s_arenaAlignment - 1);
+        }
+
+        struct ArenaAllocator::Block
+        {
+            Block *next;
+            size_t capacity;
+            size_t used;
+
+            uint8_t *Data() noexcept { return reinterpret_cast<uint8_t *>(this) + s_alignUp(sizeof(Block)); }
+        };
+
+        const size_t ArenaAllocator::DefaultBlockSize;
+
+        ArenaAllocator::ArenaAllocator(size_t blockSize, Allocator *parent) noexcept
+            : m_parent(parent), m_blockSize(s_alignUp(blockSize ? blockSize : DefaultBlockSize)), m_head(nullptr),
+              m_lastAllocation(nullptr), m_bytesAllocated(0), m_bytesReserved(0)
+        {
+            AWS_ZERO_STRUCT(m_allocator);
+            m_allocator.mem_acquire = s_MemAcquire;
+            m_allocator.mem_release = s_MemRelease;
+            m_allocator.mem_realloc = s_MemRealloc;
+            m_allocator.mem_calloc = s_MemCalloc;
+            m_allocator.impl = this;
+        }
+
+        ArenaAllocator::~ArenaAllocator() { Reset(); }
+
+        void ArenaAllocator::Reset() noexcept
+        {
+            Mark empty = {nullptr, 0, 0};
+            Rewind(empty);
+        }
+
+        void *ArenaAllocator::Acquire(size_t size) noexcept
+        {
+            size_t alignedSize = s_alignUp(size);
+            if (alignedSize < size)
+            {
+                aws_raise_error(AWS_ERROR_OOM);
+                return nullptr;
+            }
+
+            if (m_head == nullptr || m_head->capacity - m_head->used < alignedSize)
+            {
+                size_t capacity = alignedSize > m_blockSize ? alignedSize : m_blockSize;
+                size_t blockBytes = 0;
+                if (aws_add_size_checked(s_alignUp(sizeof(Block)), capacity, &blockBytes))
+                {
+                    return nullptr;
+                }
+
+                auto *block = static_cast<Block *>(aws_mem_acquire(m_parent, blockBytes));
+                if (block == nullptr)
+                {
+                    return nullptr;
+                }
+
+                block->next = m_head;
+                block->capacity = capacity;
+                block->used = 0;
+                m_head = block;
+                m_bytesReserved += blockBytes;
+            }
+
+            void *mem = m_head->Data() + m_head->used;
+            m_head->used += alignedSize;
+            m_bytesAllocated += alignedSize;
+            m_lastAllocation = mem;
+            return mem;
+        }
+
+        void *ArenaAllocator::Realloc(void *ptr, size_t oldSize, size_t newSize) noexcept
+        {
+            /* the most recent allocation can be resized in place as long as it still fits its block */
+            if (ptr != nullptr && ptr == m_lastAllocation)
+            {
+                size_t oldAligned = s_alignUp(oldSize);
+                size_t newAligned = s_alignUp(newSize);
+                size_t offset = static_cast<uint8_t *>(ptr) - m_head->Data();
+                if (newAligned >= newSize && offset + newAligned <= m_head->capacity)
+                {
+                    m_head->used = offset + newAligned;
+                    m_bytesAllocated = m_bytesAllocated - oldAligned + newAligned;
+                    return ptr;
+                }
+            }
+
+            void *mem = Acquire(newSize);
+            if (mem != nullptr && ptr != nullptr)
+            {
+                memcpy(mem, ptr, oldSize < newSize ? oldSize : newSize);
+            }
+
+            return mem;
+        }
+
+        ArenaAllocator::Mark ArenaAllocator::GetMark() const noexcept
+        {
+            Mark mark = {m_head, m_head ? m_head->used : 0, m_bytesAllocated};
+            return mark;
+        }
+
+        void ArenaAllocator::Rewind(const Mark &mark) noexcept
+        {
+            while (m_head != nullptr && m_head != mark.block)
+            {
+                Block *next = m_head->next;
+                m_bytesReserved -= s_alignUp(sizeof(Block)) + m_head->capacity;
+                aws_mem_release(m_parent, m_head);
+                m_head = next;
+            }
+
+            if (m_head != nullptr)
+            {
+                m_head->used = mark.used;
+            }
+
+            m_bytesAllocated = mark.bytesAllocated;
+            m_lastAllocation = nullptr;
+        }
+
+        void *ArenaAllocator::s_MemAcquire(Allocator *allocator, size_t size)
+        {
+            auto *arena = static_cast<ArenaAllocator *>(allocator->impl);
+            return arena->Acquire(size);
+        }
+
+        void ArenaAllocator::s_MemRelease(Allocator *, void *)
+        {
+            /* individual releases are deferred until Reset(), scope exit, or destruction. */
+        }
+
+        void *ArenaAllocator::s_MemRealloc(Allocator *allocator, void *ptr, size_t oldSize, size_t newSize)
+        {
+            auto *arena = static_cast<ArenaAllocator *>(allocator->impl);
+            return arena->Realloc(ptr, oldSize, newSize);
+        }
+
+        void *ArenaAllocator::s_MemCalloc(Allocator *allocator, size_t num, size_t size)
+        {
+            size_t total = 0;
+            if (aws_mul_size_checked(num, size, &total))
+            {
+                return nullptr;
+            }
+
+            auto *arena = static_cast<ArenaAllocator *>(allocator->impl);
+            void *mem = arena->Acquire(total);
+            if (mem != nullptr)
+            {
+                memset(mem, 0, total);
+            }
+
+            return mem;
+        }
+
+        ArenaScope::ArenaScope(ArenaAllocator &arena) noexcept : m_arena(arena), m_mark(arena.GetMark()) {}
+
+        ArenaScope::~ArenaScope() { m_arena.Rewind(m_mark); }
+    } // namespace Crt
+} // namespace Aws
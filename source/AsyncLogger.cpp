@@ -0,0 +1,506 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/Api.h>
+#include <aws/crt/AsyncLogger.h>
+#include <aws/crt/DateTime.h>
+
+#include <aws/common/file.h>
+#include <aws/common/thread.h>
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstring>
+#include <new>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        /**
+         * One thread's lines on their way to the writer. The thread only moves head and the writer only moves
+         * tail, so neither side takes a lock.
+         */
+        struct AsyncLogRing
+        {
+            AsyncLogRing() noexcept
+                : head(0), tail(0), dropped(0), abandoned(false), wakeRequested(false), reportedDrops(0),
+                  retired(false), slots(nullptr), next(nullptr)
+            {
+                threadId[0] = '\0';
+            }
+
+            std::atomic<uint64_t> head;
+            /* keeps the producer's and the writer's index off one cache line */
+            char padding[64];
+            std::atomic<uint64_t> tail;
+
+            std::atomic<uint64_t> dropped;
+            /* set once the thread exited or moved to another logger; the writer frees the ring after draining */
+            std::atomic<bool> abandoned;
+            std::atomic<bool> wakeRequested;
+            uint64_t reportedDrops;
+            /* seen abandoned and drained, only used by the writer */
+            bool retired;
+
+            /* each slot is a uint32_t length followed by the line */
+            uint8_t *slots;
+            char threadId[AWS_THREAD_ID_T_REPR_BUFSZ];
+            AsyncLogRing *next;
+        };
+
+        static std::atomic<uint64_t> s_nextLoggerId(1);
+        static std::mutex s_liveLoggersLock;
+        static AsyncLogger *s_liveLoggers = nullptr;
+
+        /**
+         * The ring the current thread logs into. Rings belong to their logger; a thread only hands its ring back,
+         * on exit or when it logs to a different logger, if that logger is still alive.
+         */
+        struct AsyncLogThreadState
+        {
+            ~AsyncLogThreadState() { Release(); }
+
+            void Release() noexcept
+            {
+                if (ring == nullptr)
+                {
+                    return;
+                }
+
+                std::lock_guard<std::mutex> lock(s_liveLoggersLock);
+                for (AsyncLogger *logger = s_liveLoggers; logger != nullptr; logger = logger->m_nextLive)
+                {
+                    if (logger->m_id == loggerId)
+                    {
+                        ring->abandoned.store(true, std::memory_order_release);
+                        break;
+                    }
+                }
+
+                ring = nullptr;
+                loggerId = 0;
+            }
+
+            uint64_t loggerId = 0;
+            AsyncLogRing *ring = nullptr;
+        };
+
+        static thread_local AsyncLogThreadState s_threadLogState;
+
+        static const size_t s_slotHeaderSize = sizeof(uint32_t);
+        static const size_t s_minLineLength = 128;
+
+        aws_logger_vtable AsyncLogger::s_vtable = {
+            AsyncLogger::s_Log,
+            AsyncLogger::s_GetLogLevel,
+            AsyncLogger::s_CleanUp,
+        };
+
+        static size_t s_roundUpToPowerOfTwo(size_t value) noexcept
+        {
+            size_t rounded = 1;
+            while (rounded < value)
+            {
+                rounded <<= 1;
+            }
+
+            return rounded;
+        }
+
+        AsyncLogger::AsyncLogger(
+            LogLevel level,
+            FILE *fp,
+            bool ownsFile,
+            const AsyncLoggerOptions &options,
+            Allocator *allocator) noexcept
+            : m_logger(), m_allocator(allocator), m_id(s_nextLoggerId.fetch_add(1)), m_file(fp),
+              m_ownsFile(ownsFile), m_ringCapacity(s_roundUpToPowerOfTwo(options.RingCapacity)),
+              m_lineLength(options.MaxLineLength < s_minLineLength ? s_minLineLength : options.MaxLineLength),
+              m_flushIntervalMs(options.FlushIntervalMs == 0 ? 1 : options.FlushIntervalMs),
+              m_level(static_cast<int>(level)), m_rings(nullptr), m_retiredDrops(0), m_stopping(false),
+              m_flushRequests(0), m_flushesDone(0), m_nextLive(nullptr)
+        {
+            m_logger.vtable = &s_vtable;
+            m_logger.allocator = allocator;
+            m_logger.p_impl = this;
+        }
+
+        AsyncLogger::~AsyncLogger()
+        {
+            {
+                /* from here on, exiting threads leave their rings alone */
+                std::lock_guard<std::mutex> lock(s_liveLoggersLock);
+                for (AsyncLogger **link = &s_liveLoggers; *link != nullptr; link = &(*link)->m_nextLive)
+                {
+                    if (*link == this)
+                    {
+                        *link = m_nextLive;
+                        break;
+                    }
+                }
+            }
+
+            if (m_writer.joinable())
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_writerLock);
+                    m_stopping = true;
+                }
+                m_writerSignal.notify_one();
+                m_writer.join();
+            }
+
+            AsyncLogRing *ring = m_rings;
+            while (ring != nullptr)
+            {
+                AsyncLogRing *next = ring->next;
+                aws_mem_release(m_allocator, ring->slots);
+                Delete(ring, m_allocator);
+                ring = next;
+            }
+
+            if (m_ownsFile)
+            {
+                fclose(m_file);
+            }
+        }
+
+        AsyncLogger *AsyncLogger::s_Create(
+            LogLevel level,
+            FILE *fp,
+            bool ownsFile,
+            const AsyncLoggerOptions &options,
+            Allocator *allocator) noexcept
+        {
+            void *mem = aws_mem_acquire(allocator, sizeof(AsyncLogger));
+            if (mem == nullptr)
+            {
+                return nullptr;
+            }
+
+            AsyncLogger *logger = new (mem) AsyncLogger(level, fp, ownsFile, options, allocator);
+            {
+                std::lock_guard<std::mutex> lock(s_liveLoggersLock);
+                logger->m_nextLive = s_liveLoggers;
+                s_liveLoggers = logger;
+            }
+
+            logger->m_writer = std::thread([logger]() { logger->RunWriter(); });
+            return logger;
+        }
+
+        AsyncLogger *AsyncLogger::Create(
+            LogLevel level,
+            const char *filename,
+            const AsyncLoggerOptions &options,
+            Allocator *allocator) noexcept
+        {
+            FILE *fp = aws_fopen(filename, "a");
+            if (fp == nullptr)
+            {
+                return nullptr;
+            }
+
+            AsyncLogger *logger = s_Create(level, fp, true, options, allocator);
+            if (logger == nullptr)
+            {
+                fclose(fp);
+            }
+
+            return logger;
+        }
+
+        AsyncLogger *AsyncLogger::Create(
+            LogLevel level,
+            FILE *fp,
+            const AsyncLoggerOptions &options,
+            Allocator *allocator) noexcept
+        {
+            if (fp == nullptr)
+            {
+                aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                return nullptr;
+            }
+
+            return s_Create(level, fp, false, options, allocator);
+        }
+
+        void AsyncLogger::Destroy(AsyncLogger *logger) noexcept
+        {
+            if (logger == nullptr)
+            {
+                return;
+            }
+
+            Allocator *allocator = logger->m_allocator;
+            logger->~AsyncLogger();
+            aws_mem_release(allocator, logger);
+        }
+
+        LogLevel AsyncLogger::GetLogLevel() const noexcept
+        {
+            return static_cast<LogLevel>(m_level.load(std::memory_order_relaxed));
+        }
+
+        void AsyncLogger::SetLogLevel(LogLevel level) noexcept
+        {
+            m_level.store(static_cast<int>(level), std::memory_order_relaxed);
+        }
+
+        uint64_t AsyncLogger::GetDroppedCount() const noexcept
+        {
+            std::lock_guard<std::mutex> lock(m_ringsLock);
+            uint64_t dropped = m_retiredDrops.load(std::memory_order_relaxed);
+            for (AsyncLogRing *ring = m_rings; ring != nullptr; ring = ring->next)
+            {
+                dropped += ring->dropped.load(std::memory_order_relaxed);
+            }
+
+            return dropped;
+        }
+
+        void AsyncLogger::Flush() noexcept
+        {
+            std::unique_lock<std::mutex> lock(m_writerLock);
+            uint64_t target = ++m_flushRequests;
+            m_writerSignal.notify_one();
+            m_flushSignal.wait(lock, [this, target]() { return m_flushesDone >= target; });
+        }
+
+        AsyncLogRing *AsyncLogger::GetThreadRing() noexcept
+        {
+            if (s_threadLogState.loggerId == m_id)
+            {
+                return s_threadLogState.ring;
+            }
+
+            s_threadLogState.Release();
+
+            AsyncLogRing *ring = New<AsyncLogRing>(m_allocator);
+            if (ring == nullptr)
+            {
+                return nullptr;
+            }
+
+            ring->slots = static_cast<uint8_t *>(
+                aws_mem_acquire(m_allocator, m_ringCapacity * (s_slotHeaderSize + m_lineLength)));
+            if (ring->slots == nullptr)
+            {
+                Delete(ring, m_allocator);
+                return nullptr;
+            }
+
+            aws_thread_id_t_to_string(aws_thread_current_thread_id(), ring->threadId, AWS_THREAD_ID_T_REPR_BUFSZ);
+
+            {
+                std::lock_guard<std::mutex> lock(m_ringsLock);
+                ring->next = m_rings;
+                m_rings = ring;
+            }
+
+            s_threadLogState.loggerId = m_id;
+            s_threadLogState.ring = ring;
+            return ring;
+        }
+
+        int AsyncLogger::s_Log(
+            aws_logger *logger,
+            enum aws_log_level logLevel,
+            aws_log_subject_t subject,
+            const char *format,
+            ...)
+        {
+            auto *self = static_cast<AsyncLogger *>(logger->p_impl);
+            AsyncLogRing *ring = self->GetThreadRing();
+            if (ring == nullptr)
+            {
+                return AWS_OP_ERR;
+            }
+
+            uint64_t head = ring->head.load(std::memory_order_relaxed);
+            uint64_t tail = ring->tail.load(std::memory_order_acquire);
+            if (head - tail >= self->m_ringCapacity)
+            {
+                ring->dropped.fetch_add(1, std::memory_order_relaxed);
+                return AWS_OP_SUCCESS;
+            }
+
+            uint8_t *slot = ring->slots + (head & (self->m_ringCapacity - 1)) * (s_slotHeaderSize + self->m_lineLength);
+            char *line = reinterpret_cast<char *>(slot + s_slotHeaderSize);
+
+            const char *levelString = nullptr;
+            if (aws_log_level_to_string(logLevel, &levelString))
+            {
+                levelString = "UNKNOWN";
+            }
+
+            char timestamp[DateTime::MaxGmtStringLength + 1];
+            size_t timestampLength = 0;
+            if (!DateTime::NowToGmtString(DateFormat::ISO_8601, timestamp, sizeof(timestamp), timestampLength))
+            {
+                timestampLength = 0;
+            }
+            timestamp[timestampLength] = '\0';
+
+            /* one byte is kept back for the newline */
+            size_t capacity = self->m_lineLength - 1;
+            int prefix = snprintf(
+                line,
+                capacity,
+                "[%s] [%s] [%s] [%s] - ",
+                levelString,
+                timestamp,
+                ring->threadId,
+                aws_log_subject_name(subject));
+            size_t length = prefix < 0 ? 0 : (std::min)(static_cast<size_t>(prefix), capacity - 1);
+
+            va_list args;
+            va_start(args, format);
+            int message = vsnprintf(line + length, capacity - length, format, args);
+            va_end(args);
+            length += message < 0 ? 0 : (std::min)(static_cast<size_t>(message), capacity - length - 1);
+
+            line[length++] = '\n';
+            uint32_t slotLength = static_cast<uint32_t>(length);
+            memcpy(slot, &slotLength, sizeof(slotLength));
+
+            ring->head.store(head + 1, std::memory_order_release);
+
+            /* wake the writer early, once, rather than letting a burst run into a full ring */
+            if ((head + 1 - tail) * 4 >= self->m_ringCapacity * 3 &&
+                !ring->wakeRequested.exchange(true, std::memory_order_relaxed))
+            {
+                self->m_writerSignal.notify_one();
+            }
+
+            return AWS_OP_SUCCESS;
+        }
+
+        enum aws_log_level AsyncLogger::s_GetLogLevel(aws_logger *logger, aws_log_subject_t subject)
+        {
+            (void)subject;
+            auto *self = static_cast<AsyncLogger *>(logger->p_impl);
+            return static_cast<enum aws_log_level>(self->m_level.load(std::memory_order_relaxed));
+        }
+
+        void AsyncLogger::s_CleanUp(aws_logger *logger)
+        {
+            /* the AsyncLogger owns everything, Destroy() releases it */
+            (void)logger;
+        }
+
+        void AsyncLogger::DrainRings() noexcept
+        {
+            const size_t slotSize = s_slotHeaderSize + m_lineLength;
+
+            /*
+             * New rings only ever go in at the front and only the writer unlinks them, so the list as it stands now
+             * can be walked and written out without holding up threads registering a ring or reading the drop count.
+             */
+            AsyncLogRing *first = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(m_ringsLock);
+                first = m_rings;
+            }
+
+            bool anyRetired = false;
+            for (AsyncLogRing *ring = first; ring != nullptr; ring = ring->next)
+            {
+                /* read before head, so an abandoned ring is seen with every line its thread wrote */
+                bool abandoned = ring->abandoned.load(std::memory_order_acquire);
+                uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+                uint64_t head = ring->head.load(std::memory_order_acquire);
+                for (; tail != head; ++tail)
+                {
+                    const uint8_t *slot = ring->slots + (tail & (m_ringCapacity - 1)) * slotSize;
+                    uint32_t length = 0;
+                    memcpy(&length, slot, sizeof(length));
+                    fwrite(slot + s_slotHeaderSize, 1, length, m_file);
+                }
+                ring->tail.store(tail, std::memory_order_release);
+                ring->wakeRequested.store(false, std::memory_order_relaxed);
+
+                uint64_t dropped = ring->dropped.load(std::memory_order_relaxed);
+                if (dropped != ring->reportedDrops)
+                {
+                    fprintf(
+                        m_file,
+                        "[WARN] [async logger] - thread %s dropped %llu lines, its ring was full\n",
+                        ring->threadId,
+                        static_cast<unsigned long long>(dropped - ring->reportedDrops));
+                    ring->reportedDrops = dropped;
+                }
+
+                ring->retired = abandoned;
+                anyRetired = anyRetired || abandoned;
+            }
+
+            if (!anyRetired)
+            {
+                return;
+            }
+
+            AsyncLogRing *retired = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(m_ringsLock);
+                AsyncLogRing **link = &m_rings;
+                while (*link != nullptr)
+                {
+                    AsyncLogRing *ring = *link;
+                    if (!ring->retired)
+                    {
+                        link = &ring->next;
+                        continue;
+                    }
+
+                    m_retiredDrops.fetch_add(ring->dropped.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                    *link = ring->next;
+                    ring->next = retired;
+                    retired = ring;
+                }
+            }
+
+            while (retired != nullptr)
+            {
+                AsyncLogRing *next = retired->next;
+                aws_mem_release(m_allocator, retired->slots);
+                Delete(retired, m_allocator);
+                retired = next;
+            }
+        }
+
+        void AsyncLogger::RunWriter() noexcept
+        {
+            while (true)
+            {
+                bool stopping = false;
+                uint64_t flushTarget = 0;
+                {
+                    std::unique_lock<std::mutex> lock(m_writerLock);
+                    if (!m_stopping && m_flushRequests == m_flushesDone)
+                    {
+                        m_writerSignal.wait_for(lock, std::chrono::milliseconds(m_flushIntervalMs));
+                    }
+                    stopping = m_stopping;
+                    flushTarget = m_flushRequests;
+                }
+
+                DrainRings();
+                fflush(m_file);
+
+                {
+                    std::lock_guard<std::mutex> lock(m_writerLock);
+                    m_flushesDone = flushTarget;
+                }
+                m_flushSignal.notify_all();
+
+                if (stopping)
+                {
+                    return;
+                }
+            }
+        }
+    } // namespace Crt
+} // namespace Aws
@@ -5,11 +5,14 @@
 #include <aws/crt/DateTime.h>
 
 #include <chrono>
+#include <cstring>
 
 namespace Aws
 {
     namespace Crt
     {
+        const size_t DateTime::MaxGmtStringLength;
+
         DateTime::DateTime() noexcept : m_good(true)
         {
             std::chrono::system_clock::time_point time;
@@ -134,11 +137,199 @@ namespace Aws
                 AWS_ERROR_SUCCESS);
         }
 
+        static const size_t s_Rfc822Length = 29;
+        static const size_t s_Iso8601Length = 20;
+
+        /* where the seconds sit in "Wed, 02 Oct 2002 08:05:09 GMT" and "2002-10-02T08:05:09Z" */
+        static const size_t s_Rfc822SecondsOffset = 23;
+        static const size_t s_Iso8601SecondsOffset = 17;
+
+        /* The minute last formatted on a thread, in both formats. Only the seconds differ within it. */
+        struct GmtStringCache
+        {
+            bool valid;
+            int64_t minute;
+            char rfc822[s_Rfc822Length];
+            char iso8601[s_Iso8601Length];
+        };
+
+        static thread_local GmtStringCache s_gmtStringCache;
+
+        static const char *const s_dayNames[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+        static const char *const s_monthNames[] =
+            {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+        static int64_t s_FloorDivide(int64_t value, int64_t divisor)
+        {
+            int64_t quotient = value / divisor;
+            return (value % divisor != 0 && value < 0) ? quotient - 1 : quotient;
+        }
+
+        static void s_WriteTwoDigits(char *out, int64_t value)
+        {
+            out[0] = static_cast<char>('0' + value / 10);
+            out[1] = static_cast<char>('0' + value % 10);
+        }
+
+        static void s_WriteName(char *out, const char *name)
+        {
+            out[0] = name[0];
+            out[1] = name[1];
+            out[2] = name[2];
+        }
+
+        /* Renders the minute in both formats, with zero seconds. False for years that take more than 4 digits. */
+        static bool s_RenderMinute(int64_t minute, GmtStringCache &cache)
+        {
+            int64_t days = s_FloorDivide(minute, 24 * 60);
+            int64_t minuteOfDay = minute - days * 24 * 60;
+
+            /* civil date from days since the epoch, in the proleptic Gregorian calendar */
+            int64_t shifted = days + 719468;
+            int64_t era = s_FloorDivide(shifted, 146097);
+            int64_t dayOfEra = shifted - era * 146097;
+            int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+            int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+            int64_t shiftedMonth = (5 * dayOfYear + 2) / 153;
+            int64_t day = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+            int64_t month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+            int64_t year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+            if (year < 0 || year > 9999)
+            {
+                return false;
+            }
+
+            /* the epoch was a Thursday */
+            int64_t dayOfWeek = days - s_FloorDivide(days + 4, 7) * 7 + 4;
+            int64_t hour = minuteOfDay / 60;
+            int64_t minuteOfHour = minuteOfDay % 60;
+
+            char *rfc822 = cache.rfc822;
+            s_WriteName(rfc822, s_dayNames[dayOfWeek]);
+            rfc822[3] = ',';
+            rfc822[4] = ' ';
+            s_WriteTwoDigits(rfc822 + 5, day);
+            rfc822[7] = ' ';
+            s_WriteName(rfc822 + 8, s_monthNames[month - 1]);
+            rfc822[11] = ' ';
+            s_WriteTwoDigits(rfc822 + 12, year / 100);
+            s_WriteTwoDigits(rfc822 + 14, year % 100);
+            rfc822[16] = ' ';
+            s_WriteTwoDigits(rfc822 + 17, hour);
+            rfc822[19] = ':';
+            s_WriteTwoDigits(rfc822 + 20, minuteOfHour);
+            rfc822[22] = ':';
+            s_WriteTwoDigits(rfc822 + s_Rfc822SecondsOffset, 0);
+            rfc822[25] = ' ';
+            s_WriteName(rfc822 + 26, "GMT");
+
+            char *iso8601 = cache.iso8601;
+            s_WriteTwoDigits(iso8601, year / 100);
+            s_WriteTwoDigits(iso8601 + 2, year % 100);
+            iso8601[4] = '-';
+            s_WriteTwoDigits(iso8601 + 5, month);
+            iso8601[7] = '-';
+            s_WriteTwoDigits(iso8601 + 8, day);
+            iso8601[10] = 'T';
+            s_WriteTwoDigits(iso8601 + 11, hour);
+            iso8601[13] = ':';
+            s_WriteTwoDigits(iso8601 + 14, minuteOfHour);
+            iso8601[16] = ':';
+            s_WriteTwoDigits(iso8601 + s_Iso8601SecondsOffset, 0);
+            iso8601[19] = 'Z';
+
+            cache.minute = minute;
+            cache.valid = true;
+            return true;
+        }
+
+        static bool s_FormatGmt(
+            int64_t secondsSinceEpoch,
+            DateFormat format,
+            char *buffer,
+            size_t bufferSize,
+            size_t &length) noexcept
+        {
+            if (format != DateFormat::RFC822 && format != DateFormat::ISO_8601)
+            {
+                aws_raise_error(AWS_ERROR_INVALID_DATE_STR);
+                return false;
+            }
+
+            size_t formatLength = format == DateFormat::RFC822 ? s_Rfc822Length : s_Iso8601Length;
+            if (bufferSize < formatLength)
+            {
+                aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+                return false;
+            }
+
+            int64_t minute = s_FloorDivide(secondsSinceEpoch, 60);
+            GmtStringCache &cache = s_gmtStringCache;
+            if ((!cache.valid || cache.minute != minute) && !s_RenderMinute(minute, cache))
+            {
+                aws_raise_error(AWS_ERROR_INVALID_DATE_STR);
+                return false;
+            }
+
+            int64_t second = secondsSinceEpoch - minute * 60;
+            if (format == DateFormat::RFC822)
+            {
+                memcpy(buffer, cache.rfc822, s_Rfc822Length);
+                s_WriteTwoDigits(buffer + s_Rfc822SecondsOffset, second);
+            }
+            else
+            {
+                memcpy(buffer, cache.iso8601, s_Iso8601Length);
+                s_WriteTwoDigits(buffer + s_Iso8601SecondsOffset, second);
+            }
+
+            length = formatLength;
+            return true;
+        }
+
         bool DateTime::ToGmtString(DateFormat format, ByteBuf &outputBuf) const noexcept
         {
-            return (
-                aws_date_time_to_utc_time_str(&m_date_time, static_cast<aws_date_format>(format), &outputBuf) ==
-                AWS_ERROR_SUCCESS);
+            if (format != DateFormat::RFC822 && format != DateFormat::ISO_8601)
+            {
+                return (
+                    aws_date_time_to_utc_time_str(&m_date_time, static_cast<aws_date_format>(format), &outputBuf) ==
+                    AWS_ERROR_SUCCESS);
+            }
+
+            size_t length = 0;
+            if (!ToGmtString(
+                    format,
+                    reinterpret_cast<char *>(outputBuf.buffer + outputBuf.len),
+                    outputBuf.capacity - outputBuf.len,
+                    length))
+            {
+                /* years of five digits and more are left to strftime */
+                return aws_last_error() == AWS_ERROR_INVALID_DATE_STR &&
+                       aws_date_time_to_utc_time_str(
+                           &m_date_time, static_cast<aws_date_format>(format), &outputBuf) == AWS_ERROR_SUCCESS;
+            }
+
+            outputBuf.len += length;
+            return true;
+        }
+
+        bool DateTime::ToGmtString(DateFormat format, char *buffer, size_t bufferSize, size_t &length) const noexcept
+        {
+            return s_FormatGmt(static_cast<int64_t>(m_date_time.timestamp), format, buffer, bufferSize, length);
+        }
+
+        bool DateTime::NowToGmtString(DateFormat format, char *buffer, size_t bufferSize, size_t &length) noexcept
+        {
+            auto sinceEpoch = std::chrono::system_clock::now().time_since_epoch();
+            auto wholeSeconds = std::chrono::duration_cast<std::chrono::seconds>(sinceEpoch);
+            int64_t seconds = static_cast<int64_t>(wholeSeconds.count());
+            /* duration_cast truncates towards zero, a time before the epoch still belongs to the earlier second */
+            if (wholeSeconds > sinceEpoch)
+            {
+                --seconds;
+            }
+
+            return s_FormatGmt(seconds, format, buffer, bufferSize, length);
         }
 
         double DateTime::SecondsWithMSPrecision() const noexcept { return aws_date_time_as_epoch_secs(&m_date_time); }
@@ -0,0 +1,429 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/EventTracer.h>
+#include <aws/crt/JsonWriter.h>
+
+#include <aws/common/clock.h>
+#include <aws/common/process.h>
+#include <aws/common/thread.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <new>
+#include <thread>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        /**
+         * One recorded event. Fields are relaxed atomics so the slot can be read while its thread overwrites it;
+         * sequence is odd while the slot is being written and 2 * (position + 1) once event number position is in.
+         */
+        struct EventTraceSlot
+        {
+            EventTraceSlot() noexcept : sequence(0), timestampNs(0), id(0), value(0), kind(0) {}
+
+            std::atomic<uint64_t> sequence;
+            std::atomic<uint64_t> timestampNs;
+            std::atomic<uint64_t> id;
+            std::atomic<int64_t> value;
+            /* the type in the low byte, the phase in the next one */
+            std::atomic<uint32_t> kind;
+        };
+
+        /**
+         * One thread's events. Only that thread moves head, readers copy slots out and check their sequence.
+         */
+        struct EventTraceRing
+        {
+            EventTraceRing() noexcept : head(0), slots(nullptr), index(0), next(nullptr) { threadId[0] = '\0'; }
+
+            std::atomic<uint64_t> head;
+            EventTraceSlot *slots;
+            uint32_t index;
+            char threadId[AWS_THREAD_ID_T_REPR_BUFSZ];
+            EventTraceRing *next;
+        };
+
+        static std::atomic<uint64_t> s_nextTracerId(1);
+        static std::atomic<EventTracer *> s_activeTracer(nullptr);
+
+        /*
+         * Record() counts itself in for as long as it may touch the tracer it loaded, in the slot of the generation
+         * it started in. SetActive() moves on to the next generation and waits for the previous one's slot to
+         * drain, so once it returns nothing is recording into the tracer it replaced. New recorders count in the
+         * other slot meanwhile, so a steady stream of them cannot hold it up.
+         */
+        static std::mutex s_setActiveLock;
+        static std::atomic<uint32_t> s_recorderGeneration(0);
+        static std::atomic<uint32_t> s_recordersInFlight[2];
+
+        /**
+         * The ring the current thread records into. Rings belong to their tracer and outlive the thread, so the
+         * thread only has to remember which tracer its ring is from.
+         */
+        struct EventTraceThreadState
+        {
+            uint64_t tracerId = 0;
+            EventTraceRing *ring = nullptr;
+        };
+
+        static thread_local EventTraceThreadState s_threadTraceState;
+
+        static const size_t s_minEventsPerThread = 16;
+
+        static size_t s_roundUpToPowerOfTwo(size_t value) noexcept
+        {
+            size_t rounded = 1;
+            while (rounded < value)
+            {
+                rounded <<= 1;
+            }
+
+            return rounded;
+        }
+
+        EventTracer::EventTracer(size_t eventsPerThread, Allocator *allocator) noexcept
+            : m_allocator(allocator), m_id(s_nextTracerId.fetch_add(1)),
+              m_ringCapacity(s_roundUpToPowerOfTwo(std::max(eventsPerThread, s_minEventsPerThread))),
+              m_createdTimestampNs(0), m_rings(nullptr), m_ringCount(0)
+        {
+            aws_high_res_clock_get_ticks(&m_createdTimestampNs);
+        }
+
+        EventTracer::~EventTracer()
+        {
+            EventTraceRing *ring = m_rings;
+            while (ring != nullptr)
+            {
+                EventTraceRing *next = ring->next;
+                for (size_t i = 0; i < m_ringCapacity; ++i)
+                {
+                    ring->slots[i].~EventTraceSlot();
+                }
+                aws_mem_release(m_allocator, ring->slots);
+                Delete(ring, m_allocator);
+                ring = next;
+            }
+        }
+
+        EventTracer *EventTracer::Create(size_t eventsPerThread, Allocator *allocator) noexcept
+        {
+            void *mem = aws_mem_acquire(allocator, sizeof(EventTracer));
+            if (mem == nullptr)
+            {
+                return nullptr;
+            }
+
+            return new (mem) EventTracer(eventsPerThread, allocator);
+        }
+
+        void EventTracer::Destroy(EventTracer *tracer) noexcept
+        {
+            if (tracer == nullptr)
+            {
+                return;
+            }
+
+            /* SetActive() has waited out every recorder of a tracer by the time it is no longer active */
+            AWS_FATAL_ASSERT(s_activeTracer.load() != tracer);
+            Allocator *allocator = tracer->m_allocator;
+            tracer->~EventTracer();
+            aws_mem_release(allocator, tracer);
+        }
+
+        void EventTracer::SetActive(EventTracer *tracer) noexcept
+        {
+            std::lock_guard<std::mutex> lock(s_setActiveLock);
+            EventTracer *previous = s_activeTracer.exchange(tracer);
+            if (previous == nullptr || previous == tracer)
+            {
+                return;
+            }
+
+            uint32_t generation = s_recorderGeneration.fetch_add(1);
+            while (s_recordersInFlight[generation & 1].load() != 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        EventTracer *EventTracer::GetActive() noexcept { return s_activeTracer.load(); }
+
+        void EventTracer::Record(TraceEventType type, TraceEventPhase phase, uint64_t id, int64_t value) noexcept
+        {
+            /* a quick look first, so recording without an active tracer stays a single load */
+            if (s_activeTracer.load(std::memory_order_relaxed) == nullptr)
+            {
+                return;
+            }
+
+            /* count in under a generation that is still current afterwards, or SetActive() may not wait for us */
+            std::atomic<uint32_t> *inFlight = nullptr;
+            while (true)
+            {
+                uint32_t generation = s_recorderGeneration.load();
+                inFlight = &s_recordersInFlight[generation & 1];
+                inFlight->fetch_add(1);
+                if (s_recorderGeneration.load() == generation)
+                {
+                    break;
+                }
+                inFlight->fetch_sub(1);
+            }
+
+            EventTracer *tracer = s_activeTracer.load();
+            if (tracer != nullptr)
+            {
+                tracer->Append(type, phase, id, value);
+            }
+            inFlight->fetch_sub(1, std::memory_order_release);
+        }
+
+        EventTraceRing *EventTracer::GetThreadRing() noexcept
+        {
+            if (s_threadTraceState.tracerId == m_id)
+            {
+                return s_threadTraceState.ring;
+            }
+
+            auto *ring = New<EventTraceRing>(m_allocator);
+            if (ring == nullptr)
+            {
+                return nullptr;
+            }
+
+            ring->slots =
+                static_cast<EventTraceSlot *>(aws_mem_acquire(m_allocator, m_ringCapacity * sizeof(EventTraceSlot)));
+            if (ring->slots == nullptr)
+            {
+                Delete(ring, m_allocator);
+                return nullptr;
+            }
+
+            for (size_t i = 0; i < m_ringCapacity; ++i)
+            {
+                new (&ring->slots[i]) EventTraceSlot();
+            }
+            aws_thread_id_t_to_string(aws_thread_current_thread_id(), ring->threadId, AWS_THREAD_ID_T_REPR_BUFSZ);
+
+            {
+                std::lock_guard<std::mutex> lock(m_ringsLock);
+                ring->index = ++m_ringCount;
+                ring->next = m_rings;
+                m_rings = ring;
+            }
+
+            s_threadTraceState.tracerId = m_id;
+            s_threadTraceState.ring = ring;
+            return ring;
+        }
+
+        void EventTracer::Append(TraceEventType type, TraceEventPhase phase, uint64_t id, int64_t value) noexcept
+        {
+            EventTraceRing *ring = GetThreadRing();
+            if (ring == nullptr)
+            {
+                return;
+            }
+
+            uint64_t timestampNs = 0;
+            aws_high_res_clock_get_ticks(&timestampNs);
+
+            uint64_t position = ring->head.load(std::memory_order_relaxed);
+            EventTraceSlot &slot = ring->slots[position & (m_ringCapacity - 1)];
+
+            slot.sequence.store(2 * position + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.timestampNs.store(timestampNs, std::memory_order_relaxed);
+            slot.id.store(id, std::memory_order_relaxed);
+            slot.value.store(value, std::memory_order_relaxed);
+            slot.kind.store(
+                static_cast<uint32_t>(type) | (static_cast<uint32_t>(phase) << 8), std::memory_order_relaxed);
+            slot.sequence.store(2 * position + 2, std::memory_order_release);
+
+            ring->head.store(position + 1, std::memory_order_release);
+        }
+
+        Vector<TraceEvent> EventTracer::GetEvents() const
+        {
+            Vector<TraceEvent> events;
+
+            std::lock_guard<std::mutex> lock(m_ringsLock);
+            for (const EventTraceRing *ring = m_rings; ring != nullptr; ring = ring->next)
+            {
+                uint64_t head = ring->head.load(std::memory_order_acquire);
+                uint64_t position = head > m_ringCapacity ? head - m_ringCapacity : 0;
+                for (; position < head; ++position)
+                {
+                    const EventTraceSlot &slot = ring->slots[position & (m_ringCapacity - 1)];
+                    uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+                    if (sequence != 2 * position + 2)
+                    {
+                        /* overwritten since head was read */
+                        continue;
+                    }
+
+                    TraceEvent event;
+                    event.TimestampNs = slot.timestampNs.load(std::memory_order_relaxed);
+                    event.Id = slot.id.load(std::memory_order_relaxed);
+                    event.Value = slot.value.load(std::memory_order_relaxed);
+                    uint32_t kind = slot.kind.load(std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+                    {
+                        continue;
+                    }
+
+                    event.ThreadIndex = ring->index;
+                    event.Type = static_cast<TraceEventType>(kind & 0xFF);
+                    event.Phase = static_cast<TraceEventPhase>((kind >> 8) & 0xFF);
+                    events.push_back(event);
+                }
+            }
+
+            std::stable_sort(
+                events.begin(), events.end(), [](const TraceEvent &lhs, const TraceEvent &rhs) {
+                    return lhs.TimestampNs < rhs.TimestampNs;
+                });
+            return events;
+        }
+
+        uint64_t EventTracer::GetOverwrittenCount() const noexcept
+        {
+            uint64_t overwritten = 0;
+
+            std::lock_guard<std::mutex> lock(m_ringsLock);
+            for (const EventTraceRing *ring = m_rings; ring != nullptr; ring = ring->next)
+            {
+                uint64_t head = ring->head.load(std::memory_order_relaxed);
+                if (head > m_ringCapacity)
+                {
+                    overwritten += head - m_ringCapacity;
+                }
+            }
+
+            return overwritten;
+        }
+
+        const char *EventTracer::GetEventName(TraceEventType type) noexcept
+        {
+            switch (type)
+            {
+                case TraceEventType::ConnectionSetup:
+                    return "ConnectionSetup";
+                case TraceEventType::TlsNegotiated:
+                    return "TlsNegotiated";
+                case TraceEventType::ConnectionShutdown:
+                    return "ConnectionShutdown";
+                case TraceEventType::HttpStream:
+                    return "HttpStream";
+                case TraceEventType::MqttPublish:
+                    return "MqttPublish";
+                case TraceEventType::CredentialsFetch:
+                    return "CredentialsFetch";
+                default:
+                    return "Unknown";
+            }
+        }
+
+        static const char *s_GetEventCategory(TraceEventType type) noexcept
+        {
+            switch (type)
+            {
+                case TraceEventType::MqttPublish:
+                    return "mqtt";
+                case TraceEventType::CredentialsFetch:
+                    return "auth";
+                default:
+                    return "http";
+            }
+        }
+
+        static const char *s_GetEventPhase(TraceEventPhase phase) noexcept
+        {
+            switch (phase)
+            {
+                case TraceEventPhase::Begin:
+                    return "b";
+                case TraceEventPhase::End:
+                    return "e";
+                default:
+                    return "i";
+            }
+        }
+
+        bool EventTracer::ExportChromeTrace(ByteBuf &output) const
+        {
+            Vector<TraceEvent> events = GetEvents();
+            int64_t pid = static_cast<int64_t>(aws_get_pid());
+
+            JsonWriter writer(output);
+            writer.BeginObject().Key("traceEvents").BeginArray();
+
+            {
+                std::lock_guard<std::mutex> lock(m_ringsLock);
+                for (const EventTraceRing *ring = m_rings; ring != nullptr; ring = ring->next)
+                {
+                    writer.BeginObject()
+                        .Key("name")
+                        .WriteString("thread_name")
+                        .Key("ph")
+                        .WriteString("M")
+                        .Key("pid")
+                        .WriteInt64(pid)
+                        .Key("tid")
+                        .WriteInt64(ring->index)
+                        .Key("args")
+                        .BeginObject()
+                        .Key("name")
+                        .WriteString(ring->threadId)
+                        .EndObject()
+                        .EndObject();
+                }
+            }
+
+            for (const TraceEvent &event : events)
+            {
+                char id[24];
+                snprintf(id, sizeof(id), "0x%" PRIx64, event.Id);
+                uint64_t sinceCreatedNs =
+                    event.TimestampNs > m_createdTimestampNs ? event.TimestampNs - m_createdTimestampNs : 0;
+
+                writer.BeginObject()
+                    .Key("name")
+                    .WriteString(GetEventName(event.Type))
+                    .Key("cat")
+                    .WriteString(s_GetEventCategory(event.Type))
+                    .Key("ph")
+                    .WriteString(s_GetEventPhase(event.Phase));
+                if (event.Phase == TraceEventPhase::Instant)
+                {
+                    /* thread scoped, async instants do not line up with the slices they belong to */
+                    writer.Key("s").WriteString("t");
+                }
+                writer.Key("ts")
+                    .WriteDouble(static_cast<double>(sinceCreatedNs) / 1000.0)
+                    .Key("pid")
+                    .WriteInt64(pid)
+                    .Key("tid")
+                    .WriteInt64(event.ThreadIndex)
+                    .Key("id")
+                    .WriteString(id)
+                    .Key("args")
+                    .BeginObject()
+                    .Key("value")
+                    .WriteInt64(event.Value)
+                    .EndObject()
+                    .EndObject();
+            }
+
+            writer.EndArray().Key("displayTimeUnit").WriteString("ms").EndObject();
+            return static_cast<bool>(writer);
+        }
+    } // namespace Crt
+} // namespace Aws
@@ -5,11 +5,14 @@
 
 #include <aws/auth/aws_imds_client.h>
 #include <aws/auth/credentials.h>
+#include <aws/crt/Api.h>
 #include <aws/crt/ImdsClient.h>
 #include <aws/crt/auth/Credentials.h>
 #include <aws/crt/http/HttpConnection.h>
 #include <aws/crt/io/Bootstrap.h>
 
+#include <mutex>
+
 namespace Aws
 {
     namespace Crt
@@ -70,11 +73,13 @@ namespace Aws
                 ramdiskId = {other.ramdiskId.data(), other.ramdiskId.size()};
                 region = {other.region.data(), other.region.size()};
 
+                marketplaceProductCodes.clear();
                 for (const auto &m : other.marketplaceProductCodes)
                 {
                     marketplaceProductCodes.emplace_back(m.data(), m.size());
                 }
 
+                billingProducts.clear();
                 for (const auto &m : other.billingProducts)
                 {
                     billingProducts.emplace_back(m.data(), m.size());
@@ -82,15 +87,138 @@ namespace Aws
                 return *this;
             }
 
+            static const char *s_instanceInfoPath = "/latest/dynamic/instance-identity/document";
+            static const char *s_iamProfilePath = "/latest/meta-data/iam/info";
+
+            /* the resources that stay the same for as long as the instance runs */
+            static const char *s_immutableResourcePaths[] = {
+                "/latest/meta-data/ami-id",
+                "/latest/meta-data/ami-launch-index",
+                "/latest/meta-data/ami-manifest-path",
+                "/latest/meta-data/ancestor-ami-ids",
+                "/latest/meta-data/instance-id",
+                "/latest/meta-data/instance-type",
+                "/latest/meta-data/mac",
+                "/latest/meta-data/local-ipv4",
+                "/latest/meta-data/placement/availability-zone",
+                "/latest/meta-data/product-codes",
+                "/latest/meta-data/public-keys/0/openssh-key",
+                "/latest/meta-data/ramdisk/id",
+                "/latest/meta-data/reservation-id",
+                "/latest/dynamic/instance-identity/document",
+                "/latest/dynamic/instance-identity/signature",
+            };
+
+            static bool s_IsImmutableResource(const StringView &resourcePath) noexcept
+            {
+                for (const char *immutablePath : s_immutableResourcePaths)
+                {
+                    if (resourcePath.compare(immutablePath) == 0)
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            /**
+             * The resources an ImdsClient has queried, by path. What is stored depends on the query: the text of
+             * a generic resource, the lines of a list, or the parsed instance info or iam profile; the queries that
+             * parse a resource and the generic one on its path each keep their own form of it.
+             */
+            struct ImdsResourceCache
+            {
+                using Clock = std::chrono::steady_clock;
+
+                struct Entry
+                {
+                    Clock::time_point expiresAt;
+                    Optional<String> resource;
+                    Optional<Vector<String>> resources;
+                    Optional<InstanceInfo> instanceInfo;
+                    Optional<IamProfile> iamProfile;
+                };
+
+                explicit ImdsResourceCache(std::chrono::milliseconds ttl) : ttl(ttl) {}
+
+                /* copies the unexpired entry for resourcePath into entry */
+                bool Find(const String &resourcePath, Entry &entry)
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    auto iter = entries.find(resourcePath);
+                    if (iter == entries.end())
+                    {
+                        return false;
+                    }
+                    if (Clock::now() >= iter->second.expiresAt)
+                    {
+                        entries.erase(iter);
+                        return false;
+                    }
+                    entry = iter->second;
+                    return true;
+                }
+
+                void Store(const String &resourcePath, Entry &&entry)
+                {
+                    entry.expiresAt = s_IsImmutableResource(StringView(resourcePath.data(), resourcePath.size()))
+                                          ? Clock::time_point::max()
+                                          : Clock::now() + ttl;
+                    std::lock_guard<std::mutex> guard(lock);
+                    auto iter = entries.find(resourcePath);
+                    if (iter == entries.end() || Clock::now() >= iter->second.expiresAt)
+                    {
+                        entries[resourcePath] = std::move(entry);
+                        return;
+                    }
+
+                    /* the other forms of the resource stay as fresh as they were */
+                    Entry &cached = iter->second;
+                    if (entry.resource)
+                    {
+                        cached.resource = std::move(entry.resource);
+                    }
+                    if (entry.resources)
+                    {
+                        cached.resources = std::move(entry.resources);
+                    }
+                    if (entry.instanceInfo)
+                    {
+                        cached.instanceInfo = std::move(entry.instanceInfo);
+                    }
+                    if (entry.iamProfile)
+                    {
+                        cached.iamProfile = std::move(entry.iamProfile);
+                    }
+                }
+
+                void Clear()
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    entries.clear();
+                }
+
+                std::chrono::milliseconds ttl;
+                std::mutex lock;
+                Map<String, Entry> entries;
+            };
+
             ImdsClient::ImdsClient(const ImdsClientConfig &config, Allocator *allocator) noexcept
             {
+                ApiHandle::InitializeSubsystem(ApiSubsystem::Auth);
+
                 AWS_FATAL_ASSERT(config.Bootstrap != nullptr);
 
                 struct aws_imds_client_options raw_config;
                 AWS_ZERO_STRUCT(raw_config);
                 raw_config.bootstrap = config.Bootstrap->GetUnderlyingHandle();
+                raw_config.function_table = config.FunctionTable;
                 m_client = aws_imds_client_new(allocator, &raw_config);
                 m_allocator = allocator;
+                if (config.CacheResources)
+                {
+                    m_cache = Aws::Crt::MakeShared<ImdsResourceCache>(allocator, config.ResourceCacheTtl);
+                }
             }
 
             ImdsClient::~ImdsClient()
@@ -111,14 +239,73 @@ namespace Aws
                 Allocator *allocator;
                 T callback;
                 void *userData;
+                /* where to keep the result, when the client caches it */
+                std::shared_ptr<ImdsResourceCache> cache;
+                String resourcePath;
             };
 
+            template <typename T>
+            static WrappedCallbackArgs<T> *s_NewCallbackArgs(
+                Allocator *allocator,
+                const std::shared_ptr<ImdsResourceCache> &cache,
+                const char *resourcePath,
+                T callback,
+                void *userData)
+            {
+                auto wrappedCallbackArgs =
+                    Aws::Crt::New<WrappedCallbackArgs<T>>(allocator, allocator, callback, userData);
+                if (wrappedCallbackArgs != nullptr && cache)
+                {
+                    wrappedCallbackArgs->cache = cache;
+                    wrappedCallbackArgs->resourcePath = resourcePath;
+                }
+                return wrappedCallbackArgs;
+            }
+
+            static Vector<StringView> s_ToStringViews(const Vector<String> &strings)
+            {
+                Vector<StringView> views;
+                views.reserve(strings.size());
+                for (const auto &string : strings)
+                {
+                    views.emplace_back(string.data(), string.size());
+                }
+                return views;
+            }
+
+            static InstanceInfoView s_ToInstanceInfoView(const InstanceInfo &instanceInfo)
+            {
+                InstanceInfoView info;
+                info.marketplaceProductCodes = s_ToStringViews(instanceInfo.marketplaceProductCodes);
+                info.availabilityZone =
+                    StringView(instanceInfo.availabilityZone.data(), instanceInfo.availabilityZone.size());
+                info.privateIp = StringView(instanceInfo.privateIp.data(), instanceInfo.privateIp.size());
+                info.version = StringView(instanceInfo.version.data(), instanceInfo.version.size());
+                info.instanceId = StringView(instanceInfo.instanceId.data(), instanceInfo.instanceId.size());
+                info.billingProducts = s_ToStringViews(instanceInfo.billingProducts);
+                info.instanceType = StringView(instanceInfo.instanceType.data(), instanceInfo.instanceType.size());
+                info.accountId = StringView(instanceInfo.accountId.data(), instanceInfo.accountId.size());
+                info.imageId = StringView(instanceInfo.imageId.data(), instanceInfo.imageId.size());
+                info.pendingTime = instanceInfo.pendingTime;
+                info.architecture = StringView(instanceInfo.architecture.data(), instanceInfo.architecture.size());
+                info.kernelId = StringView(instanceInfo.kernelId.data(), instanceInfo.kernelId.size());
+                info.ramdiskId = StringView(instanceInfo.ramdiskId.data(), instanceInfo.ramdiskId.size());
+                info.region = StringView(instanceInfo.region.data(), instanceInfo.region.size());
+                return info;
+            }
+
             void ImdsClient::s_onResourceAcquired(const aws_byte_buf *resource, int errorCode, void *userData)
             {
                 WrappedCallbackArgs<OnResourceAcquired> *callbackArgs =
                     static_cast<WrappedCallbackArgs<OnResourceAcquired> *>(userData);
-                callbackArgs->callback(
-                    ByteCursorToStringView(aws_byte_cursor_from_buf(resource)), errorCode, callbackArgs->userData);
+                StringView resourceView = ByteCursorToStringView(aws_byte_cursor_from_buf(resource));
+                if (callbackArgs->cache && errorCode == AWS_ERROR_SUCCESS)
+                {
+                    ImdsResourceCache::Entry entry;
+                    entry.resource = String(resourceView.data(), resourceView.size());
+                    callbackArgs->cache->Store(callbackArgs->resourcePath, std::move(entry));
+                }
+                callbackArgs->callback(resourceView, errorCode, callbackArgs->userData);
                 Aws::Crt::Delete(callbackArgs, callbackArgs->allocator);
             }
 
@@ -126,10 +313,19 @@ namespace Aws
             {
                 WrappedCallbackArgs<OnVectorResourceAcquired> *callbackArgs =
                     static_cast<WrappedCallbackArgs<OnVectorResourceAcquired> *>(userData);
-                callbackArgs->callback(
-                    ArrayListToVector<ByteCursor, StringView>(array, ByteCursorToStringView),
-                    errorCode,
-                    callbackArgs->userData);
+                Vector<StringView> resources =
+                    ArrayListToVector<ByteCursor, StringView>(array, ByteCursorToStringView);
+                if (callbackArgs->cache && errorCode == AWS_ERROR_SUCCESS)
+                {
+                    ImdsResourceCache::Entry entry;
+                    entry.resources = Vector<String>();
+                    for (const auto &resource : resources)
+                    {
+                        entry.resources->emplace_back(resource.data(), resource.size());
+                    }
+                    callbackArgs->cache->Store(callbackArgs->resourcePath, std::move(entry));
+                }
+                callbackArgs->callback(resources, errorCode, callbackArgs->userData);
                 Aws::Crt::Delete(callbackArgs, callbackArgs->allocator);
             }
 
@@ -153,6 +349,12 @@ namespace Aws
                 iamProfile.lastUpdated = aws_date_time_as_epoch_secs(&(iamProfileInfo->last_updated));
                 iamProfile.instanceProfileArn = ByteCursorToStringView(iamProfileInfo->instance_profile_arn);
                 iamProfile.instanceProfileId = ByteCursorToStringView(iamProfileInfo->instance_profile_id);
+                if (callbackArgs->cache && errorCode == AWS_ERROR_SUCCESS)
+                {
+                    ImdsResourceCache::Entry entry;
+                    entry.iamProfile = IamProfile(iamProfile);
+                    callbackArgs->cache->Store(callbackArgs->resourcePath, std::move(entry));
+                }
                 callbackArgs->callback(iamProfile, errorCode, callbackArgs->userData);
                 Aws::Crt::Delete(callbackArgs, callbackArgs->allocator);
             }
@@ -181,209 +383,268 @@ namespace Aws
                 info.kernelId = ByteCursorToStringView(instanceInfo->kernel_id);
                 info.ramdiskId = ByteCursorToStringView(instanceInfo->ramdisk_id);
                 info.region = ByteCursorToStringView(instanceInfo->region);
+                if (callbackArgs->cache && errorCode == AWS_ERROR_SUCCESS)
+                {
+                    ImdsResourceCache::Entry entry;
+                    entry.instanceInfo = InstanceInfo(info);
+                    callbackArgs->cache->Store(callbackArgs->resourcePath, std::move(entry));
+                }
                 callbackArgs->callback(info, errorCode, callbackArgs->userData);
                 Aws::Crt::Delete(callbackArgs, callbackArgs->allocator);
             }
 
-            int ImdsClient::GetResource(const StringView &resourcePath, OnResourceAcquired callback, void *userData)
+            int ImdsClient::GetCachedResource(
+                const char *resourcePath,
+                ResourceQuery *query,
+                OnResourceAcquired callback,
+                void *userData)
             {
-                auto wrappedCallbackArgs = Aws::Crt::New<WrappedCallbackArgs<OnResourceAcquired>>(
-                    m_allocator, m_allocator, callback, userData);
+                ImdsResourceCache::Entry entry;
+                if (m_cache && m_cache->Find(resourcePath, entry) && entry.resource)
+                {
+                    callback(StringView(entry.resource->data(), entry.resource->size()), AWS_ERROR_SUCCESS, userData);
+                    return AWS_OP_SUCCESS;
+                }
+
+                auto wrappedCallbackArgs = s_NewCallbackArgs(m_allocator, m_cache, resourcePath, callback, userData);
                 if (wrappedCallbackArgs == nullptr)
                 {
                     return AWS_OP_ERR;
                 }
 
-                return aws_imds_client_get_resource_async(
-                    m_client, StringViewToByteCursor(resourcePath), s_onResourceAcquired, wrappedCallbackArgs);
+                if (query(m_client, s_onResourceAcquired, wrappedCallbackArgs))
+                {
+                    Aws::Crt::Delete(wrappedCallbackArgs, m_allocator);
+                    return AWS_OP_ERR;
+                }
+                return AWS_OP_SUCCESS;
             }
 
-            int ImdsClient::GetAmiId(OnResourceAcquired callback, void *userData)
+            int ImdsClient::GetCachedVectorResource(
+                const char *resourcePath,
+                VectorResourceQuery *query,
+                OnVectorResourceAcquired callback,
+                void *userData)
             {
-                auto wrappedCallbackArgs = Aws::Crt::New<WrappedCallbackArgs<OnResourceAcquired>>(
-                    m_allocator, m_allocator, callback, userData);
+                ImdsResourceCache::Entry entry;
+                if (m_cache && m_cache->Find(resourcePath, entry) && entry.resources)
+                {
+                    callback(s_ToStringViews(*entry.resources), AWS_ERROR_SUCCESS, userData);
+                    return AWS_OP_SUCCESS;
+                }
+
+                auto wrappedCallbackArgs = s_NewCallbackArgs(m_allocator, m_cache, resourcePath, callback, userData);
                 if (wrappedCallbackArgs == nullptr)
                 {
                     return AWS_OP_ERR;
                 }
-                return aws_imds_client_get_ami_id(m_client, s_onResourceAcquired, wrappedCallbackArgs);
-            }
 
-            int ImdsClient::GetAmiLaunchIndex(OnResourceAcquired callback, void *userData)
-            {
-                auto wrappedCallbackArgs = Aws::Crt::New<WrappedCallbackArgs<OnResourceAcquired>>(
-                    m_allocator, m_allocator, callback, userData);
-                if (wrappedCallbackArgs == nullptr)
+                if (query(m_client, s_onVectorResourceAcquired, wrappedCallbackArgs))
                 {
+                    Aws::Crt::Delete(wrappedCallbackArgs, m_allocator);
                     return AWS_OP_ERR;
                 }
-                return aws_imds_client_get_ami_launch_index(m_client, s_onResourceAcquired, wrappedCallbackArgs);
+                return AWS_OP_SUCCESS;
             }
 
-            int ImdsClient::GetAmiManifestPath(OnResourceAcquired callback, void *userData)
+            int ImdsClient::GetResource(const StringView &resourcePath, OnResourceAcquired callback, void *userData)
             {
-                auto wrappedCallbackArgs = Aws::Crt::New<WrappedCallbackArgs<OnResourceAcquired>>(
-                    m_allocator, m_allocator, callback, userData);
+                String path(resourcePath.data(), resourcePath.size());
+                ImdsResourceCache::Entry entry;
+                if (m_cache && m_cache->Find(path, entry) && entry.resource)
+                {
+                    callback(StringView(entry.resource->data(), entry.resource->size()), AWS_ERROR_SUCCESS, userData);
+                    return AWS_OP_SUCCESS;
+                }
+
+                auto wrappedCallbackArgs = s_NewCallbackArgs(m_allocator, m_cache, path.c_str(), callback, userData);
                 if (wrappedCallbackArgs == nullptr)
                 {
                     return AWS_OP_ERR;
                 }
-                return aws_imds_client_get_ami_manifest_path(m_client, s_onResourceAcquired, wrappedCallbackArgs);
-            }
 
-            int ImdsClient::GetAncestorAmiIds(OnVectorResourceAcquired callback, void *userData)
-            {
-                auto wrappedCallbackArgs = Aws::Crt::New<WrappedCallbackArgs<OnVectorResourceAcquired>>(
-                    m_allocator, m_allocator, callback, userData);
-                if (wrappedCallbackArgs == nullptr)
+                if (aws_imds_client_get_resource_async(
+                        m_client, StringViewToByteCursor(resourcePath), s_onResourceAcquired, wrappedCallbackArgs))
                 {
+                    Aws::Crt::Delete(wrappedCallbackArgs, m_allocator);
                     return AWS_OP_ERR;
                 }
-                return aws_imds_client_get_ancestor_ami_ids(m_client, s_onVectorResourceAcquired, wrappedCallbackArgs);
+                return AWS_OP_SUCCESS;
             }
 
-            int ImdsClient::GetInstanceAction(OnResourceAcquired callback, void *userData)
+            /* collects the results of a GetMany() batch, completed by whichever query finishes last */
+            struct ImdsBatch
             {
-                auto wrappedCallbackArgs = Aws::Crt::New<WrappedCallbackArgs<OnResourceAcquired>>(
-                    m_allocator, m_allocator, callback, userData);
-                if (wrappedCallbackArgs == nullptr)
+                ImdsBatch(size_t count, OnResourcesAcquired callback, void *userData)
+                    : results(count), remaining(count), callback(callback), userData(userData)
                 {
-                    return AWS_OP_ERR;
                 }
-                return aws_imds_client_get_instance_action(m_client, s_onResourceAcquired, wrappedCallbackArgs);
-            }
 
-            int ImdsClient::GetInstanceId(OnResourceAcquired callback, void *userData)
+                void Complete(size_t index, const StringView &resource, int errorCode)
+                {
+                    bool finished = false;
+                    {
+                        std::lock_guard<std::mutex> guard(lock);
+                        results[index].resource.assign(resource.data(), resource.size());
+                        results[index].errorCode = errorCode;
+                        finished = --remaining == 0;
+                    }
+                    if (finished)
+                    {
+                        callback(results, userData);
+                    }
+                }
+
+                std::mutex lock;
+                Vector<ImdsResourceResult> results;
+                size_t remaining;
+                OnResourcesAcquired callback;
+                void *userData;
+            };
+
+            int ImdsClient::GetMany(
+                const Vector<StringView> &resourcePaths,
+                OnResourcesAcquired callback,
+                void *userData)
             {
-                auto wrappedCallbackArgs = Aws::Crt::New<WrappedCallbackArgs<OnResourceAcquired>>(
-                    m_allocator, m_allocator, callback, userData);
-                if (wrappedCallbackArgs == nullptr)
+                if (resourcePaths.empty())
+                {
+                    callback(Vector<ImdsResourceResult>(), userData);
+                    return AWS_OP_SUCCESS;
+                }
+
+                auto batch = Aws::Crt::MakeShared<ImdsBatch>(m_allocator, resourcePaths.size(), callback, userData);
+                if (batch == nullptr)
                 {
                     return AWS_OP_ERR;
                 }
-                return aws_imds_client_get_instance_id(m_client, s_onResourceAcquired, wrappedCallbackArgs);
+                for (size_t i = 0; i < resourcePaths.size(); ++i)
+                {
+                    batch->results[i].resourcePath.assign(resourcePaths[i].data(), resourcePaths[i].size());
+                }
+
+                /* a query that cannot start counts as done, so the batch still completes */
+                for (size_t i = 0; i < resourcePaths.size(); ++i)
+                {
+                    auto onResourceAcquired = [batch, i](const StringView &resource, int errorCode, void *) {
+                        batch->Complete(i, resource, errorCode);
+                    };
+                    if (GetResource(resourcePaths[i], onResourceAcquired, nullptr))
+                    {
+                        batch->Complete(i, StringView(), aws_last_error());
+                    }
+                }
+
+                return AWS_OP_SUCCESS;
+            }
+
+            int ImdsClient::GetAmiId(OnResourceAcquired callback, void *userData)
+            {
+                return GetCachedResource("/latest/meta-data/ami-id", aws_imds_client_get_ami_id, callback, userData);
+            }
+
+            int ImdsClient::GetAmiLaunchIndex(OnResourceAcquired callback, void *userData)
+            {
+                return GetCachedResource(
+                    "/latest/meta-data/ami-launch-index", aws_imds_client_get_ami_launch_index, callback, userData);
+            }
+
+            int ImdsClient::GetAmiManifestPath(OnResourceAcquired callback, void *userData)
+            {
+                return GetCachedResource(
+                    "/latest/meta-data/ami-manifest-path", aws_imds_client_get_ami_manifest_path, callback, userData);
+            }
+
+            int ImdsClient::GetAncestorAmiIds(OnVectorResourceAcquired callback, void *userData)
+            {
+                return GetCachedVectorResource(
+                    "/latest/meta-data/ancestor-ami-ids", aws_imds_client_get_ancestor_ami_ids, callback, userData);
+            }
+
+            int ImdsClient::GetInstanceAction(OnResourceAcquired callback, void *userData)
+            {
+                return GetCachedResource(
+                    "/latest/meta-data/instance-action", aws_imds_client_get_instance_action, callback, userData);
+            }
+
+            int ImdsClient::GetInstanceId(OnResourceAcquired callback, void *userData)
+            {
+                return GetCachedResource(
+                    "/latest/meta-data/instance-id", aws_imds_client_get_instance_id, callback, userData);
             }
 
             int ImdsClient::GetInstanceType(OnResourceAcquired callback, void *userData)
             {
-                auto wrappedCallbackArgs = Aws::Crt::New<WrappedCallbackArgs<OnResourceAcquired>>(
-                    m_allocator, m_allocator, callback, userData);
-                if (wrappedCallbackArgs == nullptr)
-                {
-                    return AWS_OP_ERR;
-                }
-                return aws_imds_client_get_instance_type(m_client, s_onResourceAcquired, wrappedCallbackArgs);
+                return GetCachedResource(
+                    "/latest/meta-data/instance-type", aws_imds_client_get_instance_type, callback, userData);
             }
 
             int ImdsClient::GetMacAddress(OnResourceAcquired callback, void *userData)
             {
-                auto wrappedCallbackArgs = Aws::Crt::New<WrappedCallbackArgs<OnResourceAcquired>>(
-                    m_allocator, m_allocator, callback, userData);
-                if (wrappedCallbackArgs == nullptr)
-                {
-                    return AWS_OP_ERR;
-                }
-                return aws_imds_client_get_mac_address(m_client, s_onResourceAcquired, wrappedCallbackArgs);
+                return GetCachedResource("/latest/meta-data/mac", aws_imds_client_get_mac_address, callback, userData);
             }
 
             int ImdsClient::GetPrivateIpAddress(OnResourceAcquired callback, void *userData)
             {
-                auto wrappedCallbackArgs = Aws::Crt::New<WrappedCallbackArgs<OnResourceAcquired>>(
-                    m_allocator, m_allocator, callback, userData);
-                if (wrappedCallbackArgs == nullptr)
-                {
-                    return AWS_OP_ERR;
-                }
-                return aws_imds_client_get_private_ip_address(m_client, s_onResourceAcquired, wrappedCallbackArgs);
+                return GetCachedResource(
+                    "/latest/meta-data/local-ipv4", aws_imds_client_get_private_ip_address, callback, userData);
             }
 
             int ImdsClient::GetAvailabilityZone(OnResourceAcquired callback, void *userData)
             {
-                auto wrappedCallbackArgs = Aws::Crt::New<WrappedCallbackArgs<OnResourceAcquired>>(
-                    m_allocator, m_allocator, callback, userData);
-                if (wrappedCallbackArgs == nullptr)
-                {
-                    return AWS_OP_ERR;
-                }
-                return aws_imds_client_get_availability_zone(m_client, s_onResourceAcquired, wrappedCallbackArgs);
+                return GetCachedResource(
+                    "/latest/meta-data/placement/availability-zone",
+                    aws_imds_client_get_availability_zone,
+                    callback,
+                    userData);
             }
 
             int ImdsClient::GetProductCodes(OnResourceAcquired callback, void *userData)
             {
-                auto wrappedCallbackArgs = Aws::Crt::New<WrappedCallbackArgs<OnResourceAcquired>>(
-                    m_allocator, m_allocator, callback, userData);
-                if (wrappedCallbackArgs == nullptr)
-                {
-                    return AWS_OP_ERR;
-                }
-                return aws_imds_client_get_product_codes(m_client, s_onResourceAcquired, wrappedCallbackArgs);
+                return GetCachedResource(
+                    "/latest/meta-data/product-codes", aws_imds_client_get_product_codes, callback, userData);
             }
 
             int ImdsClient::GetPublicKey(OnResourceAcquired callback, void *userData)
             {
-                auto wrappedCallbackArgs = Aws::Crt::New<WrappedCallbackArgs<OnResourceAcquired>>(
-                    m_allocator, m_allocator, callback, userData);
-                if (wrappedCallbackArgs == nullptr)
-                {
-                    return AWS_OP_ERR;
-                }
-                return aws_imds_client_get_public_key(m_client, s_onResourceAcquired, wrappedCallbackArgs);
+                return GetCachedResource(
+                    "/latest/meta-data/public-keys/0/openssh-key", aws_imds_client_get_public_key, callback, userData);
             }
 
             int ImdsClient::GetRamDiskId(OnResourceAcquired callback, void *userData)
             {
-                auto wrappedCallbackArgs = Aws::Crt::New<WrappedCallbackArgs<OnResourceAcquired>>(
-                    m_allocator, m_allocator, callback, userData);
-                if (wrappedCallbackArgs == nullptr)
-                {
-                    return AWS_OP_ERR;
-                }
-                return aws_imds_client_get_ramdisk_id(m_client, s_onResourceAcquired, wrappedCallbackArgs);
+                return GetCachedResource(
+                    "/latest/meta-data/ramdisk/id", aws_imds_client_get_ramdisk_id, callback, userData);
             }
 
             int ImdsClient::GetReservationId(OnResourceAcquired callback, void *userData)
             {
-                auto wrappedCallbackArgs = Aws::Crt::New<WrappedCallbackArgs<OnResourceAcquired>>(
-                    m_allocator, m_allocator, callback, userData);
-                if (wrappedCallbackArgs == nullptr)
-                {
-                    return AWS_OP_ERR;
-                }
-                return aws_imds_client_get_reservation_id(m_client, s_onResourceAcquired, wrappedCallbackArgs);
+                return GetCachedResource(
+                    "/latest/meta-data/reservation-id", aws_imds_client_get_reservation_id, callback, userData);
             }
 
             int ImdsClient::GetSecurityGroups(OnVectorResourceAcquired callback, void *userData)
             {
-                auto wrappedCallbackArgs = Aws::Crt::New<WrappedCallbackArgs<OnVectorResourceAcquired>>(
-                    m_allocator, m_allocator, callback, userData);
-                if (wrappedCallbackArgs == nullptr)
-                {
-                    return AWS_OP_ERR;
-                }
-                return aws_imds_client_get_security_groups(m_client, s_onVectorResourceAcquired, wrappedCallbackArgs);
+                return GetCachedVectorResource(
+                    "/latest/meta-data/security-groups", aws_imds_client_get_security_groups, callback, userData);
             }
 
             int ImdsClient::GetBlockDeviceMapping(OnVectorResourceAcquired callback, void *userData)
             {
-                auto wrappedCallbackArgs = Aws::Crt::New<WrappedCallbackArgs<OnVectorResourceAcquired>>(
-                    m_allocator, m_allocator, callback, userData);
-                if (wrappedCallbackArgs == nullptr)
-                {
-                    return AWS_OP_ERR;
-                }
-                return aws_imds_client_get_block_device_mapping(
-                    m_client, s_onVectorResourceAcquired, wrappedCallbackArgs);
+                return GetCachedVectorResource(
+                    "/latest/meta-data/block-device-mapping",
+                    aws_imds_client_get_block_device_mapping,
+                    callback,
+                    userData);
             }
 
             int ImdsClient::GetAttachedIamRole(OnResourceAcquired callback, void *userData)
             {
-                auto wrappedCallbackArgs = Aws::Crt::New<WrappedCallbackArgs<OnResourceAcquired>>(
-                    m_allocator, m_allocator, callback, userData);
-                if (wrappedCallbackArgs == nullptr)
-                {
-                    return AWS_OP_ERR;
-                }
-                return aws_imds_client_get_attached_iam_role(m_client, s_onResourceAcquired, wrappedCallbackArgs);
+                return GetCachedResource(
+                    "/latest/meta-data/iam/security-credentials/",
+                    aws_imds_client_get_attached_iam_role,
+                    callback,
+                    userData);
             }
 
             int ImdsClient::GetCredentials(
@@ -397,52 +658,336 @@ namespace Aws
                 {
                     return AWS_OP_ERR;
                 }
-                return aws_imds_client_get_credentials(
-                    m_client, StringViewToByteCursor(iamRoleName), s_onCredentialsAcquired, wrappedCallbackArgs);
+                if (aws_imds_client_get_credentials(
+                        m_client, StringViewToByteCursor(iamRoleName), s_onCredentialsAcquired, wrappedCallbackArgs))
+                {
+                    Aws::Crt::Delete(wrappedCallbackArgs, m_allocator);
+                    return AWS_OP_ERR;
+                }
+                return AWS_OP_SUCCESS;
             }
 
             int ImdsClient::GetIamProfile(OnIamProfileAcquired callback, void *userData)
             {
-                auto wrappedCallbackArgs = Aws::Crt::New<WrappedCallbackArgs<OnIamProfileAcquired>>(
-                    m_allocator, m_allocator, callback, userData);
+                ImdsResourceCache::Entry entry;
+                if (m_cache && m_cache->Find(s_iamProfilePath, entry) && entry.iamProfile)
+                {
+                    IamProfileView iamProfile;
+                    iamProfile.lastUpdated = entry.iamProfile->lastUpdated;
+                    iamProfile.instanceProfileArn = StringView(
+                        entry.iamProfile->instanceProfileArn.data(), entry.iamProfile->instanceProfileArn.size());
+                    iamProfile.instanceProfileId = StringView(
+                        entry.iamProfile->instanceProfileId.data(), entry.iamProfile->instanceProfileId.size());
+                    callback(iamProfile, AWS_ERROR_SUCCESS, userData);
+                    return AWS_OP_SUCCESS;
+                }
+
+                auto wrappedCallbackArgs =
+                    s_NewCallbackArgs(m_allocator, m_cache, s_iamProfilePath, callback, userData);
                 if (wrappedCallbackArgs == nullptr)
                 {
                     return AWS_OP_ERR;
                 }
-                return aws_imds_client_get_iam_profile(m_client, s_onIamProfileAcquired, wrappedCallbackArgs);
+                if (aws_imds_client_get_iam_profile(m_client, s_onIamProfileAcquired, wrappedCallbackArgs))
+                {
+                    Aws::Crt::Delete(wrappedCallbackArgs, m_allocator);
+                    return AWS_OP_ERR;
+                }
+                return AWS_OP_SUCCESS;
             }
 
             int ImdsClient::GetUserData(OnResourceAcquired callback, void *userData)
             {
-                auto wrappedCallbackArgs = Aws::Crt::New<WrappedCallbackArgs<OnResourceAcquired>>(
-                    m_allocator, m_allocator, callback, userData);
+                return GetCachedResource("/latest/user-data", aws_imds_client_get_user_data, callback, userData);
+            }
+
+            int ImdsClient::GetInstanceSignature(OnResourceAcquired callback, void *userData)
+            {
+                return GetCachedResource(
+                    "/latest/dynamic/instance-identity/signature",
+                    aws_imds_client_get_instance_signature,
+                    callback,
+                    userData);
+            }
+
+            int ImdsClient::GetInstanceInfo(OnInstanceInfoAcquired callback, void *userData)
+            {
+                ImdsResourceCache::Entry entry;
+                if (m_cache && m_cache->Find(s_instanceInfoPath, entry) && entry.instanceInfo)
+                {
+                    callback(s_ToInstanceInfoView(*entry.instanceInfo), AWS_ERROR_SUCCESS, userData);
+                    return AWS_OP_SUCCESS;
+                }
+
+                auto wrappedCallbackArgs =
+                    s_NewCallbackArgs(m_allocator, m_cache, s_instanceInfoPath, callback, userData);
                 if (wrappedCallbackArgs == nullptr)
                 {
                     return AWS_OP_ERR;
                 }
-                return aws_imds_client_get_user_data(m_client, s_onResourceAcquired, wrappedCallbackArgs);
+                if (aws_imds_client_get_instance_info(m_client, s_onInstanceInfoAcquired, wrappedCallbackArgs))
+                {
+                    Aws::Crt::Delete(wrappedCallbackArgs, m_allocator);
+                    return AWS_OP_ERR;
+                }
+                return AWS_OP_SUCCESS;
             }
 
-            int ImdsClient::GetInstanceSignature(OnResourceAcquired callback, void *userData)
+            void ImdsClient::ClearCache() noexcept
             {
-                auto wrappedCallbackArgs = Aws::Crt::New<WrappedCallbackArgs<OnResourceAcquired>>(
-                    m_allocator, m_allocator, callback, userData);
-                if (wrappedCallbackArgs == nullptr)
+                if (m_cache)
                 {
-                    return AWS_OP_ERR;
+                    m_cache->Clear();
                 }
-                return aws_imds_client_get_instance_signature(m_client, s_onResourceAcquired, wrappedCallbackArgs);
             }
 
-            int ImdsClient::GetInstanceInfo(OnInstanceInfoAcquired callback, void *userData)
+            /* the promise behind a future-returning query, passed to the callback form as its user data */
+            template <typename T> struct ImdsPromise
             {
-                auto wrappedCallbackArgs = Aws::Crt::New<WrappedCallbackArgs<OnInstanceInfoAcquired>>(
-                    m_allocator, m_allocator, callback, userData);
-                if (wrappedCallbackArgs == nullptr)
+                explicit ImdsPromise(Allocator *allocator) : allocator(allocator) {}
+
+                Allocator *allocator;
+                std::promise<ImdsResult<T>> promise;
+            };
+
+            template <typename T> static void s_ResolvePromise(void *userData, ImdsResult<T> &&result)
+            {
+                auto state = static_cast<ImdsPromise<T> *>(userData);
+                state->promise.set_value(std::move(result));
+                Aws::Crt::Delete(state, state->allocator);
+            }
+
+            static void s_ResolveResource(const StringView &resource, int errorCode, void *userData)
+            {
+                ImdsResult<String> result;
+                result.ErrorCode = errorCode;
+                if (errorCode == AWS_ERROR_SUCCESS)
                 {
-                    return AWS_OP_ERR;
+                    result.Value.assign(resource.data(), resource.size());
+                }
+                s_ResolvePromise(userData, std::move(result));
+            }
+
+            static void s_ResolveVectorResource(const Vector<StringView> &resource, int errorCode, void *userData)
+            {
+                ImdsResult<Vector<String>> result;
+                result.ErrorCode = errorCode;
+                if (errorCode == AWS_ERROR_SUCCESS)
+                {
+                    for (const auto &element : resource)
+                    {
+                        result.Value.emplace_back(element.data(), element.size());
+                    }
+                }
+                s_ResolvePromise(userData, std::move(result));
+            }
+
+            static void s_ResolveCredentials(const Auth::Credentials &credentials, int errorCode, void *userData)
+            {
+                ImdsResult<std::shared_ptr<Auth::Credentials>> result;
+                result.ErrorCode = errorCode;
+                if (errorCode == AWS_ERROR_SUCCESS && credentials)
+                {
+                    result.Value = Aws::Crt::MakeShared<Auth::Credentials>(
+                        static_cast<ImdsPromise<std::shared_ptr<Auth::Credentials>> *>(userData)->allocator,
+                        credentials.GetUnderlyingHandle());
+                }
+                s_ResolvePromise(userData, std::move(result));
+            }
+
+            static void s_ResolveIamProfile(const IamProfileView &iamProfile, int errorCode, void *userData)
+            {
+                ImdsResult<IamProfile> result;
+                result.ErrorCode = errorCode;
+                if (errorCode == AWS_ERROR_SUCCESS)
+                {
+                    result.Value = iamProfile;
                 }
-                return aws_imds_client_get_instance_info(m_client, s_onInstanceInfoAcquired, wrappedCallbackArgs);
+                s_ResolvePromise(userData, std::move(result));
+            }
+
+            static void s_ResolveInstanceInfo(const InstanceInfoView &instanceInfo, int errorCode, void *userData)
+            {
+                ImdsResult<InstanceInfo> result;
+                result.ErrorCode = errorCode;
+                if (errorCode == AWS_ERROR_SUCCESS)
+                {
+                    result.Value = instanceInfo;
+                }
+                s_ResolvePromise(userData, std::move(result));
+            }
+
+            /* starts a query with start(userData), which returns AWS_OP_ERR if the query did not start */
+            template <typename T, typename StartFn>
+            static std::future<ImdsResult<T>> s_QueryAsFuture(Allocator *allocator, const StartFn &start)
+            {
+                auto state = Aws::Crt::New<ImdsPromise<T>>(allocator, allocator);
+                if (state == nullptr)
+                {
+                    std::promise<ImdsResult<T>> failed;
+                    ImdsResult<T> result;
+                    result.ErrorCode = aws_last_error();
+                    failed.set_value(std::move(result));
+                    return failed.get_future();
+                }
+
+                /* a cached resource resolves the promise before start returns */
+                auto future = state->promise.get_future();
+                if (start(state))
+                {
+                    ImdsResult<T> result;
+                    result.ErrorCode = aws_last_error();
+                    s_ResolvePromise(state, std::move(result));
+                }
+                return future;
+            }
+
+            std::future<ImdsResult<String>> ImdsClient::GetResource(const StringView &resourcePath)
+            {
+                return s_QueryAsFuture<String>(m_allocator, [this, &resourcePath](void *userData) {
+                    return GetResource(resourcePath, s_ResolveResource, userData);
+                });
+            }
+
+            std::future<ImdsResult<String>> ImdsClient::GetAmiId()
+            {
+                return s_QueryAsFuture<String>(
+                    m_allocator, [this](void *userData) { return GetAmiId(s_ResolveResource, userData); });
+            }
+
+            std::future<ImdsResult<String>> ImdsClient::GetAmiLaunchIndex()
+            {
+                return s_QueryAsFuture<String>(
+                    m_allocator, [this](void *userData) { return GetAmiLaunchIndex(s_ResolveResource, userData); });
+            }
+
+            std::future<ImdsResult<String>> ImdsClient::GetAmiManifestPath()
+            {
+                return s_QueryAsFuture<String>(
+                    m_allocator, [this](void *userData) { return GetAmiManifestPath(s_ResolveResource, userData); });
+            }
+
+            std::future<ImdsResult<Vector<String>>> ImdsClient::GetAncestorAmiIds()
+            {
+                return s_QueryAsFuture<Vector<String>>(
+                    m_allocator, [this](void *userData) {
+                        return GetAncestorAmiIds(s_ResolveVectorResource, userData);
+                    });
+            }
+
+            std::future<ImdsResult<String>> ImdsClient::GetInstanceAction()
+            {
+                return s_QueryAsFuture<String>(
+                    m_allocator, [this](void *userData) { return GetInstanceAction(s_ResolveResource, userData); });
+            }
+
+            std::future<ImdsResult<String>> ImdsClient::GetInstanceId()
+            {
+                return s_QueryAsFuture<String>(
+                    m_allocator, [this](void *userData) { return GetInstanceId(s_ResolveResource, userData); });
+            }
+
+            std::future<ImdsResult<String>> ImdsClient::GetInstanceType()
+            {
+                return s_QueryAsFuture<String>(
+                    m_allocator, [this](void *userData) { return GetInstanceType(s_ResolveResource, userData); });
+            }
+
+            std::future<ImdsResult<String>> ImdsClient::GetMacAddress()
+            {
+                return s_QueryAsFuture<String>(
+                    m_allocator, [this](void *userData) { return GetMacAddress(s_ResolveResource, userData); });
+            }
+
+            std::future<ImdsResult<String>> ImdsClient::GetPrivateIpAddress()
+            {
+                return s_QueryAsFuture<String>(
+                    m_allocator, [this](void *userData) { return GetPrivateIpAddress(s_ResolveResource, userData); });
+            }
+
+            std::future<ImdsResult<String>> ImdsClient::GetAvailabilityZone()
+            {
+                return s_QueryAsFuture<String>(
+                    m_allocator, [this](void *userData) { return GetAvailabilityZone(s_ResolveResource, userData); });
+            }
+
+            std::future<ImdsResult<String>> ImdsClient::GetProductCodes()
+            {
+                return s_QueryAsFuture<String>(
+                    m_allocator, [this](void *userData) { return GetProductCodes(s_ResolveResource, userData); });
+            }
+
+            std::future<ImdsResult<String>> ImdsClient::GetPublicKey()
+            {
+                return s_QueryAsFuture<String>(
+                    m_allocator, [this](void *userData) { return GetPublicKey(s_ResolveResource, userData); });
+            }
+
+            std::future<ImdsResult<String>> ImdsClient::GetRamDiskId()
+            {
+                return s_QueryAsFuture<String>(
+                    m_allocator, [this](void *userData) { return GetRamDiskId(s_ResolveResource, userData); });
+            }
+
+            std::future<ImdsResult<String>> ImdsClient::GetReservationId()
+            {
+                return s_QueryAsFuture<String>(
+                    m_allocator, [this](void *userData) { return GetReservationId(s_ResolveResource, userData); });
+            }
+
+            std::future<ImdsResult<Vector<String>>> ImdsClient::GetSecurityGroups()
+            {
+                return s_QueryAsFuture<Vector<String>>(
+                    m_allocator, [this](void *userData) {
+                        return GetSecurityGroups(s_ResolveVectorResource, userData);
+                    });
+            }
+
+            std::future<ImdsResult<Vector<String>>> ImdsClient::GetBlockDeviceMapping()
+            {
+                return s_QueryAsFuture<Vector<String>>(
+                    m_allocator, [this](void *userData) {
+                        return GetBlockDeviceMapping(s_ResolveVectorResource, userData);
+                    });
+            }
+
+            std::future<ImdsResult<String>> ImdsClient::GetAttachedIamRole()
+            {
+                return s_QueryAsFuture<String>(
+                    m_allocator, [this](void *userData) { return GetAttachedIamRole(s_ResolveResource, userData); });
+            }
+
+            std::future<ImdsResult<std::shared_ptr<Auth::Credentials>>> ImdsClient::GetCredentials(
+                const StringView &iamRoleName)
+            {
+                return s_QueryAsFuture<std::shared_ptr<Auth::Credentials>>(
+                    m_allocator, [this, &iamRoleName](void *userData) {
+                        return GetCredentials(iamRoleName, s_ResolveCredentials, userData);
+                    });
+            }
+
+            std::future<ImdsResult<IamProfile>> ImdsClient::GetIamProfile()
+            {
+                return s_QueryAsFuture<IamProfile>(
+                    m_allocator, [this](void *userData) { return GetIamProfile(s_ResolveIamProfile, userData); });
+            }
+
+            std::future<ImdsResult<String>> ImdsClient::GetUserData()
+            {
+                return s_QueryAsFuture<String>(
+                    m_allocator, [this](void *userData) { return GetUserData(s_ResolveResource, userData); });
+            }
+
+            std::future<ImdsResult<String>> ImdsClient::GetInstanceSignature()
+            {
+                return s_QueryAsFuture<String>(
+                    m_allocator, [this](void *userData) { return GetInstanceSignature(s_ResolveResource, userData); });
+            }
+
+            std::future<ImdsResult<InstanceInfo>> ImdsClient::GetInstanceInfo()
+            {
+                return s_QueryAsFuture<InstanceInfo>(
+                    m_allocator, [this](void *userData) { return GetInstanceInfo(s_ResolveInstanceInfo, userData); });
             }
         } // namespace Imds
     }     // namespace Crt
@@ -0,0 +1,797 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/JsonObject.h>
+
+#include <aws/crt/SmallVector.h>
+#include <aws/crt/external/cJSON.h>
+#include <aws/crt/private/JsonText.h>
+
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define AWS_CRT_JSON_SSE2
+#    include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#    include <intrin.h>
+#endif
+
+namespace Aws
+{
+    namespace Crt
+    {
+        /*
+         * The document is parsed in two passes. The first classifies the input 64 bytes at a time into bit masks,
+         * works out which bytes are inside strings from the unescaped quotes, and records the offset of every
+         * structural character, every quote and the first byte of every bare literal or number. The second walks
+         * that index to build the cJSON tree without recursing, never looking at the bytes between tokens.
+         */
+        static const size_t s_blockSize = 64;
+
+        using JsonTokenIndex = SmallVector<uint32_t, 256>;
+
+        struct JsonBlockMasks
+        {
+            uint64_t quotes;
+            uint64_t backslashes;
+            uint64_t operators;
+            uint64_t whitespace;
+            uint64_t controls;
+        };
+
+        static inline size_t s_CountTrailingZeros(uint64_t value)
+        {
+#if defined(_MSC_VER)
+            unsigned long index = 0;
+#    if defined(_WIN64)
+            _BitScanForward64(&index, value);
+#    else
+            if (!_BitScanForward(&index, static_cast<unsigned long>(value)))
+            {
+                _BitScanForward(&index, static_cast<unsigned long>(value >> 32));
+                index += 32;
+            }
+#    endif
+            return static_cast<size_t>(index);
+#else
+            return static_cast<size_t>(__builtin_ctzll(value));
+#endif
+        }
+
+        /* sets every bit from each odd quote up to, but not including, the following even one */
+        static inline uint64_t s_PrefixXor(uint64_t value)
+        {
+            value ^= value << 1;
+            value ^= value << 2;
+            value ^= value << 4;
+            value ^= value << 8;
+            value ^= value << 16;
+            value ^= value << 32;
+            return value;
+        }
+
+        static inline bool s_IsWhitespace(uint8_t c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+        static inline bool s_IsDelimiter(uint8_t c)
+        {
+            return s_IsWhitespace(c) || c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',' ||
+                   c == '"';
+        }
+
+        static void s_ClassifyBlock(const uint8_t *block, JsonBlockMasks &masks)
+        {
+#if defined(AWS_CRT_JSON_SSE2)
+            const __m128i quote = _mm_set1_epi8('"');
+            const __m128i backslash = _mm_set1_epi8('\\');
+            /* '[' ']' '{' '}' only differ from each other in bits 0x20 and 0x02 */
+            const __m128i bracketBits = _mm_set1_epi8(0x20);
+            const __m128i openBrace = _mm_set1_epi8('{');
+            const __m128i closeBrace = _mm_set1_epi8('}');
+            const __m128i colon = _mm_set1_epi8(':');
+            const __m128i comma = _mm_set1_epi8(',');
+            const __m128i space = _mm_set1_epi8(' ');
+            const __m128i tab = _mm_set1_epi8('\t');
+            const __m128i newline = _mm_set1_epi8('\n');
+            const __m128i carriageReturn = _mm_set1_epi8('\r');
+            const __m128i controlBits = _mm_set1_epi8(static_cast<char>(0xe0));
+            const __m128i zero = _mm_setzero_si128();
+
+            masks = JsonBlockMasks();
+            for (size_t lane = 0; lane < s_blockSize / 16; ++lane)
+            {
+                __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + lane * 16));
+                __m128i folded = _mm_or_si128(bytes, bracketBits);
+                __m128i operators = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(folded, openBrace), _mm_cmpeq_epi8(folded, closeBrace)),
+                    _mm_or_si128(_mm_cmpeq_epi8(bytes, colon), _mm_cmpeq_epi8(bytes, comma)));
+                __m128i whitespace = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(bytes, space), _mm_cmpeq_epi8(bytes, tab)),
+                    _mm_or_si128(_mm_cmpeq_epi8(bytes, newline), _mm_cmpeq_epi8(bytes, carriageReturn)));
+
+                size_t shift = lane * 16;
+                masks.quotes |= static_cast<uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, quote))) << shift;
+                masks.backslashes |= static_cast<uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, backslash)))
+                                     << shift;
+                masks.operators |= static_cast<uint64_t>(_mm_movemask_epi8(operators)) << shift;
+                masks.whitespace |= static_cast<uint64_t>(_mm_movemask_epi8(whitespace)) << shift;
+                masks.controls |=
+                    static_cast<uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(bytes, controlBits), zero)))
+                    << shift;
+            }
+#else
+            masks = JsonBlockMasks();
+            for (size_t i = 0; i < s_blockSize; ++i)
+            {
+                uint8_t c = block[i];
+                uint64_t bit = 1ULL << i;
+                switch (c)
+                {
+                    case '"':
+                        masks.quotes |= bit;
+                        break;
+                    case '\\':
+                        masks.backslashes |= bit;
+                        break;
+                    case '{':
+                    case '}':
+                    case '[':
+                    case ']':
+                    case ':':
+                    case ',':
+                        masks.operators |= bit;
+                        break;
+                    case ' ':
+                    case '\t':
+                    case '\n':
+                    case '\r':
+                        masks.whitespace |= bit;
+                        break;
+                    default:
+                        break;
+                }
+                if (c < 0x20)
+                {
+                    masks.controls |= bit;
+                }
+            }
+#endif
+        }
+
+        static bool s_IndexTokens(const uint8_t *json, size_t length, JsonTokenIndex &index, size_t &errorOffset)
+        {
+            uint64_t escapeCarry = 0;
+            uint64_t inStringCarry = 0;
+            uint64_t atomCarry = 0;
+            /* only kept to point an unterminated string out */
+            uint64_t lastOpeningQuotes = 0;
+            size_t lastOpeningQuotesBase = 0;
+            size_t count = 0;
+            index.resize(index.capacity());
+
+            for (size_t base = 0; base < length; base += s_blockSize)
+            {
+                const uint8_t *block = json + base;
+                uint8_t padded[s_blockSize];
+                if (length - base < s_blockSize)
+                {
+                    memset(padded, ' ', sizeof(padded));
+                    memcpy(padded, block, length - base);
+                    block = padded;
+                }
+
+                JsonBlockMasks masks;
+                s_ClassifyBlock(block, masks);
+
+                /* backslashes are rare, so walking them one by one beats working out odd-length runs */
+                uint64_t escaped = escapeCarry;
+                escapeCarry = 0;
+                for (uint64_t backslashes = masks.backslashes; backslashes != 0; backslashes &= backslashes - 1)
+                {
+                    uint64_t bit = 1ULL << s_CountTrailingZeros(backslashes);
+                    if ((escaped & bit) != 0)
+                    {
+                        continue;
+                    }
+
+                    if (bit == 1ULL << 63)
+                    {
+                        escapeCarry = 1;
+                    }
+                    else
+                    {
+                        escaped |= bit << 1;
+                    }
+                }
+
+                uint64_t quotes = masks.quotes & ~escaped;
+                uint64_t inString = s_PrefixXor(quotes) ^ inStringCarry;
+                inStringCarry = (inString >> 63) != 0 ? ~0ULL : 0;
+
+                if ((quotes & inString) != 0)
+                {
+                    lastOpeningQuotes = quotes & inString;
+                    lastOpeningQuotesBase = base;
+                }
+
+                uint64_t stringControls = masks.controls & inString;
+                if (stringControls != 0)
+                {
+                    errorOffset = base + s_CountTrailingZeros(stringControls);
+                    return false;
+                }
+
+                uint64_t atoms = ~(masks.operators | masks.whitespace | quotes) & ~inString;
+                uint64_t tokens = (masks.operators & ~inString) | quotes | (atoms & ~((atoms << 1) | atomCarry));
+                atomCarry = atoms >> 63;
+
+                if (count + s_blockSize > index.size())
+                {
+                    index.resize(index.size() * 2 > count + s_blockSize ? index.size() * 2 : count + s_blockSize);
+                }
+
+                uint32_t *out = index.data();
+                for (; tokens != 0; tokens &= tokens - 1)
+                {
+                    out[count++] = static_cast<uint32_t>(base + s_CountTrailingZeros(tokens));
+                }
+            }
+
+            index.resize(count);
+            if (inStringCarry != 0)
+            {
+                errorOffset = lastOpeningQuotesBase;
+                for (; lastOpeningQuotes != 0; lastOpeningQuotes &= lastOpeningQuotes - 1)
+                {
+                    errorOffset = lastOpeningQuotesBase + s_CountTrailingZeros(lastOpeningQuotes);
+                }
+                return false;
+            }
+
+            return true;
+        }
+
+        static cJSON *s_NewNode(int type, size_t extraLength)
+        {
+            auto *node = static_cast<cJSON *>(cJSON_malloc(sizeof(cJSON) + extraLength));
+            if (node != nullptr)
+            {
+                memset(node, 0, sizeof(cJSON));
+                node->type = type;
+            }
+
+            return node;
+        }
+
+        static bool s_ReadHex4(const uint8_t *digits, uint32_t &value)
+        {
+            value = 0;
+            for (size_t i = 0; i < 4; ++i)
+            {
+                uint8_t c = digits[i];
+                value <<= 4;
+                if (c >= '0' && c <= '9')
+                {
+                    value |= c - '0';
+                }
+                else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f')
+                {
+                    value |= (c | 0x20) - 'a' + 10;
+                }
+                else
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        static size_t s_WriteUtf8(uint32_t codepoint, char *out)
+        {
+            if (codepoint < 0x80)
+            {
+                out[0] = static_cast<char>(codepoint);
+                return 1;
+            }
+            if (codepoint < 0x800)
+            {
+                out[0] = static_cast<char>(0xc0 | (codepoint >> 6));
+                out[1] = static_cast<char>(0x80 | (codepoint & 0x3f));
+                return 2;
+            }
+            if (codepoint < 0x10000)
+            {
+                out[0] = static_cast<char>(0xe0 | (codepoint >> 12));
+                out[1] = static_cast<char>(0x80 | ((codepoint >> 6) & 0x3f));
+                out[2] = static_cast<char>(0x80 | (codepoint & 0x3f));
+                return 3;
+            }
+
+            out[0] = static_cast<char>(0xf0 | (codepoint >> 18));
+            out[1] = static_cast<char>(0x80 | ((codepoint >> 12) & 0x3f));
+            out[2] = static_cast<char>(0x80 | ((codepoint >> 6) & 0x3f));
+            out[3] = static_cast<char>(0x80 | (codepoint & 0x3f));
+            return 4;
+        }
+
+        char *JsonUnescapeString(const uint8_t *begin, const uint8_t *end, char *out) noexcept
+        {
+            while (begin < end)
+            {
+                size_t remaining = static_cast<size_t>(end - begin);
+                const auto *escape = static_cast<const uint8_t *>(memchr(begin, '\\', remaining));
+                const uint8_t *runEnd = escape != nullptr ? escape : end;
+                memcpy(out, begin, static_cast<size_t>(runEnd - begin));
+                out += runEnd - begin;
+                begin = runEnd;
+                if (escape == nullptr)
+                {
+                    break;
+                }
+
+                if (end - begin < 2)
+                {
+                    return nullptr;
+                }
+
+                uint8_t escaped = begin[1];
+                begin += 2;
+                switch (escaped)
+                {
+                    case '"':
+                    case '\\':
+                    case '/':
+                        *out++ = static_cast<char>(escaped);
+                        break;
+                    case 'b':
+                        *out++ = '\b';
+                        break;
+                    case 'f':
+                        *out++ = '\f';
+                        break;
+                    case 'n':
+                        *out++ = '\n';
+                        break;
+                    case 'r':
+                        *out++ = '\r';
+                        break;
+                    case 't':
+                        *out++ = '\t';
+                        break;
+                    case 'u':
+                    {
+                        uint32_t codepoint = 0;
+                        if (end - begin < 4 || !s_ReadHex4(begin, codepoint))
+                        {
+                            return nullptr;
+                        }
+                        begin += 4;
+
+                        if (codepoint >= 0xdc00 && codepoint <= 0xdfff)
+                        {
+                            return nullptr;
+                        }
+                        if (codepoint >= 0xd800 && codepoint <= 0xdbff)
+                        {
+                            uint32_t low = 0;
+                            if (end - begin < 6 || begin[0] != '\\' || begin[1] != 'u' ||
+                                !s_ReadHex4(begin + 2, low) || low < 0xdc00 || low > 0xdfff)
+                            {
+                                return nullptr;
+                            }
+                            begin += 6;
+                            codepoint = 0x10000 + (((codepoint & 0x3ff) << 10) | (low & 0x3ff));
+                        }
+
+                        out += s_WriteUtf8(codepoint, out);
+                        break;
+                    }
+                    default:
+                        return nullptr;
+                }
+            }
+
+            *out = '\0';
+            return out;
+        }
+
+        static inline bool s_IsDigit(uint8_t c) { return c >= '0' && c <= '9'; }
+
+        /* powers of ten a double holds exactly */
+        static const double s_exactPowersOfTen[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                                    1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                                    1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+        bool JsonParseNumber(const uint8_t *begin, const uint8_t *end, double &value) noexcept
+        {
+            const uint8_t *cursor = begin;
+            bool negative = cursor < end && *cursor == '-';
+            if (negative)
+            {
+                ++cursor;
+            }
+            if (cursor == end || !s_IsDigit(*cursor) || (*cursor == '0' && cursor + 1 < end && s_IsDigit(cursor[1])))
+            {
+                return false;
+            }
+
+            /* the significant digits are accumulated as an integer, scaled by a power of ten */
+            uint64_t mantissa = 0;
+            size_t significantDigits = 0;
+            int64_t exponent = 0;
+            bool exact = true;
+            auto accumulate = [&](uint8_t digit) {
+                if (mantissa == 0 && digit == '0')
+                {
+                    return;
+                }
+                if (significantDigits < 19)
+                {
+                    mantissa = mantissa * 10 + static_cast<uint64_t>(digit - '0');
+                    ++significantDigits;
+                }
+                else
+                {
+                    exact = false;
+                    ++exponent;
+                }
+            };
+
+            for (; cursor < end && s_IsDigit(*cursor); ++cursor)
+            {
+                accumulate(*cursor);
+            }
+
+            if (cursor < end && *cursor == '.')
+            {
+                const uint8_t *fraction = ++cursor;
+                for (; cursor < end && s_IsDigit(*cursor); ++cursor)
+                {
+                    accumulate(*cursor);
+                    --exponent;
+                }
+                if (cursor == fraction)
+                {
+                    return false;
+                }
+            }
+
+            if (cursor < end && (*cursor == 'e' || *cursor == 'E'))
+            {
+                ++cursor;
+                bool negativeExponent = cursor < end && *cursor == '-';
+                if (cursor < end && (*cursor == '-' || *cursor == '+'))
+                {
+                    ++cursor;
+                }
+
+                const uint8_t *digits = cursor;
+                int64_t explicitExponent = 0;
+                for (; cursor < end && s_IsDigit(*cursor); ++cursor)
+                {
+                    if (explicitExponent < 100000)
+                    {
+                        explicitExponent = explicitExponent * 10 + (*cursor - '0');
+                    }
+                }
+                if (cursor == digits)
+                {
+                    return false;
+                }
+                exponent += negativeExponent ? -explicitExponent : explicitExponent;
+            }
+
+            if (cursor != end)
+            {
+                return false;
+            }
+
+            if (mantissa == 0)
+            {
+                value = negative ? -0.0 : 0.0;
+                return true;
+            }
+
+            /* exact whenever the mantissa and the power of ten are both exact doubles */
+            if (exact && exponent == 0)
+            {
+                value = static_cast<double>(mantissa);
+            }
+            else if (exact && mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22)
+            {
+                value = exponent < 0 ? static_cast<double>(mantissa) / s_exactPowersOfTen[-exponent]
+                                     : static_cast<double>(mantissa) * s_exactPowersOfTen[exponent];
+            }
+            else
+            {
+                /* leave the rounding of everything else to strtod, like cJSON */
+                char small[64];
+                size_t length = static_cast<size_t>(end - begin);
+                String large;
+                char *copy = small;
+                if (length >= sizeof(small))
+                {
+                    large.assign(reinterpret_cast<const char *>(begin), length);
+                    copy = &large[0];
+                }
+                else
+                {
+                    memcpy(small, begin, length);
+                    small[length] = '\0';
+                }
+                value = strtod(copy, nullptr);
+                return true;
+            }
+
+            value = negative ? -value : value;
+            return true;
+        }
+
+        static cJSON *s_ParseAtom(const uint8_t *begin, const uint8_t *end, size_t extraLength)
+        {
+            size_t length = static_cast<size_t>(end - begin);
+            if (length == 4 && memcmp(begin, "true", 4) == 0)
+            {
+                cJSON *node = s_NewNode(cJSON_True, extraLength);
+                if (node != nullptr)
+                {
+                    node->valueint = 1;
+                }
+                return node;
+            }
+            if (length == 5 && memcmp(begin, "false", 5) == 0)
+            {
+                return s_NewNode(cJSON_False, extraLength);
+            }
+            if (length == 4 && memcmp(begin, "null", 4) == 0)
+            {
+                return s_NewNode(cJSON_NULL, extraLength);
+            }
+
+            double number = 0;
+            if (!JsonParseNumber(begin, end, number))
+            {
+                return nullptr;
+            }
+
+            cJSON *node = s_NewNode(cJSON_Number, extraLength);
+            if (node != nullptr)
+            {
+                node->valuedouble = number;
+                if (number >= INT_MAX)
+                {
+                    node->valueint = INT_MAX;
+                }
+                else if (number <= static_cast<double>(INT_MIN))
+                {
+                    node->valueint = INT_MIN;
+                }
+                else
+                {
+                    node->valueint = static_cast<int>(number);
+                }
+            }
+            return node;
+        }
+
+        struct JsonParseFrame
+        {
+            cJSON *container;
+            cJSON *last;
+        };
+
+        cJSON *JsonObject::s_ParseIndexed(const char *input, size_t length, size_t &errorOffset) noexcept
+        {
+            const auto *json = reinterpret_cast<const uint8_t *>(input);
+            size_t bomLength = 0;
+            if (length >= 3 && memcmp(json, "\xef\xbb\xbf", 3) == 0)
+            {
+                bomLength = 3;
+            }
+
+            errorOffset = length;
+            if (length > UINT32_MAX)
+            {
+                return nullptr;
+            }
+
+            JsonTokenIndex index;
+            if (!s_IndexTokens(json + bomLength, length - bomLength, index, errorOffset))
+            {
+                errorOffset += bomLength;
+                return nullptr;
+            }
+            json += bomLength;
+            length -= bomLength;
+
+            const uint32_t *tokens = index.data();
+            size_t count = index.size();
+            SmallVector<JsonParseFrame, 32> frames;
+            cJSON *root = nullptr;
+            size_t keyToken = 0;
+            size_t k = 0;
+
+            auto fail = [&](size_t offset) -> cJSON * {
+                errorOffset = offset + bomLength;
+                cJSON_Delete(root);
+                return nullptr;
+            };
+
+            /* checks for a key at token k and the colon after it, and steps past them */
+            auto readKey = [&]() -> bool {
+                if (k + 2 >= count || json[tokens[k]] != '"' || json[tokens[k + 2]] != ':')
+                {
+                    return false;
+                }
+
+                keyToken = k;
+                k += 3;
+                return true;
+            };
+
+            for (;;)
+            {
+                if (k >= count)
+                {
+                    return fail(length);
+                }
+
+                /*
+                 * A member's key, and a string's value, are unescaped into the tail of their node's allocation,
+                 * so each value costs one allocation. IsReference and StringIsConst keep cJSON_Delete() from
+                 * freeing them on their own, and cJSON_Duplicate() gives copies keys of their own.
+                 */
+                size_t offset = tokens[k];
+                uint8_t c = json[offset];
+                bool isMember = !frames.empty() && (frames.back().container->type & 0xFF) == cJSON_Object;
+                size_t keyLength = isMember ? tokens[keyToken + 1] - tokens[keyToken] : 0;
+                size_t valueLength = 0;
+                cJSON *value = nullptr;
+                switch (c)
+                {
+                    case '{':
+                        value = s_NewNode(cJSON_Object, keyLength);
+                        ++k;
+                        break;
+                    case '[':
+                        value = s_NewNode(cJSON_Array, keyLength);
+                        ++k;
+                        break;
+                    case '"':
+                    {
+                        if (k + 1 >= count)
+                        {
+                            return fail(offset);
+                        }
+                        valueLength = tokens[k + 1] - offset;
+                        value = s_NewNode(cJSON_String | cJSON_IsReference, valueLength + keyLength);
+                        if (value != nullptr)
+                        {
+                            value->valuestring = reinterpret_cast<char *>(value + 1);
+                            if (!JsonUnescapeString(json + offset + 1, json + tokens[k + 1], value->valuestring))
+                            {
+                                cJSON_free(value);
+                                return fail(offset);
+                            }
+                        }
+                        k += 2;
+                        break;
+                    }
+                    case '}':
+                    case ']':
+                    case ':':
+                    case ',':
+                        return fail(offset);
+                    default:
+                    {
+                        size_t atomEnd = offset;
+                        while (atomEnd < length && !s_IsDelimiter(json[atomEnd]))
+                        {
+                            ++atomEnd;
+                        }
+                        value = s_ParseAtom(json + offset, json + atomEnd, keyLength);
+                        ++k;
+                        break;
+                    }
+                }
+
+                if (value == nullptr)
+                {
+                    return fail(offset);
+                }
+
+                if (frames.empty())
+                {
+                    root = value;
+                }
+                else
+                {
+                    JsonParseFrame &frame = frames.back();
+                    if (frame.last != nullptr)
+                    {
+                        frame.last->next = value;
+                        value->prev = frame.last;
+                    }
+                    else
+                    {
+                        frame.container->child = value;
+                    }
+                    frame.last = value;
+
+                    if (isMember)
+                    {
+                        value->string = reinterpret_cast<char *>(value + 1) + valueLength;
+                        value->type |= cJSON_StringIsConst;
+                        const uint8_t *keyBegin = json + tokens[keyToken] + 1;
+                        if (!JsonUnescapeString(keyBegin, json + tokens[keyToken + 1], value->string))
+                        {
+                            return fail(tokens[keyToken]);
+                        }
+                    }
+                }
+
+                if (c == '{' || c == '[')
+                {
+                    if (frames.size() >= CJSON_NESTING_LIMIT)
+                    {
+                        return fail(offset);
+                    }
+
+                    uint8_t close = c == '{' ? '}' : ']';
+                    if (k >= count || json[tokens[k]] != close)
+                    {
+                        frames.push_back(JsonParseFrame{value, nullptr});
+                        if (c == '{' && !readKey())
+                        {
+                            return fail(k < count ? tokens[k] : length);
+                        }
+                        continue;
+                    }
+                    ++k;
+                }
+
+                /* after a value: commas and closing brackets until the next value is due */
+                for (;;)
+                {
+                    if (frames.empty())
+                    {
+                        if (k != count)
+                        {
+                            return fail(tokens[k]);
+                        }
+                        return root;
+                    }
+
+                    if (k >= count)
+                    {
+                        return fail(length);
+                    }
+
+                    bool inObject = (frames.back().container->type & 0xFF) == cJSON_Object;
+                    uint8_t token = json[tokens[k]];
+                    if (token == ',')
+                    {
+                        ++k;
+                        if (inObject && !readKey())
+                        {
+                            return fail(k < count ? tokens[k] : length);
+                        }
+                        break;
+                    }
+
+                    if (token != (inObject ? '}' : ']'))
+                    {
+                        return fail(tokens[k]);
+                    }
+                    frames.pop_back();
+                    ++k;
+                }
+            }
+        }
+    } // namespace Crt
+} // namespace Aws
@@ -6,6 +6,7 @@
 #include <aws/crt/JsonObject.h>
 
 #include <aws/crt/external/cJSON.h>
+#include <aws/crt/private/JsonText.h>
 
 #include <algorithm>
 #include <iterator>
@@ -14,17 +15,52 @@ namespace Aws
 {
     namespace Crt
     {
-        JsonObject::JsonObject() : m_wasParseSuccessful(true) { m_value = nullptr; }
+        static thread_local Allocator *s_scopedJsonAllocator = nullptr;
 
-        JsonObject::JsonObject(cJSON *value)
-            : m_value(cJSON_Duplicate(value, 1 /* recurse */)), m_wasParseSuccessful(true)
+        JsonAllocatorScope::JsonAllocatorScope(Allocator *allocator) noexcept : m_previous(s_scopedJsonAllocator)
         {
+            s_scopedJsonAllocator = allocator;
         }
 
-        JsonObject::JsonObject(const String &value) : m_wasParseSuccessful(true)
+        JsonAllocatorScope::~JsonAllocatorScope() { s_scopedJsonAllocator = m_previous; }
+
+        Allocator *JsonAllocatorScope::Current() noexcept { return s_scopedJsonAllocator; }
+
+        JsonObject::JsonObject() : m_allocator(nullptr), m_wasParseSuccessful(true) { m_value = nullptr; }
+
+        JsonObject::JsonObject(Allocator *allocator)
+            : m_value(nullptr), m_allocator(allocator), m_wasParseSuccessful(true)
+        {
+        }
+
+        JsonObject::JsonObject(cJSON *value) : m_allocator(nullptr), m_wasParseSuccessful(true)
+        {
+            JsonAllocatorScope scope(m_allocator);
+            m_value = cJSON_Duplicate(value, 1 /* recurse */);
+        }
+
+        JsonObject::JsonObject(const String &value) : JsonObject(value, JsonParserBackend::CJson) {}
+
+        JsonObject::JsonObject(const String &value, Allocator *allocator)
+            : JsonObject(value, JsonParserBackend::CJson, allocator)
+        {
+        }
+
+        JsonObject::JsonObject(const String &value, JsonParserBackend backend, Allocator *allocator)
+            : m_allocator(allocator), m_wasParseSuccessful(true)
         {
+            JsonAllocatorScope scope(m_allocator);
             const char *return_parse_end;
-            m_value = cJSON_ParseWithOpts(value.c_str(), value.length(), &return_parse_end);
+            if (backend == JsonParserBackend::Indexed)
+            {
+                size_t errorOffset = 0;
+                m_value = s_ParseIndexed(value.c_str(), value.length(), errorOffset);
+                return_parse_end = value.c_str() + errorOffset;
+            }
+            else
+            {
+                m_value = cJSON_ParseWithOpts(value.c_str(), value.length(), &return_parse_end);
+            }
 
             if (m_value == nullptr || cJSON_IsInvalid(m_value) == 1)
             {
@@ -35,19 +71,39 @@ namespace Aws
         }
 
         JsonObject::JsonObject(const JsonObject &value)
-            : m_value(cJSON_Duplicate(value.m_value, 1 /*recurse*/)), m_wasParseSuccessful(value.m_wasParseSuccessful),
+            : m_allocator(value.m_allocator), m_wasParseSuccessful(value.m_wasParseSuccessful),
               m_errorMessage(value.m_errorMessage)
         {
+            JsonAllocatorScope scope(m_allocator);
+            m_value = cJSON_Duplicate(value.m_value, 1 /*recurse*/);
         }
 
         JsonObject::JsonObject(JsonObject &&value) noexcept
-            : m_value(value.m_value), m_wasParseSuccessful(value.m_wasParseSuccessful),
+            : m_value(value.m_value), m_allocator(value.m_allocator), m_wasParseSuccessful(value.m_wasParseSuccessful),
               m_errorMessage(std::move(value.m_errorMessage))
         {
             value.m_value = nullptr;
         }
 
-        void JsonObject::Destroy() { cJSON_Delete(m_value); }
+        void JsonObject::Destroy()
+        {
+            JsonAllocatorScope scope(m_allocator);
+            cJSON_Delete(m_value);
+        }
+
+        /* nodes can only be moved between objects that share an allocator, others get a copy */
+        cJSON *JsonObject::TakeValue(JsonObject &value)
+        {
+            cJSON *taken = value.m_value;
+            if (taken == nullptr || value.m_allocator == m_allocator)
+            {
+                value.m_value = nullptr;
+                return taken;
+            }
+
+            JsonAllocatorScope scope(m_allocator);
+            return cJSON_Duplicate(taken, 1 /*recurse*/);
+        }
 
         JsonObject::~JsonObject() { Destroy(); }
 
@@ -59,6 +115,7 @@ namespace Aws
             }
 
             Destroy();
+            JsonAllocatorScope scope(m_allocator);
             m_value = cJSON_Duplicate(other.m_value, 1 /*recurse*/);
             m_wasParseSuccessful = other.m_wasParseSuccessful;
             m_errorMessage = other.m_errorMessage;
@@ -74,6 +131,7 @@ namespace Aws
 
             using std::swap;
             swap(m_value, other.m_value);
+            swap(m_allocator, other.m_allocator);
             swap(m_errorMessage, other.m_errorMessage);
             m_wasParseSuccessful = other.m_wasParseSuccessful;
             return *this;
@@ -94,6 +152,7 @@ namespace Aws
 
         JsonObject &JsonObject::WithString(const char *key, const String &value)
         {
+            JsonAllocatorScope scope(m_allocator);
             if (m_value == nullptr)
             {
                 m_value = cJSON_CreateObject();
@@ -111,6 +170,7 @@ namespace Aws
 
         JsonObject &JsonObject::AsString(const String &value)
         {
+            JsonAllocatorScope scope(m_allocator);
             Destroy();
             m_value = cJSON_CreateString(value.c_str());
             return *this;
@@ -118,6 +178,7 @@ namespace Aws
 
         JsonObject &JsonObject::WithBool(const char *key, bool value)
         {
+            JsonAllocatorScope scope(m_allocator);
             if (m_value == nullptr)
             {
                 m_value = cJSON_CreateObject();
@@ -132,6 +193,7 @@ namespace Aws
 
         JsonObject &JsonObject::AsBool(bool value)
         {
+            JsonAllocatorScope scope(m_allocator);
             Destroy();
             m_value = cJSON_CreateBool((cJSON_bool)value);
             return *this;
@@ -149,6 +211,7 @@ namespace Aws
 
         JsonObject &JsonObject::AsInteger(int value)
         {
+            JsonAllocatorScope scope(m_allocator);
             Destroy();
             m_value = cJSON_CreateNumber(static_cast<double>(value));
             return *this;
@@ -168,6 +231,7 @@ namespace Aws
 
         JsonObject &JsonObject::WithDouble(const char *key, double value)
         {
+            JsonAllocatorScope scope(m_allocator);
             if (m_value == nullptr)
             {
                 m_value = cJSON_CreateObject();
@@ -182,6 +246,7 @@ namespace Aws
 
         JsonObject &JsonObject::AsDouble(double value)
         {
+            JsonAllocatorScope scope(m_allocator);
             Destroy();
             m_value = cJSON_CreateNumber(value);
             return *this;
@@ -189,6 +254,7 @@ namespace Aws
 
         JsonObject &JsonObject::WithArray(const char *key, const Vector<String> &array)
         {
+            JsonAllocatorScope scope(m_allocator);
             if (m_value == nullptr)
             {
                 m_value = cJSON_CreateObject();
@@ -211,6 +277,12 @@ namespace Aws
 
         JsonObject &JsonObject::WithArray(const String &key, const Vector<JsonObject> &array)
         {
+            return WithArray(key.c_str(), array);
+        }
+
+        JsonObject &JsonObject::WithArray(const char *key, const Vector<JsonObject> &array)
+        {
+            JsonAllocatorScope scope(m_allocator);
             if (m_value == nullptr)
             {
                 m_value = cJSON_CreateObject();
@@ -222,12 +294,18 @@ namespace Aws
                 cJSON_AddItemToArray(arrayValue, cJSON_Duplicate(i.m_value, 1 /*recurse*/));
             }
 
-            AddOrReplace(m_value, key.c_str(), arrayValue);
+            AddOrReplace(m_value, key, arrayValue);
             return *this;
         }
 
         JsonObject &JsonObject::WithArray(const String &key, Vector<JsonObject> &&array)
         {
+            return WithArray(key.c_str(), std::move(array));
+        }
+
+        JsonObject &JsonObject::WithArray(const char *key, Vector<JsonObject> &&array)
+        {
+            JsonAllocatorScope scope(m_allocator);
             if (m_value == nullptr)
             {
                 m_value = cJSON_CreateObject();
@@ -236,16 +314,16 @@ namespace Aws
             auto arrayValue = cJSON_CreateArray();
             for (auto &i : array)
             {
-                cJSON_AddItemToArray(arrayValue, i.m_value);
-                i.m_value = nullptr;
+                cJSON_AddItemToArray(arrayValue, TakeValue(i));
             }
 
-            AddOrReplace(m_value, key.c_str(), arrayValue);
+            AddOrReplace(m_value, key, arrayValue);
             return *this;
         }
 
         JsonObject &JsonObject::AsArray(const Vector<JsonObject> &array)
         {
+            JsonAllocatorScope scope(m_allocator);
             auto arrayValue = cJSON_CreateArray();
             for (const auto &i : array)
             {
@@ -259,11 +337,11 @@ namespace Aws
 
         JsonObject &JsonObject::AsArray(Vector<JsonObject> &&array)
         {
+            JsonAllocatorScope scope(m_allocator);
             auto arrayValue = cJSON_CreateArray();
             for (auto &i : array)
             {
-                cJSON_AddItemToArray(arrayValue, i.m_value);
-                i.m_value = nullptr;
+                cJSON_AddItemToArray(arrayValue, TakeValue(i));
             }
 
             Destroy();
@@ -273,12 +351,14 @@ namespace Aws
 
         JsonObject &JsonObject::AsNull()
         {
+            JsonAllocatorScope scope(m_allocator);
             m_value = cJSON_CreateNull();
             return *this;
         }
 
         JsonObject &JsonObject::WithObject(const char *key, const JsonObject &value)
         {
+            JsonAllocatorScope scope(m_allocator);
             if (m_value == nullptr)
             {
                 m_value = cJSON_CreateObject();
@@ -297,13 +377,14 @@ namespace Aws
 
         JsonObject &JsonObject::WithObject(const char *key, JsonObject &&value)
         {
+            JsonAllocatorScope scope(m_allocator);
             if (m_value == nullptr)
             {
                 m_value = cJSON_CreateObject();
             }
 
-            AddOrReplace(m_value, key, value.m_value == nullptr ? cJSON_CreateObject() : value.m_value);
-            value.m_value = nullptr;
+            cJSON *taken = TakeValue(value);
+            AddOrReplace(m_value, key, taken == nullptr ? cJSON_CreateObject() : taken);
             return *this;
         }
 
@@ -324,6 +405,177 @@ namespace Aws
             return *this;
         }
 
+        /* reads the next reference token of a JSON Pointer into segment, undoing its ~0 and ~1 escapes */
+        static bool s_NextPointerSegment(const char *&cursor, const char *end, String &segment)
+        {
+            segment.clear();
+            for (++cursor; cursor < end && *cursor != '/'; ++cursor)
+            {
+                if (*cursor != '~')
+                {
+                    segment.push_back(*cursor);
+                    continue;
+                }
+
+                if (++cursor == end || (*cursor != '0' && *cursor != '1'))
+                {
+                    return false;
+                }
+                segment.push_back(*cursor == '0' ? '~' : '/');
+            }
+
+            return true;
+        }
+
+        /* an array index as RFC 6901 spells it: decimal, without leading zeros */
+        static bool s_ParseArrayIndex(const String &segment, int &index)
+        {
+            if (segment.empty() || segment.size() > 9 || (segment[0] == '0' && segment.size() > 1))
+            {
+                return false;
+            }
+
+            index = 0;
+            for (char c : segment)
+            {
+                if (c < '0' || c > '9')
+                {
+                    return false;
+                }
+                index = index * 10 + (c - '0');
+            }
+
+            return true;
+        }
+
+        bool JsonObject::SetAtPath(const StringView &pointer, JsonObject &&value)
+        {
+            if (pointer.empty())
+            {
+                JsonAllocatorScope scope(m_allocator);
+                cJSON *taken = TakeValue(value);
+                Destroy();
+                m_value = taken;
+                return true;
+            }
+
+            if (pointer[0] != '/' || (m_value != nullptr && !cJSON_IsObject(m_value) && !cJSON_IsArray(m_value)))
+            {
+                aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                return false;
+            }
+
+            Vector<String> segments;
+            const char *cursor = pointer.data();
+            const char *end = pointer.data() + pointer.size();
+            while (cursor != end)
+            {
+                String segment;
+                if (!s_NextPointerSegment(cursor, end, segment))
+                {
+                    aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                    return false;
+                }
+                segments.push_back(std::move(segment));
+            }
+
+            /*
+             * Walk the path once without changing anything, so a failure leaves the document as it was. Only arrays
+             * can fail the walk; a node of nullptr stands for an object the second walk will create.
+             */
+            const cJSON *existing = m_value;
+            for (size_t i = 0; i < segments.size(); ++i)
+            {
+                if (!cJSON_IsArray(existing))
+                {
+                    existing = existing == nullptr ? nullptr
+                                                   : cJSON_GetObjectItemCaseSensitive(existing, segments[i].c_str());
+                }
+                else
+                {
+                    int index = 0;
+                    int size = cJSON_GetArraySize(existing);
+                    bool last = i + 1 == segments.size();
+                    bool appends =
+                        last && (segments[i] == "-" || (s_ParseArrayIndex(segments[i], index) && index == size));
+                    if (!appends && (!s_ParseArrayIndex(segments[i], index) || index >= size))
+                    {
+                        aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                        return false;
+                    }
+                    existing = appends ? nullptr : cJSON_GetArrayItem(existing, index);
+                }
+
+                if (!cJSON_IsObject(existing) && !cJSON_IsArray(existing))
+                {
+                    existing = nullptr;
+                }
+            }
+
+            JsonAllocatorScope scope(m_allocator);
+            if (m_value == nullptr)
+            {
+                m_value = cJSON_CreateObject();
+            }
+
+            cJSON *node = m_value;
+            for (size_t i = 0; i + 1 < segments.size(); ++i)
+            {
+                cJSON *child = nullptr;
+                if (cJSON_IsArray(node))
+                {
+                    int index = 0;
+                    s_ParseArrayIndex(segments[i], index);
+                    child = cJSON_GetArrayItem(node, index);
+                    if (!cJSON_IsObject(child) && !cJSON_IsArray(child))
+                    {
+                        child = cJSON_CreateObject();
+                        cJSON_ReplaceItemInArray(node, index, child);
+                    }
+                }
+                else
+                {
+                    child = cJSON_GetObjectItemCaseSensitive(node, segments[i].c_str());
+                    if (!cJSON_IsObject(child) && !cJSON_IsArray(child))
+                    {
+                        child = cJSON_CreateObject();
+                        AddOrReplace(node, segments[i].c_str(), child);
+                    }
+                }
+                node = child;
+            }
+
+            const String &segment = segments.back();
+            cJSON *taken = TakeValue(value);
+            taken = taken == nullptr ? cJSON_CreateObject() : taken;
+            if (!cJSON_IsArray(node))
+            {
+                AddOrReplace(node, segment.c_str(), taken);
+                return true;
+            }
+
+            int index = 0;
+            if (segment == "-" || (s_ParseArrayIndex(segment, index) && index == cJSON_GetArraySize(node)))
+            {
+                cJSON_AddItemToArray(node, taken);
+            }
+            else
+            {
+                cJSON_ReplaceItemInArray(node, index, taken);
+            }
+            return true;
+        }
+
+        bool JsonObject::SetAtPath(const StringView &pointer, const JsonObject &value)
+        {
+            JsonObject copy(m_allocator);
+            {
+                JsonAllocatorScope scope(m_allocator);
+                copy.m_value = cJSON_Duplicate(value.m_value, 1 /*recurse*/);
+            }
+            return SetAtPath(pointer, std::move(copy));
+        }
+
         bool JsonObject::operator==(const JsonObject &other) const
         {
             return cJSON_Compare(m_value, other.m_value, 1 /*case-sensitive*/) != 0;
@@ -371,6 +623,25 @@ namespace Aws
             return str;
         }
 
+        StringView JsonView::GetStringView(const String &key) const { return GetStringView(key.c_str()); }
+
+        StringView JsonView::GetStringView(const char *key) const
+        {
+            AWS_ASSERT(m_value);
+            auto item = cJSON_GetObjectItemCaseSensitive(m_value, key);
+            return JsonView(item).AsStringView();
+        }
+
+        StringView JsonView::AsStringView() const
+        {
+            const char *str = cJSON_GetStringValue(m_value);
+            if (str == nullptr)
+            {
+                return {};
+            }
+            return StringView(str);
+        }
+
         bool JsonView::GetBool(const String &key) const { return GetBool(key.c_str()); }
 
         bool JsonView::GetBool(const char *key) const
@@ -502,6 +773,45 @@ namespace Aws
             return valueMap;
         }
 
+        JsonViewRange JsonView::GetChildren() const
+        {
+            if (cJSON_IsArray(m_value) == 0 && cJSON_IsObject(m_value) == 0)
+            {
+                return JsonViewRange(nullptr);
+            }
+            return JsonViewRange(m_value->child);
+        }
+
+        JsonViewRange JsonView::GetChildren(const String &key) const { return GetChildren(key.c_str()); }
+
+        JsonViewRange JsonView::GetChildren(const char *key) const
+        {
+            AWS_ASSERT(m_value);
+            return JsonView(cJSON_GetObjectItemCaseSensitive(m_value, key)).GetChildren();
+        }
+
+        JsonView JsonViewIterator::operator*() const noexcept { return JsonView(m_value); }
+
+        StringView JsonViewIterator::Key() const noexcept
+        {
+            AWS_ASSERT(m_value);
+            return m_value->string != nullptr ? StringView(m_value->string) : StringView();
+        }
+
+        JsonViewIterator &JsonViewIterator::operator++() noexcept
+        {
+            AWS_ASSERT(m_value);
+            m_value = m_value->next;
+            return *this;
+        }
+
+        JsonViewIterator JsonViewIterator::operator++(int) noexcept
+        {
+            JsonViewIterator current = *this;
+            ++*this;
+            return current;
+        }
+
         bool JsonView::ValueExists(const String &key) const { return ValueExists(key.c_str()); }
 
         bool JsonView::ValueExists(const char *key) const
@@ -527,6 +837,121 @@ namespace Aws
             return cJSON_GetObjectItemCaseSensitive(m_value, key) != nullptr;
         }
 
+        const size_t JsonKeyIndex::DefaultThreshold;
+
+        /* FNV-1a */
+        static uint32_t s_HashJsonKey(const char *key, size_t length)
+        {
+            uint32_t hash = 2166136261u;
+            for (size_t i = 0; i < length; ++i)
+            {
+                hash ^= static_cast<uint8_t>(key[i]);
+                hash *= 16777619u;
+            }
+            return hash;
+        }
+
+        JsonKeyIndex::JsonKeyIndex(const JsonView &object, size_t threshold, Allocator *allocator) noexcept
+            : m_object(cJSON_IsObject(object.m_value) != 0 ? object.m_value : nullptr),
+              m_slots(StlAllocator<Slot>(allocator))
+        {
+            if (m_object == nullptr)
+            {
+                return;
+            }
+
+            size_t members = 0;
+            for (cJSON *member = m_object->child; member != nullptr; member = member->next)
+            {
+                ++members;
+            }
+            if (members < threshold || members == 0)
+            {
+                return;
+            }
+
+            size_t capacity = 8;
+            while (capacity < members * 2)
+            {
+                capacity *= 2;
+            }
+            m_slots.resize(capacity, Slot{nullptr, 0, 0});
+
+            size_t mask = capacity - 1;
+            for (cJSON *member = m_object->child; member != nullptr; member = member->next)
+            {
+                if (member->string == nullptr)
+                {
+                    continue;
+                }
+
+                size_t keyLength = strlen(member->string);
+                uint32_t hash = s_HashJsonKey(member->string, keyLength);
+                for (size_t i = hash & mask;; i = (i + 1) & mask)
+                {
+                    Slot &slot = m_slots[i];
+                    if (slot.node == nullptr)
+                    {
+                        slot = Slot{member, hash, static_cast<uint32_t>(keyLength)};
+                        break;
+                    }
+                    /* a duplicate key keeps its first occurrence, as cJSON's lookups do */
+                    if (slot.hash == hash && slot.keyLength == keyLength &&
+                        memcmp(slot.node->string, member->string, keyLength) == 0)
+                    {
+                        break;
+                    }
+                }
+            }
+        }
+
+        cJSON *JsonKeyIndex::Find(const StringView &key) const noexcept
+        {
+            if (m_slots.empty())
+            {
+                for (cJSON *member = m_object != nullptr ? m_object->child : nullptr; member != nullptr;
+                     member = member->next)
+                {
+                    if (member->string != nullptr && key.compare(member->string) == 0)
+                    {
+                        return member;
+                    }
+                }
+                return nullptr;
+            }
+
+            uint32_t hash = s_HashJsonKey(key.data(), key.size());
+            size_t mask = m_slots.size() - 1;
+            for (size_t i = hash & mask;; i = (i + 1) & mask)
+            {
+                const Slot &slot = m_slots[i];
+                if (slot.node == nullptr)
+                {
+                    return nullptr;
+                }
+                if (slot.hash == hash && slot.keyLength == key.size() &&
+                    memcmp(slot.node->string, key.data(), key.size()) == 0)
+                {
+                    return slot.node;
+                }
+            }
+        }
+
+        JsonView JsonKeyIndex::Get(const StringView &key) const noexcept { return JsonView(Find(key)); }
+
+        StringView JsonKeyIndex::GetStringView(const StringView &key) const noexcept
+        {
+            return JsonView(Find(key)).AsStringView();
+        }
+
+        bool JsonKeyIndex::ValueExists(const StringView &key) const noexcept
+        {
+            cJSON *member = Find(key);
+            return member != nullptr && cJSON_IsNull(member) == 0;
+        }
+
+        bool JsonKeyIndex::KeyExists(const StringView &key) const noexcept { return Find(key) != nullptr; }
+
         bool JsonView::IsObject() const { return cJSON_IsObject(m_value) != 0; }
 
         bool JsonView::IsBool() const { return cJSON_IsBool(m_value) != 0; }
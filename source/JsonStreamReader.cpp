@@ -0,0 +1,391 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/JsonStreamReader.h>
+
+#include <aws/crt/private/JsonText.h>
+
+#include <cstring>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        const size_t JsonStreamReader::DefaultMaxTokenLength;
+        const size_t JsonStreamReader::MaxDepth;
+
+        static inline bool s_IsWhitespace(uint8_t c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+        static inline bool s_IsDelimiter(uint8_t c)
+        {
+            return s_IsWhitespace(c) || c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',' ||
+                   c == '"';
+        }
+
+        static inline bool s_StartsAtom(uint8_t c)
+        {
+            return c == '-' || (c >= '0' && c <= '9') || c == 't' || c == 'f' || c == 'n';
+        }
+
+        JsonStreamReader::JsonStreamReader(
+            OnJsonReaderEvent &&onEvent,
+            size_t maxTokenLength,
+            Allocator *allocator) noexcept
+            : m_allocator(allocator), m_onEvent(std::move(onEvent)), m_maxTokenLength(maxTokenLength),
+              m_containers(allocator), m_state(ReaderState::Value), m_token(TokenKind::None), m_escaped(false),
+              m_lastError(AWS_ERROR_SUCCESS)
+        {
+            AWS_ZERO_STRUCT(m_tokenBuffer);
+            AWS_ZERO_STRUCT(m_text);
+        }
+
+        JsonStreamReader::~JsonStreamReader()
+        {
+            if (m_tokenBuffer.allocator != nullptr)
+            {
+                aws_byte_buf_clean_up(&m_tokenBuffer);
+            }
+            if (m_text.allocator != nullptr)
+            {
+                aws_byte_buf_clean_up(&m_text);
+            }
+        }
+
+        bool JsonStreamReader::Fail(int errorCode) noexcept
+        {
+            m_lastError = errorCode != AWS_ERROR_SUCCESS ? errorCode : AWS_ERROR_UNKNOWN;
+            aws_raise_error(m_lastError);
+            return false;
+        }
+
+        void JsonStreamReader::Emit(JsonReaderEventType type, size_t depth) noexcept
+        {
+            m_event.Type = type;
+            m_event.Depth = depth;
+            if (m_onEvent)
+            {
+                m_onEvent(m_event);
+            }
+            m_event.Text = StringView();
+        }
+
+        void JsonStreamReader::FinishValue() noexcept
+        {
+            m_state = m_containers.empty() ? ReaderState::Done : ReaderState::CommaOrEnd;
+        }
+
+        bool JsonStreamReader::Open(uint8_t bracket) noexcept
+        {
+            if (m_containers.size() >= MaxDepth)
+            {
+                return Fail(AWS_ERROR_MALFORMED_INPUT_STRING);
+            }
+
+            bool isObject = bracket == '{';
+            Emit(isObject ? JsonReaderEventType::BeginObject : JsonReaderEventType::BeginArray, m_containers.size());
+            m_containers.push_back(bracket);
+            m_state = isObject ? ReaderState::KeyOrEnd : ReaderState::ValueOrEnd;
+            return true;
+        }
+
+        bool JsonStreamReader::Close(uint8_t bracket) noexcept
+        {
+            bool isObject = m_containers.back() == '{';
+            if (bracket != (isObject ? '}' : ']'))
+            {
+                return Fail(AWS_ERROR_MALFORMED_INPUT_STRING);
+            }
+
+            m_containers.pop_back();
+            Emit(isObject ? JsonReaderEventType::EndObject : JsonReaderEventType::EndArray, m_containers.size());
+            FinishValue();
+            return true;
+        }
+
+        bool JsonStreamReader::ReadStructural(const uint8_t *&cursor) noexcept
+        {
+            uint8_t c = *cursor;
+            switch (m_state)
+            {
+                case ReaderState::Value:
+                case ReaderState::ValueOrEnd:
+                    if (c == '{' || c == '[' || (c == ']' && m_state == ReaderState::ValueOrEnd))
+                    {
+                        ++cursor;
+                        return c == ']' ? Close(c) : Open(c);
+                    }
+                    if (c == '"')
+                    {
+                        ++cursor;
+                        m_token = TokenKind::String;
+                        return true;
+                    }
+                    if (s_StartsAtom(c))
+                    {
+                        /* the first byte is part of the atom, so it is left for ReadToken() */
+                        m_token = TokenKind::Atom;
+                        return true;
+                    }
+                    break;
+                case ReaderState::Key:
+                case ReaderState::KeyOrEnd:
+                    if (c == '}' && m_state == ReaderState::KeyOrEnd)
+                    {
+                        ++cursor;
+                        return Close(c);
+                    }
+                    if (c == '"')
+                    {
+                        ++cursor;
+                        m_token = TokenKind::Key;
+                        return true;
+                    }
+                    break;
+                case ReaderState::Colon:
+                    if (c == ':')
+                    {
+                        ++cursor;
+                        m_state = ReaderState::Value;
+                        return true;
+                    }
+                    break;
+                case ReaderState::CommaOrEnd:
+                    if (c == ',')
+                    {
+                        ++cursor;
+                        m_state = m_containers.back() == '{' ? ReaderState::Key : ReaderState::Value;
+                        return true;
+                    }
+                    if (c == '}' || c == ']')
+                    {
+                        ++cursor;
+                        return Close(c);
+                    }
+                    break;
+                case ReaderState::Done:
+                    break;
+            }
+
+            return Fail(AWS_ERROR_MALFORMED_INPUT_STRING);
+        }
+
+        bool JsonStreamReader::ReadToken(const uint8_t *&cursor, const uint8_t *end) noexcept
+        {
+            const uint8_t *begin = cursor;
+            if (m_token == TokenKind::Atom)
+            {
+                while (cursor < end && !s_IsDelimiter(*cursor))
+                {
+                    ++cursor;
+                }
+            }
+            else
+            {
+                for (; cursor < end; ++cursor)
+                {
+                    uint8_t c = *cursor;
+                    if (m_escaped)
+                    {
+                        m_escaped = false;
+                    }
+                    else if (c == '\\')
+                    {
+                        m_escaped = true;
+                    }
+                    else if (c == '"')
+                    {
+                        break;
+                    }
+                    else if (c < 0x20)
+                    {
+                        return Fail(AWS_ERROR_MALFORMED_INPUT_STRING);
+                    }
+                }
+            }
+
+            size_t length = static_cast<size_t>(cursor - begin);
+            if (length > m_maxTokenLength - m_tokenBuffer.len)
+            {
+                return Fail(AWS_ERROR_MALFORMED_INPUT_STRING);
+            }
+
+            /* a token that is whole within this chunk is read straight from it */
+            bool complete = cursor < end;
+            if (complete && m_tokenBuffer.len == 0)
+            {
+                TokenKind kind = m_token;
+                m_token = TokenKind::None;
+                cursor += kind == TokenKind::Atom ? 0 : 1;
+                return EmitToken(kind, begin, begin + length);
+            }
+
+            if (m_tokenBuffer.allocator == nullptr && aws_byte_buf_init(&m_tokenBuffer, m_allocator, 64))
+            {
+                return Fail(aws_last_error());
+            }
+
+            ByteCursor part = aws_byte_cursor_from_array(begin, length);
+            if (aws_byte_buf_append_dynamic(&m_tokenBuffer, &part))
+            {
+                return Fail(aws_last_error());
+            }
+
+            if (!complete)
+            {
+                return true;
+            }
+
+            TokenKind kind = m_token;
+            m_token = TokenKind::None;
+            cursor += kind == TokenKind::Atom ? 0 : 1;
+            bool emitted = EmitToken(kind, m_tokenBuffer.buffer, m_tokenBuffer.buffer + m_tokenBuffer.len);
+            m_tokenBuffer.len = 0;
+            return emitted;
+        }
+
+        bool JsonStreamReader::EmitToken(TokenKind kind, const uint8_t *begin, const uint8_t *end) noexcept
+        {
+            size_t length = static_cast<size_t>(end - begin);
+            if (kind == TokenKind::Atom)
+            {
+                if (length == 4 && memcmp(begin, "true", 4) == 0)
+                {
+                    m_event.Bool = true;
+                    Emit(JsonReaderEventType::Bool, m_containers.size());
+                }
+                else if (length == 5 && memcmp(begin, "false", 5) == 0)
+                {
+                    m_event.Bool = false;
+                    Emit(JsonReaderEventType::Bool, m_containers.size());
+                }
+                else if (length == 4 && memcmp(begin, "null", 4) == 0)
+                {
+                    Emit(JsonReaderEventType::Null, m_containers.size());
+                }
+                else
+                {
+                    if (!JsonParseNumber(begin, end, m_event.Number))
+                    {
+                        return Fail(AWS_ERROR_MALFORMED_INPUT_STRING);
+                    }
+                    m_event.Text = StringView(reinterpret_cast<const char *>(begin), length);
+                    Emit(JsonReaderEventType::Number, m_containers.size());
+                }
+
+                FinishValue();
+                return true;
+            }
+
+            /* unescaping never makes a string longer */
+            if (m_text.allocator == nullptr && aws_byte_buf_init(&m_text, m_allocator, length + 1))
+            {
+                return Fail(aws_last_error());
+            }
+            if (aws_byte_buf_reserve(&m_text, length + 1))
+            {
+                return Fail(aws_last_error());
+            }
+
+            auto *text = reinterpret_cast<char *>(m_text.buffer);
+            const char *textEnd = JsonUnescapeString(begin, end, text);
+            if (textEnd == nullptr)
+            {
+                return Fail(AWS_ERROR_MALFORMED_INPUT_STRING);
+            }
+
+            m_event.Text = StringView(text, static_cast<size_t>(textEnd - text));
+            if (kind == TokenKind::Key)
+            {
+                Emit(JsonReaderEventType::Key, m_containers.size());
+                m_state = ReaderState::Colon;
+            }
+            else
+            {
+                Emit(JsonReaderEventType::String, m_containers.size());
+                FinishValue();
+            }
+
+            return true;
+        }
+
+        bool JsonStreamReader::Feed(const ByteCursor &data) noexcept
+        {
+            if (m_lastError != AWS_ERROR_SUCCESS)
+            {
+                aws_raise_error(m_lastError);
+                return false;
+            }
+
+            const uint8_t *cursor = data.ptr;
+            const uint8_t *end = data.ptr + data.len;
+            while (cursor < end)
+            {
+                if (m_token != TokenKind::None)
+                {
+                    if (!ReadToken(cursor, end))
+                    {
+                        return false;
+                    }
+                    continue;
+                }
+
+                if (s_IsWhitespace(*cursor))
+                {
+                    ++cursor;
+                    continue;
+                }
+
+                if (!ReadStructural(cursor))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        bool JsonStreamReader::Finish() noexcept
+        {
+            if (m_lastError != AWS_ERROR_SUCCESS)
+            {
+                aws_raise_error(m_lastError);
+                return false;
+            }
+
+            if (m_token == TokenKind::Atom)
+            {
+                m_token = TokenKind::None;
+                bool emitted = EmitToken(
+                    TokenKind::Atom, m_tokenBuffer.buffer, m_tokenBuffer.buffer + m_tokenBuffer.len);
+                m_tokenBuffer.len = 0;
+                if (!emitted)
+                {
+                    return false;
+                }
+            }
+
+            if (!IsComplete())
+            {
+                return Fail(AWS_ERROR_MALFORMED_INPUT_STRING);
+            }
+
+            return true;
+        }
+
+        JsonBodySink::JsonBodySink(OnJsonReaderEvent &&onEvent, size_t maxTokenLength, Allocator *allocator) noexcept
+            : m_reader(std::move(onEvent), maxTokenLength, allocator)
+        {
+        }
+
+        size_t JsonBodySink::OnBodyData(const ByteCursor &data) noexcept
+        {
+            if (m_reader && !m_reader.Feed(data) && OnParseError)
+            {
+                OnParseError(m_reader.LastError());
+            }
+
+            return data.len;
+        }
+    } // namespace Crt
+} // namespace Aws
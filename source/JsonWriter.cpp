@@ -0,0 +1,319 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/JsonWriter.h>
+
+#include <cinttypes>
+#include <clocale>
+#include <cstdio>
+#include <cstdlib>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        JsonWriter::JsonWriter(ByteBuf &output) noexcept
+            : m_output(output), m_containers(output.allocator != nullptr ? output.allocator : g_allocator),
+              m_needComma(false), m_afterKey(false), m_wroteValue(false), m_lastError(AWS_ERROR_SUCCESS)
+        {
+        }
+
+        void JsonWriter::Fail(int errorCode) noexcept
+        {
+            m_lastError = errorCode != AWS_ERROR_SUCCESS ? errorCode : AWS_ERROR_UNKNOWN;
+            aws_raise_error(m_lastError);
+        }
+
+        bool JsonWriter::Append(const void *data, size_t length) noexcept
+        {
+            ByteCursor toWrite = aws_byte_cursor_from_array(data, length);
+            int appendResult = m_output.allocator != nullptr ? aws_byte_buf_append_dynamic(&m_output, &toWrite)
+                                                             : aws_byte_buf_append(&m_output, &toWrite);
+            if (appendResult)
+            {
+                Fail(aws_last_error());
+                return false;
+            }
+
+            return true;
+        }
+
+        /* writes the comma a value needs, or fails if no value is due */
+        bool JsonWriter::BeginValue() noexcept
+        {
+            if (m_lastError != AWS_ERROR_SUCCESS)
+            {
+                return false;
+            }
+
+            if (m_containers.empty())
+            {
+                if (m_wroteValue)
+                {
+                    Fail(AWS_ERROR_INVALID_STATE);
+                    return false;
+                }
+                m_wroteValue = true;
+                return true;
+            }
+
+            if (m_containers.back() == '{')
+            {
+                if (!m_afterKey)
+                {
+                    Fail(AWS_ERROR_INVALID_STATE);
+                    return false;
+                }
+                m_afterKey = false;
+                return true;
+            }
+
+            if (m_needComma && !Append(",", 1))
+            {
+                return false;
+            }
+            m_needComma = true;
+            return true;
+        }
+
+        JsonWriter &JsonWriter::BeginObject() noexcept
+        {
+            if (BeginValue() && Append("{", 1))
+            {
+                m_containers.push_back('{');
+                m_needComma = false;
+            }
+
+            return *this;
+        }
+
+        JsonWriter &JsonWriter::BeginArray() noexcept
+        {
+            if (BeginValue() && Append("[", 1))
+            {
+                m_containers.push_back('[');
+                m_needComma = false;
+            }
+
+            return *this;
+        }
+
+        JsonWriter &JsonWriter::EndObject() noexcept
+        {
+            if (m_lastError != AWS_ERROR_SUCCESS)
+            {
+                return *this;
+            }
+
+            if (m_containers.empty() || m_containers.back() != '{' || m_afterKey)
+            {
+                Fail(AWS_ERROR_INVALID_STATE);
+                return *this;
+            }
+
+            if (Append("}", 1))
+            {
+                m_containers.pop_back();
+                m_needComma = true;
+            }
+
+            return *this;
+        }
+
+        JsonWriter &JsonWriter::EndArray() noexcept
+        {
+            if (m_lastError != AWS_ERROR_SUCCESS)
+            {
+                return *this;
+            }
+
+            if (m_containers.empty() || m_containers.back() != '[')
+            {
+                Fail(AWS_ERROR_INVALID_STATE);
+                return *this;
+            }
+
+            if (Append("]", 1))
+            {
+                m_containers.pop_back();
+                m_needComma = true;
+            }
+
+            return *this;
+        }
+
+        JsonWriter &JsonWriter::Key(const StringView &key) noexcept
+        {
+            if (m_lastError != AWS_ERROR_SUCCESS)
+            {
+                return *this;
+            }
+
+            if (m_containers.empty() || m_containers.back() != '{' || m_afterKey)
+            {
+                Fail(AWS_ERROR_INVALID_STATE);
+                return *this;
+            }
+
+            if ((!m_needComma || Append(",", 1)) && AppendString(key) && Append(":", 1))
+            {
+                m_needComma = true;
+                m_afterKey = true;
+            }
+
+            return *this;
+        }
+
+        bool JsonWriter::AppendString(const StringView &value) noexcept
+        {
+            static const char s_hexDigits[] = "0123456789abcdef";
+
+            if (!Append("\"", 1))
+            {
+                return false;
+            }
+
+            /* runs of bytes that need no escaping are copied in one go */
+            const char *run = value.data();
+            const char *end = value.data() + value.size();
+            for (const char *cursor = run; cursor < end; ++cursor)
+            {
+                auto c = static_cast<uint8_t>(*cursor);
+                if (c >= 0x20 && c != '"' && c != '\\')
+                {
+                    continue;
+                }
+
+                char escaped[6] = {'\\', 0, 0, 0, 0, 0};
+                size_t escapedLength = 2;
+                switch (c)
+                {
+                    case '"':
+                    case '\\':
+                        escaped[1] = static_cast<char>(c);
+                        break;
+                    case '\b':
+                        escaped[1] = 'b';
+                        break;
+                    case '\f':
+                        escaped[1] = 'f';
+                        break;
+                    case '\n':
+                        escaped[1] = 'n';
+                        break;
+                    case '\r':
+                        escaped[1] = 'r';
+                        break;
+                    case '\t':
+                        escaped[1] = 't';
+                        break;
+                    default:
+                        escaped[1] = 'u';
+                        escaped[2] = '0';
+                        escaped[3] = '0';
+                        escaped[4] = s_hexDigits[c >> 4];
+                        escaped[5] = s_hexDigits[c & 0xf];
+                        escapedLength = 6;
+                        break;
+                }
+
+                if (!Append(run, static_cast<size_t>(cursor - run)) || !Append(escaped, escapedLength))
+                {
+                    return false;
+                }
+                run = cursor + 1;
+            }
+
+            return Append(run, static_cast<size_t>(end - run)) && Append("\"", 1);
+        }
+
+        JsonWriter &JsonWriter::WriteString(const StringView &value) noexcept
+        {
+            if (BeginValue())
+            {
+                AppendString(value);
+            }
+
+            return *this;
+        }
+
+        JsonWriter &JsonWriter::WriteBool(bool value) noexcept
+        {
+            if (BeginValue())
+            {
+                Append(value ? "true" : "false", value ? 4 : 5);
+            }
+
+            return *this;
+        }
+
+        JsonWriter &JsonWriter::WriteInt64(int64_t value) noexcept
+        {
+            if (BeginValue())
+            {
+                char number[24];
+                int length = snprintf(number, sizeof(number), "%" PRId64, value);
+                Append(number, static_cast<size_t>(length));
+            }
+
+            return *this;
+        }
+
+        JsonWriter &JsonWriter::WriteDouble(double value) noexcept
+        {
+            if (!BeginValue())
+            {
+                return *this;
+            }
+
+            /* the same as cJSON's print_number(): 15 digits unless that does not round-trip, then 17 */
+            char number[32];
+            int length = 0;
+            if (value * 0 != 0)
+            {
+                length = snprintf(number, sizeof(number), "null");
+            }
+            else
+            {
+                length = snprintf(number, sizeof(number), "%1.15g", value);
+                if (strtod(number, nullptr) != value)
+                {
+                    length = snprintf(number, sizeof(number), "%1.17g", value);
+                }
+            }
+
+            char decimalPoint = *localeconv()->decimal_point;
+            for (int i = 0; i < length; ++i)
+            {
+                if (number[i] == decimalPoint)
+                {
+                    number[i] = '.';
+                }
+            }
+
+            Append(number, static_cast<size_t>(length));
+            return *this;
+        }
+
+        JsonWriter &JsonWriter::WriteNull() noexcept
+        {
+            if (BeginValue())
+            {
+                Append("null", 4);
+            }
+
+            return *this;
+        }
+
+        JsonWriter &JsonWriter::WriteRaw(const StringView &json) noexcept
+        {
+            if (BeginValue())
+            {
+                Append(json.data(), json.size());
+            }
+
+            return *this;
+        }
+    } // namespace Crt
+} // namespace Aws
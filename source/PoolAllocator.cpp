@@ -0,0 +1,277 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/PoolAllocator.h>
+
+#include <aws/common/math.h>
+
+#include <cstring>
+#include <new>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        static const size_t s_poolSizeClasses[] = {16, 32, 64, 128, 256, PoolAllocator::MaxPooledSize};
+        static const size_t s_poolSizeClassCount = sizeof(s_poolSizeClasses) / sizeof(s_poolSizeClasses[0]);
+        static const uint32_t s_poolLargeClass = static_cast<uint32_t>(s_poolSizeClassCount);
+
+        /* every block is prefixed with this so release can find its size class and owning pool */
+        struct alignas(std::max_align_t) PoolBlockHeader
+        {
+            PoolAllocator *pool;
+            uint32_t sizeClass;
+        };
+
+        struct PoolFreeNode
+        {
+            PoolFreeNode *next;
+        };
+
+        static uint32_t s_sizeClassFor(size_t size) noexcept
+        {
+            for (uint32_t i = 0; i < s_poolSizeClassCount; ++i)
+            {
+                if (size <= s_poolSizeClasses[i])
+                {
+                    return i;
+                }
+            }
+
+            return s_poolLargeClass;
+        }
+
+        static void *s_blockData(PoolBlockHeader *header) noexcept
+        {
+            return reinterpret_cast<uint8_t *>(header) + sizeof(PoolBlockHeader);
+        }
+
+        static PoolBlockHeader *s_blockHeader(void *ptr) noexcept
+        {
+            return reinterpret_cast<PoolBlockHeader *>(static_cast<uint8_t *>(ptr) - sizeof(PoolBlockHeader));
+        }
+
+        /**
+         * Per-thread free lists. A thread is attached to at most one pool at a time; allocations from any other
+         * pool on that thread bypass the cache.
+         */
+        struct PoolThreadCache
+        {
+            PoolThreadCache() noexcept : owner(nullptr), shutDown(false)
+            {
+                for (size_t i = 0; i < s_poolSizeClassCount; ++i)
+                {
+                    freeLists[i] = nullptr;
+                    counts[i] = 0;
+                }
+            }
+
+            ~PoolThreadCache()
+            {
+                Detach();
+                shutDown = true;
+            }
+
+            /* returns true if this thread's cache can be used for pool */
+            bool AttachTo(PoolAllocator *pool) noexcept
+            {
+                if (owner == pool)
+                {
+                    return true;
+                }
+
+                if (owner != nullptr || shutDown)
+                {
+                    return false;
+                }
+
+                pool->Acquire();
+                owner = pool;
+                return true;
+            }
+
+            void Detach() noexcept
+            {
+                if (owner == nullptr)
+                {
+                    return;
+                }
+
+                for (size_t i = 0; i < s_poolSizeClassCount; ++i)
+                {
+                    while (freeLists[i] != nullptr)
+                    {
+                        PoolFreeNode *node = freeLists[i];
+                        freeLists[i] = node->next;
+                        aws_mem_release(owner->m_parent, s_blockHeader(node));
+                    }
+                    counts[i] = 0;
+                }
+
+                PoolAllocator *pool = owner;
+                owner = nullptr;
+                pool->Unref();
+            }
+
+            PoolAllocator *owner;
+            PoolFreeNode *freeLists[s_poolSizeClassCount];
+            size_t counts[s_poolSizeClassCount];
+            bool shutDown;
+        };
+
+        static thread_local PoolThreadCache s_threadCache;
+
+        const size_t PoolAllocator::MaxPooledSize;
+        const size_t PoolAllocator::MaxCachedBlocksPerClass;
+
+        PoolAllocator *PoolAllocator::Create(Allocator *parent) noexcept
+        {
+            void *mem = aws_mem_acquire(parent, sizeof(PoolAllocator));
+            if (mem == nullptr)
+            {
+                return nullptr;
+            }
+
+            return new (mem) PoolAllocator(parent);
+        }
+
+        PoolAllocator::PoolAllocator(Allocator *parent) noexcept : m_parent(parent), m_refCount(1)
+        {
+            AWS_ZERO_STRUCT(m_allocator);
+            m_allocator.mem_acquire = s_MemAcquire;
+            m_allocator.mem_release = s_MemRelease;
+            m_allocator.mem_realloc = s_MemRealloc;
+            m_allocator.mem_calloc = s_MemCalloc;
+            m_allocator.impl = this;
+        }
+
+        void PoolAllocator::Release() noexcept
+        {
+            TrimThreadCache();
+            Unref();
+        }
+
+        void PoolAllocator::TrimThreadCache() noexcept
+        {
+            if (s_threadCache.owner == this)
+            {
+                s_threadCache.Detach();
+            }
+        }
+
+        void PoolAllocator::Acquire() noexcept { m_refCount.fetch_add(1, std::memory_order_relaxed); }
+
+        void PoolAllocator::Unref() noexcept
+        {
+            if (m_refCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                Allocator *parent = m_parent;
+                this->~PoolAllocator();
+                aws_mem_release(parent, this);
+            }
+        }
+
+        void *PoolAllocator::s_MemAcquire(Allocator *allocator, size_t size)
+        {
+            auto *pool = static_cast<PoolAllocator *>(allocator->impl);
+            uint32_t sizeClass = s_sizeClassFor(size);
+
+            if (sizeClass != s_poolLargeClass && s_threadCache.AttachTo(pool))
+            {
+                PoolFreeNode *node = s_threadCache.freeLists[sizeClass];
+                if (node != nullptr)
+                {
+                    s_threadCache.freeLists[sizeClass] = node->next;
+                    s_threadCache.counts[sizeClass]--;
+                    pool->Acquire();
+                    return node;
+                }
+            }
+
+            size_t blockSize = 0;
+            size_t dataSize = sizeClass == s_poolLargeClass ? size : s_poolSizeClasses[sizeClass];
+            if (aws_add_size_checked(sizeof(PoolBlockHeader), dataSize, &blockSize))
+            {
+                return nullptr;
+            }
+
+            auto *header = static_cast<PoolBlockHeader *>(aws_mem_acquire(pool->m_parent, blockSize));
+            if (header == nullptr)
+            {
+                return nullptr;
+            }
+
+            /* held until the block is released, so the pool outlives every block handed out from it */
+            pool->Acquire();
+            header->pool = pool;
+            header->sizeClass = sizeClass;
+            return s_blockData(header);
+        }
+
+        void PoolAllocator::s_MemRelease(Allocator *, void *ptr)
+        {
+            PoolBlockHeader *header = s_blockHeader(ptr);
+            PoolAllocator *pool = header->pool;
+            uint32_t sizeClass = header->sizeClass;
+
+            /*
+             * Only a thread that allocates from the pool caches what it releases; attaching any other thread here
+             * would keep the pool alive until that thread exits.
+             */
+            if (sizeClass != s_poolLargeClass && s_threadCache.owner == pool &&
+                s_threadCache.counts[sizeClass] < MaxCachedBlocksPerClass)
+            {
+                auto *node = static_cast<PoolFreeNode *>(ptr);
+                node->next = s_threadCache.freeLists[sizeClass];
+                s_threadCache.freeLists[sizeClass] = node;
+                s_threadCache.counts[sizeClass]++;
+            }
+            else
+            {
+                aws_mem_release(pool->m_parent, header);
+            }
+
+            /* the block's reference, which may be the last one once the owner has called Release() */
+            pool->Unref();
+        }
+
+        void *PoolAllocator::s_MemRealloc(Allocator *allocator, void *ptr, size_t oldSize, size_t newSize)
+        {
+            if (ptr != nullptr)
+            {
+                uint32_t sizeClass = s_blockHeader(ptr)->sizeClass;
+                if (sizeClass != s_poolLargeClass && newSize <= s_poolSizeClasses[sizeClass])
+                {
+                    return ptr;
+                }
+            }
+
+            void *mem = s_MemAcquire(allocator, newSize);
+            if (mem != nullptr && ptr != nullptr)
+            {
+                memcpy(mem, ptr, oldSize < newSize ? oldSize : newSize);
+                s_MemRelease(allocator, ptr);
+            }
+
+            return mem;
+        }
+
+        void *PoolAllocator::s_MemCalloc(Allocator *allocator, size_t num, size_t size)
+        {
+            size_t total = 0;
+            if (aws_mul_size_checked(num, size, &total))
+            {
+                return nullptr;
+            }
+
+            void *mem = s_MemAcquire(allocator, total);
+            if (mem != nullptr)
+            {
+                memset(mem, 0, total);
+            }
+
+            return mem;
+        }
+    } // namespace Crt
+} // namespace Aws
@@ -0,0 +1,190 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/TracingAllocator.h>
+
+#include <aws/common/math.h>
+
+#include <cstring>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        /* every traced block is prefixed with this so release knows what to uncount */
+        struct alignas(std::max_align_t) TracedBlockHeader
+        {
+            size_t size;
+            size_t subsystem;
+        };
+
+        static void *s_tracedData(TracedBlockHeader *header) noexcept
+        {
+            return reinterpret_cast<uint8_t *>(header) + sizeof(TracedBlockHeader);
+        }
+
+        static TracedBlockHeader *s_tracedHeader(void *ptr) noexcept
+        {
+            return reinterpret_cast<TracedBlockHeader *>(static_cast<uint8_t *>(ptr) - sizeof(TracedBlockHeader));
+        }
+
+        static void s_updateHighWater(std::atomic<size_t> &highWater, size_t value) noexcept
+        {
+            size_t current = highWater.load(std::memory_order_relaxed);
+            while (value > current && !highWater.compare_exchange_weak(current, value, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        AllocationStats::AllocationStats() noexcept
+            : TotalAllocations(0), TotalBytes(0), LiveAllocations(0), LiveBytes(0), HighWaterBytes(0)
+        {
+        }
+
+        const size_t TracingAllocator::SubsystemCount;
+
+        TracingAllocator::TracingAllocator(Allocator *parent) noexcept : m_parent(parent)
+        {
+            for (size_t i = 0; i <= SubsystemCount; ++i)
+            {
+                Counters &counters = i < SubsystemCount ? m_counters[i] : m_total;
+                counters.totalAllocations.store(0);
+                counters.totalBytes.store(0);
+                counters.liveAllocations.store(0);
+                counters.liveBytes.store(0);
+                counters.highWaterBytes.store(0);
+            }
+
+            for (size_t i = 0; i < SubsystemCount; ++i)
+            {
+                AWS_ZERO_STRUCT(m_allocators[i]);
+                m_allocators[i].mem_acquire = s_MemAcquire;
+                m_allocators[i].mem_release = s_MemRelease;
+                m_allocators[i].mem_realloc = s_MemRealloc;
+                m_allocators[i].mem_calloc = s_MemCalloc;
+                m_allocators[i].impl = this;
+            }
+        }
+
+        Allocator *TracingAllocator::GetAllocator(AllocationSubsystem subsystem) noexcept
+        {
+            return &m_allocators[static_cast<size_t>(subsystem)];
+        }
+
+        AllocationStats TracingAllocator::GetStats(AllocationSubsystem subsystem) const noexcept
+        {
+            return s_ToStats(m_counters[static_cast<size_t>(subsystem)]);
+        }
+
+        AllocationStats TracingAllocator::GetTotalStats() const noexcept { return s_ToStats(m_total); }
+
+        AllocationStats TracingAllocator::s_ToStats(const Counters &counters) noexcept
+        {
+            AllocationStats stats;
+            stats.TotalAllocations = counters.totalAllocations.load(std::memory_order_relaxed);
+            stats.TotalBytes = counters.totalBytes.load(std::memory_order_relaxed);
+            stats.LiveAllocations = counters.liveAllocations.load(std::memory_order_relaxed);
+            stats.LiveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+            stats.HighWaterBytes = counters.highWaterBytes.load(std::memory_order_relaxed);
+            return stats;
+        }
+
+        void TracingAllocator::RecordAcquire(size_t subsystem, size_t size) noexcept
+        {
+            Counters *toUpdate[] = {&m_counters[subsystem], &m_total};
+            for (Counters *counters : toUpdate)
+            {
+                counters->totalAllocations.fetch_add(1, std::memory_order_relaxed);
+                counters->totalBytes.fetch_add(size, std::memory_order_relaxed);
+                counters->liveAllocations.fetch_add(1, std::memory_order_relaxed);
+                size_t live = counters->liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+                s_updateHighWater(counters->highWaterBytes, live);
+            }
+        }
+
+        void TracingAllocator::RecordRelease(size_t subsystem, size_t size) noexcept
+        {
+            Counters *toUpdate[] = {&m_counters[subsystem], &m_total};
+            for (Counters *counters : toUpdate)
+            {
+                counters->liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+                counters->liveBytes.fetch_sub(size, std::memory_order_relaxed);
+            }
+        }
+
+        void *TracingAllocator::s_MemAcquire(Allocator *allocator, size_t size)
+        {
+            auto *tracer = static_cast<TracingAllocator *>(allocator->impl);
+            size_t blockSize = 0;
+            if (aws_add_size_checked(sizeof(TracedBlockHeader), size, &blockSize))
+            {
+                return nullptr;
+            }
+
+            auto *header = static_cast<TracedBlockHeader *>(aws_mem_acquire(tracer->m_parent, blockSize));
+            if (header == nullptr)
+            {
+                return nullptr;
+            }
+
+            header->size = size;
+            header->subsystem = static_cast<size_t>(allocator - tracer->m_allocators);
+            tracer->RecordAcquire(header->subsystem, size);
+            return s_tracedData(header);
+        }
+
+        void TracingAllocator::s_MemRelease(Allocator *allocator, void *ptr)
+        {
+            auto *tracer = static_cast<TracingAllocator *>(allocator->impl);
+            TracedBlockHeader *header = s_tracedHeader(ptr);
+            tracer->RecordRelease(header->subsystem, header->size);
+            aws_mem_release(tracer->m_parent, header);
+        }
+
+        void *TracingAllocator::s_MemRealloc(Allocator *allocator, void *ptr, size_t oldSize, size_t newSize)
+        {
+            if (ptr == nullptr)
+            {
+                return s_MemAcquire(allocator, newSize);
+            }
+
+            auto *tracer = static_cast<TracingAllocator *>(allocator->impl);
+            size_t blockSize = 0;
+            if (aws_add_size_checked(sizeof(TracedBlockHeader), newSize, &blockSize))
+            {
+                return nullptr;
+            }
+
+            void *block = s_tracedHeader(ptr);
+            size_t subsystem = s_tracedHeader(ptr)->subsystem;
+            if (aws_mem_realloc(tracer->m_parent, &block, sizeof(TracedBlockHeader) + oldSize, blockSize))
+            {
+                return nullptr;
+            }
+
+            auto *header = static_cast<TracedBlockHeader *>(block);
+            tracer->RecordRelease(subsystem, header->size);
+            header->size = newSize;
+            tracer->RecordAcquire(subsystem, newSize);
+            return s_tracedData(header);
+        }
+
+        void *TracingAllocator::s_MemCalloc(Allocator *allocator, size_t num, size_t size)
+        {
+            size_t total = 0;
+            if (aws_mul_size_checked(num, size, &total))
+            {
+                return nullptr;
+            }
+
+            void *mem = s_MemAcquire(allocator, total);
+            if (mem != nullptr)
+            {
+                memset(mem, 0, total);
+            }
+
+            return mem;
+        }
+    } // namespace Crt
+} // namespace Aws
@@ -48,6 +48,16 @@ namespace Aws
             return aws_byte_cursor_from_array(array, len);
         }
 
+        ByteCursor ByteCursorFromStringView(const StringView &str) noexcept
+        {
+            return aws_byte_cursor_from_array((const void *)str.data(), str.size());
+        }
+
+        ByteCursor ByteCursorFromVector(const Vector<uint8_t> &vec) noexcept
+        {
+            return aws_byte_cursor_from_array((const void *)vec.data(), vec.size());
+        }
+
         Vector<uint8_t> Base64Decode(const String &decode)
         {
             ByteCursor toDecode = ByteCursorFromString(decode);
@@ -96,5 +106,46 @@ namespace Aws
             return {};
         }
 
+        bool Base64ComputeEncodedLength(size_t inputLen, size_t &outputLen) noexcept
+        {
+            return aws_base64_compute_encoded_len(inputLen, &outputLen) == AWS_OP_SUCCESS;
+        }
+
+        bool Base64ComputeDecodedLength(const ByteCursor &encoded, size_t &outputLen) noexcept
+        {
+            return aws_base64_compute_decoded_len(&encoded, &outputLen) == AWS_OP_SUCCESS;
+        }
+
+        bool Base64Encode(const ByteCursor &toEncode, ByteBuf &output) noexcept
+        {
+            /* encode into the unused tail of output so existing contents are preserved */
+            ByteBuf tail = aws_byte_buf_from_empty_array(output.buffer + output.len, output.capacity - output.len);
+            if (aws_base64_encode(&toEncode, &tail) != AWS_OP_SUCCESS)
+            {
+                return false;
+            }
+
+            // some versions of the encoder count the null terminator in the encoded length
+            if (tail.len > 0 && tail.buffer[tail.len - 1] == 0)
+            {
+                tail.len--;
+            }
+
+            output.len += tail.len;
+            return true;
+        }
+
+        bool Base64Decode(const ByteCursor &toDecode, ByteBuf &output) noexcept
+        {
+            ByteBuf tail = aws_byte_buf_from_empty_array(output.buffer + output.len, output.capacity - output.len);
+            if (aws_base64_decode(&toDecode, &tail) != AWS_OP_SUCCESS)
+            {
+                return false;
+            }
+
+            output.len += tail.len;
+            return true;
+        }
+
     } // namespace Crt
 } // namespace Aws
@@ -4,6 +4,15 @@
  */
 #include <aws/crt/UUID.h>
 
+#include <aws/common/device_random.h>
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define AWS_CRT_UUID_SSE2
+#    include <emmintrin.h>
+#endif
+
 namespace Aws
 {
     namespace Crt
@@ -37,11 +46,8 @@ namespace Aws
 
         String UUID::ToString() const
         {
-            String uuidStr;
-            uuidStr.resize(AWS_UUID_STR_LEN);
-            auto outBuf = ByteBufFromEmptyArray(reinterpret_cast<const uint8_t *>(uuidStr.data()), uuidStr.capacity());
-            aws_uuid_to_str(&m_uuid, &outBuf);
-            uuidStr.resize(outBuf.len);
+            String uuidStr(UUIDGenerator::StringLength, '\0');
+            UUIDGenerator::Format(m_uuid, &uuidStr[0]);
             return uuidStr;
         }
 
@@ -50,5 +56,95 @@ namespace Aws
         UUID::operator ByteBuf() const noexcept { return ByteBufFromArray(m_uuid.uuid_data, sizeof(m_uuid.uuid_data)); }
 
         int UUID::GetLastError() const noexcept { return aws_last_error(); }
+
+        const size_t UUIDGenerator::StringLength;
+        const size_t UUIDGenerator::RandomBlockSize;
+
+        UUIDGenerator::UUIDGenerator() noexcept : m_offset(RandomBlockSize) {}
+
+        bool UUIDGenerator::Refill() noexcept
+        {
+            ByteBuf block = ByteBufFromEmptyArray(m_random, sizeof(m_random));
+            if (aws_device_random_buffer(&block) != AWS_OP_SUCCESS)
+            {
+                return false;
+            }
+
+            m_offset = 0;
+            return true;
+        }
+
+        bool UUIDGenerator::Generate(aws_uuid &uuid) noexcept
+        {
+            if (m_offset + sizeof(uuid.uuid_data) > RandomBlockSize && !Refill())
+            {
+                return false;
+            }
+
+            memcpy(uuid.uuid_data, m_random + m_offset, sizeof(uuid.uuid_data));
+            m_offset += sizeof(uuid.uuid_data);
+
+            /* RFC 4122: version 4, variant 10 */
+            uuid.uuid_data[6] = static_cast<uint8_t>((uuid.uuid_data[6] & 0x0f) | 0x40);
+            uuid.uuid_data[8] = static_cast<uint8_t>((uuid.uuid_data[8] & 0x3f) | 0x80);
+            return true;
+        }
+
+        bool UUIDGenerator::Generate(char *out) noexcept { return Generate(out, 1); }
+
+        bool UUIDGenerator::Generate(char *out, size_t count) noexcept
+        {
+            aws_uuid uuid;
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (!Generate(uuid))
+                {
+                    return false;
+                }
+                Format(uuid, out + i * StringLength);
+            }
+
+            return true;
+        }
+
+        void UUIDGenerator::Format(const aws_uuid &uuid, char *out) noexcept
+        {
+            /* the 32 hex digits in order, then split 8-4-4-4-12 */
+            char hex[32];
+#if defined(AWS_CRT_UUID_SSE2)
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(uuid.uuid_data));
+            const __m128i lowNibbleMask = _mm_set1_epi8(0x0f);
+            const __m128i high = _mm_and_si128(_mm_srli_epi16(bytes, 4), lowNibbleMask);
+            const __m128i low = _mm_and_si128(bytes, lowNibbleMask);
+
+            /* '0' + n, plus the distance from '9' + 1 to 'a' for n > 9 */
+            const __m128i zero = _mm_set1_epi8('0');
+            const __m128i nine = _mm_set1_epi8(9);
+            const __m128i letterOffset = _mm_set1_epi8('a' - '0' - 10);
+            const __m128i highDigits = _mm_add_epi8(
+                _mm_add_epi8(high, zero), _mm_and_si128(_mm_cmpgt_epi8(high, nine), letterOffset));
+            const __m128i lowDigits =
+                _mm_add_epi8(_mm_add_epi8(low, zero), _mm_and_si128(_mm_cmpgt_epi8(low, nine), letterOffset));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(hex), _mm_unpacklo_epi8(highDigits, lowDigits));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(hex + 16), _mm_unpackhi_epi8(highDigits, lowDigits));
+#else
+            static const char s_hexDigits[] = "0123456789abcdef";
+            for (size_t i = 0; i < sizeof(uuid.uuid_data); ++i)
+            {
+                hex[2 * i] = s_hexDigits[uuid.uuid_data[i] >> 4];
+                hex[2 * i + 1] = s_hexDigits[uuid.uuid_data[i] & 0x0f];
+            }
+#endif
+            memcpy(out, hex, 8);
+            out[8] = '-';
+            memcpy(out + 9, hex + 8, 4);
+            out[13] = '-';
+            memcpy(out + 14, hex + 12, 4);
+            out[18] = '-';
+            memcpy(out + 19, hex + 16, 4);
+            out[23] = '-';
+            memcpy(out + 24, hex + 20, 12);
+        }
     } // namespace Crt
 } // namespace Aws
\ No newline at end of file
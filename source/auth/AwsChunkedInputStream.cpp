@@ -0,0 +1,399 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/auth/AwsChunkedInputStream.h>
+
+#include <aws/crt/auth/Credentials.h>
+#include <aws/crt/crypto/Hash.h>
+#include <aws/crt/http/HttpRequestResponse.h>
+
+#include <cstdio>
+#include <cstring>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Auth
+        {
+            static const size_t s_SignatureLength = 2 * Crypto::SHA256_HMAC_DIGEST_SIZE;
+            static const char s_ChunkSignatureField[] = ";chunk-signature=";
+
+            static void s_WriteHex(const uint8_t *bytes, size_t length, uint8_t *output) noexcept
+            {
+                static const char s_hexDigits[] = "0123456789abcdef";
+                for (size_t i = 0; i < length; ++i)
+                {
+                    output[2 * i] = static_cast<uint8_t>(s_hexDigits[bytes[i] >> 4]);
+                    output[2 * i + 1] = static_cast<uint8_t>(s_hexDigits[bytes[i] & 0xf]);
+                }
+            }
+
+            static size_t s_HexLength(uint64_t value) noexcept
+            {
+                size_t digits = 1;
+                while (value >>= 4)
+                {
+                    ++digits;
+                }
+
+                return digits;
+            }
+
+            /* the length of a framed chunk of dataLength bytes */
+            static uint64_t s_FrameLength(uint64_t dataLength) noexcept
+            {
+                return s_HexLength(dataLength) + sizeof(s_ChunkSignatureField) - 1 + s_SignatureLength + 2 +
+                       dataLength + 2;
+            }
+
+            /* the four chained HMACs of the Sigv4 signing key, starting from "AWS4" + secretAccessKey */
+            static bool s_DeriveSigningKey(
+                const ByteCursor &secretAccessKey,
+                const DateTime &date,
+                const ByteCursor &region,
+                const ByteCursor &service,
+                Crypto::SHA256HMACDigest &key,
+                Allocator *allocator) noexcept
+            {
+                ByteBuf secret;
+                if (aws_byte_buf_init(&secret, allocator, 4 + secretAccessKey.len))
+                {
+                    return false;
+                }
+                ByteCursor prefix = aws_byte_cursor_from_c_str("AWS4");
+                aws_byte_buf_append(&secret, &prefix);
+                aws_byte_buf_append(&secret, &secretAccessKey);
+
+                char dayString[16];
+                int dayLength = snprintf(
+                    dayString,
+                    sizeof(dayString),
+                    "%04u%02u%02u",
+                    static_cast<unsigned>(date.GetYear()),
+                    static_cast<unsigned>(date.GetMonth()) + 1,
+                    static_cast<unsigned>(date.GetDay()));
+                ByteCursor dayCursor = ByteCursorFromArray(reinterpret_cast<uint8_t *>(dayString), dayLength);
+                ByteCursor terminator = aws_byte_cursor_from_c_str("aws4_request");
+
+                /* kDate, kRegion, kService, kSigning, alternating between the two digests */
+                Crypto::SHA256HMACDigest step;
+                ByteCursor stepCursor = ByteCursorFromArray(step.data(), step.size());
+                ByteCursor keyCursor = ByteCursorFromArray(key.data(), key.size());
+                bool success = Crypto::ComputeSHA256HMAC(allocator, ByteCursorFromByteBuf(secret), dayCursor, step) &&
+                               Crypto::ComputeSHA256HMAC(allocator, stepCursor, region, key) &&
+                               Crypto::ComputeSHA256HMAC(allocator, keyCursor, service, step) &&
+                               Crypto::ComputeSHA256HMAC(allocator, stepCursor, terminator, key);
+
+                aws_secure_zero(step.data(), step.size());
+                aws_byte_buf_clean_up_secure(&secret);
+                return success;
+            }
+
+            const size_t AwsChunkedInputStream::DefaultChunkSize;
+
+            AwsChunkedInputStream::AwsChunkedInputStream(
+                const std::shared_ptr<Io::InputStream> &source,
+                const AwsSigningConfig &config,
+                const ByteCursor &seedSignature,
+                size_t chunkSize,
+                Allocator *allocator) noexcept
+                : Io::InputStream(allocator), m_source(source), m_chunkSize(chunkSize), m_stringToSignPrefixLength(0),
+                  m_frameOffset(0), m_sourceEnded(false), m_finished(false), m_lastError(AWS_ERROR_SUCCESS)
+            {
+                AWS_ZERO_STRUCT(m_stringToSign);
+                AWS_ZERO_STRUCT(m_frame);
+                m_signingKey.fill(0);
+                memset(m_seedSignature, 0, sizeof(m_seedSignature));
+                memset(m_previousSignature, 0, sizeof(m_previousSignature));
+
+                const std::shared_ptr<Credentials> &credentials = config.GetCredentials();
+                if (!m_source || !credentials || chunkSize == 0 || seedSignature.len != s_SignatureLength)
+                {
+                    Fail(AWS_ERROR_INVALID_ARGUMENT);
+                    return;
+                }
+                memcpy(m_seedSignature, seedSignature.ptr, s_SignatureLength);
+
+                DateTime timepoint = config.GetSigningTimepoint();
+                ByteCursor region = ByteCursorFromString(config.GetRegion());
+                ByteCursor service = ByteCursorFromString(config.GetService());
+                if (!s_DeriveSigningKey(
+                        credentials->GetSecretAccessKey(), timepoint, region, service, m_signingKey, allocator))
+                {
+                    Fail(aws_last_error());
+                    return;
+                }
+
+                char prefix[64];
+                int prefixLength = snprintf(
+                    prefix,
+                    sizeof(prefix),
+                    "AWS4-HMAC-SHA256-PAYLOAD\n%04u%02u%02uT%02u%02u%02uZ\n%04u%02u%02u/",
+                    static_cast<unsigned>(timepoint.GetYear()),
+                    static_cast<unsigned>(timepoint.GetMonth()) + 1,
+                    static_cast<unsigned>(timepoint.GetDay()),
+                    static_cast<unsigned>(timepoint.GetHour()),
+                    static_cast<unsigned>(timepoint.GetMinute()),
+                    static_cast<unsigned>(timepoint.GetSecond()),
+                    static_cast<unsigned>(timepoint.GetYear()),
+                    static_cast<unsigned>(timepoint.GetMonth()) + 1,
+                    static_cast<unsigned>(timepoint.GetDay()));
+                ByteCursor prefixCursor = ByteCursorFromArray(reinterpret_cast<uint8_t *>(prefix), prefixLength);
+                ByteCursor scopeEnd = aws_byte_cursor_from_c_str("/aws4_request\n");
+                ByteCursor slash = aws_byte_cursor_from_c_str("/");
+
+                /* previous signature, "\n", hash of nothing, "\n", hash of the chunk */
+                size_t chunkPartLength = s_SignatureLength + 1 + s_SignatureLength + 1 + s_SignatureLength;
+                size_t frameCapacity = static_cast<size_t>(s_FrameLength(chunkSize));
+                if (aws_byte_buf_init(
+                        &m_stringToSign,
+                        allocator,
+                        prefixCursor.len + region.len + slash.len + service.len + scopeEnd.len + chunkPartLength) ||
+                    aws_byte_buf_init(&m_frame, allocator, frameCapacity))
+                {
+                    Fail(aws_last_error());
+                    return;
+                }
+                aws_byte_buf_append(&m_stringToSign, &prefixCursor);
+                aws_byte_buf_append(&m_stringToSign, &region);
+                aws_byte_buf_append(&m_stringToSign, &slash);
+                aws_byte_buf_append(&m_stringToSign, &service);
+                aws_byte_buf_append(&m_stringToSign, &scopeEnd);
+                m_stringToSignPrefixLength = m_stringToSign.len;
+
+                Restart();
+            }
+
+            AwsChunkedInputStream::~AwsChunkedInputStream()
+            {
+                aws_secure_zero(m_signingKey.data(), m_signingKey.size());
+                aws_byte_buf_clean_up(&m_stringToSign);
+                aws_byte_buf_clean_up(&m_frame);
+            }
+
+            bool AwsChunkedInputStream::Fail(int errorCode) noexcept
+            {
+                m_lastError = errorCode != AWS_ERROR_SUCCESS ? errorCode : AWS_ERROR_UNKNOWN;
+                aws_raise_error(m_lastError);
+                return false;
+            }
+
+            void AwsChunkedInputStream::Restart() noexcept
+            {
+                memcpy(m_previousSignature, m_seedSignature, s_SignatureLength);
+                m_frame.len = 0;
+                m_frameOffset = 0;
+                m_sourceEnded = false;
+                m_finished = false;
+            }
+
+            bool AwsChunkedInputStream::IsValid() const noexcept
+            {
+                return m_lastError == AWS_ERROR_SUCCESS && m_source && m_source->IsValid();
+            }
+
+            uint64_t AwsChunkedInputStream::GetEncodedLength(uint64_t payloadLength, size_t chunkSize) noexcept
+            {
+                if (chunkSize == 0)
+                {
+                    return 0;
+                }
+
+                uint64_t fullChunks = payloadLength / chunkSize;
+                uint64_t remainder = payloadLength % chunkSize;
+                return fullChunks * s_FrameLength(chunkSize) + (remainder ? s_FrameLength(remainder) : 0) +
+                       s_FrameLength(0);
+            }
+
+            Optional<ByteCursor> AwsChunkedInputStream::GetRequestSignature(const Http::HttpRequest &request) noexcept
+            {
+                Optional<ByteCursor> authorization = request.GetHeader(aws_byte_cursor_from_c_str("Authorization"));
+                if (!authorization.has_value())
+                {
+                    return Optional<ByteCursor>();
+                }
+
+                /* "AWS4-HMAC-SHA256 Credential=..., SignedHeaders=..., Signature=<signature>" */
+                static const char s_SignatureField[] = "Signature=";
+                const size_t fieldLength = sizeof(s_SignatureField) - 1;
+                ByteCursor value = authorization.value();
+                if (value.len < fieldLength + s_SignatureLength)
+                {
+                    return Optional<ByteCursor>();
+                }
+
+                const uint8_t *signature = value.ptr + value.len - s_SignatureLength;
+                if (memcmp(signature - fieldLength, s_SignatureField, fieldLength) != 0)
+                {
+                    return Optional<ByteCursor>();
+                }
+
+                return Optional<ByteCursor>(ByteCursorFromArray(signature, s_SignatureLength));
+            }
+
+            ByteCursor AwsChunkedInputStream::GetPreviousSignature() const noexcept
+            {
+                return ByteCursorFromArray(m_previousSignature, s_SignatureLength);
+            }
+
+            /* reads the next chunk straight into the frame after room for its header, then signs and frames it */
+            bool AwsChunkedInputStream::FrameNextChunk() noexcept
+            {
+                size_t headerRoom = static_cast<size_t>(s_FrameLength(m_chunkSize) - m_chunkSize - 2);
+                m_frame.len = headerRoom;
+
+                if (!m_sourceEnded)
+                {
+                    ByteBuf data = m_frame;
+                    data.capacity = headerRoom + m_chunkSize;
+                    data.allocator = nullptr;
+                    while (data.len < data.capacity)
+                    {
+                        if (!m_source->Read(data))
+                        {
+                            return Fail(aws_last_error());
+                        }
+
+                        Io::StreamStatus status;
+                        AWS_ZERO_STRUCT(status);
+                        m_source->GetStatus(status);
+                        if (status.is_end_of_stream)
+                        {
+                            m_sourceEnded = true;
+                            break;
+                        }
+                    }
+                    m_frame.len = data.len;
+                }
+
+                size_t dataLength = m_frame.len - headerRoom;
+                ByteCursor chunkData = ByteCursorFromArray(m_frame.buffer + headerRoom, dataLength);
+
+                Crypto::SHA256Digest chunkHash;
+                if (!Crypto::ComputeSHA256(m_allocator, chunkData, chunkHash))
+                {
+                    return Fail(aws_last_error());
+                }
+
+                m_stringToSign.len = m_stringToSignPrefixLength;
+                ByteCursor previous = GetPreviousSignature();
+                ByteCursor emptyHash = aws_byte_cursor_from_c_str(SignedBodyValue::EmptySha256);
+                ByteCursor newline = aws_byte_cursor_from_c_str("\n");
+                aws_byte_buf_append(&m_stringToSign, &previous);
+                aws_byte_buf_append(&m_stringToSign, &newline);
+                aws_byte_buf_append(&m_stringToSign, &emptyHash);
+                aws_byte_buf_append(&m_stringToSign, &newline);
+                s_WriteHex(chunkHash.data(), chunkHash.size(), m_stringToSign.buffer + m_stringToSign.len);
+                m_stringToSign.len += s_SignatureLength;
+
+                Crypto::SHA256HMACDigest signature;
+                ByteCursor key = ByteCursorFromArray(m_signingKey.data(), m_signingKey.size());
+                if (!Crypto::ComputeSHA256HMAC(m_allocator, key, ByteCursorFromByteBuf(m_stringToSign), signature))
+                {
+                    return Fail(aws_last_error());
+                }
+                s_WriteHex(signature.data(), signature.size(), m_previousSignature);
+
+                /* the header goes right before the data, and the frame starts wherever it begins */
+                char size[24];
+                int sizeLength = snprintf(size, sizeof(size), "%zx", dataLength);
+                size_t fieldLength = sizeof(s_ChunkSignatureField) - 1;
+                size_t headerLength = static_cast<size_t>(sizeLength) + fieldLength + s_SignatureLength + 2;
+                uint8_t *header = m_frame.buffer + headerRoom - headerLength;
+                memcpy(header, size, static_cast<size_t>(sizeLength));
+                memcpy(header + sizeLength, s_ChunkSignatureField, fieldLength);
+                memcpy(header + sizeLength + fieldLength, m_previousSignature, s_SignatureLength);
+                memcpy(header + headerLength - 2, "\r\n", 2);
+                memcpy(m_frame.buffer + m_frame.len, "\r\n", 2);
+                m_frame.len += 2;
+                m_frameOffset = headerRoom - headerLength;
+
+                /* the empty chunk ends the body */
+                m_finished = dataLength == 0;
+                return true;
+            }
+
+            bool AwsChunkedInputStream::ReadImpl(ByteBuf &buffer) noexcept
+            {
+                if (m_lastError != AWS_ERROR_SUCCESS)
+                {
+                    aws_raise_error(m_lastError);
+                    return false;
+                }
+
+                while (buffer.len < buffer.capacity)
+                {
+                    if (m_frameOffset == m_frame.len)
+                    {
+                        if (m_finished)
+                        {
+                            break;
+                        }
+
+                        if (!FrameNextChunk())
+                        {
+                            return false;
+                        }
+                    }
+
+                    size_t available = m_frame.len - m_frameOffset;
+                    size_t toCopy = buffer.capacity - buffer.len < available ? buffer.capacity - buffer.len : available;
+                    memcpy(buffer.buffer + buffer.len, m_frame.buffer + m_frameOffset, toCopy);
+                    buffer.len += toCopy;
+                    m_frameOffset += toCopy;
+                }
+
+                return true;
+            }
+
+            Io::StreamStatus AwsChunkedInputStream::GetStatusImpl() const noexcept
+            {
+                Io::StreamStatus status;
+                status.is_end_of_stream = m_finished && m_frameOffset == m_frame.len;
+                status.is_valid = IsValid();
+
+                return status;
+            }
+
+            int64_t AwsChunkedInputStream::GetLengthImpl() const noexcept
+            {
+                int64_t length = -1;
+                if (!m_source || !m_source->GetLength(length) || length < 0)
+                {
+                    return -1;
+                }
+
+                return static_cast<int64_t>(GetEncodedLength(static_cast<uint64_t>(length), m_chunkSize));
+            }
+
+            bool AwsChunkedInputStream::SeekImpl(Io::OffsetType offset, Io::StreamSeekBasis seekBasis) noexcept
+            {
+                if (m_frame.buffer == nullptr)
+                {
+                    /* the stream never got off the ground, and rewinding does not change that */
+                    aws_raise_error(m_lastError);
+                    return false;
+                }
+
+                /* only a rewind is supported; asking for anything else leaves the stream as it was */
+                if (offset != 0 || seekBasis != Io::StreamSeekBasis::Begin)
+                {
+                    aws_raise_error(AWS_ERROR_STREAM_UNSEEKABLE);
+                    return false;
+                }
+
+                if (!m_source->Seek(offset, seekBasis))
+                {
+                    m_lastError = aws_last_error();
+                    return false;
+                }
+
+                m_lastError = AWS_ERROR_SUCCESS;
+                Restart();
+                return true;
+            }
+        } // namespace Auth
+    }     // namespace Crt
+} // namespace Aws
@@ -5,6 +5,8 @@
 
 #include <aws/crt/auth/Credentials.h>
 
+#include <aws/crt/Api.h>
+#include <aws/crt/EventTracer.h>
 #include <aws/crt/http/HttpConnection.h>
 #include <aws/crt/http/HttpProxyStrategy.h>
 
@@ -14,6 +16,9 @@
 #include <algorithm>
 #include <aws/http/connection.h>
 
+#include <chrono>
+#include <mutex>
+
 namespace Aws
 {
     namespace Crt
@@ -100,7 +105,7 @@ namespace Aws
             Credentials::operator bool() const noexcept { return m_credentials != nullptr; }
 
             CredentialsProvider::CredentialsProvider(aws_credentials_provider *provider, Allocator *allocator) noexcept
-                : m_allocator(allocator), m_provider(provider)
+                : m_allocator(allocator), m_provider(provider), m_fetchInFlight(false)
             {
             }
 
@@ -117,10 +122,26 @@ namespace Aws
             {
                 CredentialsProviderCallbackArgs() = default;
 
-                OnCredentialsResolved m_onCredentialsResolved;
                 std::shared_ptr<const CredentialsProvider> m_provider;
             };
 
+            void CredentialsProvider::CompletePendingQueries(aws_credentials *credentials, int errorCode) const noexcept
+            {
+                Vector<OnCredentialsResolved> pendingQueries;
+                {
+                    std::lock_guard<std::mutex> lock(m_pendingLock);
+                    pendingQueries.swap(m_pendingQueries);
+                    m_fetchInFlight = false;
+                }
+
+                /* one set of credentials for everybody, and queries made from the callbacks start a new fetch */
+                auto credentialsPtr = Aws::Crt::MakeShared<Credentials>(m_allocator, credentials);
+                for (const auto &onCredentialsResolved : pendingQueries)
+                {
+                    onCredentialsResolved(credentialsPtr, errorCode);
+                }
+            }
+
             void CredentialsProvider::s_onCredentialsResolved(
                 aws_credentials *credentials,
                 int error_code,
@@ -128,13 +149,13 @@ namespace Aws
             {
                 CredentialsProviderCallbackArgs *callbackArgs =
                     static_cast<CredentialsProviderCallbackArgs *>(user_data);
+                EventTracer::Record(TraceEventType::CredentialsFetch, TraceEventPhase::End, callbackArgs, error_code);
 
-                auto credentialsPtr =
-                    Aws::Crt::MakeShared<Credentials>(callbackArgs->m_provider->m_allocator, credentials);
-
-                callbackArgs->m_onCredentialsResolved(credentialsPtr, error_code);
+                /* keeps the provider alive until every query is resolved */
+                std::shared_ptr<const CredentialsProvider> provider = std::move(callbackArgs->m_provider);
+                Aws::Crt::Delete(callbackArgs, provider->m_allocator);
 
-                Aws::Crt::Delete(callbackArgs, callbackArgs->m_provider->m_allocator);
+                provider->CompletePendingQueries(credentials, error_code);
             }
 
             bool CredentialsProvider::GetCredentials(const OnCredentialsResolved &onCredentialsResolved) const
@@ -144,16 +165,35 @@ namespace Aws
                     return false;
                 }
 
+                {
+                    std::lock_guard<std::mutex> lock(m_pendingLock);
+                    m_pendingQueries.push_back(onCredentialsResolved);
+                    if (m_fetchInFlight)
+                    {
+                        return true;
+                    }
+                    m_fetchInFlight = true;
+                }
+
                 auto callbackArgs = Aws::Crt::New<CredentialsProviderCallbackArgs>(m_allocator);
                 if (callbackArgs == nullptr)
                 {
-                    return false;
+                    CompletePendingQueries(nullptr, aws_last_error());
+                    return true;
                 }
 
                 callbackArgs->m_provider = std::static_pointer_cast<const CredentialsProvider>(shared_from_this());
-                callbackArgs->m_onCredentialsResolved = onCredentialsResolved;
 
-                aws_credentials_provider_get_credentials(m_provider, s_onCredentialsResolved, callbackArgs);
+                EventTracer::Record(TraceEventType::CredentialsFetch, TraceEventPhase::Begin, callbackArgs);
+                if (aws_credentials_provider_get_credentials(m_provider, s_onCredentialsResolved, callbackArgs))
+                {
+                    /* the fetch never started, so neither the callback nor the queries that joined it will run */
+                    int errorCode = aws_last_error();
+                    EventTracer::Record(
+                        TraceEventType::CredentialsFetch, TraceEventPhase::End, callbackArgs, errorCode);
+                    Aws::Crt::Delete(callbackArgs, m_allocator);
+                    CompletePendingQueries(nullptr, errorCode);
+                }
 
                 return true;
             }
@@ -176,6 +216,8 @@ namespace Aws
                 const CredentialsProviderStaticConfig &config,
                 Allocator *allocator)
             {
+                ApiHandle::InitializeSubsystem(ApiSubsystem::Auth);
+
                 aws_credentials_provider_static_options staticOptions;
                 AWS_ZERO_STRUCT(staticOptions);
                 staticOptions.access_key_id = config.AccessKeyId;
@@ -188,6 +230,8 @@ namespace Aws
             std::shared_ptr<ICredentialsProvider> CredentialsProvider::CreateCredentialsProviderEnvironment(
                 Allocator *allocator)
             {
+                ApiHandle::InitializeSubsystem(ApiSubsystem::Auth);
+
                 aws_credentials_provider_environment_options environmentOptions;
                 AWS_ZERO_STRUCT(environmentOptions);
                 return s_CreateWrappedProvider(
@@ -198,6 +242,8 @@ namespace Aws
                 const CredentialsProviderProfileConfig &config,
                 Allocator *allocator)
             {
+                ApiHandle::InitializeSubsystem(ApiSubsystem::Auth);
+
                 struct aws_credentials_provider_profile_options raw_config;
                 AWS_ZERO_STRUCT(raw_config);
 
@@ -214,6 +260,8 @@ namespace Aws
                 const CredentialsProviderImdsConfig &config,
                 Allocator *allocator)
             {
+                ApiHandle::InitializeSubsystem(ApiSubsystem::Auth);
+
                 struct aws_credentials_provider_imds_options raw_config;
                 AWS_ZERO_STRUCT(raw_config);
 
@@ -226,7 +274,9 @@ namespace Aws
                 const CredentialsProviderChainConfig &config,
                 Allocator *allocator)
             {
-                Vector<aws_credentials_provider *> providers;
+                ApiHandle::InitializeSubsystem(ApiSubsystem::Auth);
+
+                SmallVector<aws_credentials_provider *, 8> providers(allocator);
                 providers.reserve(config.Providers.size());
 
                 std::for_each(
@@ -249,6 +299,8 @@ namespace Aws
                 const CredentialsProviderCachedConfig &config,
                 Allocator *allocator)
             {
+                ApiHandle::InitializeSubsystem(ApiSubsystem::Auth);
+
                 struct aws_credentials_provider_cached_options raw_config;
                 AWS_ZERO_STRUCT(raw_config);
 
@@ -262,6 +314,8 @@ namespace Aws
                 const CredentialsProviderChainDefaultConfig &config,
                 Allocator *allocator)
             {
+                ApiHandle::InitializeSubsystem(ApiSubsystem::Auth);
+
                 struct aws_credentials_provider_chain_default_options raw_config;
                 AWS_ZERO_STRUCT(raw_config);
 
@@ -276,6 +330,8 @@ namespace Aws
                 const CredentialsProviderX509Config &config,
                 Allocator *allocator)
             {
+                ApiHandle::InitializeSubsystem(ApiSubsystem::Auth);
+
                 struct aws_credentials_provider_x509_options raw_config;
                 AWS_ZERO_STRUCT(raw_config);
 
@@ -328,6 +384,8 @@ namespace Aws
                 const CredentialsProviderDelegateConfig &config,
                 Allocator *allocator)
             {
+                ApiHandle::InitializeSubsystem(ApiSubsystem::Auth);
+
                 struct aws_credentials_provider_delegate_options raw_config;
                 AWS_ZERO_STRUCT(raw_config);
 
@@ -344,6 +402,214 @@ namespace Aws
                     aws_credentials_provider_new_delegate(allocator, &raw_config), allocator);
             }
 
+            /* shared by the delegate and every refresh in flight, so whichever lets go last frees it */
+            struct RefreshAheadCredentialsState
+            {
+                struct Waiter
+                {
+                    aws_on_get_credentials_callback_fn *callback;
+                    void *userData;
+                };
+
+                explicit RefreshAheadCredentialsState(Allocator *allocator)
+                    : sourceProvider(), refreshFraction(0), retryIntervalMs(0), credentials(), expiresAtMs(0),
+                      refreshAtMs(0), refreshing(false), waiters(StlAllocator<Waiter>(allocator))
+                {
+                }
+
+                std::shared_ptr<ICredentialsProvider> sourceProvider;
+                double refreshFraction;
+                uint64_t retryIntervalMs;
+
+                std::mutex lock;
+                std::shared_ptr<Credentials> credentials;
+                uint64_t expiresAtMs;
+                uint64_t refreshAtMs;
+                bool refreshing;
+                /* queries that came in while there were no unexpired credentials to hand out */
+                Vector<Waiter> waiters;
+            };
+
+            struct RefreshAheadCredentialsProviderArgs
+            {
+                Allocator *allocator;
+                std::shared_ptr<RefreshAheadCredentialsState> state;
+            };
+
+            static uint64_t s_NowMillis() noexcept
+            {
+                return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                                 std::chrono::system_clock::now().time_since_epoch())
+                                                 .count());
+            }
+
+            static void s_OnRefreshAheadCredentials(
+                const std::shared_ptr<RefreshAheadCredentialsState> &state,
+                const std::shared_ptr<Credentials> &credentials,
+                int errorCode)
+            {
+                uint64_t now = s_NowMillis();
+                std::shared_ptr<Credentials> current;
+                Vector<RefreshAheadCredentialsState::Waiter> waiters;
+                {
+                    std::lock_guard<std::mutex> lock(state->lock);
+                    state->refreshing = false;
+                    if (credentials && *credentials)
+                    {
+                        uint64_t expirationSeconds = credentials->GetExpirationTimepointInSeconds();
+                        state->credentials = credentials;
+                        if (expirationSeconds >= UINT64_MAX / 1000)
+                        {
+                            state->expiresAtMs = UINT64_MAX;
+                            state->refreshAtMs = UINT64_MAX;
+                        }
+                        else
+                        {
+                            state->expiresAtMs = expirationSeconds * 1000;
+                            uint64_t lifetimeMs = state->expiresAtMs > now ? state->expiresAtMs - now : 0;
+                            state->refreshAtMs =
+                                now + static_cast<uint64_t>(static_cast<double>(lifetimeMs) * state->refreshFraction);
+                        }
+                    }
+                    else if (state->credentials && now < state->expiresAtMs)
+                    {
+                        /* keep handing out what still works, and try again in a while */
+                        state->refreshAtMs = now + state->retryIntervalMs;
+                    }
+
+                    /* fresh credentials go to the waiters even if they are already past their expiration */
+                    if ((credentials && *credentials) || (state->credentials && now < state->expiresAtMs))
+                    {
+                        current = state->credentials;
+                    }
+                    waiters.swap(state->waiters);
+                }
+
+                if (!current && errorCode == AWS_ERROR_SUCCESS)
+                {
+                    errorCode = AWS_ERROR_UNKNOWN;
+                }
+
+                for (const auto &waiter : waiters)
+                {
+                    auto handle = current ? (struct aws_credentials *)(void *)current->GetUnderlyingHandle() : nullptr;
+                    waiter.callback(handle, current ? AWS_ERROR_SUCCESS : errorCode, waiter.userData);
+                }
+            }
+
+            static void s_StartRefreshAhead(const std::shared_ptr<RefreshAheadCredentialsState> &state)
+            {
+                bool started = state->sourceProvider->GetCredentials(
+                    [state](std::shared_ptr<Credentials> credentials, int errorCode) {
+                        s_OnRefreshAheadCredentials(state, credentials, errorCode);
+                    });
+                if (!started)
+                {
+                    s_OnRefreshAheadCredentials(state, nullptr, aws_last_error());
+                }
+            }
+
+            static int s_onRefreshAheadGetCredentials(
+                void *delegate_user_data,
+                aws_on_get_credentials_callback_fn callback,
+                void *callback_user_data)
+            {
+                auto args = static_cast<RefreshAheadCredentialsProviderArgs *>(delegate_user_data);
+                std::shared_ptr<RefreshAheadCredentialsState> state = args->state;
+
+                uint64_t now = s_NowMillis();
+                std::shared_ptr<Credentials> current;
+                bool startRefresh = false;
+                {
+                    std::lock_guard<std::mutex> lock(state->lock);
+                    if (state->credentials && now < state->expiresAtMs)
+                    {
+                        current = state->credentials;
+                    }
+                    else
+                    {
+                        state->waiters.push_back({callback, callback_user_data});
+                    }
+
+                    if ((!current || now >= state->refreshAtMs) && !state->refreshing)
+                    {
+                        state->refreshing = true;
+                        startRefresh = true;
+                    }
+                }
+
+                if (current)
+                {
+                    callback(
+                        (struct aws_credentials *)(void *)current->GetUnderlyingHandle(),
+                        AWS_ERROR_SUCCESS,
+                        callback_user_data);
+                }
+
+                if (startRefresh)
+                {
+                    s_StartRefreshAhead(state);
+                }
+
+                return AWS_OP_SUCCESS;
+            }
+
+            static void s_onRefreshAheadShutdownComplete(void *user_data)
+            {
+                auto args = static_cast<RefreshAheadCredentialsProviderArgs *>(user_data);
+                Aws::Crt::Delete(args, args->allocator);
+            }
+
+            std::shared_ptr<ICredentialsProvider> CredentialsProvider::CreateCredentialsProviderRefreshAhead(
+                const CredentialsProviderRefreshAheadConfig &config,
+                Allocator *allocator)
+            {
+                ApiHandle::InitializeSubsystem(ApiSubsystem::Auth);
+
+                if (!config.Provider || !config.Provider->IsValid())
+                {
+                    aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                    return nullptr;
+                }
+
+                auto state = Aws::Crt::MakeShared<RefreshAheadCredentialsState>(allocator, allocator);
+                auto args = Aws::Crt::New<RefreshAheadCredentialsProviderArgs>(allocator);
+                if (!state || !args)
+                {
+                    Aws::Crt::Delete(args, allocator);
+                    return nullptr;
+                }
+
+                state->sourceProvider = config.Provider;
+                state->refreshFraction = std::min(std::max(config.RefreshFraction, 0.0), 1.0);
+                state->retryIntervalMs = static_cast<uint64_t>(std::max<int64_t>(config.RetryInterval.count(), 0));
+                args->allocator = allocator;
+                args->state = state;
+
+                struct aws_credentials_provider_delegate_options raw_config;
+                AWS_ZERO_STRUCT(raw_config);
+                raw_config.delegate_user_data = args;
+                raw_config.get_credentials = s_onRefreshAheadGetCredentials;
+                raw_config.shutdown_options.shutdown_callback = s_onRefreshAheadShutdownComplete;
+                raw_config.shutdown_options.shutdown_user_data = args;
+
+                struct aws_credentials_provider *raw_provider =
+                    aws_credentials_provider_new_delegate(allocator, &raw_config);
+                if (raw_provider == nullptr)
+                {
+                    Aws::Crt::Delete(args, allocator);
+                    return nullptr;
+                }
+
+                /* the first credentials are on their way before anybody asks for them */
+                {
+                    std::lock_guard<std::mutex> lock(state->lock);
+                    state->refreshing = true;
+                }
+                s_StartRefreshAhead(state);
+
+                return s_CreateWrappedProvider(raw_provider, allocator);
+            }
         } // namespace Auth
     }     // namespace Crt
 } // namespace Aws
@@ -5,13 +5,21 @@
 
 #include <aws/crt/auth/Sigv4Signing.h>
 
+#include <aws/crt/Api.h>
 #include <aws/crt/auth/Credentials.h>
 #include <aws/crt/http/HttpRequestResponse.h>
+#include <aws/crt/private/WorkerThreads.h>
 
 #include <aws/auth/signable.h>
 #include <aws/auth/signing.h>
 #include <aws/auth/signing_result.h>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 namespace Aws
 {
     namespace Crt
@@ -29,6 +37,8 @@ namespace Aws
             AwsSigningConfig::AwsSigningConfig(Allocator *allocator)
                 : ISigningConfig(), m_allocator(allocator), m_credentialsProvider(nullptr), m_credentials(nullptr)
             {
+                ApiHandle::InitializeSubsystem(ApiSubsystem::Auth);
+
                 AWS_ZERO_STRUCT(m_config);
 
                 SetSigningAlgorithm(SigningAlgorithm::SigV4);
@@ -124,7 +134,73 @@ namespace Aws
 
             void AwsSigningConfig::SetShouldSignHeaderCallback(ShouldSignHeaderCb shouldSignHeaderCb) noexcept
             {
+                m_signedHeaderNames.clear();
                 m_config.should_sign_header = shouldSignHeaderCb;
+                m_config.should_sign_header_ud = nullptr;
+            }
+
+            static char s_ToLower(char c) noexcept { return c >= 'A' && c <= 'Z' ? static_cast<char>(c + 32) : c; }
+
+            /* compares name, in any case, with a lowercased name */
+            static int s_CompareHeaderName(const ByteCursor &name, const Crt::String &lowered) noexcept
+            {
+                size_t length = name.len < lowered.size() ? name.len : lowered.size();
+                for (size_t i = 0; i < length; ++i)
+                {
+                    char c = s_ToLower(static_cast<char>(name.ptr[i]));
+                    if (c != lowered[i])
+                    {
+                        return static_cast<unsigned char>(c) < static_cast<unsigned char>(lowered[i]) ? -1 : 1;
+                    }
+                }
+
+                return name.len == lowered.size() ? 0 : (name.len < lowered.size() ? -1 : 1);
+            }
+
+            static bool s_ShouldSignNamedHeader(const Crt::ByteCursor *name, void *userData)
+            {
+                auto headerNames = static_cast<const Vector<Crt::String> *>(userData);
+                size_t low = 0;
+                size_t high = headerNames->size();
+                while (low < high)
+                {
+                    size_t middle = low + (high - low) / 2;
+                    int comparison = s_CompareHeaderName(*name, (*headerNames)[middle]);
+                    if (comparison == 0)
+                    {
+                        return true;
+                    }
+
+                    if (comparison < 0)
+                    {
+                        high = middle;
+                    }
+                    else
+                    {
+                        low = middle + 1;
+                    }
+                }
+
+                return false;
+            }
+
+            void AwsSigningConfig::SetSignedHeaderNames(const Vector<Crt::String> &headerNames) noexcept
+            {
+                m_signedHeaderNames = headerNames;
+                for (auto &name : m_signedHeaderNames)
+                {
+                    for (auto &c : name)
+                    {
+                        c = s_ToLower(c);
+                    }
+                }
+                std::sort(m_signedHeaderNames.begin(), m_signedHeaderNames.end());
+                m_signedHeaderNames.erase(
+                    std::unique(m_signedHeaderNames.begin(), m_signedHeaderNames.end()), m_signedHeaderNames.end());
+
+                bool signNamed = !m_signedHeaderNames.empty();
+                m_config.should_sign_header = signNamed ? s_ShouldSignNamedHeader : nullptr;
+                m_config.should_sign_header_ud = signNamed ? &m_signedHeaderNames : nullptr;
             }
 
             const Crt::String &AwsSigningConfig::GetSignedBodyValue() const noexcept { return m_signedBodyValue; }
@@ -188,6 +264,7 @@ namespace Aws
             Sigv4HttpRequestSigner::Sigv4HttpRequestSigner(Aws::Crt::Allocator *allocator)
                 : IHttpRequestSigner(), m_allocator(allocator)
             {
+                ApiHandle::InitializeSubsystem(ApiSubsystem::Auth);
             }
 
             struct HttpSignerCallbackData
@@ -252,6 +329,234 @@ namespace Aws
                            s_http_signing_complete_fn,
                            signerCallbackData) == AWS_OP_SUCCESS;
             }
+
+            struct HttpSignerNowData
+            {
+                HttpSignerNowData(Allocator *allocator, Aws::Crt::Http::HttpRequest *request)
+                    : Alloc(allocator), Request(request), ErrorCode(AWS_ERROR_SUCCESS), Completed(false),
+                      Abandoned(false)
+                {
+                }
+
+                Allocator *Alloc;
+                Aws::Crt::Http::HttpRequest *Request;
+                ScopedResource<struct aws_signable> Signable;
+                std::mutex Lock;
+                int ErrorCode;
+                bool Completed;
+                /* set when the signer did not complete inline, leaving the callback to free this */
+                bool Abandoned;
+            };
+
+            static void s_http_signing_now_complete_fn(struct aws_signing_result *result, int errorCode, void *userdata)
+            {
+                auto nowData = reinterpret_cast<HttpSignerNowData *>(userdata);
+
+                {
+                    std::lock_guard<std::mutex> lock(nowData->Lock);
+                    if (!nowData->Abandoned)
+                    {
+                        if (errorCode == AWS_OP_SUCCESS &&
+                            aws_apply_signing_result_to_http_request(
+                                nowData->Request->GetUnderlyingMessage(), nowData->Alloc, result))
+                        {
+                            errorCode = aws_last_error();
+                        }
+
+                        nowData->ErrorCode = errorCode;
+                        nowData->Completed = true;
+                        return;
+                    }
+                }
+
+                Crt::Delete(nowData, nowData->Alloc);
+            }
+
+            /* signs request with config, which has its credentials and so completes before returning */
+            static bool s_SignRequestNow(
+                Allocator *allocator,
+                Aws::Crt::Http::HttpRequest &request,
+                const struct aws_signing_config_aws &config) noexcept
+            {
+                auto nowData = Crt::New<HttpSignerNowData>(allocator, allocator, &request);
+                if (!nowData)
+                {
+                    return false;
+                }
+
+                nowData->Signable = ScopedResource<struct aws_signable>(
+                    aws_signable_new_http_request(allocator, request.GetUnderlyingMessage()), aws_signable_destroy);
+                if (!nowData->Signable ||
+                    aws_sign_request_aws(
+                        allocator,
+                        nowData->Signable.get(),
+                        (const aws_signing_config_base *)&config,
+                        s_http_signing_now_complete_fn,
+                        nowData))
+                {
+                    Crt::Delete(nowData, allocator);
+                    return false;
+                }
+
+                /* with the credentials in the config there is nothing to wait for, so the signer completes inline */
+                bool completed = false;
+                {
+                    std::lock_guard<std::mutex> lock(nowData->Lock);
+                    completed = nowData->Completed;
+                    nowData->Abandoned = !completed;
+                }
+
+                if (!completed)
+                {
+                    /* the request is left unsigned, and the callback frees nowData whenever it does run */
+                    aws_raise_error(AWS_ERROR_INVALID_STATE);
+                    return false;
+                }
+
+                int errorCode = nowData->ErrorCode;
+                Crt::Delete(nowData, allocator);
+                if (errorCode != AWS_ERROR_SUCCESS)
+                {
+                    aws_raise_error(errorCode);
+                    return false;
+                }
+
+                return true;
+            }
+
+            bool Sigv4HttpRequestSigner::SignRequestNow(
+                Aws::Crt::Http::HttpRequest &request,
+                const ISigningConfig &config) noexcept
+            {
+                if (config.GetType() != SigningConfigType::Aws)
+                {
+                    aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                    return false;
+                }
+
+                auto awsSigningConfig = static_cast<const AwsSigningConfig *>(&config);
+
+                if (!awsSigningConfig->GetCredentials())
+                {
+                    aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                    return false;
+                }
+
+                return s_SignRequestNow(m_allocator, request, *awsSigningConfig->GetUnderlyingHandle());
+            }
+
+            /* waits for provider to hand out credentials */
+            static std::shared_ptr<Credentials> s_ResolveCredentials(const ICredentialsProvider &provider)
+            {
+                std::mutex lock;
+                std::condition_variable signal;
+                bool resolved = false;
+                std::shared_ptr<Credentials> credentials;
+                int error = AWS_ERROR_SUCCESS;
+
+                auto onResolved = [&](std::shared_ptr<Credentials> resolvedCredentials, int errorCode) {
+                    std::lock_guard<std::mutex> guard(lock);
+                    credentials = std::move(resolvedCredentials);
+                    error = errorCode;
+                    resolved = true;
+                    signal.notify_one();
+                };
+                if (!provider.GetCredentials(onResolved))
+                {
+                    return nullptr;
+                }
+
+                std::unique_lock<std::mutex> guard(lock);
+                signal.wait(guard, [&]() { return resolved; });
+                if (!credentials)
+                {
+                    aws_raise_error(error != AWS_ERROR_SUCCESS ? error : AWS_ERROR_UNKNOWN);
+                }
+
+                return credentials;
+            }
+
+            bool Sigv4HttpRequestSigner::SignRequests(
+                const Vector<std::shared_ptr<Aws::Crt::Http::HttpRequest>> &requests,
+                const ISigningConfig &config,
+                size_t threadCount) noexcept
+            {
+                if (config.GetType() != SigningConfigType::Aws)
+                {
+                    aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                    return false;
+                }
+
+                if (requests.empty())
+                {
+                    return true;
+                }
+
+                auto awsSigningConfig = static_cast<const AwsSigningConfig *>(&config);
+
+                std::shared_ptr<Credentials> credentials = awsSigningConfig->GetCredentials();
+                if (!credentials)
+                {
+                    if (!awsSigningConfig->GetCredentialsProvider())
+                    {
+                        aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                        return false;
+                    }
+
+                    credentials = s_ResolveCredentials(*awsSigningConfig->GetCredentialsProvider());
+                    if (!credentials)
+                    {
+                        return false;
+                    }
+                }
+
+                /* the config points at strings config owns, which outlive the batch */
+                struct aws_signing_config_aws batchConfig = *awsSigningConfig->GetUnderlyingHandle();
+                batchConfig.credentials = credentials->GetUnderlyingHandle();
+                batchConfig.credentials_provider = nullptr;
+
+                if (threadCount == 0)
+                {
+                    threadCount = std::thread::hardware_concurrency();
+                    threadCount = threadCount ? threadCount : 1;
+                }
+
+                /* every thread, the calling one included, takes the next request nobody has taken yet */
+                size_t requestCount = requests.size();
+                std::atomic<size_t> nextRequest(0);
+                std::atomic<int> error(AWS_ERROR_SUCCESS);
+                std::function<void()> work = [&]() {
+                    for (size_t index = nextRequest++; index < requestCount && error.load() == AWS_ERROR_SUCCESS;
+                         index = nextRequest++)
+                    {
+                        if (!requests[index] || !s_SignRequestNow(m_allocator, *requests[index], batchConfig))
+                        {
+                            int result = requests[index] ? aws_last_error() : AWS_ERROR_INVALID_ARGUMENT;
+                            int expected = AWS_ERROR_SUCCESS;
+                            error.compare_exchange_strong(
+                                expected, result != AWS_ERROR_SUCCESS ? result : AWS_ERROR_UNKNOWN);
+                        }
+                    }
+                };
+
+                StlAllocator<std::thread> threadAllocator(m_allocator);
+                Vector<std::thread> threads(threadAllocator);
+                StartWorkerThreads(std::min(threadCount, requestCount) - 1, work, threads);
+
+                work();
+                for (auto &thread : threads)
+                {
+                    thread.join();
+                }
+
+                if (error.load() != AWS_ERROR_SUCCESS)
+                {
+                    aws_raise_error(error.load());
+                    return false;
+                }
+
+                return true;
+            }
         } // namespace Auth
     }     // namespace Crt
 } // namespace Aws
@@ -0,0 +1,75 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/crypto/Checksum.h>
+
+#include <aws/checksums/crc.h>
+
+#include <climits>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Crypto
+        {
+            /* the aws-checksums functions take an int length, which a cursor can exceed */
+            static uint32_t s_ComputeCrc(
+                uint32_t (*crcFn)(const uint8_t *, int, uint32_t),
+                const ByteCursor &input,
+                uint32_t previousCrc) noexcept
+            {
+                ByteCursor remaining = input;
+                uint32_t crc = previousCrc;
+                while (remaining.len > 0)
+                {
+                    int chunk =
+                        remaining.len > static_cast<size_t>(INT_MAX) ? INT_MAX : static_cast<int>(remaining.len);
+                    crc = crcFn(remaining.ptr, chunk, crc);
+                    aws_byte_cursor_advance(&remaining, static_cast<size_t>(chunk));
+                }
+
+                return crc;
+            }
+
+            uint32_t ComputeCRC32(const ByteCursor &input, uint32_t previousCrc) noexcept
+            {
+                return s_ComputeCrc(aws_checksums_crc32, input, previousCrc);
+            }
+
+            uint32_t ComputeCRC32C(const ByteCursor &input, uint32_t previousCrc) noexcept
+            {
+                return s_ComputeCrc(aws_checksums_crc32c, input, previousCrc);
+            }
+
+            Checksum::Checksum(ChecksumAlgorithm algorithm) noexcept
+                : m_algorithm(algorithm), m_crc(0), m_lastError(AWS_ERROR_SUCCESS)
+            {
+            }
+
+            Checksum Checksum::CreateCRC32() noexcept { return Checksum(ChecksumAlgorithm::Crc32); }
+
+            Checksum Checksum::CreateCRC32C() noexcept { return Checksum(ChecksumAlgorithm::Crc32c); }
+
+            bool Checksum::Update(const ByteCursor &toChecksum) noexcept
+            {
+                m_crc = m_algorithm == ChecksumAlgorithm::Crc32c ? ComputeCRC32C(toChecksum, m_crc)
+                                                                 : ComputeCRC32(toChecksum, m_crc);
+                return true;
+            }
+
+            bool Checksum::Digest(ByteBuf &output) noexcept
+            {
+                if (!aws_byte_buf_write_be32(&output, m_crc))
+                {
+                    m_lastError = AWS_ERROR_SHORT_BUFFER;
+                    aws_raise_error(m_lastError);
+                    return false;
+                }
+
+                return true;
+            }
+        } // namespace Crypto
+    }     // namespace Crt
+} // namespace Aws
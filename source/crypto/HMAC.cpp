@@ -31,7 +31,23 @@ namespace Aws
                 return aws_sha256_hmac_compute(g_allocator, &secret, &input, &output, truncateTo) == AWS_OP_SUCCESS;
             }
 
-            HMAC::HMAC(aws_hmac *hmac) noexcept : m_hmac(hmac), m_good(false), m_lastError(0)
+            bool ComputeSHA256HMAC(
+                Allocator *allocator,
+                const ByteCursor &secret,
+                const ByteCursor &input,
+                SHA256HMACDigest &output) noexcept
+            {
+                ByteBuf outputBuf = ByteBufFromEmptyArray(output.data(), output.size());
+                return aws_sha256_hmac_compute(allocator, &secret, &input, &outputBuf, 0) == AWS_OP_SUCCESS;
+            }
+
+            bool ComputeSHA256HMAC(const ByteCursor &secret, const ByteCursor &input, SHA256HMACDigest &output) noexcept
+            {
+                return ComputeSHA256HMAC(g_allocator, secret, input, output);
+            }
+
+            HMAC::HMAC(aws_hmac *hmac, aws_hmac_new_fn *create, Allocator *allocator) noexcept
+                : m_hmac(hmac), m_create(create), m_allocator(allocator), m_good(false), m_lastError(0)
             {
                 if (hmac)
                 {
@@ -52,7 +68,9 @@ namespace Aws
                 }
             }
 
-            HMAC::HMAC(HMAC &&toMove) : m_hmac(toMove.m_hmac), m_good(toMove.m_good), m_lastError(toMove.m_lastError)
+            HMAC::HMAC(HMAC &&toMove)
+                : m_hmac(toMove.m_hmac), m_create(toMove.m_create), m_allocator(toMove.m_allocator),
+                  m_good(toMove.m_good), m_lastError(toMove.m_lastError)
             {
                 toMove.m_hmac = nullptr;
                 toMove.m_good = false;
@@ -62,7 +80,18 @@ namespace Aws
             {
                 if (&toMove != this)
                 {
-                    *this = HMAC(std::move(toMove));
+                    if (m_hmac)
+                    {
+                        aws_hmac_destroy(m_hmac);
+                    }
+
+                    m_hmac = toMove.m_hmac;
+                    m_create = toMove.m_create;
+                    m_allocator = toMove.m_allocator;
+                    m_good = toMove.m_good;
+                    m_lastError = toMove.m_lastError;
+                    toMove.m_hmac = nullptr;
+                    toMove.m_good = false;
                 }
 
                 return *this;
@@ -70,12 +99,12 @@ namespace Aws
 
             HMAC HMAC::CreateSHA256HMAC(Allocator *allocator, const ByteCursor &secret) noexcept
             {
-                return HMAC(aws_sha256_hmac_new(allocator, &secret));
+                return HMAC(aws_sha256_hmac_new(allocator, &secret), aws_sha256_hmac_new, allocator);
             }
 
             HMAC HMAC::CreateSHA256HMAC(const ByteCursor &secret) noexcept
             {
-                return HMAC(aws_sha256_hmac_new(g_allocator, &secret));
+                return HMAC(aws_sha256_hmac_new(g_allocator, &secret), aws_sha256_hmac_new, g_allocator);
             }
 
             bool HMAC::Update(const ByteCursor &toHMAC) noexcept
@@ -110,6 +139,38 @@ namespace Aws
                 return false;
             }
 
+            bool HMAC::Digest(SHA256HMACDigest &output) noexcept
+            {
+                ByteBuf outputBuf = ByteBufFromEmptyArray(output.data(), output.size());
+                return Digest(outputBuf);
+            }
+
+            bool HMAC::Reset(const ByteCursor &secret) noexcept
+            {
+                if (m_create == nullptr)
+                {
+                    m_lastError = AWS_ERROR_INVALID_STATE;
+                    aws_raise_error(m_lastError);
+                    return false;
+                }
+
+                /* the old HMAC goes first, so an allocator with a free list hands its memory straight back */
+                if (m_hmac)
+                {
+                    aws_hmac_destroy(m_hmac);
+                }
+
+                m_hmac = m_create(m_allocator, &secret);
+                m_good = m_hmac != nullptr;
+                if (!m_good)
+                {
+                    m_lastError = aws_last_error();
+                    return false;
+                }
+
+                return true;
+            }
+
             aws_hmac_vtable ByoHMAC::s_Vtable = {
                 "aws-crt-cpp-byo-crypto-hmac",
                 "aws-crt-cpp-byo-crypto",
@@ -26,6 +26,45 @@ namespace Aws
                 return aws_sha256_compute(DefaultAllocator(), &input, &output, truncateTo) == AWS_OP_SUCCESS;
             }
 
+            bool ComputeSHA256(Allocator *allocator, const ByteCursor &input, SHA256Digest &output) noexcept
+            {
+                ByteBuf outputBuf = ByteBufFromEmptyArray(output.data(), output.size());
+                return aws_sha256_compute(allocator, &input, &outputBuf, 0) == AWS_OP_SUCCESS;
+            }
+
+            bool ComputeSHA256(const ByteCursor &input, SHA256Digest &output) noexcept
+            {
+                return ComputeSHA256(DefaultAllocator(), input, output);
+            }
+
+            bool ComputeSHA256Batch(
+                Allocator *allocator,
+                const ByteCursor *inputs,
+                ByteBuf *outputs,
+                size_t count,
+                size_t truncateTo) noexcept
+            {
+                /* aws-cal can not restart a finished hash, so there is nothing to share between inputs */
+                for (size_t i = 0; i < count; ++i)
+                {
+                    if (aws_sha256_compute(allocator, &inputs[i], &outputs[i], truncateTo) != AWS_OP_SUCCESS)
+                    {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+            bool ComputeSHA256Batch(
+                const ByteCursor *inputs,
+                ByteBuf *outputs,
+                size_t count,
+                size_t truncateTo) noexcept
+            {
+                return ComputeSHA256Batch(DefaultAllocator(), inputs, outputs, count, truncateTo);
+            }
+
             bool ComputeMD5(Allocator *allocator, const ByteCursor &input, ByteBuf &output, size_t truncateTo) noexcept
             {
                 return aws_md5_compute(allocator, &input, &output, truncateTo) == AWS_OP_SUCCESS;
@@ -36,7 +75,19 @@ namespace Aws
                 return aws_md5_compute(DefaultAllocator(), &input, &output, truncateTo) == AWS_OP_SUCCESS;
             }
 
-            Hash::Hash(aws_hash *hash) noexcept : m_hash(hash), m_good(false), m_lastError(0)
+            bool ComputeMD5(Allocator *allocator, const ByteCursor &input, MD5Digest &output) noexcept
+            {
+                ByteBuf outputBuf = ByteBufFromEmptyArray(output.data(), output.size());
+                return aws_md5_compute(allocator, &input, &outputBuf, 0) == AWS_OP_SUCCESS;
+            }
+
+            bool ComputeMD5(const ByteCursor &input, MD5Digest &output) noexcept
+            {
+                return ComputeMD5(DefaultAllocator(), input, output);
+            }
+
+            Hash::Hash(aws_hash *hash, aws_hash_new_fn *create, Allocator *allocator) noexcept
+                : m_hash(hash), m_create(create), m_allocator(allocator), m_good(false), m_lastError(0)
             {
                 if (hash)
                 {
@@ -57,7 +108,9 @@ namespace Aws
                 }
             }
 
-            Hash::Hash(Hash &&toMove) : m_hash(toMove.m_hash), m_good(toMove.m_good), m_lastError(toMove.m_lastError)
+            Hash::Hash(Hash &&toMove)
+                : m_hash(toMove.m_hash), m_create(toMove.m_create), m_allocator(toMove.m_allocator),
+                  m_good(toMove.m_good), m_lastError(toMove.m_lastError)
             {
                 toMove.m_hash = nullptr;
                 toMove.m_good = false;
@@ -67,15 +120,32 @@ namespace Aws
             {
                 if (&toMove != this)
                 {
-                    *this = Hash(std::move(toMove));
+                    if (m_hash)
+                    {
+                        aws_hash_destroy(m_hash);
+                    }
+
+                    m_hash = toMove.m_hash;
+                    m_create = toMove.m_create;
+                    m_allocator = toMove.m_allocator;
+                    m_good = toMove.m_good;
+                    m_lastError = toMove.m_lastError;
+                    toMove.m_hash = nullptr;
+                    toMove.m_good = false;
                 }
 
                 return *this;
             }
 
-            Hash Hash::CreateSHA256(Allocator *allocator) noexcept { return Hash(aws_sha256_new(allocator)); }
+            Hash Hash::CreateSHA256(Allocator *allocator) noexcept
+            {
+                return Hash(aws_sha256_new(allocator), aws_sha256_new, allocator);
+            }
 
-            Hash Hash::CreateMD5(Allocator *allocator) noexcept { return Hash(aws_md5_new(allocator)); }
+            Hash Hash::CreateMD5(Allocator *allocator) noexcept
+            {
+                return Hash(aws_md5_new(allocator), aws_md5_new, allocator);
+            }
 
             bool Hash::Update(const ByteCursor &toHash) noexcept
             {
@@ -109,6 +179,54 @@ namespace Aws
                 return false;
             }
 
+            bool Hash::DigestInto(uint8_t *output, size_t size) noexcept
+            {
+                if (!*this)
+                {
+                    return false;
+                }
+
+                if (m_hash->digest_size != size)
+                {
+                    m_lastError = AWS_ERROR_INVALID_ARGUMENT;
+                    aws_raise_error(m_lastError);
+                    return false;
+                }
+
+                ByteBuf outputBuf = ByteBufFromEmptyArray(output, size);
+                return Digest(outputBuf);
+            }
+
+            bool Hash::Digest(SHA256Digest &output) noexcept { return DigestInto(output.data(), output.size()); }
+
+            bool Hash::Digest(MD5Digest &output) noexcept { return DigestInto(output.data(), output.size()); }
+
+            bool Hash::Reset() noexcept
+            {
+                if (m_create == nullptr)
+                {
+                    m_lastError = AWS_ERROR_INVALID_STATE;
+                    aws_raise_error(m_lastError);
+                    return false;
+                }
+
+                /* the old hash goes first, so an allocator with a free list hands its memory straight back */
+                if (m_hash)
+                {
+                    aws_hash_destroy(m_hash);
+                }
+
+                m_hash = m_create(m_allocator);
+                m_good = m_hash != nullptr;
+                if (!m_good)
+                {
+                    m_lastError = aws_last_error();
+                    return false;
+                }
+
+                return true;
+            }
+
             aws_hash_vtable ByoHash::s_Vtable = {
                 "aws-crt-cpp-byo-crypto-hash",
                 "aws-crt-cpp-byo-crypto",
@@ -0,0 +1,410 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/crypto/PartDigests.h>
+
+#include <aws/crt/private/WorkerThreads.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        size_t StartWorkerThreads(
+            size_t count,
+            const std::function<void()> &work,
+            Vector<std::thread> &threads) noexcept
+        {
+            threads.reserve(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                try
+                {
+                    threads.emplace_back(work);
+                }
+                catch (...)
+                {
+                    break;
+                }
+            }
+
+            return threads.size();
+        }
+
+        namespace Crypto
+        {
+            /* hashes data into digest, which has room for the algorithm's digest */
+            static int s_HashPart(
+                HashAlgorithm algorithm,
+                Allocator *allocator,
+                const ByteCursor &data,
+                uint8_t *digest,
+                size_t digestSize) noexcept
+            {
+                Hash hash = algorithm == HashAlgorithm::Md5 ? Hash::CreateMD5(allocator)
+                                                            : Hash::CreateSHA256(allocator);
+                ByteBuf output = ByteBufFromEmptyArray(digest, digestSize);
+                if (!hash.Update(data) || !hash.Digest(output))
+                {
+                    return hash.LastError() != AWS_ERROR_SUCCESS ? hash.LastError() : AWS_ERROR_UNKNOWN;
+                }
+
+                return AWS_ERROR_SUCCESS;
+            }
+
+            /* fills buffer from input until it is full or input ends */
+            static int s_ReadPart(Io::InputStream &input, ByteBuf &buffer, bool &end) noexcept
+            {
+                while (buffer.len < buffer.capacity)
+                {
+                    if (!input.Read(buffer))
+                    {
+                        return aws_last_error();
+                    }
+
+                    Io::StreamStatus status;
+                    AWS_ZERO_STRUCT(status);
+                    input.GetStatus(status);
+                    if (status.is_end_of_stream)
+                    {
+                        end = true;
+                        break;
+                    }
+                }
+
+                return AWS_ERROR_SUCCESS;
+            }
+
+            PartDigests::PartDigests(Allocator *allocator) noexcept
+                : m_allocator(allocator), m_algorithm(HashAlgorithm::Sha256), m_digestSize(0),
+                  m_digests(StlAllocator<uint8_t>(allocator)), m_totalLength(0), m_lastError(AWS_ERROR_SUCCESS)
+            {
+            }
+
+            bool PartDigests::Fail(int errorCode) noexcept
+            {
+                m_lastError = errorCode != AWS_ERROR_SUCCESS ? errorCode : AWS_ERROR_UNKNOWN;
+                aws_raise_error(m_lastError);
+                return false;
+            }
+
+            bool PartDigests::Start(const PartDigestOptions &options, size_t &threadCount) noexcept
+            {
+                m_digests.clear();
+                m_totalLength = 0;
+                m_lastError = AWS_ERROR_SUCCESS;
+                m_digestSize = 0;
+                if (options.PartSize == 0)
+                {
+                    return Fail(AWS_ERROR_INVALID_ARGUMENT);
+                }
+
+                m_algorithm = options.Algorithm;
+                m_digestSize = m_algorithm == HashAlgorithm::Md5 ? MD5_DIGEST_SIZE : SHA256_DIGEST_SIZE;
+
+                threadCount = options.ThreadCount;
+                if (threadCount == 0)
+                {
+                    threadCount = std::thread::hardware_concurrency();
+                    threadCount = threadCount ? threadCount : 1;
+                }
+
+                return true;
+            }
+
+            bool PartDigests::Compute(const ByteCursor &data, const PartDigestOptions &options) noexcept
+            {
+                size_t threadCount = 0;
+                if (!Start(options, threadCount))
+                {
+                    return false;
+                }
+
+                size_t partSize = options.PartSize;
+                size_t partCount = data.len == 0 ? 1 : data.len / partSize + (data.len % partSize != 0);
+                m_digests.resize(partCount * m_digestSize);
+                m_totalLength = data.len;
+
+                /* every thread, the calling one included, takes the next part nobody has taken yet */
+                std::atomic<size_t> nextPart(0);
+                std::atomic<int> error(AWS_ERROR_SUCCESS);
+                std::function<void()> work = [&]() {
+                    for (size_t part = nextPart++; part < partCount && error.load() == AWS_ERROR_SUCCESS;
+                         part = nextPart++)
+                    {
+                        size_t offset = part * partSize;
+                        size_t length = std::min(partSize, data.len - offset);
+                        uint8_t *digest = &m_digests[part * m_digestSize];
+                        ByteCursor partData = ByteCursorFromArray(data.ptr + offset, length);
+                        int result = s_HashPart(m_algorithm, m_allocator, partData, digest, m_digestSize);
+                        if (result != AWS_ERROR_SUCCESS)
+                        {
+                            int expected = AWS_ERROR_SUCCESS;
+                            error.compare_exchange_strong(expected, result);
+                        }
+                    }
+                };
+
+                StlAllocator<std::thread> threadAllocator(m_allocator);
+                Vector<std::thread> threads(threadAllocator);
+                StartWorkerThreads(std::min(threadCount, partCount) - 1, work, threads);
+                work();
+                for (auto &thread : threads)
+                {
+                    thread.join();
+                }
+
+                if (error.load() != AWS_ERROR_SUCCESS)
+                {
+                    m_digests.clear();
+                    return Fail(error.load());
+                }
+
+                return true;
+            }
+
+            bool PartDigests::Compute(Io::InputStream &input, const PartDigestOptions &options) noexcept
+            {
+                size_t threadCount = 0;
+                if (!Start(options, threadCount))
+                {
+                    return false;
+                }
+
+                struct ReadPart
+                {
+                    size_t index;
+                    ByteBuf buffer;
+                };
+
+                std::mutex lock;
+                std::condition_variable partReady;
+                std::condition_variable bufferFree;
+                StlAllocator<ReadPart> partAllocator(m_allocator);
+                std::deque<ReadPart, StlAllocator<ReadPart>> readParts(partAllocator);
+                StlAllocator<ByteBuf> bufferAllocator(m_allocator);
+                Vector<ByteBuf> freeBuffers(bufferAllocator);
+                bool readingDone = false;
+                int error = AWS_ERROR_SUCCESS;
+
+                /* the calling thread reads, and the rest hash what it has read */
+                std::function<void()> work = [&]() {
+                    std::unique_lock<std::mutex> guard(lock);
+                    while (true)
+                    {
+                        partReady.wait(guard, [&]() {
+                            return !readParts.empty() || readingDone || error != AWS_ERROR_SUCCESS;
+                        });
+                        if (readParts.empty() || error != AWS_ERROR_SUCCESS)
+                        {
+                            return;
+                        }
+
+                        ReadPart part = readParts.front();
+                        readParts.pop_front();
+                        guard.unlock();
+
+                        uint8_t digest[SHA256_DIGEST_SIZE];
+                        int result = s_HashPart(
+                            m_algorithm, m_allocator, ByteCursorFromByteBuf(part.buffer), digest, m_digestSize);
+
+                        guard.lock();
+                        if (result == AWS_ERROR_SUCCESS)
+                        {
+                            memcpy(&m_digests[part.index * m_digestSize], digest, m_digestSize);
+                        }
+                        else if (error == AWS_ERROR_SUCCESS)
+                        {
+                            error = result;
+                            partReady.notify_all();
+                        }
+                        part.buffer.len = 0;
+                        freeBuffers.push_back(part.buffer);
+                        bufferFree.notify_one();
+                    }
+                };
+
+                StlAllocator<std::thread> threadAllocator(m_allocator);
+                Vector<std::thread> threads(threadAllocator);
+                size_t workerCount = StartWorkerThreads(threadCount - 1, work, threads);
+                size_t maxBuffers = std::max<size_t>(workerCount * 2, 1);
+                size_t buffersCreated = 0;
+
+                bool end = false;
+                for (size_t index = 0; !end; ++index)
+                {
+                    ByteBuf buffer;
+                    AWS_ZERO_STRUCT(buffer);
+                    {
+                        std::unique_lock<std::mutex> guard(lock);
+                        bufferFree.wait(guard, [&]() {
+                            return !freeBuffers.empty() || buffersCreated < maxBuffers || error != AWS_ERROR_SUCCESS;
+                        });
+                        if (error != AWS_ERROR_SUCCESS)
+                        {
+                            break;
+                        }
+                        if (!freeBuffers.empty())
+                        {
+                            buffer = freeBuffers.back();
+                            freeBuffers.pop_back();
+                        }
+                    }
+
+                    if (buffer.buffer == nullptr)
+                    {
+                        if (aws_byte_buf_init(&buffer, m_allocator, options.PartSize))
+                        {
+                            std::lock_guard<std::mutex> guard(lock);
+                            error = aws_last_error();
+                            break;
+                        }
+                        ++buffersCreated;
+                    }
+
+                    int result = s_ReadPart(input, buffer, end);
+
+                    std::lock_guard<std::mutex> guard(lock);
+                    /* a stream that ends right after a whole part has nothing more to hash */
+                    bool empty = buffer.len == 0 && index > 0;
+                    if (result != AWS_ERROR_SUCCESS || empty)
+                    {
+                        error = result;
+                        freeBuffers.push_back(buffer);
+                        break;
+                    }
+
+                    m_digests.resize((index + 1) * m_digestSize);
+                    m_totalLength += buffer.len;
+                    if (workerCount == 0)
+                    {
+                        /* without other threads, the parts are hashed as they are read */
+                        ByteCursor partData = ByteCursorFromByteBuf(buffer);
+                        uint8_t *digest = &m_digests[index * m_digestSize];
+                        error = s_HashPart(m_algorithm, m_allocator, partData, digest, m_digestSize);
+                        buffer.len = 0;
+                        freeBuffers.push_back(buffer);
+                        if (error != AWS_ERROR_SUCCESS)
+                        {
+                            break;
+                        }
+                        continue;
+                    }
+
+                    readParts.push_back({index, buffer});
+                    partReady.notify_one();
+                }
+
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    readingDone = true;
+                }
+                partReady.notify_all();
+                for (auto &thread : threads)
+                {
+                    thread.join();
+                }
+
+                for (auto &part : readParts)
+                {
+                    aws_byte_buf_clean_up(&part.buffer);
+                }
+                for (auto &buffer : freeBuffers)
+                {
+                    aws_byte_buf_clean_up(&buffer);
+                }
+
+                if (error != AWS_ERROR_SUCCESS)
+                {
+                    m_digests.clear();
+                    m_totalLength = 0;
+                    return Fail(error);
+                }
+
+                return true;
+            }
+
+            ByteCursor PartDigests::GetPartDigest(size_t index) const noexcept
+            {
+                if (index >= GetPartCount())
+                {
+                    return ByteCursorFromArray(nullptr, 0);
+                }
+
+                return ByteCursorFromArray(&m_digests[index * m_digestSize], m_digestSize);
+            }
+
+            bool PartDigests::WriteDigest(const uint8_t *digest, ByteBuf &output) noexcept
+            {
+                if (!aws_byte_buf_write(&output, digest, m_digestSize))
+                {
+                    return Fail(AWS_ERROR_SHORT_BUFFER);
+                }
+
+                return true;
+            }
+
+            bool PartDigests::ComputeCompositeDigest(ByteBuf &output) noexcept
+            {
+                if (m_digests.empty())
+                {
+                    return Fail(AWS_ERROR_INVALID_STATE);
+                }
+
+                uint8_t digest[SHA256_DIGEST_SIZE];
+                int result = s_HashPart(
+                    m_algorithm, m_allocator, ByteCursorFromArray(m_digests.data(), m_digests.size()), digest,
+                    m_digestSize);
+                if (result != AWS_ERROR_SUCCESS)
+                {
+                    return Fail(result);
+                }
+
+                return WriteDigest(digest, output);
+            }
+
+            bool PartDigests::ComputeTreeDigest(ByteBuf &output) noexcept
+            {
+                if (m_digests.empty())
+                {
+                    return Fail(AWS_ERROR_INVALID_STATE);
+                }
+
+                /* each level is written over the start of the one below it, which has been read by then */
+                Vector<uint8_t> level(m_digests);
+                size_t count = GetPartCount();
+                while (count > 1)
+                {
+                    size_t next = 0;
+                    for (size_t i = 0; i + 1 < count; i += 2, ++next)
+                    {
+                        int result = s_HashPart(
+                            m_algorithm, m_allocator, ByteCursorFromArray(&level[i * m_digestSize], 2 * m_digestSize),
+                            &level[next * m_digestSize], m_digestSize);
+                        if (result != AWS_ERROR_SUCCESS)
+                        {
+                            return Fail(result);
+                        }
+                    }
+
+                    if (count % 2 != 0)
+                    {
+                        memmove(&level[next * m_digestSize], &level[(count - 1) * m_digestSize], m_digestSize);
+                        ++next;
+                    }
+                    count = next;
+                }
+
+                return WriteDigest(level.data(), output);
+            }
+        } // namespace Crypto
+    }     // namespace Crt
+} // namespace Aws
@@ -0,0 +1,561 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/eventstream/EventStream.h>
+
+#include <aws/crt/Api.h>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Eventstream
+        {
+            static const size_t s_uuidLength = 16;
+
+            EventStreamHeaderView::EventStreamHeaderView() noexcept
+                : m_type(EventStreamHeaderValueType::BoolFalse), m_value(aws_byte_cursor_from_array(nullptr, 0))
+            {
+            }
+
+            EventStreamHeaderView::EventStreamHeaderView(
+                StringView name,
+                EventStreamHeaderValueType type,
+                ByteCursor value) noexcept
+                : m_name(name), m_type(type), m_value(value)
+            {
+            }
+
+            EventStreamHeaderView::EventStreamHeaderView(const aws_event_stream_header_value_pair &header) noexcept
+                : m_name(header.header_name, header.header_name_len),
+                  m_type(static_cast<EventStreamHeaderValueType>(header.header_value_type))
+            {
+                /* fixed-size values are kept in network byte order, just as on the wire */
+                if (m_type == EventStreamHeaderValueType::ByteBuf || m_type == EventStreamHeaderValueType::String)
+                {
+                    m_value = aws_byte_cursor_from_array(header.header_value.variable_len_val, header.header_value_len);
+                }
+                else
+                {
+                    m_value = aws_byte_cursor_from_array(header.header_value.static_val, header.header_value_len);
+                }
+            }
+
+            bool EventStreamHeaderView::IsType(EventStreamHeaderValueType type, size_t length) const noexcept
+            {
+                return m_type == type && m_value.len >= length;
+            }
+
+            bool EventStreamHeaderView::GetValueAsBool() const noexcept
+            {
+                return m_type == EventStreamHeaderValueType::BoolTrue;
+            }
+
+            int8_t EventStreamHeaderView::GetValueAsByte() const noexcept
+            {
+                if (!IsType(EventStreamHeaderValueType::Byte, sizeof(int8_t)))
+                {
+                    return 0;
+                }
+
+                return static_cast<int8_t>(m_value.ptr[0]);
+            }
+
+            int16_t EventStreamHeaderView::GetValueAsInt16() const noexcept
+            {
+                uint16_t value = 0;
+                if (IsType(EventStreamHeaderValueType::Int16, sizeof(value)))
+                {
+                    ByteCursor cursor = m_value;
+                    aws_byte_cursor_read_be16(&cursor, &value);
+                }
+
+                return static_cast<int16_t>(value);
+            }
+
+            int32_t EventStreamHeaderView::GetValueAsInt32() const noexcept
+            {
+                uint32_t value = 0;
+                if (IsType(EventStreamHeaderValueType::Int32, sizeof(value)))
+                {
+                    ByteCursor cursor = m_value;
+                    aws_byte_cursor_read_be32(&cursor, &value);
+                }
+
+                return static_cast<int32_t>(value);
+            }
+
+            int64_t EventStreamHeaderView::GetValueAsInt64() const noexcept
+            {
+                uint64_t value = 0;
+                if (IsType(EventStreamHeaderValueType::Int64, sizeof(value)))
+                {
+                    ByteCursor cursor = m_value;
+                    aws_byte_cursor_read_be64(&cursor, &value);
+                }
+
+                return static_cast<int64_t>(value);
+            }
+
+            DateTime EventStreamHeaderView::GetValueAsTimestamp() const noexcept
+            {
+                uint64_t millis = 0;
+                if (IsType(EventStreamHeaderValueType::Timestamp, sizeof(millis)))
+                {
+                    ByteCursor cursor = m_value;
+                    aws_byte_cursor_read_be64(&cursor, &millis);
+                }
+
+                return DateTime(millis);
+            }
+
+            StringView EventStreamHeaderView::GetValueAsString() const noexcept
+            {
+                if (m_type != EventStreamHeaderValueType::String)
+                {
+                    return StringView();
+                }
+
+                return StringView(reinterpret_cast<const char *>(m_value.ptr), m_value.len);
+            }
+
+            ByteCursor EventStreamHeaderView::GetValueAsBytes() const noexcept
+            {
+                if (m_type != EventStreamHeaderValueType::ByteBuf)
+                {
+                    return aws_byte_cursor_from_array(nullptr, 0);
+                }
+
+                return m_value;
+            }
+
+            ByteCursor EventStreamHeaderView::GetValueAsUuid() const noexcept
+            {
+                if (!IsType(EventStreamHeaderValueType::Uuid, s_uuidLength))
+                {
+                    return aws_byte_cursor_from_array(nullptr, 0);
+                }
+
+                return aws_byte_cursor_from_array(m_value.ptr, s_uuidLength);
+            }
+
+            EventStreamHeaders::EventStreamHeaders(Allocator *allocator) noexcept
+                : m_allocator(allocator), m_lastError(AWS_ERROR_SUCCESS)
+            {
+                if (aws_event_stream_headers_list_init(&m_headers, allocator))
+                {
+                    AWS_ZERO_STRUCT(m_headers);
+                    m_lastError = aws_last_error();
+                }
+            }
+
+            EventStreamHeaders::~EventStreamHeaders()
+            {
+                if (m_lastError == AWS_ERROR_SUCCESS)
+                {
+                    aws_event_stream_headers_list_cleanup(&m_headers);
+                }
+            }
+
+            EventStreamHeaders::EventStreamHeaders(EventStreamHeaders &&toMove) noexcept
+                : m_allocator(toMove.m_allocator), m_headers(toMove.m_headers), m_lastError(toMove.m_lastError)
+            {
+                AWS_ZERO_STRUCT(toMove.m_headers);
+                toMove.m_lastError = AWS_ERROR_INVALID_STATE;
+            }
+
+            EventStreamHeaders &EventStreamHeaders::operator=(EventStreamHeaders &&toMove) noexcept
+            {
+                if (this != &toMove)
+                {
+                    this->~EventStreamHeaders();
+                    new (this) EventStreamHeaders(std::move(toMove));
+                }
+
+                return *this;
+            }
+
+            bool EventStreamHeaders::CheckName(StringView name) const noexcept
+            {
+                if (m_lastError != AWS_ERROR_SUCCESS)
+                {
+                    aws_raise_error(m_lastError);
+                    return false;
+                }
+
+                if (name.empty() || name.size() > INT8_MAX)
+                {
+                    aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                    return false;
+                }
+
+                return true;
+            }
+
+            bool EventStreamHeaders::AddBool(StringView name, bool value) noexcept
+            {
+                return CheckName(name) &&
+                       aws_event_stream_add_bool_header(
+                           &m_headers, name.data(), static_cast<uint8_t>(name.size()), value ? 1 : 0) ==
+                           AWS_OP_SUCCESS;
+            }
+
+            bool EventStreamHeaders::AddByte(StringView name, int8_t value) noexcept
+            {
+                return CheckName(name) &&
+                       aws_event_stream_add_byte_header(
+                           &m_headers, name.data(), static_cast<uint8_t>(name.size()), value) == AWS_OP_SUCCESS;
+            }
+
+            bool EventStreamHeaders::AddInt16(StringView name, int16_t value) noexcept
+            {
+                return CheckName(name) &&
+                       aws_event_stream_add_int16_header(
+                           &m_headers, name.data(), static_cast<uint8_t>(name.size()), value) == AWS_OP_SUCCESS;
+            }
+
+            bool EventStreamHeaders::AddInt32(StringView name, int32_t value) noexcept
+            {
+                return CheckName(name) &&
+                       aws_event_stream_add_int32_header(
+                           &m_headers, name.data(), static_cast<uint8_t>(name.size()), value) == AWS_OP_SUCCESS;
+            }
+
+            bool EventStreamHeaders::AddInt64(StringView name, int64_t value) noexcept
+            {
+                return CheckName(name) &&
+                       aws_event_stream_add_int64_header(
+                           &m_headers, name.data(), static_cast<uint8_t>(name.size()), value) == AWS_OP_SUCCESS;
+            }
+
+            bool EventStreamHeaders::AddTimestamp(StringView name, const DateTime &value) noexcept
+            {
+                return CheckName(name) && aws_event_stream_add_timestamp_header(
+                                              &m_headers,
+                                              name.data(),
+                                              static_cast<uint8_t>(name.size()),
+                                              static_cast<int64_t>(value.Millis())) == AWS_OP_SUCCESS;
+            }
+
+            bool EventStreamHeaders::AddString(StringView name, StringView value) noexcept
+            {
+                if (!CheckName(name))
+                {
+                    return false;
+                }
+
+                if (value.size() > UINT16_MAX)
+                {
+                    aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                    return false;
+                }
+
+                return aws_event_stream_add_string_header(
+                           &m_headers,
+                           name.data(),
+                           static_cast<uint8_t>(name.size()),
+                           value.data(),
+                           static_cast<uint16_t>(value.size()),
+                           0 /* copy */) == AWS_OP_SUCCESS;
+            }
+
+            bool EventStreamHeaders::AddBytes(StringView name, ByteCursor value) noexcept
+            {
+                if (!CheckName(name))
+                {
+                    return false;
+                }
+
+                if (value.len > UINT16_MAX)
+                {
+                    aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                    return false;
+                }
+
+                return aws_event_stream_add_bytebuf_header(
+                           &m_headers,
+                           name.data(),
+                           static_cast<uint8_t>(name.size()),
+                           value.ptr,
+                           static_cast<uint16_t>(value.len),
+                           0 /* copy */) == AWS_OP_SUCCESS;
+            }
+
+            bool EventStreamHeaders::AddUuid(StringView name, ByteCursor value) noexcept
+            {
+                if (!CheckName(name))
+                {
+                    return false;
+                }
+
+                if (value.len != s_uuidLength)
+                {
+                    aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                    return false;
+                }
+
+                return aws_event_stream_add_uuid_header(
+                           &m_headers, name.data(), static_cast<uint8_t>(name.size()), value.ptr) == AWS_OP_SUCCESS;
+            }
+
+            size_t EventStreamHeaders::GetCount() const noexcept
+            {
+                return m_lastError == AWS_ERROR_SUCCESS ? aws_array_list_length(&m_headers) : 0;
+            }
+
+            EventStreamHeaderView EventStreamHeaders::GetHeader(size_t index) const noexcept
+            {
+                aws_event_stream_header_value_pair *header = nullptr;
+                if (index >= GetCount() ||
+                    aws_array_list_get_at_ptr(&m_headers, reinterpret_cast<void **>(&header), index))
+                {
+                    return EventStreamHeaderView();
+                }
+
+                return EventStreamHeaderView(*header);
+            }
+
+            EventStreamMessage::EventStreamMessage(Allocator *allocator) noexcept
+                : m_allocator(allocator), m_hasMessage(false), m_lastError(AWS_ERROR_SUCCESS)
+            {
+                ApiHandle::InitializeSubsystem(ApiSubsystem::EventStream);
+
+                AWS_ZERO_STRUCT(m_message);
+            }
+
+            EventStreamMessage::~EventStreamMessage() { CleanUp(); }
+
+            EventStreamMessage::EventStreamMessage(EventStreamMessage &&toMove) noexcept
+                : m_allocator(toMove.m_allocator), m_message(toMove.m_message), m_hasMessage(toMove.m_hasMessage),
+                  m_lastError(toMove.m_lastError)
+            {
+                AWS_ZERO_STRUCT(toMove.m_message);
+                toMove.m_hasMessage = false;
+            }
+
+            EventStreamMessage &EventStreamMessage::operator=(EventStreamMessage &&toMove) noexcept
+            {
+                if (this != &toMove)
+                {
+                    this->~EventStreamMessage();
+                    new (this) EventStreamMessage(std::move(toMove));
+                }
+
+                return *this;
+            }
+
+            void EventStreamMessage::CleanUp() noexcept
+            {
+                if (m_hasMessage)
+                {
+                    aws_event_stream_message_clean_up(&m_message);
+                    AWS_ZERO_STRUCT(m_message);
+                    m_hasMessage = false;
+                }
+            }
+
+            bool EventStreamMessage::Encode(const EventStreamHeaders &headers, const ByteCursor &payload) noexcept
+            {
+                CleanUp();
+                if (!headers)
+                {
+                    m_lastError = headers.LastError();
+                    aws_raise_error(m_lastError);
+                    return false;
+                }
+
+                ByteBuf payloadBuf = aws_byte_buf_from_array(payload.ptr, payload.len);
+                if (aws_event_stream_message_init(
+                        &m_message,
+                        m_allocator,
+                        const_cast<aws_array_list *>(headers.GetUnderlyingHandle()),
+                        &payloadBuf))
+                {
+                    m_lastError = aws_last_error();
+                    AWS_ZERO_STRUCT(m_message);
+                    return false;
+                }
+
+                m_hasMessage = true;
+                m_lastError = AWS_ERROR_SUCCESS;
+                return true;
+            }
+
+            bool EventStreamMessage::Decode(const ByteCursor &buffer, bool copy) noexcept
+            {
+                CleanUp();
+
+                ByteBuf encoded = aws_byte_buf_from_array(buffer.ptr, buffer.len);
+                int result = copy ? aws_event_stream_message_from_buffer_copy(&m_message, m_allocator, &encoded)
+                                  : aws_event_stream_message_from_buffer(&m_message, m_allocator, &encoded);
+                if (result)
+                {
+                    m_lastError = aws_last_error();
+                    AWS_ZERO_STRUCT(m_message);
+                    return false;
+                }
+
+                m_hasMessage = true;
+                m_lastError = AWS_ERROR_SUCCESS;
+                return true;
+            }
+
+            ByteCursor EventStreamMessage::GetEncoded() const noexcept
+            {
+                if (!m_hasMessage)
+                {
+                    return aws_byte_cursor_from_array(nullptr, 0);
+                }
+
+                return aws_byte_cursor_from_array(
+                    aws_event_stream_message_buffer(&m_message), aws_event_stream_message_total_length(&m_message));
+            }
+
+            ByteCursor EventStreamMessage::GetPayload() const noexcept
+            {
+                if (!m_hasMessage)
+                {
+                    return aws_byte_cursor_from_array(nullptr, 0);
+                }
+
+                return aws_byte_cursor_from_array(
+                    aws_event_stream_message_payload(&m_message), aws_event_stream_message_payload_len(&m_message));
+            }
+
+            uint32_t EventStreamMessage::GetPreludeCrc() const noexcept
+            {
+                return m_hasMessage ? aws_event_stream_message_prelude_crc(&m_message) : 0;
+            }
+
+            uint32_t EventStreamMessage::GetMessageCrc() const noexcept
+            {
+                return m_hasMessage ? aws_event_stream_message_message_crc(&m_message) : 0;
+            }
+
+            bool EventStreamMessage::ForEachHeader(const OnEventStreamHeader &onHeader) const noexcept
+            {
+                if (!m_hasMessage)
+                {
+                    aws_raise_error(AWS_ERROR_INVALID_STATE);
+                    return false;
+                }
+
+                ByteCursor headers = aws_byte_cursor_from_array(
+                    aws_event_stream_message_buffer(&m_message) + AWS_EVENT_STREAM_PRELUDE_LENGTH,
+                    aws_event_stream_message_headers_len(&m_message));
+                return ForEachHeader(headers, onHeader);
+            }
+
+            bool EventStreamMessage::FindHeader(StringView name, EventStreamHeaderView &header) const noexcept
+            {
+                bool found = false;
+                bool wellFormed = ForEachHeader([&](const EventStreamHeaderView &candidate) {
+                    if (candidate.GetName() == name)
+                    {
+                        header = candidate;
+                        found = true;
+                    }
+                    return !found;
+                });
+
+                return wellFormed && found;
+            }
+
+            /*
+             * Each header is a one byte name length, the name, a one byte value type, and the value: nothing for
+             * booleans, a fixed number of big-endian bytes for the numeric types, 16 bytes for a uuid, and a two
+             * byte length followed by the bytes for strings and byte buffers.
+             */
+            static bool s_ReadHeader(ByteCursor &headers, EventStreamHeaderView &header) noexcept
+            {
+                uint8_t nameLength = 0;
+                if (!aws_byte_cursor_read_u8(&headers, &nameLength) || nameLength == 0)
+                {
+                    aws_raise_error(AWS_ERROR_EVENT_STREAM_MESSAGE_INVALID_HEADERS_LEN);
+                    return false;
+                }
+
+                ByteCursor name = aws_byte_cursor_advance(&headers, nameLength);
+                uint8_t type = 0;
+                if (name.len != nameLength || !aws_byte_cursor_read_u8(&headers, &type))
+                {
+                    aws_raise_error(AWS_ERROR_EVENT_STREAM_MESSAGE_INVALID_HEADERS_LEN);
+                    return false;
+                }
+
+                size_t valueLength = 0;
+                switch (static_cast<EventStreamHeaderValueType>(type))
+                {
+                    case EventStreamHeaderValueType::BoolTrue:
+                    case EventStreamHeaderValueType::BoolFalse:
+                        valueLength = 0;
+                        break;
+                    case EventStreamHeaderValueType::Byte:
+                        valueLength = 1;
+                        break;
+                    case EventStreamHeaderValueType::Int16:
+                        valueLength = 2;
+                        break;
+                    case EventStreamHeaderValueType::Int32:
+                        valueLength = 4;
+                        break;
+                    case EventStreamHeaderValueType::Int64:
+                    case EventStreamHeaderValueType::Timestamp:
+                        valueLength = 8;
+                        break;
+                    case EventStreamHeaderValueType::Uuid:
+                        valueLength = s_uuidLength;
+                        break;
+                    case EventStreamHeaderValueType::ByteBuf:
+                    case EventStreamHeaderValueType::String:
+                    {
+                        uint16_t length = 0;
+                        if (!aws_byte_cursor_read_be16(&headers, &length))
+                        {
+                            aws_raise_error(AWS_ERROR_EVENT_STREAM_MESSAGE_INVALID_HEADERS_LEN);
+                            return false;
+                        }
+                        valueLength = length;
+                        break;
+                    }
+                    default:
+                        aws_raise_error(AWS_ERROR_EVENT_STREAM_MESSAGE_UNKNOWN_HEADER_TYPE);
+                        return false;
+                }
+
+                if (headers.len < valueLength)
+                {
+                    aws_raise_error(AWS_ERROR_EVENT_STREAM_MESSAGE_INVALID_HEADERS_LEN);
+                    return false;
+                }
+
+                ByteCursor value = aws_byte_cursor_advance(&headers, valueLength);
+                header = EventStreamHeaderView(
+                    StringView(reinterpret_cast<const char *>(name.ptr), name.len),
+                    static_cast<EventStreamHeaderValueType>(type),
+                    value);
+                return true;
+            }
+
+            bool EventStreamMessage::ForEachHeader(ByteCursor headers, const OnEventStreamHeader &onHeader) noexcept
+            {
+                while (headers.len > 0)
+                {
+                    EventStreamHeaderView header;
+                    if (!s_ReadHeader(headers, header))
+                    {
+                        return false;
+                    }
+
+                    if (!onHeader(header))
+                    {
+                        break;
+                    }
+                }
+
+                return true;
+            }
+        } // namespace Eventstream
+    }     // namespace Crt
+} // namespace Aws
@@ -0,0 +1,196 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/eventstream/EventStreamDecoder.h>
+
+#include <aws/crt/Api.h>
+
+#include <aws/checksums/crc.h>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Eventstream
+        {
+            const size_t EventStreamDecoder::DefaultMaxMessageLength;
+
+            /* the prelude is the total length, the headers length and the CRC32 of those two */
+            static const size_t s_preludeCrcOffset = 8;
+
+            EventStreamDecoder::EventStreamDecoder(
+                OnEventStreamMessage &&onMessage,
+                size_t maxMessageLength,
+                Allocator *allocator) noexcept
+                : m_allocator(allocator), m_onMessage(std::move(onMessage)), m_maxMessageLength(maxMessageLength),
+                  m_messageLength(0), m_message(allocator), m_messageCount(0), m_lastError(AWS_ERROR_SUCCESS)
+            {
+                ApiHandle::InitializeSubsystem(ApiSubsystem::EventStream);
+
+                AWS_ZERO_STRUCT(m_buffer);
+            }
+
+            EventStreamDecoder::~EventStreamDecoder()
+            {
+                if (m_buffer.allocator != nullptr)
+                {
+                    aws_byte_buf_clean_up(&m_buffer);
+                }
+            }
+
+            bool EventStreamDecoder::Fail() noexcept
+            {
+                m_lastError = aws_last_error();
+                if (m_lastError == AWS_ERROR_SUCCESS)
+                {
+                    m_lastError = AWS_ERROR_UNKNOWN;
+                }
+
+                return false;
+            }
+
+            bool EventStreamDecoder::ReadPrelude(const uint8_t *prelude, uint32_t &messageLength) noexcept
+            {
+                ByteCursor cursor = aws_byte_cursor_from_array(prelude, AWS_EVENT_STREAM_PRELUDE_LENGTH);
+                uint32_t headersLength = 0;
+                uint32_t preludeCrc = 0;
+                aws_byte_cursor_read_be32(&cursor, &messageLength);
+                aws_byte_cursor_read_be32(&cursor, &headersLength);
+                aws_byte_cursor_read_be32(&cursor, &preludeCrc);
+
+                if (aws_checksums_crc32(prelude, static_cast<int>(s_preludeCrcOffset), 0) != preludeCrc)
+                {
+                    aws_raise_error(AWS_ERROR_EVENT_STREAM_PRELUDE_CHECKSUM_FAILURE);
+                    return Fail();
+                }
+
+                if (messageLength > m_maxMessageLength)
+                {
+                    aws_raise_error(AWS_ERROR_EVENT_STREAM_MESSAGE_FIELD_SIZE_EXCEEDED);
+                    return Fail();
+                }
+
+                if (messageLength < AWS_EVENT_STREAM_PRELUDE_LENGTH + AWS_EVENT_STREAM_TRAILER_LENGTH ||
+                    headersLength > messageLength - AWS_EVENT_STREAM_PRELUDE_LENGTH - AWS_EVENT_STREAM_TRAILER_LENGTH)
+                {
+                    aws_raise_error(AWS_ERROR_EVENT_STREAM_MESSAGE_INVALID_HEADERS_LEN);
+                    return Fail();
+                }
+
+                return true;
+            }
+
+            bool EventStreamDecoder::Emit(const ByteCursor &encoded) noexcept
+            {
+                if (!m_message.Decode(encoded))
+                {
+                    return Fail();
+                }
+
+                ++m_messageCount;
+                if (m_onMessage)
+                {
+                    m_onMessage(m_message);
+                }
+
+                return true;
+            }
+
+            bool EventStreamDecoder::Decode(const ByteCursor &data) noexcept
+            {
+                if (m_lastError != AWS_ERROR_SUCCESS)
+                {
+                    aws_raise_error(m_lastError);
+                    return false;
+                }
+
+                ByteCursor input = data;
+                while (input.len > 0)
+                {
+                    /* nothing buffered: decode messages that are whole in this chunk without copying them */
+                    if (m_buffer.len == 0 && input.len >= AWS_EVENT_STREAM_PRELUDE_LENGTH)
+                    {
+                        uint32_t messageLength = 0;
+                        if (!ReadPrelude(input.ptr, messageLength))
+                        {
+                            return false;
+                        }
+
+                        if (input.len >= messageLength)
+                        {
+                            if (!Emit(aws_byte_cursor_advance(&input, messageLength)))
+                            {
+                                return false;
+                            }
+                            continue;
+                        }
+                    }
+
+                    if (m_buffer.allocator == nullptr &&
+                        aws_byte_buf_init(&m_buffer, m_allocator, AWS_EVENT_STREAM_PRELUDE_LENGTH))
+                    {
+                        return Fail();
+                    }
+
+                    if (m_messageLength == 0)
+                    {
+                        size_t missing = AWS_EVENT_STREAM_PRELUDE_LENGTH - m_buffer.len;
+                        ByteCursor prelude = aws_byte_cursor_advance(&input, missing < input.len ? missing : input.len);
+                        aws_byte_buf_append(&m_buffer, &prelude);
+                        if (m_buffer.len < AWS_EVENT_STREAM_PRELUDE_LENGTH)
+                        {
+                            break;
+                        }
+
+                        if (!ReadPrelude(m_buffer.buffer, m_messageLength))
+                        {
+                            return false;
+                        }
+
+                        if (aws_byte_buf_reserve(&m_buffer, m_messageLength))
+                        {
+                            return Fail();
+                        }
+                    }
+
+                    size_t missing = m_messageLength - m_buffer.len;
+                    ByteCursor rest = aws_byte_cursor_advance(&input, missing < input.len ? missing : input.len);
+                    aws_byte_buf_append(&m_buffer, &rest);
+                    if (m_buffer.len < m_messageLength)
+                    {
+                        break;
+                    }
+
+                    m_messageLength = 0;
+                    bool emitted = Emit(aws_byte_cursor_from_buf(&m_buffer));
+                    m_buffer.len = 0;
+                    if (!emitted)
+                    {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+            EventStreamBodySink::EventStreamBodySink(
+                OnEventStreamMessage &&onMessage,
+                size_t maxMessageLength,
+                Allocator *allocator) noexcept
+                : m_decoder(std::move(onMessage), maxMessageLength, allocator)
+            {
+            }
+
+            size_t EventStreamBodySink::OnBodyData(const ByteCursor &data) noexcept
+            {
+                if (m_decoder && !m_decoder.Decode(data) && OnDecodeError)
+                {
+                    OnDecodeError(m_decoder.LastError());
+                }
+
+                return data.len;
+            }
+        } // namespace Eventstream
+    }     // namespace Crt
+} // namespace Aws
@@ -0,0 +1,469 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/eventstream/EventStreamRpcClient.h>
+
+#include <aws/crt/Api.h>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Eventstream
+        {
+            EventStreamRpcMessageView::EventStreamRpcMessageView(
+                const aws_event_stream_rpc_message_args &message) noexcept
+                : m_message(&message)
+            {
+            }
+
+            EventStreamRpcMessageType EventStreamRpcMessageView::GetType() const noexcept
+            {
+                return static_cast<EventStreamRpcMessageType>(m_message->message_type);
+            }
+
+            EventStreamHeaderView EventStreamRpcMessageView::GetHeader(size_t index) const noexcept
+            {
+                if (index >= m_message->headers_count)
+                {
+                    return EventStreamHeaderView();
+                }
+
+                return EventStreamHeaderView(m_message->headers[index]);
+            }
+
+            bool EventStreamRpcMessageView::FindHeader(StringView name, EventStreamHeaderView &header) const noexcept
+            {
+                for (size_t i = 0; i < m_message->headers_count; ++i)
+                {
+                    EventStreamHeaderView candidate(m_message->headers[i]);
+                    if (candidate.GetName() == name)
+                    {
+                        header = candidate;
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            ByteCursor EventStreamRpcMessageView::GetPayload() const noexcept
+            {
+                if (m_message->payload == nullptr)
+                {
+                    return aws_byte_cursor_from_array(nullptr, 0);
+                }
+
+                return aws_byte_cursor_from_buf(m_message->payload);
+            }
+
+            struct EventStreamRpcConnectionCallbackData
+            {
+                explicit EventStreamRpcConnectionCallbackData(Allocator *allocator) : allocator(allocator) {}
+
+                Allocator *allocator;
+                OnEventStreamRpcConnectionSetup onConnectionSetup;
+                OnEventStreamRpcProtocolMessage onProtocolMessage;
+                OnEventStreamRpcConnectionShutdown onConnectionShutdown;
+                std::weak_ptr<EventStreamRpcClientConnection> connection;
+            };
+
+            /*
+             * Shared by the continuation object and, once the stream has been activated, the C side, which hands
+             * its reference back in the closed callback. A stream that never got activated is never closed.
+             */
+            struct EventStreamRpcContinuationCallbackData
+            {
+                explicit EventStreamRpcContinuationCallbackData(Allocator *allocator)
+                    : allocator(allocator), refCount(1)
+                {
+                }
+
+                Allocator *allocator;
+                OnEventStreamRpcContinuationMessage onMessage;
+                OnEventStreamRpcContinuationClosed onClosed;
+                std::weak_ptr<EventStreamRpcClientContinuation> continuation;
+                std::atomic<int> refCount;
+            };
+
+            static void s_releaseContinuationCallbackData(EventStreamRpcContinuationCallbackData *callbackData)
+            {
+                if (--callbackData->refCount == 0)
+                {
+                    Crt::Delete(callbackData, callbackData->allocator);
+                }
+            }
+
+            struct EventStreamRpcFlushCallbackData
+            {
+                EventStreamRpcFlushCallbackData(Allocator *allocator, OnEventStreamRpcMessageFlushed &&onFlushed)
+                    : allocator(allocator), onFlushed(std::move(onFlushed))
+                {
+                }
+
+                Allocator *allocator;
+                OnEventStreamRpcMessageFlushed onFlushed;
+            };
+
+            static void s_onMessageFlushed(int errorCode, void *userData)
+            {
+                auto *callbackData = static_cast<EventStreamRpcFlushCallbackData *>(userData);
+                if (callbackData == nullptr)
+                {
+                    return;
+                }
+
+                callbackData->onFlushed(errorCode);
+                Crt::Delete(callbackData, callbackData->allocator);
+            }
+
+            /*
+             * Builds the arguments for one send, and the flush callback data that goes along with them. The
+             * payload buffer only wraps the caller's bytes, the C side encodes everything before returning.
+             */
+            static bool s_prepareSend(
+                const EventStreamRpcMessage &message,
+                OnEventStreamRpcMessageFlushed &&onFlushed,
+                Allocator *allocator,
+                ByteBuf &payload,
+                aws_event_stream_rpc_message_args &args,
+                EventStreamRpcFlushCallbackData *&flushData) noexcept
+            {
+                if (message.Headers != nullptr && !*message.Headers)
+                {
+                    aws_raise_error(message.Headers->LastError());
+                    return false;
+                }
+
+                flushData = nullptr;
+                if (onFlushed)
+                {
+                    flushData = Crt::New<EventStreamRpcFlushCallbackData>(allocator, allocator, std::move(onFlushed));
+                    if (flushData == nullptr)
+                    {
+                        return false;
+                    }
+                }
+
+                payload = aws_byte_buf_from_array(message.Payload.ptr, message.Payload.len);
+
+                AWS_ZERO_STRUCT(args);
+                if (message.Headers != nullptr)
+                {
+                    args.headers = static_cast<aws_event_stream_header_value_pair *>(
+                        message.Headers->GetUnderlyingHandle()->data);
+                    args.headers_count = message.Headers->GetCount();
+                }
+                args.payload = &payload;
+                args.message_type = static_cast<aws_event_stream_rpc_message_type>(message.Type);
+                args.message_flags = message.Flags;
+                return true;
+            }
+
+            bool EventStreamRpcClientConnection::CreateConnection(
+                const EventStreamRpcClientConnectionOptions &options,
+                Allocator *allocator) noexcept
+            {
+                ApiHandle::InitializeSubsystem(ApiSubsystem::EventStream);
+
+                if (options.Bootstrap == nullptr || options.HostName.empty() || !options.OnConnectionSetup)
+                {
+                    aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                    return false;
+                }
+
+                auto *callbackData = Crt::New<EventStreamRpcConnectionCallbackData>(allocator, allocator);
+                if (callbackData == nullptr)
+                {
+                    return false;
+                }
+
+                callbackData->onConnectionSetup = options.OnConnectionSetup;
+                callbackData->onProtocolMessage = options.OnProtocolMessage;
+                callbackData->onConnectionShutdown = options.OnConnectionShutdown;
+
+                aws_event_stream_rpc_client_connection_options connectionOptions;
+                AWS_ZERO_STRUCT(connectionOptions);
+                connectionOptions.host_name = options.HostName.c_str();
+                connectionOptions.port = options.Port;
+                connectionOptions.socket_options = &options.SocketOptions.GetImpl();
+                connectionOptions.tls_options =
+                    options.TlsOptions ? options.TlsOptions->GetUnderlyingHandle() : nullptr;
+                connectionOptions.bootstrap = options.Bootstrap->GetUnderlyingHandle();
+                connectionOptions.on_connection_setup = s_onConnectionSetup;
+                connectionOptions.on_connection_protocol_message = s_onProtocolMessage;
+                connectionOptions.on_connection_shutdown = s_onConnectionShutdown;
+                connectionOptions.user_data = callbackData;
+
+                if (aws_event_stream_rpc_client_connection_connect(allocator, &connectionOptions))
+                {
+                    Crt::Delete(callbackData, allocator);
+                    return false;
+                }
+
+                return true;
+            }
+
+            EventStreamRpcClientConnection::EventStreamRpcClientConnection(
+                aws_event_stream_rpc_client_connection *connection,
+                Allocator *allocator) noexcept
+                : m_allocator(allocator), m_connection(connection)
+            {
+            }
+
+            EventStreamRpcClientConnection::~EventStreamRpcClientConnection()
+            {
+                aws_event_stream_rpc_client_connection_close(m_connection, AWS_ERROR_SUCCESS);
+                aws_event_stream_rpc_client_connection_release(m_connection);
+            }
+
+            void EventStreamRpcClientConnection::s_onConnectionSetup(
+                aws_event_stream_rpc_client_connection *connection,
+                int errorCode,
+                void *userData)
+            {
+                auto *callbackData = static_cast<EventStreamRpcConnectionCallbackData *>(userData);
+                Allocator *allocator = callbackData->allocator;
+
+                /* on failure there will be no shutdown callback to clean up after */
+                if (errorCode != AWS_ERROR_SUCCESS)
+                {
+                    callbackData->onConnectionSetup(nullptr, errorCode);
+                    Crt::Delete(callbackData, allocator);
+                    return;
+                }
+
+                /* the reference we are handed here is released by the connection object */
+                auto *toSeat = static_cast<EventStreamRpcClientConnection *>(
+                    aws_mem_acquire(allocator, sizeof(EventStreamRpcClientConnection)));
+                if (toSeat == nullptr)
+                {
+                    aws_event_stream_rpc_client_connection_close(connection, AWS_ERROR_OOM);
+                    aws_event_stream_rpc_client_connection_release(connection);
+                    callbackData->onConnectionSetup(nullptr, AWS_ERROR_OOM);
+                    return;
+                }
+
+                toSeat = new (toSeat) EventStreamRpcClientConnection(connection, allocator);
+                std::shared_ptr<EventStreamRpcClientConnection> rpcConnection(
+                    toSeat, [allocator](EventStreamRpcClientConnection *rpcConnection) {
+                        Crt::Delete(rpcConnection, allocator);
+                    });
+
+                callbackData->connection = rpcConnection;
+                callbackData->onConnectionSetup(rpcConnection, AWS_ERROR_SUCCESS);
+            }
+
+            void EventStreamRpcClientConnection::s_onProtocolMessage(
+                aws_event_stream_rpc_client_connection *,
+                const aws_event_stream_rpc_message_args *message,
+                void *userData)
+            {
+                auto *callbackData = static_cast<EventStreamRpcConnectionCallbackData *>(userData);
+                auto rpcConnection = callbackData->connection.lock();
+                if (rpcConnection && callbackData->onProtocolMessage)
+                {
+                    callbackData->onProtocolMessage(*rpcConnection, EventStreamRpcMessageView(*message));
+                }
+            }
+
+            void EventStreamRpcClientConnection::s_onConnectionShutdown(
+                aws_event_stream_rpc_client_connection *,
+                int errorCode,
+                void *userData)
+            {
+                auto *callbackData = static_cast<EventStreamRpcConnectionCallbackData *>(userData);
+                {
+                    auto rpcConnection = callbackData->connection.lock();
+                    if (rpcConnection && callbackData->onConnectionShutdown)
+                    {
+                        callbackData->onConnectionShutdown(*rpcConnection, errorCode);
+                    }
+                }
+
+                Crt::Delete(callbackData, callbackData->allocator);
+            }
+
+            bool EventStreamRpcClientConnection::IsOpen() const noexcept
+            {
+                return aws_event_stream_rpc_client_connection_is_open(m_connection);
+            }
+
+            void EventStreamRpcClientConnection::Close(int errorCode) noexcept
+            {
+                aws_event_stream_rpc_client_connection_close(m_connection, errorCode);
+            }
+
+            bool EventStreamRpcClientConnection::SendProtocolMessage(
+                const EventStreamRpcMessage &message,
+                OnEventStreamRpcMessageFlushed &&onFlushed) noexcept
+            {
+                ByteBuf payload;
+                aws_event_stream_rpc_message_args args;
+                EventStreamRpcFlushCallbackData *flushData = nullptr;
+                if (!s_prepareSend(message, std::move(onFlushed), m_allocator, payload, args, flushData))
+                {
+                    return false;
+                }
+
+                if (aws_event_stream_rpc_client_connection_send_protocol_message(
+                        m_connection, &args, s_onMessageFlushed, flushData))
+                {
+                    Crt::Delete(flushData, m_allocator);
+                    return false;
+                }
+
+                return true;
+            }
+
+            std::shared_ptr<EventStreamRpcClientContinuation> EventStreamRpcClientConnection::NewStream(
+                OnEventStreamRpcContinuationMessage &&onMessage,
+                OnEventStreamRpcContinuationClosed &&onClosed) noexcept
+            {
+                auto *callbackData = Crt::New<EventStreamRpcContinuationCallbackData>(m_allocator, m_allocator);
+                if (callbackData == nullptr)
+                {
+                    return nullptr;
+                }
+
+                callbackData->onMessage = std::move(onMessage);
+                callbackData->onClosed = std::move(onClosed);
+
+                auto *toSeat = static_cast<EventStreamRpcClientContinuation *>(
+                    aws_mem_acquire(m_allocator, sizeof(EventStreamRpcClientContinuation)));
+                if (toSeat == nullptr)
+                {
+                    s_releaseContinuationCallbackData(callbackData);
+                    return nullptr;
+                }
+
+                toSeat = new (toSeat) EventStreamRpcClientContinuation(shared_from_this(), callbackData, m_allocator);
+                Allocator *allocator = m_allocator;
+                std::shared_ptr<EventStreamRpcClientContinuation> continuation(
+                    toSeat, [allocator](EventStreamRpcClientContinuation *continuation) {
+                        Crt::Delete(continuation, allocator);
+                    });
+                if (continuation->m_token == nullptr)
+                {
+                    return nullptr;
+                }
+
+                callbackData->continuation = continuation;
+                return continuation;
+            }
+
+            EventStreamRpcClientContinuation::EventStreamRpcClientContinuation(
+                const std::shared_ptr<EventStreamRpcClientConnection> &connection,
+                EventStreamRpcContinuationCallbackData *callbackData,
+                Allocator *allocator) noexcept
+                : m_allocator(allocator), m_connection(connection), m_callbackData(callbackData), m_token(nullptr)
+            {
+                aws_event_stream_rpc_client_stream_continuation_options continuationOptions;
+                AWS_ZERO_STRUCT(continuationOptions);
+                continuationOptions.on_continuation = s_onMessage;
+                continuationOptions.on_continuation_closed = s_onClosed;
+                continuationOptions.user_data = callbackData;
+
+                m_token = aws_event_stream_rpc_client_connection_new_stream(
+                    connection->GetUnderlyingHandle(), &continuationOptions);
+            }
+
+            EventStreamRpcClientContinuation::~EventStreamRpcClientContinuation()
+            {
+                if (m_token != nullptr)
+                {
+                    aws_event_stream_rpc_client_continuation_release(m_token);
+                }
+
+                s_releaseContinuationCallbackData(m_callbackData);
+            }
+
+            bool EventStreamRpcClientContinuation::Activate(
+                StringView operationName,
+                const EventStreamRpcMessage &message,
+                OnEventStreamRpcMessageFlushed &&onFlushed) noexcept
+            {
+                ByteBuf payload;
+                aws_event_stream_rpc_message_args args;
+                EventStreamRpcFlushCallbackData *flushData = nullptr;
+                if (!s_prepareSend(message, std::move(onFlushed), m_allocator, payload, args, flushData))
+                {
+                    return false;
+                }
+
+                /* the C side's reference, handed back once the stream is closed */
+                ++m_callbackData->refCount;
+                if (aws_event_stream_rpc_client_continuation_activate(
+                        m_token,
+                        aws_byte_cursor_from_array(operationName.data(), operationName.size()),
+                        &args,
+                        s_onMessageFlushed,
+                        flushData))
+                {
+                    s_releaseContinuationCallbackData(m_callbackData);
+                    Crt::Delete(flushData, m_allocator);
+                    return false;
+                }
+
+                return true;
+            }
+
+            bool EventStreamRpcClientContinuation::SendMessage(
+                const EventStreamRpcMessage &message,
+                OnEventStreamRpcMessageFlushed &&onFlushed) noexcept
+            {
+                ByteBuf payload;
+                aws_event_stream_rpc_message_args args;
+                EventStreamRpcFlushCallbackData *flushData = nullptr;
+                if (!s_prepareSend(message, std::move(onFlushed), m_allocator, payload, args, flushData))
+                {
+                    return false;
+                }
+
+                if (aws_event_stream_rpc_client_continuation_send_message(
+                        m_token, &args, s_onMessageFlushed, flushData))
+                {
+                    Crt::Delete(flushData, m_allocator);
+                    return false;
+                }
+
+                return true;
+            }
+
+            bool EventStreamRpcClientContinuation::IsClosed() const noexcept
+            {
+                return aws_event_stream_rpc_client_continuation_is_closed(m_token);
+            }
+
+            void EventStreamRpcClientContinuation::s_onMessage(
+                aws_event_stream_rpc_client_continuation_token *,
+                const aws_event_stream_rpc_message_args *message,
+                void *userData)
+            {
+                auto *callbackData = static_cast<EventStreamRpcContinuationCallbackData *>(userData);
+                auto continuation = callbackData->continuation.lock();
+                if (continuation && callbackData->onMessage)
+                {
+                    callbackData->onMessage(*continuation, EventStreamRpcMessageView(*message));
+                }
+            }
+
+            void EventStreamRpcClientContinuation::s_onClosed(
+                aws_event_stream_rpc_client_continuation_token *,
+                void *userData)
+            {
+                auto *callbackData = static_cast<EventStreamRpcContinuationCallbackData *>(userData);
+                {
+                    auto continuation = callbackData->continuation.lock();
+                    if (continuation && callbackData->onClosed)
+                    {
+                        callbackData->onClosed(*continuation);
+                    }
+                }
+
+                s_releaseContinuationCallbackData(callbackData);
+            }
+        } // namespace Eventstream
+    }     // namespace Crt
+} // namespace Aws
@@ -2206,7 +2206,7 @@ namespace Aws {
             goto fail;
         }
         /* Copy over all vars */
-        newitem->type = item->type & (~cJSON_IsReference);
+        newitem->type = item->type & (~(cJSON_IsReference | cJSON_StringIsConst));
         newitem->valueint = item->valueint;
         newitem->valuedouble = item->valuedouble;
         if (item->valuestring) {
@@ -2216,8 +2216,8 @@ namespace Aws {
             }
         }
         if (item->string) {
-            newitem->string = (item->type & cJSON_StringIsConst) ? item->string : (char *) cJSON_strdup(
-                (unsigned char *) item->string, &global_hooks);
+            /* a constant key may live in the duplicated item's own allocation, so the copy gets its own */
+            newitem->string = (char *) cJSON_strdup((unsigned char *) item->string, &global_hooks);
             if (!newitem->string) {
                 goto fail;
             }
@@ -0,0 +1,219 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/http/HttpBodyDecoder.h>
+
+#include <aws/http/http.h>
+
+#ifdef AWS_CRT_CPP_USE_ZLIB
+#    include <zlib.h>
+#endif
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Http
+        {
+            class IdentityBodyDecoder final : public HttpBodyDecoder
+            {
+              public:
+                bool Decode(const ByteCursor &input, const OnDecodedBody &onDecoded) noexcept override
+                {
+                    if (input.len > 0 && !onDecoded(input))
+                    {
+                        return aws_raise_error(AWS_ERROR_HTTP_CALLBACK_FAILURE) == AWS_OP_SUCCESS;
+                    }
+
+                    return true;
+                }
+
+                bool IsComplete() const noexcept override { return true; }
+            };
+
+#ifdef AWS_CRT_CPP_USE_ZLIB
+            class ZlibBodyDecoder final : public HttpBodyDecoder
+            {
+              public:
+                ZlibBodyDecoder(HttpContentEncoding encoding, Allocator *allocator) noexcept
+                    : m_allocator(allocator), m_encoding(encoding), m_initialized(false), m_complete(false),
+                      m_sniffedLength(0)
+                {
+                    AWS_ZERO_STRUCT(m_stream);
+                    m_stream.zalloc = s_zlibAlloc;
+                    m_stream.zfree = s_zlibFree;
+                    m_stream.opaque = m_allocator;
+                }
+
+                ~ZlibBodyDecoder()
+                {
+                    if (m_initialized)
+                    {
+                        inflateEnd(&m_stream);
+                    }
+                }
+
+                bool Decode(const ByteCursor &input, const OnDecodedBody &onDecoded) noexcept override
+                {
+                    if (m_initialized)
+                    {
+                        return Inflate(input.ptr, input.len, onDecoded);
+                    }
+
+                    /* 16 + MAX_WBITS asks zlib for the gzip wrapper. Plenty of servers send "deflate" without the
+                     * zlib wrapper it is supposed to have, so look at the first two bytes before picking one. */
+                    int windowBits = 16 + MAX_WBITS;
+                    ByteCursor remaining = input;
+                    if (m_encoding == HttpContentEncoding::Deflate)
+                    {
+                        while (m_sniffedLength < sizeof(m_sniffed) && remaining.len > 0)
+                        {
+                            m_sniffed[m_sniffedLength++] = *remaining.ptr;
+                            aws_byte_cursor_advance(&remaining, 1);
+                        }
+
+                        if (m_sniffedLength < sizeof(m_sniffed))
+                        {
+                            return true;
+                        }
+
+                        bool zlibWrapped =
+                            (m_sniffed[0] & 0x0f) == Z_DEFLATED && ((m_sniffed[0] << 8) | m_sniffed[1]) % 31 == 0;
+                        windowBits = zlibWrapped ? MAX_WBITS : -MAX_WBITS;
+                    }
+
+                    if (inflateInit2(&m_stream, windowBits) != Z_OK)
+                    {
+                        return aws_raise_error(AWS_ERROR_OOM) == AWS_OP_SUCCESS;
+                    }
+                    m_initialized = true;
+
+                    return Inflate(m_sniffed, m_sniffedLength, onDecoded) &&
+                           Inflate(remaining.ptr, remaining.len, onDecoded);
+                }
+
+                bool IsComplete() const noexcept override { return m_complete; }
+
+              private:
+                bool Inflate(const uint8_t *data, size_t length, const OnDecodedBody &onDecoded) noexcept
+                {
+                    m_stream.next_in = const_cast<Bytef *>(data);
+                    m_stream.avail_in = static_cast<uInt>(length);
+
+                    /* keep going while there is input left, or while inflate filled the output buffer and may be
+                     * holding more */
+                    do
+                    {
+                        if (m_complete)
+                        {
+                            if (m_stream.avail_in == 0)
+                            {
+                                break;
+                            }
+
+                            /* a gzip body may be several members back to back */
+                            if (inflateReset(&m_stream) != Z_OK)
+                            {
+                                return aws_raise_error(AWS_ERROR_HTTP_PROTOCOL_ERROR) == AWS_OP_SUCCESS;
+                            }
+                            m_complete = false;
+                        }
+
+                        m_stream.next_out = m_output;
+                        m_stream.avail_out = sizeof(m_output);
+                        int result = inflate(&m_stream, Z_NO_FLUSH);
+                        if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR)
+                        {
+                            return aws_raise_error(AWS_ERROR_HTTP_PROTOCOL_ERROR) == AWS_OP_SUCCESS;
+                        }
+
+                        size_t produced = sizeof(m_output) - m_stream.avail_out;
+                        if (produced > 0 && !onDecoded(aws_byte_cursor_from_array(m_output, produced)))
+                        {
+                            return aws_raise_error(AWS_ERROR_HTTP_CALLBACK_FAILURE) == AWS_OP_SUCCESS;
+                        }
+
+                        m_complete = result == Z_STREAM_END;
+                    } while (m_stream.avail_in > 0 || m_stream.avail_out == 0);
+
+                    return true;
+                }
+
+                static voidpf s_zlibAlloc(voidpf opaque, uInt items, uInt size)
+                {
+                    return aws_mem_calloc(static_cast<Allocator *>(opaque), items, size);
+                }
+
+                static void s_zlibFree(voidpf opaque, voidpf address)
+                {
+                    aws_mem_release(static_cast<Allocator *>(opaque), address);
+                }
+
+                Allocator *m_allocator;
+                HttpContentEncoding m_encoding;
+                bool m_initialized;
+                bool m_complete;
+                uint8_t m_sniffed[2];
+                size_t m_sniffedLength;
+                z_stream m_stream;
+                uint8_t m_output[16 * 1024];
+            };
+#endif // AWS_CRT_CPP_USE_ZLIB
+
+            bool HttpBodyDecoder::ParseContentEncoding(
+                const ByteCursor &value,
+                HttpContentEncoding &outEncoding) noexcept
+            {
+                ByteCursor trimmed = aws_byte_cursor_trim_pred(&value, aws_char_is_space);
+                if (trimmed.len == 0 || aws_byte_cursor_eq_c_str_ignore_case(&trimmed, "identity"))
+                {
+                    outEncoding = HttpContentEncoding::Identity;
+                    return true;
+                }
+
+                if (aws_byte_cursor_eq_c_str_ignore_case(&trimmed, "gzip") ||
+                    aws_byte_cursor_eq_c_str_ignore_case(&trimmed, "x-gzip"))
+                {
+                    outEncoding = HttpContentEncoding::Gzip;
+                    return true;
+                }
+
+                if (aws_byte_cursor_eq_c_str_ignore_case(&trimmed, "deflate"))
+                {
+                    outEncoding = HttpContentEncoding::Deflate;
+                    return true;
+                }
+
+                return false;
+            }
+
+            bool HttpBodyDecoder::IsSupported(HttpContentEncoding encoding) noexcept
+            {
+#ifdef AWS_CRT_CPP_USE_ZLIB
+                (void)encoding;
+                return true;
+#else
+                return encoding == HttpContentEncoding::Identity;
+#endif
+            }
+
+            std::shared_ptr<HttpBodyDecoder> HttpBodyDecoder::NewDecoder(
+                HttpContentEncoding encoding,
+                Allocator *allocator) noexcept
+            {
+                if (encoding == HttpContentEncoding::Identity)
+                {
+                    return MakeShared<IdentityBodyDecoder>(allocator);
+                }
+
+#ifdef AWS_CRT_CPP_USE_ZLIB
+                return MakeShared<ZlibBodyDecoder>(allocator, encoding, allocator);
+#else
+                aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+                return nullptr;
+#endif
+            }
+        } // namespace Http
+    }     // namespace Crt
+} // namespace Aws
@@ -0,0 +1,238 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/http/HttpBodySink.h>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Http
+        {
+            HttpBodySink::HttpBodySink(size_t windowUpdateThreshold) noexcept
+                : m_ownsWindow(false), m_windowUpdateThreshold(windowUpdateThreshold), m_pendingWindowUpdate(0),
+                  m_bufferedBytes(0), m_totalBytes(0)
+            {
+            }
+
+            OnIncomingBody HttpBodySink::GetOnIncomingBody() noexcept
+            {
+                auto self = shared_from_this();
+                return [self](HttpStream &stream, const ByteCursor &data) { self->OnIncomingData(stream, data); };
+            }
+
+            void HttpBodySink::Drained(size_t size) noexcept { ReleaseWindow(size); }
+
+            size_t HttpBodySink::GetBufferedBytes() const noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                return m_bufferedBytes;
+            }
+
+            uint64_t HttpBodySink::GetTotalBytes() const noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                return m_totalBytes;
+            }
+
+            void HttpBodySink::OnIncomingData(HttpStream &stream, const ByteCursor &data) noexcept
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_lock);
+                    if (m_stream.expired())
+                    {
+                        m_stream = stream.shared_from_this();
+                        m_ownsWindow = stream.TakeOverWindow();
+                    }
+
+                    /* count it as buffered up front, the sink may hand it to a consumer that drains it right away */
+                    m_bufferedBytes += data.len;
+                    m_totalBytes += data.len;
+                }
+
+                size_t consumed = OnBodyData(data);
+                ReleaseWindow(consumed < data.len ? consumed : data.len);
+            }
+
+            void HttpBodySink::ReleaseWindow(size_t size) noexcept
+            {
+                std::shared_ptr<HttpStream> stream;
+                size_t increment = 0;
+                {
+                    std::lock_guard<std::mutex> lock(m_lock);
+                    AWS_FATAL_ASSERT(size <= m_bufferedBytes);
+                    m_bufferedBytes -= size;
+                    if (!m_ownsWindow)
+                    {
+                        return;
+                    }
+
+                    m_pendingWindowUpdate += size;
+                    if (m_pendingWindowUpdate == 0 ||
+                        (m_pendingWindowUpdate < m_windowUpdateThreshold && m_bufferedBytes > 0))
+                    {
+                        return;
+                    }
+
+                    stream = m_stream.lock();
+                    increment = m_pendingWindowUpdate;
+                    m_pendingWindowUpdate = 0;
+                }
+
+                if (stream)
+                {
+                    stream->UpdateWindow(increment);
+                }
+            }
+
+            struct BodySinkTaskWrapper
+            {
+                aws_channel_task task{};
+                Allocator *allocator{};
+                std::function<void(Io::TaskStatus)> wrappingFn;
+            };
+
+            static void s_BodySinkTaskCallback(struct aws_channel_task *, void *arg, enum aws_task_status status)
+            {
+                auto *taskWrapper = reinterpret_cast<BodySinkTaskWrapper *>(arg);
+                taskWrapper->wrappingFn(static_cast<Io::TaskStatus>(status));
+                Delete(taskWrapper, taskWrapper->allocator);
+            }
+
+            bool HttpBodySink::ScheduleTask(
+                std::function<void(Io::TaskStatus)> &&task,
+                std::chrono::nanoseconds runIn) noexcept
+            {
+                std::shared_ptr<HttpStream> stream;
+                {
+                    std::lock_guard<std::mutex> lock(m_lock);
+                    stream = m_stream.lock();
+                }
+
+                if (!stream)
+                {
+                    return false;
+                }
+
+                aws_http_connection *connection = aws_http_stream_get_connection(stream->m_stream);
+                aws_channel *channel = aws_http_connection_get_channel(connection);
+                uint64_t currentTimestamp = 0;
+                if (!channel || aws_channel_current_clock_time(channel, &currentTimestamp))
+                {
+                    return false;
+                }
+
+                auto *wrapper = New<BodySinkTaskWrapper>(stream->m_allocator);
+                if (!wrapper)
+                {
+                    return false;
+                }
+
+                wrapper->wrappingFn = std::move(task);
+                wrapper->allocator = stream->m_allocator;
+                aws_channel_task_init(&wrapper->task, s_BodySinkTaskCallback, wrapper, "cpp-crt-http-body-sink-task");
+                aws_channel_schedule_task_future(
+                    channel, &wrapper->task, currentTimestamp + static_cast<uint64_t>(runIn.count()));
+
+                return true;
+            }
+
+            HttpOStreamBodySink::HttpOStreamBodySink(std::ostream &output) noexcept
+                : HttpBodySink(), m_output(output), m_good(true)
+            {
+            }
+
+            size_t HttpOStreamBodySink::OnBodyData(const ByteCursor &data) noexcept
+            {
+                if (m_good)
+                {
+                    m_output.write(reinterpret_cast<const char *>(data.ptr), static_cast<std::streamsize>(data.len));
+                    m_good = static_cast<bool>(m_output);
+                }
+
+                /* a failed write still has to give the window back, or the stream stalls instead of finishing */
+                return data.len;
+            }
+
+            HttpThrottledBodySink::HttpThrottledBodySink(
+                const std::shared_ptr<Io::TokenBucket> &bucket,
+                std::function<void(const ByteCursor &)> &&onData) noexcept
+                : HttpBodySink(), m_bucket(bucket), m_onData(std::move(onData)), m_throttledBytes(0),
+                  m_releaseScheduled(false)
+            {
+            }
+
+            size_t HttpThrottledBodySink::GetThrottledBytes() const noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_throttleLock);
+                return m_throttledBytes;
+            }
+
+            size_t HttpThrottledBodySink::OnBodyData(const ByteCursor &data) noexcept
+            {
+                if (m_onData)
+                {
+                    m_onData(data);
+                }
+
+                size_t granted = m_bucket->TryAcquire(data.len);
+                bool scheduleRelease = false;
+                {
+                    std::lock_guard<std::mutex> lock(m_throttleLock);
+                    m_throttledBytes += data.len - granted;
+                    scheduleRelease = m_throttledBytes > 0 && !m_releaseScheduled;
+                    m_releaseScheduled = m_releaseScheduled || scheduleRelease;
+                }
+
+                if (scheduleRelease)
+                {
+                    ScheduleRelease();
+                }
+
+                return granted;
+            }
+
+            void HttpThrottledBodySink::ScheduleRelease() noexcept
+            {
+                size_t throttledBytes = GetThrottledBytes();
+                std::chrono::nanoseconds delay(m_bucket->GetDelayNs(throttledBytes));
+
+                auto self = std::static_pointer_cast<HttpThrottledBodySink>(shared_from_this());
+                if (!ScheduleTask([self](Io::TaskStatus status) { self->OnReleaseTask(status); }, delay))
+                {
+                    /* nothing left to reopen the window of */
+                    std::lock_guard<std::mutex> lock(m_throttleLock);
+                    m_releaseScheduled = false;
+                }
+            }
+
+            void HttpThrottledBodySink::OnReleaseTask(Io::TaskStatus status) noexcept
+            {
+                size_t granted = 0;
+                bool scheduleRelease = false;
+                {
+                    std::lock_guard<std::mutex> lock(m_throttleLock);
+                    if (status == Io::TaskStatus::RunReady)
+                    {
+                        granted = m_bucket->TryAcquire(m_throttledBytes);
+                        m_throttledBytes -= granted;
+                    }
+
+                    scheduleRelease = status == Io::TaskStatus::RunReady && m_throttledBytes > 0;
+                    m_releaseScheduled = scheduleRelease;
+                }
+
+                if (granted > 0)
+                {
+                    Drained(granted);
+                }
+
+                if (scheduleRelease)
+                {
+                    ScheduleRelease();
+                }
+            }
+        } // namespace Http
+    }     // namespace Crt
+} // namespace Aws
@@ -0,0 +1,259 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/http/HttpClientConnectionPool.h>
+
+#include <aws/http/http.h>
+#include <aws/io/tls_channel_handler.h>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Http
+        {
+            HttpClientConnectionPoolOptions::HttpClientConnectionPoolOptions() noexcept
+                : ConnectionOptions(), MaxConnections(64), MaxConnectionsPerHost(8),
+                  MaxConnectionIdleInMilliseconds(0), EnableBlockingShutdown(false)
+            {
+            }
+
+            bool HttpClientConnectionPool::EndpointKey::operator<(const EndpointKey &other) const noexcept
+            {
+                if (port != other.port)
+                {
+                    return port < other.port;
+                }
+
+                if (tlsContext != other.tlsContext)
+                {
+                    return std::less<const void *>()(tlsContext, other.tlsContext);
+                }
+
+                if (hostName != other.hostName)
+                {
+                    return hostName < other.hostName;
+                }
+
+                if (serverName != other.serverName)
+                {
+                    return serverName < other.serverName;
+                }
+
+                return alpnList < other.alpnList;
+            }
+
+            std::shared_ptr<HttpClientConnectionPool> HttpClientConnectionPool::NewClientConnectionPool(
+                const HttpClientConnectionPoolOptions &options,
+                Allocator *allocator) noexcept
+            {
+                auto *toSeat = static_cast<HttpClientConnectionPool *>(
+                    aws_mem_acquire(allocator, sizeof(HttpClientConnectionPool)));
+                if (toSeat)
+                {
+                    toSeat = new (toSeat) HttpClientConnectionPool(options, allocator);
+                    return std::shared_ptr<HttpClientConnectionPool>(
+                        toSeat, [allocator](HttpClientConnectionPool *pool) { Delete(pool, allocator); });
+                }
+
+                return nullptr;
+            }
+
+            HttpClientConnectionPool::HttpClientConnectionPool(
+                const HttpClientConnectionPoolOptions &options,
+                Allocator *allocator) noexcept
+                : m_allocator(allocator), m_options(options), m_leasedConnections(0), m_shutdown(false)
+            {
+                AWS_FATAL_ASSERT(m_options.MaxConnections > 0);
+                AWS_FATAL_ASSERT(m_options.MaxConnectionsPerHost > 0);
+            }
+
+            bool HttpClientConnectionPool::AcquireConnection(
+                const String &hostName,
+                uint16_t port,
+                const Optional<Io::TlsConnectionOptions> &tlsOptions,
+                const OnClientConnectionAvailable &onClientConnectionAvailable) noexcept
+            {
+                std::shared_ptr<HttpClientConnectionManager> manager;
+                {
+                    std::lock_guard<std::mutex> lock(m_lock);
+                    if (m_shutdown)
+                    {
+                        aws_raise_error(AWS_ERROR_HTTP_CONNECTION_MANAGER_SHUTTING_DOWN);
+                        return false;
+                    }
+
+                    manager = GetOrCreateManager(hostName, port, tlsOptions);
+                    if (!manager)
+                    {
+                        return false;
+                    }
+
+                    if (m_leasedConnections >= m_options.MaxConnections)
+                    {
+                        m_queue.push_back({std::move(manager), onClientConnectionAvailable});
+                        return true;
+                    }
+
+                    ++m_leasedConnections;
+                }
+
+                if (!Dispatch(manager, onClientConnectionAvailable))
+                {
+                    int lastError = aws_last_error();
+                    ReleaseSlot();
+                    aws_raise_error(lastError);
+                    return false;
+                }
+
+                return true;
+            }
+
+            size_t HttpClientConnectionPool::GetLeasedConnectionCount() const noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                return m_leasedConnections;
+            }
+
+            size_t HttpClientConnectionPool::GetQueuedAcquisitionCount() const noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                return m_queue.size();
+            }
+
+            std::future<void> HttpClientConnectionPool::InitiateShutdown() noexcept
+            {
+                List<QueuedAcquisition> abandoned;
+                Vector<std::future<void>> shutdownFutures;
+                {
+                    std::lock_guard<std::mutex> lock(m_lock);
+                    m_shutdown = true;
+                    abandoned.swap(m_queue);
+                    shutdownFutures.reserve(m_managers.size());
+                    for (auto &entry : m_managers)
+                    {
+                        shutdownFutures.push_back(entry.second->InitiateShutdown());
+                    }
+                    m_managers.clear();
+                }
+
+                /* queued acquisitions never took a slot, so there is nothing to give back for them */
+                for (auto &queued : abandoned)
+                {
+                    queued.onClientConnectionAvailable(nullptr, AWS_ERROR_HTTP_CONNECTION_MANAGER_SHUTTING_DOWN);
+                }
+
+                return std::async(
+                    std::launch::deferred,
+                    [](Vector<std::future<void>> futures) {
+                        for (auto &future : futures)
+                        {
+                            future.get();
+                        }
+                    },
+                    std::move(shutdownFutures));
+            }
+
+            std::shared_ptr<HttpClientConnectionManager> HttpClientConnectionPool::GetOrCreateManager(
+                const String &hostName,
+                uint16_t port,
+                const Optional<Io::TlsConnectionOptions> &tlsOptions) noexcept
+            {
+                EndpointKey key;
+                key.hostName = hostName;
+                key.port = port;
+                key.tlsContext = nullptr;
+                if (tlsOptions)
+                {
+                    const aws_tls_connection_options *tlsHandle = tlsOptions->GetUnderlyingHandle();
+                    key.tlsContext = tlsHandle->ctx;
+                    if (tlsHandle->server_name != nullptr)
+                    {
+                        key.serverName.assign(aws_string_c_str(tlsHandle->server_name), tlsHandle->server_name->len);
+                    }
+                    if (tlsHandle->alpn_list != nullptr)
+                    {
+                        key.alpnList.assign(aws_string_c_str(tlsHandle->alpn_list), tlsHandle->alpn_list->len);
+                    }
+                }
+
+                auto found = m_managers.find(key);
+                if (found != m_managers.end())
+                {
+                    return found->second;
+                }
+
+                HttpClientConnectionManagerOptions managerOptions;
+                managerOptions.ConnectionOptions = m_options.ConnectionOptions;
+                managerOptions.ConnectionOptions.HostName = hostName;
+                managerOptions.ConnectionOptions.Port = port;
+                managerOptions.ConnectionOptions.TlsOptions = tlsOptions;
+                managerOptions.MaxConnections = m_options.MaxConnectionsPerHost;
+                managerOptions.EnableBlockingShutdown = m_options.EnableBlockingShutdown;
+                managerOptions.MaxConnectionIdleInMilliseconds = m_options.MaxConnectionIdleInMilliseconds;
+
+                auto manager = HttpClientConnectionManager::NewClientConnectionManager(managerOptions, m_allocator);
+                if (manager)
+                {
+                    m_managers.emplace(std::move(key), manager);
+                }
+
+                return manager;
+            }
+
+            bool HttpClientConnectionPool::Dispatch(
+                const std::shared_ptr<HttpClientConnectionManager> &manager,
+                const OnClientConnectionAvailable &onClientConnectionAvailable) noexcept
+            {
+                auto self = shared_from_this();
+                auto onAcquired = [self, onClientConnectionAvailable](
+                                      std::shared_ptr<HttpClientConnection> connection, int errorCode) {
+                    if (errorCode || !connection)
+                    {
+                        self->ReleaseSlot();
+                        onClientConnectionAvailable(nullptr, errorCode ? errorCode : AWS_ERROR_UNKNOWN);
+                        return;
+                    }
+
+                    onClientConnectionAvailable(std::move(connection), AWS_OP_SUCCESS);
+                };
+
+                /*
+                 * Streams hold the connection as well as the caller, so the slot is only given back once the
+                 * connection itself has gone back to its manager.
+                 */
+                auto onReleased = [self]() { self->ReleaseSlot(); };
+
+                return manager->AcquireConnection(onAcquired, onReleased);
+            }
+
+            void HttpClientConnectionPool::ReleaseSlot() noexcept
+            {
+                /* hand the slot straight to the oldest queued acquisition if there is one */
+                while (true)
+                {
+                    QueuedAcquisition next;
+                    {
+                        std::lock_guard<std::mutex> lock(m_lock);
+                        if (m_shutdown || m_queue.empty())
+                        {
+                            --m_leasedConnections;
+                            return;
+                        }
+
+                        next = std::move(m_queue.front());
+                        m_queue.pop_front();
+                    }
+
+                    if (Dispatch(next.manager, next.onClientConnectionAvailable))
+                    {
+                        return;
+                    }
+
+                    next.onClientConnectionAvailable(nullptr, aws_last_error());
+                }
+            }
+        } // namespace Http
+    }     // namespace Crt
+} // namespace Aws
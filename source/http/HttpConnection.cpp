@@ -2,10 +2,18 @@
  * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
  * SPDX-License-Identifier: Apache-2.0.
  */
+#include <aws/crt/Api.h>
+#include <aws/crt/EventTracer.h>
 #include <aws/crt/http/HttpConnection.h>
 #include <aws/crt/http/HttpProxyStrategy.h>
 #include <aws/crt/http/HttpRequestResponse.h>
 #include <aws/crt/io/Bootstrap.h>
+#include <aws/crt/io/HostAddressSelector.h>
+
+#include <aws/common/clock.h>
+#include <aws/common/string.h>
+
+#include <mutex>
 
 namespace Aws
 {
@@ -17,9 +25,16 @@ namespace Aws
              * HttpClientConnection has been destroyed. */
             struct ConnectionCallbackData
             {
-                explicit ConnectionCallbackData(Allocator *allocator) : allocator(allocator) {}
+                explicit ConnectionCallbackData(Allocator *allocator)
+                    : allocator(allocator), startTimestampNs(0), manualWindowManagement(false)
+                {
+                }
                 std::weak_ptr<HttpClientConnection> connection;
                 Allocator *allocator;
+                uint64_t startTimestampNs;
+                std::shared_ptr<Io::ReadWindowTuner> readWindowTuner;
+                bool manualWindowManagement;
+                Io::SocketOptions socketOptions;
                 OnConnectionSetup onConnectionSetup;
                 OnConnectionShutdown onConnectionShutdown;
             };
@@ -42,6 +57,145 @@ namespace Aws
                 }
             };
 
+            class UnmanagedHttp2Connection final : public Http2ClientConnection
+            {
+              public:
+                UnmanagedHttp2Connection(aws_http_connection *connection, Aws::Crt::Allocator *allocator)
+                    : Http2ClientConnection(connection, allocator)
+                {
+                }
+
+                ~UnmanagedHttp2Connection() override
+                {
+                    if (m_connection)
+                    {
+                        aws_http_connection_release(m_connection);
+                        m_connection = nullptr;
+                    }
+                }
+            };
+
+            /*
+             * Free list of the blocks behind HttpClientStream objects and their shared_ptr control blocks, so a
+             * connection issuing a steady stream of requests stops going to the allocator for them. Streams hold a
+             * reference, so the pool outlives the connection if a stream does. Streams may be released from any
+             * thread, hence the lock.
+             */
+            struct HttpStreamPool
+            {
+                static const size_t BlockSize = sizeof(HttpClientStream);
+                static const size_t MaxPooledBlocks = 64;
+
+                struct FreeBlock
+                {
+                    FreeBlock *next;
+                };
+
+                explicit HttpStreamPool(Allocator *allocator) noexcept
+                    : allocator(allocator), freeBlocks(nullptr), freeCount(0)
+                {
+                }
+
+                ~HttpStreamPool()
+                {
+                    while (freeBlocks != nullptr)
+                    {
+                        FreeBlock *block = freeBlocks;
+                        freeBlocks = block->next;
+                        aws_mem_release(allocator, block);
+                    }
+                }
+
+                void *Acquire(size_t size) noexcept
+                {
+                    if (size > BlockSize)
+                    {
+                        return aws_mem_acquire(allocator, size);
+                    }
+
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (freeBlocks != nullptr)
+                        {
+                            FreeBlock *block = freeBlocks;
+                            freeBlocks = block->next;
+                            --freeCount;
+                            return block;
+                        }
+                    }
+
+                    return aws_mem_acquire(allocator, BlockSize);
+                }
+
+                void Release(void *mem, size_t size) noexcept
+                {
+                    if (size <= BlockSize)
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (freeCount < MaxPooledBlocks)
+                        {
+                            auto *block = static_cast<FreeBlock *>(mem);
+                            block->next = freeBlocks;
+                            freeBlocks = block;
+                            ++freeCount;
+                            return;
+                        }
+                    }
+
+                    aws_mem_release(allocator, mem);
+                }
+
+                Allocator *allocator;
+                std::mutex mutex;
+                FreeBlock *freeBlocks;
+                size_t freeCount;
+            };
+
+            const size_t HttpStreamPool::BlockSize;
+            const size_t HttpStreamPool::MaxPooledBlocks;
+
+            /* Serves the stream's shared_ptr control block out of the connection's HttpStreamPool. */
+            template <typename T> class HttpStreamPoolAllocator
+            {
+              public:
+                using value_type = T;
+
+                explicit HttpStreamPoolAllocator(const std::shared_ptr<HttpStreamPool> &pool) noexcept : m_pool(pool) {}
+
+                template <typename U>
+                HttpStreamPoolAllocator(const HttpStreamPoolAllocator<U> &other) noexcept : m_pool(other.m_pool)
+                {
+                }
+
+                T *allocate(size_t n) { return static_cast<T *>(m_pool->Acquire(n * sizeof(T))); }
+
+                void deallocate(T *p, size_t n) { m_pool->Release(p, n * sizeof(T)); }
+
+                std::shared_ptr<HttpStreamPool> m_pool;
+            };
+
+            template <typename T, typename U>
+            bool operator==(const HttpStreamPoolAllocator<T> &lhs, const HttpStreamPoolAllocator<U> &rhs) noexcept
+            {
+                return lhs.m_pool == rhs.m_pool;
+            }
+
+            template <typename T, typename U>
+            bool operator!=(const HttpStreamPoolAllocator<T> &lhs, const HttpStreamPoolAllocator<U> &rhs) noexcept
+            {
+                return !(lhs == rhs);
+            }
+
+            /* Outlives the Http2ClientConnection if the connection shuts down with a SETTINGS or PING outstanding. */
+            struct Http2ConnectionCallbackData
+            {
+                explicit Http2ConnectionCallbackData(Allocator *allocator) : allocator(allocator) {}
+                std::weak_ptr<HttpClientConnection> connection;
+                Allocator *allocator;
+                OnHttp2SettingsChangeComplete onSettingsChangeComplete;
+                OnHttp2PingComplete onPingComplete;
+            };
+
             void HttpClientConnection::s_onClientConnectionSetup(
                 struct aws_http_connection *connection,
                 int errorCode,
@@ -51,13 +205,40 @@ namespace Aws
                  * Allocate an HttpClientConnection and seat it to `ConnectionCallbackData`'s shared_ptr.
                  */
                 auto *callbackData = static_cast<ConnectionCallbackData *>(user_data);
+                EventTracer::Record(TraceEventType::ConnectionSetup, TraceEventPhase::End, callbackData, errorCode);
                 if (!errorCode)
                 {
-                    auto connectionObj = std::allocate_shared<UnmanagedConnection>(
-                        Aws::Crt::StlAllocator<UnmanagedConnection>(), connection, callbackData->allocator);
+                    std::shared_ptr<HttpClientConnection> connectionObj;
+                    if (aws_http_connection_get_version(connection) == AWS_HTTP_VERSION_2)
+                    {
+                        connectionObj = std::allocate_shared<UnmanagedHttp2Connection>(
+                            Aws::Crt::StlAllocator<UnmanagedHttp2Connection>(), connection, callbackData->allocator);
+                    }
+                    else
+                    {
+                        connectionObj = std::allocate_shared<UnmanagedConnection>(
+                            Aws::Crt::StlAllocator<UnmanagedConnection>(), connection, callbackData->allocator);
+                    }
 
                     if (connectionObj)
                     {
+                        /* best effort, the connection is usable with default socket settings too */
+                        callbackData->socketOptions.ApplyTuning(aws_http_connection_get_channel(connection));
+
+                        uint64_t now = 0;
+                        aws_high_res_clock_get_ticks(&now);
+                        connectionObj->m_setupDurationNs =
+                            now > callbackData->startTimestampNs ? now - callbackData->startTimestampNs : 0;
+                        /* one tuner per connection can't size HTTP/2's per-stream windows: withholding from one
+                         * stream's updates to shrink the connection's window could starve that stream */
+                        if (aws_http_connection_get_version(connection) == AWS_HTTP_VERSION_1_1)
+                        {
+                            connectionObj->m_readWindowTuner = callbackData->readWindowTuner;
+                        }
+                        connectionObj->m_manualWindowManagement = callbackData->manualWindowManagement;
+                        connectionObj->m_releasesWindow =
+                            callbackData->readWindowTuner && !callbackData->manualWindowManagement;
+
                         callbackData->connection = connectionObj;
                         callbackData->onConnectionSetup(std::move(connectionObj), errorCode);
                         return;
@@ -78,6 +259,8 @@ namespace Aws
             {
                 (void)connection;
                 auto *callbackData = static_cast<ConnectionCallbackData *>(user_data);
+                EventTracer::Record(
+                    TraceEventType::ConnectionShutdown, TraceEventPhase::Instant, callbackData, errorCode);
 
                 /* Don't invoke callback if the connection object has expired. */
                 if (auto connectionPtr = callbackData->connection.lock())
@@ -88,10 +271,21 @@ namespace Aws
                 Delete(callbackData, callbackData->allocator);
             }
 
+            static void s_onTlsNegotiated(
+                struct aws_channel_handler *,
+                struct aws_channel_slot *,
+                int errorCode,
+                void *userData) noexcept
+            {
+                EventTracer::Record(TraceEventType::TlsNegotiated, TraceEventPhase::Instant, userData, errorCode);
+            }
+
             bool HttpClientConnection::CreateConnection(
                 const HttpClientConnectionOptions &connectionOptions,
                 Allocator *allocator) noexcept
             {
+                ApiHandle::InitializeSubsystem(ApiSubsystem::Http);
+
                 AWS_FATAL_ASSERT(connectionOptions.OnConnectionSetupCallback);
                 AWS_FATAL_ASSERT(connectionOptions.OnConnectionShutdownCallback);
 
@@ -122,6 +316,22 @@ namespace Aws
                 options.on_setup = HttpClientConnection::s_onClientConnectionSetup;
                 options.on_shutdown = HttpClientConnection::s_onClientConnectionShutdown;
                 options.manual_window_management = connectionOptions.ManualWindowManagement;
+                callbackData->manualWindowManagement = connectionOptions.ManualWindowManagement;
+                callbackData->socketOptions = connectionOptions.SocketOptions;
+                if (connectionOptions.AdaptiveReadWindow)
+                {
+                    callbackData->readWindowTuner =
+                        MakeShared<Io::ReadWindowTuner>(allocator, connectionOptions.AdaptiveReadWindow.value());
+                    if (!callbackData->readWindowTuner)
+                    {
+                        Delete(callbackData, allocator);
+                        return false;
+                    }
+
+                    /* the tuner decides what is handed back, so the connection must not do it on its own */
+                    options.initial_window_size = callbackData->readWindowTuner->GetWindowSize();
+                    options.manual_window_management = true;
+                }
 
                 aws_http_proxy_options proxyOptions;
                 AWS_ZERO_STRUCT(proxyOptions);
@@ -133,18 +343,266 @@ namespace Aws
                     options.proxy_options = &proxyOptions;
                 }
 
-                if (aws_http_client_connect(&options))
+                aws_http2_connection_options http2Options;
+                AWS_ZERO_STRUCT(http2Options);
+                if (!connectionOptions.Http2InitialSettings.empty())
                 {
+                    http2Options.initial_settings_array =
+                        const_cast<Http2Setting *>(connectionOptions.Http2InitialSettings.data());
+                    http2Options.num_initial_settings = connectionOptions.Http2InitialSettings.size();
+
+                    options.http2_options = &http2Options;
+                }
+
+                /*
+                 * TLS completion is only reported through the negotiation callback, so while tracing, connections
+                 * whose TLS options carry no callbacks of their own get one.
+                 */
+                aws_tls_connection_options tracedTlsOptions;
+                AWS_ZERO_STRUCT(tracedTlsOptions);
+                bool traceTls = false;
+                if (options.tls_options != nullptr && EventTracer::GetActive() != nullptr &&
+                    options.tls_options->on_negotiation_result == nullptr &&
+                    options.tls_options->on_data_read == nullptr && options.tls_options->on_error == nullptr &&
+                    aws_tls_connection_options_copy(&tracedTlsOptions, options.tls_options) == AWS_OP_SUCCESS)
+                {
+                    tracedTlsOptions.on_negotiation_result = s_onTlsNegotiated;
+                    tracedTlsOptions.user_data = callbackData;
+                    options.tls_options = &tracedTlsOptions;
+                    traceTls = true;
+                }
+
+                aws_high_res_clock_get_ticks(&callbackData->startTimestampNs);
+                EventTracer::Record(TraceEventType::ConnectionSetup, TraceEventPhase::Begin, callbackData);
+                int connectResult = aws_http_client_connect(&options);
+                int errorCode = connectResult == AWS_OP_SUCCESS ? AWS_ERROR_SUCCESS : aws_last_error();
+
+                /* aws_http_client_connect() keeps a copy of the TLS options */
+                if (traceTls)
+                {
+                    aws_tls_connection_options_clean_up(&tracedTlsOptions);
+                }
+
+                if (connectResult != AWS_OP_SUCCESS)
+                {
+                    EventTracer::Record(TraceEventType::ConnectionSetup, TraceEventPhase::End, callbackData, errorCode);
                     Delete(callbackData, allocator);
+                    aws_raise_error(errorCode);
                     return false;
                 }
 
                 return true;
             }
 
+            /* Shared by the attempts of one CreateConnectionToAddresses() call. */
+            struct ConnectionRace
+            {
+                ConnectionRace() = default;
+                ConnectionRace(const ConnectionRace &) = delete;
+                ConnectionRace &operator=(const ConnectionRace &) = delete;
+
+                ~ConnectionRace()
+                {
+                    for (auto &candidate : candidates)
+                    {
+                        aws_host_address_clean_up(&candidate);
+                    }
+                }
+
+                /* owned copies, the resolver frees the addresses it hands out once its callback returns */
+                Vector<Io::HostAddress> candidates;
+                std::mutex lock;
+                size_t remaining = 0;
+                bool starting = true;
+                bool won = false;
+                int lastError = AWS_ERROR_SUCCESS;
+                const HttpClientConnection *winner = nullptr;
+                std::shared_ptr<Io::HostAddressSelector> selector;
+                OnConnectionSetup onConnectionSetup;
+                OnConnectionShutdown onConnectionShutdown;
+            };
+
+            /* called with race->lock held, once an attempt is over; true if the race was lost by every attempt */
+            static bool s_isRaceLost(ConnectionRace &race) noexcept
+            {
+                return --race.remaining == 0 && !race.starting && !race.won;
+            }
+
+            bool HttpClientConnection::CreateConnectionToAddresses(
+                const HttpClientConnectionOptions &connectionOptions,
+                const Vector<Io::HostAddress> &addresses,
+                const std::shared_ptr<Io::HostAddressSelector> &selector,
+                Allocator *allocator) noexcept
+            {
+                AWS_FATAL_ASSERT(connectionOptions.OnConnectionSetupCallback);
+                AWS_FATAL_ASSERT(connectionOptions.OnConnectionShutdownCallback);
+
+                if (!selector || connectionOptions.ProxyOptions)
+                {
+                    aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                    return false;
+                }
+
+                auto race = MakeShared<ConnectionRace>(allocator);
+                if (!race)
+                {
+                    return false;
+                }
+
+                /* the best address of each family */
+                Vector<Io::HostAddress> &candidates = race->candidates;
+                candidates.reserve(2);
+                for (const auto &address : selector->Order(addresses))
+                {
+                    if (address.address != nullptr &&
+                        (candidates.empty() || candidates[0].record_type != address.record_type))
+                    {
+                        Io::HostAddress candidate = address;
+                        candidate.allocator = allocator;
+                        candidate.address = aws_string_new_from_string(allocator, address.address);
+                        candidate.host =
+                            address.host != nullptr ? aws_string_new_from_string(allocator, address.host) : nullptr;
+                        if (candidate.address == nullptr || (address.host != nullptr && candidate.host == nullptr))
+                        {
+                            aws_host_address_clean_up(&candidate);
+                            return false;
+                        }
+                        candidates.push_back(candidate);
+                    }
+                    if (candidates.size() == 2)
+                    {
+                        break;
+                    }
+                }
+                if (candidates.empty())
+                {
+                    aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                    return false;
+                }
+
+                race->remaining = candidates.size();
+                race->selector = selector;
+                race->onConnectionSetup = connectionOptions.OnConnectionSetupCallback;
+                race->onConnectionShutdown = connectionOptions.OnConnectionShutdownCallback;
+
+                size_t started = 0;
+                for (size_t candidateIndex = 0; candidateIndex < candidates.size(); ++candidateIndex)
+                {
+                    const Io::HostAddress &candidate = candidates[candidateIndex];
+                    HttpClientConnectionOptions attemptOptions = connectionOptions;
+                    attemptOptions.HostName = String(aws_string_c_str(candidate.address), candidate.address->len);
+                    if (attemptOptions.TlsOptions)
+                    {
+                        ByteCursor serverName = ByteCursorFromString(connectionOptions.HostName);
+                        attemptOptions.TlsOptions->SetServerName(serverName);
+                    }
+
+                    uint64_t startNs = 0;
+                    aws_high_res_clock_get_ticks(&startNs);
+                    auto onAttemptSetup = [race, candidateIndex, startNs](
+                                              const std::shared_ptr<HttpClientConnection> &connection, int errorCode) {
+                        const Io::HostAddress &candidate = race->candidates[candidateIndex];
+                        uint64_t nowNs = 0;
+                        aws_high_res_clock_get_ticks(&nowNs);
+                        if (errorCode)
+                        {
+                            race->selector->RecordConnectFailure(candidate);
+                        }
+                        else
+                        {
+                            race->selector->RecordConnectSuccess(candidate, std::chrono::nanoseconds(nowNs - startNs));
+                        }
+
+                        bool won = false;
+                        bool lost = false;
+                        {
+                            std::lock_guard<std::mutex> lock(race->lock);
+                            if (!errorCode && !race->won)
+                            {
+                                race->won = true;
+                                race->winner = connection.get();
+                                won = true;
+                            }
+                            if (errorCode)
+                            {
+                                race->lastError = errorCode;
+                            }
+                            lost = s_isRaceLost(*race);
+                        }
+
+                        if (won)
+                        {
+                            race->onConnectionSetup(connection, AWS_ERROR_SUCCESS);
+                        }
+                        else if (!errorCode)
+                        {
+                            connection->Close();
+                        }
+                        else if (lost)
+                        {
+                            race->onConnectionSetup(nullptr, race->lastError);
+                        }
+                    };
+                    attemptOptions.OnConnectionSetupCallback = onAttemptSetup;
+                    attemptOptions.OnConnectionShutdownCallback = [race](
+                                                                      HttpClientConnection &connection, int errorCode) {
+                        bool isWinner = false;
+                        {
+                            std::lock_guard<std::mutex> lock(race->lock);
+                            isWinner = race->winner == &connection;
+                        }
+                        if (isWinner)
+                        {
+                            race->onConnectionShutdown(connection, errorCode);
+                        }
+                    };
+
+                    if (CreateConnection(attemptOptions, allocator))
+                    {
+                        ++started;
+                        continue;
+                    }
+
+                    std::lock_guard<std::mutex> lock(race->lock);
+                    race->lastError = aws_last_error();
+                    --race->remaining;
+                }
+
+                if (started == 0)
+                {
+                    aws_raise_error(race->lastError);
+                    return false;
+                }
+
+                /* attempts that failed while the others were still being started report it now */
+                bool lost = false;
+                {
+                    std::lock_guard<std::mutex> lock(race->lock);
+                    race->starting = false;
+                    lost = race->remaining == 0 && !race->won;
+                }
+                if (lost)
+                {
+                    race->onConnectionSetup(nullptr, race->lastError);
+                }
+
+                return true;
+            }
+
             HttpClientConnection::HttpClientConnection(aws_http_connection *connection, Allocator *allocator) noexcept
-                : m_connection(connection), m_allocator(allocator), m_lastError(AWS_ERROR_SUCCESS)
+                : m_connection(connection), m_allocator(allocator), m_lastError(AWS_ERROR_SUCCESS),
+                  m_streamPool(
+                      std::allocate_shared<HttpStreamPool>(StlAllocator<HttpStreamPool>(allocator), allocator)),
+                  m_setupDurationNs(0), m_manualWindowManagement(false), m_releasesWindow(false), m_completedStreams(0),
+                  m_failedStreams(0)
             {
+                for (size_t i = 0; i < HttpClientConnectionStreamMetrics::LatencyBucketCount; ++i)
+                {
+                    m_timeToFirstByteHistogram[i].store(0);
+                    m_headerDurationHistogram[i].store(0);
+                    m_bodyDurationHistogram[i].store(0);
+                    m_totalDurationHistogram[i].store(0);
+                }
             }
 
             std::shared_ptr<HttpClientStream> HttpClientConnection::NewClientStream(
@@ -163,23 +621,37 @@ namespace Aws
                 options.on_complete = HttpStream::s_onStreamComplete;
 
                 /* Do the same ref counting trick we did with HttpClientConnection. We need to maintain a reference
-                 * internally (regardless of what the user does), until the Stream shuts down. */
-                auto *toSeat = static_cast<HttpClientStream *>(aws_mem_acquire(m_allocator, sizeof(HttpClientStream)));
+                 * internally (regardless of what the user does), until the Stream shuts down.
+                 * Both the stream and its control block come from the connection's pool, and go back to it once the
+                 * last reference is dropped. */
+                std::shared_ptr<HttpStreamPool> pool = m_streamPool;
+                auto *toSeat = static_cast<HttpClientStream *>(pool->Acquire(sizeof(HttpClientStream)));
 
                 if (toSeat)
                 {
                     toSeat = new (toSeat) HttpClientStream(this->shared_from_this());
 
-                    Allocator *captureAllocator = m_allocator;
                     std::shared_ptr<HttpClientStream> stream(
                         toSeat,
-                        [captureAllocator](HttpStream *stream) { Delete(stream, captureAllocator); },
-                        StlAllocator<HttpClientStream>(captureAllocator));
+                        [pool](HttpClientStream *stream) {
+                            stream->~HttpClientStream();
+                            pool->Release(stream, sizeof(HttpClientStream));
+                        },
+                        HttpStreamPoolAllocator<HttpClientStream>(pool));
 
                     stream->m_onIncomingBody = requestOptions.onIncomingBody;
                     stream->m_onIncomingHeaders = requestOptions.onIncomingHeaders;
                     stream->m_onIncomingHeadersBlockDone = requestOptions.onIncomingHeadersBlockDone;
                     stream->m_onStreamComplete = requestOptions.onStreamComplete;
+                    stream->m_responseBody = requestOptions.responseBody;
+                    stream->m_responseBodyPreallocationLimit = requestOptions.responseBodyPreallocationLimit;
+                    stream->m_decodeResponseBody = requestOptions.decodeResponseBody;
+                    stream->m_recordTimings = requestOptions.recordTimings;
+                    if (stream->m_recordTimings)
+                    {
+                        aws_high_res_clock_get_ticks(&stream->m_timings.CreatedTimestampNs);
+                    }
+                    stream->m_allocator = m_allocator;
                     stream->m_callbackData.allocator = m_allocator;
 
                     // we purposefully do not set m_callbackData::stream because we don't want the reference count
@@ -211,6 +683,252 @@ namespace Aws
                 return (HttpVersion)aws_http_connection_get_version(m_connection);
             }
 
+            bool HttpClientConnection::SetStatisticsCallback(
+                std::chrono::milliseconds reportInterval,
+                Io::OnChannelStatistics &&callback) noexcept
+            {
+                if (!Io::SetChannelStatisticsCallback(
+                        aws_http_connection_get_channel(m_connection),
+                        reportInterval,
+                        std::move(callback),
+                        m_allocator))
+                {
+                    m_lastError = aws_last_error();
+                    return false;
+                }
+
+                return true;
+            }
+
+            const size_t HttpClientConnectionStreamMetrics::LatencyBucketCount;
+
+            HttpClientConnectionStreamMetrics::HttpClientConnectionStreamMetrics() noexcept
+                : ConnectionSetupDurationNs(0), CompletedStreams(0), FailedStreams(0)
+            {
+                AWS_ZERO_ARRAY(TimeToFirstByteHistogram);
+                AWS_ZERO_ARRAY(HeaderDurationHistogram);
+                AWS_ZERO_ARRAY(BodyDurationHistogram);
+                AWS_ZERO_ARRAY(TotalDurationHistogram);
+            }
+
+            HttpClientConnectionStreamMetrics HttpClientConnection::GetStreamMetrics() const noexcept
+            {
+                HttpClientConnectionStreamMetrics metrics;
+                metrics.ConnectionSetupDurationNs = m_setupDurationNs;
+                metrics.CompletedStreams = m_completedStreams.load(std::memory_order_relaxed);
+                metrics.FailedStreams = m_failedStreams.load(std::memory_order_relaxed);
+                for (size_t i = 0; i < HttpClientConnectionStreamMetrics::LatencyBucketCount; ++i)
+                {
+                    metrics.TimeToFirstByteHistogram[i] = m_timeToFirstByteHistogram[i].load(std::memory_order_relaxed);
+                    metrics.HeaderDurationHistogram[i] = m_headerDurationHistogram[i].load(std::memory_order_relaxed);
+                    metrics.BodyDurationHistogram[i] = m_bodyDurationHistogram[i].load(std::memory_order_relaxed);
+                    metrics.TotalDurationHistogram[i] = m_totalDurationHistogram[i].load(std::memory_order_relaxed);
+                }
+
+                return metrics;
+            }
+
+            static size_t s_latencyBucket(uint64_t durationNs) noexcept
+            {
+                uint64_t durationMs =
+                    aws_timestamp_convert(durationNs, AWS_TIMESTAMP_NANOS, AWS_TIMESTAMP_MILLIS, nullptr);
+
+                size_t bucket = 0;
+                while (bucket + 1 < HttpClientConnectionStreamMetrics::LatencyBucketCount &&
+                       durationMs >= (uint64_t(1) << bucket))
+                {
+                    ++bucket;
+                }
+
+                return bucket;
+            }
+
+            void HttpClientConnection::RecordStreamTimings(const HttpStreamTimings &timings, int errorCode) noexcept
+            {
+                (errorCode ? m_failedStreams : m_completedStreams).fetch_add(1, std::memory_order_relaxed);
+
+                /* a stream that failed before getting a response has no phases worth recording */
+                if (timings.FirstHeaderTimestampNs == 0)
+                {
+                    return;
+                }
+
+                m_timeToFirstByteHistogram[s_latencyBucket(timings.GetTimeToFirstByteNs())].fetch_add(
+                    1, std::memory_order_relaxed);
+                m_totalDurationHistogram[s_latencyBucket(timings.GetTotalDurationNs())].fetch_add(
+                    1, std::memory_order_relaxed);
+                if (timings.HeadersDoneTimestampNs != 0)
+                {
+                    m_headerDurationHistogram[s_latencyBucket(timings.GetHeaderDurationNs())].fetch_add(
+                        1, std::memory_order_relaxed);
+                    m_bodyDurationHistogram[s_latencyBucket(timings.GetBodyDurationNs())].fetch_add(
+                        1, std::memory_order_relaxed);
+                }
+            }
+
+            Http2ClientConnection::Http2ClientConnection(aws_http_connection *connection, Allocator *allocator) noexcept
+                : HttpClientConnection(connection, allocator)
+            {
+            }
+
+            std::shared_ptr<Http2ClientConnection> Http2ClientConnection::FromConnection(
+                const std::shared_ptr<HttpClientConnection> &connection) noexcept
+            {
+                Http2ClientConnection *http2Connection = connection ? connection->AsHttp2() : nullptr;
+                if (!http2Connection)
+                {
+                    return nullptr;
+                }
+
+                return std::shared_ptr<Http2ClientConnection>(connection, http2Connection);
+            }
+
+            bool Http2ClientConnection::NewClientStreams(
+                const Vector<HttpRequestOptions> &requestOptions,
+                Vector<std::shared_ptr<HttpClientStream>> &outStreams) noexcept
+            {
+                Vector<std::shared_ptr<HttpClientStream>> streams;
+                streams.reserve(requestOptions.size());
+
+                for (const auto &options : requestOptions)
+                {
+                    auto stream = NewClientStream(options);
+                    if (!stream)
+                    {
+                        return false;
+                    }
+
+                    streams.push_back(std::move(stream));
+                }
+
+                outStreams.reserve(outStreams.size() + streams.size());
+                for (auto &stream : streams)
+                {
+                    if (!stream->Activate())
+                    {
+                        m_lastError = aws_last_error();
+                        return false;
+                    }
+
+                    outStreams.push_back(std::move(stream));
+                }
+
+                return true;
+            }
+
+            bool Http2ClientConnection::ChangeSettings(
+                const Vector<Http2Setting> &settings,
+                OnHttp2SettingsChangeComplete &&onComplete) noexcept
+            {
+                auto *callbackData = New<Http2ConnectionCallbackData>(m_allocator, m_allocator);
+                if (!callbackData)
+                {
+                    m_lastError = aws_last_error();
+                    return false;
+                }
+
+                callbackData->connection = shared_from_this();
+                callbackData->onSettingsChangeComplete = std::move(onComplete);
+
+                if (aws_http2_connection_change_settings(
+                        m_connection,
+                        settings.data(),
+                        settings.size(),
+                        Http2ClientConnection::s_onSettingsChangeComplete,
+                        callbackData))
+                {
+                    m_lastError = aws_last_error();
+                    Delete(callbackData, m_allocator);
+                    return false;
+                }
+
+                return true;
+            }
+
+            bool Http2ClientConnection::Ping(OnHttp2PingComplete &&onComplete) noexcept
+            {
+                auto *callbackData = New<Http2ConnectionCallbackData>(m_allocator, m_allocator);
+                if (!callbackData)
+                {
+                    m_lastError = aws_last_error();
+                    return false;
+                }
+
+                callbackData->connection = shared_from_this();
+                callbackData->onPingComplete = std::move(onComplete);
+
+                if (aws_http2_connection_ping(
+                        m_connection, nullptr, Http2ClientConnection::s_onPingComplete, callbackData))
+                {
+                    m_lastError = aws_last_error();
+                    Delete(callbackData, m_allocator);
+                    return false;
+                }
+
+                return true;
+            }
+
+            static uint32_t s_findSetting(const Http2Setting *settings, Http2SettingId id) noexcept
+            {
+                for (size_t i = 0; i < AWS_HTTP2_SETTINGS_COUNT; ++i)
+                {
+                    if (settings[i].id == (enum aws_http2_settings_id)id)
+                    {
+                        return settings[i].value;
+                    }
+                }
+
+                return 0;
+            }
+
+            uint32_t Http2ClientConnection::GetLocalSetting(Http2SettingId id) const noexcept
+            {
+                Http2Setting settings[AWS_HTTP2_SETTINGS_COUNT];
+                aws_http2_connection_get_local_settings(m_connection, settings);
+                return s_findSetting(settings, id);
+            }
+
+            uint32_t Http2ClientConnection::GetRemoteSetting(Http2SettingId id) const noexcept
+            {
+                Http2Setting settings[AWS_HTTP2_SETTINGS_COUNT];
+                aws_http2_connection_get_remote_settings(m_connection, settings);
+                return s_findSetting(settings, id);
+            }
+
+            void Http2ClientConnection::s_onSettingsChangeComplete(
+                struct aws_http_connection *,
+                int errorCode,
+                void *userData) noexcept
+            {
+                auto *callbackData = static_cast<Http2ConnectionCallbackData *>(userData);
+
+                /* Don't invoke callback if the connection object has expired. */
+                auto connectionPtr = callbackData->connection.lock();
+                if (connectionPtr && callbackData->onSettingsChangeComplete)
+                {
+                    callbackData->onSettingsChangeComplete(*connectionPtr->AsHttp2(), errorCode);
+                }
+
+                Delete(callbackData, callbackData->allocator);
+            }
+
+            void Http2ClientConnection::s_onPingComplete(
+                struct aws_http_connection *,
+                uint64_t roundTripTimeNs,
+                int errorCode,
+                void *userData) noexcept
+            {
+                auto *callbackData = static_cast<Http2ConnectionCallbackData *>(userData);
+
+                auto connectionPtr = callbackData->connection.lock();
+                if (connectionPtr && callbackData->onPingComplete)
+                {
+                    callbackData->onPingComplete(*connectionPtr->AsHttp2(), roundTripTimeNs, errorCode);
+                }
+
+                Delete(callbackData, callbackData->allocator);
+            }
+
             int HttpStream::s_onIncomingHeaders(
                 struct aws_http_stream *,
                 enum aws_http_header_block headerBlock,
@@ -219,6 +937,18 @@ namespace Aws
                 void *userData) noexcept
             {
                 auto callbackData = static_cast<ClientStreamCallbackData *>(userData);
+                HttpStreamTimings &timings = callbackData->stream->m_timings;
+                if (callbackData->stream->m_recordTimings && timings.FirstHeaderTimestampNs == 0)
+                {
+                    aws_high_res_clock_get_ticks(&timings.FirstHeaderTimestampNs);
+                }
+
+                if (headerBlock == AWS_HTTP_HEADER_BLOCK_MAIN &&
+                    (callbackData->stream->m_responseBody || callbackData->stream->m_decodeResponseBody))
+                {
+                    callbackData->stream->RecordBodyHeaders(headerArray, numHeaders);
+                }
+
                 callbackData->stream->m_onIncomingHeaders(*callbackData->stream, headerBlock, headerArray, numHeaders);
 
                 return AWS_OP_SUCCESS;
@@ -231,6 +961,19 @@ namespace Aws
             {
                 auto callbackData = static_cast<ClientStreamCallbackData *>(userData);
 
+                if (headerBlock == AWS_HTTP_HEADER_BLOCK_MAIN)
+                {
+                    if (callbackData->stream->m_recordTimings)
+                    {
+                        aws_high_res_clock_get_ticks(&callbackData->stream->m_timings.HeadersDoneTimestampNs);
+                    }
+
+                    if (!callbackData->stream->PrepareForBody())
+                    {
+                        return AWS_OP_ERR;
+                    }
+                }
+
                 if (callbackData->stream->m_onIncomingHeadersBlockDone)
                 {
                     callbackData->stream->m_onIncomingHeadersBlockDone(*callbackData->stream, headerBlock);
@@ -245,25 +988,215 @@ namespace Aws
                 void *userData) noexcept
             {
                 auto callbackData = static_cast<ClientStreamCallbackData *>(userData);
+                HttpStream &stream = *callbackData->stream;
+
+                if (stream.m_recordTimings)
+                {
+                    if (stream.m_timings.FirstBodyTimestampNs == 0)
+                    {
+                        aws_high_res_clock_get_ticks(&stream.m_timings.FirstBodyTimestampNs);
+                    }
+                    stream.m_timings.BodyBytes += data->len;
+                }
 
-                if (callbackData->stream->m_onIncomingBody)
+                const auto &tuner = stream.m_connection->m_readWindowTuner;
+                if (tuner)
+                {
+                    tuner->OnBytesReceived(data->len);
+                }
+
+                if (!stream.m_bodyDecoder)
+                {
+                    if (!stream.DeliverBody(*data))
+                    {
+                        return AWS_OP_ERR;
+                    }
+
+                    /* the connection would have reopened the window itself, had AdaptiveReadWindow not taken that
+                     * over */
+                    if (stream.m_connection->m_releasesWindow && !stream.m_windowTakenOver.load())
+                    {
+                        stream.ReleaseWindow(data->len);
+                    }
+                    return AWS_OP_SUCCESS;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(stream.m_windowLock);
+                    stream.m_codedBytesHeld += data->len;
+                }
+                if (!stream.m_bodyDecoder->Decode(
+                        *data, [&stream](const ByteCursor &decoded) { return stream.DeliverDecodedBody(decoded); }))
                 {
-                    callbackData->stream->m_onIncomingBody(*callbackData->stream, *data);
+                    return AWS_OP_ERR;
                 }
 
+                if (stream.CallerReleasesWindow())
+                {
+                    /* coded bytes the decoder took in without anything to show for them yet are not held by the
+                     * caller, and waiting for the caller to release them could stall the body */
+                    size_t unheld = 0;
+                    {
+                        std::lock_guard<std::mutex> lock(stream.m_windowLock);
+                        if (stream.m_decodedBytesHeld == 0)
+                        {
+                            unheld = stream.m_codedBytesHeld;
+                            stream.m_codedBytesHeld = 0;
+                        }
+                    }
+                    if (unheld > 0)
+                    {
+                        stream.ReleaseWindow(unheld);
+                    }
+                }
+                else if (stream.m_connection->m_releasesWindow)
+                {
+                    stream.ReleaseWindow(data->len);
+                }
                 return AWS_OP_SUCCESS;
             }
 
             void HttpStream::s_onStreamComplete(struct aws_http_stream *, int errorCode, void *userData) noexcept
             {
                 auto callbackData = static_cast<ClientStreamCallbackData *>(userData);
-                callbackData->stream->m_onStreamComplete(*callbackData->stream, errorCode);
+                HttpStream &stream = *callbackData->stream;
+                if (errorCode == AWS_ERROR_SUCCESS && stream.m_bodyDecoder && !stream.m_bodyDecoder->IsComplete())
+                {
+                    /* the coded body ended early */
+                    errorCode = AWS_ERROR_HTTP_PROTOCOL_ERROR;
+                }
+
+                EventTracer::Record(TraceEventType::HttpStream, TraceEventPhase::End, &stream, errorCode);
+                if (stream.m_recordTimings)
+                {
+                    aws_high_res_clock_get_ticks(&stream.m_timings.CompletedTimestampNs);
+                    stream.m_connection->RecordStreamTimings(stream.m_timings, errorCode);
+                }
+
+                stream.m_onStreamComplete(stream, errorCode);
                 callbackData->stream = nullptr;
             }
 
+            HttpStreamTimings::HttpStreamTimings() noexcept
+                : CreatedTimestampNs(0), ActivatedTimestampNs(0), FirstHeaderTimestampNs(0), HeadersDoneTimestampNs(0),
+                  FirstBodyTimestampNs(0), CompletedTimestampNs(0), BodyBytes(0)
+            {
+            }
+
+            /* zero if either end of the phase was never reached */
+            static uint64_t s_phaseDuration(uint64_t startTimestampNs, uint64_t endTimestampNs) noexcept
+            {
+                if (startTimestampNs == 0 || endTimestampNs < startTimestampNs)
+                {
+                    return 0;
+                }
+
+                return endTimestampNs - startTimestampNs;
+            }
+
+            uint64_t HttpStreamTimings::GetTimeToFirstByteNs() const noexcept
+            {
+                return s_phaseDuration(ActivatedTimestampNs, FirstHeaderTimestampNs);
+            }
+
+            uint64_t HttpStreamTimings::GetHeaderDurationNs() const noexcept
+            {
+                return s_phaseDuration(FirstHeaderTimestampNs, HeadersDoneTimestampNs);
+            }
+
+            uint64_t HttpStreamTimings::GetBodyDurationNs() const noexcept
+            {
+                return s_phaseDuration(HeadersDoneTimestampNs, CompletedTimestampNs);
+            }
+
+            uint64_t HttpStreamTimings::GetTotalDurationNs() const noexcept
+            {
+                return s_phaseDuration(ActivatedTimestampNs, CompletedTimestampNs);
+            }
+
             HttpStream::HttpStream(const std::shared_ptr<HttpClientConnection> &connection) noexcept
-                : m_stream(nullptr), m_connection(connection)
+                : m_stream(nullptr), m_connection(connection), m_recordTimings(false), m_timings(),
+                  m_allocator(g_allocator), m_responseBody(nullptr), m_responseBodyPreallocationLimit(0),
+                  m_decodeResponseBody(false), m_responseContentLength(0), m_hasResponseContentLength(false),
+                  m_responseEncoding(HttpContentEncoding::Identity), m_bodyDecoder(nullptr), m_decodingBody(false),
+                  m_codedBytesHeld(0), m_decodedBytesHeld(0), m_windowTakenOver(false)
+            {
+            }
+
+            void HttpStream::RecordBodyHeaders(const HttpHeader *headerArray, size_t numHeaders) noexcept
             {
+                for (size_t i = 0; i < numHeaders; ++i)
+                {
+                    const HttpHeader &header = headerArray[i];
+                    if (aws_byte_cursor_eq_c_str_ignore_case(&header.name, "content-length"))
+                    {
+                        m_hasResponseContentLength =
+                            aws_byte_cursor_utf8_parse_u64(header.value, &m_responseContentLength) == AWS_OP_SUCCESS;
+                    }
+                    else if (
+                        m_decodeResponseBody && aws_byte_cursor_eq_c_str_ignore_case(&header.name, "content-encoding"))
+                    {
+                        HttpContentEncoding encoding = HttpContentEncoding::Identity;
+                        if (HttpBodyDecoder::ParseContentEncoding(header.value, encoding) &&
+                            HttpBodyDecoder::IsSupported(encoding))
+                        {
+                            m_responseEncoding = encoding;
+                        }
+                    }
+                }
+            }
+
+            bool HttpStream::PrepareForBody() noexcept
+            {
+                if (m_responseEncoding != HttpContentEncoding::Identity)
+                {
+                    m_bodyDecoder = HttpBodyDecoder::NewDecoder(m_responseEncoding, m_allocator);
+                    m_decodingBody.store(m_bodyDecoder != nullptr, std::memory_order_release);
+                    return m_bodyDecoder != nullptr;
+                }
+
+                /* Content-Length only says how big the body is on the wire, which is useless for a decoded one */
+                if (m_responseBody && m_responseBody->allocator && m_hasResponseContentLength)
+                {
+                    size_t toReserve = m_responseContentLength < m_responseBodyPreallocationLimit
+                                           ? static_cast<size_t>(m_responseContentLength)
+                                           : m_responseBodyPreallocationLimit;
+                    /* only a hint, the body still grows on demand if this fails */
+                    aws_byte_buf_reserve_relative(m_responseBody, toReserve);
+                }
+
+                return true;
+            }
+
+            bool HttpStream::DeliverBody(const ByteCursor &data) noexcept
+            {
+                if (m_responseBody)
+                {
+                    int appendResult = m_responseBody->allocator ? aws_byte_buf_append_dynamic(m_responseBody, &data)
+                                                                 : aws_byte_buf_append(m_responseBody, &data);
+                    if (appendResult)
+                    {
+                        return false;
+                    }
+                }
+
+                if (m_onIncomingBody)
+                {
+                    m_onIncomingBody(*this, data);
+                }
+
+                return true;
+            }
+
+            bool HttpStream::DeliverDecodedBody(const ByteCursor &decoded) noexcept
+            {
+                {
+                    /* counted before the caller sees it, it may be released from inside `onIncomingBody` */
+                    std::lock_guard<std::mutex> lock(m_windowLock);
+                    m_decodedBytesHeld += decoded.len;
+                }
+
+                return DeliverBody(decoded);
             }
 
             HttpStream::~HttpStream()
@@ -302,8 +1235,16 @@ namespace Aws
             bool HttpClientStream::Activate() noexcept
             {
                 m_callbackData.stream = shared_from_this();
+                if (m_recordTimings)
+                {
+                    aws_high_res_clock_get_ticks(&m_timings.ActivatedTimestampNs);
+                }
+
+                const HttpStream *traced = this;
+                EventTracer::Record(TraceEventType::HttpStream, TraceEventPhase::Begin, traced);
                 if (aws_http_stream_activate(m_stream))
                 {
+                    EventTracer::Record(TraceEventType::HttpStream, TraceEventPhase::End, traced, aws_last_error());
                     m_callbackData.stream = nullptr;
                     return false;
                 }
@@ -313,7 +1254,72 @@ namespace Aws
 
             void HttpStream::UpdateWindow(std::size_t incrementSize) noexcept
             {
-                aws_http_stream_update_window(m_stream, incrementSize);
+                if (!m_decodingBody.load(std::memory_order_acquire))
+                {
+                    ReleaseWindow(incrementSize);
+                    return;
+                }
+
+                if (!CallerReleasesWindow())
+                {
+                    return;
+                }
+
+                /* incrementSize counts decoded bytes, the window counts the coded bytes they were decoded from */
+                size_t codedBytes = 0;
+                {
+                    std::lock_guard<std::mutex> lock(m_windowLock);
+                    if (incrementSize >= m_decodedBytesHeld && m_decodedBytesHeld > 0)
+                    {
+                        codedBytes = m_codedBytesHeld;
+                        m_codedBytesHeld = 0;
+                        m_decodedBytesHeld = 0;
+                    }
+                    else if (incrementSize < m_decodedBytesHeld)
+                    {
+                        codedBytes = static_cast<size_t>(
+                            static_cast<double>(m_codedBytesHeld) * incrementSize / m_decodedBytesHeld);
+                        m_codedBytesHeld -= codedBytes;
+                        m_decodedBytesHeld -= incrementSize;
+                    }
+                }
+
+                if (codedBytes > 0)
+                {
+                    ReleaseWindow(codedBytes);
+                }
+            }
+
+            bool HttpStream::TakeOverWindow() noexcept
+            {
+                if (m_connection->m_manualWindowManagement)
+                {
+                    return true;
+                }
+
+                if (m_connection->m_releasesWindow)
+                {
+                    m_windowTakenOver.store(true);
+                    return true;
+                }
+
+                /* aws-c-http reopens the window by itself, anything on top of that would credit bytes twice */
+                return false;
+            }
+
+            bool HttpStream::CallerReleasesWindow() const noexcept
+            {
+                return m_connection->m_manualWindowManagement || m_windowTakenOver.load();
+            }
+
+            void HttpStream::ReleaseWindow(size_t bytesConsumed) noexcept
+            {
+                const auto &tuner = m_connection->m_readWindowTuner;
+                size_t incrementSize = tuner ? tuner->OnBytesConsumed(bytesConsumed) : bytesConsumed;
+                if (incrementSize > 0)
+                {
+                    aws_http_stream_update_window(m_stream, incrementSize);
+                }
             }
 
             HttpClientConnectionProxyOptions::HttpClientConnectionProxyOptions()
@@ -351,7 +1357,7 @@ namespace Aws
             HttpClientConnectionOptions::HttpClientConnectionOptions()
                 : Bootstrap(nullptr), InitialWindowSize(SIZE_MAX), OnConnectionSetupCallback(),
                   OnConnectionShutdownCallback(), HostName(), Port(0), SocketOptions(), TlsOptions(), ProxyOptions(),
-                  ManualWindowManagement(false)
+                  ManualWindowManagement(false), AdaptiveReadWindow(), Http2InitialSettings()
             {
             }
         } // namespace Http
@@ -2,11 +2,17 @@
  * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
  * SPDX-License-Identifier: Apache-2.0.
  */
+#include <aws/crt/Api.h>
 #include <aws/crt/http/HttpConnectionManager.h>
 #include <aws/crt/http/HttpProxyStrategy.h>
+#include <aws/crt/http/HttpRequestResponse.h>
 
 #include <algorithm>
+#include <aws/common/clock.h>
 #include <aws/http/connection_manager.h>
+#include <aws/io/channel.h>
+#include <aws/io/socket.h>
+#include <aws/io/socket_channel_handler.h>
 
 namespace Aws
 {
@@ -18,7 +24,82 @@ namespace Aws
             {
                 ConnectionManagerCallbackArgs() = default;
                 OnClientConnectionAvailable m_onClientConnectionAvailable;
+                Function<void()> m_onConnectionReleased;
                 std::shared_ptr<HttpClientConnectionManager> m_connectionManager;
+                uint64_t m_acquireStartTimestampNs = 0;
+            };
+
+            /* Lives from MakeRequest() until the exchange completes or fails. */
+            struct CollectedRequestState
+            {
+                explicit CollectedRequestState(Allocator *allocator) : allocator(allocator) {}
+                Allocator *allocator;
+                std::promise<HttpCollectedResponse> promise;
+                HttpCollectedResponse response;
+                std::shared_ptr<HttpRequest> request;
+                std::shared_ptr<HttpClientStream> stream;
+            };
+
+            static void s_completeCollectedRequest(CollectedRequestState *state, int errorCode) noexcept
+            {
+                state->response.ErrorCode = errorCode;
+                state->promise.set_value(std::move(state->response));
+                Delete(state, state->allocator);
+            }
+
+            static void s_sendCollectedRequest(
+                CollectedRequestState *state,
+                const std::shared_ptr<HttpClientConnection> &connection) noexcept
+            {
+                HttpRequestOptions requestOptions;
+                requestOptions.request = state->request.get();
+                requestOptions.onIncomingHeaders = [state](
+                                                       HttpStream &stream,
+                                                       enum aws_http_header_block headerBlock,
+                                                       const HttpHeader *headersArray,
+                                                       std::size_t headersCount) {
+                    if (headerBlock != AWS_HTTP_HEADER_BLOCK_MAIN)
+                    {
+                        return;
+                    }
+
+                    state->response.StatusCode = stream.GetResponseStatusCode();
+                    for (size_t i = 0; i < headersCount; ++i)
+                    {
+                        const HttpHeader &header = headersArray[i];
+                        state->response.Headers.emplace_back(
+                            String(reinterpret_cast<const char *>(header.name.ptr), header.name.len),
+                            String(reinterpret_cast<const char *>(header.value.ptr), header.value.len));
+                    }
+                };
+                requestOptions.onIncomingBody = [state](HttpStream &, const ByteCursor &data) {
+                    state->response.Body.insert(state->response.Body.end(), data.ptr, data.ptr + data.len);
+                };
+                requestOptions.onStreamComplete = [state](HttpStream &, int errorCode) {
+                    s_completeCollectedRequest(state, errorCode);
+                };
+
+                state->stream = connection->NewClientStream(requestOptions);
+                if (!state->stream)
+                {
+                    s_completeCollectedRequest(state, connection->LastError());
+                    return;
+                }
+
+                if (!state->stream->Activate())
+                {
+                    s_completeCollectedRequest(state, aws_last_error());
+                }
+            }
+
+            /* Connections are held here until every prewarm acquisition completes so each one is distinct. */
+            struct PrewarmState
+            {
+                explicit PrewarmState(size_t connectionCount) : remaining(connectionCount), acquired(0) {}
+                std::mutex lock;
+                size_t remaining;
+                size_t acquired;
+                std::promise<size_t> promise;
             };
 
             void HttpClientConnectionManager::s_shutdownCompleted(void *userData) noexcept
@@ -28,8 +109,18 @@ namespace Aws
                 connectionManager->m_shutdownPromise.set_value();
             }
 
+            const size_t HttpClientConnectionManagerMetrics::AcquireLatencyBucketCount;
+
+            HttpClientConnectionManagerMetrics::HttpClientConnectionManagerMetrics() noexcept
+                : MaxConnections(0), LeasedConnections(0), PendingAcquisitions(0), SuccessfulAcquisitions(0),
+                  FailedAcquisitions(0), ConnectionsClosedWhileLeased(0)
+            {
+                AWS_ZERO_ARRAY(AcquireLatencyHistogram);
+            }
+
             HttpClientConnectionManagerOptions::HttpClientConnectionManagerOptions() noexcept
-                : ConnectionOptions(), MaxConnections(1), EnableBlockingShutdown(false)
+                : ConnectionOptions(), MaxConnections(1), EnableBlockingShutdown(false), MinIdleConnections(0),
+                  MaxConnectionIdleInMilliseconds(0)
             {
             }
 
@@ -37,13 +128,22 @@ namespace Aws
                 const HttpClientConnectionManagerOptions &connectionManagerOptions,
                 Allocator *allocator) noexcept
             {
+                ApiHandle::InitializeSubsystem(ApiSubsystem::Http);
+
                 auto *toSeat = static_cast<HttpClientConnectionManager *>(
                     aws_mem_acquire(allocator, sizeof(HttpClientConnectionManager)));
                 if (toSeat)
                 {
                     toSeat = new (toSeat) HttpClientConnectionManager(connectionManagerOptions, allocator);
-                    return std::shared_ptr<HttpClientConnectionManager>(
+                    std::shared_ptr<HttpClientConnectionManager> manager(
                         toSeat, [allocator](HttpClientConnectionManager *manager) { Delete(manager, allocator); });
+
+                    if (connectionManagerOptions.MinIdleConnections > 0)
+                    {
+                        manager->Prewarm(connectionManagerOptions.MinIdleConnections);
+                    }
+
+                    return manager;
                 }
 
                 return nullptr;
@@ -52,8 +152,15 @@ namespace Aws
             HttpClientConnectionManager::HttpClientConnectionManager(
                 const HttpClientConnectionManagerOptions &options,
                 Allocator *allocator) noexcept
-                : m_allocator(allocator), m_connectionManager(nullptr), m_options(options), m_releaseInvoked(false)
+                : m_allocator(allocator), m_connectionManager(nullptr), m_options(options), m_releaseInvoked(false),
+                  m_leasedConnections(0), m_pendingAcquisitions(0), m_successfulAcquisitions(0),
+                  m_failedAcquisitions(0), m_connectionsClosedWhileLeased(0)
             {
+                for (auto &bucket : m_acquireLatencyHistogram)
+                {
+                    bucket.store(0);
+                }
+
                 const auto &connectionOptions = m_options.ConnectionOptions;
                 AWS_FATAL_ASSERT(connectionOptions.HostName.size() > 0);
                 AWS_FATAL_ASSERT(connectionOptions.Port > 0);
@@ -65,6 +172,7 @@ namespace Aws
                 managerOptions.max_connections = m_options.MaxConnections;
                 managerOptions.socket_options = &connectionOptions.SocketOptions.GetImpl();
                 managerOptions.initial_window_size = connectionOptions.InitialWindowSize;
+                managerOptions.max_connection_idle_in_milliseconds = m_options.MaxConnectionIdleInMilliseconds;
 
                 if (options.EnableBlockingShutdown)
                 {
@@ -108,6 +216,13 @@ namespace Aws
 
             bool HttpClientConnectionManager::AcquireConnection(
                 const OnClientConnectionAvailable &onClientConnectionAvailable) noexcept
+            {
+                return AcquireConnection(onClientConnectionAvailable, Function<void()>());
+            }
+
+            bool HttpClientConnectionManager::AcquireConnection(
+                const OnClientConnectionAvailable &onClientConnectionAvailable,
+                const Function<void()> &onConnectionReleased) noexcept
             {
                 auto connectionManagerCallbackArgs = Aws::Crt::New<ConnectionManagerCallbackArgs>(m_allocator);
                 if (!connectionManagerCallbackArgs)
@@ -117,12 +232,148 @@ namespace Aws
 
                 connectionManagerCallbackArgs->m_connectionManager = shared_from_this();
                 connectionManagerCallbackArgs->m_onClientConnectionAvailable = onClientConnectionAvailable;
+                connectionManagerCallbackArgs->m_onConnectionReleased = onConnectionReleased;
+                aws_high_res_clock_get_ticks(&connectionManagerCallbackArgs->m_acquireStartTimestampNs);
+                m_pendingAcquisitions.fetch_add(1, std::memory_order_relaxed);
 
                 aws_http_connection_manager_acquire_connection(
                     m_connectionManager, s_onConnectionSetup, connectionManagerCallbackArgs);
                 return true;
             }
 
+            std::future<HttpClientConnectionAcquisition> HttpClientConnectionManager::AcquireConnection() noexcept
+            {
+                using AcquisitionPromise = std::promise<HttpClientConnectionAcquisition>;
+
+                /* raw rather than shared so the callback stays small enough to be stored inline */
+                auto *promise = Aws::Crt::New<AcquisitionPromise>(m_allocator);
+                if (!promise)
+                {
+                    AcquisitionPromise failed;
+                    HttpClientConnectionAcquisition acquisition;
+                    acquisition.ErrorCode = aws_last_error();
+                    failed.set_value(std::move(acquisition));
+                    return failed.get_future();
+                }
+
+                auto future = promise->get_future();
+                Allocator *allocator = m_allocator;
+                bool queued = AcquireConnection(
+                    [promise, allocator](std::shared_ptr<HttpClientConnection> connection, int errorCode) {
+                        HttpClientConnectionAcquisition acquisition;
+                        acquisition.Connection = std::move(connection);
+                        acquisition.ErrorCode = errorCode;
+                        promise->set_value(std::move(acquisition));
+                        Delete(promise, allocator);
+                    });
+
+                if (!queued)
+                {
+                    HttpClientConnectionAcquisition acquisition;
+                    acquisition.ErrorCode = aws_last_error();
+                    promise->set_value(std::move(acquisition));
+                    Delete(promise, allocator);
+                }
+
+                return future;
+            }
+
+            std::future<HttpCollectedResponse> HttpClientConnectionManager::MakeRequest(
+                const std::shared_ptr<HttpRequest> &request) noexcept
+            {
+                auto *state = Aws::Crt::New<CollectedRequestState>(m_allocator, m_allocator);
+                if (!state)
+                {
+                    std::promise<HttpCollectedResponse> failed;
+                    HttpCollectedResponse response;
+                    response.ErrorCode = aws_last_error();
+                    failed.set_value(std::move(response));
+                    return failed.get_future();
+                }
+
+                state->request = request;
+                auto future = state->promise.get_future();
+
+                bool queued =
+                    AcquireConnection([state](std::shared_ptr<HttpClientConnection> connection, int errorCode) {
+                        if (errorCode)
+                        {
+                            s_completeCollectedRequest(state, errorCode);
+                            return;
+                        }
+
+                        s_sendCollectedRequest(state, connection);
+                    });
+
+                if (!queued)
+                {
+                    s_completeCollectedRequest(state, aws_last_error());
+                }
+
+                return future;
+            }
+
+            std::future<size_t> HttpClientConnectionManager::Prewarm(size_t connectionCount) noexcept
+            {
+                /*
+                 * The pool never opens more than MaxConnections anyway, and what is leased right now is not free to
+                 * be warmed: acquisitions beyond that would only queue up behind the requests holding them.
+                 */
+                size_t leased = m_leasedConnections.load(std::memory_order_relaxed);
+                size_t freeConnections = m_options.MaxConnections > leased ? m_options.MaxConnections - leased : 0;
+                connectionCount = (std::min)(connectionCount, freeConnections);
+
+                auto state = Aws::Crt::MakeShared<PrewarmState>(m_allocator, connectionCount);
+                if (!state || connectionCount == 0)
+                {
+                    std::promise<size_t> done;
+                    done.set_value(0);
+                    return done.get_future();
+                }
+
+                auto future = state->promise.get_future();
+
+                /*
+                 * Every acquisition is queued before any of them completes, so the pool starts a connect for each
+                 * right away. Each connection can then go back as soon as it is in, without a slow connect holding
+                 * the others out of the pool.
+                 */
+                auto onConnectionAvailable = [state](std::shared_ptr<HttpClientConnection> connection, int errorCode) {
+                    bool acquired = !errorCode && connection;
+                    /* dropping the reference returns the connection to the pool as idle */
+                    connection.reset();
+
+                    size_t acquiredCount = 0;
+                    {
+                        std::lock_guard<std::mutex> lock(state->lock);
+                        if (acquired)
+                        {
+                            ++state->acquired;
+                        }
+
+                        if (--state->remaining > 0)
+                        {
+                            return;
+                        }
+
+                        acquiredCount = state->acquired;
+                    }
+
+                    state->promise.set_value(acquiredCount);
+                };
+
+                for (size_t i = 0; i < connectionCount; ++i)
+                {
+                    if (!AcquireConnection(onConnectionAvailable))
+                    {
+                        /* the ones that could not be queued still have to be counted off */
+                        onConnectionAvailable(nullptr, aws_last_error());
+                    }
+                }
+
+                return future;
+            }
+
             std::future<void> HttpClientConnectionManager::InitiateShutdown() noexcept
             {
                 m_releaseInvoked = true;
@@ -130,29 +381,127 @@ namespace Aws
                 return m_shutdownPromise.get_future();
             }
 
+            HttpClientConnectionManagerMetrics HttpClientConnectionManager::GetMetrics() const noexcept
+            {
+                HttpClientConnectionManagerMetrics metrics;
+                metrics.MaxConnections = m_options.MaxConnections;
+                metrics.LeasedConnections = m_leasedConnections.load(std::memory_order_relaxed);
+                metrics.PendingAcquisitions = m_pendingAcquisitions.load(std::memory_order_relaxed);
+                metrics.SuccessfulAcquisitions = m_successfulAcquisitions.load(std::memory_order_relaxed);
+                metrics.FailedAcquisitions = m_failedAcquisitions.load(std::memory_order_relaxed);
+                metrics.ConnectionsClosedWhileLeased = m_connectionsClosedWhileLeased.load(std::memory_order_relaxed);
+                for (size_t i = 0; i < HttpClientConnectionManagerMetrics::AcquireLatencyBucketCount; ++i)
+                {
+                    metrics.AcquireLatencyHistogram[i] = m_acquireLatencyHistogram[i].load(std::memory_order_relaxed);
+                }
+
+                return metrics;
+            }
+
+            void HttpClientConnectionManager::RecordAcquisition(uint64_t startTimestampNs, bool succeeded) noexcept
+            {
+                m_pendingAcquisitions.fetch_sub(1, std::memory_order_relaxed);
+                (succeeded ? m_successfulAcquisitions : m_failedAcquisitions).fetch_add(1, std::memory_order_relaxed);
+
+                uint64_t now = 0;
+                aws_high_res_clock_get_ticks(&now);
+                uint64_t elapsedNs = now > startTimestampNs ? now - startTimestampNs : 0;
+                uint64_t elapsedMs =
+                    aws_timestamp_convert(elapsedNs, AWS_TIMESTAMP_NANOS, AWS_TIMESTAMP_MILLIS, nullptr);
+
+                size_t bucket = 0;
+                while (bucket + 1 < HttpClientConnectionManagerMetrics::AcquireLatencyBucketCount &&
+                       elapsedMs >= (uint64_t(1) << bucket))
+                {
+                    ++bucket;
+                }
+
+                m_acquireLatencyHistogram[bucket].fetch_add(1, std::memory_order_relaxed);
+            }
+
+            /* a new connection may get the address of one the pool has closed, but not its local port as well */
+            static uint32_t s_localPort(aws_http_connection *connection) noexcept
+            {
+                struct aws_channel_slot *slot = aws_channel_get_first_slot(aws_http_connection_get_channel(connection));
+                const struct aws_socket *socket = nullptr;
+                if (slot != nullptr && slot->handler != nullptr)
+                {
+                    socket = aws_socket_handler_get_socket(slot->handler);
+                }
+
+                return socket != nullptr ? socket->local_endpoint.port : 0;
+            }
+
+            bool HttpClientConnectionManager::MarkTuned(aws_http_connection *connection) noexcept
+            {
+                uint32_t localPort = s_localPort(connection);
+
+                std::lock_guard<std::mutex> lock(m_tunedConnectionsLock);
+                auto found = m_tunedConnections.find(connection);
+                if (found != m_tunedConnections.end() && found->second == localPort)
+                {
+                    return false;
+                }
+
+                /*
+                 * Connections the pool closes while idle are never forgotten one by one, so more entries than the pool
+                 * holds connections means some are stale. Starting over only costs each live connection one more
+                 * round of setsockopt calls.
+                 */
+                if (found == m_tunedConnections.end() && m_tunedConnections.size() >= m_options.MaxConnections)
+                {
+                    m_tunedConnections.clear();
+                }
+
+                m_tunedConnections[connection] = localPort;
+                return true;
+            }
+
+            void HttpClientConnectionManager::ForgetTuned(aws_http_connection *connection) noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_tunedConnectionsLock);
+                m_tunedConnections.erase(connection);
+            }
+
             class ManagedConnection final : public HttpClientConnection
             {
               public:
                 ManagedConnection(
                     aws_http_connection *connection,
-                    std::shared_ptr<HttpClientConnectionManager> connectionManager)
+                    std::shared_ptr<HttpClientConnectionManager> connectionManager,
+                    Function<void()> &&onReleased)
                     : HttpClientConnection(connection, connectionManager->m_allocator),
-                      m_connectionManager(std::move(connectionManager))
+                      m_connectionManager(std::move(connectionManager)), m_onReleased(std::move(onReleased))
                 {
+                    m_connectionManager->m_leasedConnections.fetch_add(1, std::memory_order_relaxed);
                 }
 
                 ~ManagedConnection() override
                 {
+                    m_connectionManager->m_leasedConnections.fetch_sub(1, std::memory_order_relaxed);
                     if (m_connection)
                     {
+                        if (!aws_http_connection_is_open(m_connection))
+                        {
+                            m_connectionManager->m_connectionsClosedWhileLeased.fetch_add(1, std::memory_order_relaxed);
+                            /* the pool destroys it once it is back */
+                            m_connectionManager->ForgetTuned(m_connection);
+                        }
+
                         aws_http_connection_manager_release_connection(
                             m_connectionManager->m_connectionManager, m_connection);
                         m_connection = nullptr;
                     }
+
+                    if (m_onReleased)
+                    {
+                        m_onReleased();
+                    }
                 }
 
               private:
                 std::shared_ptr<HttpClientConnectionManager> m_connectionManager;
+                Function<void()> m_onReleased;
             };
 
             void HttpClientConnectionManager::s_onConnectionSetup(
@@ -163,8 +512,11 @@ namespace Aws
                 auto callbackArgs = static_cast<ConnectionManagerCallbackArgs *>(userData);
                 std::shared_ptr<HttpClientConnectionManager> manager = callbackArgs->m_connectionManager;
                 auto callback = std::move(callbackArgs->m_onClientConnectionAvailable);
+                auto onConnectionReleased = std::move(callbackArgs->m_onConnectionReleased);
+                uint64_t acquireStartTimestampNs = callbackArgs->m_acquireStartTimestampNs;
 
                 Delete(callbackArgs, manager->m_allocator);
+                manager->RecordAcquisition(acquireStartTimestampNs, errorCode == AWS_ERROR_SUCCESS);
 
                 if (errorCode)
                 {
@@ -172,8 +524,17 @@ namespace Aws
                     return;
                 }
 
+                /* connections come back from the pool, only the first handout of each has to tune its socket */
+                const auto &socketOptions = manager->m_options.ConnectionOptions.SocketOptions;
+                if (socketOptions.HasTuning() && manager->MarkTuned(connection))
+                {
+                    /* best effort, the connection is usable with default socket settings too */
+                    socketOptions.ApplyTuning(aws_http_connection_get_channel(connection));
+                }
+
                 auto allocator = manager->m_allocator;
-                auto connectionRawObj = Aws::Crt::New<ManagedConnection>(manager->m_allocator, connection, manager);
+                auto connectionRawObj = Aws::Crt::New<ManagedConnection>(
+                    manager->m_allocator, connection, manager, std::move(onConnectionReleased));
 
                 if (!connectionRawObj)
                 {
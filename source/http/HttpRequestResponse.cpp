@@ -94,6 +94,36 @@ namespace Aws
                 return aws_http_message_erase_header(m_message, index) == AWS_OP_SUCCESS;
             }
 
+            /* Name lookups go through the message's own aws_http_headers rather than a C++-side index: signing and
+             * proxy code modify the underlying message directly, which would leave a cached index stale. Matching is
+             * case-insensitive and allocation-free. */
+            Optional<ByteCursor> HttpMessage::GetHeader(ByteCursor name) const noexcept
+            {
+                ByteCursor value;
+                if (aws_http_headers_get(aws_http_message_get_headers(m_message), name, &value) != AWS_OP_SUCCESS)
+                {
+                    return Optional<ByteCursor>();
+                }
+
+                return Optional<ByteCursor>(value);
+            }
+
+            bool HttpMessage::SetHeader(const HttpHeader &header) noexcept
+            {
+                return aws_http_headers_set(aws_http_message_get_headers(m_message), header.name, header.value) ==
+                       AWS_OP_SUCCESS;
+            }
+
+            bool HttpMessage::EraseHeader(ByteCursor name) noexcept
+            {
+                return aws_http_headers_erase(aws_http_message_get_headers(m_message), name) == AWS_OP_SUCCESS;
+            }
+
+            bool HttpMessage::AddHeaders(const HttpHeader *headers, size_t count) noexcept
+            {
+                return aws_http_message_add_header_array(m_message, headers, count) == AWS_OP_SUCCESS;
+            }
+
             HttpRequest::HttpRequest(Allocator *allocator)
                 : HttpMessage(allocator, aws_http_message_new_request(allocator))
             {
@@ -138,6 +168,115 @@ namespace Aws
                 return aws_http_message_set_request_path(m_message, path) == AWS_OP_SUCCESS;
             }
 
+            HttpRequestTemplate::HttpRequestTemplate(Allocator *allocator) noexcept
+                : m_allocator(allocator), m_storedHeaders(StlAllocator<StoredHeader>(allocator)),
+                  m_headers(StlAllocator<HttpHeader>(allocator)), m_methodOffset(0), m_methodLength(0),
+                  m_pathOffset(0), m_pathLength(0), m_hasMethod(false), m_hasPath(false)
+            {
+                AWS_ZERO_STRUCT(m_storage);
+                aws_byte_buf_init(&m_storage, allocator, 256);
+            }
+
+            HttpRequestTemplate::~HttpRequestTemplate() { aws_byte_buf_clean_up(&m_storage); }
+
+            bool HttpRequestTemplate::SetMethod(ByteCursor method) noexcept
+            {
+                if (!Store(method, m_methodOffset))
+                {
+                    return false;
+                }
+
+                m_methodLength = method.len;
+                m_hasMethod = true;
+                return true;
+            }
+
+            bool HttpRequestTemplate::SetPath(ByteCursor path) noexcept
+            {
+                if (!Store(path, m_pathOffset))
+                {
+                    return false;
+                }
+
+                m_pathLength = path.len;
+                m_hasPath = true;
+                return true;
+            }
+
+            bool HttpRequestTemplate::AddHeader(const HttpHeader &header) noexcept
+            {
+                StoredHeader stored;
+                stored.nameLength = header.name.len;
+                stored.valueLength = header.value.len;
+                if (!Store(header.name, stored.nameOffset) || !Store(header.value, stored.valueOffset))
+                {
+                    return false;
+                }
+
+                m_storedHeaders.push_back(stored);
+
+                /* storage may have moved, so re-point every header rather than just appending the new one */
+                m_headers.clear();
+                m_headers.reserve(m_storedHeaders.size());
+                for (const auto &entry : m_storedHeaders)
+                {
+                    HttpHeader rebuilt;
+                    AWS_ZERO_STRUCT(rebuilt);
+                    rebuilt.name = StoredCursor(entry.nameOffset, entry.nameLength);
+                    rebuilt.value = StoredCursor(entry.valueOffset, entry.valueLength);
+                    m_headers.push_back(rebuilt);
+                }
+
+                return true;
+            }
+
+            std::shared_ptr<HttpRequest> HttpRequestTemplate::NewRequest(
+                const HttpHeader *overrides,
+                size_t overrideCount) const noexcept
+            {
+                auto request = MakeShared<HttpRequest>(m_allocator, m_allocator);
+                if (!request || !*request)
+                {
+                    return nullptr;
+                }
+
+                if (m_hasMethod && !request->SetMethod(StoredCursor(m_methodOffset, m_methodLength)))
+                {
+                    return nullptr;
+                }
+
+                if (m_hasPath && !request->SetPath(StoredCursor(m_pathOffset, m_pathLength)))
+                {
+                    return nullptr;
+                }
+
+                if (!m_headers.empty() && !request->AddHeaders(m_headers.data(), m_headers.size()))
+                {
+                    return nullptr;
+                }
+
+                for (size_t i = 0; i < overrideCount; ++i)
+                {
+                    if (!request->SetHeader(overrides[i]))
+                    {
+                        return nullptr;
+                    }
+                }
+
+                return request;
+            }
+
+            bool HttpRequestTemplate::Store(ByteCursor data, size_t &outOffset) noexcept
+            {
+                outOffset = m_storage.len;
+                return aws_byte_buf_append_dynamic(&m_storage, &data) == AWS_OP_SUCCESS;
+            }
+
+            ByteCursor HttpRequestTemplate::StoredCursor(size_t offset, size_t length) const noexcept
+            {
+                return aws_byte_cursor_from_array(m_storage.buffer + offset, length);
+            }
+
             HttpResponse::HttpResponse(Allocator *allocator)
                 : HttpMessage(allocator, aws_http_message_new_response(allocator))
             {
@@ -0,0 +1,287 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/io/AsyncInputStream.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Io
+        {
+            AsyncInputStream::AsyncInputStream(size_t bufferSize, Aws::Crt::Allocator *allocator) noexcept
+                : InputStream(allocator), m_frontOffset(0), m_readInFlight(false), m_producerDone(false),
+                  m_errorCode(AWS_ERROR_SUCCESS)
+            {
+                AWS_FATAL_ASSERT(bufferSize > 0);
+                AWS_ZERO_STRUCT(m_front);
+                AWS_ZERO_STRUCT(m_back);
+                if (aws_byte_buf_init(&m_front, allocator, bufferSize) ||
+                    aws_byte_buf_init(&m_back, allocator, bufferSize))
+                {
+                    m_errorCode = aws_last_error();
+                }
+            }
+
+            AsyncInputStream::~AsyncInputStream()
+            {
+                AWS_FATAL_ASSERT(!m_readInFlight);
+                aws_byte_buf_clean_up(&m_front);
+                aws_byte_buf_clean_up(&m_back);
+            }
+
+            bool AsyncInputStream::IsValid() const noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                return m_errorCode == AWS_ERROR_SUCCESS;
+            }
+
+            bool AsyncInputStream::IsReadInFlight() const noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                return m_readInFlight;
+            }
+
+            void AsyncInputStream::CompleteRead(bool endOfStream, int errorCode) noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                AWS_FATAL_ASSERT(m_readInFlight);
+                m_readInFlight = false;
+                m_producerDone = endOfStream;
+                if (errorCode != AWS_ERROR_SUCCESS)
+                {
+                    m_errorCode = errorCode;
+                }
+            }
+
+            void AsyncInputStream::DrainInto(ByteBuf &buffer) noexcept
+            {
+                while (buffer.len < buffer.capacity)
+                {
+                    if (m_frontOffset == m_front.len)
+                    {
+                        /* the back buffer belongs to the producer until its read completes */
+                        if (m_readInFlight || m_back.len == 0)
+                        {
+                            return;
+                        }
+
+                        std::swap(m_front, m_back);
+                        m_back.len = 0;
+                        m_frontOffset = 0;
+                    }
+
+                    size_t available = m_front.len - m_frontOffset;
+                    size_t toCopy = buffer.capacity - buffer.len < available ? buffer.capacity - buffer.len : available;
+                    memcpy(buffer.buffer + buffer.len, m_front.buffer + m_frontOffset, toCopy);
+                    buffer.len += toCopy;
+                    m_frontOffset += toCopy;
+                }
+            }
+
+            bool AsyncInputStream::ReadImpl(ByteBuf &buffer) noexcept
+            {
+                bool startRead = false;
+                {
+                    std::lock_guard<std::mutex> lock(m_lock);
+                    if (m_errorCode != AWS_ERROR_SUCCESS)
+                    {
+                        aws_raise_error(m_errorCode);
+                        return false;
+                    }
+
+                    DrainInto(buffer);
+                    startRead = !m_readInFlight && !m_producerDone && m_back.len == 0;
+                    m_readInFlight = m_readInFlight || startRead;
+                }
+
+                if (startRead)
+                {
+                    ReadAsyncImpl(m_back);
+
+                    /* a producer that completed synchronously has data for this read already */
+                    std::lock_guard<std::mutex> lock(m_lock);
+                    DrainInto(buffer);
+                }
+
+                return true;
+            }
+
+            StreamStatus AsyncInputStream::GetStatusImpl() const noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                StreamStatus status;
+                status.is_end_of_stream =
+                    m_producerDone && !m_readInFlight && m_frontOffset == m_front.len && m_back.len == 0;
+                status.is_valid = m_errorCode == AWS_ERROR_SUCCESS;
+
+                return status;
+            }
+
+            int64_t AsyncInputStream::GetLengthImpl() const noexcept { return -1; }
+
+            bool AsyncInputStream::SeekImpl(OffsetType offset, StreamSeekBasis seekBasis) noexcept
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_lock);
+                    if (m_readInFlight)
+                    {
+                        aws_raise_error(AWS_ERROR_STREAM_UNSEEKABLE);
+                        return false;
+                    }
+
+                    m_front.len = 0;
+                    m_frontOffset = 0;
+                    m_back.len = 0;
+                    m_producerDone = false;
+
+                    /* a failed read can be retried from a new position, failing to allocate the buffers can not */
+                    if (m_front.buffer && m_back.buffer)
+                    {
+                        m_errorCode = AWS_ERROR_SUCCESS;
+                    }
+                }
+
+                return SeekAsyncImpl(offset, seekBasis);
+            }
+
+            bool AsyncInputStream::SeekAsyncImpl(OffsetType, StreamSeekBasis) noexcept
+            {
+                aws_raise_error(AWS_ERROR_STREAM_UNSEEKABLE);
+                return false;
+            }
+
+            /* how long the worker waits before asking a source that had nothing ready again, doubling up to the max */
+            static const std::chrono::milliseconds s_MinEmptyReadBackoff(1);
+            static const std::chrono::milliseconds s_MaxEmptyReadBackoff(100);
+
+            AsyncInputStreamAdapter::AsyncInputStreamAdapter(
+                const std::shared_ptr<InputStream> &source,
+                size_t bufferSize,
+                Aws::Crt::Allocator *allocator) noexcept
+                : AsyncInputStream(bufferSize, allocator), m_source(source), m_requestedBuffer(nullptr),
+                  m_stopWorker(false)
+            {
+            }
+
+            AsyncInputStreamAdapter::~AsyncInputStreamAdapter()
+            {
+                if (m_worker.joinable())
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(m_workerLock);
+                        m_stopWorker = true;
+                    }
+                    m_workerSignal.notify_all();
+                    m_worker.join();
+                }
+            }
+
+            bool AsyncInputStreamAdapter::IsValid() const noexcept
+            {
+                return m_source && m_source->IsValid() && AsyncInputStream::IsValid();
+            }
+
+            void AsyncInputStreamAdapter::ReadWorker() noexcept
+            {
+                std::unique_lock<std::mutex> lock(m_workerLock);
+                while (true)
+                {
+                    m_workerSignal.wait(lock, [this]() { return m_stopWorker || m_requestedBuffer != nullptr; });
+                    if (m_requestedBuffer == nullptr)
+                    {
+                        return;
+                    }
+
+                    ByteBuf &buffer = *m_requestedBuffer;
+                    m_requestedBuffer = nullptr;
+                    lock.unlock();
+
+                    bool endOfStream = false;
+                    int errorCode = AWS_ERROR_SUCCESS;
+                    std::chrono::milliseconds backoff = s_MinEmptyReadBackoff;
+                    while (true)
+                    {
+                        size_t before = buffer.len;
+                        if (!m_source->Read(buffer))
+                        {
+                            errorCode = aws_last_error();
+                            break;
+                        }
+
+                        /* only the end of stream flag is of interest, a successful read is not second-guessed */
+                        StreamStatus status;
+                        AWS_ZERO_STRUCT(status);
+                        m_source->GetStatus(status);
+                        endOfStream = status.is_end_of_stream;
+                        if (endOfStream || buffer.len > before)
+                        {
+                            break;
+                        }
+
+                        /* nothing ready yet, so hold the read rather than have the reader spin on an empty one */
+                        lock.lock();
+                        bool stopping = m_workerSignal.wait_for(lock, backoff, [this]() { return m_stopWorker; });
+                        lock.unlock();
+                        if (stopping)
+                        {
+                            break;
+                        }
+                        backoff = (std::min)(backoff * 2, s_MaxEmptyReadBackoff);
+                    }
+
+                    CompleteRead(endOfStream, errorCode);
+                    lock.lock();
+                }
+            }
+
+            void AsyncInputStreamAdapter::ReadAsyncImpl(ByteBuf &buffer) noexcept
+            {
+                bool started = true;
+                {
+                    std::lock_guard<std::mutex> lock(m_workerLock);
+                    if (!m_worker.joinable())
+                    {
+                        try
+                        {
+                            m_worker = std::thread(&AsyncInputStreamAdapter::ReadWorker, this);
+                        }
+                        catch (...)
+                        {
+                            started = false;
+                        }
+                    }
+
+                    if (started)
+                    {
+                        m_requestedBuffer = &buffer;
+                    }
+                }
+
+                if (!started)
+                {
+                    CompleteRead(false, AWS_ERROR_UNKNOWN);
+                    return;
+                }
+
+                m_workerSignal.notify_all();
+            }
+
+            int64_t AsyncInputStreamAdapter::GetLengthImpl() const noexcept
+            {
+                int64_t length = -1;
+                return m_source->GetLength(length) ? length : -1;
+            }
+
+            bool AsyncInputStreamAdapter::SeekAsyncImpl(OffsetType offset, StreamSeekBasis seekBasis) noexcept
+            {
+                return m_source->Seek(offset, seekBasis);
+            }
+        } // namespace Io
+    }     // namespace Crt
+} // namespace Aws
@@ -4,6 +4,8 @@
  */
 #include <aws/crt/io/Bootstrap.h>
 
+#include <aws/crt/Api.h>
+
 namespace Aws
 {
     namespace Crt
@@ -57,6 +59,8 @@ namespace Aws
                   m_callbackData(Crt::New<ClientBootstrapCallbackData>(allocator, allocator)),
                   m_enableBlockingShutdown(false)
             {
+                ApiHandle::InitializeSubsystem(ApiSubsystem::Io);
+
                 m_shutdownFuture = m_callbackData->ShutdownPromise.get_future();
 
                 aws_client_bootstrap_options options;
@@ -3,6 +3,11 @@
  * SPDX-License-Identifier: Apache-2.0.
  */
 #include <aws/crt/io/ChannelHandler.h>
+#include <aws/crt/io/ReadWindowTuner.h>
+
+#include <aws/crt/Api.h>
+
+#include <aws/common/array_list.h>
 
 #include <chrono>
 
@@ -12,6 +17,9 @@ namespace Aws
     {
         namespace Io
         {
+            static const aws_crt_statistics_category_t s_cppHandlerStatisticsCategory =
+                AWS_CRT_STATISTICS_CATEGORY_BEGIN_RANGE(AWS_CRT_CPP_PACKAGE_ID);
+
             int ChannelHandler::s_ProcessReadMessage(
                 struct aws_channel_handler *handler,
                 struct aws_channel_slot *,
@@ -19,7 +27,21 @@ namespace Aws
             {
                 auto *channelHandler = reinterpret_cast<ChannelHandler *>(handler->impl);
 
-                return channelHandler->ProcessReadMessage(message);
+                /* once processed, the message is no longer ours to look at */
+                size_t length = message->message_data.len;
+                if (channelHandler->m_readWindowTuner)
+                {
+                    channelHandler->m_readWindowTuner->OnBytesReceived(length);
+                }
+
+                if (channelHandler->ProcessReadMessage(message) != AWS_OP_SUCCESS)
+                {
+                    return AWS_OP_ERR;
+                }
+
+                ++channelHandler->m_messagesRead;
+                channelHandler->m_bytesRead += length;
+                return AWS_OP_SUCCESS;
             }
 
             int ChannelHandler::s_ProcessWriteMessage(
@@ -29,7 +51,15 @@ namespace Aws
             {
                 auto *channelHandler = reinterpret_cast<ChannelHandler *>(handler->impl);
 
-                return channelHandler->ProcessWriteMessage(message);
+                size_t length = message->message_data.len;
+                if (channelHandler->ProcessWriteMessage(message) != AWS_OP_SUCCESS)
+                {
+                    return AWS_OP_ERR;
+                }
+
+                ++channelHandler->m_messagesWritten;
+                channelHandler->m_bytesWritten += length;
+                return AWS_OP_SUCCESS;
             }
 
             int ChannelHandler::s_IncrementReadWindow(
@@ -71,6 +101,10 @@ namespace Aws
             void ChannelHandler::s_ResetStatistics(struct aws_channel_handler *handler)
             {
                 auto *channelHandler = reinterpret_cast<ChannelHandler *>(handler->impl);
+                channelHandler->m_messagesRead = 0;
+                channelHandler->m_bytesRead = 0;
+                channelHandler->m_messagesWritten = 0;
+                channelHandler->m_bytesWritten = 0;
                 channelHandler->ResetStatistics();
             }
 
@@ -100,12 +134,44 @@ namespace Aws
                 s_GatherStatistics,
             };
 
-            ChannelHandler::ChannelHandler(Allocator *allocator) : m_allocator(allocator)
+            ChannelHandler::ChannelHandler(Allocator *allocator)
+                : m_allocator(allocator), m_messagesRead(0), m_bytesRead(0), m_messagesWritten(0), m_bytesWritten(0)
             {
                 AWS_ZERO_STRUCT(m_handler);
                 m_handler.alloc = allocator;
                 m_handler.impl = reinterpret_cast<void *>(this);
                 m_handler.vtable = &ChannelHandler::s_vtable;
+                m_statisticsRecord.base.category = s_cppHandlerStatisticsCategory;
+                m_statisticsRecord.handler = this;
+            }
+
+            void ChannelHandler::GatherStatistics(struct aws_array_list *statsList)
+            {
+                struct aws_crt_statistics_base *record = &m_statisticsRecord.base;
+                aws_array_list_push_back(statsList, &record);
+            }
+
+            ChannelHandlerStatistics ChannelHandler::GetStatistics() const
+            {
+                ChannelHandlerStatistics statistics;
+                statistics.HandlerName = GetStatisticsName();
+                statistics.MessagesRead = m_messagesRead;
+                statistics.BytesRead = m_bytesRead;
+                statistics.MessagesWritten = m_messagesWritten;
+                statistics.BytesWritten = m_bytesWritten;
+                AddStatistics(statistics);
+                return statistics;
+            }
+
+            const ChannelHandler *ChannelHandler::FromStatisticsRecord(const struct aws_crt_statistics_base *record)
+            {
+                if (record == nullptr || record->category != s_cppHandlerStatisticsCategory)
+                {
+                    return nullptr;
+                }
+
+                /* base is the first member of the record */
+                return reinterpret_cast<const StatisticsRecord *>(record)->handler;
             }
 
             struct aws_channel_handler *ChannelHandler::SeatForCInterop(const std::shared_ptr<ChannelHandler> &selfRef)
@@ -139,11 +205,159 @@ namespace Aws
                            GetSlot(), message, static_cast<aws_channel_direction>(direction)) == AWS_OP_SUCCESS;
             }
 
+            struct SegmentMessageCompletion
+            {
+                Allocator *allocator;
+                Vector<std::function<void(int)>> onRelease;
+            };
+
+            static void s_OnSegmentMessageCompletion(aws_channel *, aws_io_message *, int errorCode, void *userData)
+            {
+                auto *completion = static_cast<SegmentMessageCompletion *>(userData);
+                for (auto &onRelease : completion->onRelease)
+                {
+                    if (onRelease)
+                    {
+                        onRelease(errorCode);
+                    }
+                }
+                Delete(completion, completion->allocator);
+            }
+
+            static void s_ReleaseSegments(Vector<WriteSegment> &segments, size_t first, int errorCode)
+            {
+                for (size_t i = first; i < segments.size(); ++i)
+                {
+                    if (segments[i].OnRelease)
+                    {
+                        segments[i].OnRelease(errorCode);
+                    }
+                }
+            }
+
+            bool ChannelHandler::SendSegments(Vector<WriteSegment> &&segments)
+            {
+                size_t next = 0;
+                while (next < segments.size())
+                {
+                    if (segments[next].Data.len == 0)
+                    {
+                        if (segments[next].OnRelease)
+                        {
+                            segments[next].OnRelease(AWS_ERROR_SUCCESS);
+                        }
+                        ++next;
+                        continue;
+                    }
+
+                    auto *completion = New<SegmentMessageCompletion>(m_allocator);
+                    if (completion == nullptr)
+                    {
+                        s_ReleaseSegments(segments, next, LastErrorOrUnknown());
+                        return false;
+                    }
+                    completion->allocator = m_allocator;
+
+                    struct aws_io_message *message = nullptr;
+                    if (segments[next].Data.len >= SegmentCopyThreshold)
+                    {
+                        /* the message only borrows the data: whoever writes it frees the struct, not the buffer */
+                        message = static_cast<struct aws_io_message *>(
+                            aws_mem_calloc(m_allocator, 1, sizeof(struct aws_io_message)));
+                        if (message != nullptr)
+                        {
+                            message->allocator = m_allocator;
+                            message->message_type = AWS_IO_MESSAGE_APPLICATION_DATA;
+                            message->message_data =
+                                aws_byte_buf_from_array(segments[next].Data.ptr, segments[next].Data.len);
+                            message->owning_channel = GetSlot()->channel;
+                            completion->onRelease.push_back(std::move(segments[next].OnRelease));
+                            ++next;
+                        }
+                    }
+                    else
+                    {
+                        size_t runLength = 0;
+                        for (size_t i = next; i < segments.size() && segments[i].Data.len < SegmentCopyThreshold; ++i)
+                        {
+                            runLength += segments[i].Data.len;
+                        }
+
+                        message = AcquireMessageFromPool(MessageType::ApplicationData, runLength);
+                        if (message != nullptr && message->message_data.capacity == 0)
+                        {
+                            aws_mem_release(message->allocator, message);
+                            aws_raise_error(AWS_ERROR_INVALID_STATE);
+                            message = nullptr;
+                        }
+
+                        while (message != nullptr && next < segments.size() &&
+                               segments[next].Data.len < SegmentCopyThreshold)
+                        {
+                            ByteBuf &buffer = message->message_data;
+                            size_t space = buffer.capacity - buffer.len;
+                            if (space == 0)
+                            {
+                                break;
+                            }
+
+                            /* a segment that does not fit is split, and released with the message holding its end */
+                            ByteCursor &data = segments[next].Data;
+                            ByteCursor part = aws_byte_cursor_advance(&data, data.len < space ? data.len : space);
+                            aws_byte_buf_write_from_whole_cursor(&buffer, part);
+                            if (data.len == 0)
+                            {
+                                completion->onRelease.push_back(std::move(segments[next].OnRelease));
+                                ++next;
+                            }
+                        }
+                    }
+
+                    if (message == nullptr)
+                    {
+                        int errorCode = LastErrorOrUnknown();
+                        s_OnSegmentMessageCompletion(nullptr, nullptr, errorCode, completion);
+                        s_ReleaseSegments(segments, next, errorCode);
+                        return false;
+                    }
+
+                    message->on_completion = s_OnSegmentMessageCompletion;
+                    message->user_data = completion;
+                    if (!SendMessage(message, ChannelDirection::Write))
+                    {
+                        int errorCode = LastErrorOrUnknown();
+                        aws_mem_release(message->allocator, message);
+                        s_OnSegmentMessageCompletion(nullptr, nullptr, errorCode, completion);
+                        s_ReleaseSegments(segments, next, errorCode);
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
             bool ChannelHandler::IncrementUpstreamReadWindow(size_t windowUpdateSize)
             {
                 return aws_channel_slot_increment_read_window(GetSlot(), windowUpdateSize) == AWS_OP_SUCCESS;
             }
 
+            void ChannelHandler::SetReadWindowTuner(const std::shared_ptr<ReadWindowTuner> &tuner)
+            {
+                m_readWindowTuner = tuner;
+            }
+
+            bool ChannelHandler::OnReadDataConsumed(size_t bytesConsumed)
+            {
+                size_t windowUpdateSize =
+                    m_readWindowTuner ? m_readWindowTuner->OnBytesConsumed(bytesConsumed) : bytesConsumed;
+                if (windowUpdateSize == 0)
+                {
+                    return true;
+                }
+
+                return IncrementUpstreamReadWindow(windowUpdateSize);
+            }
+
             void ChannelHandler::OnShutdownComplete(
                 ChannelDirection direction,
                 int errorCode,
@@ -0,0 +1,160 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/io/ChannelStatistics.h>
+
+#include <aws/common/array_list.h>
+#include <aws/io/statistics.h>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Io
+        {
+            struct ChannelStatisticsHandler
+            {
+                struct aws_crt_statistics_handler handler;
+                uint64_t reportIntervalMs;
+                OnChannelStatistics callback;
+            };
+
+            static void s_ProcessChannelStatistics(
+                struct aws_crt_statistics_handler *handler,
+                struct aws_crt_statistics_sample_interval *interval,
+                struct aws_array_list *statsList,
+                void *)
+            {
+                auto *statisticsHandler = static_cast<ChannelStatisticsHandler *>(handler->impl);
+
+                ChannelStatistics statistics;
+                statistics.IntervalBeginMs = interval->begin_time_ms;
+                statistics.IntervalEndMs = interval->end_time_ms;
+
+                size_t count = aws_array_list_length(statsList);
+                for (size_t i = 0; i < count; ++i)
+                {
+                    struct aws_crt_statistics_base *record = nullptr;
+                    if (aws_array_list_get_at(statsList, &record, i) || record == nullptr)
+                    {
+                        continue;
+                    }
+
+                    if (record->category == AWSCRT_STAT_CAT_SOCKET)
+                    {
+                        auto *socketRecord = reinterpret_cast<struct aws_crt_statistics_socket *>(record);
+                        SocketStatistics socket;
+                        socket.BytesRead = socketRecord->bytes_read;
+                        socket.BytesWritten = socketRecord->bytes_written;
+                        statistics.Socket = socket;
+                    }
+                    else if (record->category == AWSCRT_STAT_CAT_TLS)
+                    {
+                        auto *tlsRecord = reinterpret_cast<struct aws_crt_statistics_tls *>(record);
+                        TlsStatistics tls;
+                        tls.HandshakeStatus = static_cast<TlsNegotiationStatus>(tlsRecord->handshake_status);
+                        if (tlsRecord->handshake_end_ns > tlsRecord->handshake_start_ns)
+                        {
+                            tls.HandshakeDuration =
+                                std::chrono::nanoseconds(tlsRecord->handshake_end_ns - tlsRecord->handshake_start_ns);
+                        }
+                        statistics.Tls = tls;
+                    }
+                    else if (const ChannelHandler *channelHandler = ChannelHandler::FromStatisticsRecord(record))
+                    {
+                        statistics.Handlers.push_back(channelHandler->GetStatistics());
+                    }
+                }
+
+                statisticsHandler->callback(statistics);
+            }
+
+            static void s_DestroyChannelStatisticsHandler(struct aws_crt_statistics_handler *handler)
+            {
+                auto *statisticsHandler = static_cast<ChannelStatisticsHandler *>(handler->impl);
+                Delete(statisticsHandler, handler->allocator);
+            }
+
+            static uint64_t s_GetChannelStatisticsReportInterval(struct aws_crt_statistics_handler *handler)
+            {
+                return static_cast<ChannelStatisticsHandler *>(handler->impl)->reportIntervalMs;
+            }
+
+            static struct aws_crt_statistics_handler_vtable s_channelStatisticsHandlerVtable = {
+                s_ProcessChannelStatistics,
+                s_DestroyChannelStatisticsHandler,
+                s_GetChannelStatisticsReportInterval,
+            };
+
+            struct SetStatisticsHandlerTask
+            {
+                struct aws_channel_task task;
+                struct aws_channel *channel;
+                ChannelStatisticsHandler *statisticsHandler;
+                Allocator *allocator;
+            };
+
+            static void s_OnSetStatisticsHandlerTask(struct aws_channel_task *, void *arg, enum aws_task_status status)
+            {
+                auto *setTask = static_cast<SetStatisticsHandlerTask *>(arg);
+                if (status != AWS_TASK_STATUS_RUN_READY ||
+                    aws_channel_set_statistics_handler(setTask->channel, &setTask->statisticsHandler->handler))
+                {
+                    s_DestroyChannelStatisticsHandler(&setTask->statisticsHandler->handler);
+                }
+                Delete(setTask, setTask->allocator);
+            }
+
+            bool SetChannelStatisticsCallback(
+                struct aws_channel *channel,
+                std::chrono::milliseconds reportInterval,
+                OnChannelStatistics &&callback,
+                Allocator *allocator) noexcept
+            {
+                if (channel == nullptr || !callback || reportInterval.count() <= 0)
+                {
+                    aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                    return false;
+                }
+
+                auto *statisticsHandler = New<ChannelStatisticsHandler>(allocator);
+                if (statisticsHandler == nullptr)
+                {
+                    return false;
+                }
+
+                statisticsHandler->handler.vtable = &s_channelStatisticsHandlerVtable;
+                statisticsHandler->handler.allocator = allocator;
+                statisticsHandler->handler.impl = statisticsHandler;
+                statisticsHandler->reportIntervalMs = static_cast<uint64_t>(reportInterval.count());
+                statisticsHandler->callback = std::move(callback);
+
+                if (aws_channel_thread_is_callers_thread(channel))
+                {
+                    if (aws_channel_set_statistics_handler(channel, &statisticsHandler->handler))
+                    {
+                        s_DestroyChannelStatisticsHandler(&statisticsHandler->handler);
+                        return false;
+                    }
+                    return true;
+                }
+
+                auto *setTask = New<SetStatisticsHandlerTask>(allocator);
+                if (setTask == nullptr)
+                {
+                    s_DestroyChannelStatisticsHandler(&statisticsHandler->handler);
+                    return false;
+                }
+
+                setTask->channel = channel;
+                setTask->statisticsHandler = statisticsHandler;
+                setTask->allocator = allocator;
+                aws_channel_task_init(
+                    &setTask->task, s_OnSetStatisticsHandlerTask, setTask, "cpp-crt-set-channel-statistics-handler");
+                aws_channel_schedule_task_now(channel, &setTask->task);
+                return true;
+            }
+        } // namespace Io
+    }     // namespace Crt
+} // namespace Aws
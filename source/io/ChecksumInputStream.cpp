@@ -0,0 +1,181 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/io/ChecksumInputStream.h>
+
+#include <aws/crt/crypto/Checksum.h>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Io
+        {
+            ChecksumInputStream::ChecksumInputStream(
+                const std::shared_ptr<InputStream> &source,
+                StreamChecksumAlgorithm algorithm,
+                Aws::Crt::Allocator *allocator) noexcept
+                : InputStream(allocator), m_source(source), m_algorithm(algorithm), m_crc(0), m_bytesChecksummed(0),
+                  m_finished(false), m_lastError(AWS_ERROR_SUCCESS)
+            {
+                Restart();
+            }
+
+            void ChecksumInputStream::Restart() noexcept
+            {
+                m_crc = 0;
+                m_bytesChecksummed = 0;
+                m_finished = false;
+
+                switch (m_algorithm)
+                {
+                    case StreamChecksumAlgorithm::Md5:
+                        m_hash = Crypto::Hash::CreateMD5(m_allocator);
+                        break;
+                    case StreamChecksumAlgorithm::Sha256:
+                        m_hash = Crypto::Hash::CreateSHA256(m_allocator);
+                        break;
+                    default:
+                        return;
+                }
+
+                if (!*m_hash)
+                {
+                    m_lastError = m_hash->LastError();
+                }
+            }
+
+            bool ChecksumInputStream::IsValid() const noexcept
+            {
+                if (!m_source || !m_source->IsValid())
+                {
+                    return false;
+                }
+
+                /* a hash that has been digested is spent on purpose, not broken */
+                return !m_hash.has_value() || m_finished || *m_hash;
+            }
+
+            size_t ChecksumInputStream::GetChecksumSize() const noexcept
+            {
+                switch (m_algorithm)
+                {
+                    case StreamChecksumAlgorithm::Md5:
+                        return Crypto::MD5_DIGEST_SIZE;
+                    case StreamChecksumAlgorithm::Sha256:
+                        return Crypto::SHA256_DIGEST_SIZE;
+                    default:
+                        return CRC32_CHECKSUM_SIZE;
+                }
+            }
+
+            bool ChecksumInputStream::Digest(ByteBuf &output) noexcept
+            {
+                if (output.capacity - output.len < GetChecksumSize())
+                {
+                    m_lastError = AWS_ERROR_SHORT_BUFFER;
+                    aws_raise_error(m_lastError);
+                    return false;
+                }
+
+                if (!m_hash.has_value())
+                {
+                    aws_byte_buf_write_be32(&output, m_crc);
+                    return true;
+                }
+
+                if (m_finished)
+                {
+                    m_lastError = AWS_ERROR_INVALID_STATE;
+                    aws_raise_error(m_lastError);
+                    return false;
+                }
+
+                m_finished = true;
+                if (!m_hash->Digest(output))
+                {
+                    m_lastError = m_hash->LastError();
+                    return false;
+                }
+
+                return true;
+            }
+
+            bool ChecksumInputStream::ReadImpl(ByteBuf &buffer) noexcept
+            {
+                if (m_finished)
+                {
+                    /* these bytes would be missing from a digest that has already been handed out */
+                    m_lastError = AWS_ERROR_INVALID_STATE;
+                    aws_raise_error(m_lastError);
+                    return false;
+                }
+
+                size_t start = buffer.len;
+                if (!m_source->Read(buffer))
+                {
+                    m_lastError = aws_last_error();
+                    return false;
+                }
+
+                ByteCursor read = ByteCursorFromArray(buffer.buffer + start, buffer.len - start);
+                m_bytesChecksummed += read.len;
+
+                if (m_hash.has_value())
+                {
+                    if (!m_hash->Update(read))
+                    {
+                        m_lastError = m_hash->LastError();
+                        aws_raise_error(m_lastError);
+                        return false;
+                    }
+
+                    return true;
+                }
+
+                m_crc = m_algorithm == StreamChecksumAlgorithm::Crc32c ? Crypto::ComputeCRC32C(read, m_crc)
+                                                                       : Crypto::ComputeCRC32(read, m_crc);
+                return true;
+            }
+
+            StreamStatus ChecksumInputStream::GetStatusImpl() const noexcept
+            {
+                StreamStatus status;
+                AWS_ZERO_STRUCT(status);
+                m_source->GetStatus(status);
+                if (m_hash.has_value() && !m_finished && !*m_hash)
+                {
+                    status.is_valid = false;
+                }
+
+                return status;
+            }
+
+            int64_t ChecksumInputStream::GetLengthImpl() const noexcept
+            {
+                int64_t length = -1;
+                return m_source->GetLength(length) ? length : -1;
+            }
+
+            bool ChecksumInputStream::SeekImpl(OffsetType offset, StreamSeekBasis seekBasis) noexcept
+            {
+                if (offset != 0 || seekBasis != StreamSeekBasis::Begin)
+                {
+                    m_lastError = AWS_ERROR_STREAM_UNSEEKABLE;
+                    aws_raise_error(m_lastError);
+                    return false;
+                }
+
+                if (!m_source->Seek(offset, seekBasis))
+                {
+                    m_lastError = aws_last_error();
+                    return false;
+                }
+
+                Restart();
+                return true;
+            }
+        } // namespace Io
+    }     // namespace Crt
+} // namespace Aws
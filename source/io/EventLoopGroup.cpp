@@ -4,37 +4,194 @@
  */
 #include <aws/crt/io/EventLoopGroup.h>
 
+#include <aws/crt/Api.h>
+
+#include <aws/common/system_info.h>
+
+#include <atomic>
+
 namespace Aws
 {
     namespace Crt
     {
         namespace Io
         {
+            struct EventLoopTaskNode
+            {
+                std::function<void(TaskStatus)> fn;
+                EventLoopTaskNode *next;
+            };
+
+            /* Producers push onto an atomic stack; whoever pushes onto an empty one wakes the loop, which takes the
+             * whole stack at once and runs it oldest first. */
+            struct EventLoopTaskQueue
+            {
+                aws_task drainTask;
+                aws_event_loop *eventLoop;
+                std::atomic<EventLoopTaskNode *> head;
+                Allocator *allocator;
+            };
+
+            struct EventLoopGroupTaskQueues
+            {
+                Allocator *allocator;
+                aws_shutdown_callback_options shutdownOptions;
+                Vector<EventLoopTaskQueue *> queues;
+                std::atomic<size_t> nextLoop;
+                /* a group that fails to start may or may not call back, so until it has started the constructor
+                 * frees the queues itself */
+                bool started;
+            };
+
+            static void s_RunTaskBatch(EventLoopTaskQueue *queue, TaskStatus status)
+            {
+                EventLoopTaskNode *node = queue->head.exchange(nullptr);
+
+                EventLoopTaskNode *oldestFirst = nullptr;
+                while (node != nullptr)
+                {
+                    EventLoopTaskNode *next = node->next;
+                    node->next = oldestFirst;
+                    oldestFirst = node;
+                    node = next;
+                }
+
+                while (oldestFirst != nullptr)
+                {
+                    EventLoopTaskNode *next = oldestFirst->next;
+                    oldestFirst->fn(status);
+                    Delete(oldestFirst, queue->allocator);
+                    oldestFirst = next;
+                }
+            }
+
+            static void s_onTaskBatch(aws_task *, void *arg, aws_task_status status)
+            {
+                s_RunTaskBatch(
+                    static_cast<EventLoopTaskQueue *>(arg),
+                    status == AWS_TASK_STATUS_RUN_READY ? TaskStatus::RunReady : TaskStatus::Canceled);
+            }
+
+            static void s_onEventLoopGroupShutdown(void *userData)
+            {
+                auto *taskQueues = static_cast<EventLoopGroupTaskQueues *>(userData);
+                if (!taskQueues->started)
+                {
+                    return;
+                }
+
+                for (auto *queue : taskQueues->queues)
+                {
+                    s_RunTaskBatch(queue, TaskStatus::Canceled);
+                    Delete(queue, taskQueues->allocator);
+                }
+                Delete(taskQueues, taskQueues->allocator);
+            }
+
+            static EventLoopGroupTaskQueues *s_NewTaskQueues(Allocator *allocator)
+            {
+                auto *taskQueues = New<EventLoopGroupTaskQueues>(allocator);
+                if (taskQueues != nullptr)
+                {
+                    taskQueues->allocator = allocator;
+                    taskQueues->shutdownOptions.shutdown_callback_fn = s_onEventLoopGroupShutdown;
+                    taskQueues->shutdownOptions.shutdown_callback_user_data = taskQueues;
+                    taskQueues->nextLoop = 0;
+                    taskQueues->started = false;
+                }
+                return taskQueues;
+            }
+
             EventLoopGroup::EventLoopGroup(uint16_t threadCount, Allocator *allocator) noexcept
-                : m_eventLoopGroup(nullptr), m_lastError(AWS_ERROR_SUCCESS)
+                : EventLoopGroup(threadCount, nullptr, allocator)
+            {
+            }
+
+            EventLoopGroup::EventLoopGroup(
+                uint16_t threadCount,
+                const uint16_t *cpuGroup,
+                Allocator *allocator) noexcept
+                : m_eventLoopGroup(nullptr), m_taskQueues(s_NewTaskQueues(allocator)), m_lastError(AWS_ERROR_SUCCESS)
+            {
+                ApiHandle::InitializeSubsystem(ApiSubsystem::Io);
+
+                const aws_shutdown_callback_options *shutdownOptions =
+                    m_taskQueues != nullptr ? &m_taskQueues->shutdownOptions : nullptr;
+                if (cpuGroup != nullptr)
+                {
+                    m_eventLoopGroup = aws_event_loop_group_new_default_pinned_to_cpu_group(
+                        allocator, threadCount, *cpuGroup, shutdownOptions);
+                }
+                else
+                {
+                    m_eventLoopGroup = aws_event_loop_group_new_default(allocator, threadCount, shutdownOptions);
+                }
+                InitTaskQueues();
+            }
+
+            EventLoopGroup EventLoopGroup::PinnedToCpuGroup(
+                uint16_t cpuGroup,
+                uint16_t threadCount,
+                Allocator *allocator) noexcept
+            {
+                return EventLoopGroup(threadCount, &cpuGroup, allocator);
+            }
+
+            void EventLoopGroup::InitTaskQueues() noexcept
             {
-                m_eventLoopGroup = aws_event_loop_group_new_default(allocator, threadCount, NULL);
                 if (m_eventLoopGroup == nullptr)
                 {
                     m_lastError = aws_last_error();
+                    if (m_taskQueues != nullptr)
+                    {
+                        Delete(m_taskQueues, m_taskQueues->allocator);
+                        m_taskQueues = nullptr;
+                    }
+                    return;
+                }
+
+                if (m_taskQueues == nullptr)
+                {
+                    return;
+                }
+
+                m_taskQueues->started = true;
+                size_t loopCount = aws_event_loop_group_get_loop_count(m_eventLoopGroup);
+                m_taskQueues->queues.reserve(loopCount);
+                for (size_t i = 0; i < loopCount; ++i)
+                {
+                    auto *queue = New<EventLoopTaskQueue>(m_taskQueues->allocator);
+                    if (queue == nullptr)
+                    {
+                        break;
+                    }
+                    queue->eventLoop = aws_event_loop_group_get_loop_at(m_eventLoopGroup, i);
+                    queue->head = nullptr;
+                    queue->allocator = m_taskQueues->allocator;
+                    aws_task_init(&queue->drainTask, s_onTaskBatch, queue, "cpp-crt-event-loop-group-task-batch");
+                    m_taskQueues->queues.push_back(queue);
                 }
             }
 
             EventLoopGroup::~EventLoopGroup() { aws_event_loop_group_release(m_eventLoopGroup); }
 
             EventLoopGroup::EventLoopGroup(EventLoopGroup &&toMove) noexcept
-                : m_eventLoopGroup(toMove.m_eventLoopGroup), m_lastError(toMove.m_lastError)
+                : m_eventLoopGroup(toMove.m_eventLoopGroup), m_taskQueues(toMove.m_taskQueues),
+                  m_lastError(toMove.m_lastError)
             {
                 toMove.m_lastError = AWS_ERROR_UNKNOWN;
                 toMove.m_eventLoopGroup = nullptr;
+                toMove.m_taskQueues = nullptr;
             }
 
             EventLoopGroup &EventLoopGroup::operator=(EventLoopGroup &&toMove) noexcept
             {
                 m_eventLoopGroup = toMove.m_eventLoopGroup;
+                m_taskQueues = toMove.m_taskQueues;
                 m_lastError = toMove.m_lastError;
                 toMove.m_lastError = AWS_ERROR_UNKNOWN;
                 toMove.m_eventLoopGroup = nullptr;
+                toMove.m_taskQueues = nullptr;
 
                 return *this;
             }
@@ -43,6 +200,87 @@ namespace Aws
 
             EventLoopGroup::operator bool() const { return m_lastError == AWS_ERROR_SUCCESS; }
 
+            uint16_t EventLoopGroup::GetCpuGroupCount() noexcept { return aws_get_cpu_group_count(); }
+
+            size_t EventLoopGroup::GetCpuCountForGroup(uint16_t cpuGroup) noexcept
+            {
+                return aws_get_cpu_count_for_group(cpuGroup);
+            }
+
+            size_t EventLoopGroup::GetLoopCount() noexcept
+            {
+                if (*this)
+                {
+                    return aws_event_loop_group_get_loop_count(m_eventLoopGroup);
+                }
+
+                return 0;
+            }
+
+            aws_event_loop *EventLoopGroup::GetLoopAt(size_t index) noexcept
+            {
+                if (index < GetLoopCount())
+                {
+                    return aws_event_loop_group_get_loop_at(m_eventLoopGroup, index);
+                }
+
+                return nullptr;
+            }
+
+            aws_event_loop *EventLoopGroup::GetNextLoop() noexcept
+            {
+                if (*this)
+                {
+                    return aws_event_loop_group_get_next_loop(m_eventLoopGroup);
+                }
+
+                return nullptr;
+            }
+
+            bool EventLoopGroup::Schedule(std::function<void(TaskStatus)> &&task, size_t loopIndex) noexcept
+            {
+                if (!*this || m_taskQueues == nullptr || loopIndex >= m_taskQueues->queues.size())
+                {
+                    aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                    return false;
+                }
+
+                EventLoopTaskQueue *queue = m_taskQueues->queues[loopIndex];
+                auto *node = New<EventLoopTaskNode>(queue->allocator);
+                if (node == nullptr)
+                {
+                    return false;
+                }
+                node->fn = std::move(task);
+
+                EventLoopTaskNode *head = queue->head.load(std::memory_order_relaxed);
+                do
+                {
+                    node->next = head;
+                } while (!queue->head.compare_exchange_weak(head, node, std::memory_order_release));
+
+                /* the batch task is only ever scheduled by whoever finds the stack empty, and the loop empties it
+                 * after that schedule has been taken off its queue, so it is never scheduled twice at once */
+                if (head == nullptr)
+                {
+                    aws_event_loop_schedule_task_now(queue->eventLoop, &queue->drainTask);
+                }
+
+                return true;
+            }
+
+            bool EventLoopGroup::Schedule(std::function<void(TaskStatus)> &&task) noexcept
+            {
+                if (!*this || m_taskQueues == nullptr || m_taskQueues->queues.empty())
+                {
+                    aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                    return false;
+                }
+
+                size_t loopIndex = m_taskQueues->nextLoop.fetch_add(1) % m_taskQueues->queues.size();
+                return Schedule(std::move(task), loopIndex);
+            }
+
             aws_event_loop_group *EventLoopGroup::GetUnderlyingHandle() noexcept
             {
                 if (*this)
@@ -0,0 +1,217 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/io/EventLoopMonitor.h>
+
+#include <aws/crt/Api.h>
+
+#include <mutex>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Io
+        {
+            struct EventLoopMonitorState
+            {
+                EventLoopMonitorState(aws_event_loop_group *group, uint64_t intervalNs, Allocator *allocator)
+                    : allocator(allocator), elGroup(aws_event_loop_group_acquire(group)), probeIntervalNs(intervalNs)
+                {
+                }
+
+                ~EventLoopMonitorState() { aws_event_loop_group_release(elGroup); }
+
+                Allocator *allocator;
+                aws_event_loop_group *elGroup;
+                uint64_t probeIntervalNs;
+                std::mutex lock;
+                Vector<EventLoopStatistics> loops;
+            };
+
+            struct EventLoopProbeTask
+            {
+                aws_task task;
+                std::weak_ptr<EventLoopMonitorState> state;
+                aws_event_loop *eventLoop;
+                size_t loopIndex;
+                uint64_t dueAtNs;
+                Allocator *allocator;
+            };
+
+            static bool s_ScheduleProbe(
+                const std::shared_ptr<EventLoopMonitorState> &state,
+                aws_event_loop *eventLoop,
+                size_t loopIndex);
+
+            static size_t s_LatencyBucket(uint64_t latencyNs)
+            {
+                uint64_t latencyUs = latencyNs / 1000;
+                size_t bucket = 0;
+                while (latencyUs >= 2 && bucket + 1 < EventLoopStatistics::LatencyBucketCount)
+                {
+                    latencyUs >>= 1;
+                    ++bucket;
+                }
+                return bucket;
+            }
+
+            static void s_onProbeTask(aws_task *, void *arg, aws_task_status status)
+            {
+                auto *probeTask = static_cast<EventLoopProbeTask *>(arg);
+                auto state = probeTask->state.lock();
+                aws_event_loop *eventLoop = probeTask->eventLoop;
+                size_t loopIndex = probeTask->loopIndex;
+                uint64_t dueAtNs = probeTask->dueAtNs;
+                Delete(probeTask, probeTask->allocator);
+
+                uint64_t now = 0;
+                if (!state || status != AWS_TASK_STATUS_RUN_READY || aws_event_loop_current_clock_time(eventLoop, &now))
+                {
+                    return;
+                }
+
+                uint64_t latencyNs = now > dueAtNs ? now - dueAtNs : 0;
+                {
+                    std::lock_guard<std::mutex> lock(state->lock);
+                    EventLoopStatistics &statistics = state->loops[loopIndex];
+                    ++statistics.Probes;
+                    statistics.LastLatency = std::chrono::nanoseconds(latencyNs);
+                    statistics.TotalLatency += statistics.LastLatency;
+                    if (statistics.LastLatency > statistics.MaxLatency)
+                    {
+                        statistics.MaxLatency = statistics.LastLatency;
+                    }
+                    ++statistics.LatencyHistogram[s_LatencyBucket(latencyNs)];
+                }
+
+                s_ScheduleProbe(state, eventLoop, loopIndex);
+            }
+
+            static bool s_ScheduleProbe(
+                const std::shared_ptr<EventLoopMonitorState> &state,
+                aws_event_loop *eventLoop,
+                size_t loopIndex)
+            {
+                uint64_t now = 0;
+                if (aws_event_loop_current_clock_time(eventLoop, &now))
+                {
+                    return false;
+                }
+
+                auto *probeTask = New<EventLoopProbeTask>(state->allocator);
+                if (probeTask == nullptr)
+                {
+                    return false;
+                }
+
+                probeTask->state = state;
+                probeTask->eventLoop = eventLoop;
+                probeTask->loopIndex = loopIndex;
+                probeTask->dueAtNs = now + state->probeIntervalNs;
+                probeTask->allocator = state->allocator;
+                aws_task_init(&probeTask->task, s_onProbeTask, probeTask, "cpp-crt-event-loop-monitor-probe");
+                aws_event_loop_schedule_task_future(eventLoop, &probeTask->task, probeTask->dueAtNs);
+                return true;
+            }
+
+            EventLoopMonitor::EventLoopMonitor(
+                EventLoopGroup &eventLoopGroup,
+                std::chrono::milliseconds probeInterval,
+                Allocator *allocator) noexcept
+                : m_lastError(AWS_ERROR_SUCCESS)
+            {
+                aws_event_loop_group *elGroup = eventLoopGroup.GetUnderlyingHandle();
+                if (elGroup == nullptr || probeInterval.count() <= 0)
+                {
+                    m_lastError = AWS_ERROR_INVALID_ARGUMENT;
+                    return;
+                }
+
+                uint64_t intervalNs = static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(probeInterval).count());
+                auto state = MakeShared<EventLoopMonitorState>(allocator, elGroup, intervalNs, allocator);
+                if (!state)
+                {
+                    m_lastError = LastErrorOrUnknown();
+                    return;
+                }
+
+                size_t loopCount = aws_event_loop_group_get_loop_count(elGroup);
+                state->loops.resize(loopCount);
+                for (size_t i = 0; i < loopCount; ++i)
+                {
+                    if (!s_ScheduleProbe(state, aws_event_loop_group_get_loop_at(elGroup, i), i))
+                    {
+                        m_lastError = LastErrorOrUnknown();
+                        return;
+                    }
+                }
+
+                m_state = std::move(state);
+            }
+
+            /* probes still queued find the state gone, free themselves and stop rescheduling */
+            EventLoopMonitor::~EventLoopMonitor() = default;
+
+            Vector<EventLoopStatistics> EventLoopMonitor::GetStatistics() const noexcept
+            {
+                Vector<EventLoopStatistics> statistics;
+                if (!m_state)
+                {
+                    return statistics;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(m_state->lock);
+                    statistics = m_state->loops;
+                }
+
+                for (size_t i = 0; i < statistics.size(); ++i)
+                {
+                    statistics[i].LoadFactor =
+                        aws_event_loop_get_load_factor(aws_event_loop_group_get_loop_at(m_state->elGroup, i));
+                }
+
+                return statistics;
+            }
+
+            EventLoopStatistics EventLoopMonitor::GetStatistics(size_t loopIndex) const noexcept
+            {
+                EventLoopStatistics statistics;
+                if (!m_state)
+                {
+                    return statistics;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(m_state->lock);
+                    if (loopIndex >= m_state->loops.size())
+                    {
+                        return statistics;
+                    }
+                    statistics = m_state->loops[loopIndex];
+                }
+
+                statistics.LoadFactor =
+                    aws_event_loop_get_load_factor(aws_event_loop_group_get_loop_at(m_state->elGroup, loopIndex));
+                return statistics;
+            }
+
+            void EventLoopMonitor::Reset() noexcept
+            {
+                if (!m_state)
+                {
+                    return;
+                }
+
+                std::lock_guard<std::mutex> lock(m_state->lock);
+                for (auto &statistics : m_state->loops)
+                {
+                    statistics = EventLoopStatistics();
+                }
+            }
+        } // namespace Io
+    }     // namespace Crt
+} // namespace Aws
@@ -0,0 +1,502 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/io/Stream.h>
+
+#ifdef _WIN32
+#    ifndef WIN32_LEAN_AND_MEAN
+#        define WIN32_LEAN_AND_MEAN
+#    endif
+#    include <windows.h>
+#else
+#    include <cerrno>
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+#include <cstring>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Io
+        {
+#ifdef _WIN32
+            static int s_TranslateFileError(DWORD error) noexcept
+            {
+                switch (error)
+                {
+                    case ERROR_FILE_NOT_FOUND:
+                    case ERROR_PATH_NOT_FOUND:
+                    case ERROR_INVALID_NAME:
+                        return AWS_ERROR_FILE_INVALID_PATH;
+                    case ERROR_ACCESS_DENIED:
+                    case ERROR_SHARING_VIOLATION:
+                        return AWS_ERROR_NO_PERMISSION;
+                    case ERROR_TOO_MANY_OPEN_FILES:
+                        return AWS_ERROR_MAX_FDS_EXCEEDED;
+                    case ERROR_NOT_ENOUGH_MEMORY:
+                    case ERROR_OUTOFMEMORY:
+                        return AWS_ERROR_OOM;
+                    default:
+                        return AWS_IO_STREAM_READ_FAILED;
+                }
+            }
+
+            static HANDLE s_OpenFile(const char *filePath, int64_t &outLength) noexcept
+            {
+                HANDLE file = CreateFileA(
+                    filePath,
+                    GENERIC_READ,
+                    FILE_SHARE_READ,
+                    nullptr,
+                    OPEN_EXISTING,
+                    FILE_ATTRIBUTE_NORMAL,
+                    nullptr);
+                if (file == INVALID_HANDLE_VALUE)
+                {
+                    aws_raise_error(s_TranslateFileError(GetLastError()));
+                    return INVALID_HANDLE_VALUE;
+                }
+
+                LARGE_INTEGER size;
+                if (!GetFileSizeEx(file, &size))
+                {
+                    aws_raise_error(s_TranslateFileError(GetLastError()));
+                    CloseHandle(file);
+                    return INVALID_HANDLE_VALUE;
+                }
+
+                outLength = static_cast<int64_t>(size.QuadPart);
+                return file;
+            }
+#else
+            static int s_TranslateFileError(int error) noexcept
+            {
+                switch (error)
+                {
+                    case ENOENT:
+                    case ENOTDIR:
+                    case ENAMETOOLONG:
+                    case EISDIR:
+                        return AWS_ERROR_FILE_INVALID_PATH;
+                    case EACCES:
+                    case EPERM:
+                        return AWS_ERROR_NO_PERMISSION;
+                    case EMFILE:
+                    case ENFILE:
+                        return AWS_ERROR_MAX_FDS_EXCEEDED;
+                    case ENOMEM:
+                        return AWS_ERROR_OOM;
+                    default:
+                        return AWS_IO_STREAM_READ_FAILED;
+                }
+            }
+
+            static int s_OpenFile(const char *filePath, int64_t &outLength) noexcept
+            {
+                int flags = O_RDONLY;
+#    ifdef O_CLOEXEC
+                flags |= O_CLOEXEC;
+#    endif
+                int file = open(filePath, flags);
+                if (file < 0)
+                {
+                    aws_raise_error(s_TranslateFileError(errno));
+                    return -1;
+                }
+
+                struct stat fileStat;
+                int statError = fstat(file, &fileStat) == 0 ? 0 : errno;
+                if (statError == 0 && !S_ISREG(fileStat.st_mode))
+                {
+                    /* pipes and devices have no length to seek against */
+                    statError = S_ISDIR(fileStat.st_mode) ? EISDIR : EINVAL;
+                }
+
+                if (statError != 0)
+                {
+                    aws_raise_error(s_TranslateFileError(statError));
+                    close(file);
+                    return -1;
+                }
+
+                outLength = static_cast<int64_t>(fileStat.st_size);
+                return file;
+            }
+#endif
+
+            FileInputStream::FileInputStream(const char *filePath, Aws::Crt::Allocator *allocator) noexcept
+                : InputStream(allocator), m_length(0), m_position(0), m_readFailed(false),
+                  m_lastError(AWS_ERROR_SUCCESS)
+            {
+                m_file = s_OpenFile(filePath, m_length);
+                if (!IsValid())
+                {
+                    m_lastError = aws_last_error();
+                }
+            }
+
+            FileInputStream::~FileInputStream()
+            {
+                if (IsValid())
+                {
+#ifdef _WIN32
+                    CloseHandle(m_file);
+#else
+                    close(m_file);
+#endif
+                }
+            }
+
+            bool FileInputStream::IsValid() const noexcept
+            {
+#ifdef _WIN32
+                return m_file != INVALID_HANDLE_VALUE;
+#else
+                return m_file >= 0;
+#endif
+            }
+
+            /* Clamps a positional read of buffer's free space at offset to a source of the given length. */
+            static size_t s_PositionalReadSize(const ByteBuf &buffer, int64_t offset, int64_t length) noexcept
+            {
+                if (offset < 0 || offset >= length)
+                {
+                    return 0;
+                }
+
+                size_t toRead = buffer.capacity - buffer.len;
+                if (static_cast<uint64_t>(length - offset) < toRead)
+                {
+                    toRead = static_cast<size_t>(length - offset);
+                }
+
+                return toRead;
+            }
+
+            bool FileInputStream::ReadAt(int64_t offset, ByteBuf &buffer) const noexcept
+            {
+                if (!IsValid())
+                {
+                    aws_raise_error(AWS_IO_STREAM_READ_FAILED);
+                    return false;
+                }
+
+                size_t toRead = s_PositionalReadSize(buffer, offset, m_length);
+                if (toRead == 0)
+                {
+                    return true;
+                }
+
+#ifdef _WIN32
+                if (toRead > MAXDWORD)
+                {
+                    toRead = MAXDWORD;
+                }
+
+                OVERLAPPED overlapped;
+                AWS_ZERO_STRUCT(overlapped);
+                overlapped.Offset = static_cast<DWORD>(offset & 0xFFFFFFFF);
+                overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+                DWORD bytesRead = 0;
+                BOOL readSucceeded =
+                    ReadFile(m_file, buffer.buffer + buffer.len, static_cast<DWORD>(toRead), &bytesRead, &overlapped);
+                if (!readSucceeded && GetLastError() != ERROR_HANDLE_EOF)
+                {
+                    aws_raise_error(AWS_IO_STREAM_READ_FAILED);
+                    return false;
+                }
+#else
+                ssize_t bytesRead = -1;
+                do
+                {
+                    bytesRead = pread(m_file, buffer.buffer + buffer.len, toRead, static_cast<off_t>(offset));
+                } while (bytesRead < 0 && errno == EINTR);
+
+                if (bytesRead < 0)
+                {
+                    aws_raise_error(AWS_IO_STREAM_READ_FAILED);
+                    return false;
+                }
+#endif
+
+                if (bytesRead == 0)
+                {
+                    /* the file shrank since it was opened */
+                    aws_raise_error(AWS_IO_STREAM_READ_FAILED);
+                    return false;
+                }
+
+                buffer.len += static_cast<size_t>(bytesRead);
+                return true;
+            }
+
+            int64_t FileInputStream::GetSourceLength() const noexcept { return m_length; }
+
+            bool FileInputStream::ReadImpl(ByteBuf &buffer) noexcept
+            {
+                size_t previousLength = buffer.len;
+                if (!ReadAt(m_position, buffer))
+                {
+                    m_readFailed = true;
+                    return false;
+                }
+
+                m_position += static_cast<int64_t>(buffer.len - previousLength);
+                return true;
+            }
+
+            StreamStatus FileInputStream::GetStatusImpl() const noexcept
+            {
+                StreamStatus status;
+                status.is_end_of_stream = m_position >= m_length;
+                status.is_valid = IsValid() && !m_readFailed;
+
+                return status;
+            }
+
+            int64_t FileInputStream::GetLengthImpl() const noexcept { return IsValid() ? m_length : -1; }
+
+            bool FileInputStream::SeekImpl(OffsetType offset, StreamSeekBasis seekBasis) noexcept
+            {
+                if (!ResolveSeekPosition(offset, seekBasis, m_length, m_position))
+                {
+                    return false;
+                }
+
+                m_readFailed = false;
+                return true;
+            }
+
+            MmapFileInputStream::MmapFileInputStream(const char *filePath, Aws::Crt::Allocator *allocator) noexcept
+                : InputStream(allocator), m_data(nullptr), m_length(0), m_position(0), m_valid(false),
+                  m_lastError(AWS_ERROR_SUCCESS)
+            {
+#ifdef _WIN32
+                HANDLE file = s_OpenFile(filePath, m_length);
+                if (file == INVALID_HANDLE_VALUE)
+                {
+                    m_lastError = aws_last_error();
+                    return;
+                }
+
+                /* an empty file cannot be mapped, but it is a perfectly good empty stream */
+                if (m_length > 0)
+                {
+                    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                    if (mapping)
+                    {
+                        /* the view keeps the file mapped on its own, neither handle is needed past this point */
+                        m_data = static_cast<const uint8_t *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                        CloseHandle(mapping);
+                    }
+
+                    if (!m_data)
+                    {
+                        m_lastError = s_TranslateFileError(GetLastError());
+                        aws_raise_error(m_lastError);
+                        CloseHandle(file);
+                        return;
+                    }
+                }
+
+                CloseHandle(file);
+#else
+                int file = s_OpenFile(filePath, m_length);
+                if (file < 0)
+                {
+                    m_lastError = aws_last_error();
+                    return;
+                }
+
+                if (m_length > 0)
+                {
+                    void *mapping = mmap(nullptr, static_cast<size_t>(m_length), PROT_READ, MAP_PRIVATE, file, 0);
+                    if (mapping == MAP_FAILED)
+                    {
+                        m_lastError = s_TranslateFileError(errno);
+                        aws_raise_error(m_lastError);
+                        close(file);
+                        return;
+                    }
+
+                    m_data = static_cast<const uint8_t *>(mapping);
+                }
+
+                /* the mapping keeps the file alive on its own */
+                close(file);
+#endif
+                m_valid = true;
+            }
+
+            MmapFileInputStream::~MmapFileInputStream()
+            {
+                if (m_data)
+                {
+#ifdef _WIN32
+                    UnmapViewOfFile(m_data);
+#else
+                    munmap(const_cast<uint8_t *>(m_data), static_cast<size_t>(m_length));
+#endif
+                }
+            }
+
+            bool MmapFileInputStream::IsValid() const noexcept { return m_valid; }
+
+            ByteCursor MmapFileInputStream::GetContents() const noexcept
+            {
+                return aws_byte_cursor_from_array(m_data, static_cast<size_t>(m_length));
+            }
+
+            bool MmapFileInputStream::ReadAt(int64_t offset, ByteBuf &buffer) const noexcept
+            {
+                if (!m_valid)
+                {
+                    aws_raise_error(AWS_IO_STREAM_READ_FAILED);
+                    return false;
+                }
+
+                size_t toRead = s_PositionalReadSize(buffer, offset, m_length);
+                if (toRead > 0)
+                {
+                    memcpy(buffer.buffer + buffer.len, m_data + offset, toRead);
+                    buffer.len += toRead;
+                }
+
+                return true;
+            }
+
+            int64_t MmapFileInputStream::GetSourceLength() const noexcept { return m_length; }
+
+            bool MmapFileInputStream::ReadImpl(ByteBuf &buffer) noexcept
+            {
+                size_t previousLength = buffer.len;
+                if (!ReadAt(m_position, buffer))
+                {
+                    return false;
+                }
+
+                m_position += static_cast<int64_t>(buffer.len - previousLength);
+                return true;
+            }
+
+            StreamStatus MmapFileInputStream::GetStatusImpl() const noexcept
+            {
+                StreamStatus status;
+                status.is_end_of_stream = m_position >= m_length;
+                status.is_valid = m_valid;
+
+                return status;
+            }
+
+            int64_t MmapFileInputStream::GetLengthImpl() const noexcept { return m_valid ? m_length : -1; }
+
+            bool MmapFileInputStream::SeekImpl(OffsetType offset, StreamSeekBasis seekBasis) noexcept
+            {
+                return ResolveSeekPosition(offset, seekBasis, m_length, m_position);
+            }
+
+            RangeInputStream::RangeInputStream(
+                const std::shared_ptr<PositionalInputSource> &source,
+                int64_t offset,
+                int64_t length,
+                Aws::Crt::Allocator *allocator) noexcept
+                : InputStream(allocator), m_source(source), m_offset(offset), m_length(length), m_position(0),
+                  m_readFailed(false), m_lastError(AWS_ERROR_SUCCESS)
+            {
+                if (!m_source || offset < 0 || length < 0 || offset > m_source->GetSourceLength() - length)
+                {
+                    m_lastError = AWS_ERROR_INVALID_ARGUMENT;
+                    aws_raise_error(m_lastError);
+                }
+            }
+
+            bool RangeInputStream::Split(
+                const std::shared_ptr<PositionalInputSource> &source,
+                int64_t partSize,
+                Vector<std::shared_ptr<RangeInputStream>> &outParts,
+                Aws::Crt::Allocator *allocator) noexcept
+            {
+                if (!source || partSize <= 0)
+                {
+                    aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                    return false;
+                }
+
+                int64_t sourceLength = source->GetSourceLength();
+                int64_t offset = 0;
+                do
+                {
+                    int64_t length = sourceLength - offset < partSize ? sourceLength - offset : partSize;
+                    auto part = MakeShared<RangeInputStream>(allocator, source, offset, length, allocator);
+                    if (!part)
+                    {
+                        return false;
+                    }
+
+                    outParts.push_back(std::move(part));
+                    offset += length;
+                } while (offset < sourceLength);
+
+                return true;
+            }
+
+            bool RangeInputStream::IsValid() const noexcept { return m_lastError == AWS_ERROR_SUCCESS; }
+
+            bool RangeInputStream::ReadImpl(ByteBuf &buffer) noexcept
+            {
+                if (!IsValid())
+                {
+                    aws_raise_error(AWS_IO_STREAM_READ_FAILED);
+                    return false;
+                }
+
+                /* let the source fill the buffer up to the end of the range and no further */
+                ByteBuf window = buffer;
+                size_t remaining = static_cast<size_t>(m_length - m_position);
+                if (window.capacity - window.len > remaining)
+                {
+                    window.capacity = window.len + remaining;
+                }
+
+                if (!m_source->ReadAt(m_offset + m_position, window))
+                {
+                    m_readFailed = true;
+                    return false;
+                }
+
+                m_position += static_cast<int64_t>(window.len - buffer.len);
+                buffer.len = window.len;
+                return true;
+            }
+
+            StreamStatus RangeInputStream::GetStatusImpl() const noexcept
+            {
+                StreamStatus status;
+                status.is_end_of_stream = m_position >= m_length;
+                status.is_valid = IsValid() && !m_readFailed;
+
+                return status;
+            }
+
+            int64_t RangeInputStream::GetLengthImpl() const noexcept { return IsValid() ? m_length : -1; }
+
+            bool RangeInputStream::SeekImpl(OffsetType offset, StreamSeekBasis seekBasis) noexcept
+            {
+                if (!ResolveSeekPosition(offset, seekBasis, m_length, m_position))
+                {
+                    return false;
+                }
+
+                m_readFailed = false;
+                return true;
+            }
+        } // namespace Io
+    }     // namespace Crt
+} // namespace Aws
@@ -0,0 +1,166 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/io/HostAddressSelector.h>
+
+#include <aws/common/string.h>
+
+#include <algorithm>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Io
+        {
+            static const uint64_t s_maxPenaltyDoublings = 5;
+
+            static String s_AddressText(const HostAddress &address)
+            {
+                if (address.address == nullptr)
+                {
+                    return String();
+                }
+                return String(aws_string_c_str(address.address), address.address->len);
+            }
+
+            HostAddressSelector::HostAddressSelector(
+                HostResolver *resolver,
+                std::chrono::milliseconds failurePenalty) noexcept
+                : m_resolver(resolver), m_failurePenalty(failurePenalty)
+            {
+            }
+
+            void HostAddressSelector::RecordConnectSuccess(
+                const HostAddress &address,
+                std::chrono::nanoseconds latency) noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                HostAddressStatistics &statistics = m_addresses[s_AddressText(address)].statistics;
+                ++statistics.ConnectAttempts;
+                statistics.ConsecutiveFailures = 0;
+                if (statistics.SmoothedConnectLatency.count() == 0)
+                {
+                    statistics.SmoothedConnectLatency = latency;
+                }
+                else
+                {
+                    statistics.SmoothedConnectLatency = (statistics.SmoothedConnectLatency * 7 + latency) / 8;
+                }
+            }
+
+            void HostAddressSelector::RecordConnectFailure(const HostAddress &address) noexcept
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_lock);
+                    AddressEntry &entry = m_addresses[s_AddressText(address)];
+                    ++entry.statistics.ConnectAttempts;
+                    ++entry.statistics.ConnectFailures;
+                    ++entry.statistics.ConsecutiveFailures;
+                    entry.lastFailure = std::chrono::steady_clock::now();
+                }
+
+                if (m_resolver != nullptr && m_resolver->GetUnderlyingHandle() != nullptr)
+                {
+                    HostAddress failedAddress = address;
+                    aws_host_resolver_record_connection_failure(m_resolver->GetUnderlyingHandle(), &failedAddress);
+                }
+            }
+
+            Vector<HostAddress> HostAddressSelector::Order(const Vector<HostAddress> &addresses) const noexcept
+            {
+                enum class Health
+                {
+                    Measured,
+                    Untried,
+                    Penalized,
+                };
+
+                struct RankedAddress
+                {
+                    Health health;
+                    uint64_t key;
+                    const HostAddress *address;
+                };
+
+                Vector<RankedAddress> ranked;
+                ranked.reserve(addresses.size());
+                {
+                    auto now = std::chrono::steady_clock::now();
+                    std::lock_guard<std::mutex> lock(m_lock);
+                    for (const auto &address : addresses)
+                    {
+                        RankedAddress rankedAddress{Health::Untried, 0, &address};
+                        auto iter = m_addresses.find(s_AddressText(address));
+                        if (iter != m_addresses.end())
+                        {
+                            const HostAddressStatistics &statistics = iter->second.statistics;
+                            uint64_t doublings = std::min(statistics.ConsecutiveFailures, s_maxPenaltyDoublings + 1);
+                            if (statistics.ConsecutiveFailures > 0 &&
+                                now - iter->second.lastFailure < m_failurePenalty * (1 << (doublings - 1)))
+                            {
+                                rankedAddress.health = Health::Penalized;
+                                rankedAddress.key = statistics.ConsecutiveFailures;
+                            }
+                            else if (statistics.SmoothedConnectLatency.count() > 0)
+                            {
+                                rankedAddress.health = Health::Measured;
+                                rankedAddress.key = static_cast<uint64_t>(statistics.SmoothedConnectLatency.count());
+                            }
+                        }
+                        ranked.push_back(rankedAddress);
+                    }
+                }
+
+                /* the resolver's order breaks ties */
+                std::stable_sort(
+                    ranked.begin(), ranked.end(), [](const RankedAddress &lhs, const RankedAddress &rhs) {
+                        if (lhs.health != rhs.health)
+                        {
+                            return lhs.health < rhs.health;
+                        }
+                        return lhs.key < rhs.key;
+                    });
+
+                Vector<const HostAddress *> families[2];
+                for (const auto &rankedAddress : ranked)
+                {
+                    bool isIpv6 = rankedAddress.address->record_type == AWS_ADDRESS_RECORD_TYPE_AAAA;
+                    families[isIpv6 ? 0 : 1].push_back(rankedAddress.address);
+                }
+
+                Vector<HostAddress> ordered;
+                ordered.reserve(addresses.size());
+                bool ipv6First = ranked.empty() || ranked[0].address->record_type == AWS_ADDRESS_RECORD_TYPE_AAAA;
+                size_t first = ipv6First ? 0 : 1;
+                for (size_t i = 0; i < families[0].size() || i < families[1].size(); ++i)
+                {
+                    if (i < families[first].size())
+                    {
+                        ordered.push_back(*families[first][i]);
+                    }
+                    if (i < families[1 - first].size())
+                    {
+                        ordered.push_back(*families[1 - first][i]);
+                    }
+                }
+
+                return ordered;
+            }
+
+            HostAddressStatistics HostAddressSelector::GetStatistics(const String &address) const noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                auto iter = m_addresses.find(address);
+                return iter != m_addresses.end() ? iter->second.statistics : HostAddressStatistics();
+            }
+
+            void HostAddressSelector::Clear() noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                m_addresses.clear();
+            }
+        } // namespace Io
+    }     // namespace Crt
+} // namespace Aws
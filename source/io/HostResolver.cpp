@@ -4,10 +4,14 @@
  */
 #include <aws/crt/io/HostResolver.h>
 
+#include <aws/crt/Api.h>
 #include <aws/crt/io/EventLoopGroup.h>
 
 #include <aws/common/string.h>
 
+#include <atomic>
+#include <mutex>
+
 namespace Aws
 {
     namespace Crt
@@ -16,6 +20,181 @@ namespace Aws
         {
             HostResolver::~HostResolver() {}
 
+            /**
+             * What a DefaultHostResolver shares with its resolutions in flight and the task refreshing its pinned
+             * hosts: its own references to the C resolver and event loop group, the statistics, and the pins.
+             */
+            struct DefaultHostResolverState
+            {
+                DefaultHostResolverState(
+                    Allocator *allocator,
+                    aws_host_resolver *resolver,
+                    aws_event_loop_group *elGroup,
+                    const aws_host_resolution_config &config)
+                    : allocator(allocator), resolver(aws_host_resolver_acquire(resolver)),
+                      elGroup(aws_event_loop_group_acquire(elGroup)), eventLoop(nullptr), config(config),
+                      scheduledRefreshNs(0), resolutions(0), cacheHits(0), cacheMisses(0), failures(0), prefetches(0),
+                      refreshes(0)
+                {
+                }
+
+                ~DefaultHostResolverState()
+                {
+                    aws_host_resolver_release(resolver);
+                    aws_event_loop_group_release(elGroup);
+                }
+
+                struct PinnedHost
+                {
+                    uint64_t refreshIntervalNs;
+                    uint64_t nextRefreshNs;
+                };
+
+                Allocator *allocator;
+                aws_host_resolver *resolver;
+                aws_event_loop_group *elGroup;
+                /* the loop the refreshes are scheduled on, picked with the first pin */
+                aws_event_loop *eventLoop;
+                aws_host_resolution_config config;
+
+                std::mutex lock;
+                Map<String, PinnedHost> pinnedHosts;
+                /* when the next refresh task runs, or 0 if none is scheduled */
+                uint64_t scheduledRefreshNs;
+
+                std::atomic<uint64_t> resolutions;
+                std::atomic<uint64_t> cacheHits;
+                std::atomic<uint64_t> cacheMisses;
+                std::atomic<uint64_t> failures;
+                std::atomic<uint64_t> prefetches;
+                std::atomic<uint64_t> refreshes;
+            };
+
+            /* a resolution nobody waits on, started by a prefetch or a refresh */
+            struct BackgroundResolveArgs
+            {
+                std::shared_ptr<DefaultHostResolverState> state;
+                aws_string *host;
+            };
+
+            static void s_onBackgroundHostResolved(
+                struct aws_host_resolver *,
+                const struct aws_string *,
+                int errCode,
+                const struct aws_array_list *,
+                void *userData)
+            {
+                BackgroundResolveArgs *args = static_cast<BackgroundResolveArgs *>(userData);
+                if (errCode)
+                {
+                    ++args->state->failures;
+                }
+                aws_string_destroy(args->host);
+                Allocator *allocator = args->state->allocator;
+                Delete(args, allocator);
+            }
+
+            static bool s_StartBackgroundResolve(
+                const std::shared_ptr<DefaultHostResolverState> &state,
+                const String &host) noexcept
+            {
+                BackgroundResolveArgs *args = New<BackgroundResolveArgs>(state->allocator);
+                if (!args)
+                {
+                    return false;
+                }
+
+                args->state = state;
+                args->host = aws_string_new_from_array(
+                    state->allocator, reinterpret_cast<const uint8_t *>(host.data()), host.length());
+                if (!args->host || aws_host_resolver_resolve_host(
+                                       state->resolver, args->host, s_onBackgroundHostResolved, &state->config, args))
+                {
+                    aws_string_destroy(args->host);
+                    Delete(args, state->allocator);
+                    return false;
+                }
+
+                return true;
+            }
+
+            struct PinRefreshTask
+            {
+                aws_task task;
+                std::weak_ptr<DefaultHostResolverState> state;
+                uint64_t runAtNs;
+                Allocator *allocator;
+            };
+
+            static void s_ScheduleRefresh(const std::shared_ptr<DefaultHostResolverState> &state, uint64_t runAtNs);
+
+            static void s_onPinRefreshTask(aws_task *, void *arg, aws_task_status status)
+            {
+                auto *refreshTask = static_cast<PinRefreshTask *>(arg);
+                auto state = refreshTask->state.lock();
+                uint64_t runAtNs = refreshTask->runAtNs;
+                Delete(refreshTask, refreshTask->allocator);
+
+                uint64_t now = 0;
+                if (!state || status != AWS_TASK_STATUS_RUN_READY ||
+                    aws_event_loop_current_clock_time(state->eventLoop, &now))
+                {
+                    return;
+                }
+
+                Vector<String> dueHosts;
+                uint64_t nextRefreshNs = 0;
+                {
+                    std::lock_guard<std::mutex> lock(state->lock);
+                    if (state->scheduledRefreshNs == runAtNs)
+                    {
+                        state->scheduledRefreshNs = 0;
+                    }
+
+                    for (auto &pinnedHost : state->pinnedHosts)
+                    {
+                        if (pinnedHost.second.nextRefreshNs <= now)
+                        {
+                            dueHosts.push_back(pinnedHost.first);
+                            pinnedHost.second.nextRefreshNs = now + pinnedHost.second.refreshIntervalNs;
+                        }
+                        if (nextRefreshNs == 0 || pinnedHost.second.nextRefreshNs < nextRefreshNs)
+                        {
+                            nextRefreshNs = pinnedHost.second.nextRefreshNs;
+                        }
+                    }
+
+                    if (nextRefreshNs != 0 &&
+                        (state->scheduledRefreshNs == 0 || nextRefreshNs < state->scheduledRefreshNs))
+                    {
+                        s_ScheduleRefresh(state, nextRefreshNs);
+                    }
+                }
+
+                for (const auto &host : dueHosts)
+                {
+                    ++state->refreshes;
+                    s_StartBackgroundResolve(state, host);
+                }
+            }
+
+            /* called with state->lock held */
+            static void s_ScheduleRefresh(const std::shared_ptr<DefaultHostResolverState> &state, uint64_t runAtNs)
+            {
+                auto *refreshTask = New<PinRefreshTask>(state->allocator);
+                if (!refreshTask)
+                {
+                    return;
+                }
+
+                refreshTask->state = state;
+                refreshTask->runAtNs = runAtNs;
+                refreshTask->allocator = state->allocator;
+                aws_task_init(&refreshTask->task, s_onPinRefreshTask, refreshTask, "cpp-crt-host-resolver-pin-refresh");
+                aws_event_loop_schedule_task_future(state->eventLoop, &refreshTask->task, runAtNs);
+                state->scheduledRefreshNs = runAtNs;
+            }
+
             DefaultHostResolver::DefaultHostResolver(
                 EventLoopGroup &elGroup,
                 size_t maxHosts,
@@ -23,6 +202,8 @@ namespace Aws
                 Allocator *allocator) noexcept
                 : m_resolver(nullptr), m_allocator(allocator), m_initialized(false)
             {
+                ApiHandle::InitializeSubsystem(ApiSubsystem::Io);
+
                 AWS_ZERO_STRUCT(m_config);
 
                 struct aws_host_resolver_default_options resolver_options;
@@ -39,6 +220,13 @@ namespace Aws
                 m_config.impl = aws_default_dns_resolve;
                 m_config.impl_data = nullptr;
                 m_config.max_ttl = maxTTL;
+
+                if (m_initialized)
+                {
+                    m_state = MakeShared<DefaultHostResolverState>(
+                        allocator, allocator, m_resolver, elGroup.GetUnderlyingHandle(), m_config);
+                    m_initialized = m_state != nullptr;
+                }
             }
 
             DefaultHostResolver::~DefaultHostResolver()
@@ -54,6 +242,7 @@ namespace Aws
                 HostResolver *resolver;
                 OnHostResolved onResolved;
                 aws_string *host;
+                std::shared_ptr<DefaultHostResolverState> state;
             };
 
             void DefaultHostResolver::s_onHostResolved(
@@ -75,6 +264,12 @@ namespace Aws
                     addresses.push_back(*address_ptr);
                 }
 
+                ++args->state->resolutions;
+                if (errCode)
+                {
+                    ++args->state->failures;
+                }
+
                 String host(aws_string_c_str(hostName), hostName->len);
                 args->onResolved(*args->resolver, addresses, errCode);
                 aws_string_destroy(args->host);
@@ -94,16 +289,137 @@ namespace Aws
                 args->onResolved = onResolved;
                 args->resolver = this;
                 args->allocator = m_allocator;
+                args->state = m_state;
 
-                if (!args->host ||
-                    aws_host_resolver_resolve_host(m_resolver, args->host, s_onHostResolved, &m_config, args))
+                if (!args->host)
                 {
                     Delete(args, m_allocator);
                     return false;
                 }
 
+                bool cached = aws_host_resolver_get_host_address_count(
+                                  m_resolver,
+                                  args->host,
+                                  AWS_GET_HOST_ADDRESS_COUNT_RECORD_TYPE_A |
+                                      AWS_GET_HOST_ADDRESS_COUNT_RECORD_TYPE_AAAA) > 0;
+
+                if (aws_host_resolver_resolve_host(m_resolver, args->host, s_onHostResolved, &m_config, args))
+                {
+                    aws_string_destroy(args->host);
+                    Delete(args, m_allocator);
+                    return false;
+                }
+
+                ++(cached ? m_state->cacheHits : m_state->cacheMisses);
                 return true;
             }
+
+            bool DefaultHostResolver::Prefetch(const Vector<String> &hosts) noexcept
+            {
+                if (!m_state)
+                {
+                    aws_raise_error(AWS_ERROR_INVALID_STATE);
+                    return false;
+                }
+
+                bool started = true;
+                for (const auto &host : hosts)
+                {
+                    ++m_state->prefetches;
+                    started = s_StartBackgroundResolve(m_state, host) && started;
+                }
+                return started;
+            }
+
+            bool DefaultHostResolver::PinHost(const String &host, std::chrono::milliseconds refreshInterval) noexcept
+            {
+                uint64_t intervalNs = static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(refreshInterval).count());
+                if (!m_state)
+                {
+                    aws_raise_error(AWS_ERROR_INVALID_STATE);
+                    return false;
+                }
+                if (intervalNs == 0)
+                {
+                    aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                    return false;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(m_state->lock);
+                    if (m_state->eventLoop == nullptr)
+                    {
+                        m_state->eventLoop = aws_event_loop_group_get_next_loop(m_state->elGroup);
+                    }
+
+                    uint64_t now = 0;
+                    if (m_state->eventLoop == nullptr || aws_event_loop_current_clock_time(m_state->eventLoop, &now))
+                    {
+                        return false;
+                    }
+
+                    DefaultHostResolverState::PinnedHost &pinnedHost = m_state->pinnedHosts[host];
+                    pinnedHost.refreshIntervalNs = intervalNs;
+                    pinnedHost.nextRefreshNs = now + intervalNs;
+                    if (m_state->scheduledRefreshNs == 0 || pinnedHost.nextRefreshNs < m_state->scheduledRefreshNs)
+                    {
+                        s_ScheduleRefresh(m_state, pinnedHost.nextRefreshNs);
+                    }
+                }
+
+                ++m_state->prefetches;
+                return s_StartBackgroundResolve(m_state, host);
+            }
+
+            void DefaultHostResolver::UnpinHost(const String &host) noexcept
+            {
+                if (!m_state)
+                {
+                    return;
+                }
+
+                /* a refresh task finding no pins left does not schedule another */
+                std::lock_guard<std::mutex> lock(m_state->lock);
+                m_state->pinnedHosts.erase(host);
+            }
+
+            size_t DefaultHostResolver::GetCachedAddressCount(const String &host) const noexcept
+            {
+                if (!m_resolver)
+                {
+                    return 0;
+                }
+
+                aws_string *hostName = aws_string_new_from_array(
+                    m_allocator, reinterpret_cast<const uint8_t *>(host.data()), host.length());
+                if (!hostName)
+                {
+                    return 0;
+                }
+
+                size_t count = aws_host_resolver_get_host_address_count(
+                    m_resolver,
+                    hostName,
+                    AWS_GET_HOST_ADDRESS_COUNT_RECORD_TYPE_A | AWS_GET_HOST_ADDRESS_COUNT_RECORD_TYPE_AAAA);
+                aws_string_destroy(hostName);
+                return count;
+            }
+
+            HostResolverStatistics DefaultHostResolver::GetStatistics() const noexcept
+            {
+                HostResolverStatistics statistics;
+                if (m_state)
+                {
+                    statistics.Resolutions = m_state->resolutions.load();
+                    statistics.CacheHits = m_state->cacheHits.load();
+                    statistics.CacheMisses = m_state->cacheMisses.load();
+                    statistics.Failures = m_state->failures.load();
+                    statistics.Prefetches = m_state->prefetches.load();
+                    statistics.Refreshes = m_state->refreshes.load();
+                }
+                return statistics;
+            }
         } // namespace Io
     }     // namespace Crt
 } // namespace Aws
@@ -0,0 +1,259 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/io/ReadAheadInputStream.h>
+
+#include <cstring>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Io
+        {
+            ReadAheadInputStream::ReadAheadInputStream(
+                const std::shared_ptr<InputStream> &source,
+                size_t blockSize,
+                bool prefetch,
+                Aws::Crt::Allocator *allocator) noexcept
+                : InputStream(allocator), m_source(source), m_blockSize(blockSize), m_prefetchEnabled(prefetch),
+                  m_frontOffset(0), m_sourceDone(false), m_prefetchState(PrefetchState::Idle),
+                  m_prefetchError(AWS_ERROR_SUCCESS), m_stopWorker(false), m_lastError(AWS_ERROR_SUCCESS)
+            {
+                AWS_FATAL_ASSERT(blockSize > 0);
+                AWS_ZERO_STRUCT(m_front);
+                AWS_ZERO_STRUCT(m_back);
+                if (aws_byte_buf_init(&m_front, allocator, blockSize) ||
+                    aws_byte_buf_init(&m_back, allocator, blockSize))
+                {
+                    m_lastError = aws_last_error();
+                }
+            }
+
+            ReadAheadInputStream::~ReadAheadInputStream()
+            {
+                if (m_worker.joinable())
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(m_prefetchLock);
+                        m_stopWorker = true;
+                    }
+                    m_prefetchSignal.notify_all();
+                    m_worker.join();
+                }
+
+                aws_byte_buf_clean_up(&m_front);
+                aws_byte_buf_clean_up(&m_back);
+            }
+
+            bool ReadAheadInputStream::IsValid() const noexcept
+            {
+                return m_source && m_front.buffer && m_back.buffer && m_lastError == AWS_ERROR_SUCCESS;
+            }
+
+            int ReadAheadInputStream::FillBackBlock() noexcept
+            {
+                while (m_back.len < m_back.capacity)
+                {
+                    size_t before = m_back.len;
+                    if (!m_source->Read(m_back))
+                    {
+                        return aws_last_error();
+                    }
+
+                    StreamStatus status;
+                    AWS_ZERO_STRUCT(status);
+                    m_source->GetStatus(status);
+                    if (status.is_end_of_stream)
+                    {
+                        m_sourceDone = true;
+                        break;
+                    }
+
+                    if (m_back.len == before)
+                    {
+                        break;
+                    }
+                }
+
+                return AWS_ERROR_SUCCESS;
+            }
+
+            void ReadAheadInputStream::PrefetchWorker() noexcept
+            {
+                std::unique_lock<std::mutex> lock(m_prefetchLock);
+                while (true)
+                {
+                    m_prefetchSignal.wait(
+                        lock, [this]() { return m_stopWorker || m_prefetchState == PrefetchState::Requested; });
+                    if (m_stopWorker)
+                    {
+                        return;
+                    }
+
+                    lock.unlock();
+                    int errorCode = FillBackBlock();
+                    lock.lock();
+
+                    m_prefetchError = errorCode;
+                    m_prefetchState = PrefetchState::Ready;
+                    m_prefetchSignal.notify_all();
+                }
+            }
+
+            void ReadAheadInputStream::WaitForPrefetch() noexcept
+            {
+                std::unique_lock<std::mutex> lock(m_prefetchLock);
+                m_prefetchSignal.wait(lock, [this]() { return m_prefetchState != PrefetchState::Requested; });
+                m_prefetchState = PrefetchState::Idle;
+            }
+
+            void ReadAheadInputStream::StartPrefetch() noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_prefetchLock);
+                if (!m_prefetchEnabled || m_prefetchState != PrefetchState::Idle || m_sourceDone || m_back.len > 0)
+                {
+                    return;
+                }
+
+                if (!m_worker.joinable())
+                {
+                    try
+                    {
+                        m_worker = std::thread(&ReadAheadInputStream::PrefetchWorker, this);
+                    }
+                    catch (...)
+                    {
+                        /* no thread to spare, every block is read when it is needed instead */
+                        m_prefetchEnabled = false;
+                        return;
+                    }
+                }
+
+                m_prefetchState = PrefetchState::Requested;
+                m_prefetchSignal.notify_all();
+            }
+
+            bool ReadAheadInputStream::NextBlock() noexcept
+            {
+                int errorCode = AWS_ERROR_SUCCESS;
+                bool fillNow = false;
+                {
+                    std::lock_guard<std::mutex> lock(m_prefetchLock);
+                    if (m_prefetchState == PrefetchState::Requested)
+                    {
+                        /* never wait on the read ahead, the caller is likely an event-loop thread */
+                        m_front.len = 0;
+                        m_frontOffset = 0;
+                        return true;
+                    }
+
+                    if (m_prefetchState == PrefetchState::Ready)
+                    {
+                        errorCode = m_prefetchError;
+                        m_prefetchState = PrefetchState::Idle;
+                    }
+                    else
+                    {
+                        fillNow = m_back.len == 0 && !m_sourceDone;
+                    }
+                }
+
+                if (fillNow)
+                {
+                    errorCode = FillBackBlock();
+                }
+
+                if (errorCode != AWS_ERROR_SUCCESS)
+                {
+                    m_lastError = errorCode;
+                    aws_raise_error(errorCode);
+                    return false;
+                }
+
+                std::swap(m_front, m_back);
+                m_back.len = 0;
+                m_frontOffset = 0;
+
+                return true;
+            }
+
+            bool ReadAheadInputStream::ReadImpl(ByteBuf &buffer) noexcept
+            {
+                if (!IsValid())
+                {
+                    aws_raise_error(m_lastError != AWS_ERROR_SUCCESS ? m_lastError : AWS_ERROR_INVALID_STATE);
+                    return false;
+                }
+
+                while (buffer.len < buffer.capacity)
+                {
+                    if (m_frontOffset == m_front.len)
+                    {
+                        if (!NextBlock())
+                        {
+                            return false;
+                        }
+
+                        if (m_front.len == 0)
+                        {
+                            break;
+                        }
+                    }
+
+                    size_t available = m_front.len - m_frontOffset;
+                    size_t toCopy = buffer.capacity - buffer.len < available ? buffer.capacity - buffer.len : available;
+                    memcpy(buffer.buffer + buffer.len, m_front.buffer + m_frontOffset, toCopy);
+                    buffer.len += toCopy;
+                    m_frontOffset += toCopy;
+                }
+
+                StartPrefetch();
+                return true;
+            }
+
+            StreamStatus ReadAheadInputStream::GetStatusImpl() const noexcept
+            {
+                StreamStatus status;
+                status.is_valid = IsValid();
+
+                /* with a read ahead in flight, the back block and the source are not ours to look at */
+                std::lock_guard<std::mutex> lock(m_prefetchLock);
+                status.is_end_of_stream = m_prefetchState == PrefetchState::Idle && m_sourceDone &&
+                                          m_frontOffset == m_front.len && m_back.len == 0;
+
+                return status;
+            }
+
+            int64_t ReadAheadInputStream::GetLengthImpl() const noexcept
+            {
+                int64_t length = -1;
+                return m_source->GetLength(length) ? length : -1;
+            }
+
+            bool ReadAheadInputStream::SeekImpl(OffsetType offset, StreamSeekBasis seekBasis) noexcept
+            {
+                WaitForPrefetch();
+                m_front.len = 0;
+                m_frontOffset = 0;
+                m_back.len = 0;
+                m_sourceDone = false;
+
+                /* a failed read can be retried from a new position, failing to allocate the blocks can not */
+                if (m_front.buffer && m_back.buffer)
+                {
+                    m_lastError = AWS_ERROR_SUCCESS;
+                }
+
+                if (!m_source->Seek(offset, seekBasis))
+                {
+                    m_lastError = aws_last_error();
+                    return false;
+                }
+
+                return true;
+            }
+        } // namespace Io
+    }     // namespace Crt
+} // namespace Aws
@@ -0,0 +1,179 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/io/ReadWindowTuner.h>
+
+#include <aws/common/clock.h>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Io
+        {
+            static ReadWindowTunerOptions s_NormalizeOptions(const ReadWindowTunerOptions &options)
+            {
+                ReadWindowTunerOptions normalized = options;
+                if (normalized.MinWindowSize == 0)
+                {
+                    normalized.MinWindowSize = 1;
+                }
+                if (normalized.MaxWindowSize < normalized.MinWindowSize)
+                {
+                    normalized.MaxWindowSize = normalized.MinWindowSize;
+                }
+                if (normalized.InitialWindowSize < normalized.MinWindowSize)
+                {
+                    normalized.InitialWindowSize = normalized.MinWindowSize;
+                }
+                if (normalized.InitialWindowSize > normalized.MaxWindowSize)
+                {
+                    normalized.InitialWindowSize = normalized.MaxWindowSize;
+                }
+                if (normalized.DefaultRoundTripTimeNs == 0)
+                {
+                    normalized.DefaultRoundTripTimeNs = ReadWindowTunerOptions().DefaultRoundTripTimeNs;
+                }
+
+                return normalized;
+            }
+
+            ReadWindowTuner::ReadWindowTuner(const ReadWindowTunerOptions &options) noexcept
+                : m_options(s_NormalizeOptions(options)), m_windowSize(m_options.InitialWindowSize),
+                  m_roundTripTimeNs(m_options.DefaultRoundTripTimeNs), m_hasRoundTripTime(false), m_sampleStartNs(0),
+                  m_sampleBytes(0), m_epochStartNs(0), m_epochBytes(0), m_shrinkDebt(0)
+            {
+            }
+
+            size_t ReadWindowTuner::GetWindowSize() const noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                return m_windowSize;
+            }
+
+            uint64_t ReadWindowTuner::GetRoundTripTimeNs() const noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                return m_roundTripTimeNs;
+            }
+
+            void ReadWindowTuner::SetRoundTripTimeNs(uint64_t roundTripTimeNs) noexcept
+            {
+                if (roundTripTimeNs == 0)
+                {
+                    return;
+                }
+
+                std::lock_guard<std::mutex> lock(m_lock);
+                m_roundTripTimeNs = roundTripTimeNs;
+                m_hasRoundTripTime = true;
+            }
+
+            void ReadWindowTuner::OnBytesReceived(size_t bytes) noexcept
+            {
+                uint64_t now = 0;
+                aws_high_res_clock_get_ticks(&now);
+                OnBytesReceived(bytes, now);
+            }
+
+            void ReadWindowTuner::OnBytesReceived(size_t bytes, uint64_t nowNs) noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                if (m_sampleStartNs == 0)
+                {
+                    m_sampleStartNs = nowNs;
+                    m_sampleBytes = 0;
+                }
+
+                m_sampleBytes += bytes;
+                if (m_sampleBytes < m_windowSize || nowNs <= m_sampleStartNs)
+                {
+                    return;
+                }
+
+                /* a window's worth took at most a round trip plus however long the consumer sat on it, so an upper
+                 * bound: trust lower samples at once and move towards higher ones slowly */
+                uint64_t sample = nowNs - m_sampleStartNs;
+                if (!m_hasRoundTripTime || sample < m_roundTripTimeNs)
+                {
+                    m_roundTripTimeNs = sample;
+                }
+                else
+                {
+                    m_roundTripTimeNs = m_roundTripTimeNs - m_roundTripTimeNs / 8 + sample / 8;
+                }
+                m_hasRoundTripTime = true;
+
+                m_sampleStartNs = nowNs;
+                m_sampleBytes = 0;
+            }
+
+            size_t ReadWindowTuner::OnBytesConsumed(size_t bytes) noexcept
+            {
+                uint64_t now = 0;
+                aws_high_res_clock_get_ticks(&now);
+                return OnBytesConsumed(bytes, now);
+            }
+
+            size_t ReadWindowTuner::OnBytesConsumed(size_t bytes, uint64_t nowNs) noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                if (m_epochStartNs == 0)
+                {
+                    m_epochStartNs = nowNs;
+                }
+
+                m_epochBytes += bytes;
+                size_t increment = bytes;
+                if (nowNs > m_epochStartNs && nowNs - m_epochStartNs >= m_roundTripTimeNs)
+                {
+                    size_t previousWindow = m_windowSize;
+                    Retune(nowNs);
+                    if (m_windowSize > previousWindow)
+                    {
+                        increment += m_windowSize - previousWindow;
+                    }
+                }
+
+                /* a smaller window is reached by handing back less than was consumed */
+                size_t withheld = m_shrinkDebt < increment ? m_shrinkDebt : increment;
+                m_shrinkDebt -= withheld;
+
+                return increment - withheld;
+            }
+
+            void ReadWindowTuner::Retune(uint64_t nowNs) noexcept
+            {
+                double elapsed = static_cast<double>(nowNs - m_epochStartNs);
+                double perRoundTrip =
+                    static_cast<double>(m_epochBytes) * static_cast<double>(m_roundTripTimeNs) / elapsed;
+                double target = 2 * perRoundTrip;
+
+                size_t targetWindow = m_options.MaxWindowSize;
+                if (target < static_cast<double>(m_options.MinWindowSize))
+                {
+                    targetWindow = m_options.MinWindowSize;
+                }
+                else if (target < static_cast<double>(m_options.MaxWindowSize))
+                {
+                    targetWindow = static_cast<size_t>(target);
+                }
+
+                if (targetWindow > m_windowSize)
+                {
+                    m_windowSize = targetWindow;
+                }
+                else
+                {
+                    size_t shrink = (m_windowSize - targetWindow) / 4;
+                    m_windowSize -= shrink;
+                    m_shrinkDebt += shrink;
+                }
+
+                m_epochStartNs = nowNs;
+                m_epochBytes = 0;
+            }
+        } // namespace Io
+    }     // namespace Crt
+} // namespace Aws
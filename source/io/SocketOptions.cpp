@@ -4,6 +4,18 @@
  */
 #include <aws/crt/io/SocketOptions.h>
 
+#include <aws/io/channel.h>
+#include <aws/io/logging.h>
+#include <aws/io/socket_channel_handler.h>
+
+#ifdef _WIN32
+#    include <winsock2.h>
+#else
+#    include <netinet/in.h>
+#    include <netinet/tcp.h>
+#    include <sys/socket.h>
+#endif
+
 namespace Aws
 {
     namespace Crt
@@ -14,6 +26,7 @@ namespace Aws
             static const uint32_t DEFAULT_SOCKET_TIME_MSEC = 3000;
 
             SocketOptions::SocketOptions()
+                : m_receiveBufferSize(0), m_sendBufferSize(0), m_tcpNoDelay(false), m_busyPollUs(0)
             {
                 options.type = AWS_SOCKET_STREAM;
                 options.domain = AWS_SOCKET_IPV4;
@@ -23,6 +36,92 @@ namespace Aws
                 options.keep_alive_interval_sec = 0;
                 options.keepalive = false;
             }
+
+#ifdef _WIN32
+            using NativeSocket = SOCKET;
+#else
+            using NativeSocket = int;
+#endif
+
+            static bool s_SetIntOption(
+                const struct aws_socket *socket,
+                NativeSocket nativeSocket,
+                int level,
+                int name,
+                const char *label,
+                uint32_t optionValue)
+            {
+                int value = static_cast<int>(optionValue);
+                if (setsockopt(nativeSocket, level, name, reinterpret_cast<const char *>(&value), sizeof(value)) == 0)
+                {
+                    return true;
+                }
+
+                AWS_LOGF_ERROR(AWS_LS_IO_SOCKET, "id=%p: failed to set %s to %d.", (void *)socket, label, value);
+                aws_raise_error(AWS_IO_SOCKET_INVALID_OPTIONS);
+                return false;
+            }
+
+            bool SocketOptions::ApplyTuning(struct aws_channel *channel) const
+            {
+                if (!HasTuning())
+                {
+                    return true;
+                }
+
+                struct aws_channel_slot *slot = aws_channel_get_first_slot(channel);
+                const struct aws_socket *socket = nullptr;
+                if (slot != nullptr && slot->handler != nullptr)
+                {
+                    socket = aws_socket_handler_get_socket(slot->handler);
+                }
+                if (socket == nullptr)
+                {
+                    aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                    return false;
+                }
+
+#ifdef _WIN32
+                NativeSocket nativeSocket = reinterpret_cast<NativeSocket>(socket->io_handle.data.handle);
+                if (nativeSocket == INVALID_SOCKET)
+#else
+                NativeSocket nativeSocket = socket->io_handle.data.fd;
+                if (nativeSocket < 0)
+#endif
+                {
+                    aws_raise_error(AWS_IO_SOCKET_CLOSED);
+                    return false;
+                }
+
+                if (m_receiveBufferSize != 0 &&
+                    !s_SetIntOption(socket, nativeSocket, SOL_SOCKET, SO_RCVBUF, "SO_RCVBUF", m_receiveBufferSize))
+                {
+                    return false;
+                }
+
+                if (m_sendBufferSize != 0 &&
+                    !s_SetIntOption(socket, nativeSocket, SOL_SOCKET, SO_SNDBUF, "SO_SNDBUF", m_sendBufferSize))
+                {
+                    return false;
+                }
+
+                /* local sockets have no TCP level */
+                if (m_tcpNoDelay && options.domain != AWS_SOCKET_LOCAL &&
+                    !s_SetIntOption(socket, nativeSocket, IPPROTO_TCP, TCP_NODELAY, "TCP_NODELAY", 1))
+                {
+                    return false;
+                }
+
+#ifdef SO_BUSY_POLL
+                if (m_busyPollUs != 0 &&
+                    !s_SetIntOption(socket, nativeSocket, SOL_SOCKET, SO_BUSY_POLL, "SO_BUSY_POLL", m_busyPollUs))
+                {
+                    return false;
+                }
+#endif
+
+                return true;
+            }
         } // namespace Io
     }     // namespace Crt
 } // namespace Aws
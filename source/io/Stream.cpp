@@ -8,6 +8,8 @@
 
 #include <aws/io/stream.h>
 
+#include <cstring>
+
 namespace Aws
 {
     namespace Crt
@@ -92,6 +94,36 @@ namespace Aws
                 m_underlying_stream.vtable = &s_vtable;
             }
 
+            bool InputStream::ResolveSeekPosition(
+                OffsetType offset,
+                StreamSeekBasis seekBasis,
+                int64_t length,
+                int64_t &outPosition) noexcept
+            {
+                int64_t position = -1;
+                switch (seekBasis)
+                {
+                    case StreamSeekBasis::Begin:
+                        position = offset;
+                        break;
+                    case StreamSeekBasis::End:
+                        position = offset <= 0 ? length + offset : -1;
+                        break;
+                    default:
+                        aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                        return false;
+                }
+
+                if (position < 0 || position > length)
+                {
+                    aws_raise_error(AWS_IO_STREAM_INVALID_SEEK_POSITION);
+                    return false;
+                }
+
+                outPosition = position;
+                return true;
+            }
+
             StdIOStreamInputStream::StdIOStreamInputStream(
                 std::shared_ptr<Aws::Crt::Io::IStream> stream,
                 Aws::Crt::Allocator *allocator) noexcept
@@ -173,6 +205,241 @@ namespace Aws
 
                 return true;
             }
+
+            ByteCursorInputStream::ByteCursorInputStream(
+                const ByteCursor &data,
+                Aws::Crt::Allocator *allocator) noexcept
+                : InputStream(allocator), m_owner(), m_data(data), m_position(0)
+            {
+            }
+
+            ByteCursorInputStream::ByteCursorInputStream(
+                std::shared_ptr<const void> owner,
+                const ByteCursor &data,
+                Aws::Crt::Allocator *allocator) noexcept
+                : InputStream(allocator), m_owner(std::move(owner)), m_data(data), m_position(0)
+            {
+            }
+
+            bool ByteCursorInputStream::IsValid() const noexcept { return m_data.ptr != nullptr || m_data.len == 0; }
+
+            bool ByteCursorInputStream::ReadImpl(ByteBuf &buffer) noexcept
+            {
+                size_t available = m_data.len - static_cast<size_t>(m_position);
+                size_t toCopy = buffer.capacity - buffer.len < available ? buffer.capacity - buffer.len : available;
+                if (toCopy > 0)
+                {
+                    memcpy(buffer.buffer + buffer.len, m_data.ptr + m_position, toCopy);
+                    buffer.len += toCopy;
+                    m_position += static_cast<int64_t>(toCopy);
+                }
+
+                return true;
+            }
+
+            StreamStatus ByteCursorInputStream::GetStatusImpl() const noexcept
+            {
+                StreamStatus status;
+                status.is_end_of_stream = static_cast<size_t>(m_position) == m_data.len;
+                status.is_valid = IsValid();
+
+                return status;
+            }
+
+            int64_t ByteCursorInputStream::GetLengthImpl() const noexcept { return static_cast<int64_t>(m_data.len); }
+
+            bool ByteCursorInputStream::SeekImpl(OffsetType offset, StreamSeekBasis seekBasis) noexcept
+            {
+                return ResolveSeekPosition(offset, seekBasis, static_cast<int64_t>(m_data.len), m_position);
+            }
+
+            ChainedInputStream::ChainedInputStream(Aws::Crt::Allocator *allocator) noexcept
+                : InputStream(allocator), m_currentSegment(0), m_bytesOffset(0), m_readFailed(false)
+            {
+            }
+
+            void ChainedInputStream::AddSegment(const ByteCursor &bytes) noexcept
+            {
+                Segment segment;
+                segment.bytes = bytes;
+                segment.length = static_cast<int64_t>(bytes.len);
+                segment.rewindBeforeRead = false;
+                m_segments.push_back(std::move(segment));
+            }
+
+            void ChainedInputStream::AddSegment(const std::shared_ptr<InputStream> &stream) noexcept
+            {
+                Segment segment;
+                AWS_ZERO_STRUCT(segment.bytes);
+                segment.stream = stream;
+                segment.length = -1;
+                if (stream && !stream->GetLength(segment.length))
+                {
+                    segment.length = -1;
+                }
+                segment.rewindBeforeRead = false;
+                m_segments.push_back(std::move(segment));
+            }
+
+            bool ChainedInputStream::IsValid() const noexcept
+            {
+                for (const auto &segment : m_segments)
+                {
+                    if (segment.stream && !segment.stream->IsValid())
+                    {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+            bool ChainedInputStream::EnterSegment(size_t index, int64_t segmentOffset) noexcept
+            {
+                m_currentSegment = index;
+                m_bytesOffset = 0;
+                if (index >= m_segments.size())
+                {
+                    return true;
+                }
+
+                Segment &segment = m_segments[index];
+                if (!segment.stream)
+                {
+                    m_bytesOffset = static_cast<size_t>(segmentOffset);
+                    return true;
+                }
+
+                /* a child that has never been touched is read from wherever its owner left it */
+                if ((segmentOffset != 0 || segment.rewindBeforeRead) &&
+                    !segment.stream->Seek(segmentOffset, StreamSeekBasis::Begin))
+                {
+                    return false;
+                }
+
+                segment.rewindBeforeRead = segmentOffset != 0;
+                return true;
+            }
+
+            bool ChainedInputStream::ReadImpl(ByteBuf &buffer) noexcept
+            {
+                while (buffer.len < buffer.capacity && m_currentSegment < m_segments.size())
+                {
+                    Segment &segment = m_segments[m_currentSegment];
+                    bool segmentDone = false;
+                    if (!segment.stream)
+                    {
+                        size_t available = segment.bytes.len - m_bytesOffset;
+                        size_t toCopy =
+                            buffer.capacity - buffer.len < available ? buffer.capacity - buffer.len : available;
+                        if (toCopy > 0)
+                        {
+                            memcpy(buffer.buffer + buffer.len, segment.bytes.ptr + m_bytesOffset, toCopy);
+                            buffer.len += toCopy;
+                            m_bytesOffset += toCopy;
+                        }
+                        segmentDone = m_bytesOffset == segment.bytes.len;
+                    }
+                    else
+                    {
+                        size_t previousLength = buffer.len;
+                        segment.rewindBeforeRead = true;
+                        StreamStatus status;
+                        if (!segment.stream->Read(buffer) || !segment.stream->GetStatus(status))
+                        {
+                            m_readFailed = true;
+                            return false;
+                        }
+
+                        segmentDone = status.is_end_of_stream;
+                        if (!segmentDone && buffer.len == previousLength)
+                        {
+                            /* the child has nothing for us right now, try again on the next read */
+                            return true;
+                        }
+                    }
+
+                    if (segmentDone && !EnterSegment(m_currentSegment + 1, 0))
+                    {
+                        m_readFailed = true;
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+            StreamStatus ChainedInputStream::GetStatusImpl() const noexcept
+            {
+                StreamStatus status;
+                status.is_end_of_stream = m_currentSegment >= m_segments.size();
+                status.is_valid = !m_readFailed;
+
+                return status;
+            }
+
+            int64_t ChainedInputStream::GetLengthImpl() const noexcept
+            {
+                int64_t totalLength = 0;
+                for (const auto &segment : m_segments)
+                {
+                    if (segment.length < 0)
+                    {
+                        return -1;
+                    }
+
+                    totalLength += segment.length;
+                }
+
+                return totalLength;
+            }
+
+            bool ChainedInputStream::SeekImpl(OffsetType offset, StreamSeekBasis seekBasis) noexcept
+            {
+                m_readFailed = false;
+                if (seekBasis == StreamSeekBasis::Begin && offset == 0)
+                {
+                    if (EnterSegment(0, 0))
+                    {
+                        return true;
+                    }
+
+                    m_readFailed = true;
+                    return false;
+                }
+
+                int64_t totalLength = GetLengthImpl();
+                if (totalLength < 0)
+                {
+                    aws_raise_error(AWS_ERROR_STREAM_UNSEEKABLE);
+                    return false;
+                }
+
+                int64_t position = 0;
+                if (!ResolveSeekPosition(offset, seekBasis, totalLength, position))
+                {
+                    return false;
+                }
+
+                size_t index = 0;
+                for (; index < m_segments.size(); ++index)
+                {
+                    if (position < m_segments[index].length)
+                    {
+                        break;
+                    }
+
+                    position -= m_segments[index].length;
+                }
+
+                if (!EnterSegment(index, position))
+                {
+                    m_readFailed = true;
+                    return false;
+                }
+
+                return true;
+            }
         } // namespace Io
     }     // namespace Crt
 } // namespace Aws
@@ -0,0 +1,147 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/io/ThrottledInputStream.h>
+
+#include <aws/common/clock.h>
+
+#include <cmath>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Io
+        {
+            static const double s_NanosPerSecond = 1000000000.0;
+
+            static double s_BurstFor(uint64_t bytesPerSecond, uint64_t burstBytes)
+            {
+                double burst = burstBytes ? static_cast<double>(burstBytes) : static_cast<double>(bytesPerSecond) / 10;
+                return burst < 1 ? 1 : burst;
+            }
+
+            TokenBucket::TokenBucket(uint64_t bytesPerSecond, uint64_t burstBytes) noexcept
+                : m_bytesPerSecond(static_cast<double>(bytesPerSecond)),
+                  m_burstBytes(s_BurstFor(bytesPerSecond, burstBytes)), m_tokens(m_burstBytes), m_lastRefillNs(0)
+            {
+                AWS_FATAL_ASSERT(bytesPerSecond > 0);
+                aws_high_res_clock_get_ticks(&m_lastRefillNs);
+            }
+
+            void TokenBucket::Refill() noexcept
+            {
+                uint64_t now = 0;
+                aws_high_res_clock_get_ticks(&now);
+                if (now <= m_lastRefillNs)
+                {
+                    return;
+                }
+
+                double earned = static_cast<double>(now - m_lastRefillNs) * m_bytesPerSecond / s_NanosPerSecond;
+                m_tokens = m_tokens + earned < m_burstBytes ? m_tokens + earned : m_burstBytes;
+                m_lastRefillNs = now;
+            }
+
+            size_t TokenBucket::TryAcquire(size_t requested) noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                Refill();
+
+                /* only whole tokens are handed out, fractions keep accumulating */
+                double available = std::floor(m_tokens);
+                size_t granted =
+                    static_cast<double>(requested) < available ? requested : static_cast<size_t>(available);
+                m_tokens -= static_cast<double>(granted);
+
+                return granted;
+            }
+
+            void TokenBucket::Release(size_t unused) noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                double tokens = m_tokens + static_cast<double>(unused);
+                m_tokens = tokens < m_burstBytes ? tokens : m_burstBytes;
+            }
+
+            uint64_t TokenBucket::GetDelayNs(size_t bytes) noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                Refill();
+
+                double wanted = static_cast<double>(bytes) < m_burstBytes ? static_cast<double>(bytes) : m_burstBytes;
+                if (m_tokens >= wanted)
+                {
+                    return 0;
+                }
+
+                return static_cast<uint64_t>(std::ceil((wanted - m_tokens) * s_NanosPerSecond / m_bytesPerSecond));
+            }
+
+            void TokenBucket::SetRate(uint64_t bytesPerSecond, uint64_t burstBytes) noexcept
+            {
+                AWS_FATAL_ASSERT(bytesPerSecond > 0);
+                std::lock_guard<std::mutex> lock(m_lock);
+
+                /* settle what was earned at the old rate first */
+                Refill();
+                m_bytesPerSecond = static_cast<double>(bytesPerSecond);
+                m_burstBytes = s_BurstFor(bytesPerSecond, burstBytes);
+                m_tokens = m_tokens < m_burstBytes ? m_tokens : m_burstBytes;
+            }
+
+            uint64_t TokenBucket::GetRate() const noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                return static_cast<uint64_t>(m_bytesPerSecond);
+            }
+
+            ThrottledInputStream::ThrottledInputStream(
+                const std::shared_ptr<InputStream> &source,
+                const std::shared_ptr<TokenBucket> &bucket,
+                Aws::Crt::Allocator *allocator) noexcept
+                : InputStream(allocator), m_source(source), m_bucket(bucket)
+            {
+            }
+
+            bool ThrottledInputStream::IsValid() const noexcept { return m_source && m_bucket && m_source->IsValid(); }
+
+            bool ThrottledInputStream::ReadImpl(ByteBuf &buffer) noexcept
+            {
+                size_t granted = m_bucket->TryAcquire(buffer.capacity - buffer.len);
+                if (granted == 0)
+                {
+                    return true;
+                }
+
+                ByteBuf allowance = aws_byte_buf_from_empty_array(buffer.buffer + buffer.len, granted);
+                bool succeeded = m_source->Read(allowance);
+                buffer.len += allowance.len;
+                m_bucket->Release(granted - allowance.len);
+
+                return succeeded;
+            }
+
+            StreamStatus ThrottledInputStream::GetStatusImpl() const noexcept
+            {
+                StreamStatus status;
+                AWS_ZERO_STRUCT(status);
+                m_source->GetStatus(status);
+
+                return status;
+            }
+
+            int64_t ThrottledInputStream::GetLengthImpl() const noexcept
+            {
+                int64_t length = -1;
+                return m_source->GetLength(length) ? length : -1;
+            }
+
+            bool ThrottledInputStream::SeekImpl(OffsetType offset, StreamSeekBasis seekBasis) noexcept
+            {
+                return m_source->Seek(offset, seekBasis);
+            }
+        } // namespace Io
+    }     // namespace Crt
+} // namespace Aws
@@ -5,9 +5,14 @@
 #include <aws/crt/io/TlsOptions.h>
 
 #include <aws/crt/Api.h>
+#include <aws/crt/crypto/Hash.h>
+#include <aws/common/string.h>
 #include <aws/io/logging.h>
 #include <aws/io/tls_channel_handler.h>
 
+#include <cstring>
+#include <mutex>
+
 namespace Aws
 {
     namespace Crt
@@ -22,11 +27,17 @@ namespace Aws
                 }
             }
 
-            TlsContextOptions::TlsContextOptions() noexcept : m_isInit(false) { AWS_ZERO_STRUCT(m_options); }
+            TlsContextOptions::TlsContextOptions() noexcept : m_isInit(false)
+            {
+                /* every Init* factory starts from here, before the options are loaded */
+                ApiHandle::InitializeSubsystem(ApiSubsystem::Io);
+                AWS_ZERO_STRUCT(m_options);
+            }
 
             TlsContextOptions::TlsContextOptions(TlsContextOptions &&other) noexcept
             {
                 m_options = other.m_options;
+                m_sessionCache = std::move(other.m_sessionCache);
                 m_isInit = other.m_isInit;
                 AWS_ZERO_STRUCT(other.m_options);
                 other.m_isInit = false;
@@ -42,6 +53,7 @@ namespace Aws
                     }
 
                     m_options = other.m_options;
+                    m_sessionCache = std::move(other.m_sessionCache);
                     m_isInit = other.m_isInit;
                     AWS_ZERO_STRUCT(other.m_options);
                     other.m_isInit = false;
@@ -145,6 +157,18 @@ namespace Aws
                 aws_tls_ctx_options_set_minimum_tls_version(&m_options, minimumTlsVersion);
             }
 
+#if BYO_CRYPTO
+            void TlsContextOptions::SetSessionCache(const std::shared_ptr<TlsSessionCache> &sessionCache) noexcept
+            {
+                m_sessionCache = sessionCache;
+            }
+#else  // BYO_CRYPTO
+            void TlsContextOptions::SetSessionCache(const std::shared_ptr<TlsSessionCache> &) noexcept
+            {
+                AWS_LOGF_WARN(AWS_LS_IO_TLS, "SetSessionCache() has no effect unless compiled with BYO_CRYPTO");
+            }
+#endif // BYO_CRYPTO
+
             bool TlsContextOptions::OverrideDefaultTrustStore(const char *caPath, const char *caFile) noexcept
             {
                 AWS_ASSERT(m_isInit);
@@ -287,8 +311,10 @@ namespace Aws
             TlsContext::TlsContext() noexcept : m_ctx(nullptr), m_initializationError(AWS_ERROR_SUCCESS) {}
 
             TlsContext::TlsContext(TlsContextOptions &options, TlsMode mode, Allocator *allocator) noexcept
-                : m_ctx(nullptr), m_initializationError(AWS_ERROR_SUCCESS)
+                : m_ctx(nullptr), m_sessionCache(options.m_sessionCache), m_initializationError(AWS_ERROR_SUCCESS)
             {
+                ApiHandle::InitializeSubsystem(ApiSubsystem::Io);
+
 #if BYO_CRYPTO
                 if (!ApiHandle::GetBYOCryptoNewTlsContextImplCallback() ||
                     !ApiHandle::GetBYOCryptoDeleteTlsContextImplCallback())
@@ -344,6 +370,161 @@ namespace Aws
 #endif // BYO_CRYPTO
             }
 
+            struct CachedTlsContext
+            {
+                std::weak_ptr<aws_tls_ctx> ctx;
+                std::shared_ptr<TlsSessionCache> sessionCache;
+            };
+
+            using TlsContextCache = Map<String, CachedTlsContext>;
+
+            static std::mutex s_tlsContextCacheLock;
+            static TlsContextCache *s_tlsContextCache = nullptr;
+            static Allocator *s_tlsContextCacheAllocator = nullptr;
+
+            static void s_AppendKeyBytes(Crypto::Hash &key, const uint8_t *bytes, size_t length)
+            {
+                uint64_t prefix = length;
+                key.Update(ByteCursorFromArray(reinterpret_cast<const uint8_t *>(&prefix), sizeof(prefix)));
+                if (length > 0)
+                {
+                    key.Update(ByteCursorFromArray(bytes, length));
+                }
+            }
+
+            static void s_AppendKeyBuf(Crypto::Hash &key, const aws_byte_buf &buf)
+            {
+                s_AppendKeyBytes(key, buf.buffer, buf.len);
+            }
+
+            static void s_AppendKeyString(Crypto::Hash &key, const aws_string *string)
+            {
+                if (string == nullptr)
+                {
+                    s_AppendKeyBytes(key, nullptr, 0);
+                    return;
+                }
+                s_AppendKeyBytes(key, aws_string_bytes(string), string->len);
+            }
+
+            template <typename T> static void s_AppendKeyValue(Crypto::Hash &key, const T &value)
+            {
+                s_AppendKeyBytes(key, reinterpret_cast<const uint8_t *>(&value), sizeof(value));
+            }
+
+            /* The SHA256 of everything a built context depends on, each field length-prefixed so no two option sets
+             * hash the same bytes. Only the digest is kept, never the certificate, private key or password. Fails,
+             * leaving the context uncached, if there is no SHA256 to key it with. */
+            static bool s_TlsContextCacheKey(
+                const TlsContextOptions &options,
+                TlsMode mode,
+                Allocator *allocator,
+                String &key)
+            {
+                const aws_tls_ctx_options &ctxOptions = *options.GetUnderlyingHandle();
+
+                Crypto::Hash material = Crypto::Hash::CreateSHA256(g_allocator);
+                s_AppendKeyValue(material, mode);
+                s_AppendKeyValue(material, allocator);
+                s_AppendKeyValue(material, options.GetSessionCache().get());
+                s_AppendKeyValue(material, ctxOptions.minimum_tls_version);
+                s_AppendKeyValue(material, ctxOptions.cipher_pref);
+                s_AppendKeyValue(material, ctxOptions.max_fragment_size);
+                s_AppendKeyValue(material, ctxOptions.verify_peer);
+                s_AppendKeyValue(material, ctxOptions.ctx_options_extension);
+                s_AppendKeyBuf(material, ctxOptions.ca_file);
+                s_AppendKeyString(material, ctxOptions.ca_path);
+                s_AppendKeyString(material, ctxOptions.alpn_list);
+                s_AppendKeyBuf(material, ctxOptions.certificate);
+                s_AppendKeyBuf(material, ctxOptions.private_key);
+#ifdef __APPLE__
+                s_AppendKeyBuf(material, ctxOptions.pkcs12);
+                s_AppendKeyBuf(material, ctxOptions.pkcs12_password);
+#    if !defined(AWS_OS_IOS)
+                s_AppendKeyString(material, ctxOptions.keychain_path);
+#    endif
+#endif
+#ifdef _WIN32
+                s_AppendKeyBytes(
+                    material,
+                    reinterpret_cast<const uint8_t *>(ctxOptions.system_certificate_path),
+                    ctxOptions.system_certificate_path != nullptr ? strlen(ctxOptions.system_certificate_path) : 0);
+#endif
+
+                Crypto::SHA256Digest digest;
+                if (!material.Digest(digest))
+                {
+                    return false;
+                }
+
+                key.assign(reinterpret_cast<const char *>(digest.data()), digest.size());
+                return true;
+            }
+
+            TlsContext TlsContext::GetOrCreate(TlsContextOptions &options, TlsMode mode, Allocator *allocator) noexcept
+            {
+                String key;
+                if (!s_TlsContextCacheKey(options, mode, allocator, key))
+                {
+                    return TlsContext(options, mode, allocator);
+                }
+
+                std::lock_guard<std::mutex> lock(s_tlsContextCacheLock);
+                if (s_tlsContextCache == nullptr)
+                {
+                    s_tlsContextCache = New<TlsContextCache>(g_allocator);
+                    if (s_tlsContextCache == nullptr)
+                    {
+                        return TlsContext(options, mode, allocator);
+                    }
+                    s_tlsContextCacheAllocator = g_allocator;
+                }
+
+                for (auto iter = s_tlsContextCache->begin(); iter != s_tlsContextCache->end();)
+                {
+                    if (iter->second.ctx.expired())
+                    {
+                        iter = s_tlsContextCache->erase(iter);
+                    }
+                    else
+                    {
+                        ++iter;
+                    }
+                }
+
+                auto cached = s_tlsContextCache->find(key);
+                if (cached != s_tlsContextCache->end())
+                {
+                    TlsContext context;
+                    context.m_ctx = cached->second.ctx.lock();
+                    context.m_sessionCache = cached->second.sessionCache;
+                    if (context.m_ctx)
+                    {
+                        return context;
+                    }
+                }
+
+                TlsContext context(options, mode, allocator);
+                if (context)
+                {
+                    CachedTlsContext &entry = (*s_tlsContextCache)[key];
+                    entry.ctx = context.m_ctx;
+                    entry.sessionCache = context.m_sessionCache;
+                }
+                return context;
+            }
+
+            void TlsContext::ClearCache() noexcept
+            {
+                std::lock_guard<std::mutex> lock(s_tlsContextCacheLock);
+                if (s_tlsContextCache != nullptr)
+                {
+                    Delete(s_tlsContextCache, s_tlsContextCacheAllocator);
+                    s_tlsContextCache = nullptr;
+                    s_tlsContextCacheAllocator = nullptr;
+                }
+            }
+
             TlsConnectionOptions TlsContext::NewConnectionOptions() const noexcept
             {
                 if (!isValid())
@@ -0,0 +1,119 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/io/TlsSessionCache.h>
+
+#include <iterator>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Io
+        {
+            TlsSessionCache::TlsSessionCache(const TlsSessionCacheOptions &options) noexcept : m_options(options) {}
+
+            void TlsSessionCache::Store(
+                const String &serverName,
+                const ByteCursor &session,
+                std::chrono::seconds lifetimeHint) noexcept
+            {
+                if (m_options.MaxEntries == 0 || session.len == 0)
+                {
+                    return;
+                }
+
+                std::chrono::seconds lifetime = m_options.SessionLifetime;
+                if (lifetimeHint.count() > 0 && lifetimeHint < lifetime)
+                {
+                    lifetime = lifetimeHint;
+                }
+
+                std::lock_guard<std::mutex> lock(m_lock);
+                auto existing = m_index.find(serverName);
+                if (existing != m_index.end())
+                {
+                    Erase(existing->second);
+                }
+                else if (m_entries.size() >= m_options.MaxEntries)
+                {
+                    Erase(std::prev(m_entries.end()));
+                    ++m_statistics.Evictions;
+                }
+
+                Entry entry;
+                entry.serverName = serverName;
+                entry.session.assign(session.ptr, session.ptr + session.len);
+                entry.expiresAt = std::chrono::steady_clock::now() + lifetime;
+                m_entries.push_front(std::move(entry));
+                m_index[serverName] = m_entries.begin();
+                ++m_statistics.Stores;
+            }
+
+            bool TlsSessionCache::Retrieve(const String &serverName, ByteBuf &session) noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                auto iter = m_index.find(serverName);
+                if (iter == m_index.end())
+                {
+                    ++m_statistics.Misses;
+                    return false;
+                }
+
+                auto entry = iter->second;
+                if (entry->expiresAt <= std::chrono::steady_clock::now())
+                {
+                    Erase(entry);
+                    ++m_statistics.Misses;
+                    return false;
+                }
+
+                ByteCursor stored = ByteCursorFromArray(entry->session.data(), entry->session.size());
+                if (aws_byte_buf_append_dynamic(&session, &stored) != AWS_OP_SUCCESS)
+                {
+                    return false;
+                }
+
+                m_entries.splice(m_entries.begin(), m_entries, entry);
+                ++m_statistics.Hits;
+                return true;
+            }
+
+            void TlsSessionCache::Remove(const String &serverName) noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                auto iter = m_index.find(serverName);
+                if (iter != m_index.end())
+                {
+                    Erase(iter->second);
+                }
+            }
+
+            void TlsSessionCache::Clear() noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                m_index.clear();
+                m_entries.clear();
+            }
+
+            size_t TlsSessionCache::GetSize() const noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                return m_entries.size();
+            }
+
+            TlsSessionCacheStatistics TlsSessionCache::GetStatistics() const noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                return m_statistics;
+            }
+
+            void TlsSessionCache::Erase(List<Entry>::iterator entry) noexcept
+            {
+                m_index.erase(entry->serverName);
+                m_entries.erase(entry);
+            }
+        } // namespace Io
+    }     // namespace Crt
+} // namespace Aws
@@ -0,0 +1,255 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/mqtt/MessageWorkerPool.h>
+
+#include <aws/common/clock.h>
+
+#include <deque>
+#include <thread>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Mqtt
+        {
+            struct MessageWorkerHandler
+            {
+                uint64_t id;
+                OnMessageReceivedHandler handler;
+            };
+
+            struct QueuedMessage
+            {
+                std::shared_ptr<MessageWorkerHandler> handler;
+                MqttConnection *connection;
+                String topic;
+                Vector<uint8_t> payload;
+                bool dup;
+                QOS qos;
+                bool retain;
+                uint64_t enqueuedTimestampNs;
+            };
+
+            struct MessageWorker
+            {
+                explicit MessageWorker(Allocator *allocator)
+                    : queue(StlAllocator<QueuedMessage>(allocator)), stop(false)
+                {
+                }
+
+                std::thread thread;
+                std::mutex lock;
+                std::condition_variable wakeUp;
+                std::deque<QueuedMessage, StlAllocator<QueuedMessage>> queue;
+                bool stop;
+            };
+
+            static uint64_t s_HashTopic(StringView topic) noexcept
+            {
+                uint64_t hash = 14695981039346656037ULL;
+                for (char c : topic)
+                {
+                    hash ^= static_cast<uint8_t>(c);
+                    hash *= 1099511628211ULL;
+                }
+                return hash;
+            }
+
+            MessageWorkerPool::MessageWorkerPool(const MessageWorkerPoolOptions &options, Allocator *allocator) noexcept
+                : m_allocator(allocator), m_options(options), m_workers(StlAllocator<MessageWorker *>(allocator)),
+                  m_nextHandlerId(1), m_shuttingDown(false)
+            {
+                size_t threadCount = options.ThreadCount;
+                if (threadCount == 0)
+                {
+                    threadCount = std::thread::hardware_concurrency();
+                    threadCount = threadCount ? threadCount : 1;
+                }
+
+                if (m_options.MaxQueuedMessages == 0)
+                {
+                    m_options.MaxQueuedMessages = 1;
+                }
+
+                m_workers.reserve(threadCount);
+                for (size_t i = 0; i < threadCount; ++i)
+                {
+                    auto worker = Crt::New<MessageWorker>(allocator, allocator);
+                    if (!worker)
+                    {
+                        break;
+                    }
+
+                    try
+                    {
+                        worker->thread = std::thread([this, worker]() { RunWorker(*worker); });
+                    }
+                    catch (...)
+                    {
+                        Crt::Delete(worker, allocator);
+                        break;
+                    }
+
+                    m_workers.push_back(worker);
+                }
+            }
+
+            MessageWorkerPool::~MessageWorkerPool()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_lock);
+                    m_shuttingDown = true;
+                }
+                m_spaceAvailable.notify_all();
+
+                /* each worker handles what is left in its queue before it exits */
+                for (MessageWorker *worker : m_workers)
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(worker->lock);
+                        worker->stop = true;
+                    }
+                    worker->wakeUp.notify_one();
+                    worker->thread.join();
+                    Crt::Delete(worker, m_allocator);
+                }
+            }
+
+            OnMessageReceivedViewHandler MessageWorkerPool::Wrap(OnMessageReceivedHandler &&handler) noexcept
+            {
+                auto workerHandler = MakeShared<MessageWorkerHandler>(m_allocator);
+                if (!workerHandler)
+                {
+                    return nullptr;
+                }
+
+                workerHandler->id = m_nextHandlerId++;
+                workerHandler->handler = std::move(handler);
+
+                return [this, workerHandler](
+                           MqttConnection &connection,
+                           StringView topic,
+                           const ByteCursor &payload,
+                           bool dup,
+                           QOS qos,
+                           bool retain) { Enqueue(workerHandler, connection, topic, payload, dup, qos, retain); };
+            }
+
+            void MessageWorkerPool::Enqueue(
+                const std::shared_ptr<MessageWorkerHandler> &handler,
+                MqttConnection &connection,
+                StringView topic,
+                const ByteCursor &payload,
+                bool dup,
+                QOS qos,
+                bool retain) noexcept
+            {
+                if (m_workers.empty())
+                {
+                    return;
+                }
+
+                {
+                    std::unique_lock<std::mutex> lock(m_lock);
+                    if (!m_shuttingDown && m_metrics.QueuedMessages >= m_options.MaxQueuedMessages &&
+                        m_options.OverflowPolicy == MessageOverflowPolicy::Block)
+                    {
+                        ++m_metrics.Blocked;
+                        m_spaceAvailable.wait(lock, [this]() {
+                            return m_shuttingDown || m_metrics.QueuedMessages < m_options.MaxQueuedMessages;
+                        });
+                    }
+
+                    if (m_shuttingDown || m_metrics.QueuedMessages >= m_options.MaxQueuedMessages)
+                    {
+                        ++m_metrics.Dropped;
+                        return;
+                    }
+
+                    ++m_metrics.Enqueued;
+                    ++m_metrics.QueuedMessages;
+                    if (m_metrics.QueuedMessages > m_metrics.PeakQueuedMessages)
+                    {
+                        m_metrics.PeakQueuedMessages = m_metrics.QueuedMessages;
+                    }
+                }
+
+                QueuedMessage message{
+                    handler,
+                    &connection,
+                    String(topic.data(), topic.size(), StlAllocator<char>(m_allocator)),
+                    Vector<uint8_t>(payload.ptr, payload.ptr + payload.len, StlAllocator<uint8_t>(m_allocator)),
+                    dup,
+                    qos,
+                    retain,
+                    0};
+                aws_high_res_clock_get_ticks(&message.enqueuedTimestampNs);
+
+                uint64_t key = m_options.Ordering == MessageOrdering::PerTopic ? s_HashTopic(topic) : handler->id;
+                MessageWorker *worker = m_workers[key % m_workers.size()];
+                {
+                    std::lock_guard<std::mutex> lock(worker->lock);
+                    worker->queue.push_back(std::move(message));
+                }
+                worker->wakeUp.notify_one();
+            }
+
+            void MessageWorkerPool::RunWorker(MessageWorker &worker) noexcept
+            {
+                for (;;)
+                {
+                    std::unique_lock<std::mutex> workerLock(worker.lock);
+                    worker.wakeUp.wait(workerLock, [&worker]() { return worker.stop || !worker.queue.empty(); });
+                    if (worker.queue.empty())
+                    {
+                        return;
+                    }
+
+                    QueuedMessage message = std::move(worker.queue.front());
+                    worker.queue.pop_front();
+                    workerLock.unlock();
+
+                    uint64_t dequeuedTimestampNs = 0;
+                    aws_high_res_clock_get_ticks(&dequeuedTimestampNs);
+
+                    if (message.handler->handler)
+                    {
+                        ByteBuf payload = aws_byte_buf_from_array(message.payload.data(), message.payload.size());
+                        message.handler->handler(
+                            *message.connection, message.topic, payload, message.dup, message.qos, message.retain);
+                    }
+
+                    bool drained = false;
+                    {
+                        std::lock_guard<std::mutex> lock(m_lock);
+                        --m_metrics.QueuedMessages;
+                        ++m_metrics.Handled;
+                        m_metrics.TotalQueueDelayNs += dequeuedTimestampNs - message.enqueuedTimestampNs;
+                        drained = m_metrics.QueuedMessages == 0;
+                    }
+
+                    m_spaceAvailable.notify_one();
+                    if (drained)
+                    {
+                        m_drained.notify_all();
+                    }
+                }
+            }
+
+            MessageWorkerPoolMetrics MessageWorkerPool::GetMetrics() const noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                return m_metrics;
+            }
+
+            void MessageWorkerPool::Drain() noexcept
+            {
+                std::unique_lock<std::mutex> lock(m_lock);
+                m_drained.wait(lock, [this]() { return m_metrics.QueuedMessages == 0; });
+            }
+        } // namespace Mqtt
+    }     // namespace Crt
+} // namespace Aws
@@ -0,0 +1,414 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/mqtt/MqttChunkedTransfer.h>
+
+#include <aws/common/clock.h>
+#include <aws/common/device_random.h>
+#include <aws/common/math.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Mqtt
+        {
+            const size_t MqttChunkedPublisher::DefaultMaxChunkPayload;
+
+            static const uint8_t s_chunkMagic = 0xc7;
+            static const uint8_t s_chunkVersion = 1;
+
+            struct ChunkHeader
+            {
+                uint32_t transferId;
+                uint32_t totalLength;
+                uint32_t chunkSize;
+                uint32_t chunkIndex;
+            };
+
+            static size_t s_ChunkCount(size_t totalLength, size_t chunkSize) noexcept
+            {
+                return totalLength == 0 ? 1 : (totalLength + chunkSize - 1) / chunkSize;
+            }
+
+            static void s_WriteChunkHeader(uint8_t *destination, const ChunkHeader &header) noexcept
+            {
+                ByteBuf buffer = aws_byte_buf_from_empty_array(destination, MQTT_CHUNK_HEADER_LENGTH);
+                aws_byte_buf_write_u8(&buffer, s_chunkMagic);
+                aws_byte_buf_write_u8(&buffer, s_chunkVersion);
+                aws_byte_buf_write_be16(&buffer, 0);
+                aws_byte_buf_write_be32(&buffer, header.transferId);
+                aws_byte_buf_write_be32(&buffer, header.totalLength);
+                aws_byte_buf_write_be32(&buffer, header.chunkSize);
+                aws_byte_buf_write_be32(&buffer, header.chunkIndex);
+            }
+
+            /* checks the header against the chunk it came with, and leaves chunk on the chunk's own bytes */
+            static bool s_ReadChunkHeader(ByteCursor &chunk, ChunkHeader &header) noexcept
+            {
+                uint8_t magic = 0;
+                uint8_t version = 0;
+                uint16_t reserved = 0;
+                if (!aws_byte_cursor_read_u8(&chunk, &magic) || !aws_byte_cursor_read_u8(&chunk, &version) ||
+                    !aws_byte_cursor_read_be16(&chunk, &reserved) ||
+                    !aws_byte_cursor_read_be32(&chunk, &header.transferId) ||
+                    !aws_byte_cursor_read_be32(&chunk, &header.totalLength) ||
+                    !aws_byte_cursor_read_be32(&chunk, &header.chunkSize) ||
+                    !aws_byte_cursor_read_be32(&chunk, &header.chunkIndex))
+                {
+                    return false;
+                }
+
+                if (magic != s_chunkMagic || version != s_chunkVersion ||
+                    (header.chunkSize == 0 && header.totalLength != 0))
+                {
+                    return false;
+                }
+
+                size_t chunkCount = s_ChunkCount(header.totalLength, header.chunkSize);
+                if (header.chunkIndex >= chunkCount)
+                {
+                    return false;
+                }
+
+                size_t offset = static_cast<size_t>(header.chunkIndex) * header.chunkSize;
+                size_t remaining = header.totalLength - offset;
+                return chunk.len == (remaining < header.chunkSize ? remaining : header.chunkSize);
+            }
+
+            struct ChunkedPublishState
+            {
+                ChunkedPublishState(OnChunkedPublishCompleteHandler &&onComplete, size_t pending)
+                    : onComplete(std::move(onComplete)), pending(pending), errorCode(AWS_ERROR_SUCCESS)
+                {
+                }
+
+                OnChunkedPublishCompleteHandler onComplete;
+                std::atomic<size_t> pending;
+                std::atomic<int> errorCode;
+            };
+
+            static void s_CompleteChunk(
+                MqttConnection &connection,
+                const std::shared_ptr<ChunkedPublishState> &state,
+                int errorCode) noexcept
+            {
+                if (errorCode != AWS_ERROR_SUCCESS)
+                {
+                    int expected = AWS_ERROR_SUCCESS;
+                    state->errorCode.compare_exchange_strong(expected, errorCode);
+                }
+
+                if (--state->pending == 0 && state->onComplete)
+                {
+                    state->onComplete(connection, state->errorCode.load());
+                }
+            }
+
+            MqttChunkedPublisher::MqttChunkedPublisher(
+                const std::shared_ptr<MqttConnection> &connection,
+                size_t maxChunkPayload,
+                Allocator *allocator) noexcept
+                : m_allocator(allocator), m_connection(connection),
+                  m_maxChunkPayload(maxChunkPayload ? maxChunkPayload : 1), m_nextTransferId(0)
+            {
+                /* publishers sharing a topic must not reuse each other's transfer ids */
+                uint32_t seed = 0;
+                if (aws_device_random_u32(&seed))
+                {
+                    uint64_t now = 0;
+                    aws_high_res_clock_get_ticks(&now);
+                    seed = static_cast<uint32_t>(now ^ (now >> 32));
+                }
+                m_nextTransferId = seed;
+            }
+
+            size_t MqttChunkedPublisher::GetChunkCount(size_t payloadLength) const noexcept
+            {
+                return s_ChunkCount(payloadLength, m_maxChunkPayload);
+            }
+
+            bool MqttChunkedPublisher::Publish(
+                const char *topic,
+                QOS qos,
+                const ByteCursor &payload,
+                OnChunkedPublishCompleteHandler &&onComplete) noexcept
+            {
+                if (!m_connection || topic == nullptr || payload.len > UINT32_MAX ||
+                    m_maxChunkPayload > UINT32_MAX)
+                {
+                    aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                    return false;
+                }
+
+                size_t chunkCount = GetChunkCount(payload.len);
+                size_t headersLength = 0;
+                size_t wireLength = 0;
+                if (aws_mul_size_checked(chunkCount, MQTT_CHUNK_HEADER_LENGTH, &headersLength) ||
+                    aws_add_size_checked(headersLength, payload.len, &wireLength))
+                {
+                    return false;
+                }
+
+                /* every chunk, header and all, in one allocation that the publishes keep alive */
+                auto *wireBytes = static_cast<uint8_t *>(aws_mem_acquire(m_allocator, wireLength));
+                if (wireBytes == nullptr)
+                {
+                    return false;
+                }
+
+                Allocator *allocator = m_allocator;
+                std::shared_ptr<uint8_t> wire(
+                    wireBytes, [allocator](uint8_t *bytes) { aws_mem_release(allocator, bytes); });
+
+                /* one extra count, so acks racing the loop below can not complete the transfer early */
+                auto state = MakeShared<ChunkedPublishState>(m_allocator, std::move(onComplete), chunkCount + 1);
+                if (!state)
+                {
+                    return false;
+                }
+
+                ChunkHeader header;
+                header.transferId = m_nextTransferId++;
+                header.totalLength = static_cast<uint32_t>(payload.len);
+                header.chunkSize = static_cast<uint32_t>(m_maxChunkPayload);
+
+                bool anyPublished = false;
+                for (size_t i = 0; i < chunkCount; ++i)
+                {
+                    size_t offset = i * m_maxChunkPayload;
+                    size_t length = payload.len - offset < m_maxChunkPayload ? payload.len - offset : m_maxChunkPayload;
+                    uint8_t *chunk = wireBytes + i * (MQTT_CHUNK_HEADER_LENGTH + m_maxChunkPayload);
+
+                    header.chunkIndex = static_cast<uint32_t>(i);
+                    s_WriteChunkHeader(chunk, header);
+                    if (length > 0)
+                    {
+                        memcpy(chunk + MQTT_CHUNK_HEADER_LENGTH, payload.ptr + offset, length);
+                    }
+
+                    uint16_t packetId = m_connection->Publish(
+                        topic,
+                        qos,
+                        false,
+                        wire,
+                        aws_byte_cursor_from_array(chunk, MQTT_CHUNK_HEADER_LENGTH + length),
+                        [state](MqttConnection &connection, uint16_t, int errorCode) {
+                            s_CompleteChunk(connection, state, errorCode);
+                        });
+                    if (packetId == 0)
+                    {
+                        /* the rest can not be put back together without this one, so do not send them */
+                        int expected = AWS_ERROR_SUCCESS;
+                        state->errorCode.compare_exchange_strong(expected, aws_last_error());
+                        state->pending -= chunkCount - i;
+                        break;
+                    }
+
+                    anyPublished = true;
+                }
+
+                if (!anyPublished)
+                {
+                    aws_raise_error(state->errorCode.load());
+                    return false;
+                }
+
+                s_CompleteChunk(*m_connection, state, AWS_ERROR_SUCCESS);
+                return true;
+            }
+
+            struct ChunkedTransfer
+            {
+                ChunkedTransfer(Allocator *allocator, StringView topic, const ChunkHeader &header)
+                    : topic(topic.data(), topic.size(), StlAllocator<char>(allocator)), header(header),
+                      payload(header.totalLength, 0, StlAllocator<uint8_t>(allocator)),
+                      received(
+                          s_ChunkCount(header.totalLength, header.chunkSize), false, StlAllocator<bool>(allocator)),
+                      receivedChunks(0), lastSequence(0)
+                {
+                }
+
+                String topic;
+                ChunkHeader header;
+                Vector<uint8_t> payload;
+                Vector<bool> received;
+                size_t receivedChunks;
+                uint64_t lastSequence;
+            };
+
+            static uint64_t s_TransferKey(StringView topic, uint32_t transferId) noexcept
+            {
+                uint64_t hash = 14695981039346656037ULL;
+                for (char c : topic)
+                {
+                    hash ^= static_cast<uint8_t>(c);
+                    hash *= 1099511628211ULL;
+                }
+                return hash ^ (static_cast<uint64_t>(transferId) * 0x9e3779b97f4a7c15ULL);
+            }
+
+            MqttChunkReassembler::MqttChunkReassembler(
+                OnChunkedMessageReceivedHandler &&onMessage,
+                size_t maxPayloadLength,
+                size_t maxPendingTransfers,
+                Allocator *allocator) noexcept
+                : m_allocator(allocator), m_onMessage(std::move(onMessage)), m_maxPayloadLength(maxPayloadLength),
+                  m_maxPendingTransfers(maxPendingTransfers ? maxPendingTransfers : 1),
+                  m_transfers(StlAllocator<std::pair<const uint64_t, std::shared_ptr<ChunkedTransfer>>>(allocator)),
+                  m_completedKeys(m_maxPendingTransfers, 0, StlAllocator<uint64_t>(allocator)), m_nextCompletedKey(0),
+                  m_sequence(0)
+            {
+            }
+
+            MqttChunkReassembler::~MqttChunkReassembler() = default;
+
+            OnMessageReceivedViewHandler MqttChunkReassembler::GetOnMessageHandler() noexcept
+            {
+                return [this](
+                           MqttConnection &connection,
+                           StringView topic,
+                           const ByteCursor &payload,
+                           bool,
+                           QOS,
+                           bool) { OnChunk(connection, topic, payload); };
+            }
+
+            void MqttChunkReassembler::EvictStalest() noexcept
+            {
+                auto stalest = m_transfers.end();
+                for (auto it = m_transfers.begin(); it != m_transfers.end(); ++it)
+                {
+                    if (stalest == m_transfers.end() || it->second->lastSequence < stalest->second->lastSequence)
+                    {
+                        stalest = it;
+                    }
+                }
+
+                if (stalest != m_transfers.end())
+                {
+                    m_metrics.PendingBytes -= stalest->second->payload.size();
+                    ++m_metrics.EvictedTransfers;
+                    m_transfers.erase(stalest);
+                }
+            }
+
+            bool MqttChunkReassembler::OnChunk(
+                MqttConnection &connection,
+                StringView topic,
+                const ByteCursor &chunk) noexcept
+            {
+                ByteCursor data = chunk;
+                ChunkHeader header;
+                if (!s_ReadChunkHeader(data, header) || header.totalLength > m_maxPayloadLength)
+                {
+                    std::lock_guard<std::mutex> lock(m_lock);
+                    ++m_metrics.RejectedChunks;
+                    return false;
+                }
+
+                if (s_ChunkCount(header.totalLength, header.chunkSize) == 1)
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(m_lock);
+                        ++m_metrics.CompletedTransfers;
+                    }
+
+                    if (m_onMessage)
+                    {
+                        m_onMessage(connection, topic, data);
+                    }
+                    return true;
+                }
+
+                std::shared_ptr<ChunkedTransfer> completed;
+                {
+                    std::lock_guard<std::mutex> lock(m_lock);
+
+                    uint64_t key = s_TransferKey(topic, header.transferId);
+                    if (std::find(m_completedKeys.begin(), m_completedKeys.end(), key) != m_completedKeys.end())
+                    {
+                        ++m_metrics.DuplicateChunks;
+                        return true;
+                    }
+
+                    auto found = m_transfers.find(key);
+                    if (found != m_transfers.end() &&
+                        (StringView(found->second->topic.data(), found->second->topic.size()) != topic ||
+                         found->second->header.transferId != header.transferId ||
+                         found->second->header.totalLength != header.totalLength ||
+                         found->second->header.chunkSize != header.chunkSize))
+                    {
+                        /* a different transfer that hashed alike, or a sender that restarted: keep the newer one */
+                        m_metrics.PendingBytes -= found->second->payload.size();
+                        ++m_metrics.EvictedTransfers;
+                        m_transfers.erase(found);
+                        found = m_transfers.end();
+                    }
+
+                    if (found == m_transfers.end())
+                    {
+                        if (m_transfers.size() >= m_maxPendingTransfers)
+                        {
+                            EvictStalest();
+                        }
+
+                        auto transfer = MakeShared<ChunkedTransfer>(m_allocator, m_allocator, topic, header);
+                        if (!transfer)
+                        {
+                            ++m_metrics.RejectedChunks;
+                            return false;
+                        }
+
+                        m_metrics.PendingBytes += transfer->payload.size();
+                        found = m_transfers.emplace(key, std::move(transfer)).first;
+                    }
+
+                    ChunkedTransfer &transfer = *found->second;
+                    transfer.lastSequence = ++m_sequence;
+                    if (transfer.received[header.chunkIndex])
+                    {
+                        ++m_metrics.DuplicateChunks;
+                        return true;
+                    }
+
+                    size_t offset = static_cast<size_t>(header.chunkIndex) * header.chunkSize;
+                    memcpy(transfer.payload.data() + offset, data.ptr, data.len);
+                    transfer.received[header.chunkIndex] = true;
+
+                    if (++transfer.receivedChunks == transfer.received.size())
+                    {
+                        completed = std::move(found->second);
+                        m_transfers.erase(found);
+                        m_completedKeys[m_nextCompletedKey] = key;
+                        m_nextCompletedKey = (m_nextCompletedKey + 1) % m_completedKeys.size();
+                        m_metrics.PendingBytes -= completed->payload.size();
+                        ++m_metrics.CompletedTransfers;
+                    }
+                }
+
+                if (completed && m_onMessage)
+                {
+                    m_onMessage(
+                        connection,
+                        StringView(completed->topic.data(), completed->topic.size()),
+                        aws_byte_cursor_from_array(completed->payload.data(), completed->payload.size()));
+                }
+
+                return true;
+            }
+
+            MqttChunkReassemblerMetrics MqttChunkReassembler::GetMetrics() const noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                MqttChunkReassemblerMetrics metrics = m_metrics;
+                metrics.PendingTransfers = m_transfers.size();
+                return metrics;
+            }
+        } // namespace Mqtt
+    }     // namespace Crt
+} // namespace Aws
@@ -4,6 +4,9 @@
  */
 #include <aws/crt/mqtt/MqttClient.h>
 
+#include <aws/common/clock.h>
+#include <aws/crt/Api.h>
+#include <aws/crt/EventTracer.h>
 #include <aws/crt/StlAllocator.h>
 #include <aws/crt/http/HttpProxyStrategy.h>
 #include <aws/crt/http/HttpRequestResponse.h>
@@ -17,9 +20,100 @@ namespace Aws
     {
         namespace Mqtt
         {
+            MqttConnectionCounters::MqttConnectionCounters() noexcept
+                : incompleteOperationCount(0), incompleteOperationBytes(0), unackedPublishCount(0),
+                  completedOperationCount(0), failedOperationCount(0), interruptionCount(0), resumptionCount(0),
+                  totalPublishLatencyNs(0)
+            {
+                for (auto &bucket : publishLatencyBuckets)
+                {
+                    bucket = 0;
+                }
+            }
+
+            uint64_t MqttConnectionStatistics::GetPublishLatencyBucketBoundUs(size_t bucket) noexcept
+            {
+                return bucket + 1 >= MQTT_PUBLISH_LATENCY_BUCKET_COUNT ? UINT64_MAX : uint64_t(1) << bucket;
+            }
+
+            /* what an operation added to the connection's counters, taken back once it completes */
+            struct OperationStatistics
+            {
+                OperationStatistics() : bytes(0), awaitsAck(false), queuedTimestampNs(0) {}
+
+                size_t bytes;
+                bool awaitsAck;
+                uint64_t queuedTimestampNs;
+            };
+
+            static void s_OperationQueued(
+                MqttConnectionCounters &counters,
+                OperationStatistics &operation,
+                size_t bytes,
+                bool awaitsAck) noexcept
+            {
+                operation.bytes = bytes;
+                operation.awaitsAck = awaitsAck;
+                if (awaitsAck)
+                {
+                    aws_high_res_clock_get_ticks(&operation.queuedTimestampNs);
+                    ++counters.unackedPublishCount;
+                }
+
+                ++counters.incompleteOperationCount;
+                counters.incompleteOperationBytes += bytes;
+            }
+
+            static void s_OperationAbandoned(
+                MqttConnectionCounters &counters,
+                const OperationStatistics &operation) noexcept
+            {
+                if (operation.awaitsAck)
+                {
+                    --counters.unackedPublishCount;
+                }
+
+                --counters.incompleteOperationCount;
+                counters.incompleteOperationBytes -= operation.bytes;
+            }
+
+            static void s_OperationCompleted(
+                MqttConnectionCounters &counters,
+                const OperationStatistics &operation,
+                int errorCode) noexcept
+            {
+                s_OperationAbandoned(counters, operation);
+                if (errorCode != AWS_ERROR_SUCCESS)
+                {
+                    ++counters.failedOperationCount;
+                    return;
+                }
+
+                ++counters.completedOperationCount;
+                if (operation.awaitsAck)
+                {
+                    uint64_t now = 0;
+                    aws_high_res_clock_get_ticks(&now);
+                    uint64_t latencyNs = now - operation.queuedTimestampNs;
+                    counters.totalPublishLatencyNs += latencyNs;
+
+                    size_t bucket = 0;
+                    for (uint64_t latencyUs = latencyNs / 1000; latencyUs > 0; latencyUs >>= 1)
+                    {
+                        ++bucket;
+                    }
+                    if (bucket >= MQTT_PUBLISH_LATENCY_BUCKET_COUNT)
+                    {
+                        bucket = MQTT_PUBLISH_LATENCY_BUCKET_COUNT - 1;
+                    }
+                    ++counters.publishLatencyBuckets[bucket];
+                }
+            }
+
             void MqttConnection::s_onConnectionInterrupted(aws_mqtt_client_connection *, int errorCode, void *userData)
             {
                 auto connWrapper = reinterpret_cast<MqttConnection *>(userData);
+                ++connWrapper->m_counters.interruptionCount;
                 if (connWrapper->OnConnectionInterrupted)
                 {
                     connWrapper->OnConnectionInterrupted(*connWrapper, errorCode);
@@ -33,6 +127,7 @@ namespace Aws
                 void *userData)
             {
                 auto connWrapper = reinterpret_cast<MqttConnection *>(userData);
+                ++connWrapper->m_counters.resumptionCount;
                 if (connWrapper->OnConnectionResumed)
                 {
                     connWrapper->OnConnectionResumed(*connWrapper, returnCode, sessionPresent);
@@ -67,10 +162,31 @@ namespace Aws
                 PubCallbackData() : connection(nullptr), allocator(nullptr) {}
 
                 MqttConnection *connection;
-                OnMessageReceivedHandler onMessageReceived;
+                OnMessageReceivedViewHandler onMessageReceived;
                 Allocator *allocator;
             };
 
+            /* Lets the handlers that take copies of each message share the allocation-free delivery path. */
+            static OnMessageReceivedViewHandler s_ToViewHandler(OnMessageReceivedHandler &&onMessage)
+            {
+                if (!onMessage)
+                {
+                    return nullptr;
+                }
+
+                return [onMessage](
+                           MqttConnection &connection,
+                           StringView topic,
+                           const ByteCursor &payload,
+                           bool dup,
+                           QOS qos,
+                           bool retain) {
+                    String topicStr(topic.data(), topic.size());
+                    ByteBuf payloadBuf = aws_byte_buf_from_array(payload.ptr, payload.len);
+                    onMessage(connection, topicStr, payloadBuf, dup, qos, retain);
+                };
+            }
+
             static void s_cleanUpOnPublishData(void *userData)
             {
                 auto callbackData = reinterpret_cast<PubCallbackData *>(userData);
@@ -90,10 +206,8 @@ namespace Aws
 
                 if (callbackData->onMessageReceived)
                 {
-                    String topicStr(reinterpret_cast<char *>(topic->ptr), topic->len);
-                    ByteBuf payloadBuf = aws_byte_buf_from_array(payload->ptr, payload->len);
                     callbackData->onMessageReceived(
-                        *(callbackData->connection), topicStr, payloadBuf, dup, qos, retain);
+                        *(callbackData->connection), ByteCursorToStringView(*topic), *payload, dup, qos, retain);
                 }
             }
 
@@ -104,6 +218,9 @@ namespace Aws
                 MqttConnection *connection;
                 OnOperationCompleteHandler onOperationComplete;
                 const char *topic;
+                /* keeps the payload of a publish alive until the operation completes */
+                std::shared_ptr<const void> payloadOwner;
+                OperationStatistics statistics;
                 Allocator *allocator;
             };
 
@@ -114,6 +231,13 @@ namespace Aws
                 void *userData)
             {
                 auto callbackData = reinterpret_cast<OpCompleteCallbackData *>(userData);
+                s_OperationCompleted(callbackData->connection->m_counters, callbackData->statistics, errorCode);
+
+                /* only publishes carry a topic */
+                if (callbackData->topic)
+                {
+                    EventTracer::Record(TraceEventType::MqttPublish, TraceEventPhase::End, callbackData, errorCode);
+                }
 
                 if (callbackData->onOperationComplete)
                 {
@@ -129,6 +253,66 @@ namespace Aws
                 Crt::Delete(callbackData, callbackData->allocator);
             }
 
+            struct PublishBatchCallbackData;
+
+            /* the user data of a single message of a PublishBatch() call */
+            struct PublishBatchMessageState
+            {
+                PublishBatchCallbackData *batch;
+                OperationStatistics statistics;
+            };
+
+            /* Callback state shared by every message of a PublishBatch() call. The per-message states and the topic
+             * copies live in the same allocation, right behind it. */
+            struct PublishBatchCallbackData
+            {
+                explicit PublishBatchCallbackData(size_t messageCount)
+                    : connection(nullptr), allocator(nullptr), count(messageCount), pending(0)
+                {
+                }
+
+                MqttConnection *connection;
+                OnOperationCompleteHandler onOperationComplete;
+                Allocator *allocator;
+                size_t count;
+                std::atomic<size_t> pending;
+
+                PublishBatchMessageState *GetMessageStates() noexcept
+                {
+                    return reinterpret_cast<PublishBatchMessageState *>(this + 1);
+                }
+                char *GetTopicStorage() noexcept { return reinterpret_cast<char *>(GetMessageStates() + count); }
+            };
+
+            static void s_ReleaseBatchCallbackData(PublishBatchCallbackData *callbackData, size_t count) noexcept
+            {
+                if (callbackData->pending.fetch_sub(count) == count)
+                {
+                    Allocator *allocator = callbackData->allocator;
+                    callbackData->~PublishBatchCallbackData();
+                    aws_mem_release(allocator, callbackData);
+                }
+            }
+
+            void MqttConnection::s_onBatchOpComplete(
+                aws_mqtt_client_connection *,
+                uint16_t packetId,
+                int errorCode,
+                void *userData)
+            {
+                auto messageState = reinterpret_cast<PublishBatchMessageState *>(userData);
+                auto callbackData = messageState->batch;
+                s_OperationCompleted(callbackData->connection->m_counters, messageState->statistics, errorCode);
+                EventTracer::Record(TraceEventType::MqttPublish, TraceEventPhase::End, messageState, errorCode);
+
+                if (callbackData->onOperationComplete)
+                {
+                    callbackData->onOperationComplete(*callbackData->connection, packetId, errorCode);
+                }
+
+                s_ReleaseBatchCallbackData(callbackData, 1);
+            }
+
             struct SubAckCallbackData
             {
                 SubAckCallbackData() : connection(nullptr), topic(nullptr), allocator(nullptr) {}
@@ -136,6 +320,7 @@ namespace Aws
                 MqttConnection *connection;
                 OnSubAckHandler onSubAck;
                 const char *topic;
+                OperationStatistics statistics;
                 Allocator *allocator;
             };
 
@@ -148,6 +333,7 @@ namespace Aws
                 void *userData)
             {
                 auto callbackData = reinterpret_cast<SubAckCallbackData *>(userData);
+                s_OperationCompleted(callbackData->connection->m_counters, callbackData->statistics, errorCode);
 
                 if (callbackData->onSubAck)
                 {
@@ -170,7 +356,9 @@ namespace Aws
 
                 MqttConnection *connection;
                 OnMultiSubAckHandler onSubAck;
+                OnMultiSubAckGrantsHandler onSubAckGrants;
                 const char *topic;
+                OperationStatistics statistics;
                 Allocator *allocator;
             };
 
@@ -182,12 +370,15 @@ namespace Aws
                 void *userData)
             {
                 auto callbackData = reinterpret_cast<MultiSubAckCallbackData *>(userData);
+                s_OperationCompleted(callbackData->connection->m_counters, callbackData->statistics, errorCode);
 
-                if (callbackData->onSubAck)
+                if (callbackData->onSubAck || callbackData->onSubAckGrants)
                 {
                     size_t length = aws_array_list_length(topicSubacks);
                     Vector<String> topics;
+                    Vector<QOS> grantedQos;
                     topics.reserve(length);
+                    grantedQos.reserve(length);
                     QOS qos = AWS_MQTT_QOS_AT_MOST_ONCE;
                     for (size_t i = 0; i < length; ++i)
                     {
@@ -195,10 +386,19 @@ namespace Aws
                         aws_array_list_get_at(topicSubacks, &subscription, i);
                         topics.push_back(
                             String(reinterpret_cast<char *>(subscription->topic.ptr), subscription->topic.len));
+                        grantedQos.push_back(subscription->qos);
                         qos = subscription->qos;
                     }
 
-                    callbackData->onSubAck(*callbackData->connection, packetId, topics, qos, errorCode);
+                    if (callbackData->onSubAck)
+                    {
+                        callbackData->onSubAck(*callbackData->connection, packetId, topics, qos, errorCode);
+                    }
+                    if (callbackData->onSubAckGrants)
+                    {
+                        callbackData->onSubAckGrants(
+                            *callbackData->connection, packetId, topics, grantedQos, errorCode);
+                    }
                 }
 
                 if (callbackData->topic)
@@ -302,6 +502,25 @@ namespace Aws
 
             int MqttConnection::LastError() const noexcept { return aws_last_error(); }
 
+            MqttConnectionStatistics MqttConnection::GetOperationStatistics() const noexcept
+            {
+                MqttConnectionStatistics statistics;
+                statistics.IncompleteOperationCount = m_counters.incompleteOperationCount;
+                statistics.IncompleteOperationBytes = m_counters.incompleteOperationBytes;
+                statistics.UnackedPublishCount = m_counters.unackedPublishCount;
+                statistics.CompletedOperationCount = m_counters.completedOperationCount;
+                statistics.FailedOperationCount = m_counters.failedOperationCount;
+                statistics.InterruptionCount = m_counters.interruptionCount;
+                statistics.ResumptionCount = m_counters.resumptionCount;
+                for (size_t i = 0; i < MQTT_PUBLISH_LATENCY_BUCKET_COUNT; ++i)
+                {
+                    statistics.PublishLatencyBuckets[i] = m_counters.publishLatencyBuckets[i];
+                }
+                statistics.TotalPublishLatencyNs = m_counters.totalPublishLatencyNs;
+
+                return statistics;
+            }
+
             bool MqttConnection::SetWill(const char *topic, QOS qos, bool retain, const ByteBuf &payload) noexcept
             {
                 ByteBuf topicBuf = aws_byte_buf_from_c_str(topic);
@@ -426,6 +645,16 @@ namespace Aws
             }
 
             bool MqttConnection::SetOnMessageHandler(OnMessageReceivedHandler &&onMessage) noexcept
+            {
+                return SetOnMessageHandler(s_ToViewHandler(std::move(onMessage)));
+            }
+
+            bool MqttConnection::SetOnMessageHandler(std::nullptr_t) noexcept
+            {
+                return SetOnMessageHandler(OnMessageReceivedViewHandler());
+            }
+
+            bool MqttConnection::SetOnMessageHandler(OnMessageReceivedViewHandler &&onMessage) noexcept
             {
                 auto pubCallbackData = Aws::Crt::New<PubCallbackData>(m_owningClient->allocator);
 
@@ -470,6 +699,24 @@ namespace Aws
                 QOS qos,
                 OnMessageReceivedHandler &&onMessage,
                 OnSubAckHandler &&onSubAck) noexcept
+            {
+                return Subscribe(topicFilter, qos, s_ToViewHandler(std::move(onMessage)), std::move(onSubAck));
+            }
+
+            uint16_t MqttConnection::Subscribe(
+                const char *topicFilter,
+                QOS qos,
+                std::nullptr_t,
+                OnSubAckHandler &&onSubAck) noexcept
+            {
+                return Subscribe(topicFilter, qos, OnMessageReceivedViewHandler(), std::move(onSubAck));
+            }
+
+            uint16_t MqttConnection::Subscribe(
+                const char *topicFilter,
+                QOS qos,
+                OnMessageReceivedViewHandler &&onMessage,
+                OnSubAckHandler &&onSubAck) noexcept
             {
                 auto pubCallbackData = Crt::New<PubCallbackData>(m_owningClient->allocator);
 
@@ -498,6 +745,7 @@ namespace Aws
 
                 ByteBuf topicFilterBuf = aws_byte_buf_from_c_str(topicFilter);
                 ByteCursor topicFilterCur = aws_byte_cursor_from_buf(&topicFilterBuf);
+                s_OperationQueued(m_counters, subAckCallbackData->statistics, topicFilterCur.len, false);
 
                 uint16_t packetId = aws_mqtt_client_connection_subscribe(
                     m_underlyingConnection,
@@ -511,6 +759,7 @@ namespace Aws
 
                 if (!packetId)
                 {
+                    s_OperationAbandoned(m_counters, subAckCallbackData->statistics);
                     Crt::Delete(pubCallbackData, pubCallbackData->allocator);
                     Crt::Delete(subAckCallbackData, subAckCallbackData->allocator);
                 }
@@ -542,6 +791,30 @@ namespace Aws
                 const Vector<std::pair<const char *, OnMessageReceivedHandler>> &topicFilters,
                 QOS qos,
                 OnMultiSubAckHandler &&onSubAck) noexcept
+            {
+                Vector<std::pair<const char *, OnMessageReceivedViewHandler>> newTopicFilters;
+                newTopicFilters.reserve(topicFilters.size());
+                for (const auto &pair : topicFilters)
+                {
+                    OnMessageReceivedHandler handler = pair.second;
+                    newTopicFilters.emplace_back(pair.first, s_ToViewHandler(std::move(handler)));
+                }
+                return Subscribe(newTopicFilters, qos, std::move(onSubAck));
+            }
+
+            uint16_t MqttConnection::Subscribe(
+                const Vector<std::pair<const char *, OnMessageReceivedViewHandler>> &topicFilters,
+                QOS qos,
+                OnMultiSubAckHandler &&onSubAck) noexcept
+            {
+                return SubscribeMultiple(topicFilters, qos, std::move(onSubAck), OnMultiSubAckGrantsHandler());
+            }
+
+            uint16_t MqttConnection::SubscribeMultiple(
+                const Vector<std::pair<const char *, OnMessageReceivedViewHandler>> &topicFilters,
+                QOS qos,
+                OnMultiSubAckHandler &&onSubAck,
+                OnMultiSubAckGrantsHandler &&onSubAckGrants) noexcept
             {
                 uint16_t packetId = 0;
                 auto subAckCallbackData = Crt::New<MultiSubAckCallbackData>(m_owningClient->allocator);
@@ -551,16 +824,15 @@ namespace Aws
                     return 0;
                 }
 
-                aws_array_list multiPub;
-                AWS_ZERO_STRUCT(multiPub);
+                /* the client copies the subscriptions out, so they can live on the stack for the common case */
+                SmallVector<aws_mqtt_topic_subscription, 8> subscriptions(m_owningClient->allocator);
+                subscriptions.reserve(topicFilters.size());
 
-                if (aws_array_list_init_dynamic(
-                        &multiPub, m_owningClient->allocator, topicFilters.size(), sizeof(aws_mqtt_topic_subscription)))
-                {
-                    Crt::Delete(subAckCallbackData, m_owningClient->allocator);
-                    return 0;
-                }
+                aws_array_list multiPub;
+                aws_array_list_init_static(
+                    &multiPub, subscriptions.data(), subscriptions.capacity(), sizeof(aws_mqtt_topic_subscription));
 
+                size_t topicFiltersLen = 0;
                 for (auto &topicFilter : topicFilters)
                 {
                     auto pubCallbackData = Crt::New<PubCallbackData>(m_owningClient->allocator);
@@ -583,6 +855,7 @@ namespace Aws
                     subscription.on_publish_ud = pubCallbackData;
                     subscription.qos = qos;
                     subscription.topic = topicFilterCur;
+                    topicFiltersLen += topicFilterCur.len;
 
                     aws_array_list_push_back(&multiPub, reinterpret_cast<const void *>(&subscription));
                 }
@@ -590,11 +863,17 @@ namespace Aws
                 subAckCallbackData->connection = this;
                 subAckCallbackData->allocator = m_owningClient->allocator;
                 subAckCallbackData->onSubAck = std::move(onSubAck);
+                subAckCallbackData->onSubAckGrants = std::move(onSubAckGrants);
                 subAckCallbackData->topic = nullptr;
                 subAckCallbackData->allocator = m_owningClient->allocator;
 
+                s_OperationQueued(m_counters, subAckCallbackData->statistics, topicFiltersLen, false);
                 packetId = aws_mqtt_client_connection_subscribe_multiple(
                     m_underlyingConnection, &multiPub, s_onMultiSubAck, subAckCallbackData);
+                if (!packetId)
+                {
+                    s_OperationAbandoned(m_counters, subAckCallbackData->statistics);
+                }
 
             clean_up:
                 if (!packetId)
@@ -634,11 +913,13 @@ namespace Aws
                 ByteBuf topicFilterBuf = aws_byte_buf_from_c_str(topicFilter);
                 ByteCursor topicFilterCur = aws_byte_cursor_from_buf(&topicFilterBuf);
 
+                s_OperationQueued(m_counters, opCompleteCallbackData->statistics, topicFilterCur.len, false);
                 uint16_t packetId = aws_mqtt_client_connection_unsubscribe(
                     m_underlyingConnection, &topicFilterCur, s_onOpComplete, opCompleteCallbackData);
 
                 if (!packetId)
                 {
+                    s_OperationAbandoned(m_counters, opCompleteCallbackData->statistics);
                     Crt::Delete(opCompleteCallbackData, m_owningClient->allocator);
                 }
 
@@ -652,7 +933,18 @@ namespace Aws
                 const ByteBuf &payload,
                 OnOperationCompleteHandler &&onOpComplete) noexcept
             {
+                return Publish(
+                    topic, qos, retain, nullptr, aws_byte_cursor_from_buf(&payload), std::move(onOpComplete));
+            }
 
+            uint16_t MqttConnection::Publish(
+                const char *topic,
+                QOS qos,
+                bool retain,
+                std::shared_ptr<const void> payloadOwner,
+                const ByteCursor &payload,
+                OnOperationCompleteHandler &&onOpComplete) noexcept
+            {
                 auto opCompleteCallbackData = Crt::New<OpCompleteCallbackData>(m_owningClient->allocator);
                 if (!opCompleteCallbackData)
                 {
@@ -666,6 +958,7 @@ namespace Aws
                 if (!topicCpy)
                 {
                     Crt::Delete(opCompleteCallbackData, m_owningClient->allocator);
+                    return 0;
                 }
 
                 memcpy(topicCpy, topic, topicLen);
@@ -674,9 +967,21 @@ namespace Aws
                 opCompleteCallbackData->allocator = m_owningClient->allocator;
                 opCompleteCallbackData->onOperationComplete = std::move(onOpComplete);
                 opCompleteCallbackData->topic = topicCpy;
+                opCompleteCallbackData->payloadOwner = std::move(payloadOwner);
                 ByteCursor topicCur = aws_byte_cursor_from_array(topicCpy, topicLen - 1);
 
-                ByteCursor payloadCur = aws_byte_cursor_from_buf(&payload);
+                ByteCursor payloadCur = payload;
+                s_OperationQueued(
+                    m_counters,
+                    opCompleteCallbackData->statistics,
+                    topicCur.len + payloadCur.len,
+                    qos != AWS_MQTT_QOS_AT_MOST_ONCE);
+
+                EventTracer::Record(
+                    TraceEventType::MqttPublish,
+                    TraceEventPhase::Begin,
+                    opCompleteCallbackData,
+                    static_cast<int64_t>(payloadCur.len));
                 uint16_t packetId = aws_mqtt_client_connection_publish(
                     m_underlyingConnection,
                     &topicCur,
@@ -688,6 +993,9 @@ namespace Aws
 
                 if (!packetId)
                 {
+                    EventTracer::Record(
+                        TraceEventType::MqttPublish, TraceEventPhase::End, opCompleteCallbackData, aws_last_error());
+                    s_OperationAbandoned(m_counters, opCompleteCallbackData->statistics);
                     aws_mem_release(m_owningClient->allocator, reinterpret_cast<void *>(topicCpy));
                     Crt::Delete(opCompleteCallbackData, m_owningClient->allocator);
                 }
@@ -695,9 +1003,105 @@ namespace Aws
                 return packetId;
             }
 
-            MqttClient::MqttClient(Io::ClientBootstrap &bootstrap, Allocator *allocator) noexcept
-                : m_client(aws_mqtt_client_new(allocator, bootstrap.GetUnderlyingHandle()))
+            size_t MqttConnection::PublishBatch(
+                const PublishBatchMessage *messages,
+                size_t count,
+                OnOperationCompleteHandler &&onOpComplete,
+                uint16_t *outPacketIds) noexcept
+            {
+                if (outPacketIds)
+                {
+                    memset(outPacketIds, 0, count * sizeof(uint16_t));
+                }
+
+                if (count == 0)
+                {
+                    return 0;
+                }
+
+                size_t topicsLen = 0;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    topicsLen += messages[i].topic.len;
+                }
+
+                void *storage = aws_mem_acquire(
+                    m_owningClient->allocator,
+                    sizeof(PublishBatchCallbackData) + count * sizeof(PublishBatchMessageState) + topicsLen);
+                if (!storage)
+                {
+                    return 0;
+                }
+
+                auto callbackData = new (storage) PublishBatchCallbackData(count);
+                callbackData->connection = this;
+                callbackData->allocator = m_owningClient->allocator;
+                callbackData->onOperationComplete = std::move(onOpComplete);
+
+                /* one extra reference keeps the state alive should the first messages complete before the loop is
+                 * done with it */
+                callbackData->pending = count + 1;
+
+                char *topicStorage = callbackData->GetTopicStorage();
+                size_t queued = 0;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const PublishBatchMessage &message = messages[i];
+                    if (message.topic.len > 0)
+                    {
+                        memcpy(topicStorage, message.topic.ptr, message.topic.len);
+                    }
+
+                    ByteCursor topicCur = aws_byte_cursor_from_array(topicStorage, message.topic.len);
+                    topicStorage += message.topic.len;
+
+                    PublishBatchMessageState *messageState = new (callbackData->GetMessageStates() + i)
+                        PublishBatchMessageState{callbackData, OperationStatistics()};
+                    s_OperationQueued(
+                        m_counters,
+                        messageState->statistics,
+                        message.topic.len + message.payload.len,
+                        message.qos != AWS_MQTT_QOS_AT_MOST_ONCE);
+
+                    EventTracer::Record(
+                        TraceEventType::MqttPublish,
+                        TraceEventPhase::Begin,
+                        messageState,
+                        static_cast<int64_t>(message.payload.len));
+                    uint16_t packetId = aws_mqtt_client_connection_publish(
+                        m_underlyingConnection,
+                        &topicCur,
+                        message.qos,
+                        message.retain,
+                        &message.payload,
+                        s_onBatchOpComplete,
+                        messageState);
+
+                    if (outPacketIds)
+                    {
+                        outPacketIds[i] = packetId;
+                    }
+
+                    if (packetId)
+                    {
+                        ++queued;
+                    }
+                    else
+                    {
+                        EventTracer::Record(
+                            TraceEventType::MqttPublish, TraceEventPhase::End, messageState, aws_last_error());
+                        s_OperationAbandoned(m_counters, messageState->statistics);
+                    }
+                }
+
+                s_ReleaseBatchCallbackData(callbackData, count - queued + 1);
+                return queued;
+            }
+
+            MqttClient::MqttClient(Io::ClientBootstrap &bootstrap, Allocator *allocator) noexcept : m_client(nullptr)
             {
+                ApiHandle::InitializeSubsystem(ApiSubsystem::Mqtt);
+                m_client = aws_mqtt_client_new(allocator, bootstrap.GetUnderlyingHandle());
             }
 
             MqttClient::~MqttClient()
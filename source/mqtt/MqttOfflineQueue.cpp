@@ -0,0 +1,508 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/mqtt/MqttOfflineQueue.h>
+
+#include <aws/crt/io/Stream.h>
+
+#include <aws/common/file.h>
+
+#include <cstring>
+#include <string>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Mqtt
+        {
+            struct OfflinePublish
+            {
+                OfflinePublish(const char *topicName, size_t topicLength, Allocator *allocator)
+                    : topic(topicName, topicLength, StlAllocator<char>(allocator)), qos(AWS_MQTT_QOS_AT_MOST_ONCE),
+                      retain(false), replaceable(false)
+                {
+                    AWS_ZERO_STRUCT(payload);
+                }
+
+                StringView GetTopic() const noexcept { return StringView(topic.data(), topic.size()); }
+                size_t GetSize() const noexcept { return topic.size() + payload.len; }
+
+                String topic;
+                QOS qos;
+                bool retain;
+                /* set if the message sits in MqttOfflineQueue::m_latestByTopic */
+                bool replaceable;
+                std::shared_ptr<const void> payloadOwner;
+                ByteCursor payload;
+            };
+
+            /* a spilled message is its topic length, payload length, qos and retain flag, then the topic and the
+             * payload themselves */
+            static const size_t s_SpillRecordHeaderSize = 10;
+
+            size_t OfflineTopicHash::operator()(const StringView &topic) const noexcept
+            {
+                uint64_t hash = 14695981039346656037ULL;
+                for (char c : topic)
+                {
+                    hash ^= static_cast<uint8_t>(c);
+                    hash *= 1099511628211ULL;
+                }
+                return static_cast<size_t>(hash);
+            }
+
+            std::shared_ptr<MqttOfflineQueue> MqttOfflineQueue::NewOfflineQueue(
+                const std::shared_ptr<MqttConnection> &connection,
+                const MqttOfflineQueueOptions &options,
+                Allocator *allocator) noexcept
+            {
+                if (!connection || !*connection)
+                {
+                    aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                    return nullptr;
+                }
+
+                auto *toSeat = static_cast<MqttOfflineQueue *>(aws_mem_acquire(allocator, sizeof(MqttOfflineQueue)));
+                if (!toSeat)
+                {
+                    return nullptr;
+                }
+
+                toSeat = new (toSeat) MqttOfflineQueue(connection, options, allocator);
+                std::shared_ptr<MqttOfflineQueue> queue(
+                    toSeat, [allocator](MqttOfflineQueue *queue) { Crt::Delete(queue, allocator); });
+                queue->InstallConnectionHandlers();
+
+                return queue;
+            }
+
+            MqttOfflineQueue::MqttOfflineQueue(
+                const std::shared_ptr<MqttConnection> &connection,
+                const MqttOfflineQueueOptions &options,
+                Allocator *allocator) noexcept
+                : m_allocator(allocator), m_connection(connection), m_options(options),
+                  m_queue(StlAllocator<std::shared_ptr<OfflinePublish>>(allocator)),
+                  m_latestByTopic(
+                      0,
+                      OfflineTopicHash(),
+                      std::equal_to<StringView>(),
+                      StlAllocator<LatestByTopic::value_type>(allocator)),
+                  m_online(false), m_spillFile(nullptr), m_spillFilePath(StlAllocator<char>(allocator)),
+                  m_spillGeneration(0)
+            {
+            }
+
+            MqttOfflineQueue::~MqttOfflineQueue()
+            {
+                if (m_spillFile)
+                {
+                    fclose(m_spillFile);
+                    remove(m_spillFilePath.c_str());
+                }
+            }
+
+            void MqttOfflineQueue::InstallConnectionHandlers() noexcept
+            {
+                std::weak_ptr<MqttOfflineQueue> weakSelf = shared_from_this();
+
+                OnConnectionCompletedHandler onCompleted = std::move(m_connection->OnConnectionCompleted);
+                m_connection->OnConnectionCompleted =
+                    [weakSelf, onCompleted](
+                        MqttConnection &connection, int errorCode, ReturnCode returnCode, bool sessionPresent) {
+                        if (auto self = weakSelf.lock())
+                        {
+                            self->SetOnline(errorCode == AWS_ERROR_SUCCESS && returnCode == AWS_MQTT_CONNECT_ACCEPTED);
+                        }
+                        if (onCompleted)
+                        {
+                            onCompleted(connection, errorCode, returnCode, sessionPresent);
+                        }
+                    };
+
+                OnConnectionInterruptedHandler onInterrupted = std::move(m_connection->OnConnectionInterrupted);
+                m_connection->OnConnectionInterrupted = [weakSelf, onInterrupted](
+                                                            MqttConnection &connection, int errorCode) {
+                    if (auto self = weakSelf.lock())
+                    {
+                        self->SetOnline(false);
+                    }
+                    if (onInterrupted)
+                    {
+                        onInterrupted(connection, errorCode);
+                    }
+                };
+
+                OnConnectionResumedHandler onResumed = std::move(m_connection->OnConnectionResumed);
+                m_connection->OnConnectionResumed =
+                    [weakSelf, onResumed](MqttConnection &connection, ReturnCode returnCode, bool sessionPresent) {
+                        if (auto self = weakSelf.lock())
+                        {
+                            self->SetOnline(returnCode == AWS_MQTT_CONNECT_ACCEPTED);
+                        }
+                        if (onResumed)
+                        {
+                            onResumed(connection, returnCode, sessionPresent);
+                        }
+                    };
+
+                OnDisconnectHandler onDisconnect = std::move(m_connection->OnDisconnect);
+                m_connection->OnDisconnect = [weakSelf, onDisconnect](MqttConnection &connection) {
+                    if (auto self = weakSelf.lock())
+                    {
+                        self->SetOnline(false);
+                    }
+                    if (onDisconnect)
+                    {
+                        onDisconnect(connection);
+                    }
+                };
+            }
+
+            bool MqttOfflineQueue::Publish(const char *topic, QOS qos, bool retain, const ByteCursor &payload) noexcept
+            {
+                auto payloadCopy = MakeShared<Vector<uint8_t>>(
+                    m_allocator, payload.ptr, payload.ptr + payload.len, StlAllocator<uint8_t>(m_allocator));
+                if (!payloadCopy)
+                {
+                    return false;
+                }
+
+                ByteCursor payloadCur = aws_byte_cursor_from_array(payloadCopy->data(), payloadCopy->size());
+                return Publish(topic, qos, retain, std::move(payloadCopy), payloadCur);
+            }
+
+            bool MqttOfflineQueue::Publish(
+                const char *topic,
+                QOS qos,
+                bool retain,
+                std::shared_ptr<const void> payloadOwner,
+                const ByteCursor &payload) noexcept
+            {
+                if (topic == nullptr)
+                {
+                    aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                    return false;
+                }
+
+                auto message = MakeShared<OfflinePublish>(m_allocator, topic, strlen(topic), m_allocator);
+                if (!message)
+                {
+                    return false;
+                }
+
+                message->qos = qos;
+                message->retain = retain;
+                message->payloadOwner = std::move(payloadOwner);
+                message->payload = payload;
+
+                DroppedPublishes dropped{StlAllocator<std::shared_ptr<OfflinePublish>>(m_allocator)};
+                bool accepted = false;
+                {
+                    std::lock_guard<std::mutex> lock(m_lock);
+                    accepted = m_online ? PublishNow(message) : Enqueue(message, dropped);
+                }
+
+                CompleteDropped(dropped);
+                return accepted;
+            }
+
+            bool MqttOfflineQueue::PublishNow(const std::shared_ptr<OfflinePublish> &message) noexcept
+            {
+                std::weak_ptr<MqttOfflineQueue> weakSelf = shared_from_this();
+
+                /* the completion holds on to the message, and with it to the payload */
+                uint16_t packetId = m_connection->Publish(
+                    message->topic.c_str(),
+                    message->qos,
+                    message->retain,
+                    nullptr,
+                    message->payload,
+                    [weakSelf, message](MqttConnection &connection, uint16_t, int errorCode) {
+                        auto self = weakSelf.lock();
+                        if (self && self->OnPublishComplete)
+                        {
+                            self->OnPublishComplete(connection, message->GetTopic(), errorCode);
+                        }
+                    });
+
+                return packetId != 0;
+            }
+
+            bool MqttOfflineQueue::Enqueue(
+                const std::shared_ptr<OfflinePublish> &message,
+                DroppedPublishes &dropped) noexcept
+            {
+                StringView topic = message->GetTopic();
+                OfflineTopicPolicy policy =
+                    m_options.TopicPolicy ? m_options.TopicPolicy(topic) : OfflineTopicPolicy::Queue;
+                if (policy == OfflineTopicPolicy::Drop)
+                {
+                    ++m_metrics.Dropped;
+                    aws_raise_error(AWS_ERROR_MQTT_NOT_CONNECTED);
+                    return false;
+                }
+
+                size_t size = message->GetSize();
+                bool dropOldest = m_options.OverflowPolicy == OfflineQueueOverflowPolicy::DropOldest;
+
+                if (policy == OfflineTopicPolicy::Replace)
+                {
+                    auto latest = m_latestByTopic.find(topic);
+                    if (latest != m_latestByTopic.end())
+                    {
+                        std::shared_ptr<OfflinePublish> &slot = *latest->second;
+                        size_t queuedBytes = m_metrics.QueuedBytes - slot->GetSize() + size;
+                        if (queuedBytes <= m_options.MaxQueuedBytes || dropOldest)
+                        {
+                            /* the map is keyed by a view of the replaced message's topic, so it is keyed anew */
+                            QueuedPublishes::iterator position = latest->second;
+                            m_latestByTopic.erase(latest);
+
+                            dropped.push_back(slot);
+                            ++m_metrics.Replaced;
+                            m_metrics.QueuedBytes = queuedBytes;
+                            message->replaceable = true;
+                            slot = message;
+                            m_latestByTopic.emplace(message->GetTopic(), position);
+
+                            while (m_metrics.QueuedBytes > m_options.MaxQueuedBytes)
+                            {
+                                Evict(dropped);
+                            }
+                            return true;
+                        }
+                    }
+                }
+
+                /* once messages are in the spill file, memory only holds older ones */
+                bool fitsInMemory = !m_spillFile && m_metrics.QueuedBytes + size <= m_options.MaxQueuedBytes;
+                if (!fitsInMemory)
+                {
+                    if (!m_options.SpillFilePath.empty() && Spill(*message))
+                    {
+                        return true;
+                    }
+
+                    if (!dropOldest || m_spillFile || size > m_options.MaxQueuedBytes)
+                    {
+                        ++m_metrics.Dropped;
+                        aws_raise_error(AWS_ERROR_MQTT_NOT_CONNECTED);
+                        return false;
+                    }
+
+                    while (m_metrics.QueuedBytes + size > m_options.MaxQueuedBytes)
+                    {
+                        Evict(dropped);
+                    }
+                }
+
+                m_queue.push_back(message);
+                m_metrics.QueuedBytes += size;
+                ++m_metrics.QueuedMessages;
+
+                if (policy == OfflineTopicPolicy::Replace)
+                {
+                    message->replaceable = true;
+                    m_latestByTopic[topic] = std::prev(m_queue.end());
+                }
+
+                return true;
+            }
+
+            void MqttOfflineQueue::Evict(DroppedPublishes &dropped) noexcept
+            {
+                std::shared_ptr<OfflinePublish> oldest = m_queue.front();
+                if (oldest->replaceable)
+                {
+                    m_latestByTopic.erase(oldest->GetTopic());
+                }
+
+                m_queue.pop_front();
+                m_metrics.QueuedBytes -= oldest->GetSize();
+                --m_metrics.QueuedMessages;
+                ++m_metrics.Dropped;
+                dropped.push_back(std::move(oldest));
+            }
+
+            bool MqttOfflineQueue::Spill(const OfflinePublish &message) noexcept
+            {
+                size_t recordSize = s_SpillRecordHeaderSize + message.GetSize();
+                if (message.topic.size() > UINT32_MAX || message.payload.len > UINT32_MAX ||
+                    m_metrics.SpilledBytes + recordSize > m_options.MaxSpillBytes)
+                {
+                    return false;
+                }
+
+                if (!m_spillFile)
+                {
+                    m_spillFilePath = m_options.SpillFilePath;
+                    m_spillFilePath += '.';
+                    m_spillFilePath += std::to_string(m_spillGeneration).c_str();
+
+                    m_spillFile = aws_fopen(m_spillFilePath.c_str(), "wb");
+                    if (!m_spillFile)
+                    {
+                        return false;
+                    }
+                }
+
+                uint8_t header[s_SpillRecordHeaderSize];
+                ByteBuf headerBuf = aws_byte_buf_from_empty_array(header, sizeof(header));
+                aws_byte_buf_write_be32(&headerBuf, static_cast<uint32_t>(message.topic.size()));
+                aws_byte_buf_write_be32(&headerBuf, static_cast<uint32_t>(message.payload.len));
+                aws_byte_buf_write_u8(&headerBuf, static_cast<uint8_t>(message.qos));
+                aws_byte_buf_write_u8(&headerBuf, message.retain ? 1 : 0);
+
+                bool written = fwrite(header, 1, sizeof(header), m_spillFile) == sizeof(header) &&
+                               fwrite(message.topic.data(), 1, message.topic.size(), m_spillFile) ==
+                                   message.topic.size() &&
+                               fwrite(message.payload.ptr, 1, message.payload.len, m_spillFile) == message.payload.len;
+                if (!written)
+                {
+                    /* a torn record is overwritten by the next one, and never read past SpilledBytes anyway */
+                    fseek(m_spillFile, static_cast<long>(m_metrics.SpilledBytes), SEEK_SET);
+                    return false;
+                }
+
+                m_metrics.SpilledBytes += recordSize;
+                ++m_metrics.SpilledMessages;
+                return true;
+            }
+
+            void MqttOfflineQueue::DrainSpillFile(DroppedPublishes &failed) noexcept
+            {
+                if (!m_spillFile)
+                {
+                    return;
+                }
+
+                fclose(m_spillFile);
+                m_spillFile = nullptr;
+                ++m_spillGeneration;
+
+                size_t spilledBytes = m_metrics.SpilledBytes;
+                size_t spilledMessages = m_metrics.SpilledMessages;
+                m_metrics.SpilledBytes = 0;
+                m_metrics.SpilledMessages = 0;
+
+                /* the messages are published straight from the mapping, which is unmapped and the file removed
+                 * once the last of them completes */
+                Allocator *allocator = m_allocator;
+                String path = m_spillFilePath;
+                auto stream = Crt::New<Io::MmapFileInputStream>(allocator, path.c_str(), allocator);
+                if (!stream)
+                {
+                    remove(path.c_str());
+                    m_metrics.Dropped += spilledMessages;
+                    return;
+                }
+
+                std::shared_ptr<Io::MmapFileInputStream> mapping(stream, [allocator, path](Io::MmapFileInputStream *s) {
+                    Crt::Delete(s, allocator);
+                    remove(path.c_str());
+                });
+                if (!mapping->IsValid())
+                {
+                    m_metrics.Dropped += spilledMessages;
+                    return;
+                }
+
+                ByteCursor contents = mapping->GetContents();
+                contents.len = contents.len < spilledBytes ? contents.len : spilledBytes;
+                while (contents.len >= s_SpillRecordHeaderSize)
+                {
+                    uint32_t topicLength = 0;
+                    uint32_t payloadLength = 0;
+                    uint8_t qos = 0;
+                    uint8_t retain = 0;
+                    aws_byte_cursor_read_be32(&contents, &topicLength);
+                    aws_byte_cursor_read_be32(&contents, &payloadLength);
+                    aws_byte_cursor_read_u8(&contents, &qos);
+                    aws_byte_cursor_read_u8(&contents, &retain);
+                    if (contents.len < static_cast<size_t>(topicLength) + payloadLength)
+                    {
+                        break;
+                    }
+
+                    ByteCursor topic = aws_byte_cursor_advance(&contents, topicLength);
+                    auto message = MakeShared<OfflinePublish>(
+                        m_allocator, reinterpret_cast<const char *>(topic.ptr), topic.len, m_allocator);
+                    if (!message)
+                    {
+                        ++m_metrics.Dropped;
+                        aws_byte_cursor_advance(&contents, payloadLength);
+                        continue;
+                    }
+
+                    message->qos = static_cast<QOS>(qos);
+                    message->retain = retain != 0;
+                    message->payloadOwner = mapping;
+                    message->payload = aws_byte_cursor_advance(&contents, payloadLength);
+                    if (!PublishNow(message))
+                    {
+                        failed.push_back(std::move(message));
+                    }
+                }
+            }
+
+            void MqttOfflineQueue::SetOnline(bool online) noexcept
+            {
+                DroppedPublishes failed{StlAllocator<std::shared_ptr<OfflinePublish>>(m_allocator)};
+                {
+                    std::lock_guard<std::mutex> lock(m_lock);
+                    bool wasOnline = m_online;
+                    m_online = online;
+                    if (!online || wasOnline)
+                    {
+                        return;
+                    }
+
+                    /* the queue is drained before anything published from now on, so the order holds */
+                    m_latestByTopic.clear();
+                    while (!m_queue.empty())
+                    {
+                        std::shared_ptr<OfflinePublish> message = std::move(m_queue.front());
+                        m_queue.pop_front();
+                        if (!PublishNow(message))
+                        {
+                            failed.push_back(std::move(message));
+                        }
+                    }
+                    m_metrics.QueuedBytes = 0;
+                    m_metrics.QueuedMessages = 0;
+
+                    DrainSpillFile(failed);
+                }
+
+                CompleteDropped(failed);
+            }
+
+            void MqttOfflineQueue::CompleteDropped(const DroppedPublishes &dropped) noexcept
+            {
+                if (!OnPublishComplete)
+                {
+                    return;
+                }
+
+                for (const auto &message : dropped)
+                {
+                    OnPublishComplete(*m_connection, message->GetTopic(), AWS_ERROR_MQTT_NOT_CONNECTED);
+                }
+            }
+
+            bool MqttOfflineQueue::IsOnline() const noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                return m_online;
+            }
+
+            MqttOfflineQueueMetrics MqttOfflineQueue::GetMetrics() const noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                return m_metrics;
+            }
+        } // namespace Mqtt
+    }     // namespace Crt
+} // namespace Aws
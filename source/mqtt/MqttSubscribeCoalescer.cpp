@@ -0,0 +1,385 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/mqtt/MqttSubscribeCoalescer.h>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Mqtt
+        {
+            struct CoalescedSubscribe
+            {
+                CoalescedSubscribe(const char *topicFilter, QOS subscribeQos, Allocator *allocator)
+                    : topic(topicFilter, StlAllocator<char>(allocator)), qos(subscribeQos)
+                {
+                }
+
+                String topic;
+                QOS qos;
+                OnMessageReceivedViewHandler onMessage;
+                OnSubAckHandler onSubAck;
+            };
+
+            struct CoalescerFlushTask
+            {
+                aws_task task{};
+                std::weak_ptr<MqttSubscribeCoalescer> coalescer;
+                Allocator *allocator{};
+            };
+
+            std::shared_ptr<MqttSubscribeCoalescer> MqttSubscribeCoalescer::NewSubscribeCoalescer(
+                const std::shared_ptr<MqttConnection> &connection,
+                const MqttSubscribeCoalescerOptions &options,
+                Allocator *allocator) noexcept
+            {
+                if (!connection || !*connection || options.MaxTopicsPerSubscribe == 0)
+                {
+                    aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                    return nullptr;
+                }
+
+                auto *toSeat =
+                    static_cast<MqttSubscribeCoalescer *>(aws_mem_acquire(allocator, sizeof(MqttSubscribeCoalescer)));
+                if (!toSeat)
+                {
+                    return nullptr;
+                }
+
+                toSeat = new (toSeat) MqttSubscribeCoalescer(connection, options, allocator);
+                std::shared_ptr<MqttSubscribeCoalescer> coalescer(
+                    toSeat, [allocator](MqttSubscribeCoalescer *coalescer) { Crt::Delete(coalescer, allocator); });
+                coalescer->InstallConnectionHandlers();
+
+                return coalescer;
+            }
+
+            MqttSubscribeCoalescer::MqttSubscribeCoalescer(
+                const std::shared_ptr<MqttConnection> &connection,
+                const MqttSubscribeCoalescerOptions &options,
+                Allocator *allocator) noexcept
+                : m_allocator(allocator), m_connection(connection), m_options(options), m_online(false),
+                  m_flushScheduled(false)
+            {
+            }
+
+            MqttSubscribeCoalescer::~MqttSubscribeCoalescer()
+            {
+                for (const auto &subscribe : m_pending)
+                {
+                    if (subscribe->onSubAck)
+                    {
+                        subscribe->onSubAck(
+                            *m_connection, 0, subscribe->topic, subscribe->qos, AWS_ERROR_MQTT_NOT_CONNECTED);
+                    }
+                }
+            }
+
+            void MqttSubscribeCoalescer::InstallConnectionHandlers() noexcept
+            {
+                std::weak_ptr<MqttSubscribeCoalescer> weakSelf = shared_from_this();
+
+                OnConnectionCompletedHandler onCompleted = std::move(m_connection->OnConnectionCompleted);
+                m_connection->OnConnectionCompleted =
+                    [weakSelf, onCompleted](
+                        MqttConnection &connection, int errorCode, ReturnCode returnCode, bool sessionPresent) {
+                        if (auto self = weakSelf.lock())
+                        {
+                            self->SetOnline(errorCode == AWS_ERROR_SUCCESS && returnCode == AWS_MQTT_CONNECT_ACCEPTED);
+                        }
+                        if (onCompleted)
+                        {
+                            onCompleted(connection, errorCode, returnCode, sessionPresent);
+                        }
+                    };
+
+                OnConnectionInterruptedHandler onInterrupted = std::move(m_connection->OnConnectionInterrupted);
+                m_connection->OnConnectionInterrupted = [weakSelf, onInterrupted](
+                                                            MqttConnection &connection, int errorCode) {
+                    if (auto self = weakSelf.lock())
+                    {
+                        self->SetOnline(false);
+                    }
+                    if (onInterrupted)
+                    {
+                        onInterrupted(connection, errorCode);
+                    }
+                };
+
+                OnConnectionResumedHandler onResumed = std::move(m_connection->OnConnectionResumed);
+                m_connection->OnConnectionResumed =
+                    [weakSelf, onResumed](MqttConnection &connection, ReturnCode returnCode, bool sessionPresent) {
+                        if (auto self = weakSelf.lock())
+                        {
+                            self->SetOnline(returnCode == AWS_MQTT_CONNECT_ACCEPTED);
+                        }
+                        if (onResumed)
+                        {
+                            onResumed(connection, returnCode, sessionPresent);
+                        }
+                    };
+
+                OnDisconnectHandler onDisconnect = std::move(m_connection->OnDisconnect);
+                m_connection->OnDisconnect = [weakSelf, onDisconnect](MqttConnection &connection) {
+                    if (auto self = weakSelf.lock())
+                    {
+                        self->SetOnline(false);
+                    }
+                    if (onDisconnect)
+                    {
+                        onDisconnect(connection);
+                    }
+                };
+            }
+
+            void MqttSubscribeCoalescer::SetOnline(bool online) noexcept
+            {
+                PendingSubscribes pending;
+                {
+                    std::lock_guard<std::mutex> lock(m_lock);
+                    m_online = online;
+                    if (!online)
+                    {
+                        return;
+                    }
+                    pending.swap(m_pending);
+                    m_metrics.PendingSubscribes = 0;
+                }
+
+                Send(std::move(pending));
+            }
+
+            bool MqttSubscribeCoalescer::Subscribe(
+                const char *topicFilter,
+                QOS qos,
+                OnMessageReceivedHandler &&onMessage,
+                OnSubAckHandler &&onSubAck) noexcept
+            {
+                OnMessageReceivedViewHandler onMessageView;
+                if (onMessage)
+                {
+                    onMessageView = [onMessage](
+                                        MqttConnection &connection,
+                                        StringView topic,
+                                        const ByteCursor &payload,
+                                        bool dup,
+                                        QOS messageQos,
+                                        bool retain) {
+                        String topicStr(topic.data(), topic.size());
+                        ByteBuf payloadBuf = aws_byte_buf_from_array(payload.ptr, payload.len);
+                        onMessage(connection, topicStr, payloadBuf, dup, messageQos, retain);
+                    };
+                }
+
+                return Subscribe(topicFilter, qos, std::move(onMessageView), std::move(onSubAck));
+            }
+
+            bool MqttSubscribeCoalescer::Subscribe(
+                const char *topicFilter,
+                QOS qos,
+                std::nullptr_t,
+                OnSubAckHandler &&onSubAck) noexcept
+            {
+                return Subscribe(topicFilter, qos, OnMessageReceivedViewHandler(), std::move(onSubAck));
+            }
+
+            bool MqttSubscribeCoalescer::Subscribe(
+                const char *topicFilter,
+                QOS qos,
+                OnMessageReceivedViewHandler &&onMessage,
+                OnSubAckHandler &&onSubAck) noexcept
+            {
+                if (topicFilter == nullptr || *topicFilter == '\0')
+                {
+                    aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                    return false;
+                }
+
+                auto subscribe = MakeShared<CoalescedSubscribe>(m_allocator, topicFilter, qos, m_allocator);
+                if (!subscribe)
+                {
+                    return false;
+                }
+                subscribe->onMessage = std::move(onMessage);
+                subscribe->onSubAck = std::move(onSubAck);
+
+                PendingSubscribes ready;
+                {
+                    std::lock_guard<std::mutex> lock(m_lock);
+                    m_pending.push_back(std::move(subscribe));
+
+                    if (m_online)
+                    {
+                        if (m_options.EventLoopGroup == nullptr ||
+                            m_pending.size() >= m_options.MaxTopicsPerSubscribe)
+                        {
+                            ready.swap(m_pending);
+                        }
+                        else if (!m_flushScheduled)
+                        {
+                            ScheduleFlush();
+                        }
+                    }
+                    m_metrics.PendingSubscribes = m_pending.size();
+                }
+
+                Send(std::move(ready));
+                return true;
+            }
+
+            void MqttSubscribeCoalescer::ScheduleFlush() noexcept
+            {
+                aws_event_loop *eventLoop =
+                    aws_event_loop_group_get_next_loop(m_options.EventLoopGroup->GetUnderlyingHandle());
+                uint64_t now = 0;
+                if (eventLoop == nullptr || aws_event_loop_current_clock_time(eventLoop, &now))
+                {
+                    return;
+                }
+
+                auto *flushTask = Crt::New<CoalescerFlushTask>(m_allocator);
+                if (!flushTask)
+                {
+                    return;
+                }
+
+                flushTask->coalescer = shared_from_this();
+                flushTask->allocator = m_allocator;
+                aws_task_init(&flushTask->task, s_onFlushTask, flushTask, "cpp-crt-mqtt-subscribe-coalescer-flush");
+
+                auto window = std::chrono::duration_cast<std::chrono::nanoseconds>(m_options.CoalescingWindow);
+                aws_event_loop_schedule_task_future(
+                    eventLoop, &flushTask->task, now + static_cast<uint64_t>(window.count()));
+                m_flushScheduled = true;
+            }
+
+            void MqttSubscribeCoalescer::s_onFlushTask(aws_task *, void *arg, aws_task_status status)
+            {
+                auto *flushTask = reinterpret_cast<CoalescerFlushTask *>(arg);
+                if (auto self = flushTask->coalescer.lock())
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(self->m_lock);
+                        self->m_flushScheduled = false;
+                    }
+
+                    if (status == AWS_TASK_STATUS_RUN_READY)
+                    {
+                        self->Flush();
+                    }
+                }
+
+                Crt::Delete(flushTask, flushTask->allocator);
+            }
+
+            size_t MqttSubscribeCoalescer::Flush() noexcept
+            {
+                PendingSubscribes pending;
+                {
+                    std::lock_guard<std::mutex> lock(m_lock);
+                    if (!m_online)
+                    {
+                        return 0;
+                    }
+                    pending.swap(m_pending);
+                    m_metrics.PendingSubscribes = 0;
+                }
+
+                return Send(std::move(pending));
+            }
+
+            size_t MqttSubscribeCoalescer::Send(PendingSubscribes &&pending) noexcept
+            {
+                size_t packets = 0;
+                size_t topics = 0;
+                const QOS levels[] = {AWS_MQTT_QOS_AT_MOST_ONCE, AWS_MQTT_QOS_AT_LEAST_ONCE, AWS_MQTT_QOS_EXACTLY_ONCE};
+
+                for (QOS qos : levels)
+                {
+                    PendingSubscribes collected;
+                    for (size_t i = 0; i < pending.size(); ++i)
+                    {
+                        if (pending[i] && pending[i]->qos == qos)
+                        {
+                            collected.push_back(std::move(pending[i]));
+                        }
+
+                        if (collected.empty() ||
+                            (collected.size() < m_options.MaxTopicsPerSubscribe && i + 1 < pending.size()))
+                        {
+                            continue;
+                        }
+
+                        /* the batch outlives the call through the suback handler, which fans the ack back out */
+                        auto batch = MakeShared<PendingSubscribes>(m_allocator, std::move(collected));
+                        uint16_t packetId = 0;
+                        if (batch)
+                        {
+                            collected.clear();
+                            Vector<std::pair<const char *, OnMessageReceivedViewHandler>> topicFilters;
+                            topicFilters.reserve(batch->size());
+                            for (const auto &subscribe : *batch)
+                            {
+                                topicFilters.emplace_back(subscribe->topic.c_str(), subscribe->onMessage);
+                            }
+
+                            /* each topic gets the QoS granted to it, so one rejected filter isn't reported as
+                             * granted just because the rest of its packet was */
+                            packetId = m_connection->SubscribeMultiple(
+                                topicFilters,
+                                qos,
+                                OnMultiSubAckHandler(),
+                                [batch, qos](
+                                    MqttConnection &connection,
+                                    uint16_t packetId,
+                                    const Vector<String> &,
+                                    const Vector<QOS> &grantedQos,
+                                    int errorCode) {
+                                    for (size_t j = 0; j < batch->size(); ++j)
+                                    {
+                                        const auto &subscribe = (*batch)[j];
+                                        if (subscribe->onSubAck)
+                                        {
+                                            QOS granted = j < grantedQos.size() ? grantedQos[j] : qos;
+                                            subscribe->onSubAck(
+                                                connection, packetId, subscribe->topic, granted, errorCode);
+                                        }
+                                    }
+                                });
+                        }
+
+                        if (packetId != 0)
+                        {
+                            ++packets;
+                            topics += batch->size();
+                            continue;
+                        }
+
+                        int errorCode = aws_last_error() != AWS_ERROR_SUCCESS ? aws_last_error() : AWS_ERROR_UNKNOWN;
+                        for (const auto &subscribe : batch ? *batch : collected)
+                        {
+                            if (subscribe->onSubAck)
+                            {
+                                subscribe->onSubAck(*m_connection, 0, subscribe->topic, qos, errorCode);
+                            }
+                        }
+                        collected.clear();
+                    }
+                }
+
+                std::lock_guard<std::mutex> lock(m_lock);
+                m_metrics.SubscribePackets += packets;
+                m_metrics.SubscribedTopics += topics;
+                return packets;
+            }
+
+            MqttSubscribeCoalescerMetrics MqttSubscribeCoalescer::GetMetrics() const noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                return m_metrics;
+            }
+        } // namespace Mqtt
+    }     // namespace Crt
+} // namespace Aws
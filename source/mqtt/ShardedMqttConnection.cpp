@@ -0,0 +1,246 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/mqtt/ShardedMqttConnection.h>
+
+#include <cstring>
+#include <string>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Mqtt
+        {
+            ShardedMqttConnection::ShardedMqttConnection(
+                MqttClient &client,
+                size_t shardCount,
+                const char *hostName,
+                uint16_t port,
+                const Io::SocketOptions &socketOptions,
+                const Crt::Io::TlsContext &tlsContext,
+                bool useWebsocket) noexcept
+                : m_pendingConnects(0), m_connectedShards(0), m_pendingDisconnects(0), m_lastError(AWS_ERROR_SUCCESS)
+            {
+                if (shardCount == 0)
+                {
+                    m_lastError = AWS_ERROR_INVALID_ARGUMENT;
+                    return;
+                }
+
+                m_shards.reserve(shardCount);
+                for (size_t i = 0; i < shardCount && m_lastError == AWS_ERROR_SUCCESS; ++i)
+                {
+                    AddShard(client.NewConnection(hostName, port, socketOptions, tlsContext, useWebsocket));
+                }
+            }
+
+            ShardedMqttConnection::ShardedMqttConnection(
+                MqttClient &client,
+                size_t shardCount,
+                const char *hostName,
+                uint16_t port,
+                const Io::SocketOptions &socketOptions,
+                bool useWebsocket) noexcept
+                : m_pendingConnects(0), m_connectedShards(0), m_pendingDisconnects(0), m_lastError(AWS_ERROR_SUCCESS)
+            {
+                if (shardCount == 0)
+                {
+                    m_lastError = AWS_ERROR_INVALID_ARGUMENT;
+                    return;
+                }
+
+                m_shards.reserve(shardCount);
+                for (size_t i = 0; i < shardCount && m_lastError == AWS_ERROR_SUCCESS; ++i)
+                {
+                    AddShard(client.NewConnection(hostName, port, socketOptions, useWebsocket));
+                }
+            }
+
+            void ShardedMqttConnection::AddShard(std::shared_ptr<MqttConnection> &&shard) noexcept
+            {
+                if (!shard || !*shard)
+                {
+                    m_lastError = aws_last_error() != AWS_ERROR_SUCCESS ? aws_last_error() : AWS_ERROR_UNKNOWN;
+                    return;
+                }
+
+                shard->OnConnectionCompleted = [this](MqttConnection &, int errorCode, ReturnCode returnCode, bool) {
+                    CompleteConnect(errorCode == AWS_ERROR_SUCCESS && returnCode == AWS_MQTT_CONNECT_ACCEPTED);
+                };
+                shard->OnDisconnect = [this](MqttConnection &) { CompleteDisconnect(); };
+
+                m_shards.push_back(std::move(shard));
+            }
+
+            size_t ShardedMqttConnection::GetShardIndex(StringView topic) const noexcept
+            {
+                if (m_shards.empty())
+                {
+                    return 0;
+                }
+
+                return static_cast<size_t>(HashStringView(topic) % m_shards.size());
+            }
+
+            void ShardedMqttConnection::CompleteConnect(bool connected) noexcept
+            {
+                if (connected)
+                {
+                    ++m_connectedShards;
+                }
+
+                if (--m_pendingConnects == 0 && OnConnectionCompleted)
+                {
+                    OnConnectionCompleted(*this, m_connectedShards.load());
+                }
+            }
+
+            void ShardedMqttConnection::CompleteDisconnect() noexcept
+            {
+                if (--m_pendingDisconnects == 0 && OnDisconnect)
+                {
+                    OnDisconnect(*this);
+                }
+            }
+
+            bool ShardedMqttConnection::Connect(
+                const char *clientIdPrefix,
+                bool cleanSession,
+                uint16_t keepAliveTimeSecs,
+                uint32_t pingTimeoutMs,
+                uint32_t protocolOperationTimeoutMs) noexcept
+            {
+                if (m_lastError != AWS_ERROR_SUCCESS || clientIdPrefix == nullptr)
+                {
+                    aws_raise_error(m_lastError != AWS_ERROR_SUCCESS ? m_lastError : AWS_ERROR_INVALID_ARGUMENT);
+                    return false;
+                }
+
+                /* one extra count, so completions racing the loop below can not finish the connect early */
+                m_connectedShards = 0;
+                m_pendingConnects = m_shards.size() + 1;
+
+                bool anyStarted = false;
+                for (size_t i = 0; i < m_shards.size(); ++i)
+                {
+                    String clientId(clientIdPrefix);
+                    clientId += '-';
+                    clientId += std::to_string(i).c_str();
+
+                    if (m_shards[i]->Connect(
+                            clientId.c_str(),
+                            cleanSession,
+                            keepAliveTimeSecs,
+                            pingTimeoutMs,
+                            protocolOperationTimeoutMs))
+                    {
+                        anyStarted = true;
+                    }
+                    else
+                    {
+                        --m_pendingConnects;
+                    }
+                }
+
+                if (!anyStarted)
+                {
+                    m_pendingConnects = 0;
+                    return false;
+                }
+
+                CompleteConnect(false);
+                return true;
+            }
+
+            bool ShardedMqttConnection::Disconnect() noexcept
+            {
+                m_pendingDisconnects = m_shards.size() + 1;
+
+                bool anyStarted = false;
+                for (auto &shard : m_shards)
+                {
+                    if (shard->Disconnect())
+                    {
+                        anyStarted = true;
+                    }
+                    else
+                    {
+                        --m_pendingDisconnects;
+                    }
+                }
+
+                if (!anyStarted)
+                {
+                    m_pendingDisconnects = 0;
+                    return false;
+                }
+
+                CompleteDisconnect();
+                return true;
+            }
+
+            uint16_t ShardedMqttConnection::Subscribe(
+                const char *topicFilter,
+                QOS qos,
+                OnMessageReceivedViewHandler &&onMessage,
+                OnSubAckHandler &&onSubAck) noexcept
+            {
+                if (m_shards.empty() || topicFilter == nullptr)
+                {
+                    aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                    return 0;
+                }
+
+                auto &shard = m_shards[GetShardIndex(StringView(topicFilter, strlen(topicFilter)))];
+                return shard->Subscribe(topicFilter, qos, std::move(onMessage), std::move(onSubAck));
+            }
+
+            uint16_t ShardedMqttConnection::Unsubscribe(
+                const char *topicFilter,
+                OnOperationCompleteHandler &&onOpComplete) noexcept
+            {
+                if (m_shards.empty() || topicFilter == nullptr)
+                {
+                    aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                    return 0;
+                }
+
+                auto &shard = m_shards[GetShardIndex(StringView(topicFilter, strlen(topicFilter)))];
+                return shard->Unsubscribe(topicFilter, std::move(onOpComplete));
+            }
+
+            bool ShardedMqttConnection::SetOnMessageHandler(const OnMessageReceivedViewHandler &onMessage) noexcept
+            {
+                for (auto &shard : m_shards)
+                {
+                    OnMessageReceivedViewHandler shardHandler = onMessage;
+                    if (!shard->SetOnMessageHandler(std::move(shardHandler)))
+                    {
+                        return false;
+                    }
+                }
+
+                return !m_shards.empty();
+            }
+
+            uint16_t ShardedMqttConnection::Publish(
+                const char *topic,
+                QOS qos,
+                bool retain,
+                const ByteBuf &payload,
+                OnOperationCompleteHandler &&onOpComplete) noexcept
+            {
+                if (m_shards.empty() || topic == nullptr)
+                {
+                    aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                    return 0;
+                }
+
+                auto &shard = m_shards[GetShardIndex(StringView(topic, strlen(topic)))];
+                return shard->Publish(topic, qos, retain, payload, std::move(onOpComplete));
+            }
+        } // namespace Mqtt
+    }     // namespace Crt
+} // namespace Aws
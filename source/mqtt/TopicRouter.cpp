@@ -0,0 +1,320 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/mqtt/TopicRouter.h>
+
+#include <aws/crt/SmallVector.h>
+
+#include <algorithm>
+
+namespace Aws
+{
+    namespace Crt
+    {
+        namespace Mqtt
+        {
+            /* FNV-1a, so looking up a level does not have to copy it into a String first */
+            struct TopicLevelHash
+            {
+                size_t operator()(const StringView &level) const noexcept
+                {
+                    uint64_t hash = 14695981039346656037ULL;
+                    for (char c : level)
+                    {
+                        hash ^= static_cast<uint8_t>(c);
+                        hash *= 1099511628211ULL;
+                    }
+                    return static_cast<size_t>(hash);
+                }
+            };
+
+            struct TopicRoute
+            {
+                TopicRoute(uint64_t routeId, StringView topicFilter, Allocator *allocator)
+                    : id(routeId), filter(topicFilter.data(), topicFilter.size(), StlAllocator<char>(allocator))
+                {
+                }
+
+                uint64_t id;
+                String filter;
+                OnMessageReceivedViewHandler handler;
+            };
+
+            struct TopicRouterNode
+            {
+                using ChildMap = std::unordered_map<
+                    StringView,
+                    TopicRouterNode *,
+                    TopicLevelHash,
+                    std::equal_to<StringView>,
+                    StlAllocator<std::pair<const StringView, TopicRouterNode *>>>;
+
+                TopicRouterNode(StringView topicLevel, Allocator *allocator)
+                    : level(topicLevel.data(), topicLevel.size(), StlAllocator<char>(allocator)),
+                      children(
+                          0,
+                          TopicLevelHash(),
+                          std::equal_to<StringView>(),
+                          StlAllocator<ChildMap::value_type>(allocator)),
+                      routes(StlAllocator<std::shared_ptr<TopicRoute>>(allocator))
+                {
+                }
+
+                /* the node's key in its parent's children, which refer to this string rather than copy it */
+                String level;
+                ChildMap children;
+                Vector<std::shared_ptr<TopicRoute>> routes;
+            };
+
+            using TopicLevels = SmallVector<StringView, 16>;
+
+            static const StringView s_SingleLevelWildcard("+");
+            static const StringView s_MultiLevelWildcard("#");
+
+            static void s_SplitLevels(StringView topic, TopicLevels &levels)
+            {
+                size_t start = 0;
+                for (;;)
+                {
+                    size_t separator = topic.find('/', start);
+                    if (separator == StringView::npos)
+                    {
+                        levels.push_back(topic.substr(start));
+                        return;
+                    }
+
+                    levels.push_back(topic.substr(start, separator - start));
+                    start = separator + 1;
+                }
+            }
+
+            static void s_DestroyNode(TopicRouterNode *node, Allocator *allocator)
+            {
+                for (auto &child : node->children)
+                {
+                    s_DestroyNode(child.second, allocator);
+                }
+
+                Crt::Delete(node, allocator);
+            }
+
+            using RouteMatches = SmallVector<std::shared_ptr<TopicRoute>, 8>;
+
+            static void s_CollectRoutes(
+                const TopicRouterNode *node,
+                const TopicLevels &levels,
+                size_t index,
+                bool systemTopic,
+                RouteMatches &matches)
+            {
+                bool wildcardsMatch = index > 0 || !systemTopic;
+                if (wildcardsMatch)
+                {
+                    auto multiLevel = node->children.find(s_MultiLevelWildcard);
+                    if (multiLevel != node->children.end())
+                    {
+                        for (const auto &route : multiLevel->second->routes)
+                        {
+                            matches.push_back(route);
+                        }
+                    }
+                }
+
+                if (index == levels.size())
+                {
+                    for (const auto &route : node->routes)
+                    {
+                        matches.push_back(route);
+                    }
+                    return;
+                }
+
+                auto exact = node->children.find(levels[index]);
+                if (exact != node->children.end())
+                {
+                    s_CollectRoutes(exact->second, levels, index + 1, systemTopic, matches);
+                }
+
+                if (wildcardsMatch)
+                {
+                    auto singleLevel = node->children.find(s_SingleLevelWildcard);
+                    if (singleLevel != node->children.end() && singleLevel != exact)
+                    {
+                        s_CollectRoutes(singleLevel->second, levels, index + 1, systemTopic, matches);
+                    }
+                }
+            }
+
+            TopicRouter::TopicRouter(Allocator *allocator) noexcept
+                : m_allocator(allocator), m_root(Crt::New<TopicRouterNode>(allocator, StringView(), allocator)),
+                  m_routes(StlAllocator<std::pair<const uint64_t, std::shared_ptr<TopicRoute>>>(allocator)),
+                  m_nextRouteId(1)
+            {
+            }
+
+            TopicRouter::~TopicRouter()
+            {
+                if (m_root)
+                {
+                    s_DestroyNode(m_root, m_allocator);
+                }
+            }
+
+            bool TopicRouter::IsValidTopicFilter(StringView topicFilter) noexcept
+            {
+                if (topicFilter.empty() || topicFilter.size() > UINT16_MAX)
+                {
+                    return false;
+                }
+
+                TopicLevels levels;
+                s_SplitLevels(topicFilter, levels);
+                for (size_t i = 0; i < levels.size(); ++i)
+                {
+                    StringView level = levels[i];
+                    if (level.find('#') != StringView::npos && (level.size() != 1 || i + 1 != levels.size()))
+                    {
+                        return false;
+                    }
+
+                    if (level.find('+') != StringView::npos && level.size() != 1)
+                    {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+            uint64_t TopicRouter::AddRoute(StringView topicFilter, OnMessageReceivedViewHandler &&handler) noexcept
+            {
+                if (!m_root || !IsValidTopicFilter(topicFilter))
+                {
+                    aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                    return 0;
+                }
+
+                TopicLevels levels;
+                s_SplitLevels(topicFilter, levels);
+
+                std::lock_guard<std::mutex> lock(m_lock);
+                auto route = MakeShared<TopicRoute>(m_allocator, m_nextRouteId, topicFilter, m_allocator);
+                if (!route)
+                {
+                    return 0;
+                }
+                route->handler = std::move(handler);
+
+                TopicRouterNode *node = m_root;
+                for (StringView level : levels)
+                {
+                    auto child = node->children.find(level);
+                    if (child == node->children.end())
+                    {
+                        auto newNode = Crt::New<TopicRouterNode>(m_allocator, level, m_allocator);
+                        if (!newNode)
+                        {
+                            return 0;
+                        }
+                        StringView key(newNode->level.data(), newNode->level.size());
+                        child = node->children.emplace(key, newNode).first;
+                    }
+                    node = child->second;
+                }
+
+                node->routes.push_back(route);
+                m_routes.emplace(route->id, route);
+
+                return m_nextRouteId++;
+            }
+
+            bool TopicRouter::RemoveRoute(uint64_t routeId) noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                auto entry = m_routes.find(routeId);
+                if (entry == m_routes.end())
+                {
+                    return false;
+                }
+
+                std::shared_ptr<TopicRoute> route = entry->second;
+                m_routes.erase(entry);
+
+                TopicLevels levels;
+                s_SplitLevels(StringView(route->filter.data(), route->filter.size()), levels);
+
+                SmallVector<TopicRouterNode *, 16> path;
+                path.push_back(m_root);
+                for (StringView level : levels)
+                {
+                    path.push_back(path.back()->children.find(level)->second);
+                }
+
+                auto &routes = path.back()->routes;
+                routes.erase(std::find(routes.begin(), routes.end(), route));
+
+                /* prune the branch back to the last node still in use */
+                while (path.size() > 1 && path.back()->routes.empty() && path.back()->children.empty())
+                {
+                    TopicRouterNode *node = path.back();
+                    path.pop_back();
+                    path.back()->children.erase(StringView(node->level.data(), node->level.size()));
+                    Crt::Delete(node, m_allocator);
+                }
+
+                return true;
+            }
+
+            size_t TopicRouter::GetRouteCount() const noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                return m_routes.size();
+            }
+
+            size_t TopicRouter::Dispatch(
+                MqttConnection &connection,
+                StringView topic,
+                const ByteCursor &payload,
+                bool dup,
+                QOS qos,
+                bool retain) const noexcept
+            {
+                TopicLevels levels;
+                s_SplitLevels(topic, levels);
+
+                /* handlers run outside the lock, so they are free to add and remove routes */
+                RouteMatches matches;
+                {
+                    std::lock_guard<std::mutex> lock(m_lock);
+                    if (m_root)
+                    {
+                        s_CollectRoutes(m_root, levels, 0, !topic.empty() && topic[0] == '$', matches);
+                    }
+                }
+
+                for (const auto &route : matches)
+                {
+                    if (route->handler)
+                    {
+                        route->handler(connection, topic, payload, dup, qos, retain);
+                    }
+                }
+
+                return matches.size();
+            }
+
+            OnMessageReceivedViewHandler TopicRouter::GetOnMessageReceived() noexcept
+            {
+                auto self = shared_from_this();
+                return [self](
+                           MqttConnection &connection,
+                           StringView topic,
+                           const ByteCursor &payload,
+                           bool dup,
+                           QOS qos,
+                           bool retain) { self->Dispatch(connection, topic, payload, dup, qos, retain); };
+            }
+        } // namespace Mqtt
+    }     // namespace Crt
+} // namespace Aws
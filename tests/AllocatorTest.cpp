@@ -0,0 +1,241 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/Api.h>
+#include <aws/crt/ArenaAllocator.h>
+#include <aws/crt/PoolAllocator.h>
+#include <aws/testing/aws_test_harness.h>
+
+#include <thread>
+
+static int s_TestArenaAllocatorContainers(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::ArenaAllocator arena(256, allocator);
+        Aws::Crt::Allocator *arenaAllocator = arena.GetUnderlyingHandle();
+
+        {
+            Aws::Crt::StlAllocator<int> intAllocator(arenaAllocator);
+            Aws::Crt::Vector<int> ints(intAllocator);
+            for (int i = 0; i < 1000; ++i)
+            {
+                ints.push_back(i);
+            }
+
+            Aws::Crt::String str("a string that is long enough to not fit in the small string buffer", arenaAllocator);
+
+            ASSERT_INT_EQUALS(1000, ints.size());
+            ASSERT_INT_EQUALS(999, ints.back());
+            ASSERT_TRUE(arena.BytesAllocated() >= 1000 * sizeof(int));
+        }
+
+        ASSERT_TRUE(arena.BytesReserved() > 0);
+        arena.Reset();
+        ASSERT_UINT_EQUALS(0, arena.BytesAllocated());
+        ASSERT_UINT_EQUALS(0, arena.BytesReserved());
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(ArenaAllocatorContainers, s_TestArenaAllocatorContainers)
+
+static int s_TestArenaAllocatorScope(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::ArenaAllocator arena(128, allocator);
+
+        void *outer = aws_mem_acquire(arena.GetUnderlyingHandle(), 16);
+        ASSERT_NOT_NULL(outer);
+        size_t allocatedBeforeScope = arena.BytesAllocated();
+        size_t reservedBeforeScope = arena.BytesReserved();
+
+        {
+            Aws::Crt::ArenaScope scope(arena);
+            for (size_t i = 0; i < 64; ++i)
+            {
+                ASSERT_NOT_NULL(aws_mem_acquire(scope.GetAllocator(), 64));
+            }
+
+            /* oversized allocations get their own block */
+            ASSERT_NOT_NULL(aws_mem_calloc(scope.GetAllocator(), 1, 4096));
+            ASSERT_TRUE(arena.BytesReserved() > reservedBeforeScope);
+        }
+
+        ASSERT_UINT_EQUALS(allocatedBeforeScope, arena.BytesAllocated());
+        ASSERT_UINT_EQUALS(reservedBeforeScope, arena.BytesReserved());
+
+        /* the most recent allocation grows in place */
+        void *last = aws_mem_acquire(arena.GetUnderlyingHandle(), 16);
+        void *grown = last;
+        ASSERT_SUCCESS(aws_mem_realloc(arena.GetUnderlyingHandle(), &grown, 16, 32));
+        ASSERT_PTR_EQUALS(last, grown);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(ArenaAllocatorScope, s_TestArenaAllocatorScope)
+
+static int s_TestPoolAllocatorReuse(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::PoolAllocator *pool = Aws::Crt::PoolAllocator::Create(allocator);
+        ASSERT_NOT_NULL(pool);
+        Aws::Crt::Allocator *poolAllocator = pool->GetUnderlyingHandle();
+
+        void *first = aws_mem_acquire(poolAllocator, 24);
+        ASSERT_NOT_NULL(first);
+        aws_mem_release(poolAllocator, first);
+
+        /* same size class on the same thread comes back off the free list */
+        void *second = aws_mem_acquire(poolAllocator, 30);
+        ASSERT_PTR_EQUALS(first, second);
+
+        /* growing within the size class is in place */
+        ASSERT_SUCCESS(aws_mem_realloc(poolAllocator, &second, 30, 32));
+        ASSERT_PTR_EQUALS(first, second);
+        aws_mem_release(poolAllocator, second);
+
+        void *large = aws_mem_calloc(poolAllocator, 1, Aws::Crt::PoolAllocator::MaxPooledSize + 1);
+        ASSERT_NOT_NULL(large);
+        aws_mem_release(poolAllocator, large);
+
+        pool->Release();
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(PoolAllocatorReuse, s_TestPoolAllocatorReuse)
+
+static int s_TestPoolAllocatorReleaseBeforeBlocks(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::PoolAllocator *pool = Aws::Crt::PoolAllocator::Create(allocator);
+        ASSERT_NOT_NULL(pool);
+        Aws::Crt::Allocator *poolAllocator = pool->GetUnderlyingHandle();
+
+        void *small = aws_mem_acquire(poolAllocator, 24);
+        void *large = aws_mem_acquire(poolAllocator, Aws::Crt::PoolAllocator::MaxPooledSize + 1);
+        void *elsewhere = aws_mem_acquire(poolAllocator, 100);
+        ASSERT_NOT_NULL(small);
+        ASSERT_NOT_NULL(large);
+        ASSERT_NOT_NULL(elsewhere);
+
+        /* the blocks keep the pool alive past the owner's reference, and the last of them destroys it */
+        pool->Release();
+        aws_mem_release(poolAllocator, small);
+        aws_mem_release(poolAllocator, large);
+
+        std::thread releaser([poolAllocator, elsewhere]() { aws_mem_release(poolAllocator, elsewhere); });
+        releaser.join();
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(PoolAllocatorReleaseBeforeBlocks, s_TestPoolAllocatorReleaseBeforeBlocks)
+
+static int s_TestApiHandleThreadCachingPool(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandleOptions options;
+        options.EnableThreadCachingPool = true;
+        Aws::Crt::ApiHandle apiHandle(allocator, options);
+
+        ASSERT_TRUE(Aws::Crt::g_allocator != allocator);
+
+        Aws::Crt::Vector<Aws::Crt::String> strings;
+        for (size_t i = 0; i < 100; ++i)
+        {
+            strings.emplace_back("a string long enough to need a heap allocation of its own");
+        }
+        strings.clear();
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(ApiHandleThreadCachingPool, s_TestApiHandleThreadCachingPool)
+
+static int s_TestApiHandleAllocationTracing(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandleOptions options;
+        options.EnableAllocationTracing = true;
+        Aws::Crt::ApiHandle apiHandle(allocator, options);
+
+        const Aws::Crt::TracingAllocator *tracer = apiHandle.GetTracingAllocator();
+        ASSERT_NOT_NULL(tracer);
+
+        Aws::Crt::AllocationStats before = tracer->GetStats(Aws::Crt::AllocationSubsystem::Crt);
+        {
+            Aws::Crt::String str("a string long enough to need a heap allocation of its own");
+            Aws::Crt::AllocationStats during = tracer->GetStats(Aws::Crt::AllocationSubsystem::Crt);
+            ASSERT_TRUE(during.TotalAllocations > before.TotalAllocations);
+            ASSERT_TRUE(during.LiveBytes >= before.LiveBytes + str.size());
+            ASSERT_TRUE(during.HighWaterBytes >= during.LiveBytes);
+        }
+
+        Aws::Crt::AllocationStats after = tracer->GetStats(Aws::Crt::AllocationSubsystem::Crt);
+        ASSERT_UINT_EQUALS(before.LiveBytes, after.LiveBytes);
+        ASSERT_UINT_EQUALS(before.LiveAllocations, after.LiveAllocations);
+
+        Aws::Crt::AllocationStats total = tracer->GetTotalStats();
+        ASSERT_TRUE(total.TotalAllocations >= after.TotalAllocations);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(ApiHandleAllocationTracing, s_TestApiHandleAllocationTracing)
+
+static int s_TestStlAllocatorPropagation(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::ArenaAllocator arena(1024, allocator);
+        Aws::Crt::StlAllocator<int> defaultAllocator(allocator);
+        Aws::Crt::StlAllocator<int> arenaAllocator(arena.GetUnderlyingHandle());
+
+        ASSERT_TRUE(defaultAllocator == Aws::Crt::StlAllocator<char>(allocator));
+        ASSERT_TRUE(defaultAllocator != arenaAllocator);
+
+        Aws::Crt::Vector<int> source({1, 2, 3, 4}, arenaAllocator);
+        const int *storage = source.data();
+
+        /* move assignment across allocators takes the storage and the allocator with it */
+        Aws::Crt::Vector<int> destination(defaultAllocator);
+        destination = std::move(source);
+        ASSERT_PTR_EQUALS(storage, destination.data());
+        ASSERT_TRUE(destination.get_allocator() == arenaAllocator);
+
+        Aws::Crt::Vector<int> other({5}, defaultAllocator);
+        destination.swap(other);
+        ASSERT_PTR_EQUALS(storage, other.data());
+        ASSERT_TRUE(other.get_allocator() == arenaAllocator);
+        ASSERT_TRUE(destination.get_allocator() == defaultAllocator);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(StlAllocatorPropagation, s_TestStlAllocatorPropagation)
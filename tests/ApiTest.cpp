@@ -3,9 +3,16 @@
  * SPDX-License-Identifier: Apache-2.0.
  */
 #include <aws/crt/Api.h>
+#include <aws/crt/JsonObject.h>
 #include <aws/crt/Types.h>
 #include <aws/testing/aws_test_harness.h>
 
+#include <aws/common/file.h>
+
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
 static int s_TestApiMultiCreateDestroy(struct aws_allocator *allocator, void *)
 {
     {
@@ -37,3 +44,214 @@ static int s_TestApiMultiDefaultCreateDestroy(struct aws_allocator *allocator, v
 }
 
 AWS_TEST_CASE(ApiMultiDefaultCreateDestroy, s_TestApiMultiDefaultCreateDestroy)
+
+static const char *ASYNC_LOGGING_TEST_FILE = "async_logging_test.log";
+
+/* reads the log through a FILE of its own, so the writer's position and buffering are left alone */
+static size_t s_CountLinesContaining(const char *path, const char *needle)
+{
+    FILE *fp = aws_fopen(path, "r");
+    if (fp == nullptr)
+    {
+        return 0;
+    }
+
+    size_t count = 0;
+    char line[1024];
+    while (fgets(line, sizeof(line), fp) != nullptr)
+    {
+        if (strstr(line, needle) != nullptr)
+        {
+            ++count;
+        }
+    }
+    fclose(fp);
+
+    return count;
+}
+
+static int s_TestApiHandleAsyncLogging(struct aws_allocator *allocator, void *)
+{
+    const char *path = ASYNC_LOGGING_TEST_FILE;
+    remove(path);
+
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+        Aws::Crt::AsyncLoggerOptions options;
+        options.RingCapacity = 8;
+        apiHandle.InitializeAsyncLogging(Aws::Crt::LogLevel::Info, path, options);
+
+        Aws::Crt::AsyncLogger *logger = apiHandle.GetAsyncLogger();
+        ASSERT_NOT_NULL(logger);
+        ASSERT_PTR_EQUALS(logger->GetUnderlyingHandle(), aws_logger_get());
+
+        /* below the level: never formatted */
+        AWS_LOGF_DEBUG(AWS_LS_COMMON_GENERAL, "async-logging-debug %d", 0);
+        for (int i = 0; i < 4; ++i)
+        {
+            AWS_LOGF_INFO(AWS_LS_COMMON_GENERAL, "async-logging-info %d", i);
+        }
+        logger->Flush();
+        ASSERT_UINT_EQUALS(4, s_CountLinesContaining(path, "async-logging-info"));
+        ASSERT_UINT_EQUALS(0, s_CountLinesContaining(path, "async-logging-debug"));
+
+        /* a thread that exits before the flush hands its ring back, and its lines still come out */
+        std::thread exited([]() {
+            for (int i = 0; i < 3; ++i)
+            {
+                AWS_LOGF_INFO(AWS_LS_COMMON_GENERAL, "async-logging-exited %d", i);
+            }
+        });
+        exited.join();
+        logger->Flush();
+        ASSERT_UINT_EQUALS(3, s_CountLinesContaining(path, "async-logging-exited"));
+        ASSERT_UINT_EQUALS(0, logger->GetDroppedCount());
+
+        /* a burst larger than the ring, with nothing draining it in between, drops lines instead of blocking */
+        for (int i = 0; i < 10000; ++i)
+        {
+            AWS_LOGF_INFO(AWS_LS_COMMON_GENERAL, "async-logging-burst %d", i);
+        }
+        logger->Flush();
+        uint64_t dropped = logger->GetDroppedCount();
+        ASSERT_UINT_EQUALS(10000, s_CountLinesContaining(path, "async-logging-burst") + dropped);
+    }
+
+    ASSERT_NULL(aws_logger_get());
+    remove(path);
+
+    return AWS_ERROR_SUCCESS;
+}
+
+AWS_TEST_CASE(ApiHandleAsyncLogging, s_TestApiHandleAsyncLogging)
+
+static int s_TestApiHandleEventTracing(struct aws_allocator *allocator, void *)
+{
+    using namespace Aws::Crt;
+
+    {
+        ApiHandle apiHandle(allocator);
+        ASSERT_NULL(apiHandle.GetEventTracer());
+
+        /* nothing is recorded before tracing is enabled */
+        EventTracer::Record(TraceEventType::HttpStream, TraceEventPhase::Begin, 1);
+
+        EventTracer *tracer = apiHandle.EnableEventTracing(16);
+        ASSERT_NOT_NULL(tracer);
+        ASSERT_PTR_EQUALS(tracer, EventTracer::GetActive());
+        ASSERT_PTR_EQUALS(tracer, apiHandle.GetEventTracer());
+
+        EventTracer::Record(TraceEventType::HttpStream, TraceEventPhase::Begin, 1);
+        std::thread other([]() {
+            EventTracer::Record(TraceEventType::CredentialsFetch, TraceEventPhase::Instant, 2, 7);
+        });
+        other.join();
+        EventTracer::Record(TraceEventType::HttpStream, TraceEventPhase::End, 1, 0);
+
+        Vector<TraceEvent> events = tracer->GetEvents();
+        ASSERT_UINT_EQUALS(3, events.size());
+        ASSERT_TRUE(events[0].Type == TraceEventType::HttpStream);
+        ASSERT_TRUE(events[0].Phase == TraceEventPhase::Begin);
+        ASSERT_TRUE(events[1].Type == TraceEventType::CredentialsFetch);
+        ASSERT_INT_EQUALS(7, events[1].Value);
+        ASSERT_TRUE(events[2].Phase == TraceEventPhase::End);
+        ASSERT_TRUE(events[0].ThreadIndex == events[2].ThreadIndex);
+        ASSERT_TRUE(events[0].ThreadIndex != events[1].ThreadIndex);
+        ASSERT_TRUE(events[0].TimestampNs <= events[1].TimestampNs);
+        ASSERT_TRUE(events[1].TimestampNs <= events[2].TimestampNs);
+
+        ByteBuf trace;
+        ASSERT_SUCCESS(aws_byte_buf_init(&trace, allocator, 1024));
+        ASSERT_TRUE(tracer->ExportChromeTrace(trace));
+        JsonObject parsed(String(reinterpret_cast<const char *>(trace.buffer), trace.len));
+        aws_byte_buf_clean_up(&trace);
+        ASSERT_TRUE(parsed.WasParseSuccessful());
+
+        /* a thread_name entry per thread, then the events */
+        Vector<JsonView> traceEvents = parsed.View().GetArray("traceEvents");
+        ASSERT_UINT_EQUALS(5, traceEvents.size());
+        ASSERT_TRUE(traceEvents[2].GetString("name") == "HttpStream");
+        ASSERT_TRUE(traceEvents[2].GetString("ph") == "b");
+        ASSERT_TRUE(traceEvents[2].GetString("id") == "0x1");
+        ASSERT_TRUE(traceEvents[3].GetString("ph") == "i");
+        ASSERT_INT_EQUALS(7, traceEvents[3].GetJsonObject("args").GetInt64("value"));
+
+        /* a full ring overwrites its oldest events */
+        for (int i = 0; i < 20; ++i)
+        {
+            EventTracer::Record(TraceEventType::MqttPublish, TraceEventPhase::Instant, i);
+        }
+        ASSERT_UINT_EQUALS(6, tracer->GetOverwrittenCount());
+        events = tracer->GetEvents();
+        ASSERT_UINT_EQUALS(17, events.size());
+        ASSERT_INT_EQUALS(19, static_cast<int>(events.back().Id));
+
+        /* disabling keeps the events readable */
+        apiHandle.DisableEventTracing();
+        ASSERT_NULL(EventTracer::GetActive());
+        EventTracer::Record(TraceEventType::MqttPublish, TraceEventPhase::Instant, 100);
+        ASSERT_UINT_EQUALS(17, tracer->GetEvents().size());
+
+        ASSERT_PTR_EQUALS(tracer, apiHandle.EnableEventTracing());
+    }
+
+    ASSERT_NULL(EventTracer::GetActive());
+
+    return AWS_ERROR_SUCCESS;
+}
+
+AWS_TEST_CASE(ApiHandleEventTracing, s_TestApiHandleEventTracing)
+
+static int s_TestApiHandleLazySubsystems(struct aws_allocator *allocator, void *)
+{
+    using namespace Aws::Crt;
+
+    {
+        ApiHandleOptions options;
+        options.LazySubsystemInitialization = true;
+        ApiHandle apiHandle(allocator, options);
+
+        for (size_t i = 0; i < static_cast<size_t>(ApiSubsystem::Count); ++i)
+        {
+            ASSERT_FALSE(ApiHandle::IsSubsystemInitialized(static_cast<ApiSubsystem>(i)));
+        }
+
+        /* hashing and JSON work without any subsystem */
+#if !BYO_CRYPTO
+        Crypto::SHA256Digest digest;
+        ASSERT_TRUE(Crypto::ComputeSHA256(allocator, ByteCursorFromCString("lazy"), digest));
+#endif
+        JsonObject parsed(String("{\"lazy\":true}"));
+        ASSERT_TRUE(parsed.View().GetBool("lazy"));
+        ASSERT_FALSE(ApiHandle::IsSubsystemInitialized(ApiSubsystem::Io));
+
+        /* first use initializes the subsystem, and nothing more */
+        {
+            Io::EventLoopGroup eventLoopGroup(1, allocator);
+            ASSERT_TRUE(eventLoopGroup);
+        }
+        ASSERT_TRUE(ApiHandle::IsSubsystemInitialized(ApiSubsystem::Io));
+        ASSERT_FALSE(ApiHandle::IsSubsystemInitialized(ApiSubsystem::Http));
+
+        /* up front, along with what it depends on */
+        ApiHandle::InitializeSubsystem(ApiSubsystem::Mqtt);
+        ASSERT_TRUE(ApiHandle::IsSubsystemInitialized(ApiSubsystem::Http));
+        ASSERT_TRUE(ApiHandle::IsSubsystemInitialized(ApiSubsystem::Mqtt));
+        ASSERT_FALSE(ApiHandle::IsSubsystemInitialized(ApiSubsystem::Auth));
+        ASSERT_FALSE(ApiHandle::IsSubsystemInitialized(ApiSubsystem::EventStream));
+    }
+
+    ASSERT_FALSE(ApiHandle::IsSubsystemInitialized(ApiSubsystem::Io));
+
+    {
+        ApiHandle apiHandle(allocator);
+        for (size_t i = 0; i < static_cast<size_t>(ApiSubsystem::Count); ++i)
+        {
+            ASSERT_TRUE(ApiHandle::IsSubsystemInitialized(static_cast<ApiSubsystem>(i)));
+        }
+    }
+
+    return AWS_ERROR_SUCCESS;
+}
+
+AWS_TEST_CASE(ApiHandleLazySubsystems, s_TestApiHandleLazySubsystems)
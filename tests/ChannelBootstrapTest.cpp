@@ -3,8 +3,21 @@
  * SPDX-License-Identifier: Apache-2.0.
  */
 #include <aws/crt/Api.h>
+#include <aws/crt/io/SocketOptions.h>
 #include <aws/testing/aws_test_harness.h>
 
+#include <aws/io/socket_channel_handler.h>
+
+#include "LoopbackServer.h"
+
+#ifdef _WIN32
+#    include <winsock2.h>
+#else
+#    include <netinet/in.h>
+#    include <netinet/tcp.h>
+#    include <sys/socket.h>
+#endif
+
 #include <future>
 #include <utility>
 
@@ -38,3 +51,157 @@ static int s_TestClientBootstrapResourceSafety(struct aws_allocator *allocator,
 }
 
 AWS_TEST_CASE(ClientBootstrapResourceSafety, s_TestClientBootstrapResourceSafety)
+
+/* what a client channel's socket reported once SocketOptions::ApplyTuning() had run on it */
+struct SocketTuningProbe
+{
+    const Aws::Crt::Io::SocketOptions *socketOptions = nullptr;
+    std::mutex lock;
+    std::condition_variable signal;
+    int setupError = AWS_ERROR_SUCCESS;
+    bool applied = false;
+    bool shutdown = false;
+    int receiveBufferSize = 0;
+    int sendBufferSize = 0;
+    int noDelay = 0;
+};
+
+static int s_GetSocketIntOption(struct aws_channel *channel, int level, int name)
+{
+    const struct aws_socket *socket = aws_socket_handler_get_socket(aws_channel_get_first_slot(channel)->handler);
+    int value = 0;
+#ifdef _WIN32
+    int length = sizeof(value);
+    SOCKET nativeSocket = reinterpret_cast<SOCKET>(socket->io_handle.data.handle);
+#else
+    socklen_t length = sizeof(value);
+    int nativeSocket = socket->io_handle.data.fd;
+#endif
+    if (getsockopt(nativeSocket, level, name, reinterpret_cast<char *>(&value), &length) != 0)
+    {
+        return -1;
+    }
+
+    return value;
+}
+
+static void s_OnTuningChannelSetup(
+    struct aws_client_bootstrap *,
+    int errorCode,
+    struct aws_channel *channel,
+    void *userData)
+{
+    auto *probe = static_cast<SocketTuningProbe *>(userData);
+    {
+        std::lock_guard<std::mutex> guard(probe->lock);
+        probe->setupError = errorCode;
+        if (errorCode == AWS_ERROR_SUCCESS)
+        {
+            probe->applied = probe->socketOptions->ApplyTuning(channel);
+            probe->receiveBufferSize = s_GetSocketIntOption(channel, SOL_SOCKET, SO_RCVBUF);
+            probe->sendBufferSize = s_GetSocketIntOption(channel, SOL_SOCKET, SO_SNDBUF);
+            probe->noDelay = s_GetSocketIntOption(channel, IPPROTO_TCP, TCP_NODELAY);
+        }
+    }
+
+    if (errorCode == AWS_ERROR_SUCCESS)
+    {
+        aws_channel_shutdown(channel, AWS_ERROR_SUCCESS);
+    }
+    else
+    {
+        probe->signal.notify_all();
+    }
+}
+
+static void s_OnTuningChannelShutdown(struct aws_client_bootstrap *, int, struct aws_channel *channel, void *userData)
+{
+    auto *probe = static_cast<SocketTuningProbe *>(userData);
+    aws_channel_destroy(channel);
+    {
+        std::lock_guard<std::mutex> guard(probe->lock);
+        probe->shutdown = true;
+    }
+    probe->signal.notify_all();
+}
+
+static int s_TestSocketOptionsTuning(struct aws_allocator *allocator, void *)
+{
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::Io::SocketOptions socketOptions;
+        ASSERT_FALSE(socketOptions.HasTuning());
+        ASSERT_UINT_EQUALS(0, socketOptions.GetReceiveBufferSize());
+        ASSERT_UINT_EQUALS(0, socketOptions.GetSendBufferSize());
+        ASSERT_FALSE(socketOptions.GetTcpNoDelay());
+        ASSERT_UINT_EQUALS(0, socketOptions.GetBusyPollUs());
+
+        /* nothing to apply, so there is no need for a socket */
+        ASSERT_TRUE(socketOptions.ApplyTuning(nullptr));
+
+        socketOptions.SetReceiveBufferSize(4 * 1024 * 1024);
+        socketOptions.SetSendBufferSize(1024 * 1024);
+        socketOptions.SetTcpNoDelay(true);
+        socketOptions.SetBusyPollUs(50);
+        ASSERT_TRUE(socketOptions.HasTuning());
+
+        /* the settings live next to aws_socket_options, so copies carry them */
+        Aws::Crt::Io::SocketOptions copy = socketOptions;
+        ASSERT_UINT_EQUALS(4 * 1024 * 1024, copy.GetReceiveBufferSize());
+        ASSERT_UINT_EQUALS(1024 * 1024, copy.GetSendBufferSize());
+        ASSERT_TRUE(copy.GetTcpNoDelay());
+        ASSERT_UINT_EQUALS(50, copy.GetBusyPollUs());
+
+        /*
+         * Now on a real socket. The sizes are above the usual defaults and below the usual caps, and busy polling
+         * is left out since raising it can take privileges the test may not have.
+         */
+        Aws::Crt::Io::EventLoopGroup eventLoopGroup(1, allocator);
+        ASSERT_TRUE(eventLoopGroup);
+        Aws::Crt::Io::DefaultHostResolver defaultHostResolver(eventLoopGroup, 8, 30, allocator);
+        ASSERT_TRUE(defaultHostResolver);
+        Aws::Crt::Io::ClientBootstrap clientBootstrap(eventLoopGroup, defaultHostResolver, allocator);
+        clientBootstrap.EnableBlockingShutdown();
+
+        LoopbackServer server(eventLoopGroup, LoopbackServer::HandlerFactory(), allocator);
+        ASSERT_TRUE(server.Listen());
+
+        Aws::Crt::Io::SocketOptions tuned;
+        tuned.SetReceiveBufferSize(192 * 1024);
+        tuned.SetSendBufferSize(64 * 1024);
+        tuned.SetTcpNoDelay(true);
+
+        SocketTuningProbe probe;
+        probe.socketOptions = &tuned;
+
+        struct aws_socket_channel_bootstrap_options channelOptions;
+        AWS_ZERO_STRUCT(channelOptions);
+        channelOptions.bootstrap = clientBootstrap.GetUnderlyingHandle();
+        channelOptions.host_name = server.GetHostName();
+        channelOptions.port = server.GetPort();
+        channelOptions.socket_options = &tuned.GetImpl();
+        channelOptions.setup_callback = s_OnTuningChannelSetup;
+        channelOptions.shutdown_callback = s_OnTuningChannelShutdown;
+        channelOptions.user_data = &probe;
+        ASSERT_SUCCESS(aws_client_bootstrap_new_socket_channel(&channelOptions));
+
+        {
+            std::unique_lock<std::mutex> guard(probe.lock);
+            ASSERT_TRUE(probe.signal.wait_for(guard, std::chrono::seconds(10), [&probe]() {
+                return probe.shutdown || probe.setupError != AWS_ERROR_SUCCESS;
+            }));
+            ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, probe.setupError);
+            ASSERT_TRUE(probe.applied);
+
+            /* some kernels report back more than was asked for, never less */
+            ASSERT_TRUE(probe.receiveBufferSize >= 192 * 1024);
+            ASSERT_TRUE(probe.sendBufferSize >= 64 * 1024);
+            ASSERT_TRUE(probe.noDelay != 0);
+        }
+    }
+
+    return AWS_ERROR_SUCCESS;
+}
+
+AWS_TEST_CASE(SocketOptionsTuning, s_TestSocketOptionsTuning)
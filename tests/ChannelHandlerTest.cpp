@@ -4,8 +4,14 @@
  */
 #include <aws/crt/Api.h>
 #include <aws/crt/io/ChannelHandler.h>
+#include <aws/crt/io/ChannelStatistics.h>
+#include <aws/crt/io/ReadWindowTuner.h>
 #include <aws/testing/aws_test_harness.h>
 
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <thread>
 #include <utility>
 
 class ChannelHandlerMock : public Aws::Crt::Io::ChannelHandler
@@ -104,3 +110,454 @@ static int s_TestChannelHandlerInterop(struct aws_allocator *allocator, void *)
 }
 
 AWS_TEST_CASE(ChannelHandlerInterop, s_TestChannelHandlerInterop)
+
+/* Shared plumbing of the handlers below: no read traffic, shutdown completes at once. */
+class PassiveChannelHandler : public Aws::Crt::Io::ChannelHandler
+{
+  public:
+    PassiveChannelHandler(Aws::Crt::Allocator *allocator) : Aws::Crt::Io::ChannelHandler(allocator) {}
+
+    int ProcessReadMessage(struct aws_io_message *) override { return aws_raise_error(AWS_ERROR_UNIMPLEMENTED); }
+
+    int ProcessWriteMessage(struct aws_io_message *) override { return aws_raise_error(AWS_ERROR_UNIMPLEMENTED); }
+
+    int IncrementReadWindow(size_t) override { return AWS_OP_SUCCESS; }
+
+    void ProcessShutdown(Aws::Crt::Io::ChannelDirection dir, int errorCode, bool freeScarceResourcesImmediately)
+        override
+    {
+        OnShutdownComplete(dir, errorCode, freeScarceResourcesImmediately);
+    }
+
+    size_t InitialWindowSize() override { return SIZE_MAX; }
+
+    size_t MessageOverhead() override { return 0; }
+};
+
+/* Left end of the channel: stands in for the socket, recording what reaches it and completing every write. */
+class WriteCaptureHandler : public PassiveChannelHandler
+{
+  public:
+    WriteCaptureHandler(Aws::Crt::Allocator *allocator) : PassiveChannelHandler(allocator) {}
+
+    int ProcessWriteMessage(struct aws_io_message *message) override
+    {
+        Written.append(reinterpret_cast<const char *>(message->message_data.buffer), message->message_data.len);
+        MessageBuffers.push_back(message->message_data.buffer);
+        if (message->on_completion)
+        {
+            message->on_completion(message->owning_channel, message, AWS_ERROR_SUCCESS, message->user_data);
+        }
+        aws_mem_release(message->allocator, message);
+        return AWS_OP_SUCCESS;
+    }
+
+    Aws::Crt::String Written;
+    Aws::Crt::Vector<const uint8_t *> MessageBuffers;
+};
+
+class SegmentWriterHandler : public PassiveChannelHandler
+{
+  public:
+    SegmentWriterHandler(Aws::Crt::Allocator *allocator) : PassiveChannelHandler(allocator) {}
+
+    using Aws::Crt::Io::ChannelHandler::SegmentCopyThreshold;
+    using Aws::Crt::Io::ChannelHandler::SendSegments;
+};
+
+struct SegmentChannelTestState
+{
+    std::shared_ptr<WriteCaptureHandler> capture;
+    std::shared_ptr<SegmentWriterHandler> writer;
+    std::promise<int> setup;
+    std::promise<void> shutdown;
+};
+
+static void s_OnSegmentChannelSetup(struct aws_channel *channel, int errorCode, void *userData)
+{
+    auto *state = static_cast<SegmentChannelTestState *>(userData);
+    if (errorCode == AWS_ERROR_SUCCESS)
+    {
+        struct aws_channel_slot *captureSlot = aws_channel_slot_new(channel);
+        struct aws_channel_slot *writerSlot = aws_channel_slot_new(channel);
+        if (captureSlot == nullptr || writerSlot == nullptr || aws_channel_slot_insert_end(channel, captureSlot) ||
+            aws_channel_slot_insert_end(channel, writerSlot) ||
+            aws_channel_slot_set_handler(captureSlot, state->capture->SeatForCInterop(state->capture)) ||
+            aws_channel_slot_set_handler(writerSlot, state->writer->SeatForCInterop(state->writer)))
+        {
+            errorCode = aws_last_error();
+        }
+    }
+    state->setup.set_value(errorCode);
+}
+
+static void s_OnSegmentChannelShutdown(struct aws_channel *, int, void *userData)
+{
+    static_cast<SegmentChannelTestState *>(userData)->shutdown.set_value();
+}
+
+static int s_TestChannelHandlerSendSegments(struct aws_allocator *allocator, void *)
+{
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+        Aws::Crt::Io::EventLoopGroup eventLoopGroup(1, allocator);
+        ASSERT_TRUE(eventLoopGroup);
+
+        SegmentChannelTestState state;
+        state.capture = Aws::Crt::MakeShared<WriteCaptureHandler>(allocator, allocator);
+        state.writer = Aws::Crt::MakeShared<SegmentWriterHandler>(allocator, allocator);
+
+        struct aws_channel_options channelOptions;
+        AWS_ZERO_STRUCT(channelOptions);
+        channelOptions.event_loop = eventLoopGroup.GetNextLoop();
+        channelOptions.on_setup_completed = s_OnSegmentChannelSetup;
+        channelOptions.on_shutdown_completed = s_OnSegmentChannelShutdown;
+        channelOptions.setup_user_data = &state;
+        channelOptions.shutdown_user_data = &state;
+
+        struct aws_channel *channel = aws_channel_new(allocator, &channelOptions);
+        ASSERT_NOT_NULL(channel);
+        ASSERT_SUCCESS(state.setup.get_future().get());
+
+        Aws::Crt::String header("PUT /object HTTP/1.1\r\n\r\n");
+        Aws::Crt::String payload(3 * SegmentWriterHandler::SegmentCopyThreshold, 'p');
+        Aws::Crt::String trailer("0\r\n\r\n");
+        Aws::Crt::Vector<int> released;
+        std::promise<bool> sent;
+
+        auto writer = state.writer;
+        writer->ScheduleTask([&](Aws::Crt::Io::TaskStatus) {
+            Aws::Crt::Vector<Aws::Crt::Io::WriteSegment> segments;
+            for (const Aws::Crt::String *part : {&header, &payload, &trailer})
+            {
+                Aws::Crt::Io::WriteSegment segment;
+                segment.Data = Aws::Crt::ByteCursorFromArray(
+                    reinterpret_cast<const uint8_t *>(part->data()), part->size());
+                segment.OnRelease = [&released](int errorCode) { released.push_back(errorCode); };
+                segments.push_back(std::move(segment));
+            }
+            sent.set_value(writer->SendSegments(std::move(segments)));
+        });
+        ASSERT_TRUE(sent.get_future().get());
+
+        /* the header and the trailer are copied into pool messages, the payload goes through in place */
+        ASSERT_TRUE(header + payload + trailer == state.capture->Written);
+        ASSERT_UINT_EQUALS(3, state.capture->MessageBuffers.size());
+        ASSERT_PTR_EQUALS(payload.data(), state.capture->MessageBuffers[1]);
+        ASSERT_FALSE(header.data() == reinterpret_cast<const char *>(state.capture->MessageBuffers[0]));
+        ASSERT_UINT_EQUALS(3, released.size());
+        for (int errorCode : released)
+        {
+            ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, errorCode);
+        }
+
+        writer.reset();
+        aws_channel_shutdown(channel, AWS_ERROR_SUCCESS);
+        state.shutdown.get_future().get();
+        aws_channel_destroy(channel);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(ChannelHandlerSendSegments, s_TestChannelHandlerSendSegments)
+
+static int s_TestChannelHandlerStatistics(struct aws_allocator *allocator, void *)
+{
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+        Aws::Crt::Io::EventLoopGroup eventLoopGroup(1, allocator);
+        ASSERT_TRUE(eventLoopGroup);
+
+        SegmentChannelTestState state;
+        state.capture = Aws::Crt::MakeShared<WriteCaptureHandler>(allocator, allocator);
+        state.writer = Aws::Crt::MakeShared<SegmentWriterHandler>(allocator, allocator);
+
+        struct aws_channel_options channelOptions;
+        AWS_ZERO_STRUCT(channelOptions);
+        channelOptions.event_loop = eventLoopGroup.GetNextLoop();
+        channelOptions.on_setup_completed = s_OnSegmentChannelSetup;
+        channelOptions.on_shutdown_completed = s_OnSegmentChannelShutdown;
+        channelOptions.setup_user_data = &state;
+        channelOptions.shutdown_user_data = &state;
+
+        struct aws_channel *channel = aws_channel_new(allocator, &channelOptions);
+        ASSERT_NOT_NULL(channel);
+        ASSERT_SUCCESS(state.setup.get_future().get());
+
+        Aws::Crt::String header("PUT /object HTTP/1.1\r\n\r\n");
+        Aws::Crt::String payload(2 * SegmentWriterHandler::SegmentCopyThreshold, 'p');
+        size_t totalBytes = header.size() + payload.size();
+
+        /* the bytes are all written within one sampling interval, so one sample reports them all */
+        bool reported = false;
+        std::promise<Aws::Crt::Io::ChannelStatistics> report;
+        ASSERT_TRUE(Aws::Crt::Io::SetChannelStatisticsCallback(
+            channel,
+            std::chrono::milliseconds(10),
+            [&](const Aws::Crt::Io::ChannelStatistics &statistics) {
+                if (!reported && statistics.Handlers.size() == 2 &&
+                    statistics.Handlers[0].BytesWritten == totalBytes)
+                {
+                    reported = true;
+                    report.set_value(statistics);
+                }
+            },
+            allocator));
+
+        std::promise<bool> sent;
+        auto writer = state.writer;
+        writer->ScheduleTask([&](Aws::Crt::Io::TaskStatus) {
+            Aws::Crt::Vector<Aws::Crt::Io::WriteSegment> segments;
+            for (const Aws::Crt::String *part : {&header, &payload})
+            {
+                Aws::Crt::Io::WriteSegment segment;
+                segment.Data = Aws::Crt::ByteCursorFromArray(
+                    reinterpret_cast<const uint8_t *>(part->data()), part->size());
+                segments.push_back(std::move(segment));
+            }
+            sent.set_value(writer->SendSegments(std::move(segments)));
+        });
+        ASSERT_TRUE(sent.get_future().get());
+
+        Aws::Crt::Io::ChannelStatistics statistics = report.get_future().get();
+        ASSERT_TRUE(statistics.IntervalEndMs >= statistics.IntervalBeginMs);
+        ASSERT_FALSE(statistics.Socket.has_value());
+        ASSERT_FALSE(statistics.Tls.has_value());
+
+        /* the capture handler sits left of the writer, so it is reported first and saw both messages */
+        const Aws::Crt::Io::ChannelHandlerStatistics &capture = statistics.Handlers[0];
+        ASSERT_TRUE(capture.HandlerName == "cpp-crt-channel-handler");
+        ASSERT_UINT_EQUALS(2, capture.MessagesWritten);
+        ASSERT_UINT_EQUALS(0, capture.MessagesRead);
+        ASSERT_UINT_EQUALS(0, statistics.Handlers[1].MessagesWritten);
+
+        writer.reset();
+        aws_channel_shutdown(channel, AWS_ERROR_SUCCESS);
+        state.shutdown.get_future().get();
+        aws_channel_destroy(channel);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(ChannelHandlerStatistics, s_TestChannelHandlerStatistics)
+
+static int s_TestReadWindowTunerAdapts(struct aws_allocator *, void *)
+{
+    const uint64_t roundTripNs = 10 * 1000 * 1000;
+
+    Aws::Crt::Io::ReadWindowTunerOptions options;
+    options.InitialWindowSize = 64 * 1024;
+    options.MinWindowSize = 16 * 1024;
+    options.MaxWindowSize = 1024 * 1024;
+    options.DefaultRoundTripTimeNs = roundTripNs;
+    Aws::Crt::Io::ReadWindowTuner tuner(options);
+    ASSERT_UINT_EQUALS(64 * 1024, tuner.GetWindowSize());
+
+    /*
+     * the window aims at twice what was consumed in a round trip: 128K in the first takes it from 64K to 256K, and a
+     * consumer keeping up with a full window each round trip after that doubles it, up to the budget
+     */
+    uint64_t now = 1000;
+    ASSERT_UINT_EQUALS(64 * 1024, tuner.OnBytesConsumed(64 * 1024, now));
+    now += roundTripNs;
+    ASSERT_UINT_EQUALS(256 * 1024, tuner.OnBytesConsumed(64 * 1024, now));
+    ASSERT_UINT_EQUALS(256 * 1024, tuner.GetWindowSize());
+    now += roundTripNs;
+    ASSERT_UINT_EQUALS(512 * 1024, tuner.OnBytesConsumed(256 * 1024, now));
+    now += roundTripNs;
+    ASSERT_UINT_EQUALS(1024 * 1024, tuner.OnBytesConsumed(512 * 1024, now));
+    now += roundTripNs;
+    ASSERT_UINT_EQUALS(1024 * 1024, tuner.OnBytesConsumed(1024 * 1024, now));
+    ASSERT_UINT_EQUALS(1024 * 1024, tuner.GetWindowSize());
+
+    /* a consumer that falls behind has window updates held back until the window has shrunk */
+    now += 10 * roundTripNs;
+    ASSERT_UINT_EQUALS(0, tuner.OnBytesConsumed(16 * 1024, now));
+    size_t shrunk = 1024 * 1024 - (1024 * 1024 - 16 * 1024) / 4;
+    ASSERT_UINT_EQUALS(shrunk, tuner.GetWindowSize());
+    size_t handedBack = 0;
+    for (int i = 0; i < 32; ++i)
+    {
+        handedBack += tuner.OnBytesConsumed(16 * 1024, now);
+    }
+    ASSERT_UINT_EQUALS(32 * 16 * 1024 - (1024 * 1024 - shrunk - 16 * 1024), handedBack);
+
+    /* the round trip is how long a window's worth took to arrive */
+    Aws::Crt::Io::ReadWindowTuner measured(options);
+    measured.OnBytesReceived(32 * 1024, 1000);
+    ASSERT_UINT_EQUALS(roundTripNs, measured.GetRoundTripTimeNs());
+    measured.OnBytesReceived(32 * 1024, 1000 + roundTripNs / 2);
+    ASSERT_UINT_EQUALS(roundTripNs / 2, measured.GetRoundTripTimeNs());
+    measured.SetRoundTripTimeNs(roundTripNs / 4);
+    ASSERT_UINT_EQUALS(roundTripNs / 4, measured.GetRoundTripTimeNs());
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(ReadWindowTunerAdapts, s_TestReadWindowTunerAdapts)
+
+/* Left end of a read path: feeds messages to the handler on its right and totals the window handed back to it. */
+class ReadFeedHandler : public PassiveChannelHandler
+{
+  public:
+    ReadFeedHandler(Aws::Crt::Allocator *allocator) : PassiveChannelHandler(allocator), WindowIncrements(0) {}
+
+    int IncrementReadWindow(size_t size) override
+    {
+        WindowIncrements += size;
+        return AWS_OP_SUCCESS;
+    }
+
+    bool Feed(size_t length)
+    {
+        struct aws_io_message *message = AcquireMessageFromPool(Aws::Crt::Io::MessageType::ApplicationData, length);
+        if (message == nullptr)
+        {
+            return false;
+        }
+
+        memset(message->message_data.buffer, 'r', length);
+        message->message_data.len = length;
+        if (!SendMessage(message, Aws::Crt::Io::ChannelDirection::Read))
+        {
+            aws_mem_release(message->allocator, message);
+            return false;
+        }
+        return true;
+    }
+
+    size_t WindowIncrements;
+};
+
+/* Right end of a read path: takes whatever arrives and leaves reporting it consumed to the test. */
+class TunedReadHandler : public PassiveChannelHandler
+{
+  public:
+    TunedReadHandler(Aws::Crt::Allocator *allocator) : PassiveChannelHandler(allocator), BytesRead(0) {}
+
+    int ProcessReadMessage(struct aws_io_message *message) override
+    {
+        BytesRead += message->message_data.len;
+        aws_mem_release(message->allocator, message);
+        return AWS_OP_SUCCESS;
+    }
+
+    size_t InitialWindowSize() override
+    {
+        return GetReadWindowTuner() ? GetReadWindowTuner()->GetWindowSize() : 4 * 1024;
+    }
+
+    using Aws::Crt::Io::ChannelHandler::OnReadDataConsumed;
+    using Aws::Crt::Io::ChannelHandler::SetReadWindowTuner;
+
+    size_t BytesRead;
+};
+
+struct ReadWindowChannelTestState
+{
+    std::shared_ptr<ReadFeedHandler> feed;
+    std::shared_ptr<TunedReadHandler> reader;
+    std::promise<int> setup;
+    std::promise<void> shutdown;
+};
+
+static void s_OnReadWindowChannelSetup(struct aws_channel *channel, int errorCode, void *userData)
+{
+    auto *state = static_cast<ReadWindowChannelTestState *>(userData);
+    if (errorCode == AWS_ERROR_SUCCESS)
+    {
+        struct aws_channel_slot *feedSlot = aws_channel_slot_new(channel);
+        struct aws_channel_slot *readerSlot = aws_channel_slot_new(channel);
+        if (feedSlot == nullptr || readerSlot == nullptr || aws_channel_slot_insert_end(channel, feedSlot) ||
+            aws_channel_slot_insert_end(channel, readerSlot) ||
+            aws_channel_slot_set_handler(feedSlot, state->feed->SeatForCInterop(state->feed)) ||
+            aws_channel_slot_set_handler(readerSlot, state->reader->SeatForCInterop(state->reader)))
+        {
+            errorCode = aws_last_error();
+        }
+    }
+    state->setup.set_value(errorCode);
+}
+
+static void s_OnReadWindowChannelShutdown(struct aws_channel *, int, void *userData)
+{
+    static_cast<ReadWindowChannelTestState *>(userData)->shutdown.set_value();
+}
+
+/*
+ * A handler with a tuner hands back what the tuner makes of the data it consumed, and one without hands back all of
+ * it. The tuner's round trip is a nanosecond, so the second report retunes, finds the consumer slow, and shrinks the
+ * window by holding back part of the update.
+ */
+static int s_TestChannelHandlerReadWindowTuner(struct aws_allocator *allocator, void *)
+{
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+        Aws::Crt::Io::EventLoopGroup eventLoopGroup(1, allocator);
+        ASSERT_TRUE(eventLoopGroup);
+
+        Aws::Crt::Io::ReadWindowTunerOptions options;
+        options.InitialWindowSize = 4 * 1024;
+        options.MinWindowSize = 1024;
+        options.MaxWindowSize = 4 * 1024;
+        options.DefaultRoundTripTimeNs = 1;
+        auto tuner = Aws::Crt::MakeShared<Aws::Crt::Io::ReadWindowTuner>(allocator, options);
+
+        ReadWindowChannelTestState state;
+        state.feed = Aws::Crt::MakeShared<ReadFeedHandler>(allocator, allocator);
+        state.reader = Aws::Crt::MakeShared<TunedReadHandler>(allocator, allocator);
+        state.reader->SetReadWindowTuner(tuner);
+        ASSERT_TRUE(state.reader->GetReadWindowTuner() == tuner);
+
+        struct aws_channel_options channelOptions;
+        AWS_ZERO_STRUCT(channelOptions);
+        channelOptions.event_loop = eventLoopGroup.GetNextLoop();
+        channelOptions.on_setup_completed = s_OnReadWindowChannelSetup;
+        channelOptions.on_shutdown_completed = s_OnReadWindowChannelShutdown;
+        channelOptions.setup_user_data = &state;
+        channelOptions.shutdown_user_data = &state;
+        channelOptions.enable_read_back_pressure = true;
+
+        struct aws_channel *channel = aws_channel_new(allocator, &channelOptions);
+        ASSERT_NOT_NULL(channel);
+        ASSERT_SUCCESS(state.setup.get_future().get());
+
+        /* window updates go upstream from a channel task, so what was handed back is read from a task after it */
+        std::promise<bool> consumed;
+        std::promise<size_t> handedBack;
+        auto reader = state.reader;
+        reader->ScheduleTask([&](Aws::Crt::Io::TaskStatus) {
+            bool succeeded = state.feed->Feed(2 * 1024) && reader->OnReadDataConsumed(1024);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            consumed.set_value(succeeded && reader->OnReadDataConsumed(1024));
+            reader->ScheduleTask(
+                [&](Aws::Crt::Io::TaskStatus) { handedBack.set_value(state.feed->WindowIncrements); });
+        });
+        ASSERT_TRUE(consumed.get_future().get());
+        ASSERT_UINT_EQUALS(2 * 1024, reader->BytesRead);
+
+        /* the second report shrank the window a quarter of the way to the minimum, off its own update */
+        size_t shrink = (4 * 1024 - 1024) / 4;
+        ASSERT_UINT_EQUALS(4 * 1024 - shrink, tuner->GetWindowSize());
+        ASSERT_UINT_EQUALS(2 * 1024 - shrink, handedBack.get_future().get());
+
+        std::promise<size_t> untuned;
+        reader->ScheduleTask([&](Aws::Crt::Io::TaskStatus) {
+            reader->SetReadWindowTuner(nullptr);
+            reader->OnReadDataConsumed(512);
+            reader->ScheduleTask([&](Aws::Crt::Io::TaskStatus) { untuned.set_value(state.feed->WindowIncrements); });
+        });
+        ASSERT_UINT_EQUALS(2 * 1024 - shrink + 512, untuned.get_future().get());
+
+        reader.reset();
+        aws_channel_shutdown(channel, AWS_ERROR_SUCCESS);
+        state.shutdown.get_future().get();
+        aws_channel_destroy(channel);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(ChannelHandlerReadWindowTuner, s_TestChannelHandlerReadWindowTuner)
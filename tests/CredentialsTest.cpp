@@ -9,8 +9,11 @@
 #include <aws/crt/auth/Credentials.h>
 #include <aws/testing/aws_test_harness.h>
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
+#include <thread>
 
 using namespace Aws::Crt;
 using namespace Aws::Crt::Auth;
@@ -283,3 +286,165 @@ static int s_TestProviderDelegateGet(struct aws_allocator *allocator, void *ctx)
 }
 
 AWS_TEST_CASE(TestProviderDelegateGet, s_TestProviderDelegateGet)
+
+static int s_TestProviderCoalescedGet(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        ApiHandle apiHandle(allocator);
+
+        /* the handler holds the first fetch open until every other query has been made */
+        std::mutex lock;
+        std::condition_variable signal;
+        bool fetchStarted = false;
+        bool releaseFetch = false;
+        int fetchCount = 0;
+        auto delegateGetCredentials = [&]() -> std::shared_ptr<Credentials> {
+            std::unique_lock<std::mutex> guard(lock);
+            ++fetchCount;
+            fetchStarted = true;
+            signal.notify_all();
+            signal.wait(guard, [&]() { return releaseFetch; });
+            return Aws::Crt::MakeShared<Credentials>(
+                allocator,
+                aws_byte_cursor_from_c_str(s_access_key_id),
+                aws_byte_cursor_from_c_str(s_secret_access_key),
+                aws_byte_cursor_from_c_str(s_session_token),
+                UINT32_MAX,
+                allocator);
+        };
+        CredentialsProviderDelegateConfig config;
+        config.Handler = delegateGetCredentials;
+        auto provider = CredentialsProvider::CreateCredentialsProviderDelegate(config, allocator);
+
+        const int queryCount = 5;
+        int resolvedCount = 0;
+        Vector<std::shared_ptr<Credentials>> resolved;
+        auto onResolved = [&](std::shared_ptr<Credentials> credentials, int errorCode) {
+            std::lock_guard<std::mutex> guard(lock);
+            if (errorCode == AWS_ERROR_SUCCESS)
+            {
+                resolved.push_back(credentials);
+            }
+            ++resolvedCount;
+            signal.notify_all();
+        };
+
+        std::thread first([&]() { provider->GetCredentials(onResolved); });
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            signal.wait(guard, [&]() { return fetchStarted; });
+        }
+        bool queriesStarted = true;
+        for (int i = 1; i < queryCount; ++i)
+        {
+            queriesStarted = provider->GetCredentials(onResolved) && queriesStarted;
+        }
+        int resolvedBeforeRelease = 0;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            resolvedBeforeRelease = resolvedCount;
+            releaseFetch = true;
+            signal.notify_all();
+        }
+        first.join();
+
+        ASSERT_TRUE(queriesStarted);
+        ASSERT_INT_EQUALS(0, resolvedBeforeRelease);
+        ASSERT_INT_EQUALS(1, fetchCount);
+        ASSERT_INT_EQUALS(queryCount, resolvedCount);
+        ASSERT_INT_EQUALS(queryCount, (int)resolved.size());
+        for (const auto &credentials : resolved)
+        {
+            ASSERT_TRUE(credentials.get() == resolved[0].get());
+            auto cursor = credentials->GetAccessKeyId();
+            ASSERT_TRUE(aws_byte_cursor_eq_c_str(&cursor, s_access_key_id));
+        }
+
+        /* with nothing in flight, the next query fetches again */
+        GetCredentialsWaiter waiter(provider);
+        ASSERT_NOT_NULL(waiter.GetCredentials().get());
+        ASSERT_INT_EQUALS(2, fetchCount);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(TestProviderCoalescedGet, s_TestProviderCoalescedGet)
+
+static int s_TestProviderRefreshAheadGet(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        ApiHandle apiHandle(allocator);
+
+        /* every fetch hands out credentials expiring lifetimeSeconds from now, with the fetch count as the token */
+        std::atomic<int> fetchCount(0);
+        int64_t lifetimeSeconds = 3600;
+        auto delegateGetCredentials = [&]() -> std::shared_ptr<Credentials> {
+            char token[16];
+            snprintf(token, sizeof(token), "%d", ++fetchCount);
+            auto now = std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::system_clock::now().time_since_epoch());
+            return Aws::Crt::MakeShared<Credentials>(
+                allocator,
+                aws_byte_cursor_from_c_str(s_access_key_id),
+                aws_byte_cursor_from_c_str(s_secret_access_key),
+                aws_byte_cursor_from_c_str(token),
+                static_cast<uint64_t>(now.count() + lifetimeSeconds),
+                allocator);
+        };
+        CredentialsProviderDelegateConfig delegateConfig;
+        delegateConfig.Handler = delegateGetCredentials;
+        auto source = CredentialsProvider::CreateCredentialsProviderDelegate(delegateConfig, allocator);
+
+        /* renewed only at the very end of their lifetime, the first credentials are all there is */
+        CredentialsProviderRefreshAheadConfig config;
+        config.Provider = source;
+        config.RefreshFraction = 1.0;
+        auto provider = CredentialsProvider::CreateCredentialsProviderRefreshAhead(config, allocator);
+        ASSERT_NOT_NULL(provider.get());
+        ASSERT_INT_EQUALS(1, fetchCount.load());
+
+        GetCredentialsWaiter waiter(provider);
+        for (int i = 0; i < 3; ++i)
+        {
+            auto creds = waiter.GetCredentials();
+            ASSERT_NOT_NULL(creds.get());
+            auto cursor = creds->GetSessionToken();
+            ASSERT_TRUE(aws_byte_cursor_eq_c_str(&cursor, "1"));
+        }
+        ASSERT_INT_EQUALS(1, fetchCount.load());
+
+        /* due for renewal right away, each query gets the current credentials and starts fetching the next */
+        fetchCount = 0;
+        config.RefreshFraction = 0.0;
+        auto eagerProvider = CredentialsProvider::CreateCredentialsProviderRefreshAhead(config, allocator);
+        GetCredentialsWaiter eagerWaiter(eagerProvider);
+        auto creds = eagerWaiter.GetCredentials();
+        auto cursor = creds->GetSessionToken();
+        ASSERT_TRUE(aws_byte_cursor_eq_c_str(&cursor, "1"));
+        creds = eagerWaiter.GetCredentials();
+        cursor = creds->GetSessionToken();
+        ASSERT_TRUE(aws_byte_cursor_eq_c_str(&cursor, "2"));
+        ASSERT_INT_EQUALS(3, fetchCount.load());
+
+        /* expired credentials are never handed out, so the query waits for new ones */
+        fetchCount = 0;
+        lifetimeSeconds = -10;
+        config.RefreshFraction = 0.75;
+        auto expiredProvider = CredentialsProvider::CreateCredentialsProviderRefreshAhead(config, allocator);
+        GetCredentialsWaiter expiredWaiter(expiredProvider);
+        creds = expiredWaiter.GetCredentials();
+        cursor = creds->GetSessionToken();
+        ASSERT_TRUE(aws_byte_cursor_eq_c_str(&cursor, "2"));
+        ASSERT_INT_EQUALS(2, fetchCount.load());
+
+        CredentialsProviderRefreshAheadConfig noSourceConfig;
+        ASSERT_NULL(CredentialsProvider::CreateCredentialsProviderRefreshAhead(noSourceConfig, allocator).get());
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(TestProviderRefreshAheadGet, s_TestProviderRefreshAheadGet)
@@ -44,4 +44,49 @@ static int s_TestDateTimeBinding(struct aws_allocator *allocator, void *ctx)
     return AWS_OP_SUCCESS;
 }
 
-AWS_TEST_CASE(DateTimeBinding, s_TestDateTimeBinding)
\ No newline at end of file
+AWS_TEST_CASE(DateTimeBinding, s_TestDateTimeBinding)
+
+static int s_TestDateTimeFixedBufferGmtString(struct aws_allocator *allocator, void *ctx)
+{
+    (void)allocator;
+    (void)ctx;
+
+    char buffer[Aws::Crt::DateTime::MaxGmtStringLength];
+    size_t length = 0;
+
+    Aws::Crt::DateTime dateTime("Wed, 02 Oct 2002 08:05:09 GMT", Aws::Crt::DateFormat::RFC822);
+    ASSERT_TRUE(dateTime);
+    ASSERT_TRUE(dateTime.ToGmtString(Aws::Crt::DateFormat::RFC822, buffer, sizeof(buffer), length));
+    ASSERT_BIN_ARRAYS_EQUALS("Wed, 02 Oct 2002 08:05:09 GMT", 29, buffer, length);
+    ASSERT_TRUE(dateTime.ToGmtString(Aws::Crt::DateFormat::ISO_8601, buffer, sizeof(buffer), length));
+    ASSERT_BIN_ARRAYS_EQUALS("2002-10-02T08:05:09Z", 20, buffer, length);
+
+    /* the same minute again comes from the thread's cache, the next one is rendered afresh */
+    Aws::Crt::DateTime laterInMinute = dateTime + std::chrono::milliseconds(50000);
+    ASSERT_TRUE(laterInMinute.ToGmtString(Aws::Crt::DateFormat::RFC822, buffer, sizeof(buffer), length));
+    ASSERT_BIN_ARRAYS_EQUALS("Wed, 02 Oct 2002 08:05:59 GMT", 29, buffer, length);
+    Aws::Crt::DateTime nextDay = dateTime + std::chrono::milliseconds(16 * 3600 * 1000);
+    ASSERT_TRUE(nextDay.ToGmtString(Aws::Crt::DateFormat::ISO_8601, buffer, sizeof(buffer), length));
+    ASSERT_BIN_ARRAYS_EQUALS("2002-10-03T00:05:09Z", 20, buffer, length);
+
+    ASSERT_FALSE(dateTime.ToGmtString(Aws::Crt::DateFormat::RFC822, buffer, 20, length));
+    ASSERT_INT_EQUALS(AWS_ERROR_SHORT_BUFFER, aws_last_error());
+    ASSERT_FALSE(dateTime.ToGmtString(Aws::Crt::DateFormat::AutoDetect, buffer, sizeof(buffer), length));
+
+    /* the buffer overload appends */
+    uint8_t dateOutput[AWS_DATE_TIME_STR_MAX_LEN];
+    Aws::Crt::ByteBuf strOutput = Aws::Crt::ByteBufFromEmptyArray(dateOutput, sizeof(dateOutput));
+    ASSERT_TRUE(aws_byte_buf_write_from_whole_cursor(&strOutput, Aws::Crt::ByteCursorFromCString("Date: ")));
+    ASSERT_TRUE(dateTime.ToGmtString(Aws::Crt::DateFormat::RFC822, strOutput));
+    ASSERT_BIN_ARRAYS_EQUALS("Date: Wed, 02 Oct 2002 08:05:09 GMT", 35, strOutput.buffer, strOutput.len);
+
+    ASSERT_TRUE(Aws::Crt::DateTime::NowToGmtString(Aws::Crt::DateFormat::RFC822, buffer, sizeof(buffer), length));
+    Aws::Crt::String now(buffer, length);
+    Aws::Crt::DateTime parsedNow(now.c_str(), Aws::Crt::DateFormat::RFC822);
+    ASSERT_TRUE(parsedNow);
+    ASSERT_TRUE(Aws::Crt::DateTime::Now() - parsedNow < std::chrono::milliseconds(60000));
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(DateTimeFixedBufferGmtString, s_TestDateTimeFixedBufferGmtString)
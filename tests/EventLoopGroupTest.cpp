@@ -3,8 +3,13 @@
  * SPDX-License-Identifier: Apache-2.0.
  */
 #include <aws/crt/Api.h>
+#include <aws/crt/io/EventLoopMonitor.h>
 #include <aws/testing/aws_test_harness.h>
 
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
 #include <utility>
 
 static int s_TestEventLoopResourceSafety(struct aws_allocator *allocator, void *ctx)
@@ -30,3 +35,190 @@ static int s_TestEventLoopResourceSafety(struct aws_allocator *allocator, void *
 }
 
 AWS_TEST_CASE(EventLoopResourceSafety, s_TestEventLoopResourceSafety)
+
+static int s_TestEventLoopGroupPinnedToCpuGroup(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+
+    {
+        Aws::Crt::ApiHandle handle;
+
+        uint16_t cpuGroupCount = Aws::Crt::Io::EventLoopGroup::GetCpuGroupCount();
+        ASSERT_TRUE(cpuGroupCount > 0);
+
+        for (uint16_t cpuGroup = 0; cpuGroup < cpuGroupCount; ++cpuGroup)
+        {
+            Aws::Crt::Io::EventLoopGroup eventLoopGroup =
+                Aws::Crt::Io::EventLoopGroup::PinnedToCpuGroup(cpuGroup, 0, allocator);
+            ASSERT_TRUE(eventLoopGroup);
+            ASSERT_TRUE(eventLoopGroup.GetLoopCount() > 0);
+            ASSERT_TRUE(
+                eventLoopGroup.GetLoopCount() <= Aws::Crt::Io::EventLoopGroup::GetCpuCountForGroup(cpuGroup));
+        }
+
+        Aws::Crt::Io::EventLoopGroup eventLoopGroup = Aws::Crt::Io::EventLoopGroup::PinnedToCpuGroup(0, 2, allocator);
+        ASSERT_TRUE(eventLoopGroup);
+        ASSERT_UINT_EQUALS(2, eventLoopGroup.GetLoopCount());
+        ASSERT_NOT_NULL(eventLoopGroup.GetLoopAt(0));
+        ASSERT_NOT_NULL(eventLoopGroup.GetLoopAt(1));
+        ASSERT_FALSE(eventLoopGroup.GetLoopAt(0) == eventLoopGroup.GetLoopAt(1));
+        ASSERT_NULL(eventLoopGroup.GetLoopAt(2));
+
+        aws_event_loop *nextLoop = eventLoopGroup.GetNextLoop();
+        ASSERT_TRUE(nextLoop == eventLoopGroup.GetLoopAt(0) || nextLoop == eventLoopGroup.GetLoopAt(1));
+
+        Aws::Crt::Io::EventLoopGroup movedFrom = Aws::Crt::Io::EventLoopGroup::PinnedToCpuGroup(0, 1, allocator);
+        Aws::Crt::Io::EventLoopGroup movedTo(std::move(movedFrom));
+        // NOLINTNEXTLINE
+        ASSERT_UINT_EQUALS(0, movedFrom.GetLoopCount());
+        // NOLINTNEXTLINE
+        ASSERT_NULL(movedFrom.GetNextLoop());
+    }
+
+    return AWS_ERROR_SUCCESS;
+}
+
+AWS_TEST_CASE(EventLoopGroupPinnedToCpuGroup, s_TestEventLoopGroupPinnedToCpuGroup)
+
+static void s_BlockEventLoop(aws_task *, void *, aws_task_status status)
+{
+    if (status == AWS_TASK_STATUS_RUN_READY)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+}
+
+static int s_TestEventLoopMonitorLatency(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+
+    {
+        Aws::Crt::ApiHandle handle;
+
+        Aws::Crt::Io::EventLoopGroup eventLoopGroup(1, allocator);
+        ASSERT_TRUE(eventLoopGroup);
+
+        Aws::Crt::Io::EventLoopMonitor monitor(eventLoopGroup, std::chrono::milliseconds(10), allocator);
+        ASSERT_TRUE(monitor);
+
+        auto probed = [&monitor](uint64_t probes) {
+            for (int i = 0; i < 500 && monitor.GetStatistics(0).Probes < probes; ++i)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            return monitor.GetStatistics(0).Probes >= probes;
+        };
+
+        ASSERT_TRUE(probed(2));
+        auto statistics = monitor.GetStatistics();
+        ASSERT_UINT_EQUALS(1, statistics.size());
+        uint64_t histogramTotal = 0;
+        for (size_t i = 0; i < Aws::Crt::Io::EventLoopStatistics::LatencyBucketCount; ++i)
+        {
+            histogramTotal += statistics[0].LatencyHistogram[i];
+        }
+        ASSERT_UINT_EQUALS(statistics[0].Probes, histogramTotal);
+        ASSERT_TRUE(statistics[0].MaxLatency <= statistics[0].TotalLatency);
+
+        /* a task hogging the loop delays the next probe by about as long as it runs */
+        auto resetAt = std::chrono::steady_clock::now();
+        monitor.Reset();
+        uint64_t probesSinceReset = monitor.GetStatistics(0).Probes;
+        auto sinceReset = std::chrono::steady_clock::now() - resetAt;
+        /* the monitor keeps probing through Reset(), so only as many probes as fit in the meantime can be counted */
+        ASSERT_TRUE(probesSinceReset <= 1 + static_cast<uint64_t>(sinceReset / std::chrono::milliseconds(10)));
+        aws_task blockingTask;
+        aws_task_init(&blockingTask, s_BlockEventLoop, nullptr, "event-loop-monitor-test-block");
+        aws_event_loop_schedule_task_now(eventLoopGroup.GetLoopAt(0), &blockingTask);
+        ASSERT_TRUE(probed(2));
+        ASSERT_TRUE(monitor.GetStatistics(0).MaxLatency >= std::chrono::milliseconds(50));
+
+        ASSERT_UINT_EQUALS(0, monitor.GetStatistics(1).Probes);
+    }
+
+    return AWS_ERROR_SUCCESS;
+}
+
+AWS_TEST_CASE(EventLoopMonitorLatency, s_TestEventLoopMonitorLatency)
+
+static int s_TestEventLoopGroupScheduleBatches(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+
+    {
+        Aws::Crt::ApiHandle handle;
+
+        Aws::Crt::Io::EventLoopGroup eventLoopGroup(2, allocator);
+        ASSERT_TRUE(eventLoopGroup);
+        ASSERT_FALSE(eventLoopGroup.Schedule([](Aws::Crt::Io::TaskStatus) {}, 2));
+
+        const int producerCount = 4;
+        const int tasksPerProducer = 1000;
+        aws_event_loop *eventLoop = eventLoopGroup.GetLoopAt(1);
+
+        /* only touched on the loop thread */
+        int lastSeen[producerCount] = {-1, -1, -1, -1};
+        std::atomic<int> ran(0);
+        std::atomic<int> outOfOrder(0);
+        std::atomic<int> offLoop(0);
+        std::promise<void> allRan;
+
+        Aws::Crt::Vector<std::thread> producers;
+        for (int producer = 0; producer < producerCount; ++producer)
+        {
+            producers.emplace_back([&, producer]() {
+                for (int i = 0; i < tasksPerProducer; ++i)
+                {
+                    eventLoopGroup.Schedule(
+                        [&, producer, i](Aws::Crt::Io::TaskStatus status) {
+                            if (status != Aws::Crt::Io::TaskStatus::RunReady ||
+                                !aws_event_loop_thread_is_callers_thread(eventLoop))
+                            {
+                                ++offLoop;
+                            }
+                            if (lastSeen[producer] + 1 != i)
+                            {
+                                ++outOfOrder;
+                            }
+                            lastSeen[producer] = i;
+                            if (++ran == producerCount * tasksPerProducer)
+                            {
+                                allRan.set_value();
+                            }
+                        },
+                        1);
+                }
+            });
+        }
+
+        for (auto &producer : producers)
+        {
+            producer.join();
+        }
+
+        ASSERT_TRUE(allRan.get_future().wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+        ASSERT_INT_EQUALS(0, outOfOrder.load());
+        ASSERT_INT_EQUALS(0, offLoop.load());
+
+        /* without a loop index the loops take tasks in turn */
+        std::promise<aws_event_loop *> ranOn[2];
+        for (int i = 0; i < 2; ++i)
+        {
+            auto *promise = &ranOn[i];
+            ASSERT_TRUE(eventLoopGroup.Schedule([promise, &eventLoopGroup](Aws::Crt::Io::TaskStatus) {
+                for (size_t loop = 0; loop < 2; ++loop)
+                {
+                    if (aws_event_loop_thread_is_callers_thread(eventLoopGroup.GetLoopAt(loop)))
+                    {
+                        promise->set_value(eventLoopGroup.GetLoopAt(loop));
+                    }
+                }
+            }));
+        }
+        ASSERT_FALSE(ranOn[0].get_future().get() == ranOn[1].get_future().get());
+    }
+
+    return AWS_ERROR_SUCCESS;
+}
+
+AWS_TEST_CASE(EventLoopGroupScheduleBatches, s_TestEventLoopGroupScheduleBatches)
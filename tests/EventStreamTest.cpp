@@ -0,0 +1,392 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/Api.h>
+#include <aws/crt/eventstream/EventStream.h>
+#include <aws/crt/eventstream/EventStreamDecoder.h>
+#include <aws/crt/eventstream/EventStreamRpcClient.h>
+
+#include <aws/testing/aws_test_harness.h>
+
+#include "LoopbackServer.h"
+
+static int s_TestEventStreamMessageRoundTrip(Aws::Crt::Allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::Eventstream::EventStreamHeaders headers(allocator);
+        ASSERT_TRUE(headers);
+        ASSERT_TRUE(headers.AddString(":event-type", "Records"));
+        ASSERT_TRUE(headers.AddInt32("sequence", -42));
+        ASSERT_TRUE(headers.AddBool("final", true));
+        uint8_t bytes[] = {0x00, 0xff, 0x7f};
+        ASSERT_TRUE(headers.AddBytes("blob", aws_byte_cursor_from_array(bytes, sizeof(bytes))));
+        ASSERT_FALSE(headers.AddInt16("", 1));
+        ASSERT_UINT_EQUALS(4, headers.GetCount());
+        ASSERT_INT_EQUALS(-42, headers.GetHeader(1).GetValueAsInt32());
+
+        const char payloadText[] = "hello event stream";
+        Aws::Crt::Eventstream::EventStreamMessage encoded(allocator);
+        ASSERT_TRUE(encoded.Encode(headers, aws_byte_cursor_from_c_str(payloadText)));
+
+        Aws::Crt::ByteCursor wire = encoded.GetEncoded();
+        Aws::Crt::Eventstream::EventStreamMessage decoded(allocator);
+        ASSERT_TRUE(decoded.Decode(wire));
+        ASSERT_UINT_EQUALS(encoded.GetMessageCrc(), decoded.GetMessageCrc());
+
+        /* the decoded message points straight into the encoded bytes */
+        Aws::Crt::ByteCursor payload = decoded.GetPayload();
+        ASSERT_TRUE(payload.ptr > wire.ptr && payload.ptr + payload.len < wire.ptr + wire.len);
+        ASSERT_BIN_ARRAYS_EQUALS(payloadText, sizeof(payloadText) - 1, payload.ptr, payload.len);
+
+        size_t headerCount = 0;
+        ASSERT_TRUE(decoded.ForEachHeader([&headerCount](const Aws::Crt::Eventstream::EventStreamHeaderView &) {
+            ++headerCount;
+            return true;
+        }));
+        ASSERT_UINT_EQUALS(4, headerCount);
+
+        Aws::Crt::Eventstream::EventStreamHeaderView header;
+        ASSERT_TRUE(decoded.FindHeader(":event-type", header));
+        ASSERT_TRUE(header.GetType() == Aws::Crt::Eventstream::EventStreamHeaderValueType::String);
+        ASSERT_TRUE(header.GetValueAsString() == Aws::Crt::StringView("Records"));
+        ASSERT_INT_EQUALS(0, header.GetValueAsInt32());
+        ASSERT_TRUE(decoded.FindHeader("sequence", header));
+        ASSERT_INT_EQUALS(-42, header.GetValueAsInt32());
+        ASSERT_TRUE(decoded.FindHeader("final", header));
+        ASSERT_TRUE(header.GetValueAsBool());
+        ASSERT_TRUE(decoded.FindHeader("blob", header));
+        Aws::Crt::ByteCursor blob = header.GetValueAsBytes();
+        ASSERT_BIN_ARRAYS_EQUALS(bytes, sizeof(bytes), blob.ptr, blob.len);
+        ASSERT_FALSE(decoded.FindHeader("missing", header));
+
+        /* a flipped payload byte fails the message CRC */
+        Aws::Crt::Vector<uint8_t> corrupted(wire.ptr, wire.ptr + wire.len);
+        corrupted[corrupted.size() - 5] ^= 0x01;
+        Aws::Crt::Eventstream::EventStreamMessage rejected(allocator);
+        ASSERT_FALSE(rejected.Decode(aws_byte_cursor_from_array(corrupted.data(), corrupted.size())));
+        ASSERT_INT_EQUALS(AWS_ERROR_EVENT_STREAM_MESSAGE_CHECKSUM_FAILURE, rejected.LastError());
+        ASSERT_FALSE(rejected);
+    }
+
+    return AWS_ERROR_SUCCESS;
+}
+
+AWS_TEST_CASE(EventStreamMessageRoundTrip, s_TestEventStreamMessageRoundTrip)
+
+static int s_TestEventStreamDecoderChunked(Aws::Crt::Allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        const char *payloads[] = {"first", "a somewhat longer second payload", ""};
+        Aws::Crt::Vector<uint8_t> wire;
+        size_t largestMessage = 0;
+        for (const char *payload : payloads)
+        {
+            Aws::Crt::Eventstream::EventStreamHeaders headers(allocator);
+            ASSERT_TRUE(headers.AddString(":message-type", "event"));
+            Aws::Crt::Eventstream::EventStreamMessage message(allocator);
+            ASSERT_TRUE(message.Encode(headers, aws_byte_cursor_from_c_str(payload)));
+            Aws::Crt::ByteCursor encoded = message.GetEncoded();
+            wire.insert(wire.end(), encoded.ptr, encoded.ptr + encoded.len);
+            largestMessage = encoded.len > largestMessage ? encoded.len : largestMessage;
+        }
+
+        /* chunk sizes that split preludes, messages, and several messages at once */
+        const size_t chunkSizes[] = {1, 5, 12, 13, 50, wire.size()};
+        for (size_t chunkSize : chunkSizes)
+        {
+            size_t decoded = 0;
+            Aws::Crt::Eventstream::EventStreamDecoder decoder(
+                [&](const Aws::Crt::Eventstream::EventStreamMessage &message) {
+                    Aws::Crt::ByteCursor payload = message.GetPayload();
+                    if (decoded < 3 && aws_byte_cursor_eq_c_str(&payload, payloads[decoded]))
+                    {
+                        ++decoded;
+                    }
+                },
+                Aws::Crt::Eventstream::EventStreamDecoder::DefaultMaxMessageLength,
+                allocator);
+
+            for (size_t offset = 0; offset < wire.size(); offset += chunkSize)
+            {
+                size_t length = wire.size() - offset < chunkSize ? wire.size() - offset : chunkSize;
+                ASSERT_TRUE(decoder.Decode(aws_byte_cursor_from_array(wire.data() + offset, length)));
+            }
+
+            ASSERT_UINT_EQUALS(3, decoded);
+            ASSERT_UINT_EQUALS(3, decoder.GetMessageCount());
+            ASSERT_FALSE(decoder.HasPartialMessage());
+            ASSERT_TRUE(decoder.GetBufferCapacity() <= largestMessage);
+        }
+
+        /* a broken prelude is caught before anything is buffered for its message */
+        Aws::Crt::Vector<uint8_t> corrupted(wire);
+        corrupted[1] ^= 0x01;
+        Aws::Crt::Eventstream::EventStreamDecoder decoder(nullptr, 1024, allocator);
+        ASSERT_FALSE(decoder.Decode(aws_byte_cursor_from_array(corrupted.data(), corrupted.size())));
+        ASSERT_INT_EQUALS(AWS_ERROR_EVENT_STREAM_PRELUDE_CHECKSUM_FAILURE, decoder.LastError());
+        ASSERT_FALSE(decoder.Decode(aws_byte_cursor_from_array(wire.data(), wire.size())));
+    }
+
+    return AWS_ERROR_SUCCESS;
+}
+
+AWS_TEST_CASE(EventStreamDecoderChunked, s_TestEventStreamDecoderChunked)
+
+/*
+ * Server end of an event-stream RPC connection: accepts the Connect message, then echoes each application message
+ * back on its stream, ending the stream once the payload is "close". The operation each stream was activated with
+ * is recorded.
+ */
+class LoopbackEventStreamRpcServer : public LoopbackConnectionHandler
+{
+  public:
+    explicit LoopbackEventStreamRpcServer(Aws::Crt::Allocator *allocator)
+        : LoopbackConnectionHandler(allocator),
+          m_decoder(
+              [this](const Aws::Crt::Eventstream::EventStreamMessage &message) { OnMessage(message); },
+              Aws::Crt::Eventstream::EventStreamDecoder::DefaultMaxMessageLength,
+              allocator)
+    {
+    }
+
+    Aws::Crt::Vector<Aws::Crt::String> GetOperations()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_operations;
+    }
+
+  protected:
+    void OnData(Aws::Crt::ByteCursor data) override { m_decoder.Decode(data); }
+
+  private:
+    static int32_t s_GetInt32(const Aws::Crt::Eventstream::EventStreamMessage &message, const char *name)
+    {
+        Aws::Crt::Eventstream::EventStreamHeaderView header;
+        return message.FindHeader(name, header) ? header.GetValueAsInt32() : -1;
+    }
+
+    void Reply(
+        Aws::Crt::Eventstream::EventStreamRpcMessageType type,
+        int32_t flags,
+        int32_t streamId,
+        Aws::Crt::ByteCursor payload)
+    {
+        Aws::Crt::Eventstream::EventStreamHeaders headers(m_allocator);
+        headers.AddInt32(":message-type", static_cast<int32_t>(type));
+        headers.AddInt32(":message-flags", flags);
+        headers.AddInt32(":stream-id", streamId);
+
+        Aws::Crt::Eventstream::EventStreamMessage reply(m_allocator);
+        if (reply.Encode(headers, payload))
+        {
+            Write(reply.GetEncoded());
+        }
+    }
+
+    void OnMessage(const Aws::Crt::Eventstream::EventStreamMessage &message)
+    {
+        auto type = static_cast<Aws::Crt::Eventstream::EventStreamRpcMessageType>(s_GetInt32(message, ":message-type"));
+        int32_t streamId = s_GetInt32(message, ":stream-id");
+        Aws::Crt::ByteCursor payload = message.GetPayload();
+
+        if (type == Aws::Crt::Eventstream::EventStreamRpcMessageType::Connect)
+        {
+            Reply(
+                Aws::Crt::Eventstream::EventStreamRpcMessageType::ConnectAck,
+                AWS_EVENT_STREAM_RPC_MESSAGE_FLAG_CONNECTION_ACCEPTED,
+                0,
+                aws_byte_cursor_from_array(nullptr, 0));
+            return;
+        }
+
+        if (type != Aws::Crt::Eventstream::EventStreamRpcMessageType::ApplicationMessage || streamId <= 0)
+        {
+            return;
+        }
+
+        Aws::Crt::Eventstream::EventStreamHeaderView operation;
+        if (message.FindHeader("operation", operation))
+        {
+            Aws::Crt::StringView name = operation.GetValueAsString();
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_operations.emplace_back(name.data(), name.size());
+        }
+
+        bool close = aws_byte_cursor_eq_c_str(&payload, "close");
+        Reply(
+            Aws::Crt::Eventstream::EventStreamRpcMessageType::ApplicationMessage,
+            close ? AWS_EVENT_STREAM_RPC_MESSAGE_FLAG_TERMINATE_STREAM : 0,
+            streamId,
+            payload);
+    }
+
+    Aws::Crt::Eventstream::EventStreamDecoder m_decoder;
+
+    std::mutex m_lock;
+    Aws::Crt::Vector<Aws::Crt::String> m_operations;
+};
+
+/*
+ * Connects to a local event-stream RPC server, completes the Connect handshake, then activates a stream, gets its
+ * message echoed back, and has the server end the stream.
+ */
+static int s_TestEventStreamRpcClientLoopback(Aws::Crt::Allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::Io::EventLoopGroup eventLoopGroup(1, allocator);
+        ASSERT_TRUE(eventLoopGroup);
+        Aws::Crt::Io::DefaultHostResolver defaultHostResolver(eventLoopGroup, 8, 30, allocator);
+        ASSERT_TRUE(defaultHostResolver);
+        Aws::Crt::Io::ClientBootstrap clientBootstrap(eventLoopGroup, defaultHostResolver, allocator);
+        clientBootstrap.EnableBlockingShutdown();
+
+        LoopbackServer server(
+            eventLoopGroup,
+            [allocator]() { return Aws::Crt::MakeShared<LoopbackEventStreamRpcServer>(allocator, allocator); },
+            allocator);
+        ASSERT_TRUE(server.Listen());
+
+        std::mutex lock;
+        std::condition_variable signal;
+        std::shared_ptr<Aws::Crt::Eventstream::EventStreamRpcClientConnection> connection;
+        int setupError = AWS_ERROR_UNKNOWN;
+        bool setupDone = false;
+        bool connectAcked = false;
+        bool shutdown = false;
+
+        Aws::Crt::Eventstream::EventStreamRpcClientConnectionOptions options;
+        options.HostName = server.GetHostName();
+        options.Port = server.GetPort();
+        options.SocketOptions.SetConnectTimeoutMs(3000);
+        options.Bootstrap = &clientBootstrap;
+        options.OnConnectionSetup =
+            [&](const std::shared_ptr<Aws::Crt::Eventstream::EventStreamRpcClientConnection> &newConnection,
+                int errorCode) {
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    connection = newConnection;
+                    setupError = errorCode;
+                    setupDone = true;
+                }
+                signal.notify_all();
+            };
+        options.OnProtocolMessage = [&](Aws::Crt::Eventstream::EventStreamRpcClientConnection &,
+                                        const Aws::Crt::Eventstream::EventStreamRpcMessageView &message) {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                connectAcked = message.GetType() == Aws::Crt::Eventstream::EventStreamRpcMessageType::ConnectAck &&
+                               (message.GetFlags() & AWS_EVENT_STREAM_RPC_MESSAGE_FLAG_CONNECTION_ACCEPTED) != 0;
+            }
+            signal.notify_all();
+        };
+        options.OnConnectionShutdown = [&](Aws::Crt::Eventstream::EventStreamRpcClientConnection &, int) {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                shutdown = true;
+            }
+            signal.notify_all();
+        };
+
+        ASSERT_TRUE(Aws::Crt::Eventstream::EventStreamRpcClientConnection::CreateConnection(options, allocator));
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            ASSERT_TRUE(signal.wait_for(guard, std::chrono::seconds(10), [&]() { return setupDone; }));
+            ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, setupError);
+            ASSERT_NOT_NULL(connection);
+        }
+        ASSERT_TRUE(connection->IsOpen());
+
+        Aws::Crt::Eventstream::EventStreamRpcMessage connect;
+        connect.Type = Aws::Crt::Eventstream::EventStreamRpcMessageType::Connect;
+        ASSERT_TRUE(connection->SendProtocolMessage(connect));
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            ASSERT_TRUE(signal.wait_for(guard, std::chrono::seconds(10), [&]() { return connectAcked; }));
+        }
+
+        Aws::Crt::Vector<Aws::Crt::String> received;
+        Aws::Crt::Vector<uint32_t> receivedFlags;
+        bool closed = false;
+        int flushError = AWS_ERROR_UNKNOWN;
+        auto continuation = connection->NewStream(
+            [&](Aws::Crt::Eventstream::EventStreamRpcClientContinuation &,
+                const Aws::Crt::Eventstream::EventStreamRpcMessageView &message) {
+                Aws::Crt::ByteCursor payload = message.GetPayload();
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    received.emplace_back(reinterpret_cast<const char *>(payload.ptr), payload.len);
+                    receivedFlags.push_back(message.GetFlags());
+                }
+                signal.notify_all();
+            },
+            [&](Aws::Crt::Eventstream::EventStreamRpcClientContinuation &) {
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    closed = true;
+                }
+                signal.notify_all();
+            });
+        ASSERT_NOT_NULL(continuation);
+        ASSERT_FALSE(continuation->IsClosed());
+
+        Aws::Crt::Eventstream::EventStreamRpcMessage message;
+        message.Payload = aws_byte_cursor_from_c_str("hello");
+        ASSERT_TRUE(continuation->Activate("test#Echo", message, [&](int errorCode) {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                flushError = errorCode;
+            }
+            signal.notify_all();
+        }));
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            ASSERT_TRUE(signal.wait_for(guard, std::chrono::seconds(10), [&]() { return received.size() == 1; }));
+            ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, flushError);
+            ASSERT_TRUE(received[0] == "hello");
+            ASSERT_UINT_EQUALS(0, receivedFlags[0]);
+        }
+
+        /* the server ends the stream along with its answer */
+        message.Payload = aws_byte_cursor_from_c_str("close");
+        ASSERT_TRUE(continuation->SendMessage(message));
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            ASSERT_TRUE(signal.wait_for(guard, std::chrono::seconds(10), [&]() { return closed; }));
+            ASSERT_UINT_EQUALS(2, received.size());
+            ASSERT_TRUE(received[1] == "close");
+            ASSERT_TRUE((receivedFlags[1] & AWS_EVENT_STREAM_RPC_MESSAGE_FLAG_TERMINATE_STREAM) != 0);
+        }
+        ASSERT_TRUE(continuation->IsClosed());
+        ASSERT_FALSE(continuation->SendMessage(message));
+
+        auto rpcServer = std::static_pointer_cast<LoopbackEventStreamRpcServer>(server.GetHandler(0));
+        ASSERT_NOT_NULL(rpcServer);
+        Aws::Crt::Vector<Aws::Crt::String> operations = rpcServer->GetOperations();
+        ASSERT_UINT_EQUALS(1, operations.size());
+        ASSERT_TRUE(operations[0] == "test#Echo");
+
+        connection->Close();
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            ASSERT_TRUE(signal.wait_for(guard, std::chrono::seconds(10), [&]() { return shutdown; }));
+        }
+        ASSERT_FALSE(connection->IsOpen());
+
+        continuation.reset();
+        connection.reset();
+    }
+
+    return AWS_ERROR_SUCCESS;
+}
+
+AWS_TEST_CASE(EventStreamRpcClientLoopback, s_TestEventStreamRpcClientLoopback)
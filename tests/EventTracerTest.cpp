@@ -0,0 +1,466 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/Api.h>
+#include <aws/crt/EventTracer.h>
+#include <aws/crt/auth/Credentials.h>
+#include <aws/crt/http/HttpConnection.h>
+#include <aws/crt/http/HttpRequestResponse.h>
+#include <aws/crt/io/Bootstrap.h>
+#include <aws/crt/mqtt/MqttClient.h>
+
+#include <aws/testing/aws_test_harness.h>
+
+#include "LoopbackMqttBroker.h"
+#include "LoopbackServer.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace Aws::Crt;
+
+/* @return the events of type and phase, in the order they were recorded */
+static Vector<TraceEvent> s_FindEvents(const Vector<TraceEvent> &events, TraceEventType type, TraceEventPhase phase)
+{
+    Vector<TraceEvent> found;
+    for (const TraceEvent &event : events)
+    {
+        if (event.Type == type && event.Phase == phase)
+        {
+            found.push_back(event);
+        }
+    }
+
+    return found;
+}
+
+/*
+ * Threads keep recording while tracers are swapped out and destroyed. Destroying a tracer right after it stops
+ * being active must never free it from under a recorder.
+ */
+static int s_TestEventTracerRecordersQuiesce(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        ApiHandle apiHandle(allocator);
+
+        std::atomic<bool> stop(false);
+        Vector<std::thread> recorders;
+        for (uint64_t i = 0; i < 4; ++i)
+        {
+            recorders.emplace_back([&stop, i]() {
+                while (!stop.load())
+                {
+                    EventTracer::Record(TraceEventType::MqttPublish, TraceEventPhase::Instant, i);
+                }
+            });
+        }
+
+        for (int i = 0; i < 200; ++i)
+        {
+            EventTracer *tracer = EventTracer::Create(16, allocator);
+            ASSERT_NOT_NULL(tracer);
+            EventTracer::SetActive(tracer);
+            std::this_thread::yield();
+            EventTracer::SetActive(nullptr);
+            EventTracer::Destroy(tracer);
+        }
+
+        stop = true;
+        for (std::thread &recorder : recorders)
+        {
+            recorder.join();
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(EventTracerRecordersQuiesce, s_TestEventTracerRecordersQuiesce)
+
+/*
+ * Connects to server, over TLS if tlsOptions is set, and if that works fetches "/" and closes the connection
+ * again. outSetupError is set to the error code the connection was set up with.
+ */
+static int s_TracedHttpFetch(
+    struct aws_allocator *allocator,
+    Io::ClientBootstrap &clientBootstrap,
+    const LoopbackServer &server,
+    const Io::TlsConnectionOptions *tlsOptions,
+    int &outSetupError)
+{
+    std::mutex lock;
+    std::condition_variable signal;
+    std::shared_ptr<Http::HttpClientConnection> connection;
+    bool setupDone = false;
+    bool shutdownDone = false;
+
+    Http::HttpClientConnectionOptions connectionOptions;
+    connectionOptions.Bootstrap = &clientBootstrap;
+    connectionOptions.HostName = server.GetHostName();
+    connectionOptions.Port = server.GetPort();
+    if (tlsOptions != nullptr)
+    {
+        connectionOptions.TlsOptions = *tlsOptions;
+    }
+    connectionOptions.OnConnectionSetupCallback =
+        [&](const std::shared_ptr<Http::HttpClientConnection> &newConnection, int errorCode) {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                connection = newConnection;
+                outSetupError = errorCode;
+                setupDone = true;
+            }
+            signal.notify_all();
+        };
+    connectionOptions.OnConnectionShutdownCallback = [&](Http::HttpClientConnection &, int) {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            shutdownDone = true;
+        }
+        signal.notify_all();
+    };
+
+    ASSERT_TRUE(Http::HttpClientConnection::CreateConnection(connectionOptions, allocator));
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        ASSERT_TRUE(signal.wait_for(guard, std::chrono::seconds(10), [&]() { return setupDone; }));
+    }
+    if (connection == nullptr)
+    {
+        return AWS_OP_SUCCESS;
+    }
+
+    Http::HttpRequest request(allocator);
+    request.SetMethod(ByteCursorFromCString("GET"));
+    request.SetPath(ByteCursorFromCString("/"));
+    Http::HttpHeader hostHeader;
+    hostHeader.name = ByteCursorFromCString("host");
+    hostHeader.value = ByteCursorFromCString(server.GetHostName());
+    request.AddHeader(hostHeader);
+
+    int streamError = -1;
+    bool streamDone = false;
+    Http::HttpRequestOptions requestOptions;
+    requestOptions.request = &request;
+    requestOptions.onStreamComplete = [&](Http::HttpStream &, int errorCode) {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            streamError = errorCode;
+            streamDone = true;
+        }
+        signal.notify_all();
+    };
+
+    auto stream = connection->NewClientStream(requestOptions);
+    ASSERT_TRUE(stream);
+    ASSERT_TRUE(stream->Activate());
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        ASSERT_TRUE(signal.wait_for(guard, std::chrono::seconds(10), [&]() { return streamDone; }));
+    }
+    ASSERT_SUCCESS(streamError);
+
+    stream = nullptr;
+    connection->Close();
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        signal.wait(guard, [&]() { return shutdownDone; });
+    }
+    connection = nullptr;
+
+    return AWS_OP_SUCCESS;
+}
+
+/* Connection setup, stream and shutdown events of a plain HTTP fetch, recorded from the real callbacks. */
+static int s_TestEventTracerHttpEvents(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        ApiHandle apiHandle(allocator);
+        EventTracer *tracer = apiHandle.EnableEventTracing();
+        ASSERT_NOT_NULL(tracer);
+
+        Io::EventLoopGroup eventLoopGroup(1, allocator);
+        ASSERT_TRUE(eventLoopGroup);
+        Io::DefaultHostResolver defaultHostResolver(eventLoopGroup, 8, 30, allocator);
+        ASSERT_TRUE(defaultHostResolver);
+        Io::ClientBootstrap clientBootstrap(eventLoopGroup, defaultHostResolver, allocator);
+        ASSERT_TRUE(clientBootstrap);
+        clientBootstrap.EnableBlockingShutdown();
+
+        LoopbackServer server(
+            eventLoopGroup,
+            [allocator]() {
+                return MakeShared<LoopbackHttpResponder>(allocator, allocator, [](const String &) {
+                    return String("HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok");
+                });
+            },
+            allocator);
+        ASSERT_TRUE(server.Listen());
+
+        int setupError = -1;
+        ASSERT_SUCCESS(s_TracedHttpFetch(allocator, clientBootstrap, server, nullptr, setupError));
+        ASSERT_SUCCESS(setupError);
+
+        Vector<TraceEvent> events = tracer->GetEvents();
+        Vector<TraceEvent> setupBegins = s_FindEvents(events, TraceEventType::ConnectionSetup, TraceEventPhase::Begin);
+        Vector<TraceEvent> setupEnds = s_FindEvents(events, TraceEventType::ConnectionSetup, TraceEventPhase::End);
+        Vector<TraceEvent> shutdowns =
+            s_FindEvents(events, TraceEventType::ConnectionShutdown, TraceEventPhase::Instant);
+        ASSERT_UINT_EQUALS(1, setupBegins.size());
+        ASSERT_UINT_EQUALS(1, setupEnds.size());
+        ASSERT_UINT_EQUALS(1, shutdowns.size());
+        ASSERT_TRUE(setupBegins[0].Id == setupEnds[0].Id);
+        ASSERT_TRUE(setupBegins[0].Id == shutdowns[0].Id);
+        ASSERT_INT_EQUALS(0, setupEnds[0].Value);
+        ASSERT_TRUE(setupBegins[0].TimestampNs <= setupEnds[0].TimestampNs);
+        ASSERT_TRUE(setupEnds[0].TimestampNs <= shutdowns[0].TimestampNs);
+
+        Vector<TraceEvent> streamBegins = s_FindEvents(events, TraceEventType::HttpStream, TraceEventPhase::Begin);
+        Vector<TraceEvent> streamEnds = s_FindEvents(events, TraceEventType::HttpStream, TraceEventPhase::End);
+        ASSERT_UINT_EQUALS(1, streamBegins.size());
+        ASSERT_UINT_EQUALS(1, streamEnds.size());
+        ASSERT_TRUE(streamBegins[0].Id == streamEnds[0].Id);
+        ASSERT_INT_EQUALS(0, streamEnds[0].Value);
+        ASSERT_TRUE(setupEnds[0].TimestampNs <= streamBegins[0].TimestampNs);
+        ASSERT_TRUE(streamEnds[0].TimestampNs <= shutdowns[0].TimestampNs);
+
+        /* nothing was set up over TLS */
+        ASSERT_UINT_EQUALS(0, s_FindEvents(events, TraceEventType::TlsNegotiated, TraceEventPhase::Instant).size());
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(EventTracerHttpEvents, s_TestEventTracerHttpEvents)
+
+#if !BYO_CRYPTO
+/* Answers whatever it is sent with something that is not TLS, so a handshake fails at once. */
+class NotTlsResponder : public LoopbackConnectionHandler
+{
+  public:
+    explicit NotTlsResponder(Allocator *allocator) : LoopbackConnectionHandler(allocator) {}
+
+  protected:
+    void OnData(ByteCursor) override
+    {
+        static const char response[] = "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\n\r\n";
+        Write(ByteCursorFromArray(reinterpret_cast<const uint8_t *>(response), sizeof(response) - 1));
+    }
+};
+
+/* A failed TLS negotiation shows up as a TlsNegotiated event, then as the end of the connection setup. */
+static int s_TestEventTracerTlsEvents(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        ApiHandle apiHandle(allocator);
+        EventTracer *tracer = apiHandle.EnableEventTracing();
+        ASSERT_NOT_NULL(tracer);
+
+        Io::EventLoopGroup eventLoopGroup(1, allocator);
+        ASSERT_TRUE(eventLoopGroup);
+        Io::DefaultHostResolver defaultHostResolver(eventLoopGroup, 8, 30, allocator);
+        ASSERT_TRUE(defaultHostResolver);
+        Io::ClientBootstrap clientBootstrap(eventLoopGroup, defaultHostResolver, allocator);
+        ASSERT_TRUE(clientBootstrap);
+        clientBootstrap.EnableBlockingShutdown();
+
+        LoopbackServer server(
+            eventLoopGroup, [allocator]() { return MakeShared<NotTlsResponder>(allocator, allocator); }, allocator);
+        ASSERT_TRUE(server.Listen());
+
+        Io::TlsContextOptions tlsCtxOptions = Io::TlsContextOptions::InitDefaultClient(allocator);
+        Io::TlsContext tlsContext(tlsCtxOptions, Io::TlsMode::CLIENT, allocator);
+        ASSERT_TRUE(tlsContext);
+        Io::TlsConnectionOptions tlsConnectionOptions = tlsContext.NewConnectionOptions();
+        ByteCursor serverName = ByteCursorFromCString(server.GetHostName());
+        ASSERT_TRUE(tlsConnectionOptions.SetServerName(serverName));
+
+        int setupError = AWS_ERROR_SUCCESS;
+        ASSERT_SUCCESS(s_TracedHttpFetch(allocator, clientBootstrap, server, &tlsConnectionOptions, setupError));
+        ASSERT_TRUE(setupError != AWS_ERROR_SUCCESS);
+
+        Vector<TraceEvent> events = tracer->GetEvents();
+        Vector<TraceEvent> setupBegins = s_FindEvents(events, TraceEventType::ConnectionSetup, TraceEventPhase::Begin);
+        Vector<TraceEvent> negotiations = s_FindEvents(events, TraceEventType::TlsNegotiated, TraceEventPhase::Instant);
+        Vector<TraceEvent> setupEnds = s_FindEvents(events, TraceEventType::ConnectionSetup, TraceEventPhase::End);
+        ASSERT_UINT_EQUALS(1, setupBegins.size());
+        ASSERT_UINT_EQUALS(1, negotiations.size());
+        ASSERT_UINT_EQUALS(1, setupEnds.size());
+        ASSERT_TRUE(setupBegins[0].Id == negotiations[0].Id);
+        ASSERT_TRUE(setupBegins[0].Id == setupEnds[0].Id);
+        ASSERT_TRUE(negotiations[0].Value != AWS_ERROR_SUCCESS);
+        ASSERT_INT_EQUALS(setupError, setupEnds[0].Value);
+        ASSERT_TRUE(negotiations[0].TimestampNs <= setupEnds[0].TimestampNs);
+        ASSERT_UINT_EQUALS(0, s_FindEvents(events, TraceEventType::HttpStream, TraceEventPhase::Begin).size());
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(EventTracerTlsEvents, s_TestEventTracerTlsEvents)
+#endif // !BYO_CRYPTO
+
+/* Single and batched QoS 1 publishes each record a Begin and, once acknowledged, an End. */
+static int s_TestEventTracerMqttPublishEvents(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        ApiHandle apiHandle(allocator);
+        EventTracer *tracer = apiHandle.EnableEventTracing();
+        ASSERT_NOT_NULL(tracer);
+
+        Io::EventLoopGroup eventLoopGroup(1, allocator);
+        ASSERT_TRUE(eventLoopGroup);
+        Io::DefaultHostResolver defaultHostResolver(eventLoopGroup, 8, 30, allocator);
+        ASSERT_TRUE(defaultHostResolver);
+        Io::ClientBootstrap clientBootstrap(eventLoopGroup, defaultHostResolver, allocator);
+        clientBootstrap.EnableBlockingShutdown();
+
+        LoopbackServer server(
+            eventLoopGroup, [allocator]() { return MakeShared<LoopbackMqttBroker>(allocator, allocator); }, allocator);
+        ASSERT_TRUE(server.Listen());
+
+        Mqtt::MqttClient mqttClient(clientBootstrap, allocator);
+        ASSERT_TRUE(mqttClient);
+        Io::SocketOptions socketOptions;
+        auto mqttConnection = mqttClient.NewConnection(server.GetHostName(), server.GetPort(), socketOptions);
+        ASSERT_NOT_NULL(mqttConnection);
+
+        std::mutex lock;
+        std::condition_variable signal;
+        bool connected = false;
+        bool disconnected = false;
+        size_t completed = 0;
+
+        mqttConnection->OnConnectionCompleted = [&](Mqtt::MqttConnection &, int, Mqtt::ReturnCode, bool) {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                connected = true;
+            }
+            signal.notify_all();
+        };
+        mqttConnection->OnDisconnect = [&](Mqtt::MqttConnection &) {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                disconnected = true;
+            }
+            signal.notify_all();
+        };
+        auto onComplete = [&](Mqtt::MqttConnection &, uint16_t, int) {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                ++completed;
+            }
+            signal.notify_all();
+        };
+
+        ASSERT_TRUE(mqttConnection->Connect("event-tracer-publish", true));
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            ASSERT_TRUE(signal.wait_for(guard, std::chrono::seconds(10), [&]() { return connected; }));
+        }
+
+        ByteBuf payload = ByteBufFromCString("single");
+        ASSERT_TRUE(mqttConnection->Publish("event/single", AWS_MQTT_QOS_AT_LEAST_ONCE, false, payload, onComplete));
+
+        Mqtt::PublishBatchMessage messages[2];
+        messages[0].topic = ByteCursorFromCString("event/batch");
+        messages[0].payload = ByteCursorFromCString("first");
+        messages[0].qos = AWS_MQTT_QOS_AT_LEAST_ONCE;
+        messages[0].retain = false;
+        messages[1] = messages[0];
+        messages[1].payload = ByteCursorFromCString("second!");
+        ASSERT_UINT_EQUALS(2, mqttConnection->PublishBatch(messages, 2, onComplete));
+
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            ASSERT_TRUE(signal.wait_for(guard, std::chrono::seconds(10), [&]() { return completed == 3; }));
+        }
+
+        Vector<TraceEvent> events = tracer->GetEvents();
+        Vector<TraceEvent> begins = s_FindEvents(events, TraceEventType::MqttPublish, TraceEventPhase::Begin);
+        Vector<TraceEvent> ends = s_FindEvents(events, TraceEventType::MqttPublish, TraceEventPhase::End);
+        ASSERT_UINT_EQUALS(3, begins.size());
+        ASSERT_UINT_EQUALS(3, ends.size());
+        ASSERT_INT_EQUALS(6, begins[0].Value);
+        ASSERT_INT_EQUALS(5, begins[1].Value);
+        ASSERT_INT_EQUALS(7, begins[2].Value);
+        for (const TraceEvent &begin : begins)
+        {
+            size_t matched = 0;
+            for (const TraceEvent &end : ends)
+            {
+                if (end.Id == begin.Id)
+                {
+                    ++matched;
+                    ASSERT_INT_EQUALS(0, end.Value);
+                    ASSERT_TRUE(begin.TimestampNs <= end.TimestampNs);
+                }
+            }
+            ASSERT_UINT_EQUALS(1, matched);
+        }
+
+        ASSERT_TRUE(mqttConnection->Disconnect());
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            signal.wait(guard, [&]() { return disconnected; });
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(EventTracerMqttPublishEvents, s_TestEventTracerMqttPublishEvents)
+
+/* A credentials fetch is recorded from the call until the provider resolves it. */
+static int s_TestEventTracerCredentialsEvents(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        ApiHandle apiHandle(allocator);
+        EventTracer *tracer = apiHandle.EnableEventTracing();
+        ASSERT_NOT_NULL(tracer);
+
+        Auth::CredentialsProviderStaticConfig config;
+        config.AccessKeyId = ByteCursorFromCString("AKIDEXAMPLE");
+        config.SecretAccessKey = ByteCursorFromCString("wJalrXUtnFEMI/K7MDENG+bPxRfiCYEXAMPLEKEY");
+        auto provider = Auth::CredentialsProvider::CreateCredentialsProviderStatic(config, allocator);
+        ASSERT_NOT_NULL(provider.get());
+
+        std::mutex lock;
+        std::condition_variable signal;
+        bool resolved = false;
+        int resolvedError = -1;
+        ASSERT_TRUE(provider->GetCredentials([&](std::shared_ptr<Auth::Credentials>, int errorCode) {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                resolvedError = errorCode;
+                resolved = true;
+            }
+            signal.notify_all();
+        }));
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            ASSERT_TRUE(signal.wait_for(guard, std::chrono::seconds(10), [&]() { return resolved; }));
+        }
+        ASSERT_SUCCESS(resolvedError);
+
+        Vector<TraceEvent> events = tracer->GetEvents();
+        Vector<TraceEvent> begins = s_FindEvents(events, TraceEventType::CredentialsFetch, TraceEventPhase::Begin);
+        Vector<TraceEvent> ends = s_FindEvents(events, TraceEventType::CredentialsFetch, TraceEventPhase::End);
+        ASSERT_UINT_EQUALS(1, begins.size());
+        ASSERT_UINT_EQUALS(1, ends.size());
+        ASSERT_TRUE(begins[0].Id == ends[0].Id);
+        ASSERT_INT_EQUALS(0, ends[0].Value);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(EventTracerCredentialsEvents, s_TestEventTracerCredentialsEvents)
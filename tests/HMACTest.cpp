@@ -42,6 +42,102 @@ static int s_TestSHA256HMACResourceSafety(struct aws_allocator *allocator, void
     return AWS_OP_SUCCESS;
 }
 
+static int s_TestSHA256HMACReset(struct aws_allocator *allocator, void *)
+{
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+        uint8_t secret[] = {
+            0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+            0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+        };
+        Aws::Crt::ByteCursor secretCur = aws_byte_cursor_from_array(secret, sizeof(secret));
+        Aws::Crt::ByteCursor otherSecret = aws_byte_cursor_from_c_str("Jefe");
+
+        /* RFC 4231 test cases 1 and 2 */
+        uint8_t expected[] = {
+            0xb0, 0x34, 0x4c, 0x61, 0xd8, 0xdb, 0x38, 0x53, 0x5c, 0xa8, 0xaf, 0xce, 0xaf, 0x0b, 0xf1, 0x2b,
+            0x88, 0x1d, 0xc2, 0x00, 0xc9, 0x83, 0x3d, 0xa7, 0x26, 0xe9, 0x37, 0x6c, 0x2e, 0x32, 0xcf, 0xf7,
+        };
+        uint8_t expectedOther[] = {
+            0x5b, 0xdc, 0xc1, 0x46, 0xbf, 0x60, 0x75, 0x4e, 0x6a, 0x04, 0x24, 0x26, 0x08, 0x95, 0x75, 0xc7,
+            0x5a, 0x00, 0x3f, 0x08, 0x9d, 0x27, 0x39, 0x83, 0x9d, 0xec, 0x58, 0xb9, 0x64, 0xec, 0x38, 0x43,
+        };
+
+        Aws::Crt::Crypto::HMAC sha256Hmac = Aws::Crt::Crypto::HMAC::CreateSHA256HMAC(allocator, secretCur);
+        ASSERT_TRUE(sha256Hmac);
+
+        uint8_t output[Aws::Crt::Crypto::SHA256_HMAC_DIGEST_SIZE] = {0};
+        Aws::Crt::ByteBuf outputBuf = Aws::Crt::ByteBufFromEmptyArray(output, sizeof(output));
+        ASSERT_TRUE(sha256Hmac.Update(aws_byte_cursor_from_c_str("Hi There")));
+        ASSERT_TRUE(sha256Hmac.Digest(outputBuf));
+        ASSERT_FALSE(sha256Hmac);
+        ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), outputBuf.buffer, outputBuf.len);
+
+        /* re-keyed */
+        ASSERT_TRUE(sha256Hmac.Reset(otherSecret));
+        ASSERT_TRUE(sha256Hmac);
+        outputBuf.len = 0;
+        ASSERT_TRUE(sha256Hmac.Update(aws_byte_cursor_from_c_str("what do ya want ")));
+        ASSERT_TRUE(sha256Hmac.Update(aws_byte_cursor_from_c_str("for nothing?")));
+        ASSERT_TRUE(sha256Hmac.Digest(outputBuf));
+        ASSERT_BIN_ARRAYS_EQUALS(expectedOther, sizeof(expectedOther), outputBuf.buffer, outputBuf.len);
+
+        /* and back to the first key */
+        ASSERT_TRUE(sha256Hmac.Reset(secretCur));
+        outputBuf.len = 0;
+        ASSERT_TRUE(sha256Hmac.Update(aws_byte_cursor_from_c_str("Hi There")));
+        ASSERT_TRUE(sha256Hmac.Digest(outputBuf));
+        ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), outputBuf.buffer, outputBuf.len);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(SHA256HMACReset, s_TestSHA256HMACReset)
+
+static int s_TestSHA256HMACDigestArray(struct aws_allocator *allocator, void *)
+{
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+        uint8_t secret[] = {
+            0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+            0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+        };
+        Aws::Crt::ByteCursor secretCur = aws_byte_cursor_from_array(secret, sizeof(secret));
+        Aws::Crt::ByteCursor otherSecret = aws_byte_cursor_from_c_str("Jefe");
+
+        /* RFC 4231 test cases 1 and 2 */
+        uint8_t expected[] = {
+            0xb0, 0x34, 0x4c, 0x61, 0xd8, 0xdb, 0x38, 0x53, 0x5c, 0xa8, 0xaf, 0xce, 0xaf, 0x0b, 0xf1, 0x2b,
+            0x88, 0x1d, 0xc2, 0x00, 0xc9, 0x83, 0x3d, 0xa7, 0x26, 0xe9, 0x37, 0x6c, 0x2e, 0x32, 0xcf, 0xf7,
+        };
+        uint8_t expectedOther[] = {
+            0x5b, 0xdc, 0xc1, 0x46, 0xbf, 0x60, 0x75, 0x4e, 0x6a, 0x04, 0x24, 0x26, 0x08, 0x95, 0x75, 0xc7,
+            0x5a, 0x00, 0x3f, 0x08, 0x9d, 0x27, 0x39, 0x83, 0x9d, 0xec, 0x58, 0xb9, 0x64, 0xec, 0x38, 0x43,
+        };
+
+        Aws::Crt::Crypto::HMAC sha256Hmac = Aws::Crt::Crypto::HMAC::CreateSHA256HMAC(allocator, secretCur);
+        ASSERT_TRUE(sha256Hmac);
+        ASSERT_TRUE(sha256Hmac.Update(aws_byte_cursor_from_c_str("Hi There")));
+        Aws::Crt::Crypto::SHA256HMACDigest digest;
+        ASSERT_TRUE(sha256Hmac.Digest(digest));
+        ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), digest.data(), digest.size());
+
+        Aws::Crt::ByteCursor input = aws_byte_cursor_from_c_str("what do ya want for nothing?");
+        digest.fill(0);
+        ASSERT_TRUE(Aws::Crt::Crypto::ComputeSHA256HMAC(allocator, otherSecret, input, digest));
+        ASSERT_BIN_ARRAYS_EQUALS(expectedOther, sizeof(expectedOther), digest.data(), digest.size());
+
+        digest.fill(0);
+        ASSERT_TRUE(Aws::Crt::Crypto::ComputeSHA256HMAC(otherSecret, input, digest));
+        ASSERT_BIN_ARRAYS_EQUALS(expectedOther, sizeof(expectedOther), digest.data(), digest.size());
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(SHA256HMACDigestArray, s_TestSHA256HMACDigestArray)
+
 #else
 class ByoCryptoHMACInterceptor : public Aws::Crt::Crypto::ByoHMAC
 {
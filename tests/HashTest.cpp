@@ -3,7 +3,9 @@
  * SPDX-License-Identifier: Apache-2.0.
  */
 #include <aws/crt/Api.h>
+#include <aws/crt/crypto/Checksum.h>
 #include <aws/crt/crypto/Hash.h>
+#include <aws/crt/crypto/PartDigests.h>
 #include <aws/testing/aws_test_harness.h>
 
 #include <utility>
@@ -38,6 +40,122 @@ static int s_TestSHA256ResourceSafety(struct aws_allocator *allocator, void *)
 
 AWS_TEST_CASE(SHA256ResourceSafety, s_TestSHA256ResourceSafety)
 
+static int s_TestSHA256Reset(struct aws_allocator *allocator, void *)
+{
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+        Aws::Crt::Crypto::Hash sha256 = Aws::Crt::Crypto::Hash::CreateSHA256(allocator);
+        ASSERT_TRUE(sha256);
+
+        uint8_t expected[] = {
+            0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+            0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad,
+        };
+
+        /* a spent hash, and one reset halfway through a message, both start over */
+        ASSERT_TRUE(sha256.Update(aws_byte_cursor_from_c_str("unrelated")));
+        for (int i = 0; i < 3; ++i)
+        {
+            ASSERT_TRUE(sha256.Reset());
+            ASSERT_TRUE(sha256);
+
+            uint8_t output[Aws::Crt::Crypto::SHA256_DIGEST_SIZE] = {0};
+            Aws::Crt::ByteBuf outputBuf = Aws::Crt::ByteBufFromEmptyArray(output, sizeof(output));
+            ASSERT_TRUE(sha256.Update(aws_byte_cursor_from_c_str("abc")));
+            ASSERT_TRUE(sha256.Digest(outputBuf));
+            ASSERT_FALSE(sha256);
+            ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), outputBuf.buffer, outputBuf.len);
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(SHA256Reset, s_TestSHA256Reset)
+
+static int s_TestSHA256Batch(struct aws_allocator *allocator, void *)
+{
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        const char *messages[] = {"abc", "", "a somewhat longer message than the others", "abc"};
+        const size_t count = sizeof(messages) / sizeof(messages[0]);
+        Aws::Crt::ByteCursor inputs[count];
+        uint8_t digests[count][Aws::Crt::Crypto::SHA256_DIGEST_SIZE];
+        Aws::Crt::ByteBuf outputs[count];
+        for (size_t i = 0; i < count; ++i)
+        {
+            inputs[i] = aws_byte_cursor_from_c_str(messages[i]);
+            outputs[i] = Aws::Crt::ByteBufFromEmptyArray(digests[i], sizeof(digests[i]));
+        }
+
+        ASSERT_TRUE(Aws::Crt::Crypto::ComputeSHA256Batch(allocator, inputs, outputs, count));
+        for (size_t i = 0; i < count; ++i)
+        {
+            uint8_t expected[Aws::Crt::Crypto::SHA256_DIGEST_SIZE] = {0};
+            Aws::Crt::ByteBuf expectedBuf = Aws::Crt::ByteBufFromEmptyArray(expected, sizeof(expected));
+            ASSERT_TRUE(Aws::Crt::Crypto::ComputeSHA256(allocator, inputs[i], expectedBuf));
+            ASSERT_BIN_ARRAYS_EQUALS(expectedBuf.buffer, expectedBuf.len, outputs[i].buffer, outputs[i].len);
+        }
+
+        /* an output without room fails the batch there */
+        uint8_t small[4];
+        outputs[2] = Aws::Crt::ByteBufFromEmptyArray(small, sizeof(small));
+        outputs[0].len = 0;
+        ASSERT_FALSE(Aws::Crt::Crypto::ComputeSHA256Batch(allocator, inputs, outputs, count));
+        ASSERT_UINT_EQUALS(Aws::Crt::Crypto::SHA256_DIGEST_SIZE, outputs[0].len);
+
+        ASSERT_TRUE(Aws::Crt::Crypto::ComputeSHA256Batch(allocator, inputs, outputs, 0));
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(SHA256Batch, s_TestSHA256Batch)
+
+static int s_TestDigestArrays(struct aws_allocator *allocator, void *)
+{
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+        Aws::Crt::ByteCursor input = aws_byte_cursor_from_c_str("abc");
+
+        Aws::Crt::Crypto::SHA256Digest expected = {{
+            0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+            0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad,
+        }};
+
+        Aws::Crt::Crypto::SHA256Digest digest;
+        ASSERT_TRUE(Aws::Crt::Crypto::ComputeSHA256(allocator, input, digest));
+        ASSERT_TRUE(expected == digest);
+
+        Aws::Crt::Crypto::Hash sha256 = Aws::Crt::Crypto::Hash::CreateSHA256(allocator);
+        ASSERT_TRUE(sha256.Update(input));
+        digest.fill(0);
+        ASSERT_TRUE(sha256.Digest(digest));
+        ASSERT_TRUE(expected == digest);
+
+        Aws::Crt::Crypto::MD5Digest expectedMd5 = {{
+            0x90, 0x01, 0x50, 0x98, 0x3c, 0xd2, 0x4f, 0xb0, 0xd6, 0x96, 0x3f, 0x7d, 0x28, 0xe1, 0x7f, 0x72,
+        }};
+        Aws::Crt::Crypto::MD5Digest md5Digest;
+        ASSERT_TRUE(Aws::Crt::Crypto::ComputeMD5(allocator, input, md5Digest));
+        ASSERT_TRUE(expectedMd5 == md5Digest);
+
+        /* a digest of the wrong size leaves the hash running */
+        Aws::Crt::Crypto::Hash md5 = Aws::Crt::Crypto::Hash::CreateMD5(allocator);
+        ASSERT_TRUE(md5.Update(input));
+        ASSERT_FALSE(md5.Digest(digest));
+        ASSERT_INT_EQUALS(AWS_ERROR_INVALID_ARGUMENT, md5.LastError());
+        ASSERT_TRUE(md5);
+        ASSERT_TRUE(md5.Digest(md5Digest));
+        ASSERT_TRUE(expectedMd5 == md5Digest);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(DigestArrays, s_TestDigestArrays)
+
 static int s_TestMD5ResourceSafety(struct aws_allocator *allocator, void *)
 {
     {
@@ -81,6 +199,107 @@ static int s_TestMD5ResourceSafety(struct aws_allocator *allocator, void *)
 
 AWS_TEST_CASE(MD5ResourceSafety, s_TestMD5ResourceSafety)
 
+static int s_ExpectSHA256(const Aws::Crt::ByteCursor &data, const Aws::Crt::ByteCursor &digest)
+{
+    uint8_t expected[Aws::Crt::Crypto::SHA256_DIGEST_SIZE] = {0};
+    Aws::Crt::ByteBuf expectedBuf = Aws::Crt::ByteBufFromEmptyArray(expected, sizeof(expected));
+    ASSERT_TRUE(Aws::Crt::Crypto::ComputeSHA256(data, expectedBuf));
+    ASSERT_BIN_ARRAYS_EQUALS(expectedBuf.buffer, expectedBuf.len, digest.ptr, digest.len);
+    return AWS_OP_SUCCESS;
+}
+
+static int s_TestSHA256PartDigests(struct aws_allocator *allocator, void *)
+{
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::Vector<uint8_t> data(10 * 1000 + 17);
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            data[i] = static_cast<uint8_t>(i * 31 + 7);
+        }
+        Aws::Crt::ByteCursor dataCursor = Aws::Crt::ByteCursorFromArray(data.data(), data.size());
+
+        Aws::Crt::Crypto::PartDigestOptions options;
+        options.PartSize = 1000;
+        options.ThreadCount = 4;
+
+        Aws::Crt::Crypto::PartDigests digests(allocator);
+        ASSERT_TRUE(digests.Compute(dataCursor, options));
+        ASSERT_UINT_EQUALS(11, digests.GetPartCount());
+        ASSERT_UINT_EQUALS(data.size(), digests.GetTotalLength());
+        for (size_t part = 0; part < digests.GetPartCount(); ++part)
+        {
+            size_t length = part == 10 ? 17 : 1000;
+            Aws::Crt::ByteCursor partData = Aws::Crt::ByteCursorFromArray(&data[part * 1000], length);
+            ASSERT_SUCCESS(s_ExpectSHA256(partData, digests.GetPartDigest(part)));
+        }
+
+        /* the composite digest is the digest of the part digests back to back */
+        Aws::Crt::Vector<uint8_t> concatenated;
+        for (size_t part = 0; part < digests.GetPartCount(); ++part)
+        {
+            Aws::Crt::ByteCursor digest = digests.GetPartDigest(part);
+            concatenated.insert(concatenated.end(), digest.ptr, digest.ptr + digest.len);
+        }
+        uint8_t composite[Aws::Crt::Crypto::SHA256_DIGEST_SIZE] = {0};
+        Aws::Crt::ByteBuf compositeBuf = Aws::Crt::ByteBufFromEmptyArray(composite, sizeof(composite));
+        ASSERT_TRUE(digests.ComputeCompositeDigest(compositeBuf));
+        ASSERT_SUCCESS(s_ExpectSHA256(
+            Aws::Crt::ByteCursorFromArray(concatenated.data(), concatenated.size()),
+            Aws::Crt::ByteCursorFromByteBuf(compositeBuf)));
+
+        /* reading a stream splits it into the same parts, whether or not other threads hash them */
+        for (size_t threadCount : {1, 3})
+        {
+            Aws::Crt::Io::ByteCursorInputStream stream(dataCursor, allocator);
+            Aws::Crt::Crypto::PartDigests streamed(allocator);
+            options.ThreadCount = threadCount;
+            ASSERT_TRUE(streamed.Compute(stream, options));
+            ASSERT_UINT_EQUALS(digests.GetPartCount(), streamed.GetPartCount());
+            ASSERT_UINT_EQUALS(data.size(), streamed.GetTotalLength());
+            for (size_t part = 0; part < digests.GetPartCount(); ++part)
+            {
+                Aws::Crt::ByteCursor expected = digests.GetPartDigest(part);
+                Aws::Crt::ByteCursor actual = streamed.GetPartDigest(part);
+                ASSERT_BIN_ARRAYS_EQUALS(expected.ptr, expected.len, actual.ptr, actual.len);
+            }
+        }
+
+        /* three parts make the tree H(H(d0 d1) d2) */
+        Aws::Crt::ByteCursor head = Aws::Crt::ByteCursorFromArray(data.data(), 3000);
+        ASSERT_TRUE(digests.Compute(head, options));
+        ASSERT_UINT_EQUALS(3, digests.GetPartCount());
+
+        uint8_t pair[2 * Aws::Crt::Crypto::SHA256_DIGEST_SIZE] = {0};
+        Aws::Crt::ByteBuf pairBuf = Aws::Crt::ByteBufFromEmptyArray(pair, sizeof(pair));
+        Aws::Crt::ByteCursor input = Aws::Crt::ByteCursorFromArray(concatenated.data(), 2 * 32);
+        ASSERT_TRUE(Aws::Crt::Crypto::ComputeSHA256(input, pairBuf));
+        Aws::Crt::ByteCursor third = digests.GetPartDigest(2);
+        ASSERT_TRUE(aws_byte_buf_write_from_whole_cursor(&pairBuf, third));
+
+        uint8_t tree[Aws::Crt::Crypto::SHA256_DIGEST_SIZE] = {0};
+        Aws::Crt::ByteBuf treeBuf = Aws::Crt::ByteBufFromEmptyArray(tree, sizeof(tree));
+        ASSERT_TRUE(digests.ComputeTreeDigest(treeBuf));
+        ASSERT_SUCCESS(
+            s_ExpectSHA256(Aws::Crt::ByteCursorFromByteBuf(pairBuf), Aws::Crt::ByteCursorFromByteBuf(treeBuf)));
+
+        /* nothing at all is one empty part, the same either way in */
+        Aws::Crt::Io::ByteCursorInputStream empty(Aws::Crt::ByteCursorFromArray(nullptr, 0), allocator);
+        ASSERT_TRUE(digests.Compute(empty, options));
+        ASSERT_UINT_EQUALS(1, digests.GetPartCount());
+        ASSERT_SUCCESS(s_ExpectSHA256(Aws::Crt::ByteCursorFromArray(nullptr, 0), digests.GetPartDigest(0)));
+
+        options.PartSize = 0;
+        ASSERT_FALSE(digests.Compute(dataCursor, options));
+        ASSERT_INT_EQUALS(AWS_ERROR_INVALID_ARGUMENT, digests.LastError());
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(SHA256PartDigests, s_TestSHA256PartDigests)
+
 #else
 
 class ByoCryptoHashInterceptor : public Aws::Crt::Crypto::ByoHash
@@ -195,3 +414,47 @@ static int s_TestMD5ResourceSafety(struct aws_allocator *allocator, void *)
 AWS_TEST_CASE(MD5ResourceSafety, s_TestMD5ResourceSafety)
 
 #endif /* BYO_CRYPTO */
+
+static int s_TestCRC32Checksums(struct aws_allocator *allocator, void *)
+{
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        /* the "check" values of both CRCs */
+        Aws::Crt::ByteCursor input = aws_byte_cursor_from_c_str("123456789");
+        ASSERT_UINT_EQUALS(0xCBF43926, Aws::Crt::Crypto::ComputeCRC32(input));
+        ASSERT_UINT_EQUALS(0xE3069283, Aws::Crt::Crypto::ComputeCRC32C(input));
+        ASSERT_UINT_EQUALS(0, Aws::Crt::Crypto::ComputeCRC32(aws_byte_cursor_from_c_str("")));
+
+        Aws::Crt::ByteCursor head = aws_byte_cursor_from_c_str("12345");
+        Aws::Crt::ByteCursor tail = aws_byte_cursor_from_c_str("6789");
+        ASSERT_UINT_EQUALS(
+            0xE3069283, Aws::Crt::Crypto::ComputeCRC32C(tail, Aws::Crt::Crypto::ComputeCRC32C(head)));
+
+        Aws::Crt::Crypto::Checksum crc32c = Aws::Crt::Crypto::Checksum::CreateCRC32C();
+        ASSERT_TRUE(crc32c);
+        ASSERT_TRUE(crc32c.Update(head));
+        ASSERT_TRUE(crc32c.Update(tail));
+        ASSERT_UINT_EQUALS(0xE3069283, crc32c.GetValue());
+
+        uint8_t expected[] = {0xE3, 0x06, 0x92, 0x83};
+        uint8_t output[Aws::Crt::Crypto::CRC32_DIGEST_SIZE] = {0};
+        Aws::Crt::ByteBuf outputBuf = Aws::Crt::ByteBufFromEmptyArray(output, sizeof(output));
+        ASSERT_TRUE(crc32c.Digest(outputBuf));
+        ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), outputBuf.buffer, outputBuf.len);
+
+        /* the checksum stays usable, but the full buffer takes no more */
+        ASSERT_TRUE(crc32c);
+        ASSERT_FALSE(crc32c.Digest(outputBuf));
+        ASSERT_INT_EQUALS(AWS_ERROR_SHORT_BUFFER, crc32c.LastError());
+
+        Aws::Crt::Crypto::Checksum crc32 = Aws::Crt::Crypto::Checksum::CreateCRC32();
+        ASSERT_TRUE(crc32.Update(input));
+        ASSERT_UINT_EQUALS(0xCBF43926, crc32.GetValue());
+        ASSERT_TRUE(Aws::Crt::Crypto::ChecksumAlgorithm::Crc32 == crc32.GetAlgorithm());
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(CRC32Checksums, s_TestCRC32Checksums)
@@ -2,13 +2,21 @@
  * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
  * SPDX-License-Identifier: Apache-2.0.
  */
+#include <aws/common/string.h>
 #include <aws/crt/Api.h>
 #include <aws/crt/Types.h>
+#include <aws/crt/http/HttpConnection.h>
+#include <aws/crt/io/Bootstrap.h>
+#include <aws/crt/io/HostAddressSelector.h>
 #include <aws/crt/io/HostResolver.h>
 #include <aws/testing/aws_test_harness.h>
 
+#include "LoopbackServer.h"
+
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
+#include <thread>
 
 static int s_TestDefaultResolution(struct aws_allocator *allocator, void *)
 {
@@ -50,3 +58,265 @@ static int s_TestDefaultResolution(struct aws_allocator *allocator, void *)
 }
 
 AWS_TEST_CASE(DefaultResolution, s_TestDefaultResolution)
+
+static int s_TestPrefetchAndPinnedResolution(struct aws_allocator *allocator, void *)
+{
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::Io::EventLoopGroup eventLoopGroup(0, allocator);
+        ASSERT_TRUE(eventLoopGroup);
+
+        Aws::Crt::Io::DefaultHostResolver defaultHostResolver(eventLoopGroup, 8, 30, allocator);
+        ASSERT_TRUE(defaultHostResolver);
+
+        Aws::Crt::Vector<Aws::Crt::String> hosts;
+        hosts.push_back("localhost");
+        ASSERT_TRUE(defaultHostResolver.Prefetch(hosts));
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (defaultHostResolver.GetCachedAddressCount("localhost") == 0 &&
+               std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        ASSERT_TRUE(defaultHostResolver.GetCachedAddressCount("localhost") > 0);
+
+        std::condition_variable semaphore;
+        std::mutex semaphoreLock;
+        bool resolved = false;
+        auto onHostResolved = [&](Aws::Crt::Io::HostResolver &,
+                                  const Aws::Crt::Vector<Aws::Crt::Io::HostAddress> &,
+                                  int) {
+            {
+                std::lock_guard<std::mutex> lock(semaphoreLock);
+                resolved = true;
+            }
+            semaphore.notify_one();
+        };
+
+        /* the prefetched host is answered from the cache */
+        ASSERT_TRUE(defaultHostResolver.ResolveHost("localhost", onHostResolved));
+        {
+            std::unique_lock<std::mutex> lock(semaphoreLock);
+            semaphore.wait(lock, [&]() { return resolved; });
+        }
+
+        Aws::Crt::Io::HostResolverStatistics statistics = defaultHostResolver.GetStatistics();
+        ASSERT_UINT_EQUALS(1, statistics.Prefetches);
+        ASSERT_UINT_EQUALS(1, statistics.Resolutions);
+        ASSERT_UINT_EQUALS(1, statistics.CacheHits);
+        ASSERT_UINT_EQUALS(0, statistics.CacheMisses);
+
+        /* a pinned host keeps being refreshed until it is unpinned */
+        ASSERT_TRUE(defaultHostResolver.PinHost("localhost", std::chrono::milliseconds(20)));
+        deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (defaultHostResolver.GetStatistics().Refreshes < 2 && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        ASSERT_TRUE(defaultHostResolver.GetStatistics().Refreshes >= 2);
+        defaultHostResolver.UnpinHost("localhost");
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(PrefetchAndPinnedResolution, s_TestPrefetchAndPinnedResolution)
+
+static Aws::Crt::Io::HostAddress s_MakeHostAddress(const aws_string *address, aws_address_record_type recordType)
+{
+    Aws::Crt::Io::HostAddress hostAddress;
+    AWS_ZERO_STRUCT(hostAddress);
+    hostAddress.address = address;
+    hostAddress.record_type = recordType;
+    return hostAddress;
+}
+
+static int s_TestHostAddressSelectorOrder(struct aws_allocator *allocator, void *)
+{
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        aws_string *ipv4A = aws_string_new_from_c_str(allocator, "10.0.0.1");
+        aws_string *ipv4B = aws_string_new_from_c_str(allocator, "10.0.0.2");
+        aws_string *ipv6A = aws_string_new_from_c_str(allocator, "fd00::1");
+        aws_string *ipv6B = aws_string_new_from_c_str(allocator, "fd00::2");
+
+        Aws::Crt::Vector<Aws::Crt::Io::HostAddress> addresses;
+        addresses.push_back(s_MakeHostAddress(ipv4A, AWS_ADDRESS_RECORD_TYPE_A));
+        addresses.push_back(s_MakeHostAddress(ipv4B, AWS_ADDRESS_RECORD_TYPE_A));
+        addresses.push_back(s_MakeHostAddress(ipv6A, AWS_ADDRESS_RECORD_TYPE_AAAA));
+        addresses.push_back(s_MakeHostAddress(ipv6B, AWS_ADDRESS_RECORD_TYPE_AAAA));
+
+        Aws::Crt::Io::HostAddressSelector selector;
+
+        /* nothing recorded: resolver order, with the families interleaved */
+        auto ordered = selector.Order(addresses);
+        ASSERT_UINT_EQUALS(4, ordered.size());
+        ASSERT_PTR_EQUALS(ipv4A, ordered[0].address);
+        ASSERT_PTR_EQUALS(ipv6A, ordered[1].address);
+        ASSERT_PTR_EQUALS(ipv4B, ordered[2].address);
+        ASSERT_PTR_EQUALS(ipv6B, ordered[3].address);
+
+        /* fastest first, untried next, failed last */
+        selector.RecordConnectSuccess(addresses[3], std::chrono::milliseconds(5));
+        selector.RecordConnectSuccess(addresses[1], std::chrono::milliseconds(20));
+        selector.RecordConnectFailure(addresses[0]);
+        ordered = selector.Order(addresses);
+        ASSERT_UINT_EQUALS(4, ordered.size());
+        ASSERT_PTR_EQUALS(ipv6B, ordered[0].address);
+        ASSERT_PTR_EQUALS(ipv4B, ordered[1].address);
+        ASSERT_PTR_EQUALS(ipv6A, ordered[2].address);
+        ASSERT_PTR_EQUALS(ipv4A, ordered[3].address);
+
+        Aws::Crt::Io::HostAddressStatistics statistics = selector.GetStatistics("10.0.0.1");
+        ASSERT_UINT_EQUALS(1, statistics.ConnectAttempts);
+        ASSERT_UINT_EQUALS(1, statistics.ConnectFailures);
+        ASSERT_UINT_EQUALS(1, statistics.ConsecutiveFailures);
+
+        /* new samples count for an eighth */
+        selector.RecordConnectSuccess(addresses[3], std::chrono::milliseconds(13));
+        statistics = selector.GetStatistics("fd00::2");
+        ASSERT_UINT_EQUALS(2, statistics.ConnectAttempts);
+        ASSERT_UINT_EQUALS(0, statistics.ConnectFailures);
+        ASSERT_TRUE(statistics.SmoothedConnectLatency == std::chrono::milliseconds(6));
+
+        selector.Clear();
+        ASSERT_UINT_EQUALS(0, selector.GetStatistics("fd00::2").ConnectAttempts);
+
+        aws_string_destroy(ipv4A);
+        aws_string_destroy(ipv4B);
+        aws_string_destroy(ipv6A);
+        aws_string_destroy(ipv6B);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(HostAddressSelectorOrder, s_TestHostAddressSelectorOrder)
+
+/*
+ * Races an IPv4 address with a listener behind it against an IPv6 one, freeing both address strings as soon as the
+ * call returns, as the resolver does once its callback is over. Then races them again once nothing listens.
+ */
+static int s_TestConnectionToAddressesRace(struct aws_allocator *allocator, void *)
+{
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::Io::EventLoopGroup eventLoopGroup(1, allocator);
+        ASSERT_TRUE(eventLoopGroup);
+
+        Aws::Crt::Io::DefaultHostResolver defaultHostResolver(eventLoopGroup, 8, 30, allocator);
+        ASSERT_TRUE(defaultHostResolver);
+
+        Aws::Crt::Io::ClientBootstrap clientBootstrap(eventLoopGroup, defaultHostResolver, allocator);
+        ASSERT_TRUE(clientBootstrap);
+        clientBootstrap.EnableBlockingShutdown();
+
+        LoopbackServer server(eventLoopGroup, LoopbackServer::HandlerFactory(), allocator);
+        ASSERT_TRUE(server.Listen());
+
+        auto selector = Aws::Crt::MakeShared<Aws::Crt::Io::HostAddressSelector>(allocator, &defaultHostResolver);
+
+        std::mutex lock;
+        std::condition_variable signal;
+        std::shared_ptr<Aws::Crt::Http::HttpClientConnection> connection;
+        int setupError = AWS_ERROR_SUCCESS;
+        bool setupDone = false;
+        bool shutdownDone = false;
+
+        Aws::Crt::Http::HttpClientConnectionOptions connectionOptions;
+        connectionOptions.Bootstrap = &clientBootstrap;
+        connectionOptions.HostName = "localhost";
+        connectionOptions.Port = server.GetPort();
+        connectionOptions.SocketOptions.SetConnectTimeoutMs(3000);
+        connectionOptions.OnConnectionSetupCallback =
+            [&](const std::shared_ptr<Aws::Crt::Http::HttpClientConnection> &newConnection, int errorCode) {
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    connection = newConnection;
+                    setupError = errorCode;
+                    setupDone = true;
+                }
+                signal.notify_all();
+            };
+        connectionOptions.OnConnectionShutdownCallback = [&](Aws::Crt::Http::HttpClientConnection &, int) {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                shutdownDone = true;
+            }
+            signal.notify_all();
+        };
+
+        auto startRace = [&]() {
+            aws_string *ipv4 = aws_string_new_from_c_str(allocator, "127.0.0.1");
+            aws_string *ipv6 = aws_string_new_from_c_str(allocator, "::1");
+            Aws::Crt::Vector<Aws::Crt::Io::HostAddress> addresses;
+            addresses.push_back(s_MakeHostAddress(ipv4, AWS_ADDRESS_RECORD_TYPE_A));
+            addresses.push_back(s_MakeHostAddress(ipv6, AWS_ADDRESS_RECORD_TYPE_AAAA));
+
+            bool started = Aws::Crt::Http::HttpClientConnection::CreateConnectionToAddresses(
+                connectionOptions, addresses, selector, allocator);
+
+            aws_string_destroy(ipv4);
+            aws_string_destroy(ipv6);
+            return started;
+        };
+
+        /* the losing attempt reports after the winner, so wait for both to be recorded */
+        auto waitForAttempts = [&](uint64_t attempts) {
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+            while ((selector->GetStatistics("127.0.0.1").ConnectAttempts < attempts ||
+                    selector->GetStatistics("::1").ConnectAttempts < attempts) &&
+                   std::chrono::steady_clock::now() < deadline)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        };
+
+        ASSERT_TRUE(startRace());
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            signal.wait(guard, [&]() { return setupDone; });
+            ASSERT_SUCCESS(setupError);
+            ASSERT_NOT_NULL(connection.get());
+        }
+
+        waitForAttempts(1);
+        Aws::Crt::Io::HostAddressStatistics ipv4Statistics = selector->GetStatistics("127.0.0.1");
+        ASSERT_UINT_EQUALS(1, ipv4Statistics.ConnectAttempts);
+        ASSERT_UINT_EQUALS(0, ipv4Statistics.ConnectFailures);
+        ASSERT_TRUE(ipv4Statistics.SmoothedConnectLatency.count() > 0);
+        ASSERT_UINT_EQUALS(1, selector->GetStatistics("::1").ConnectAttempts);
+
+        connection->Close();
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            signal.wait(guard, [&]() { return shutdownDone; });
+            connection.reset();
+            setupDone = false;
+        }
+
+        server.Close();
+
+        ASSERT_TRUE(startRace());
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            signal.wait(guard, [&]() { return setupDone; });
+            ASSERT_TRUE(setupError != AWS_ERROR_SUCCESS);
+            ASSERT_NULL(connection.get());
+        }
+
+        waitForAttempts(2);
+        ipv4Statistics = selector->GetStatistics("127.0.0.1");
+        ASSERT_UINT_EQUALS(2, ipv4Statistics.ConnectAttempts);
+        ASSERT_UINT_EQUALS(1, ipv4Statistics.ConnectFailures);
+        ASSERT_UINT_EQUALS(2, selector->GetStatistics("::1").ConnectAttempts);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(ConnectionToAddressesRace, s_TestConnectionToAddressesRace)
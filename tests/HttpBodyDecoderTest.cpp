@@ -0,0 +1,240 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/Api.h>
+#include <aws/crt/http/HttpBodyDecoder.h>
+#include <aws/crt/http/HttpConnection.h>
+#include <aws/crt/http/HttpRequestResponse.h>
+#include <aws/crt/io/Bootstrap.h>
+
+#include <aws/testing/aws_test_harness.h>
+
+#include "LoopbackServer.h"
+
+#include <condition_variable>
+#include <mutex>
+
+using namespace Aws::Crt;
+
+static const char s_decodedBody[] =
+    "The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog. "
+    "The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog. ";
+
+static const uint8_t s_gzipBody[] = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x0b, 0xc9, 0x48, 0x55, 0x28, 0x2c, 0xcd,
+    0x4c, 0xce, 0x56, 0x48, 0x2a, 0xca, 0x2f, 0xcf, 0x53, 0x48, 0xcb, 0xaf, 0x50, 0xc8, 0x2a, 0xcd, 0x2d,
+    0x28, 0x56, 0xc8, 0x2f, 0x4b, 0x2d, 0x52, 0x28, 0x01, 0x4a, 0xe7, 0x24, 0x56, 0x55, 0x2a, 0xa4, 0xe4,
+    0xa7, 0xeb, 0x29, 0x84, 0x0c, 0x0e, 0xc5, 0x00, 0x1b, 0x8d, 0xff, 0x44, 0xb4, 0x00, 0x00, 0x00};
+
+/* the same body as raw deflate, the way many servers send "Content-Encoding: deflate" */
+static const uint8_t s_rawDeflateBody[] = {
+    0x0b, 0xc9, 0x48, 0x55, 0x28, 0x2c, 0xcd, 0x4c, 0xce, 0x56, 0x48, 0x2a, 0xca, 0x2f, 0xcf, 0x53, 0x48,
+    0xcb, 0xaf, 0x50, 0xc8, 0x2a, 0xcd, 0x2d, 0x28, 0x56, 0xc8, 0x2f, 0x4b, 0x2d, 0x52, 0x28, 0x01, 0x4a,
+    0xe7, 0x24, 0x56, 0x55, 0x2a, 0xa4, 0xe4, 0xa7, 0xeb, 0x29, 0x84, 0x0c, 0x0e, 0xc5, 0x00};
+
+/* feeds input one byte at a time, the worst case for an incremental decoder */
+static int s_DecodeBytewise(
+    Http::HttpBodyDecoder &decoder,
+    const uint8_t *input,
+    size_t inputLength,
+    String &outDecoded)
+{
+    for (size_t i = 0; i < inputLength; ++i)
+    {
+        ASSERT_TRUE(decoder.Decode(ByteCursorFromArray(input + i, 1), [&](const ByteCursor &data) {
+            outDecoded.append(reinterpret_cast<const char *>(data.ptr), data.len);
+            return true;
+        }));
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+static int s_TestHttpBodyDecoder(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Http::HttpContentEncoding encoding = Http::HttpContentEncoding::Identity;
+        ASSERT_TRUE(Http::HttpBodyDecoder::ParseContentEncoding(ByteCursorFromCString(" GZip "), encoding));
+        ASSERT_TRUE(encoding == Http::HttpContentEncoding::Gzip);
+        ASSERT_TRUE(Http::HttpBodyDecoder::ParseContentEncoding(ByteCursorFromCString("deflate"), encoding));
+        ASSERT_TRUE(encoding == Http::HttpContentEncoding::Deflate);
+        ASSERT_TRUE(Http::HttpBodyDecoder::ParseContentEncoding(ByteCursorFromCString("identity"), encoding));
+        ASSERT_TRUE(encoding == Http::HttpContentEncoding::Identity);
+        ASSERT_FALSE(Http::HttpBodyDecoder::ParseContentEncoding(ByteCursorFromCString("br"), encoding));
+
+        auto identity = Http::HttpBodyDecoder::NewDecoder(Http::HttpContentEncoding::Identity, allocator);
+        ASSERT_NOT_NULL(identity.get());
+        String passedThrough;
+        ASSERT_SUCCESS(s_DecodeBytewise(
+            *identity, reinterpret_cast<const uint8_t *>(s_decodedBody), sizeof(s_decodedBody) - 1, passedThrough));
+        ASSERT_STR_EQUALS(s_decodedBody, passedThrough.c_str());
+
+        if (!Http::HttpBodyDecoder::IsSupported(Http::HttpContentEncoding::Gzip))
+        {
+            ASSERT_NULL(Http::HttpBodyDecoder::NewDecoder(Http::HttpContentEncoding::Gzip, allocator).get());
+            ASSERT_INT_EQUALS(AWS_ERROR_UNSUPPORTED_OPERATION, aws_last_error());
+            return AWS_OP_SUCCESS;
+        }
+
+        auto gzip = Http::HttpBodyDecoder::NewDecoder(Http::HttpContentEncoding::Gzip, allocator);
+        ASSERT_NOT_NULL(gzip.get());
+        String gunzipped;
+        ASSERT_SUCCESS(s_DecodeBytewise(*gzip, s_gzipBody, sizeof(s_gzipBody) - 1, gunzipped));
+        ASSERT_FALSE(gzip->IsComplete());
+        ASSERT_SUCCESS(s_DecodeBytewise(*gzip, s_gzipBody + sizeof(s_gzipBody) - 1, 1, gunzipped));
+        ASSERT_TRUE(gzip->IsComplete());
+        ASSERT_STR_EQUALS(s_decodedBody, gunzipped.c_str());
+
+        auto deflate = Http::HttpBodyDecoder::NewDecoder(Http::HttpContentEncoding::Deflate, allocator);
+        ASSERT_NOT_NULL(deflate.get());
+        String inflated;
+        ASSERT_SUCCESS(s_DecodeBytewise(*deflate, s_rawDeflateBody, sizeof(s_rawDeflateBody), inflated));
+        ASSERT_TRUE(deflate->IsComplete());
+        ASSERT_STR_EQUALS(s_decodedBody, inflated.c_str());
+
+        auto corrupt = Http::HttpBodyDecoder::NewDecoder(Http::HttpContentEncoding::Gzip, allocator);
+        ASSERT_NOT_NULL(corrupt.get());
+        ASSERT_FALSE(corrupt->Decode(ByteCursorFromCString("definitely not gzip"), [](const ByteCursor &) {
+            return true;
+        }));
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(HttpBodyDecoder, s_TestHttpBodyDecoder)
+
+/*
+ * Fetches a gzip coded body from a local server with decodeResponseBody set. Builds with zlib see it decoded, builds
+ * without it see the coded bytes as received. Either way the window is updated from this thread while the event loop
+ * sets the stream up for the body.
+ */
+static int s_TestHttpBodyDecoderStream(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Io::EventLoopGroup eventLoopGroup(1, allocator);
+        ASSERT_TRUE(eventLoopGroup);
+        Io::DefaultHostResolver defaultHostResolver(eventLoopGroup, 8, 30, allocator);
+        ASSERT_TRUE(defaultHostResolver);
+        Io::ClientBootstrap clientBootstrap(eventLoopGroup, defaultHostResolver, allocator);
+        ASSERT_TRUE(clientBootstrap);
+        clientBootstrap.EnableBlockingShutdown();
+
+        String gzipBody(reinterpret_cast<const char *>(s_gzipBody), sizeof(s_gzipBody));
+        LoopbackServer server(
+            eventLoopGroup,
+            [allocator, gzipBody]() {
+                return MakeShared<LoopbackHttpResponder>(allocator, allocator, [gzipBody](const String &) {
+                    return String("HTTP/1.1 200 OK\r\nContent-Encoding: gzip\r\nContent-Length: ") +
+                           std::to_string(gzipBody.size()).c_str() + "\r\n\r\n" + gzipBody;
+                });
+            },
+            allocator);
+        ASSERT_TRUE(server.Listen());
+
+        std::mutex lock;
+        std::condition_variable signal;
+        std::shared_ptr<Http::HttpClientConnection> connection;
+        bool setupDone = false;
+        bool shutdownDone = false;
+
+        Http::HttpClientConnectionOptions connectionOptions;
+        connectionOptions.Bootstrap = &clientBootstrap;
+        connectionOptions.HostName = server.GetHostName();
+        connectionOptions.Port = server.GetPort();
+        connectionOptions.ManualWindowManagement = true;
+        connectionOptions.InitialWindowSize = 64 * 1024;
+        connectionOptions.OnConnectionSetupCallback =
+            [&](const std::shared_ptr<Http::HttpClientConnection> &newConnection, int) {
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    connection = newConnection;
+                    setupDone = true;
+                }
+                signal.notify_all();
+            };
+        connectionOptions.OnConnectionShutdownCallback = [&](Http::HttpClientConnection &, int) {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                shutdownDone = true;
+            }
+            signal.notify_all();
+        };
+
+        ASSERT_TRUE(Http::HttpClientConnection::CreateConnection(connectionOptions, allocator));
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            signal.wait(guard, [&]() { return setupDone; });
+            ASSERT_NOT_NULL(connection.get());
+        }
+
+        Http::HttpRequest request(allocator);
+        request.SetMethod(ByteCursorFromCString("GET"));
+        request.SetPath(ByteCursorFromCString("/"));
+        Http::HttpHeader hostHeader;
+        hostHeader.name = ByteCursorFromCString("host");
+        hostHeader.value = ByteCursorFromCString(server.GetHostName());
+        request.AddHeader(hostHeader);
+
+        String received;
+        int streamError = -1;
+        bool streamDone = false;
+
+        Http::HttpRequestOptions requestOptions;
+        requestOptions.request = &request;
+        requestOptions.decodeResponseBody = true;
+        requestOptions.onIncomingBody = [&](Http::HttpStream &, const ByteCursor &data) {
+            received.append(reinterpret_cast<const char *>(data.ptr), data.len);
+        };
+        requestOptions.onStreamComplete = [&](Http::HttpStream &, int errorCode) {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                streamError = errorCode;
+                streamDone = true;
+            }
+            signal.notify_all();
+        };
+
+        auto stream = connection->NewClientStream(requestOptions);
+        ASSERT_TRUE(stream);
+        ASSERT_TRUE(stream->Activate());
+        for (int i = 0; i < 64; ++i)
+        {
+            stream->UpdateWindow(1);
+        }
+
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            signal.wait(guard, [&]() { return streamDone; });
+        }
+        ASSERT_SUCCESS(streamError);
+
+        if (Http::HttpBodyDecoder::IsSupported(Http::HttpContentEncoding::Gzip))
+        {
+            ASSERT_STR_EQUALS(s_decodedBody, received.c_str());
+        }
+        else
+        {
+            ASSERT_TRUE(received == gzipBody);
+        }
+
+        stream = nullptr;
+        connection->Close();
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            signal.wait(guard, [&]() { return shutdownDone; });
+        }
+        connection = nullptr;
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(HttpBodyDecoderStream, s_TestHttpBodyDecoderStream)
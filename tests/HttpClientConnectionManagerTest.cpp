@@ -7,7 +7,9 @@
 
 #include <aws/crt/Api.h>
 #include <aws/crt/crypto/Hash.h>
+#include <aws/crt/http/HttpClientConnectionPool.h>
 #include <aws/crt/http/HttpConnectionManager.h>
+#include <aws/crt/http/HttpRequestResponse.h>
 #include <aws/crt/io/Uri.h>
 
 #include <aws/testing/aws_test_harness.h>
@@ -377,4 +379,333 @@ AWS_TEST_CASE(
     HttpClientConnectionWithPendingAcquisitionsAndClosedConnections,
     s_TestHttpClientConnectionWithPendingAcquisitionsAndClosedConnections)
 
+/* prewarm a small pool, then acquire through the future-returning API and pipeline several collected requests. */
+static int s_TestHttpClientConnectionManagerFutures(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::Io::TlsContextOptions tlsCtxOptions = Aws::Crt::Io::TlsContextOptions::InitDefaultClient();
+
+        Aws::Crt::Io::TlsContext tlsContext(tlsCtxOptions, Aws::Crt::Io::TlsMode::CLIENT, allocator);
+        ASSERT_TRUE(tlsContext);
+
+        Aws::Crt::Io::TlsConnectionOptions tlsConnectionOptions = tlsContext.NewConnectionOptions();
+
+        ByteCursor cursor = ByteCursorFromCString("https://aws-crt-test-stuff.s3.amazonaws.com/http_test_doc.txt");
+        Io::Uri uri(cursor, allocator);
+
+        auto hostName = uri.GetHostName();
+        tlsConnectionOptions.SetServerName(hostName);
+
+        Aws::Crt::Io::SocketOptions socketOptions;
+        socketOptions.SetConnectTimeoutMs(10000);
+
+        Aws::Crt::Io::EventLoopGroup eventLoopGroup(1, allocator);
+        ASSERT_TRUE(eventLoopGroup);
+
+        Aws::Crt::Io::DefaultHostResolver defaultHostResolver(eventLoopGroup, 8, 30, allocator);
+        ASSERT_TRUE(defaultHostResolver);
+
+        Aws::Crt::Io::ClientBootstrap clientBootstrap(eventLoopGroup, defaultHostResolver, allocator);
+        ASSERT_TRUE(clientBootstrap);
+        clientBootstrap.EnableBlockingShutdown();
+
+        Http::HttpClientConnectionOptions connectionOptions;
+        connectionOptions.Bootstrap = &clientBootstrap;
+        connectionOptions.SocketOptions = socketOptions;
+        connectionOptions.TlsOptions = tlsConnectionOptions;
+        connectionOptions.HostName = String((const char *)hostName.ptr, hostName.len);
+        connectionOptions.Port = 443;
+
+        Http::HttpClientConnectionManagerOptions connectionManagerOptions;
+        connectionManagerOptions.ConnectionOptions = connectionOptions;
+        connectionManagerOptions.MaxConnections = 2;
+        connectionManagerOptions.EnableBlockingShutdown = true;
+
+        auto connectionManager =
+            Http::HttpClientConnectionManager::NewClientConnectionManager(connectionManagerOptions, allocator);
+        ASSERT_TRUE(connectionManager);
+        ASSERT_UINT_EQUALS(2u, connectionManager->Prewarm(8).get());
+        {
+            Http::HttpClientConnectionAcquisition acquisition = connectionManager->AcquireConnection().get();
+            ASSERT_SUCCESS(acquisition.ErrorCode);
+            ASSERT_TRUE(acquisition.Connection);
+            ASSERT_TRUE(acquisition.Connection->IsOpen());
+
+            /* the leased connection is not there to be warmed */
+            ASSERT_UINT_EQUALS(1u, connectionManager->Prewarm(8).get());
+        }
+
+        auto request = MakeShared<Http::HttpRequest>(allocator, allocator);
+        request->SetMethod(ByteCursorFromCString("GET"));
+        request->SetPath(uri.GetPathAndQuery());
+
+        Http::HttpHeader hostHeader;
+        hostHeader.name = ByteCursorFromCString("host");
+        hostHeader.value = uri.GetHostName();
+        request->AddHeader(hostHeader);
+
+        const size_t requestCount = 4;
+        Vector<std::future<Http::HttpCollectedResponse>> responses;
+        for (size_t i = 0; i < requestCount; ++i)
+        {
+            responses.push_back(connectionManager->MakeRequest(request));
+        }
+
+        for (auto &future : responses)
+        {
+            Http::HttpCollectedResponse response = future.get();
+            ASSERT_SUCCESS(response.ErrorCode);
+            ASSERT_INT_EQUALS(200, response.StatusCode);
+            ASSERT_FALSE(response.Headers.empty());
+            ASSERT_FALSE(response.Body.empty());
+        }
+
+        Http::HttpClientConnectionManagerMetrics metrics = connectionManager->GetMetrics();
+        ASSERT_UINT_EQUALS(2u, metrics.MaxConnections);
+        ASSERT_UINT_EQUALS(0u, metrics.PendingAcquisitions);
+        ASSERT_UINT_EQUALS(2 + 1 + requestCount + 1, metrics.SuccessfulAcquisitions);
+        uint64_t histogramTotal = 0;
+        for (uint64_t bucket : metrics.AcquireLatencyHistogram)
+        {
+            histogramTotal += bucket;
+        }
+        ASSERT_UINT_EQUALS(metrics.SuccessfulAcquisitions + metrics.FailedAcquisitions, histogramTotal);
+
+        connectionManager->InitiateShutdown().get();
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(HttpClientConnectionManagerFutures, s_TestHttpClientConnectionManagerFutures)
+
+/* spread acquisitions over two hosts with a global budget smaller than the demand, and make sure the budget holds */
+static int s_TestHttpClientConnectionPoolMultipleHosts(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::Io::TlsContextOptions tlsCtxOptions = Aws::Crt::Io::TlsContextOptions::InitDefaultClient();
+
+        Aws::Crt::Io::TlsContext tlsContext(tlsCtxOptions, Aws::Crt::Io::TlsMode::CLIENT, allocator);
+        ASSERT_TRUE(tlsContext);
+
+        const char *hostNames[] = {"s3.amazonaws.com", "aws-crt-test-stuff.s3.amazonaws.com"};
+        Vector<Aws::Crt::Io::TlsConnectionOptions> tlsConnectionOptions;
+        for (const char *hostName : hostNames)
+        {
+            tlsConnectionOptions.push_back(tlsContext.NewConnectionOptions());
+            ByteCursor serverName = ByteCursorFromCString(hostName);
+            tlsConnectionOptions.back().SetServerName(serverName);
+        }
+
+        Aws::Crt::Io::SocketOptions socketOptions;
+        socketOptions.SetConnectTimeoutMs(10000);
+
+        Aws::Crt::Io::EventLoopGroup eventLoopGroup(1, allocator);
+        ASSERT_TRUE(eventLoopGroup);
+
+        Aws::Crt::Io::DefaultHostResolver defaultHostResolver(eventLoopGroup, 8, 30, allocator);
+        ASSERT_TRUE(defaultHostResolver);
+
+        Aws::Crt::Io::ClientBootstrap clientBootstrap(eventLoopGroup, defaultHostResolver, allocator);
+        ASSERT_TRUE(clientBootstrap);
+        clientBootstrap.EnableBlockingShutdown();
+
+        Http::HttpClientConnectionPoolOptions poolOptions;
+        poolOptions.ConnectionOptions.Bootstrap = &clientBootstrap;
+        poolOptions.ConnectionOptions.SocketOptions = socketOptions;
+        poolOptions.MaxConnections = 3;
+        poolOptions.MaxConnectionsPerHost = 2;
+        poolOptions.EnableBlockingShutdown = true;
+
+        auto connectionPool = Http::HttpClientConnectionPool::NewClientConnectionPool(poolOptions, allocator);
+        ASSERT_TRUE(connectionPool);
+
+        std::mutex semaphoreLock;
+        std::condition_variable semaphore;
+        Vector<std::shared_ptr<Http::HttpClientConnection>> connections;
+        size_t connectionsAcquired = 0;
+        size_t connectionsFailed = 0;
+
+        auto onConnectionAvailable = [&](std::shared_ptr<Http::HttpClientConnection> newConnection, int errorCode) {
+            {
+                std::lock_guard<std::mutex> lockGuard(semaphoreLock);
+                if (!errorCode)
+                {
+                    connections.push_back(newConnection);
+                    connectionsAcquired++;
+                }
+                else
+                {
+                    connectionsFailed++;
+                }
+            }
+            semaphore.notify_one();
+        };
+
+        const size_t totalConnections = 6;
+        for (size_t i = 0; i < totalConnections; ++i)
+        {
+            Optional<Aws::Crt::Io::TlsConnectionOptions> tlsOptions(tlsConnectionOptions[i % 2]);
+            ASSERT_TRUE(connectionPool->AcquireConnection(hostNames[i % 2], 443, tlsOptions, onConnectionAvailable));
+        }
+
+        {
+            std::unique_lock<std::mutex> uniqueLock(semaphoreLock);
+            semaphore.wait(uniqueLock, [&]() { return connectionsAcquired + connectionsFailed >= 3; });
+            ASSERT_UINT_EQUALS(0u, connectionsFailed);
+            ASSERT_UINT_EQUALS(3u, connectionsAcquired);
+        }
+
+        ASSERT_UINT_EQUALS(3u, connectionPool->GetLeasedConnectionCount());
+        ASSERT_UINT_EQUALS(3u, connectionPool->GetQueuedAcquisitionCount());
+
+        /* releasing the first batch hands their slots to the queued acquisitions */
+        Vector<std::shared_ptr<Http::HttpClientConnection>> firstBatch;
+        {
+            std::lock_guard<std::mutex> lockGuard(semaphoreLock);
+            firstBatch.swap(connections);
+        }
+        firstBatch.clear();
+
+        {
+            std::unique_lock<std::mutex> uniqueLock(semaphoreLock);
+            semaphore.wait(uniqueLock, [&]() { return connectionsAcquired + connectionsFailed >= totalConnections; });
+            ASSERT_UINT_EQUALS(0u, connectionsFailed);
+            ASSERT_UINT_EQUALS(totalConnections, connectionsAcquired);
+        }
+
+        ASSERT_UINT_EQUALS(0u, connectionPool->GetQueuedAcquisitionCount());
+
+        {
+            std::lock_guard<std::mutex> lockGuard(semaphoreLock);
+            firstBatch.swap(connections);
+        }
+        firstBatch.clear();
+        ASSERT_UINT_EQUALS(0u, connectionPool->GetLeasedConnectionCount());
+
+        connectionPool->InitiateShutdown().get();
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(HttpClientConnectionPoolMultipleHosts, s_TestHttpClientConnectionPoolMultipleHosts)
+
+/* a connection kept alive by one of its streams must keep holding its pool slot after the caller lets go of it */
+static int s_TestHttpClientConnectionPoolStreamHoldsSlot(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::Io::TlsContextOptions tlsCtxOptions = Aws::Crt::Io::TlsContextOptions::InitDefaultClient();
+
+        Aws::Crt::Io::TlsContext tlsContext(tlsCtxOptions, Aws::Crt::Io::TlsMode::CLIENT, allocator);
+        ASSERT_TRUE(tlsContext);
+
+        const char *hostName = "s3.amazonaws.com";
+        Aws::Crt::Io::TlsConnectionOptions tlsConnectionOptions = tlsContext.NewConnectionOptions();
+        ByteCursor serverName = ByteCursorFromCString(hostName);
+        tlsConnectionOptions.SetServerName(serverName);
+        Optional<Aws::Crt::Io::TlsConnectionOptions> tlsOptions(tlsConnectionOptions);
+
+        Aws::Crt::Io::SocketOptions socketOptions;
+        socketOptions.SetConnectTimeoutMs(10000);
+
+        Aws::Crt::Io::EventLoopGroup eventLoopGroup(1, allocator);
+        ASSERT_TRUE(eventLoopGroup);
+
+        Aws::Crt::Io::DefaultHostResolver defaultHostResolver(eventLoopGroup, 8, 30, allocator);
+        ASSERT_TRUE(defaultHostResolver);
+
+        Aws::Crt::Io::ClientBootstrap clientBootstrap(eventLoopGroup, defaultHostResolver, allocator);
+        ASSERT_TRUE(clientBootstrap);
+        clientBootstrap.EnableBlockingShutdown();
+
+        Http::HttpClientConnectionPoolOptions poolOptions;
+        poolOptions.ConnectionOptions.Bootstrap = &clientBootstrap;
+        poolOptions.ConnectionOptions.SocketOptions = socketOptions;
+        poolOptions.MaxConnections = 1;
+        poolOptions.MaxConnectionsPerHost = 2;
+        poolOptions.EnableBlockingShutdown = true;
+
+        auto connectionPool = Http::HttpClientConnectionPool::NewClientConnectionPool(poolOptions, allocator);
+        ASSERT_TRUE(connectionPool);
+
+        std::mutex semaphoreLock;
+        std::condition_variable semaphore;
+        Vector<std::shared_ptr<Http::HttpClientConnection>> connections;
+        size_t connectionsFailed = 0;
+
+        auto onConnectionAvailable = [&](std::shared_ptr<Http::HttpClientConnection> newConnection, int errorCode) {
+            {
+                std::lock_guard<std::mutex> lockGuard(semaphoreLock);
+                if (!errorCode)
+                {
+                    connections.push_back(newConnection);
+                }
+                else
+                {
+                    connectionsFailed++;
+                }
+            }
+            semaphore.notify_one();
+        };
+
+        ASSERT_TRUE(connectionPool->AcquireConnection(hostName, 443, tlsOptions, onConnectionAvailable));
+        {
+            std::unique_lock<std::mutex> uniqueLock(semaphoreLock);
+            semaphore.wait(uniqueLock, [&]() { return connections.size() + connectionsFailed >= 1; });
+            ASSERT_UINT_EQUALS(0u, connectionsFailed);
+        }
+
+        std::shared_ptr<Http::HttpClientConnection> connection;
+        {
+            std::lock_guard<std::mutex> lockGuard(semaphoreLock);
+            connection = std::move(connections.back());
+            connections.clear();
+        }
+
+        auto request = MakeShared<Http::HttpRequest>(allocator, allocator);
+        request->SetMethod(ByteCursorFromCString("GET"));
+        request->SetPath(ByteCursorFromCString("/"));
+
+        Http::HttpRequestOptions requestOptions;
+        requestOptions.request = request.get();
+        auto stream = connection->NewClientStream(requestOptions);
+        ASSERT_TRUE(stream);
+
+        ASSERT_TRUE(connectionPool->AcquireConnection(hostName, 443, tlsOptions, onConnectionAvailable));
+        ASSERT_UINT_EQUALS(1u, connectionPool->GetQueuedAcquisitionCount());
+
+        /* the stream still holds the connection, so its slot must not move on yet */
+        connection.reset();
+        ASSERT_UINT_EQUALS(1u, connectionPool->GetLeasedConnectionCount());
+        ASSERT_UINT_EQUALS(1u, connectionPool->GetQueuedAcquisitionCount());
+
+        stream.reset();
+        {
+            std::unique_lock<std::mutex> uniqueLock(semaphoreLock);
+            semaphore.wait(uniqueLock, [&]() { return connections.size() + connectionsFailed >= 1; });
+            ASSERT_UINT_EQUALS(0u, connectionsFailed);
+            connections.clear();
+        }
+
+        ASSERT_UINT_EQUALS(0u, connectionPool->GetQueuedAcquisitionCount());
+        ASSERT_UINT_EQUALS(0u, connectionPool->GetLeasedConnectionCount());
+
+        connectionPool->InitiateShutdown().get();
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(HttpClientConnectionPoolStreamHoldsSlot, s_TestHttpClientConnectionPoolStreamHoldsSlot)
+
 #endif // !BYO_CRYPTO
@@ -4,16 +4,22 @@
  */
 #include <aws/crt/Api.h>
 #include <aws/crt/crypto/Hash.h>
+#include <aws/crt/http/HttpBodySink.h>
 #include <aws/crt/http/HttpConnection.h>
 #include <aws/crt/http/HttpRequestResponse.h>
 #include <aws/crt/io/Uri.h>
 
 #include <aws/testing/aws_test_harness.h>
 
+#include "LoopbackServer.h"
+
+#include <atomic>
 #include <condition_variable>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <mutex>
+#include <thread>
 
 using namespace Aws::Crt;
 
@@ -62,7 +68,7 @@ static int s_VerifyFilesAreTheSame(Allocator *allocator, const char *fileName1,
     return AWS_OP_SUCCESS;
 }
 
-static int s_TestHttpDownloadNoBackPressure(struct aws_allocator *allocator, ByteCursor urlCursor, bool h2Required)
+static int s_TestHttpDownload(struct aws_allocator *allocator, ByteCursor urlCursor, bool h2Required, bool backPressure)
 {
     int result = AWS_OP_ERR;
 
@@ -139,6 +145,12 @@ static int s_TestHttpDownloadNoBackPressure(struct aws_allocator *allocator, Byt
         httpClientConnectionOptions.TlsOptions = tlsConnectionOptions;
         httpClientConnectionOptions.HostName = String((const char *)hostName.ptr, hostName.len);
         httpClientConnectionOptions.Port = 443;
+        if (backPressure)
+        {
+            /* small enough that the download only finishes if the sink keeps reopening the window */
+            httpClientConnectionOptions.ManualWindowManagement = true;
+            httpClientConnectionOptions.InitialWindowSize = 1024;
+        }
 
         std::unique_lock<std::mutex> semaphoreULock(semaphoreLock);
         ASSERT_TRUE(Http::HttpClientConnection::CreateConnection(httpClientConnectionOptions, allocator));
@@ -176,9 +188,18 @@ static int s_TestHttpDownloadNoBackPressure(struct aws_allocator *allocator, Byt
             [&](Http::HttpStream &stream, enum aws_http_header_block, const Http::HttpHeader *, std::size_t) {
                 responseCode = stream.GetResponseStatusCode();
             };
-        requestOptions.onIncomingBody = [&](Http::HttpStream &, const ByteCursor &data) {
-            downloadedFile.write((const char *)data.ptr, data.len);
-        };
+        std::shared_ptr<Http::HttpOStreamBodySink> bodySink;
+        if (backPressure)
+        {
+            bodySink = MakeShared<Http::HttpOStreamBodySink>(allocator, downloadedFile);
+            requestOptions.onIncomingBody = bodySink->GetOnIncomingBody();
+        }
+        else
+        {
+            requestOptions.onIncomingBody = [&](Http::HttpStream &, const ByteCursor &data) {
+                downloadedFile.write((const char *)data.ptr, data.len);
+            };
+        }
 
         request.SetMethod(ByteCursorFromCString("GET"));
         request.SetPath(uri.GetPathAndQuery());
@@ -193,6 +214,12 @@ static int s_TestHttpDownloadNoBackPressure(struct aws_allocator *allocator, Byt
 
         semaphore.wait(semaphoreULock, [&]() { return streamCompleted; });
         ASSERT_INT_EQUALS(200, responseCode);
+        if (bodySink)
+        {
+            ASSERT_TRUE(bodySink->IsGood());
+            ASSERT_UINT_EQUALS(0u, bodySink->GetBufferedBytes());
+            ASSERT_TRUE(bodySink->GetTotalBytes() > httpClientConnectionOptions.InitialWindowSize);
+        }
 
         connection->Close();
         semaphore.wait(semaphoreULock, [&]() { return connectionShutdown; });
@@ -209,7 +236,7 @@ static int s_TestHttpDownloadNoBackPressureHTTP1_1(struct aws_allocator *allocat
 {
     (void)ctx;
     ByteCursor cursor = ByteCursorFromCString("https://aws-crt-test-stuff.s3.amazonaws.com/http_test_doc.txt");
-    return s_TestHttpDownloadNoBackPressure(allocator, cursor, false /*h2Required*/);
+    return s_TestHttpDownload(allocator, cursor, false /*h2Required*/, false /*backPressure*/);
 }
 
 AWS_TEST_CASE(HttpDownloadNoBackPressureHTTP1_1, s_TestHttpDownloadNoBackPressureHTTP1_1)
@@ -218,11 +245,229 @@ static int s_TestHttpDownloadNoBackPressureHTTP2(struct aws_allocator *allocator
 {
     (void)ctx;
     ByteCursor cursor = ByteCursorFromCString("https://d1cz66xoahf9cl.cloudfront.net/http_test_doc.txt");
-    return s_TestHttpDownloadNoBackPressure(allocator, cursor, true /*h2Required*/);
+    return s_TestHttpDownload(allocator, cursor, true /*h2Required*/, false /*backPressure*/);
 }
 
 AWS_TEST_CASE(HttpDownloadNoBackPressureHTTP2, s_TestHttpDownloadNoBackPressureHTTP2)
 
+static int s_TestHttpDownloadWithBackPressureHTTP1_1(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    ByteCursor cursor = ByteCursorFromCString("https://aws-crt-test-stuff.s3.amazonaws.com/http_test_doc.txt");
+    return s_TestHttpDownload(allocator, cursor, false /*h2Required*/, true /*backPressure*/);
+}
+
+AWS_TEST_CASE(HttpDownloadWithBackPressureHTTP1_1, s_TestHttpDownloadWithBackPressureHTTP1_1)
+
+static const uint32_t s_http2LocalInitialWindowSize = 1024 * 1024;
+
+/* connects to an HTTP/2 server with Http2InitialSettings set, runs exercise against the connection, then closes it */
+static int s_WithHttp2Connection(
+    struct aws_allocator *allocator,
+    const std::function<int(Http::Http2ClientConnection &, Io::Uri &)> &exercise)
+{
+    Aws::Crt::ApiHandle apiHandle(allocator);
+    Aws::Crt::Io::TlsContextOptions tlsCtxOptions = Aws::Crt::Io::TlsContextOptions::InitDefaultClient();
+    Aws::Crt::Io::TlsContext tlsContext(tlsCtxOptions, Aws::Crt::Io::TlsMode::CLIENT, allocator);
+    ASSERT_TRUE(tlsContext);
+
+    Aws::Crt::Io::TlsConnectionOptions tlsConnectionOptions = tlsContext.NewConnectionOptions();
+
+    Io::Uri uri(ByteCursorFromCString("https://d1cz66xoahf9cl.cloudfront.net/http_test_doc.txt"), allocator);
+    auto hostName = uri.GetHostName();
+    tlsConnectionOptions.SetServerName(hostName);
+    tlsConnectionOptions.SetAlpnList("h2");
+
+    Aws::Crt::Io::SocketOptions socketOptions;
+    socketOptions.SetConnectTimeoutMs(1000);
+
+    Aws::Crt::Io::EventLoopGroup eventLoopGroup(0, allocator);
+    ASSERT_TRUE(eventLoopGroup);
+    Aws::Crt::Io::DefaultHostResolver defaultHostResolver(eventLoopGroup, 8, 30, allocator);
+    ASSERT_TRUE(defaultHostResolver);
+    Aws::Crt::Io::ClientBootstrap clientBootstrap(eventLoopGroup, defaultHostResolver, allocator);
+    ASSERT_TRUE(clientBootstrap);
+    clientBootstrap.EnableBlockingShutdown();
+
+    std::shared_ptr<Http::HttpClientConnection> connection;
+    bool setupDone = false;
+    bool connectionShutdown = false;
+    std::condition_variable semaphore;
+    std::mutex semaphoreLock;
+
+    Http::HttpClientConnectionOptions httpClientConnectionOptions;
+    httpClientConnectionOptions.Bootstrap = &clientBootstrap;
+    httpClientConnectionOptions.OnConnectionSetupCallback =
+        [&](const std::shared_ptr<Http::HttpClientConnection> &newConnection, int) {
+            std::lock_guard<std::mutex> lockGuard(semaphoreLock);
+            connection = newConnection;
+            setupDone = true;
+            semaphore.notify_one();
+        };
+    httpClientConnectionOptions.OnConnectionShutdownCallback = [&](Http::HttpClientConnection &, int) {
+        std::lock_guard<std::mutex> lockGuard(semaphoreLock);
+        connectionShutdown = true;
+        semaphore.notify_one();
+    };
+    httpClientConnectionOptions.SocketOptions = socketOptions;
+    httpClientConnectionOptions.TlsOptions = tlsConnectionOptions;
+    httpClientConnectionOptions.HostName = String((const char *)hostName.ptr, hostName.len);
+    httpClientConnectionOptions.Port = 443;
+    Http::Http2Setting initialWindowSize;
+    initialWindowSize.id = AWS_HTTP2_SETTINGS_INITIAL_WINDOW_SIZE;
+    initialWindowSize.value = s_http2LocalInitialWindowSize;
+    httpClientConnectionOptions.Http2InitialSettings.push_back(initialWindowSize);
+
+    std::unique_lock<std::mutex> semaphoreULock(semaphoreLock);
+    ASSERT_TRUE(Http::HttpClientConnection::CreateConnection(httpClientConnectionOptions, allocator));
+    semaphore.wait(semaphoreULock, [&]() { return setupDone; });
+    ASSERT_TRUE(connection);
+    ASSERT_TRUE(connection->GetVersion() == Http::HttpVersion::Http2);
+
+    auto http2Connection = Http::Http2ClientConnection::FromConnection(connection);
+    ASSERT_NOT_NULL(http2Connection.get());
+    ASSERT_PTR_EQUALS(http2Connection.get(), connection->AsHttp2());
+
+    semaphoreULock.unlock();
+    int result = exercise(*http2Connection, uri);
+    semaphoreULock.lock();
+
+    http2Connection = nullptr;
+    connection->Close();
+    semaphore.wait(semaphoreULock, [&]() { return connectionShutdown; });
+    connection = nullptr;
+
+    return result;
+}
+
+static int s_TestHttp2ClientConnectionSettings(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    return s_WithHttp2Connection(allocator, [](Http::Http2ClientConnection &connection, Io::Uri &) {
+        std::mutex lock;
+        std::condition_variable signal;
+        bool pingDone = false;
+        int pingError = -1;
+        uint64_t roundTripTimeNs = 0;
+
+        /* the peer acknowledges the initial SETTINGS frame before it answers a PING sent after it */
+        bool pingQueued = connection.Ping([&](Http::Http2ClientConnection &, uint64_t roundTripNs, int errorCode) {
+            std::lock_guard<std::mutex> guard(lock);
+            pingError = errorCode;
+            roundTripTimeNs = roundTripNs;
+            pingDone = true;
+            signal.notify_one();
+        });
+        ASSERT_TRUE(pingQueued);
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            ASSERT_TRUE(signal.wait_for(guard, std::chrono::seconds(10), [&]() { return pingDone; }));
+        }
+        ASSERT_SUCCESS(pingError);
+        ASSERT_TRUE(roundTripTimeNs > 0);
+
+        ASSERT_UINT_EQUALS(
+            s_http2LocalInitialWindowSize, connection.GetLocalSetting(Http::Http2SettingId::InitialWindowSize));
+        ASSERT_TRUE(connection.GetMaxConcurrentStreams() > 0);
+        ASSERT_TRUE(connection.GetInitialWindowSize() > 0);
+        ASSERT_UINT_EQUALS(
+            connection.GetMaxConcurrentStreams(),
+            connection.GetRemoteSetting(Http::Http2SettingId::MaxConcurrentStreams));
+
+        /* a change only shows in the local settings once the peer has acknowledged it */
+        bool settingsDone = false;
+        int settingsError = -1;
+        Vector<Http::Http2Setting> settings;
+        Http::Http2Setting maxHeaderListSize;
+        maxHeaderListSize.id = AWS_HTTP2_SETTINGS_MAX_HEADER_LIST_SIZE;
+        maxHeaderListSize.value = 32 * 1024;
+        settings.push_back(maxHeaderListSize);
+        bool settingsQueued = connection.ChangeSettings(settings, [&](Http::Http2ClientConnection &, int errorCode) {
+            std::lock_guard<std::mutex> guard(lock);
+            settingsError = errorCode;
+            settingsDone = true;
+            signal.notify_one();
+        });
+        ASSERT_TRUE(settingsQueued);
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            ASSERT_TRUE(signal.wait_for(guard, std::chrono::seconds(10), [&]() { return settingsDone; }));
+        }
+        ASSERT_SUCCESS(settingsError);
+        ASSERT_UINT_EQUALS(
+            maxHeaderListSize.value, connection.GetLocalSetting(Http::Http2SettingId::MaxHeaderListSize));
+
+        return AWS_OP_SUCCESS;
+    });
+}
+
+AWS_TEST_CASE(Http2ClientConnectionSettings, s_TestHttp2ClientConnectionSettings)
+
+static int s_TestHttp2ClientConnectionStreamBatch(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    return s_WithHttp2Connection(allocator, [allocator](Http::Http2ClientConnection &connection, Io::Uri &uri) {
+        const size_t streamCount = 3;
+
+        Http::HttpRequest request(allocator);
+        request.SetMethod(ByteCursorFromCString("GET"));
+        request.SetPath(uri.GetPathAndQuery());
+        Http::HttpHeader hostHeader;
+        hostHeader.name = ByteCursorFromCString("host");
+        hostHeader.value = uri.GetHostName();
+        request.AddHeader(hostHeader);
+
+        std::mutex lock;
+        std::condition_variable signal;
+        size_t completedCount = 0;
+        Vector<int> responseCodes(streamCount, 0);
+        Vector<int> errorCodes(streamCount, -1);
+        Vector<size_t> bodyLengths(streamCount, 0);
+
+        Vector<Http::HttpRequestOptions> batch;
+        for (size_t i = 0; i < streamCount; ++i)
+        {
+            Http::HttpRequestOptions requestOptions;
+            requestOptions.request = &request;
+            requestOptions.onIncomingHeaders =
+                [&, i](Http::HttpStream &stream, enum aws_http_header_block, const Http::HttpHeader *, std::size_t) {
+                    responseCodes[i] = stream.GetResponseStatusCode();
+                };
+            requestOptions.onIncomingBody = [&, i](Http::HttpStream &, const ByteCursor &data) {
+                bodyLengths[i] += data.len;
+            };
+            requestOptions.onStreamComplete = [&, i](Http::HttpStream &, int errorCode) {
+                std::lock_guard<std::mutex> guard(lock);
+                errorCodes[i] = errorCode;
+                ++completedCount;
+                signal.notify_one();
+            };
+            batch.push_back(requestOptions);
+        }
+
+        Vector<std::shared_ptr<Http::HttpClientStream>> streams;
+        ASSERT_TRUE(connection.NewClientStreams(batch, streams));
+        ASSERT_UINT_EQUALS(streamCount, streams.size());
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            ASSERT_TRUE(
+                signal.wait_for(guard, std::chrono::seconds(10), [&]() { return completedCount == streamCount; }));
+        }
+
+        for (size_t i = 0; i < streamCount; ++i)
+        {
+            ASSERT_SUCCESS(errorCodes[i]);
+            ASSERT_INT_EQUALS(200, responseCodes[i]);
+            ASSERT_TRUE(bodyLengths[i] > 0);
+            ASSERT_UINT_EQUALS(bodyLengths[0], bodyLengths[i]);
+        }
+
+        return AWS_OP_SUCCESS;
+    });
+}
+
+AWS_TEST_CASE(Http2ClientConnectionStreamBatch, s_TestHttp2ClientConnectionStreamBatch)
+
 static int s_TestHttpStreamUnActivated(struct aws_allocator *allocator, void *ctx)
 {
     (void)ctx;
@@ -342,3 +587,656 @@ static int s_TestHttpStreamUnActivated(struct aws_allocator *allocator, void *ct
 AWS_TEST_CASE(HttpStreamUnActivated, s_TestHttpStreamUnActivated)
 
 #endif // !BYO_CRYPTO
+
+/*
+ * Downloads a body many times the largest window from a local server over a connection with AdaptiveReadWindow, with
+ * the window either left to the connection or updated from `OnIncomingBody`. Whatever the tuner holds back, the
+ * window must keep reopening until the whole body is in.
+ */
+static int s_FetchWithAdaptiveReadWindow(Allocator *allocator, bool manualWindowManagement)
+{
+    Io::EventLoopGroup eventLoopGroup(1, allocator);
+    ASSERT_TRUE(eventLoopGroup);
+    Io::DefaultHostResolver defaultHostResolver(eventLoopGroup, 8, 30, allocator);
+    ASSERT_TRUE(defaultHostResolver);
+    Io::ClientBootstrap clientBootstrap(eventLoopGroup, defaultHostResolver, allocator);
+    ASSERT_TRUE(clientBootstrap);
+    clientBootstrap.EnableBlockingShutdown();
+
+    const size_t bodySize = 1024 * 1024;
+    LoopbackServer server(
+        eventLoopGroup,
+        [allocator, bodySize]() {
+            return MakeShared<LoopbackHttpResponder>(allocator, allocator, [bodySize](const String &) {
+                return String("HTTP/1.1 200 OK\r\nContent-Length: ") + std::to_string(bodySize).c_str() +
+                       "\r\n\r\n" + String(bodySize, 'b');
+            });
+        },
+        allocator);
+    ASSERT_TRUE(server.Listen());
+
+    std::mutex lock;
+    std::condition_variable signal;
+    std::shared_ptr<Http::HttpClientConnection> connection;
+    bool setupDone = false;
+    bool shutdownDone = false;
+
+    Io::ReadWindowTunerOptions tunerOptions;
+    tunerOptions.InitialWindowSize = 16 * 1024;
+    tunerOptions.MinWindowSize = 16 * 1024;
+    tunerOptions.MaxWindowSize = 256 * 1024;
+
+    Http::HttpClientConnectionOptions connectionOptions;
+    connectionOptions.Bootstrap = &clientBootstrap;
+    connectionOptions.HostName = server.GetHostName();
+    connectionOptions.Port = server.GetPort();
+    connectionOptions.ManualWindowManagement = manualWindowManagement;
+    connectionOptions.AdaptiveReadWindow = tunerOptions;
+    connectionOptions.OnConnectionSetupCallback =
+        [&](const std::shared_ptr<Http::HttpClientConnection> &newConnection, int) {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                connection = newConnection;
+                setupDone = true;
+            }
+            signal.notify_all();
+        };
+    connectionOptions.OnConnectionShutdownCallback = [&](Http::HttpClientConnection &, int) {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            shutdownDone = true;
+        }
+        signal.notify_all();
+    };
+
+    ASSERT_TRUE(Http::HttpClientConnection::CreateConnection(connectionOptions, allocator));
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        signal.wait(guard, [&]() { return setupDone; });
+        ASSERT_NOT_NULL(connection.get());
+    }
+    ASSERT_TRUE(connection->GetVersion() == Http::HttpVersion::Http1_1);
+    ASSERT_NOT_NULL(connection->GetReadWindowTuner().get());
+
+    Http::HttpRequest request(allocator);
+    request.SetMethod(ByteCursorFromCString("GET"));
+    request.SetPath(ByteCursorFromCString("/"));
+    Http::HttpHeader hostHeader;
+    hostHeader.name = ByteCursorFromCString("host");
+    hostHeader.value = ByteCursorFromCString(server.GetHostName());
+    request.AddHeader(hostHeader);
+
+    size_t received = 0;
+    int streamError = -1;
+    bool streamDone = false;
+
+    Http::HttpRequestOptions requestOptions;
+    requestOptions.request = &request;
+    requestOptions.onIncomingBody = [&](Http::HttpStream &stream, const ByteCursor &data) {
+        received += data.len;
+        if (manualWindowManagement)
+        {
+            stream.UpdateWindow(data.len);
+        }
+    };
+    requestOptions.onStreamComplete = [&](Http::HttpStream &, int errorCode) {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            streamError = errorCode;
+            streamDone = true;
+        }
+        signal.notify_all();
+    };
+
+    auto stream = connection->NewClientStream(requestOptions);
+    ASSERT_TRUE(stream);
+    ASSERT_TRUE(stream->Activate());
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        ASSERT_TRUE(signal.wait_for(guard, std::chrono::seconds(30), [&]() { return streamDone; }));
+    }
+    ASSERT_SUCCESS(streamError);
+    ASSERT_UINT_EQUALS(bodySize, received);
+
+    size_t windowSize = connection->GetReadWindowTuner()->GetWindowSize();
+    ASSERT_TRUE(windowSize >= tunerOptions.MinWindowSize && windowSize <= tunerOptions.MaxWindowSize);
+
+    stream = nullptr;
+    connection->Close();
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        signal.wait(guard, [&]() { return shutdownDone; });
+    }
+    connection = nullptr;
+
+    return AWS_OP_SUCCESS;
+}
+
+static int s_TestHttpAdaptiveReadWindow(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        ASSERT_SUCCESS(s_FetchWithAdaptiveReadWindow(allocator, false));
+        ASSERT_SUCCESS(s_FetchWithAdaptiveReadWindow(allocator, true));
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(HttpAdaptiveReadWindow, s_TestHttpAdaptiveReadWindow)
+
+/* holds on to every byte of the body until told to let go, draining what it holds at that point */
+class HoldingBodySink final : public Http::HttpBodySink
+{
+  public:
+    HoldingBodySink() noexcept : m_holding(true) {}
+
+    void LetGo() noexcept
+    {
+        m_holding = false;
+        Drained(GetBufferedBytes());
+    }
+
+  protected:
+    size_t OnBodyData(const ByteCursor &data) noexcept override { return m_holding ? 0 : data.len; }
+
+  private:
+    std::atomic<bool> m_holding;
+};
+
+/*
+ * With AdaptiveReadWindow but no ManualWindowManagement, a body sink reopens the window instead of the connection. A
+ * sink that holds on to the body must therefore stall it at the window, and only letting go finishes the download.
+ */
+static int s_TestHttpBodySinkAdaptiveReadWindow(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Io::EventLoopGroup eventLoopGroup(1, allocator);
+        ASSERT_TRUE(eventLoopGroup);
+        Io::DefaultHostResolver defaultHostResolver(eventLoopGroup, 8, 30, allocator);
+        ASSERT_TRUE(defaultHostResolver);
+        Io::ClientBootstrap clientBootstrap(eventLoopGroup, defaultHostResolver, allocator);
+        ASSERT_TRUE(clientBootstrap);
+        clientBootstrap.EnableBlockingShutdown();
+
+        const size_t bodySize = 256 * 1024;
+        LoopbackServer server(
+            eventLoopGroup,
+            [allocator, bodySize]() {
+                return MakeShared<LoopbackHttpResponder>(allocator, allocator, [bodySize](const String &) {
+                    return String("HTTP/1.1 200 OK\r\nContent-Length: ") + std::to_string(bodySize).c_str() +
+                           "\r\n\r\n" + String(bodySize, 'b');
+                });
+            },
+            allocator);
+        ASSERT_TRUE(server.Listen());
+
+        std::mutex lock;
+        std::condition_variable signal;
+        std::shared_ptr<Http::HttpClientConnection> connection;
+        bool setupDone = false;
+        bool shutdownDone = false;
+
+        /* a window that cannot grow, so what the sink holds can be compared to it */
+        Io::ReadWindowTunerOptions tunerOptions;
+        tunerOptions.InitialWindowSize = 16 * 1024;
+        tunerOptions.MinWindowSize = 16 * 1024;
+        tunerOptions.MaxWindowSize = 16 * 1024;
+
+        Http::HttpClientConnectionOptions connectionOptions;
+        connectionOptions.Bootstrap = &clientBootstrap;
+        connectionOptions.HostName = server.GetHostName();
+        connectionOptions.Port = server.GetPort();
+        connectionOptions.AdaptiveReadWindow = tunerOptions;
+        connectionOptions.OnConnectionSetupCallback =
+            [&](const std::shared_ptr<Http::HttpClientConnection> &newConnection, int) {
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    connection = newConnection;
+                    setupDone = true;
+                }
+                signal.notify_all();
+            };
+        connectionOptions.OnConnectionShutdownCallback = [&](Http::HttpClientConnection &, int) {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                shutdownDone = true;
+            }
+            signal.notify_all();
+        };
+
+        ASSERT_TRUE(Http::HttpClientConnection::CreateConnection(connectionOptions, allocator));
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            signal.wait(guard, [&]() { return setupDone; });
+            ASSERT_NOT_NULL(connection.get());
+        }
+
+        Http::HttpRequest request(allocator);
+        request.SetMethod(ByteCursorFromCString("GET"));
+        request.SetPath(ByteCursorFromCString("/"));
+        Http::HttpHeader hostHeader;
+        hostHeader.name = ByteCursorFromCString("host");
+        hostHeader.value = ByteCursorFromCString(server.GetHostName());
+        request.AddHeader(hostHeader);
+
+        auto sink = MakeShared<HoldingBodySink>(allocator);
+        int streamError = -1;
+        bool streamDone = false;
+
+        Http::HttpRequestOptions requestOptions;
+        requestOptions.request = &request;
+        requestOptions.onIncomingBody = sink->GetOnIncomingBody();
+        requestOptions.onStreamComplete = [&](Http::HttpStream &, int errorCode) {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                streamError = errorCode;
+                streamDone = true;
+            }
+            signal.notify_all();
+        };
+
+        auto stream = connection->NewClientStream(requestOptions);
+        ASSERT_TRUE(stream);
+        ASSERT_TRUE(stream->Activate());
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            ASSERT_FALSE(signal.wait_for(guard, std::chrono::milliseconds(500), [&]() { return streamDone; }));
+        }
+        ASSERT_TRUE(sink->GetTotalBytes() > 0);
+        ASSERT_TRUE(sink->GetTotalBytes() <= tunerOptions.MaxWindowSize);
+        ASSERT_UINT_EQUALS(sink->GetTotalBytes(), sink->GetBufferedBytes());
+
+        sink->LetGo();
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            ASSERT_TRUE(signal.wait_for(guard, std::chrono::seconds(30), [&]() { return streamDone; }));
+        }
+        ASSERT_SUCCESS(streamError);
+        ASSERT_UINT_EQUALS(bodySize, sink->GetTotalBytes());
+        ASSERT_UINT_EQUALS(0u, sink->GetBufferedBytes());
+        ASSERT_UINT_EQUALS(tunerOptions.MaxWindowSize, connection->GetReadWindowTuner()->GetWindowSize());
+
+        stream = nullptr;
+        connection->Close();
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            signal.wait(guard, [&]() { return shutdownDone; });
+        }
+        connection = nullptr;
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(HttpBodySinkAdaptiveReadWindow, s_TestHttpBodySinkAdaptiveReadWindow)
+
+/*
+ * Sends one GET to a local server that answers every request with response, using requestOptions for everything but
+ * the request and `onStreamComplete`. Once the stream completes, check runs with its connection and the stream, before
+ * the connection is closed. streamError is the error the stream completed with.
+ */
+static int s_LoopbackGet(
+    Allocator *allocator,
+    const String &response,
+    Http::HttpRequestOptions requestOptions,
+    int &streamError,
+    const std::function<int(Http::HttpClientConnection &, Http::HttpStream &)> &check)
+{
+    Io::EventLoopGroup eventLoopGroup(1, allocator);
+    ASSERT_TRUE(eventLoopGroup);
+    Io::DefaultHostResolver defaultHostResolver(eventLoopGroup, 8, 30, allocator);
+    ASSERT_TRUE(defaultHostResolver);
+    Io::ClientBootstrap clientBootstrap(eventLoopGroup, defaultHostResolver, allocator);
+    ASSERT_TRUE(clientBootstrap);
+    clientBootstrap.EnableBlockingShutdown();
+
+    LoopbackServer server(
+        eventLoopGroup,
+        [allocator, response]() {
+            return MakeShared<LoopbackHttpResponder>(
+                allocator, allocator, [response](const String &) { return response; });
+        },
+        allocator);
+    ASSERT_TRUE(server.Listen());
+
+    std::mutex lock;
+    std::condition_variable signal;
+    std::shared_ptr<Http::HttpClientConnection> connection;
+    bool setupDone = false;
+    bool shutdownDone = false;
+
+    Http::HttpClientConnectionOptions connectionOptions;
+    connectionOptions.Bootstrap = &clientBootstrap;
+    connectionOptions.HostName = server.GetHostName();
+    connectionOptions.Port = server.GetPort();
+    connectionOptions.OnConnectionSetupCallback =
+        [&](const std::shared_ptr<Http::HttpClientConnection> &newConnection, int) {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                connection = newConnection;
+                setupDone = true;
+            }
+            signal.notify_all();
+        };
+    connectionOptions.OnConnectionShutdownCallback = [&](Http::HttpClientConnection &, int) {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            shutdownDone = true;
+        }
+        signal.notify_all();
+    };
+
+    ASSERT_TRUE(Http::HttpClientConnection::CreateConnection(connectionOptions, allocator));
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        signal.wait(guard, [&]() { return setupDone; });
+        ASSERT_NOT_NULL(connection.get());
+    }
+
+    Http::HttpRequest request(allocator);
+    request.SetMethod(ByteCursorFromCString("GET"));
+    request.SetPath(ByteCursorFromCString("/"));
+    Http::HttpHeader hostHeader;
+    hostHeader.name = ByteCursorFromCString("host");
+    hostHeader.value = ByteCursorFromCString(server.GetHostName());
+    request.AddHeader(hostHeader);
+
+    bool streamDone = false;
+    requestOptions.request = &request;
+    requestOptions.onStreamComplete = [&](Http::HttpStream &, int errorCode) {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            streamError = errorCode;
+            streamDone = true;
+        }
+        signal.notify_all();
+    };
+
+    auto stream = connection->NewClientStream(requestOptions);
+    ASSERT_TRUE(stream);
+    ASSERT_TRUE(stream->Activate());
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        ASSERT_TRUE(signal.wait_for(guard, std::chrono::seconds(30), [&]() { return streamDone; }));
+    }
+
+    int result = check(*connection, *stream);
+
+    stream = nullptr;
+    connection->Close();
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        signal.wait(guard, [&]() { return shutdownDone; });
+    }
+    connection = nullptr;
+
+    return result;
+}
+
+static int s_TestHttpResponseBodyIntoBuffer(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        const size_t bodySize = 100 * 1024;
+        String body(bodySize, 'r');
+        String response = String("HTTP/1.1 200 OK\r\nContent-Length: ") + std::to_string(bodySize).c_str() +
+                          "\r\n\r\n" + body;
+        auto noCheck = [](Http::HttpClientConnection &, Http::HttpStream &) { return AWS_OP_SUCCESS; };
+
+        /* a growable buffer is reserved from Content-Length once, and gets the whole body */
+        ByteBuf growable;
+        ASSERT_SUCCESS(aws_byte_buf_init(&growable, allocator, 0));
+        size_t bodyChunks = 0;
+        Http::HttpRequestOptions requestOptions;
+        requestOptions.responseBody = &growable;
+        requestOptions.onIncomingBody = [&](Http::HttpStream &, const ByteCursor &) { ++bodyChunks; };
+        int streamError = -1;
+        ASSERT_SUCCESS(s_LoopbackGet(allocator, response, requestOptions, streamError, noCheck));
+        ASSERT_SUCCESS(streamError);
+        ASSERT_TRUE(bodyChunks > 0);
+        ASSERT_UINT_EQUALS(bodySize, growable.capacity);
+        ASSERT_BIN_ARRAYS_EQUALS(body.data(), body.size(), growable.buffer, growable.len);
+
+        /* the reservation stops at the limit, and the rest of the body still arrives */
+        ByteBuf limited;
+        ASSERT_SUCCESS(aws_byte_buf_init(&limited, allocator, 0));
+        requestOptions.responseBody = &limited;
+        requestOptions.responseBodyPreallocationLimit = 1024;
+        ASSERT_SUCCESS(s_LoopbackGet(allocator, response, requestOptions, streamError, noCheck));
+        ASSERT_SUCCESS(streamError);
+        ASSERT_BIN_ARRAYS_EQUALS(body.data(), body.size(), limited.buffer, limited.len);
+        aws_byte_buf_clean_up(&limited);
+        aws_byte_buf_clean_up(&growable);
+
+        /* a fixed buffer without room for the body fails the stream */
+        uint8_t storage[1024];
+        ByteBuf fixed = ByteBufFromEmptyArray(storage, sizeof(storage));
+        requestOptions.responseBody = &fixed;
+        ASSERT_SUCCESS(s_LoopbackGet(allocator, response, requestOptions, streamError, noCheck));
+        ASSERT_INT_EQUALS(AWS_ERROR_DEST_COPY_TOO_SMALL, streamError);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(HttpResponseBodyIntoBuffer, s_TestHttpResponseBodyIntoBuffer)
+
+static int s_TestHttpStreamTimings(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        String response("HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\nhello");
+        Http::HttpRequestOptions requestOptions;
+        requestOptions.recordTimings = true;
+        int streamError = -1;
+        ASSERT_SUCCESS(s_LoopbackGet(
+            allocator,
+            response,
+            requestOptions,
+            streamError,
+            [](Http::HttpClientConnection &connection, Http::HttpStream &stream) -> int {
+                const Http::HttpStreamTimings &timings = stream.GetTimings();
+                ASSERT_TRUE(timings.CreatedTimestampNs > 0);
+                ASSERT_TRUE(timings.ActivatedTimestampNs >= timings.CreatedTimestampNs);
+                ASSERT_TRUE(timings.FirstHeaderTimestampNs >= timings.ActivatedTimestampNs);
+                ASSERT_TRUE(timings.HeadersDoneTimestampNs >= timings.FirstHeaderTimestampNs);
+                ASSERT_TRUE(timings.FirstBodyTimestampNs >= timings.HeadersDoneTimestampNs);
+                ASSERT_TRUE(timings.CompletedTimestampNs >= timings.FirstBodyTimestampNs);
+                ASSERT_UINT_EQUALS(5u, timings.BodyBytes);
+                ASSERT_UINT_EQUALS(
+                    timings.GetTotalDurationNs(), timings.CompletedTimestampNs - timings.ActivatedTimestampNs);
+
+                /* the completed stream is counted once, in every histogram */
+                Http::HttpClientConnectionStreamMetrics streamMetrics = connection.GetStreamMetrics();
+                ASSERT_TRUE(streamMetrics.ConnectionSetupDurationNs > 0);
+                ASSERT_UINT_EQUALS(1u, streamMetrics.CompletedStreams);
+                ASSERT_UINT_EQUALS(0u, streamMetrics.FailedStreams);
+                uint64_t histogramTotal = 0;
+                for (size_t i = 0; i < Http::HttpClientConnectionStreamMetrics::LatencyBucketCount; ++i)
+                {
+                    histogramTotal += streamMetrics.TimeToFirstByteHistogram[i] +
+                                      streamMetrics.HeaderDurationHistogram[i] +
+                                      streamMetrics.BodyDurationHistogram[i] + streamMetrics.TotalDurationHistogram[i];
+                }
+                ASSERT_UINT_EQUALS(4u, histogramTotal);
+
+                return AWS_OP_SUCCESS;
+            }));
+        ASSERT_SUCCESS(streamError);
+
+        /* without recordTimings, nothing is timed or counted */
+        requestOptions.recordTimings = false;
+        ASSERT_SUCCESS(s_LoopbackGet(
+            allocator,
+            response,
+            requestOptions,
+            streamError,
+            [](Http::HttpClientConnection &connection, Http::HttpStream &stream) -> int {
+                ASSERT_UINT_EQUALS(0u, stream.GetTimings().CompletedTimestampNs);
+                ASSERT_UINT_EQUALS(0u, connection.GetStreamMetrics().CompletedStreams);
+                return AWS_OP_SUCCESS;
+            }));
+        ASSERT_SUCCESS(streamError);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(HttpStreamTimings, s_TestHttpStreamTimings)
+
+/*
+ * Sends one GET through connection and waits until the stream has completed and the connection has let go of it, so
+ * that dropping `stream` destroys it.
+ */
+static int s_LoopbackRequest(
+    Http::HttpClientConnection &connection,
+    Http::HttpRequest &request,
+    std::shared_ptr<Http::HttpClientStream> &stream)
+{
+    std::mutex lock;
+    std::condition_variable signal;
+    bool streamDone = false;
+    int streamError = -1;
+
+    Http::HttpRequestOptions requestOptions;
+    requestOptions.request = &request;
+    requestOptions.onStreamComplete = [&](Http::HttpStream &, int errorCode) {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            streamError = errorCode;
+            streamDone = true;
+        }
+        signal.notify_all();
+    };
+
+    stream = connection.NewClientStream(requestOptions);
+    ASSERT_TRUE(stream);
+    ASSERT_TRUE(stream->Activate());
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        ASSERT_TRUE(signal.wait_for(guard, std::chrono::seconds(30), [&]() { return streamDone; }));
+    }
+    ASSERT_SUCCESS(streamError);
+
+    /* the connection's reference is dropped on the event loop right after onStreamComplete returns */
+    while (stream.use_count() > 1)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+static int s_TestHttpStreamPool(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Io::EventLoopGroup eventLoopGroup(1, allocator);
+        ASSERT_TRUE(eventLoopGroup);
+        Io::DefaultHostResolver defaultHostResolver(eventLoopGroup, 8, 30, allocator);
+        ASSERT_TRUE(defaultHostResolver);
+        Io::ClientBootstrap clientBootstrap(eventLoopGroup, defaultHostResolver, allocator);
+        ASSERT_TRUE(clientBootstrap);
+        clientBootstrap.EnableBlockingShutdown();
+
+        LoopbackServer server(
+            eventLoopGroup,
+            [allocator]() {
+                return MakeShared<LoopbackHttpResponder>(allocator, allocator, [](const String &) {
+                    return String("HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\nhello");
+                });
+            },
+            allocator);
+        ASSERT_TRUE(server.Listen());
+
+        std::mutex lock;
+        std::condition_variable signal;
+        std::shared_ptr<Http::HttpClientConnection> connection;
+        bool setupDone = false;
+        bool shutdownDone = false;
+
+        Http::HttpClientConnectionOptions connectionOptions;
+        connectionOptions.Bootstrap = &clientBootstrap;
+        connectionOptions.HostName = server.GetHostName();
+        connectionOptions.Port = server.GetPort();
+        connectionOptions.OnConnectionSetupCallback =
+            [&](const std::shared_ptr<Http::HttpClientConnection> &newConnection, int) {
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    connection = newConnection;
+                    setupDone = true;
+                }
+                signal.notify_all();
+            };
+        connectionOptions.OnConnectionShutdownCallback = [&](Http::HttpClientConnection &, int) {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                shutdownDone = true;
+            }
+            signal.notify_all();
+        };
+
+        ASSERT_TRUE(Http::HttpClientConnection::CreateConnection(connectionOptions, allocator));
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            signal.wait(guard, [&]() { return setupDone; });
+            ASSERT_NOT_NULL(connection.get());
+        }
+
+        Http::HttpRequest request(allocator);
+        request.SetMethod(ByteCursorFromCString("GET"));
+        request.SetPath(ByteCursorFromCString("/"));
+        Http::HttpHeader hostHeader;
+        hostHeader.name = ByteCursorFromCString("host");
+        hostHeader.value = ByteCursorFromCString(server.GetHostName());
+        request.AddHeader(hostHeader);
+
+        /*
+         * Each stream and its control block go back to the pool once released, so later requests are served from the
+         * same blocks. Which block ends up holding the stream alternates, but out of three requests two share one.
+         */
+        const void *streamAddresses[3];
+        for (const void *&streamAddress : streamAddresses)
+        {
+            std::shared_ptr<Http::HttpClientStream> stream;
+            ASSERT_SUCCESS(s_LoopbackRequest(*connection, request, stream));
+            streamAddress = stream.get();
+        }
+        ASSERT_TRUE(
+            streamAddresses[0] == streamAddresses[1] || streamAddresses[0] == streamAddresses[2] ||
+            streamAddresses[1] == streamAddresses[2]);
+
+        /* a stream still out when the connection goes away keeps the pool, and the last of the connection, alive */
+        std::shared_ptr<Http::HttpClientStream> heldStream;
+        ASSERT_SUCCESS(s_LoopbackRequest(*connection, request, heldStream));
+        std::weak_ptr<Http::HttpClientConnection> weakConnection = connection;
+        connection->Close();
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            signal.wait(guard, [&]() { return shutdownDone; });
+        }
+        connection = nullptr;
+        ASSERT_FALSE(weakConnection.expired());
+        ASSERT_INT_EQUALS(200, heldStream->GetResponseStatusCode());
+
+        /* the connection is destroyed along with the stream, then the stream's blocks go back to the pool */
+        heldStream = nullptr;
+        ASSERT_TRUE(weakConnection.expired());
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(HttpStreamPool, s_TestHttpStreamPool)
@@ -46,3 +46,92 @@ static int s_HttpRequestTestCreateDestroy(struct aws_allocator *allocator, void
 }
 
 AWS_TEST_CASE(HttpRequestTestCreateDestroy, s_HttpRequestTestCreateDestroy)
+
+static int s_HttpRequestTestHeadersByName(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::Http::HttpRequest request(allocator);
+        HttpHeader headers[] = {
+            {aws_byte_cursor_from_c_str("Host"), aws_byte_cursor_from_c_str("www.test.com")},
+            {aws_byte_cursor_from_c_str("X-Amz-Meta"), aws_byte_cursor_from_c_str("one")},
+            {aws_byte_cursor_from_c_str("x-amz-meta"), aws_byte_cursor_from_c_str("two")},
+        };
+        ASSERT_TRUE(request.AddHeaders(headers, AWS_ARRAY_SIZE(headers)));
+        ASSERT_UINT_EQUALS(3u, request.GetHeaderCount());
+
+        auto host = request.GetHeader(aws_byte_cursor_from_c_str("HOST"));
+        ASSERT_TRUE(host.has_value());
+        ASSERT_TRUE(aws_byte_cursor_eq_c_str(&host.value(), "www.test.com"));
+        ASSERT_FALSE(request.GetHeader(aws_byte_cursor_from_c_str("Authorization")).has_value());
+
+        /* set collapses every case-insensitive match into one header */
+        HttpHeader meta = {aws_byte_cursor_from_c_str("x-AMZ-meta"), aws_byte_cursor_from_c_str("three")};
+        ASSERT_TRUE(request.SetHeader(meta));
+        ASSERT_UINT_EQUALS(2u, request.GetHeaderCount());
+        auto metaValue = request.GetHeader(aws_byte_cursor_from_c_str("X-Amz-Meta"));
+        ASSERT_TRUE(metaValue.has_value());
+        ASSERT_TRUE(aws_byte_cursor_eq_c_str(&metaValue.value(), "three"));
+
+        ASSERT_TRUE(request.EraseHeader(aws_byte_cursor_from_c_str("host")));
+        ASSERT_FALSE(request.EraseHeader(aws_byte_cursor_from_c_str("host")));
+        ASSERT_UINT_EQUALS(1u, request.GetHeaderCount());
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(HttpRequestTestHeadersByName, s_HttpRequestTestHeadersByName)
+
+static int s_HttpRequestTestTemplate(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        HttpRequestTemplate requestTemplate(allocator);
+        ASSERT_TRUE(requestTemplate.SetMethod(aws_byte_cursor_from_c_str("PUT")));
+        ASSERT_TRUE(requestTemplate.SetPath(aws_byte_cursor_from_c_str("/bucket/key")));
+
+        /* enough headers to move the template's storage at least once */
+        const size_t staticHeaderCount = 16;
+        for (size_t i = 0; i < staticHeaderCount; ++i)
+        {
+            Aws::Crt::String name = "x-amz-meta-static-header-" + Aws::Crt::String(1, (char)('a' + i));
+            HttpHeader header = {aws_byte_cursor_from_c_str(name.c_str()), aws_byte_cursor_from_c_str("value")};
+            ASSERT_TRUE(requestTemplate.AddHeader(header));
+        }
+
+        HttpHeader overrides[] = {
+            {aws_byte_cursor_from_c_str("X-Amz-Meta-Static-Header-a"), aws_byte_cursor_from_c_str("overridden")},
+            {aws_byte_cursor_from_c_str("Content-Length"), aws_byte_cursor_from_c_str("0")},
+        };
+
+        for (size_t round = 0; round < 2; ++round)
+        {
+            auto request = requestTemplate.NewRequest(overrides, AWS_ARRAY_SIZE(overrides));
+            ASSERT_NOT_NULL(request.get());
+
+            auto method = request->GetMethod();
+            ASSERT_TRUE(method.has_value());
+            ASSERT_TRUE(aws_byte_cursor_eq_c_str(&method.value(), "PUT"));
+            auto path = request->GetPath();
+            ASSERT_TRUE(path.has_value());
+            ASSERT_TRUE(aws_byte_cursor_eq_c_str(&path.value(), "/bucket/key"));
+
+            ASSERT_UINT_EQUALS(staticHeaderCount + 1, request->GetHeaderCount());
+            auto overridden = request->GetHeader(aws_byte_cursor_from_c_str("x-amz-meta-static-header-a"));
+            ASSERT_TRUE(overridden.has_value());
+            ASSERT_TRUE(aws_byte_cursor_eq_c_str(&overridden.value(), "overridden"));
+            auto untouched = request->GetHeader(aws_byte_cursor_from_c_str("x-amz-meta-static-header-p"));
+            ASSERT_TRUE(untouched.has_value());
+            ASSERT_TRUE(aws_byte_cursor_eq_c_str(&untouched.value(), "value"));
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(HttpRequestTestTemplate, s_HttpRequestTestTemplate)
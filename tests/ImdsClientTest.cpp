@@ -3,12 +3,18 @@
  * SPDX-License-Identifier: Apache-2.0.
  */
 #include <aws/auth/aws_imds_client.h>
+#include <aws/auth/private/credentials_utils.h>
+#include <aws/common/clock.h>
 #include <aws/crt/Api.h>
 #include <aws/crt/ImdsClient.h>
 #include <aws/crt/auth/Credentials.h>
+#include <aws/http/connection_manager.h>
+#include <aws/http/request_response.h>
 #include <aws/testing/aws_test_harness.h>
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
+#include <thread>
 
 using namespace Aws::Crt;
 using namespace Aws::Crt::Auth;
@@ -162,3 +168,300 @@ static int s_TestImdsClientGetCredentials(struct aws_allocator *allocator, void
 }
 
 AWS_TEST_CASE(TestImdsClientGetCredentials, s_TestImdsClientGetCredentials);
+
+static int s_TestImdsClientCachedGetMany(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+        Aws::Crt::Io::EventLoopGroup eventLoopGroup(1, allocator);
+        ASSERT_TRUE(eventLoopGroup);
+
+        Aws::Crt::Io::DefaultHostResolver defaultHostResolver(eventLoopGroup, 8, 30, allocator);
+        ASSERT_TRUE(defaultHostResolver);
+
+        Aws::Crt::Io::ClientBootstrap clientBootstrap(eventLoopGroup, defaultHostResolver, allocator);
+        ASSERT_TRUE(clientBootstrap);
+        clientBootstrap.EnableBlockingShutdown();
+
+        ImdsClientConfig config;
+        config.Bootstrap = &clientBootstrap;
+        config.CacheResources = true;
+        ImdsClient client(config);
+
+        std::condition_variable signal;
+        std::mutex lock;
+        bool done = false;
+        Vector<ImdsResourceResult> results;
+
+        auto callback = [&](const Vector<ImdsResourceResult> &batchResults, void *) {
+            std::unique_lock<std::mutex> ulock(lock);
+            results = batchResults;
+            done = true;
+            signal.notify_one();
+        };
+
+        Vector<StringView> paths;
+        paths.push_back("/latest/meta-data/instance-id");
+        paths.push_back("/latest/meta-data/placement/availability-zone");
+        ASSERT_SUCCESS(client.GetMany(paths, callback, nullptr));
+
+        {
+            std::unique_lock<std::mutex> ulock(lock);
+            signal.wait(ulock, [&]() { return done; });
+        }
+
+        ASSERT_UINT_EQUALS(paths.size(), results.size());
+        ASSERT_TRUE(results[0].resourcePath == "/latest/meta-data/instance-id");
+        if (results[0].errorCode == 0)
+        {
+            ASSERT_FALSE(results[0].resource.empty());
+
+            /* the instance id never changes, so it is now answered from the cache, before the call returns */
+            bool answered = false;
+            String instanceId;
+            auto idCallback = [&](const StringView &resource, int errorCode, void *) {
+                answered = errorCode == 0;
+                instanceId.assign(resource.data(), resource.size());
+            };
+            ASSERT_SUCCESS(client.GetInstanceId(idCallback, nullptr));
+            ASSERT_TRUE(answered);
+            ASSERT_TRUE(instanceId == results[0].resource);
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(TestImdsClientCachedGetMany, s_TestImdsClientCachedGetMany);
+
+static int s_TestImdsClientFutures(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+        Aws::Crt::Io::EventLoopGroup eventLoopGroup(1, allocator);
+        ASSERT_TRUE(eventLoopGroup);
+
+        Aws::Crt::Io::DefaultHostResolver defaultHostResolver(eventLoopGroup, 8, 30, allocator);
+        ASSERT_TRUE(defaultHostResolver);
+
+        Aws::Crt::Io::ClientBootstrap clientBootstrap(eventLoopGroup, defaultHostResolver, allocator);
+        ASSERT_TRUE(clientBootstrap);
+        clientBootstrap.EnableBlockingShutdown();
+
+        ImdsClientConfig config;
+        config.Bootstrap = &clientBootstrap;
+        ImdsClient client(config);
+
+        /* all three are in flight at once */
+        auto instanceIdFuture = client.GetInstanceId();
+        auto instanceInfoFuture = client.GetInstanceInfo();
+        auto securityGroupsFuture = client.GetSecurityGroups();
+
+        ImdsResult<String> instanceId = instanceIdFuture.get();
+        ImdsResult<InstanceInfo> instanceInfo = instanceInfoFuture.get();
+        ImdsResult<Vector<String>> securityGroups = securityGroupsFuture.get();
+
+        if (instanceId.ErrorCode == 0 && instanceInfo.ErrorCode == 0)
+        {
+            ASSERT_FALSE(instanceId.Value.empty());
+            ASSERT_TRUE(instanceId.Value == instanceInfo.Value.instanceId);
+        }
+        if (securityGroups.ErrorCode == 0)
+        {
+            ASSERT_FALSE(securityGroups.Value.empty());
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(TestImdsClientFutures, s_TestImdsClientFutures);
+
+/*
+ * Stands in for the HTTP layer of the C client, so the client can be tested without an instance metadata service.
+ * Every request is answered when it is activated: the token request with a token, and every other request with
+ * "value of <path>".
+ */
+struct MockImds
+{
+    aws_http_connection_manager_shutdown_complete_fn *shutdownCallback = nullptr;
+    void *shutdownUserData = nullptr;
+    struct aws_http_make_request_options requestOptions;
+    std::atomic<size_t> resourceRequests{0};
+};
+
+static MockImds s_mockImds;
+
+static struct aws_http_connection_manager *s_MockConnectionManagerNew(
+    struct aws_allocator *,
+    const struct aws_http_connection_manager_options *options)
+{
+    s_mockImds.shutdownCallback = options->shutdown_complete_callback;
+    s_mockImds.shutdownUserData = options->shutdown_complete_user_data;
+    return reinterpret_cast<struct aws_http_connection_manager *>(&s_mockImds);
+}
+
+static void s_MockConnectionManagerRelease(struct aws_http_connection_manager *)
+{
+    if (s_mockImds.shutdownCallback)
+    {
+        s_mockImds.shutdownCallback(s_mockImds.shutdownUserData);
+    }
+}
+
+static void s_MockAcquireConnection(
+    struct aws_http_connection_manager *,
+    aws_http_connection_manager_on_connection_setup_fn *callback,
+    void *userData)
+{
+    callback(reinterpret_cast<struct aws_http_connection *>(&s_mockImds), AWS_ERROR_SUCCESS, userData);
+}
+
+static int s_MockReleaseConnection(struct aws_http_connection_manager *, struct aws_http_connection *)
+{
+    return AWS_OP_SUCCESS;
+}
+
+static struct aws_http_stream *s_MockMakeRequest(
+    struct aws_http_connection *,
+    const struct aws_http_make_request_options *options)
+{
+    s_mockImds.requestOptions = *options;
+    return reinterpret_cast<struct aws_http_stream *>(&s_mockImds);
+}
+
+static int s_MockStreamActivate(struct aws_http_stream *stream)
+{
+    /* answering may start the next request, which replaces the options */
+    struct aws_http_make_request_options options = s_mockImds.requestOptions;
+
+    struct aws_byte_cursor path;
+    AWS_ZERO_STRUCT(path);
+    aws_http_message_get_request_path(options.request, &path);
+    String requestPath((const char *)path.ptr, path.len);
+
+    String body;
+    if (requestPath == "/latest/api/token")
+    {
+        body = "token";
+    }
+    else
+    {
+        ++s_mockImds.resourceRequests;
+        body = "value of " + requestPath;
+    }
+
+    if (options.on_response_headers)
+    {
+        options.on_response_headers(stream, AWS_HTTP_HEADER_BLOCK_MAIN, nullptr, 0, options.user_data);
+    }
+    if (options.on_response_header_block_done)
+    {
+        options.on_response_header_block_done(stream, AWS_HTTP_HEADER_BLOCK_MAIN, options.user_data);
+    }
+    struct aws_byte_cursor bodyCursor = aws_byte_cursor_from_array(body.data(), body.size());
+    if (options.on_response_body)
+    {
+        options.on_response_body(stream, &bodyCursor, options.user_data);
+    }
+    if (options.on_complete)
+    {
+        options.on_complete(stream, AWS_ERROR_SUCCESS, options.user_data);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+static struct aws_http_connection *s_MockStreamGetConnection(const struct aws_http_stream *)
+{
+    return reinterpret_cast<struct aws_http_connection *>(&s_mockImds);
+}
+
+static int s_MockStreamGetResponseStatus(const struct aws_http_stream *, int *outStatus)
+{
+    *outStatus = 200;
+    return AWS_OP_SUCCESS;
+}
+
+static void s_MockStreamRelease(struct aws_http_stream *) {}
+
+static void s_MockConnectionClose(struct aws_http_connection *) {}
+
+static int s_TestImdsClientResourceCacheTtl(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+        Aws::Crt::Io::EventLoopGroup eventLoopGroup(1, allocator);
+        ASSERT_TRUE(eventLoopGroup);
+
+        Aws::Crt::Io::DefaultHostResolver defaultHostResolver(eventLoopGroup, 8, 30, allocator);
+        ASSERT_TRUE(defaultHostResolver);
+
+        Aws::Crt::Io::ClientBootstrap clientBootstrap(eventLoopGroup, defaultHostResolver, allocator);
+        ASSERT_TRUE(clientBootstrap);
+        clientBootstrap.EnableBlockingShutdown();
+
+        struct aws_auth_http_system_vtable mockFunctions;
+        AWS_ZERO_STRUCT(mockFunctions);
+        mockFunctions.aws_http_connection_manager_new = s_MockConnectionManagerNew;
+        mockFunctions.aws_http_connection_manager_release = s_MockConnectionManagerRelease;
+        mockFunctions.aws_http_connection_manager_acquire_connection = s_MockAcquireConnection;
+        mockFunctions.aws_http_connection_manager_release_connection = s_MockReleaseConnection;
+        mockFunctions.aws_http_connection_make_request = s_MockMakeRequest;
+        mockFunctions.aws_http_stream_activate = s_MockStreamActivate;
+        mockFunctions.aws_http_stream_get_connection = s_MockStreamGetConnection;
+        mockFunctions.aws_http_stream_get_incoming_response_status = s_MockStreamGetResponseStatus;
+        mockFunctions.aws_http_stream_release = s_MockStreamRelease;
+        mockFunctions.aws_http_connection_close = s_MockConnectionClose;
+        mockFunctions.aws_high_res_clock_get_ticks = aws_high_res_clock_get_ticks;
+        s_mockImds.resourceRequests = 0;
+
+        ImdsClientConfig config;
+        config.Bootstrap = &clientBootstrap;
+        config.CacheResources = true;
+        config.ResourceCacheTtl = std::chrono::milliseconds(200);
+        config.FunctionTable = &mockFunctions;
+        ImdsClient client(config);
+
+        /* a resource that may change is served from the cache until its ttl runs out */
+        ImdsResult<String> securityGroups = client.GetResource("/latest/meta-data/security-groups").get();
+        ASSERT_SUCCESS(securityGroups.ErrorCode);
+        ASSERT_TRUE(securityGroups.Value == "value of /latest/meta-data/security-groups");
+        ASSERT_UINT_EQUALS(1, s_mockImds.resourceRequests.load());
+
+        securityGroups = client.GetResource("/latest/meta-data/security-groups").get();
+        ASSERT_SUCCESS(securityGroups.ErrorCode);
+        ASSERT_TRUE(securityGroups.Value == "value of /latest/meta-data/security-groups");
+        ASSERT_UINT_EQUALS(1, s_mockImds.resourceRequests.load());
+
+        /* one that never changes is kept for the life of the client */
+        ImdsResult<String> instanceId = client.GetResource("/latest/meta-data/instance-id").get();
+        ASSERT_SUCCESS(instanceId.ErrorCode);
+        ASSERT_TRUE(instanceId.Value == "value of /latest/meta-data/instance-id");
+        ASSERT_UINT_EQUALS(2, s_mockImds.resourceRequests.load());
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+        securityGroups = client.GetResource("/latest/meta-data/security-groups").get();
+        ASSERT_SUCCESS(securityGroups.ErrorCode);
+        ASSERT_UINT_EQUALS(3, s_mockImds.resourceRequests.load());
+
+        instanceId = client.GetResource("/latest/meta-data/instance-id").get();
+        ASSERT_SUCCESS(instanceId.ErrorCode);
+        ASSERT_TRUE(instanceId.Value == "value of /latest/meta-data/instance-id");
+        ASSERT_UINT_EQUALS(3, s_mockImds.resourceRequests.load());
+
+        /* clearing the cache drops even the resources that never change */
+        client.ClearCache();
+        instanceId = client.GetResource("/latest/meta-data/instance-id").get();
+        ASSERT_SUCCESS(instanceId.ErrorCode);
+        ASSERT_UINT_EQUALS(4, s_mockImds.resourceRequests.load());
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(TestImdsClientResourceCacheTtl, s_TestImdsClientResourceCacheTtl);
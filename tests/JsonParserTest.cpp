@@ -3,7 +3,11 @@
  * SPDX-License-Identifier: Apache-2.0.
  */
 #include <aws/crt/Api.h>
+#include <aws/crt/ArenaAllocator.h>
+#include <aws/crt/JsonMapping.h>
 #include <aws/crt/JsonObject.h>
+#include <aws/crt/JsonStreamReader.h>
+#include <aws/crt/JsonWriter.h>
 #include <aws/testing/aws_test_harness.h>
 
 static int s_BasicJsonParsing(struct aws_allocator *allocator, void *ctx)
@@ -113,3 +117,488 @@ static int s_JsonExplicitNullTest(struct aws_allocator *allocator, void *ctx)
 }
 
 AWS_TEST_CASE(JsonExplicitNull, s_JsonExplicitNullTest)
+
+static int s_JsonIndexedParsingTest(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        const Aws::Crt::String jsonValue = "\xef\xbb\xbf{\"key\\n\":\"a\\\"b\\u00e9\\ud83d\\ude00\", "
+                                           "\"array\":[1, -2.5e3, true, false, null, [], {}], "
+                                           "\"nested\":{\"x\":{\"y\":[\"z\"]}}}";
+
+        Aws::Crt::JsonObject indexed(jsonValue, Aws::Crt::JsonParserBackend::Indexed);
+        ASSERT_TRUE(indexed.WasParseSuccessful());
+        Aws::Crt::JsonObject reference(jsonValue, Aws::Crt::JsonParserBackend::CJson);
+        ASSERT_TRUE(reference.WasParseSuccessful());
+        ASSERT_TRUE(indexed == reference);
+
+        auto view = indexed.View();
+        ASSERT_STR_EQUALS("a\"b\xc3\xa9\xf0\x9f\x98\x80", view.GetString("key\n").c_str());
+        ASSERT_INT_EQUALS(-2500, view.GetArray("array")[1].AsInteger());
+        ASSERT_STR_EQUALS("z", view.GetJsonObject("nested").GetJsonObject("x").GetArray("y")[0].AsString().c_str());
+
+        /* keys and strings share their node's allocation, so copies and replacements must not free them */
+        Aws::Crt::JsonObject copy(indexed);
+        copy.WithString("key\n", "replaced");
+        ASSERT_STR_EQUALS("replaced", copy.View().GetString("key\n").c_str());
+        ASSERT_TRUE(indexed == reference);
+
+        const char *rejected[] = {
+            "",
+            "[1,]",
+            "{\"a\":1,}",
+            "{\"a\" 1}",
+            "[01]",
+            "[1.]",
+            "\"abc",
+            "[\"\\x\"]",
+            "{\"\\ud800\":1}",
+            "{} {}",
+        };
+        for (const char *json : rejected)
+        {
+            Aws::Crt::JsonObject doc(json, Aws::Crt::JsonParserBackend::Indexed);
+            ASSERT_FALSE(doc.WasParseSuccessful());
+            ASSERT_FALSE(doc.GetErrorMessage().empty());
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(JsonIndexedParsing, s_JsonIndexedParsingTest)
+
+static int s_JsonViewIterationTest(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        const Aws::Crt::String jsonValue = "{\"name\":\"device\",\"tags\":[\"a\",\"b\",\"c\"],"
+                                           "\"attributes\":{\"x\":1,\"y\":2}}";
+        Aws::Crt::JsonObject doc(jsonValue);
+        ASSERT_TRUE(doc.WasParseSuccessful());
+        auto view = doc.View();
+
+        Aws::Crt::StringView name = view.GetStringView("name");
+        ASSERT_TRUE(name == Aws::Crt::StringView("device"));
+        ASSERT_TRUE(view.GetStringView("missing").empty());
+        ASSERT_TRUE(view.GetJsonObject("attributes").AsStringView().empty());
+
+        Aws::Crt::String tags;
+        for (auto tag : view.GetChildren("tags"))
+        {
+            tags.append(tag.AsStringView().data(), tag.AsStringView().size());
+        }
+        ASSERT_STR_EQUALS("abc", tags.c_str());
+
+        int sum = 0;
+        Aws::Crt::String keys;
+        auto attributes = view.GetChildren("attributes");
+        for (auto iter = attributes.begin(); iter != attributes.end(); ++iter)
+        {
+            keys.append(iter.Key().data(), iter.Key().size());
+            sum += (*iter).AsInteger();
+        }
+        ASSERT_STR_EQUALS("xy", keys.c_str());
+        ASSERT_INT_EQUALS(3, sum);
+
+        ASSERT_TRUE(view.GetChildren("name").empty());
+        ASSERT_TRUE(view.GetChildren().begin().Key() == Aws::Crt::StringView("name"));
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(JsonViewIteration, s_JsonViewIterationTest)
+
+static Aws::Crt::String s_ReadJsonInChunks(const Aws::Crt::String &json, size_t chunkSize, bool &success)
+{
+    Aws::Crt::String events;
+    Aws::Crt::JsonStreamReader reader([&events](const Aws::Crt::JsonReaderEvent &event) {
+        events.append(1, static_cast<char>('0' + static_cast<int>(event.Type)));
+        events.append(event.Text.data(), event.Text.size());
+        events.append(1, static_cast<char>('0' + event.Depth));
+        if (event.Type == Aws::Crt::JsonReaderEventType::Bool)
+        {
+            events.append(event.Bool ? "T" : "F");
+        }
+        else if (event.Type == Aws::Crt::JsonReaderEventType::Number)
+        {
+            events.append(std::to_string(event.Number).c_str());
+        }
+        events.append(1, ' ');
+    });
+
+    success = true;
+    for (size_t offset = 0; offset < json.size() && success; offset += chunkSize)
+    {
+        size_t length = json.size() - offset < chunkSize ? json.size() - offset : chunkSize;
+        success = reader.Feed(aws_byte_cursor_from_array(json.data() + offset, length));
+    }
+    success = success && reader.Finish();
+    return events;
+}
+
+static int s_JsonStreamReaderChunkedTest(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        const Aws::Crt::String jsonValue = "{\"items\": [{\"id\": 1, \"name\": \"caf\\u00e9\\n\"}, "
+                                           "{\"id\": -2.5e2, \"tags\": [true, false, null, []]}], \"next\": {}}";
+
+        bool success = false;
+        Aws::Crt::String whole = s_ReadJsonInChunks(jsonValue, jsonValue.size(), success);
+        ASSERT_TRUE(success);
+        for (size_t chunkSize = 1; chunkSize < 8; ++chunkSize)
+        {
+            Aws::Crt::String chunked = s_ReadJsonInChunks(jsonValue, chunkSize, success);
+            ASSERT_TRUE(success);
+            ASSERT_STR_EQUALS(whole.c_str(), chunked.c_str());
+        }
+
+        /* the events follow the document, with its strings unescaped */
+        const char *expectedPrefix = "00 4items1 21 02 4id3 6131.000000 4name3 5caf\xc3\xa9\n3 12 ";
+        ASSERT_TRUE(whole.find(expectedPrefix) == 0);
+        ASSERT_TRUE(whole.find("74T 74F 84 24 34 33 ") != Aws::Crt::String::npos);
+
+        /* a number at the end of the document is only complete once the end is signalled */
+        ASSERT_STR_EQUALS("642042.000000 ", s_ReadJsonInChunks("42", 1, success).c_str());
+        ASSERT_TRUE(success);
+
+        const char *rejected[] = {
+            "", "[1,]", "{\"a\" 1}", "[01]", "\"abc", "[\"\\x\"]", "{} {}", "[tru]", "{\"a\":1", "[1}"};
+        for (const char *json : rejected)
+        {
+            s_ReadJsonInChunks(json, 2, success);
+            ASSERT_FALSE(success);
+        }
+
+        /* tokens past the limit break the reader instead of being buffered */
+        Aws::Crt::JsonStreamReader limited([](const Aws::Crt::JsonReaderEvent &) {}, 4, allocator);
+        ASSERT_TRUE(limited.Feed(aws_byte_cursor_from_c_str("[\"ab")));
+        ASSERT_FALSE(limited.Feed(aws_byte_cursor_from_c_str("cde\"]")));
+        ASSERT_INT_EQUALS(AWS_ERROR_MALFORMED_INPUT_STRING, limited.LastError());
+        ASSERT_FALSE(limited.Feed(aws_byte_cursor_from_c_str("]")));
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(JsonStreamReaderChunked, s_JsonStreamReaderChunkedTest)
+
+static int s_JsonWriterTest(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::ByteBuf output;
+        ASSERT_SUCCESS(aws_byte_buf_init(&output, allocator, 16));
+
+        const char *tags[] = {"a", "b\"\n\x01"};
+        Aws::Crt::JsonWriter writer(output);
+        writer.BeginObject().Key("id").WriteInt64(-9007199254740993LL).Key("ratio").WriteDouble(0.1);
+        writer.Key("tags").BeginArray();
+        for (const char *tag : tags)
+        {
+            writer.WriteString(tag);
+        }
+        writer.EndArray().Key("nested").BeginObject().EndObject().Key("ok").WriteBool(true);
+        writer.Key("none").WriteNull().Key("raw").WriteRaw("[1,2]").EndObject();
+        ASSERT_TRUE(writer);
+        ASSERT_TRUE(writer.IsComplete());
+
+        const char *expected = "{\"id\":-9007199254740993,\"ratio\":0.1,\"tags\":[\"a\",\"b\\\"\\n\\u0001\"],"
+                               "\"nested\":{},\"ok\":true,\"none\":null,\"raw\":[1,2]}";
+        Aws::Crt::String written(reinterpret_cast<const char *>(output.buffer), output.len);
+        ASSERT_STR_EQUALS(expected, written.c_str());
+
+        /* the output reads back as the same document */
+        Aws::Crt::JsonObject parsed(written);
+        ASSERT_TRUE(parsed.WasParseSuccessful());
+        ASSERT_STR_EQUALS("b\"\n\x01", parsed.View().GetArray("tags")[1].AsString().c_str());
+
+        /* out of place calls break the writer and leave the buffer alone */
+        output.len = 0;
+        Aws::Crt::JsonWriter misused(output);
+        misused.BeginObject().WriteInt64(1).Key("a").WriteInt64(2);
+        ASSERT_FALSE(misused);
+        ASSERT_INT_EQUALS(AWS_ERROR_INVALID_STATE, misused.LastError());
+        ASSERT_UINT_EQUALS(1, output.len);
+
+        /* a buffer without an allocator is not grown */
+        uint8_t storage[8];
+        Aws::Crt::ByteBuf fixed = aws_byte_buf_from_empty_array(storage, sizeof(storage));
+        Aws::Crt::JsonWriter bounded(fixed);
+        bounded.BeginArray().WriteString("too long for it").EndArray();
+        ASSERT_FALSE(bounded);
+        ASSERT_INT_EQUALS(AWS_ERROR_SHORT_BUFFER, bounded.LastError());
+
+        aws_byte_buf_clean_up(&output);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(JsonWriter, s_JsonWriterTest)
+
+static int s_JsonObjectAllocatorTest(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::ArenaAllocator arena(1024, allocator);
+        const Aws::Crt::String jsonValue = "{\"items\":[{\"id\":1},{\"id\":2}],\"name\":\"arena\"}";
+        {
+            Aws::Crt::JsonObject parsed(jsonValue, Aws::Crt::JsonParserBackend::Indexed, arena.GetUnderlyingHandle());
+            ASSERT_TRUE(parsed.WasParseSuccessful());
+            ASSERT_PTR_EQUALS(arena.GetUnderlyingHandle(), parsed.GetAllocator());
+            size_t parsedBytes = arena.BytesAllocated();
+            ASSERT_TRUE(parsedBytes > 0);
+
+            /* building on the document allocates from the arena too */
+            parsed.WithString("extra", "value").WithInteger("count", 2);
+            ASSERT_TRUE(arena.BytesAllocated() > parsedBytes);
+
+            /* copies keep the allocator, moves carry it along */
+            Aws::Crt::JsonObject copy(parsed);
+            ASSERT_PTR_EQUALS(arena.GetUnderlyingHandle(), copy.GetAllocator());
+            Aws::Crt::JsonObject moved(std::move(copy));
+            ASSERT_PTR_EQUALS(arena.GetUnderlyingHandle(), moved.GetAllocator());
+            ASSERT_TRUE(moved == parsed);
+
+            /* nodes moved into a document on another allocator are copied, and released by their owner */
+            size_t arenaBytes = arena.BytesAllocated();
+            Aws::Crt::JsonObject heapDoc;
+            heapDoc.WithObject("nested", std::move(moved));
+            ASSERT_UINT_EQUALS(arenaBytes, arena.BytesAllocated());
+            ASSERT_STR_EQUALS("arena", heapDoc.View().GetJsonObject("nested").GetString("name").c_str());
+
+            Aws::Crt::Vector<Aws::Crt::JsonObject> elements;
+            elements.push_back(Aws::Crt::JsonObject(jsonValue, arena.GetUnderlyingHandle()));
+            elements.push_back(parsed);
+            heapDoc.WithArray("all", std::move(elements));
+            ASSERT_INT_EQUALS(2, heapDoc.View().GetArray("all")[1].GetInteger("count"));
+        }
+
+        ASSERT_TRUE(arena.BytesAllocated() > 0);
+        arena.Reset();
+        ASSERT_UINT_EQUALS(0, arena.BytesReserved());
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(JsonObjectAllocator, s_JsonObjectAllocatorTest)
+
+static int s_JsonKeyIndexTest(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::JsonObject wide("{\"dup\":1,\"dup\":2,\"none\":null,\"name\":\"wide\"}");
+        for (int i = 0; i < 200; ++i)
+        {
+            wide.WithInteger(Aws::Crt::String("key") + std::to_string(i).c_str(), i);
+        }
+
+        Aws::Crt::JsonKeyIndex index(wide.View(), Aws::Crt::JsonKeyIndex::DefaultThreshold, allocator);
+        ASSERT_TRUE(index.IsHashed());
+        for (int i = 0; i < 200; ++i)
+        {
+            Aws::Crt::String key = Aws::Crt::String("key") + std::to_string(i).c_str();
+            ASSERT_INT_EQUALS(i, index.Get(key.c_str()).AsInteger());
+        }
+        ASSERT_INT_EQUALS(1, index.Get("dup").AsInteger());
+        ASSERT_TRUE(index.GetStringView("name") == Aws::Crt::StringView("wide"));
+        ASSERT_TRUE(index.GetStringView("key1").empty());
+        ASSERT_TRUE(index.KeyExists("none"));
+        ASSERT_FALSE(index.ValueExists("none"));
+        ASSERT_FALSE(index.KeyExists("key200"));
+        ASSERT_FALSE(index.KeyExists("ke"));
+
+        /* small objects are searched in place, with the same results */
+        Aws::Crt::JsonObject narrow("{\"a\":1,\"b\":\"two\"}");
+        Aws::Crt::JsonKeyIndex narrowIndex(narrow.View());
+        ASSERT_FALSE(narrowIndex.IsHashed());
+        ASSERT_INT_EQUALS(1, narrowIndex.Get("a").AsInteger());
+        ASSERT_TRUE(narrowIndex.GetStringView("b") == Aws::Crt::StringView("two"));
+        ASSERT_FALSE(narrowIndex.KeyExists("c"));
+
+        /* anything but an object finds nothing */
+        Aws::Crt::JsonObject array("[1,2]");
+        Aws::Crt::JsonKeyIndex arrayIndex(array.View(), 0);
+        ASSERT_FALSE(arrayIndex.KeyExists("0"));
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(JsonKeyIndex, s_JsonKeyIndexTest)
+
+struct JsonMappingSample
+{
+    int64_t Timestamp = 0;
+    double Value = 0;
+};
+
+struct JsonMappingTelemetry
+{
+    Aws::Crt::String Id;
+    int Count = 0;
+    bool Healthy = false;
+    Aws::Crt::Vector<JsonMappingSample> Samples;
+    Aws::Crt::Optional<Aws::Crt::String> Note;
+};
+
+namespace Aws
+{
+    namespace Crt
+    {
+        template <> struct JsonMapping<JsonMappingSample>
+        {
+            template <typename Visitor, typename Object> static void Fields(Visitor &visit, Object &object)
+            {
+                visit("ts", object.Timestamp);
+                visit("value", object.Value);
+            }
+        };
+
+        template <> struct JsonMapping<JsonMappingTelemetry>
+        {
+            template <typename Visitor, typename Object> static void Fields(Visitor &visit, Object &object)
+            {
+                visit("id", object.Id);
+                visit("count", object.Count);
+                visit("healthy", object.Healthy);
+                visit("samples", object.Samples);
+                visit("note", object.Note);
+            }
+        };
+    } // namespace Crt
+} // namespace Aws
+
+static int s_JsonMappingRoundTripTest(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::JsonObject doc("{\"count\":3,\"id\":\"sensor-1\",\"unknown\":[1],\"healthy\":true,"
+                                 "\"samples\":[{\"ts\":1700000000000,\"value\":0.5},{\"value\":2,\"ts\":1}],"
+                                 "\"note\":null}");
+        ASSERT_TRUE(doc.WasParseSuccessful());
+
+        JsonMappingTelemetry telemetry;
+        telemetry.Note = Aws::Crt::String("stale");
+        ASSERT_TRUE(Aws::Crt::JsonDeserialize(doc.View(), telemetry));
+        ASSERT_STR_EQUALS("sensor-1", telemetry.Id.c_str());
+        ASSERT_INT_EQUALS(3, telemetry.Count);
+        ASSERT_TRUE(telemetry.Healthy);
+        ASSERT_UINT_EQUALS(2, telemetry.Samples.size());
+        ASSERT_INT_EQUALS(1700000000000LL, telemetry.Samples[0].Timestamp);
+        ASSERT_TRUE(telemetry.Samples[1].Value == 2.0);
+        ASSERT_FALSE(telemetry.Note.has_value());
+
+        /* written back, empty optionals are left out */
+        Aws::Crt::ByteBuf output;
+        ASSERT_SUCCESS(aws_byte_buf_init(&output, allocator, 128));
+        Aws::Crt::JsonWriter writer(output);
+        Aws::Crt::JsonSerialize(writer, telemetry);
+        ASSERT_TRUE(writer.IsComplete());
+        const char *expected = "{\"id\":\"sensor-1\",\"count\":3,\"healthy\":true,"
+                               "\"samples\":[{\"ts\":1700000000000,\"value\":0.5},{\"ts\":1,\"value\":2}]}";
+        Aws::Crt::String written(reinterpret_cast<const char *>(output.buffer), output.len);
+        ASSERT_STR_EQUALS(expected, written.c_str());
+        aws_byte_buf_clean_up(&output);
+
+        /* a member of the wrong type fails the read */
+        Aws::Crt::JsonObject mistyped("{\"count\":\"three\"}");
+        ASSERT_FALSE(Aws::Crt::JsonDeserialize(mistyped.View(), telemetry));
+        Aws::Crt::JsonObject overflowing("{\"count\":3000000000}");
+        ASSERT_FALSE(Aws::Crt::JsonDeserialize(overflowing.View(), telemetry));
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(JsonMappingRoundTrip, s_JsonMappingRoundTripTest)
+
+static int s_JsonSetAtPathTest(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::JsonObject shadow(
+            "{\"state\":{\"reported\":{\"color\":\"red\",\"leds\":[1,2]},\"desired\":7},\"version\":3}");
+        ASSERT_TRUE(shadow.WasParseSuccessful());
+
+        Aws::Crt::JsonObject color;
+        color.AsString("green");
+        ASSERT_TRUE(shadow.SetAtPath("/state/reported/color", std::move(color)));
+        Aws::Crt::JsonView reported = shadow.View().GetJsonObject("state").GetJsonObject("reported");
+        ASSERT_STR_EQUALS("green", reported.GetString("color").c_str());
+
+        /* missing objects are created, and a scalar on the way is replaced by an object */
+        Aws::Crt::JsonObject mode;
+        mode.AsString("eco");
+        ASSERT_TRUE(shadow.SetAtPath("/state/desired/power/mode", mode));
+        ASSERT_STR_EQUALS("eco", mode.View().AsString().c_str());
+
+        Aws::Crt::JsonObject led;
+        led.AsInteger(9);
+        ASSERT_TRUE(shadow.SetAtPath("/state/reported/leds/0", led));
+        ASSERT_TRUE(shadow.SetAtPath("/state/reported/leds/-", led));
+        ASSERT_TRUE(shadow.SetAtPath("/state/reported/leds/3", led));
+
+        Aws::Crt::JsonObject slash;
+        slash.AsBool(true);
+        ASSERT_TRUE(shadow.SetAtPath("/a~1b~0c", std::move(slash)));
+
+        Aws::Crt::JsonObject expected("{\"state\":{\"reported\":{\"color\":\"green\",\"leds\":[9,2,9,9]},"
+                                      "\"desired\":{\"power\":{\"mode\":\"eco\"}}},\"version\":3,\"a/b~c\":true}");
+        ASSERT_TRUE(expected == shadow);
+
+        /* failures leave the document and the value alone */
+        Aws::Crt::JsonObject kept;
+        kept.AsInteger(1);
+        ASSERT_FALSE(shadow.SetAtPath("/state/reported/leds/5", std::move(kept)));
+        ASSERT_INT_EQUALS(AWS_ERROR_INVALID_ARGUMENT, aws_last_error());
+        ASSERT_FALSE(shadow.SetAtPath("/state/reported/leds/01", std::move(kept)));
+        ASSERT_FALSE(shadow.SetAtPath("/state/reported/leds/x/y", std::move(kept)));
+        ASSERT_FALSE(shadow.SetAtPath("state", std::move(kept)));
+        ASSERT_FALSE(shadow.SetAtPath("/bad~2escape", std::move(kept)));
+        ASSERT_FALSE(shadow.SetAtPath("/newkey/bad~2", std::move(kept)));
+        ASSERT_FALSE(shadow.SetAtPath("/version/leds/x~", std::move(kept)));
+        ASSERT_FALSE(shadow.SetAtPath("/state/reported/leds/1/extra/~3", std::move(kept)));
+        ASSERT_TRUE(kept.View().IsIntegerType());
+        ASSERT_TRUE(expected == shadow);
+
+        Aws::Crt::JsonObject empty;
+        ASSERT_FALSE(empty.SetAtPath("/newkey/bad~2", std::move(kept)));
+        ASSERT_FALSE(empty.View().IsObject());
+
+        ASSERT_TRUE(shadow.SetAtPath("", std::move(kept)));
+        ASSERT_INT_EQUALS(1, shadow.View().AsInteger());
+
+        /* arrays built from moved objects, under a plain C string key */
+        Aws::Crt::Vector<Aws::Crt::JsonObject> items;
+        items.emplace_back(Aws::Crt::String("{\"id\":1}"));
+        items.emplace_back(Aws::Crt::String("{\"id\":2}"));
+        Aws::Crt::JsonObject list;
+        list.WithArray("items", std::move(items));
+        ASSERT_INT_EQUALS(2, list.View().GetArray("items")[1].GetInteger("id"));
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(JsonSetAtPath, s_JsonSetAtPathTest)
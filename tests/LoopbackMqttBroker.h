@@ -0,0 +1,164 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include "LoopbackServer.h"
+
+#include <aws/common/byte_buf.h>
+
+/*
+ * Just enough of an MQTT 3.1.1 broker for client tests on a LoopbackServer: it accepts every CONNECT, acknowledges
+ * QoS 1 publishes, and grants subscriptions at the QoS asked for unless the topic filter starts with "reject/", which
+ * gets 0x80. Publishes and subscriptions are recorded but not routed anywhere.
+ */
+class LoopbackMqttBroker : public LoopbackConnectionHandler
+{
+  public:
+    struct ReceivedPublish
+    {
+        Aws::Crt::String topic;
+        Aws::Crt::String payload;
+        uint8_t qos;
+    };
+
+    explicit LoopbackMqttBroker(Aws::Crt::Allocator *allocator) : LoopbackConnectionHandler(allocator) {}
+
+    Aws::Crt::Vector<ReceivedPublish> GetPublishes()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_publishes;
+    }
+
+    /* @return the number of SUBSCRIBE packets received, however many topics each carried. */
+    size_t GetSubscribePacketCount()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_subscribePackets;
+    }
+
+    Aws::Crt::Vector<Aws::Crt::String> GetSubscribedTopics()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_subscribedTopics;
+    }
+
+  protected:
+    void OnData(Aws::Crt::ByteCursor data) override
+    {
+        m_received.append(reinterpret_cast<const char *>(data.ptr), data.len);
+        while (true)
+        {
+            /* fixed header: type and flags, then a variable length integer */
+            if (m_received.size() < 2)
+            {
+                return;
+            }
+
+            size_t remainingLength = 0;
+            size_t headerLength = 1;
+            size_t multiplier = 1;
+            uint8_t lengthByte = 0;
+            do
+            {
+                if (headerLength >= m_received.size())
+                {
+                    return;
+                }
+                lengthByte = static_cast<uint8_t>(m_received[headerLength++]);
+                remainingLength += (lengthByte & 0x7F) * multiplier;
+                multiplier *= 128;
+            } while ((lengthByte & 0x80) != 0);
+
+            if (m_received.size() < headerLength + remainingLength)
+            {
+                return;
+            }
+
+            uint8_t typeAndFlags = static_cast<uint8_t>(m_received[0]);
+            Aws::Crt::String body = m_received.substr(headerLength, remainingLength);
+            m_received.erase(0, headerLength + remainingLength);
+            OnPacket(typeAndFlags, body);
+        }
+    }
+
+  private:
+    static uint16_t s_ReadU16(const Aws::Crt::String &body, size_t offset)
+    {
+        return static_cast<uint16_t>(
+            (static_cast<uint8_t>(body[offset]) << 8) | static_cast<uint8_t>(body[offset + 1]));
+    }
+
+    void Reply(std::initializer_list<uint8_t> header, const Aws::Crt::String &rest = Aws::Crt::String())
+    {
+        Aws::Crt::String packet(header.begin(), header.end());
+        packet += rest;
+        Write(aws_byte_cursor_from_array(packet.data(), packet.size()));
+    }
+
+    void OnPacket(uint8_t typeAndFlags, const Aws::Crt::String &body)
+    {
+        switch (typeAndFlags >> 4)
+        {
+            case 1: /* CONNECT */
+                Reply({0x20, 0x02, 0x00, 0x00});
+                break;
+            case 3: /* PUBLISH */
+            {
+                uint8_t qos = (typeAndFlags >> 1) & 0x03;
+                uint16_t topicLength = s_ReadU16(body, 0);
+                size_t offset = 2 + topicLength;
+                ReceivedPublish publish;
+                publish.topic = body.substr(2, topicLength);
+                publish.qos = qos;
+                if (qos > 0)
+                {
+                    Reply({0x40, 0x02, static_cast<uint8_t>(body[offset]), static_cast<uint8_t>(body[offset + 1])});
+                    offset += 2;
+                }
+                publish.payload = body.substr(offset);
+
+                std::lock_guard<std::mutex> lock(m_lock);
+                m_publishes.push_back(publish);
+                break;
+            }
+            case 8: /* SUBSCRIBE */
+            {
+                Aws::Crt::String grants;
+                size_t offset = 2;
+                std::lock_guard<std::mutex> lock(m_lock);
+                while (offset + 2 <= body.size())
+                {
+                    uint16_t topicLength = s_ReadU16(body, offset);
+                    Aws::Crt::String topic = body.substr(offset + 2, topicLength);
+                    uint8_t requestedQos = static_cast<uint8_t>(body[offset + 2 + topicLength]);
+                    offset += 3 + topicLength;
+
+                    grants += static_cast<char>(topic.compare(0, 7, "reject/") == 0 ? 0x80 : requestedQos);
+                    m_subscribedTopics.push_back(topic);
+                }
+                ++m_subscribePackets;
+                Reply(
+                    {0x90, static_cast<uint8_t>(2 + grants.size()), static_cast<uint8_t>(body[0]),
+                     static_cast<uint8_t>(body[1])},
+                    grants);
+                break;
+            }
+            case 10: /* UNSUBSCRIBE */
+                Reply({0xB0, 0x02, static_cast<uint8_t>(body[0]), static_cast<uint8_t>(body[1])});
+                break;
+            case 12: /* PINGREQ */
+                Reply({0xD0, 0x00});
+                break;
+            default:
+                break;
+        }
+    }
+
+    Aws::Crt::String m_received;
+
+    std::mutex m_lock;
+    Aws::Crt::Vector<ReceivedPublish> m_publishes;
+    Aws::Crt::Vector<Aws::Crt::String> m_subscribedTopics;
+    size_t m_subscribePackets = 0;
+};
@@ -0,0 +1,303 @@
+#pragma once
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/io/ChannelHandler.h>
+#include <aws/crt/io/EventLoopGroup.h>
+#include <aws/crt/io/SocketOptions.h>
+
+#include <aws/io/channel.h>
+#include <aws/io/channel_bootstrap.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <random>
+
+/*
+ * Server end of one LoopbackServer connection. Reads are handed to OnData() and consumed at once; Write() sends
+ * back to the client. Everything but Write() from other threads runs on the channel's thread.
+ */
+class LoopbackConnectionHandler : public Aws::Crt::Io::ChannelHandler
+{
+  public:
+    explicit LoopbackConnectionHandler(Aws::Crt::Allocator *allocator) : Aws::Crt::Io::ChannelHandler(allocator) {}
+
+    /* Copies data and writes it to the client from the channel's thread. */
+    void Write(Aws::Crt::ByteCursor data)
+    {
+        Aws::Crt::String copy(reinterpret_cast<const char *>(data.ptr), data.len);
+        if (ChannelsThreadIsCallersThread())
+        {
+            WriteNow(copy);
+            return;
+        }
+
+        ScheduleTask([this, copy](Aws::Crt::Io::TaskStatus status) {
+            if (status == Aws::Crt::Io::TaskStatus::RunReady)
+            {
+                WriteNow(copy);
+            }
+        });
+    }
+
+  protected:
+    /* Called with each chunk the client sends, on the channel's thread. */
+    virtual void OnData(Aws::Crt::ByteCursor data) { (void)data; }
+
+    int ProcessReadMessage(struct aws_io_message *message) override
+    {
+        size_t length = message->message_data.len;
+        OnData(aws_byte_cursor_from_buf(&message->message_data));
+        aws_mem_release(message->allocator, message);
+        IncrementUpstreamReadWindow(length);
+        return AWS_OP_SUCCESS;
+    }
+
+    int ProcessWriteMessage(struct aws_io_message *) override { return aws_raise_error(AWS_ERROR_UNIMPLEMENTED); }
+
+    int IncrementReadWindow(size_t) override { return AWS_OP_SUCCESS; }
+
+    void ProcessShutdown(Aws::Crt::Io::ChannelDirection dir, int errorCode, bool freeScarceResourcesImmediately)
+        override
+    {
+        OnShutdownComplete(dir, errorCode, freeScarceResourcesImmediately);
+    }
+
+    size_t InitialWindowSize() override { return 64 * 1024; }
+
+    size_t MessageOverhead() override { return 0; }
+
+  private:
+    void WriteNow(const Aws::Crt::String &data)
+    {
+        size_t written = 0;
+        while (written < data.size())
+        {
+            struct aws_io_message *message =
+                AcquireMessageFromPool(Aws::Crt::Io::MessageType::ApplicationData, data.size() - written);
+            if (message == nullptr)
+            {
+                return;
+            }
+
+            size_t chunk = std::min(data.size() - written, message->message_data.capacity);
+            Aws::Crt::ByteCursor chunkCursor =
+                aws_byte_cursor_from_array(reinterpret_cast<const uint8_t *>(data.data()) + written, chunk);
+            aws_byte_buf_append(&message->message_data, &chunkCursor);
+            if (!SendMessage(message, Aws::Crt::Io::ChannelDirection::Write))
+            {
+                aws_mem_release(message->allocator, message);
+                return;
+            }
+            written += chunk;
+        }
+    }
+};
+
+/*
+ * Answers HTTP/1.1 requests without a body, such as GETs, with whatever respond() makes of each request head. The
+ * connection is kept open for further requests.
+ */
+class LoopbackHttpResponder : public LoopbackConnectionHandler
+{
+  public:
+    using Respond = std::function<Aws::Crt::String(const Aws::Crt::String &requestHead)>;
+
+    LoopbackHttpResponder(Aws::Crt::Allocator *allocator, Respond respond)
+        : LoopbackConnectionHandler(allocator), m_respond(std::move(respond))
+    {
+    }
+
+    /* @return the first line of a request head, e.g. "GET /path HTTP/1.1". */
+    static Aws::Crt::String RequestLine(const Aws::Crt::String &requestHead)
+    {
+        return requestHead.substr(0, requestHead.find("\r\n"));
+    }
+
+  protected:
+    void OnData(Aws::Crt::ByteCursor data) override
+    {
+        m_received.append(reinterpret_cast<const char *>(data.ptr), data.len);
+        size_t headEnd = 0;
+        while ((headEnd = m_received.find("\r\n\r\n")) != Aws::Crt::String::npos)
+        {
+            Aws::Crt::String requestHead = m_received.substr(0, headEnd + 4);
+            m_received.erase(0, headEnd + 4);
+            Aws::Crt::String response = m_respond(requestHead);
+            Write(aws_byte_cursor_from_array(response.data(), response.size()));
+        }
+    }
+
+  private:
+    Respond m_respond;
+    Aws::Crt::String m_received;
+};
+
+/*
+ * TCP listener on 127.0.0.1 for tests that need a peer without going out to the network. Each accepted connection
+ * gets a handler from the factory, a LoopbackConnectionHandler that discards what it reads by default.
+ */
+class LoopbackServer
+{
+  public:
+    using HandlerFactory = std::function<std::shared_ptr<LoopbackConnectionHandler>()>;
+
+    LoopbackServer(
+        Aws::Crt::Io::EventLoopGroup &eventLoopGroup,
+        HandlerFactory handlerFactory = HandlerFactory(),
+        Aws::Crt::Allocator *allocator = Aws::Crt::g_allocator)
+        : m_allocator(allocator), m_handlerFactory(std::move(handlerFactory)), m_bootstrap(nullptr),
+          m_listener(nullptr), m_port(0), m_destroyed(false)
+    {
+        m_bootstrap = aws_server_bootstrap_new(allocator, eventLoopGroup.GetUnderlyingHandle());
+    }
+
+    LoopbackServer(const LoopbackServer &) = delete;
+    LoopbackServer &operator=(const LoopbackServer &) = delete;
+
+    ~LoopbackServer()
+    {
+        Close();
+        if (m_bootstrap != nullptr)
+        {
+            aws_server_bootstrap_release(m_bootstrap);
+        }
+    }
+
+    /* Starts listening on a free port. */
+    bool Listen()
+    {
+        if (m_bootstrap == nullptr)
+        {
+            return false;
+        }
+
+        Aws::Crt::Io::SocketOptions socketOptions;
+        socketOptions.SetSocketDomain(Aws::Crt::Io::SocketDomain::IPv4);
+        socketOptions.SetConnectTimeoutMs(3000);
+
+        std::random_device randomDevice;
+        std::uniform_int_distribution<int> ports(20000, 59999);
+        for (int attempt = 0; attempt < 32 && m_listener == nullptr; ++attempt)
+        {
+            uint16_t port = static_cast<uint16_t>(ports(randomDevice));
+
+            struct aws_server_socket_channel_bootstrap_options options;
+            AWS_ZERO_STRUCT(options);
+            options.bootstrap = m_bootstrap;
+            options.host_name = GetHostName();
+            options.port = port;
+            options.socket_options = &socketOptions.GetImpl();
+            options.incoming_callback = s_OnIncomingChannel;
+            options.shutdown_callback = s_OnChannelShutdown;
+            options.destroy_callback = s_OnListenerDestroyed;
+            options.user_data = this;
+
+            m_listener = aws_server_bootstrap_new_socket_listener(&options);
+            if (m_listener != nullptr)
+            {
+                m_port = port;
+            }
+            else if (aws_last_error() != AWS_IO_SOCKET_ADDRESS_IN_USE)
+            {
+                return false;
+            }
+        }
+
+        return m_listener != nullptr;
+    }
+
+    /* Stops listening and waits until every accepted connection has shut down. */
+    void Close()
+    {
+        if (m_listener == nullptr)
+        {
+            return;
+        }
+
+        aws_server_bootstrap_destroy_socket_listener(m_bootstrap, m_listener);
+        m_listener = nullptr;
+
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_signal.wait(lock, [this]() { return m_destroyed; });
+        m_handlers.clear();
+    }
+
+    const char *GetHostName() const { return "127.0.0.1"; }
+
+    uint16_t GetPort() const { return m_port; }
+
+    /* Waits up to timeout for count connections to have been accepted. */
+    bool WaitForConnections(size_t count, std::chrono::milliseconds timeout = std::chrono::seconds(10))
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        return m_signal.wait_for(lock, timeout, [this, count]() { return m_handlers.size() >= count; });
+    }
+
+    /* @return the handler of the index-th connection accepted, or nullptr. */
+    std::shared_ptr<LoopbackConnectionHandler> GetHandler(size_t index)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return index < m_handlers.size() ? m_handlers[index] : nullptr;
+    }
+
+  private:
+    static void s_OnIncomingChannel(
+        struct aws_server_bootstrap *,
+        int errorCode,
+        struct aws_channel *channel,
+        void *userData)
+    {
+        auto *server = static_cast<LoopbackServer *>(userData);
+        if (errorCode != AWS_ERROR_SUCCESS)
+        {
+            return;
+        }
+
+        std::shared_ptr<LoopbackConnectionHandler> handler =
+            server->m_handlerFactory ? server->m_handlerFactory()
+                                     : Aws::Crt::MakeShared<LoopbackConnectionHandler>(
+                                           server->m_allocator, server->m_allocator);
+
+        struct aws_channel_slot *slot = aws_channel_slot_new(channel);
+        if (handler == nullptr || slot == nullptr || aws_channel_slot_insert_end(channel, slot) ||
+            aws_channel_slot_set_handler(slot, handler->SeatForCInterop(handler)))
+        {
+            aws_channel_shutdown(channel, aws_last_error());
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(server->m_lock);
+            server->m_handlers.push_back(handler);
+        }
+        server->m_signal.notify_all();
+    }
+
+    static void s_OnChannelShutdown(struct aws_server_bootstrap *, int, struct aws_channel *, void *) {}
+
+    static void s_OnListenerDestroyed(struct aws_server_bootstrap *, void *userData)
+    {
+        auto *server = static_cast<LoopbackServer *>(userData);
+        {
+            std::lock_guard<std::mutex> lock(server->m_lock);
+            server->m_destroyed = true;
+        }
+        server->m_signal.notify_all();
+    }
+
+    Aws::Crt::Allocator *m_allocator;
+    HandlerFactory m_handlerFactory;
+    struct aws_server_bootstrap *m_bootstrap;
+    struct aws_socket *m_listener;
+    uint16_t m_port;
+
+    std::mutex m_lock;
+    std::condition_variable m_signal;
+    bool m_destroyed;
+    Aws::Crt::Vector<std::shared_ptr<LoopbackConnectionHandler>> m_handlers;
+};
@@ -0,0 +1,114 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/Api.h>
+#include <aws/crt/mqtt/MqttChunkedTransfer.h>
+
+#include <aws/testing/aws_test_harness.h>
+
+#include <cstring>
+
+static Aws::Crt::Vector<uint8_t> s_MakeChunk(
+    uint32_t transferId,
+    const char *payload,
+    uint32_t chunkSize,
+    uint32_t chunkIndex)
+{
+    uint32_t totalLength = static_cast<uint32_t>(strlen(payload));
+    uint32_t offset = chunkIndex * chunkSize;
+    uint32_t length = totalLength - offset < chunkSize ? totalLength - offset : chunkSize;
+
+    Aws::Crt::Vector<uint8_t> chunk(Aws::Crt::Mqtt::MQTT_CHUNK_HEADER_LENGTH + length);
+    Aws::Crt::ByteBuf buffer = aws_byte_buf_from_empty_array(chunk.data(), chunk.size());
+    aws_byte_buf_write_u8(&buffer, 0xc7);
+    aws_byte_buf_write_u8(&buffer, 1);
+    aws_byte_buf_write_be16(&buffer, 0);
+    aws_byte_buf_write_be32(&buffer, transferId);
+    aws_byte_buf_write_be32(&buffer, totalLength);
+    aws_byte_buf_write_be32(&buffer, chunkSize);
+    aws_byte_buf_write_be32(&buffer, chunkIndex);
+    aws_byte_buf_write(&buffer, reinterpret_cast<const uint8_t *>(payload) + offset, length);
+    return chunk;
+}
+
+static int s_TestMqttChunkReassemblerOutOfOrder(Aws::Crt::Allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::Io::EventLoopGroup eventLoopGroup(1, allocator);
+        ASSERT_TRUE(eventLoopGroup);
+        Aws::Crt::Io::DefaultHostResolver defaultHostResolver(eventLoopGroup, 8, 30, allocator);
+        ASSERT_TRUE(defaultHostResolver);
+        Aws::Crt::Io::ClientBootstrap clientBootstrap(eventLoopGroup, defaultHostResolver, allocator);
+        clientBootstrap.EnableBlockingShutdown();
+
+        Aws::Crt::Mqtt::MqttClient mqttClient(clientBootstrap, allocator);
+        ASSERT_TRUE(mqttClient);
+        Aws::Crt::Io::SocketOptions socketOptions;
+        auto mqttConnection = mqttClient.NewConnection("localhost", 1883, socketOptions);
+        ASSERT_NOT_NULL(mqttConnection);
+
+        Aws::Crt::Mqtt::MqttChunkedPublisher publisher(mqttConnection, 4, allocator);
+        ASSERT_UINT_EQUALS(3, publisher.GetChunkCount(10));
+        ASSERT_UINT_EQUALS(1, publisher.GetChunkCount(0));
+
+        Aws::Crt::Vector<Aws::Crt::String> received;
+        Aws::Crt::Mqtt::MqttChunkReassembler reassembler(
+            [&received](Aws::Crt::Mqtt::MqttConnection &, Aws::Crt::StringView, const Aws::Crt::ByteCursor &payload) {
+                received.emplace_back(reinterpret_cast<const char *>(payload.ptr), payload.len);
+            },
+            1024,
+            2,
+            allocator);
+
+        /* two transfers on one topic, interleaved, out of order, with a duplicate */
+        const char *first = "0123456789";
+        const char *second = "abcdefghij";
+        auto feed = [&](uint32_t transferId, const char *payload, uint32_t chunkIndex) {
+            auto chunk = s_MakeChunk(transferId, payload, 4, chunkIndex);
+            return reassembler.OnChunk(
+                *mqttConnection, "large/object", aws_byte_cursor_from_array(chunk.data(), chunk.size()));
+        };
+
+        ASSERT_TRUE(feed(1, first, 2));
+        ASSERT_TRUE(feed(2, second, 0));
+        ASSERT_TRUE(feed(1, first, 0));
+        ASSERT_TRUE(feed(1, first, 0));
+        ASSERT_TRUE(received.empty());
+        ASSERT_TRUE(feed(2, second, 2));
+        ASSERT_TRUE(feed(1, first, 1));
+        ASSERT_UINT_EQUALS(1, received.size());
+        ASSERT_TRUE(received[0] == first);
+        ASSERT_TRUE(feed(2, second, 1));
+        ASSERT_UINT_EQUALS(2, received.size());
+        ASSERT_TRUE(received[1] == second);
+
+        /* a late duplicate of a completed transfer does not start it over */
+        ASSERT_TRUE(feed(1, first, 2));
+
+        /* a payload that fits in one chunk is delivered right away */
+        ASSERT_TRUE(feed(3, "tiny", 0));
+        ASSERT_UINT_EQUALS(3, received.size());
+        ASSERT_TRUE(received[2] == "tiny");
+
+        /* a chunk whose length does not match its header is rejected */
+        auto truncated = s_MakeChunk(4, first, 4, 0);
+        truncated.pop_back();
+        ASSERT_FALSE(reassembler.OnChunk(
+            *mqttConnection, "large/object", aws_byte_cursor_from_array(truncated.data(), truncated.size())));
+
+        Aws::Crt::Mqtt::MqttChunkReassemblerMetrics metrics = reassembler.GetMetrics();
+        ASSERT_UINT_EQUALS(0, metrics.PendingTransfers);
+        ASSERT_UINT_EQUALS(0, metrics.PendingBytes);
+        ASSERT_UINT_EQUALS(3, metrics.CompletedTransfers);
+        ASSERT_UINT_EQUALS(2, metrics.DuplicateChunks);
+        ASSERT_UINT_EQUALS(1, metrics.RejectedChunks);
+    }
+
+    return AWS_ERROR_SUCCESS;
+}
+
+AWS_TEST_CASE(MqttChunkReassemblerOutOfOrder, s_TestMqttChunkReassemblerOutOfOrder)
@@ -6,6 +6,13 @@
 
 #include <aws/testing/aws_test_harness.h>
 
+#include "LoopbackMqttBroker.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <utility>
 #if !BYO_CRYPTO
 static int s_TestMqttClientResourceSafety(Aws::Crt::Allocator *allocator, void *ctx)
@@ -41,6 +48,7 @@ static int s_TestMqttClientResourceSafety(Aws::Crt::Allocator *allocator, void *
 
         mqttConnection->SetOnMessageHandler(
             [](Aws::Crt::Mqtt::MqttConnection &, const Aws::Crt::String &, const Aws::Crt::ByteBuf &) {});
+        ASSERT_TRUE(mqttConnection->SetOnMessageHandler(nullptr));
         mqttConnection->Disconnect();
         ASSERT_TRUE(mqttConnection);
 
@@ -90,3 +98,242 @@ static int s_TestMqttClientNewConnectionUninitializedTlsContext(Aws::Crt::Alloca
 
 AWS_TEST_CASE(MqttClientNewConnectionUninitializedTlsContext, s_TestMqttClientNewConnectionUninitializedTlsContext)
 #endif // !BYO_CRYPTO
+
+/*
+ * Queues a QoS 1 publish and a subscribe before connecting to a local broker, so that both are counted as incomplete,
+ * then connects and runs an unsubscribe and a QoS 0 publish. Once everything completes, the counters must be back
+ * to zero, with one latency sample for the acknowledged publish.
+ */
+static int s_TestMqttConnectionOperationStatistics(Aws::Crt::Allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::Io::EventLoopGroup eventLoopGroup(1, allocator);
+        ASSERT_TRUE(eventLoopGroup);
+        Aws::Crt::Io::DefaultHostResolver defaultHostResolver(eventLoopGroup, 8, 30, allocator);
+        ASSERT_TRUE(defaultHostResolver);
+        Aws::Crt::Io::ClientBootstrap clientBootstrap(eventLoopGroup, defaultHostResolver, allocator);
+        clientBootstrap.EnableBlockingShutdown();
+
+        LoopbackServer server(
+            eventLoopGroup,
+            [allocator]() { return Aws::Crt::MakeShared<LoopbackMqttBroker>(allocator, allocator); },
+            allocator);
+        ASSERT_TRUE(server.Listen());
+
+        Aws::Crt::Mqtt::MqttClient mqttClient(clientBootstrap, allocator);
+        ASSERT_TRUE(mqttClient);
+        Aws::Crt::Io::SocketOptions socketOptions;
+        auto mqttConnection = mqttClient.NewConnection(server.GetHostName(), server.GetPort(), socketOptions);
+        ASSERT_NOT_NULL(mqttConnection);
+
+        std::mutex lock;
+        std::condition_variable signal;
+        bool disconnected = false;
+        size_t completed = 0;
+        int errors = 0;
+
+        mqttConnection->OnDisconnect = [&](Aws::Crt::Mqtt::MqttConnection &) {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                disconnected = true;
+            }
+            signal.notify_all();
+        };
+        auto onComplete = [&](Aws::Crt::Mqtt::MqttConnection &, uint16_t, int errorCode) {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                ++completed;
+                errors += errorCode != AWS_ERROR_SUCCESS ? 1 : 0;
+            }
+            signal.notify_all();
+        };
+        auto onSubAck = [&](Aws::Crt::Mqtt::MqttConnection &connection,
+                            uint16_t packetId,
+                            const Aws::Crt::String &,
+                            Aws::Crt::Mqtt::QOS,
+                            int errorCode) { onComplete(connection, packetId, errorCode); };
+
+        Aws::Crt::Mqtt::MqttConnectionStatistics statistics = mqttConnection->GetOperationStatistics();
+        ASSERT_UINT_EQUALS(0, statistics.IncompleteOperationCount);
+        ASSERT_UINT_EQUALS(0, statistics.CompletedOperationCount);
+
+        /* offline, both stay queued */
+        Aws::Crt::ByteBuf payload = Aws::Crt::ByteBufFromCString("hello");
+        ASSERT_TRUE(mqttConnection->Publish("stats/qos1", AWS_MQTT_QOS_AT_LEAST_ONCE, false, payload, onComplete));
+        ASSERT_TRUE(mqttConnection->Subscribe("stats/#", AWS_MQTT_QOS_AT_LEAST_ONCE, nullptr, onSubAck));
+
+        statistics = mqttConnection->GetOperationStatistics();
+        ASSERT_UINT_EQUALS(2, statistics.IncompleteOperationCount);
+        /* "stats/qos1" and "hello", then "stats/#" */
+        ASSERT_UINT_EQUALS(22, statistics.IncompleteOperationBytes);
+        ASSERT_UINT_EQUALS(1, statistics.UnackedPublishCount);
+
+        ASSERT_TRUE(mqttConnection->Connect("operation-statistics", true));
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            ASSERT_TRUE(signal.wait_for(guard, std::chrono::seconds(10), [&]() { return completed == 2; }));
+        }
+
+        ASSERT_TRUE(mqttConnection->Unsubscribe("stats/#", onComplete));
+        ASSERT_TRUE(mqttConnection->Publish("stats/qos0", AWS_MQTT_QOS_AT_MOST_ONCE, false, payload, onComplete));
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            ASSERT_TRUE(signal.wait_for(guard, std::chrono::seconds(10), [&]() { return completed == 4; }));
+            ASSERT_INT_EQUALS(0, errors);
+        }
+
+        statistics = mqttConnection->GetOperationStatistics();
+        ASSERT_UINT_EQUALS(0, statistics.IncompleteOperationCount);
+        ASSERT_UINT_EQUALS(0, statistics.IncompleteOperationBytes);
+        ASSERT_UINT_EQUALS(0, statistics.UnackedPublishCount);
+        ASSERT_UINT_EQUALS(4, statistics.CompletedOperationCount);
+        ASSERT_UINT_EQUALS(0, statistics.FailedOperationCount);
+        ASSERT_UINT_EQUALS(0, statistics.InterruptionCount);
+        ASSERT_UINT_EQUALS(0, statistics.ResumptionCount);
+
+        /* only the QoS 1 publish waited for an acknowledgement */
+        uint64_t latencySamples = 0;
+        for (uint64_t bucket : statistics.PublishLatencyBuckets)
+        {
+            latencySamples += bucket;
+        }
+        ASSERT_UINT_EQUALS(1, latencySamples);
+        ASSERT_TRUE(statistics.TotalPublishLatencyNs > 0);
+
+        ASSERT_TRUE(server.WaitForConnections(1));
+        auto broker = std::static_pointer_cast<LoopbackMqttBroker>(server.GetHandler(0));
+        ASSERT_UINT_EQUALS(2, broker->GetPublishes().size());
+
+        ASSERT_TRUE(mqttConnection->Disconnect());
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            signal.wait(guard, [&]() { return disconnected; });
+        }
+    }
+
+    return AWS_ERROR_SUCCESS;
+}
+
+AWS_TEST_CASE(MqttConnectionOperationStatistics, s_TestMqttConnectionOperationStatistics)
+
+/* The owner is released on the event loop right after the completion callback returns. */
+static bool s_WaitForRelease(const std::weak_ptr<const void> &owner)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!owner.expired())
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+        {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    return true;
+}
+
+/*
+ * Publishes a payload owned by a shared_ptr the test lets go of right away. The publish must keep it alive while it is
+ * queued, until its completion callback has run, and drop it afterwards. A publish that cannot be queued drops it
+ * before returning.
+ */
+static int s_TestMqttConnectionPublishPayloadOwner(Aws::Crt::Allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::Io::EventLoopGroup eventLoopGroup(1, allocator);
+        ASSERT_TRUE(eventLoopGroup);
+        Aws::Crt::Io::DefaultHostResolver defaultHostResolver(eventLoopGroup, 8, 30, allocator);
+        ASSERT_TRUE(defaultHostResolver);
+        Aws::Crt::Io::ClientBootstrap clientBootstrap(eventLoopGroup, defaultHostResolver, allocator);
+        clientBootstrap.EnableBlockingShutdown();
+
+        LoopbackServer server(
+            eventLoopGroup,
+            [allocator]() { return Aws::Crt::MakeShared<LoopbackMqttBroker>(allocator, allocator); },
+            allocator);
+        ASSERT_TRUE(server.Listen());
+
+        Aws::Crt::Mqtt::MqttClient mqttClient(clientBootstrap, allocator);
+        ASSERT_TRUE(mqttClient);
+        Aws::Crt::Io::SocketOptions socketOptions;
+        auto mqttConnection = mqttClient.NewConnection(server.GetHostName(), server.GetPort(), socketOptions);
+        ASSERT_NOT_NULL(mqttConnection);
+
+        std::mutex lock;
+        std::condition_variable signal;
+        bool disconnected = false;
+        bool completed = false;
+        int completionError = -1;
+        bool ownerAliveOnCompletion = false;
+
+        mqttConnection->OnDisconnect = [&](Aws::Crt::Mqtt::MqttConnection &) {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                disconnected = true;
+            }
+            signal.notify_all();
+        };
+
+        auto payloadString = Aws::Crt::MakeShared<Aws::Crt::String>(allocator, "owned payload");
+        Aws::Crt::ByteCursor payload = Aws::Crt::ByteCursorFromCString(payloadString->c_str());
+        std::weak_ptr<const void> weakOwner = payloadString;
+        auto onComplete = [&](Aws::Crt::Mqtt::MqttConnection &, uint16_t, int errorCode) {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                ownerAliveOnCompletion = !weakOwner.expired();
+                completionError = errorCode;
+                completed = true;
+            }
+            signal.notify_all();
+        };
+
+        /* queued while offline, the publish holds the only reference */
+        ASSERT_TRUE(mqttConnection->Publish(
+            "owner/qos1", AWS_MQTT_QOS_AT_LEAST_ONCE, false, std::move(payloadString), payload, onComplete));
+        ASSERT_NULL(payloadString.get());
+        ASSERT_FALSE(weakOwner.expired());
+
+        ASSERT_TRUE(mqttConnection->Connect("payload-owner", true));
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            ASSERT_TRUE(signal.wait_for(guard, std::chrono::seconds(10), [&]() { return completed; }));
+            ASSERT_SUCCESS(completionError);
+            ASSERT_TRUE(ownerAliveOnCompletion);
+        }
+        ASSERT_TRUE(s_WaitForRelease(weakOwner));
+
+        ASSERT_TRUE(server.WaitForConnections(1));
+        auto broker = std::static_pointer_cast<LoopbackMqttBroker>(server.GetHandler(0));
+        auto publishes = broker->GetPublishes();
+        ASSERT_UINT_EQUALS(1, publishes.size());
+        ASSERT_STR_EQUALS("owned payload", publishes[0].payload.c_str());
+
+        /* a topic with a wildcard is rejected before anything is queued, and the callback is never invoked */
+        auto rejectedOwner = Aws::Crt::MakeShared<Aws::Crt::String>(allocator, "rejected payload");
+        payload = Aws::Crt::ByteCursorFromCString(rejectedOwner->c_str());
+        weakOwner = rejectedOwner;
+        completed = false;
+        ASSERT_UINT_EQUALS(
+            0,
+            mqttConnection->Publish(
+                "owner/#", AWS_MQTT_QOS_AT_LEAST_ONCE, false, std::move(rejectedOwner), payload, onComplete));
+        ASSERT_TRUE(weakOwner.expired());
+
+        ASSERT_TRUE(mqttConnection->Disconnect());
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            signal.wait(guard, [&]() { return disconnected; });
+            ASSERT_FALSE(completed);
+        }
+    }
+
+    return AWS_ERROR_SUCCESS;
+}
+
+AWS_TEST_CASE(MqttConnectionPublishPayloadOwner, s_TestMqttConnectionPublishPayloadOwner)
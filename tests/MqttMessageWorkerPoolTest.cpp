@@ -0,0 +1,114 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/Api.h>
+#include <aws/crt/mqtt/MessageWorkerPool.h>
+
+#include <aws/testing/aws_test_harness.h>
+
+#include <future>
+
+static int s_TestMqttMessageWorkerPoolOrdering(Aws::Crt::Allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::Io::EventLoopGroup eventLoopGroup(1, allocator);
+        ASSERT_TRUE(eventLoopGroup);
+        Aws::Crt::Io::DefaultHostResolver defaultHostResolver(eventLoopGroup, 8, 30, allocator);
+        ASSERT_TRUE(defaultHostResolver);
+        Aws::Crt::Io::ClientBootstrap clientBootstrap(eventLoopGroup, defaultHostResolver, allocator);
+        clientBootstrap.EnableBlockingShutdown();
+
+        Aws::Crt::Mqtt::MqttClient mqttClient(clientBootstrap, allocator);
+        ASSERT_TRUE(mqttClient);
+        Aws::Crt::Io::SocketOptions socketOptions;
+        auto mqttConnection = mqttClient.NewConnection("localhost", 1883, socketOptions);
+        ASSERT_NOT_NULL(mqttConnection);
+
+        const int messagesPerTopic = 100;
+        std::mutex receivedLock;
+        Aws::Crt::Vector<int> received[2];
+        {
+            Aws::Crt::Mqtt::MessageWorkerPoolOptions options;
+            options.ThreadCount = 4;
+            Aws::Crt::Mqtt::MessageWorkerPool pool(options, allocator);
+            ASSERT_TRUE(pool);
+
+            auto onMessage = pool.Wrap([&](Aws::Crt::Mqtt::MqttConnection &,
+                                           const Aws::Crt::String &topic,
+                                           const Aws::Crt::ByteBuf &payload,
+                                           bool,
+                                           Aws::Crt::Mqtt::QOS,
+                                           bool) {
+                int value = 0;
+                memcpy(&value, payload.buffer, sizeof(value));
+                std::lock_guard<std::mutex> lock(receivedLock);
+                received[topic == "b" ? 1 : 0].push_back(value);
+            });
+
+            for (int i = 0; i < messagesPerTopic; ++i)
+            {
+                Aws::Crt::ByteCursor payload = aws_byte_cursor_from_array(&i, sizeof(i));
+                onMessage(*mqttConnection, "a", payload, false, AWS_MQTT_QOS_AT_LEAST_ONCE, false);
+                onMessage(*mqttConnection, "b", payload, false, AWS_MQTT_QOS_AT_LEAST_ONCE, false);
+            }
+
+            pool.Drain();
+            auto metrics = pool.GetMetrics();
+            ASSERT_UINT_EQUALS(2 * messagesPerTopic, metrics.Enqueued);
+            ASSERT_UINT_EQUALS(2 * messagesPerTopic, metrics.Handled);
+            ASSERT_UINT_EQUALS(0, metrics.Dropped);
+            ASSERT_UINT_EQUALS(0, metrics.QueuedMessages);
+        }
+
+        /* messages on one topic are handled in the order they arrived */
+        for (const auto &topicReceived : received)
+        {
+            ASSERT_UINT_EQUALS(messagesPerTopic, topicReceived.size());
+            for (int i = 0; i < messagesPerTopic; ++i)
+            {
+                ASSERT_INT_EQUALS(i, topicReceived[i]);
+            }
+        }
+
+        /* with the only slot taken by a handler still running, later messages are dropped */
+        Aws::Crt::Mqtt::MessageWorkerPoolOptions options;
+        options.ThreadCount = 1;
+        options.MaxQueuedMessages = 1;
+        Aws::Crt::Mqtt::MessageWorkerPool pool(options, allocator);
+        ASSERT_TRUE(pool);
+
+        std::promise<void> release;
+        std::shared_future<void> released(release.get_future());
+        auto onMessage = pool.Wrap(
+            [released](
+                Aws::Crt::Mqtt::MqttConnection &,
+                const Aws::Crt::String &,
+                const Aws::Crt::ByteBuf &,
+                bool,
+                Aws::Crt::Mqtt::QOS,
+                bool) { released.wait(); });
+
+        auto payload = Aws::Crt::ByteCursorFromCString("payload");
+        for (int i = 0; i < 3; ++i)
+        {
+            onMessage(*mqttConnection, "a", payload, false, AWS_MQTT_QOS_AT_MOST_ONCE, false);
+        }
+
+        auto metrics = pool.GetMetrics();
+        ASSERT_UINT_EQUALS(1, metrics.Enqueued);
+        ASSERT_UINT_EQUALS(2, metrics.Dropped);
+        ASSERT_UINT_EQUALS(1, metrics.PeakQueuedMessages);
+
+        release.set_value();
+        pool.Drain();
+        ASSERT_UINT_EQUALS(1, pool.GetMetrics().Handled);
+    }
+
+    return AWS_ERROR_SUCCESS;
+}
+
+AWS_TEST_CASE(MqttMessageWorkerPoolOrdering, s_TestMqttMessageWorkerPoolOrdering)
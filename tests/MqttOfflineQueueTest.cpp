@@ -0,0 +1,217 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/Api.h>
+#include <aws/crt/mqtt/MqttOfflineQueue.h>
+
+#include <aws/testing/aws_test_harness.h>
+
+#include "LoopbackMqttBroker.h"
+
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+
+static int s_TestMqttOfflineQueueBudget(Aws::Crt::Allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::Io::EventLoopGroup eventLoopGroup(1, allocator);
+        ASSERT_TRUE(eventLoopGroup);
+        Aws::Crt::Io::DefaultHostResolver defaultHostResolver(eventLoopGroup, 8, 30, allocator);
+        ASSERT_TRUE(defaultHostResolver);
+        Aws::Crt::Io::ClientBootstrap clientBootstrap(eventLoopGroup, defaultHostResolver, allocator);
+        clientBootstrap.EnableBlockingShutdown();
+
+        Aws::Crt::Mqtt::MqttClient mqttClient(clientBootstrap, allocator);
+        ASSERT_TRUE(mqttClient);
+        Aws::Crt::Io::SocketOptions socketOptions;
+        auto mqttConnection = mqttClient.NewConnection("localhost", 1883, socketOptions);
+        ASSERT_NOT_NULL(mqttConnection);
+
+        /* never connected, so everything is held back: 10 bytes of topic and payload per message */
+        Aws::Crt::Mqtt::MqttOfflineQueueOptions options;
+        options.MaxQueuedBytes = 30;
+        options.TopicPolicy = [](Aws::Crt::StringView topic) {
+            if (topic == Aws::Crt::StringView("latest"))
+            {
+                return Aws::Crt::Mqtt::OfflineTopicPolicy::Replace;
+            }
+            return topic == Aws::Crt::StringView("ignore") ? Aws::Crt::Mqtt::OfflineTopicPolicy::Drop
+                                     : Aws::Crt::Mqtt::OfflineTopicPolicy::Queue;
+        };
+        options.SpillFilePath = "mqtt_offline_queue_test.spill";
+        options.MaxSpillBytes = 20;
+
+        auto queue = Aws::Crt::Mqtt::MqttOfflineQueue::NewOfflineQueue(mqttConnection, options, allocator);
+        ASSERT_NOT_NULL(queue);
+        ASSERT_FALSE(queue->IsOnline());
+
+        int reportedErrors = 0;
+        queue->OnPublishComplete =
+            [&reportedErrors](Aws::Crt::Mqtt::MqttConnection &, Aws::Crt::StringView, int errorCode) {
+                if (errorCode != AWS_ERROR_SUCCESS)
+                {
+                    ++reportedErrors;
+                }
+            };
+
+        ASSERT_TRUE(queue->Publish(
+            "latest", AWS_MQTT_QOS_AT_LEAST_ONCE, false, Aws::Crt::ByteCursorFromCString("v1v1")));
+        ASSERT_TRUE(queue->Publish(
+            "latest", AWS_MQTT_QOS_AT_LEAST_ONCE, false, Aws::Crt::ByteCursorFromCString("v2v2")));
+        ASSERT_FALSE(queue->Publish(
+            "ignore", AWS_MQTT_QOS_AT_LEAST_ONCE, false, Aws::Crt::ByteCursorFromCString("data")));
+        ASSERT_TRUE(queue->Publish(
+            "topic1", AWS_MQTT_QOS_AT_LEAST_ONCE, false, Aws::Crt::ByteCursorFromCString("data")));
+        ASSERT_TRUE(queue->Publish(
+            "topic2", AWS_MQTT_QOS_AT_LEAST_ONCE, false, Aws::Crt::ByteCursorFromCString("data")));
+
+        auto metrics = queue->GetMetrics();
+        ASSERT_UINT_EQUALS(3, metrics.QueuedMessages);
+        ASSERT_UINT_EQUALS(30, metrics.QueuedBytes);
+        ASSERT_UINT_EQUALS(1, metrics.Replaced);
+        ASSERT_UINT_EQUALS(1, metrics.Dropped);
+        ASSERT_INT_EQUALS(1, reportedErrors);
+
+        /* past the memory budget, messages go to the spill file until it is full */
+        ASSERT_TRUE(queue->Publish("s", AWS_MQTT_QOS_AT_LEAST_ONCE, false, Aws::Crt::ByteCursorFromCString("1")));
+        ASSERT_FALSE(queue->Publish(
+            "spill2", AWS_MQTT_QOS_AT_LEAST_ONCE, false, Aws::Crt::ByteCursorFromCString("data")));
+
+        metrics = queue->GetMetrics();
+        ASSERT_UINT_EQUALS(3, metrics.QueuedMessages);
+        ASSERT_UINT_EQUALS(1, metrics.SpilledMessages);
+        ASSERT_UINT_EQUALS(12, metrics.SpilledBytes);
+        ASSERT_UINT_EQUALS(2, metrics.Dropped);
+
+        FILE *spillFile = fopen("mqtt_offline_queue_test.spill.0", "rb");
+        ASSERT_NOT_NULL(spillFile);
+        fclose(spillFile);
+
+        queue.reset();
+        ASSERT_NULL(fopen("mqtt_offline_queue_test.spill.0", "rb"));
+    }
+
+    return AWS_ERROR_SUCCESS;
+}
+
+AWS_TEST_CASE(MqttOfflineQueueBudget, s_TestMqttOfflineQueueBudget)
+
+/* queues past the memory budget into the spill file while offline, then connects and drains both, in order */
+static int s_TestMqttOfflineQueueSpillAndDrain(Aws::Crt::Allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::Io::EventLoopGroup eventLoopGroup(1, allocator);
+        ASSERT_TRUE(eventLoopGroup);
+        Aws::Crt::Io::DefaultHostResolver defaultHostResolver(eventLoopGroup, 8, 30, allocator);
+        ASSERT_TRUE(defaultHostResolver);
+        Aws::Crt::Io::ClientBootstrap clientBootstrap(eventLoopGroup, defaultHostResolver, allocator);
+        clientBootstrap.EnableBlockingShutdown();
+
+        LoopbackServer server(
+            eventLoopGroup,
+            [allocator]() { return Aws::Crt::MakeShared<LoopbackMqttBroker>(allocator, allocator); },
+            allocator);
+        ASSERT_TRUE(server.Listen());
+
+        Aws::Crt::Mqtt::MqttClient mqttClient(clientBootstrap, allocator);
+        ASSERT_TRUE(mqttClient);
+        Aws::Crt::Io::SocketOptions socketOptions;
+        auto mqttConnection = mqttClient.NewConnection(server.GetHostName(), server.GetPort(), socketOptions);
+        ASSERT_NOT_NULL(mqttConnection);
+
+        std::mutex lock;
+        std::condition_variable signal;
+        bool connected = false;
+        bool disconnected = false;
+        size_t completed = 0;
+        int completionErrors = 0;
+
+        /* the queue wraps these, so they are set first */
+        mqttConnection->OnConnectionCompleted =
+            [&](Aws::Crt::Mqtt::MqttConnection &, int, Aws::Crt::Mqtt::ReturnCode, bool) {
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    connected = true;
+                }
+                signal.notify_all();
+            };
+        mqttConnection->OnDisconnect = [&](Aws::Crt::Mqtt::MqttConnection &) {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                disconnected = true;
+            }
+            signal.notify_all();
+        };
+
+        /* 10 bytes of topic and payload per message: two fit in memory, the rest spill */
+        Aws::Crt::Mqtt::MqttOfflineQueueOptions options;
+        options.MaxQueuedBytes = 20;
+        options.SpillFilePath = "mqtt_offline_queue_drain_test.spill";
+        options.MaxSpillBytes = 1024;
+
+        auto queue = Aws::Crt::Mqtt::MqttOfflineQueue::NewOfflineQueue(mqttConnection, options, allocator);
+        ASSERT_NOT_NULL(queue);
+        queue->OnPublishComplete = [&](Aws::Crt::Mqtt::MqttConnection &, Aws::Crt::StringView, int errorCode) {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                ++completed;
+                if (errorCode != AWS_ERROR_SUCCESS)
+                {
+                    ++completionErrors;
+                }
+            }
+            signal.notify_all();
+        };
+
+        const char *topics[] = {"topic0", "topic1", "topic2", "topic3", "topic4"};
+        for (const char *topic : topics)
+        {
+            ASSERT_TRUE(
+                queue->Publish(topic, AWS_MQTT_QOS_AT_LEAST_ONCE, false, Aws::Crt::ByteCursorFromCString("data")));
+        }
+
+        auto metrics = queue->GetMetrics();
+        ASSERT_UINT_EQUALS(2, metrics.QueuedMessages);
+        ASSERT_UINT_EQUALS(3, metrics.SpilledMessages);
+
+        ASSERT_TRUE(mqttConnection->Connect("offline-queue-drain", true));
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            signal.wait(guard, [&]() { return connected && completed == 5; });
+            ASSERT_INT_EQUALS(0, completionErrors);
+        }
+        ASSERT_TRUE(queue->IsOnline());
+
+        metrics = queue->GetMetrics();
+        ASSERT_UINT_EQUALS(0, metrics.QueuedMessages);
+        ASSERT_UINT_EQUALS(0, metrics.SpilledMessages);
+
+        ASSERT_TRUE(server.WaitForConnections(1));
+        auto broker = std::static_pointer_cast<LoopbackMqttBroker>(server.GetHandler(0));
+        auto publishes = broker->GetPublishes();
+        ASSERT_UINT_EQUALS(5, publishes.size());
+        for (size_t i = 0; i < publishes.size(); ++i)
+        {
+            ASSERT_STR_EQUALS(topics[i], publishes[i].topic.c_str());
+            ASSERT_STR_EQUALS("data", publishes[i].payload.c_str());
+        }
+
+        ASSERT_TRUE(mqttConnection->Disconnect());
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            signal.wait(guard, [&]() { return disconnected; });
+        }
+    }
+
+    return AWS_ERROR_SUCCESS;
+}
+
+AWS_TEST_CASE(MqttOfflineQueueSpillAndDrain, s_TestMqttOfflineQueueSpillAndDrain)
@@ -0,0 +1,64 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/Api.h>
+#include <aws/crt/mqtt/ShardedMqttConnection.h>
+
+#include <aws/testing/aws_test_harness.h>
+
+static int s_TestMqttShardedConnectionSharding(Aws::Crt::Allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::Io::EventLoopGroup eventLoopGroup(4, allocator);
+        ASSERT_TRUE(eventLoopGroup);
+        Aws::Crt::Io::DefaultHostResolver defaultHostResolver(eventLoopGroup, 8, 30, allocator);
+        ASSERT_TRUE(defaultHostResolver);
+        Aws::Crt::Io::ClientBootstrap clientBootstrap(eventLoopGroup, defaultHostResolver, allocator);
+        clientBootstrap.EnableBlockingShutdown();
+
+        Aws::Crt::Mqtt::MqttClient mqttClient(clientBootstrap, allocator);
+        ASSERT_TRUE(mqttClient);
+        Aws::Crt::Io::SocketOptions socketOptions;
+
+        Aws::Crt::Mqtt::ShardedMqttConnection noShards(mqttClient, 0, "localhost", 1883, socketOptions);
+        ASSERT_FALSE(noShards);
+        ASSERT_INT_EQUALS(AWS_ERROR_INVALID_ARGUMENT, noShards.LastError());
+
+        Aws::Crt::Mqtt::ShardedMqttConnection connection(mqttClient, 4, "localhost", 1883, socketOptions);
+        ASSERT_TRUE(connection);
+        ASSERT_UINT_EQUALS(4, connection.GetShardCount());
+        for (size_t i = 0; i < connection.GetShardCount(); ++i)
+        {
+            ASSERT_NOT_NULL(connection.GetShard(i));
+            for (size_t j = 0; j < i; ++j)
+            {
+                ASSERT_TRUE(connection.GetShard(i) != connection.GetShard(j));
+            }
+        }
+
+        /* a topic always maps to the same shard, and the topics spread over all of them */
+        bool shardUsed[4] = {false, false, false, false};
+        for (int i = 0; i < 64; ++i)
+        {
+            Aws::Crt::String topic = "devices/" + Aws::Crt::String(std::to_string(i).c_str()) + "/telemetry";
+            Aws::Crt::StringView topicView(topic.data(), topic.size());
+            size_t shard = connection.GetShardIndex(topicView);
+            ASSERT_TRUE(shard < 4);
+            ASSERT_UINT_EQUALS(shard, connection.GetShardIndex(topicView));
+            shardUsed[shard] = true;
+        }
+
+        for (bool used : shardUsed)
+        {
+            ASSERT_TRUE(used);
+        }
+    }
+
+    return AWS_ERROR_SUCCESS;
+}
+
+AWS_TEST_CASE(MqttShardedConnectionSharding, s_TestMqttShardedConnectionSharding)
@@ -0,0 +1,207 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/Api.h>
+#include <aws/crt/mqtt/MqttSubscribeCoalescer.h>
+
+#include <aws/testing/aws_test_harness.h>
+
+#include "LoopbackMqttBroker.h"
+
+#include <condition_variable>
+#include <mutex>
+
+static int s_TestMqttSubscribeCoalescerOffline(Aws::Crt::Allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::Io::EventLoopGroup eventLoopGroup(1, allocator);
+        ASSERT_TRUE(eventLoopGroup);
+        Aws::Crt::Io::DefaultHostResolver defaultHostResolver(eventLoopGroup, 8, 30, allocator);
+        ASSERT_TRUE(defaultHostResolver);
+        Aws::Crt::Io::ClientBootstrap clientBootstrap(eventLoopGroup, defaultHostResolver, allocator);
+        clientBootstrap.EnableBlockingShutdown();
+
+        Aws::Crt::Mqtt::MqttClient mqttClient(clientBootstrap, allocator);
+        ASSERT_TRUE(mqttClient);
+        Aws::Crt::Io::SocketOptions socketOptions;
+        auto mqttConnection = mqttClient.NewConnection("localhost", 1883, socketOptions);
+        ASSERT_NOT_NULL(mqttConnection);
+
+        Aws::Crt::Mqtt::MqttSubscribeCoalescerOptions options;
+        options.EventLoopGroup = &eventLoopGroup;
+        options.MaxTopicsPerSubscribe = 0;
+        ASSERT_NULL(Aws::Crt::Mqtt::MqttSubscribeCoalescer::NewSubscribeCoalescer(mqttConnection, options, allocator));
+        options.MaxTopicsPerSubscribe = 2;
+
+        Aws::Crt::Vector<Aws::Crt::String> failed;
+        {
+            auto coalescer =
+                Aws::Crt::Mqtt::MqttSubscribeCoalescer::NewSubscribeCoalescer(mqttConnection, options, allocator);
+            ASSERT_NOT_NULL(coalescer);
+
+            /* nothing is sent before the connection completes, however many topics pile up */
+            const char *topics[] = {"devices/1/config", "devices/1/jobs", "devices/1/shadow"};
+            for (const char *topic : topics)
+            {
+                ASSERT_TRUE(coalescer->Subscribe(
+                    topic,
+                    AWS_MQTT_QOS_AT_LEAST_ONCE,
+                    Aws::Crt::Mqtt::OnMessageReceivedViewHandler(),
+                    [&failed](
+                        Aws::Crt::Mqtt::MqttConnection &,
+                        uint16_t packetId,
+                        const Aws::Crt::String &topic,
+                        Aws::Crt::Mqtt::QOS,
+                        int errorCode) {
+                        if (packetId == 0 && errorCode == AWS_ERROR_MQTT_NOT_CONNECTED)
+                        {
+                            failed.push_back(topic);
+                        }
+                    }));
+            }
+            ASSERT_FALSE(coalescer->Subscribe("", AWS_MQTT_QOS_AT_LEAST_ONCE, nullptr, nullptr));
+
+            ASSERT_UINT_EQUALS(0, coalescer->Flush());
+            Aws::Crt::Mqtt::MqttSubscribeCoalescerMetrics metrics = coalescer->GetMetrics();
+            ASSERT_UINT_EQUALS(3, metrics.PendingSubscribes);
+            ASSERT_UINT_EQUALS(0, metrics.SubscribePackets);
+        }
+
+        /* each topic held back is failed on its own once the coalescer goes away */
+        ASSERT_UINT_EQUALS(3, failed.size());
+        ASSERT_TRUE(failed[0] == "devices/1/config");
+        ASSERT_TRUE(failed[2] == "devices/1/shadow");
+    }
+
+    return AWS_ERROR_SUCCESS;
+}
+
+AWS_TEST_CASE(MqttSubscribeCoalescerOffline, s_TestMqttSubscribeCoalescerOffline)
+
+/*
+ * Subscribes to three topics while offline and two more inside the window once connected, against a local broker
+ * that rejects "reject/" filters. Each batch must go out as a single SUBSCRIBE, and each topic must be acknowledged
+ * with its own grant.
+ */
+static int s_TestMqttSubscribeCoalescerBatching(Aws::Crt::Allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::Io::EventLoopGroup eventLoopGroup(1, allocator);
+        ASSERT_TRUE(eventLoopGroup);
+        Aws::Crt::Io::DefaultHostResolver defaultHostResolver(eventLoopGroup, 8, 30, allocator);
+        ASSERT_TRUE(defaultHostResolver);
+        Aws::Crt::Io::ClientBootstrap clientBootstrap(eventLoopGroup, defaultHostResolver, allocator);
+        clientBootstrap.EnableBlockingShutdown();
+
+        LoopbackServer server(
+            eventLoopGroup,
+            [allocator]() { return Aws::Crt::MakeShared<LoopbackMqttBroker>(allocator, allocator); },
+            allocator);
+        ASSERT_TRUE(server.Listen());
+
+        Aws::Crt::Mqtt::MqttClient mqttClient(clientBootstrap, allocator);
+        ASSERT_TRUE(mqttClient);
+        Aws::Crt::Io::SocketOptions socketOptions;
+        auto mqttConnection = mqttClient.NewConnection(server.GetHostName(), server.GetPort(), socketOptions);
+        ASSERT_NOT_NULL(mqttConnection);
+
+        std::mutex lock;
+        std::condition_variable signal;
+        bool disconnected = false;
+        Aws::Crt::Map<Aws::Crt::String, Aws::Crt::Mqtt::QOS> granted;
+        Aws::Crt::Map<Aws::Crt::String, uint16_t> packetIds;
+        int ackErrors = 0;
+
+        mqttConnection->OnDisconnect = [&](Aws::Crt::Mqtt::MqttConnection &) {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                disconnected = true;
+            }
+            signal.notify_all();
+        };
+
+        Aws::Crt::Mqtt::MqttSubscribeCoalescerOptions options;
+        options.EventLoopGroup = &eventLoopGroup;
+        options.CoalescingWindow = std::chrono::milliseconds(50);
+        auto coalescer =
+            Aws::Crt::Mqtt::MqttSubscribeCoalescer::NewSubscribeCoalescer(mqttConnection, options, allocator);
+        ASSERT_NOT_NULL(coalescer);
+
+        auto subscribe = [&](const char *topic) {
+            return coalescer->Subscribe(
+                topic,
+                AWS_MQTT_QOS_AT_LEAST_ONCE,
+                Aws::Crt::Mqtt::OnMessageReceivedViewHandler(),
+                [&](Aws::Crt::Mqtt::MqttConnection &,
+                    uint16_t packetId,
+                    const Aws::Crt::String &ackedTopic,
+                    Aws::Crt::Mqtt::QOS qos,
+                    int errorCode) {
+                    {
+                        std::lock_guard<std::mutex> guard(lock);
+                        granted[ackedTopic] = qos;
+                        packetIds[ackedTopic] = packetId;
+                        if (errorCode != AWS_ERROR_SUCCESS)
+                        {
+                            ++ackErrors;
+                        }
+                    }
+                    signal.notify_all();
+                });
+        };
+
+        ASSERT_TRUE(subscribe("devices/1/config"));
+        ASSERT_TRUE(subscribe("reject/devices/1/jobs"));
+        ASSERT_TRUE(subscribe("devices/1/shadow"));
+
+        ASSERT_TRUE(mqttConnection->Connect("subscribe-coalescer-batching", true));
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            ASSERT_TRUE(signal.wait_for(guard, std::chrono::seconds(10), [&]() { return granted.size() == 3; }));
+        }
+
+        ASSERT_TRUE(subscribe("devices/2/config"));
+        ASSERT_TRUE(subscribe("reject/devices/2/jobs"));
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            ASSERT_TRUE(signal.wait_for(guard, std::chrono::seconds(10), [&]() { return granted.size() == 5; }));
+            ASSERT_INT_EQUALS(0, ackErrors);
+
+            ASSERT_INT_EQUALS(AWS_MQTT_QOS_AT_LEAST_ONCE, granted["devices/1/config"]);
+            ASSERT_INT_EQUALS(AWS_MQTT_QOS_FAILURE, granted["reject/devices/1/jobs"]);
+            ASSERT_INT_EQUALS(AWS_MQTT_QOS_AT_LEAST_ONCE, granted["devices/1/shadow"]);
+            ASSERT_INT_EQUALS(AWS_MQTT_QOS_AT_LEAST_ONCE, granted["devices/2/config"]);
+            ASSERT_INT_EQUALS(AWS_MQTT_QOS_FAILURE, granted["reject/devices/2/jobs"]);
+
+            ASSERT_UINT_EQUALS(packetIds["devices/1/config"], packetIds["devices/1/shadow"]);
+            ASSERT_UINT_EQUALS(packetIds["devices/2/config"], packetIds["reject/devices/2/jobs"]);
+            ASSERT_FALSE(packetIds["devices/1/config"] == packetIds["devices/2/config"]);
+        }
+
+        ASSERT_TRUE(server.WaitForConnections(1));
+        auto broker = std::static_pointer_cast<LoopbackMqttBroker>(server.GetHandler(0));
+        ASSERT_UINT_EQUALS(2, broker->GetSubscribePacketCount());
+        ASSERT_UINT_EQUALS(5, broker->GetSubscribedTopics().size());
+
+        Aws::Crt::Mqtt::MqttSubscribeCoalescerMetrics metrics = coalescer->GetMetrics();
+        ASSERT_UINT_EQUALS(2, metrics.SubscribePackets);
+        ASSERT_UINT_EQUALS(5, metrics.SubscribedTopics);
+
+        ASSERT_TRUE(mqttConnection->Disconnect());
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            signal.wait(guard, [&]() { return disconnected; });
+        }
+    }
+
+    return AWS_ERROR_SUCCESS;
+}
+
+AWS_TEST_CASE(MqttSubscribeCoalescerBatching, s_TestMqttSubscribeCoalescerBatching)
@@ -0,0 +1,92 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/crt/Api.h>
+#include <aws/crt/mqtt/TopicRouter.h>
+
+#include <aws/testing/aws_test_harness.h>
+
+static int s_TestMqttTopicRouterDispatch(Aws::Crt::Allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::Io::EventLoopGroup eventLoopGroup(1, allocator);
+        ASSERT_TRUE(eventLoopGroup);
+        Aws::Crt::Io::DefaultHostResolver defaultHostResolver(eventLoopGroup, 8, 30, allocator);
+        ASSERT_TRUE(defaultHostResolver);
+        Aws::Crt::Io::ClientBootstrap clientBootstrap(eventLoopGroup, defaultHostResolver, allocator);
+        clientBootstrap.EnableBlockingShutdown();
+
+        Aws::Crt::Mqtt::MqttClient mqttClient(clientBootstrap, allocator);
+        ASSERT_TRUE(mqttClient);
+        Aws::Crt::Io::SocketOptions socketOptions;
+        auto mqttConnection = mqttClient.NewConnection("localhost", 1883, socketOptions);
+        ASSERT_NOT_NULL(mqttConnection);
+
+        ASSERT_TRUE(Aws::Crt::Mqtt::TopicRouter::IsValidTopicFilter("sensors/+/temperature"));
+        ASSERT_TRUE(Aws::Crt::Mqtt::TopicRouter::IsValidTopicFilter("#"));
+        ASSERT_FALSE(Aws::Crt::Mqtt::TopicRouter::IsValidTopicFilter("sensors/#/temperature"));
+        ASSERT_FALSE(Aws::Crt::Mqtt::TopicRouter::IsValidTopicFilter("sensors/a+"));
+        ASSERT_FALSE(Aws::Crt::Mqtt::TopicRouter::IsValidTopicFilter(""));
+
+        auto router = Aws::Crt::MakeShared<Aws::Crt::Mqtt::TopicRouter>(allocator, allocator);
+
+        int exactHits = 0;
+        int singleLevelHits = 0;
+        int multiLevelHits = 0;
+        int everythingHits = 0;
+        auto counter = [](int &hits) {
+            return [&hits](
+                       Aws::Crt::Mqtt::MqttConnection &,
+                       Aws::Crt::StringView,
+                       const Aws::Crt::ByteCursor &,
+                       bool,
+                       Aws::Crt::Mqtt::QOS,
+                       bool) { ++hits; };
+        };
+
+        uint64_t exactRoute = router->AddRoute("sensors/kitchen/temperature", counter(exactHits));
+        ASSERT_TRUE(exactRoute != 0);
+        ASSERT_TRUE(router->AddRoute("sensors/+/temperature", counter(singleLevelHits)) != 0);
+        ASSERT_TRUE(router->AddRoute("sensors/#", counter(multiLevelHits)) != 0);
+        ASSERT_TRUE(router->AddRoute("#", counter(everythingHits)) != 0);
+        ASSERT_UINT_EQUALS(0, router->AddRoute("sensors/#/bad", counter(everythingHits)));
+        ASSERT_UINT_EQUALS(4, router->GetRouteCount());
+
+        auto onMessage = router->GetOnMessageReceived();
+        auto payload = Aws::Crt::ByteCursorFromCString("21.5");
+        onMessage(*mqttConnection, "sensors/kitchen/temperature", payload, false, AWS_MQTT_QOS_AT_MOST_ONCE, false);
+        ASSERT_INT_EQUALS(1, exactHits);
+        ASSERT_INT_EQUALS(1, singleLevelHits);
+        ASSERT_INT_EQUALS(1, multiLevelHits);
+        ASSERT_INT_EQUALS(1, everythingHits);
+
+        /* '#' also matches its parent level, '+' exactly one level */
+        ASSERT_UINT_EQUALS(
+            2, router->Dispatch(*mqttConnection, "sensors", payload, false, AWS_MQTT_QOS_AT_MOST_ONCE, false));
+        ASSERT_UINT_EQUALS(
+            2,
+            router->Dispatch(
+                *mqttConnection, "sensors/kitchen/humidity", payload, false, AWS_MQTT_QOS_AT_MOST_ONCE, false));
+
+        /* wildcards at the first level never match system topics */
+        ASSERT_UINT_EQUALS(
+            0, router->Dispatch(*mqttConnection, "$SYS/uptime", payload, false, AWS_MQTT_QOS_AT_MOST_ONCE, false));
+
+        ASSERT_TRUE(router->RemoveRoute(exactRoute));
+        ASSERT_FALSE(router->RemoveRoute(exactRoute));
+        ASSERT_UINT_EQUALS(
+            3,
+            router->Dispatch(
+                *mqttConnection, "sensors/kitchen/temperature", payload, false, AWS_MQTT_QOS_AT_MOST_ONCE, false));
+        ASSERT_INT_EQUALS(1, exactHits);
+        ASSERT_UINT_EQUALS(3, router->GetRouteCount());
+    }
+
+    return AWS_ERROR_SUCCESS;
+}
+
+AWS_TEST_CASE(MqttTopicRouterDispatch, s_TestMqttTopicRouterDispatch)
@@ -4,14 +4,23 @@
  */
 #include <aws/crt/Api.h>
 
+#include <aws/crt/io/AsyncInputStream.h>
+#include <aws/crt/io/ChecksumInputStream.h>
+#include <aws/crt/io/ReadAheadInputStream.h>
 #include <aws/crt/io/Stream.h>
+#include <aws/crt/io/ThrottledInputStream.h>
 
 #include <aws/common/byte_buf.h>
 #include <aws/io/stream.h>
 
 #include <aws/testing/aws_test_harness.h>
 
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
 #include <sstream>
+#include <thread>
 
 static int s_StreamTestCreateDestroyWrapper(struct aws_allocator *allocator, void *ctx)
 {
@@ -168,3 +177,698 @@ static int s_StreamTestSeekEnd(struct aws_allocator *allocator, void *ctx)
 }
 
 AWS_TEST_CASE(StreamTestSeekEnd, s_StreamTestSeekEnd)
+
+static const char *FILE_STREAM_TEST_FILE = "file_input_stream_test.txt";
+static const char *FILE_STREAM_EMPTY_TEST_FILE = "file_input_stream_empty_test.txt";
+
+template <typename FileStreamT> static int s_TestFileStream(struct aws_allocator *allocator)
+{
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        {
+            std::ofstream testFile(FILE_STREAM_TEST_FILE, std::ios_base::binary);
+            testFile << STREAM_CONTENTS;
+            std::ofstream emptyFile(FILE_STREAM_EMPTY_TEST_FILE, std::ios_base::binary);
+        }
+
+        FileStreamT missingStream("file_input_stream_does_not_exist.txt", allocator);
+        ASSERT_FALSE(static_cast<bool>(missingStream));
+        ASSERT_INT_EQUALS(AWS_ERROR_FILE_INVALID_PATH, missingStream.LastError());
+
+        FileStreamT fileStream(FILE_STREAM_TEST_FILE, allocator);
+        ASSERT_TRUE(static_cast<bool>(fileStream));
+
+        int64_t length = 0;
+        ASSERT_SUCCESS(aws_input_stream_get_length(fileStream.GetUnderlyingStream(), &length));
+        ASSERT_TRUE(length == (int64_t)strlen(STREAM_CONTENTS));
+
+        /* a buffer smaller than the file makes the stream resume from where the previous read left off */
+        aws_byte_buf buffer;
+        AWS_ZERO_STRUCT(buffer);
+        aws_byte_buf_init(&buffer, allocator, 5);
+
+        Aws::Crt::String contents;
+        aws_stream_status status;
+        AWS_ZERO_STRUCT(status);
+        do
+        {
+            buffer.len = 0;
+            ASSERT_SUCCESS(aws_input_stream_read(fileStream.GetUnderlyingStream(), &buffer));
+            contents.append((const char *)buffer.buffer, buffer.len);
+            ASSERT_SUCCESS(aws_input_stream_get_status(fileStream.GetUnderlyingStream(), &status));
+            ASSERT_TRUE(status.is_valid);
+        } while (!status.is_end_of_stream);
+        ASSERT_STR_EQUALS(STREAM_CONTENTS, contents.c_str());
+
+        ASSERT_SUCCESS(aws_input_stream_seek(fileStream.GetUnderlyingStream(), BEGIN_SEEK_OFFSET, AWS_SSB_BEGIN));
+        buffer.len = 0;
+        ASSERT_SUCCESS(aws_input_stream_read(fileStream.GetUnderlyingStream(), &buffer));
+        ASSERT_BIN_ARRAYS_EQUALS(STREAM_CONTENTS + BEGIN_SEEK_OFFSET, buffer.len, buffer.buffer, buffer.len);
+
+        ASSERT_SUCCESS(aws_input_stream_seek(fileStream.GetUnderlyingStream(), END_SEEK_OFFSET, AWS_SSB_END));
+        buffer.len = 0;
+        ASSERT_SUCCESS(aws_input_stream_read(fileStream.GetUnderlyingStream(), &buffer));
+        ASSERT_TRUE(buffer.len == -END_SEEK_OFFSET);
+        ASSERT_BIN_ARRAYS_EQUALS(
+            STREAM_CONTENTS + strlen(STREAM_CONTENTS) + END_SEEK_OFFSET, buffer.len, buffer.buffer, buffer.len);
+
+        ASSERT_FAILS(aws_input_stream_seek(fileStream.GetUnderlyingStream(), length + 1, AWS_SSB_BEGIN));
+        ASSERT_INT_EQUALS(AWS_IO_STREAM_INVALID_SEEK_POSITION, aws_last_error());
+        ASSERT_FAILS(aws_input_stream_seek(fileStream.GetUnderlyingStream(), 1, AWS_SSB_END));
+
+        FileStreamT emptyStream(FILE_STREAM_EMPTY_TEST_FILE, allocator);
+        ASSERT_TRUE(static_cast<bool>(emptyStream));
+        ASSERT_SUCCESS(aws_input_stream_get_length(emptyStream.GetUnderlyingStream(), &length));
+        ASSERT_TRUE(length == 0);
+        buffer.len = 0;
+        ASSERT_SUCCESS(aws_input_stream_read(emptyStream.GetUnderlyingStream(), &buffer));
+        ASSERT_TRUE(buffer.len == 0);
+        ASSERT_SUCCESS(aws_input_stream_get_status(emptyStream.GetUnderlyingStream(), &status));
+        ASSERT_TRUE(status.is_end_of_stream);
+
+        aws_byte_buf_clean_up(&buffer);
+    }
+
+    remove(FILE_STREAM_TEST_FILE);
+    remove(FILE_STREAM_EMPTY_TEST_FILE);
+
+    return AWS_OP_SUCCESS;
+}
+
+static int s_StreamTestFileInputStream(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    return s_TestFileStream<Aws::Crt::Io::FileInputStream>(allocator);
+}
+
+AWS_TEST_CASE(StreamTestFileInputStream, s_StreamTestFileInputStream)
+
+static int s_StreamTestMmapFileInputStream(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+        {
+            std::ofstream testFile(FILE_STREAM_TEST_FILE, std::ios_base::binary);
+            testFile << STREAM_CONTENTS;
+        }
+
+        Aws::Crt::Io::MmapFileInputStream mappedStream(FILE_STREAM_TEST_FILE, allocator);
+        ASSERT_TRUE(static_cast<bool>(mappedStream));
+        Aws::Crt::ByteCursor contents = mappedStream.GetContents();
+        ASSERT_BIN_ARRAYS_EQUALS(STREAM_CONTENTS, strlen(STREAM_CONTENTS), contents.ptr, contents.len);
+    }
+
+    return s_TestFileStream<Aws::Crt::Io::MmapFileInputStream>(allocator);
+}
+
+AWS_TEST_CASE(StreamTestMmapFileInputStream, s_StreamTestMmapFileInputStream)
+
+/* Produces STREAM_CONTENTS a few bytes at a time, but only when the test says so. */
+class ManualAsyncInputStream : public Aws::Crt::Io::AsyncInputStream
+{
+  public:
+    explicit ManualAsyncInputStream(struct aws_allocator *allocator)
+        : AsyncInputStream(4, allocator), m_pending(nullptr), m_produced(0)
+    {
+    }
+
+    bool HasPendingRead() const noexcept { return m_pending != nullptr; }
+
+    void Produce()
+    {
+        size_t remaining = strlen(STREAM_CONTENTS) - m_produced;
+        size_t toProduce = m_pending->capacity - m_pending->len;
+        toProduce = toProduce < remaining ? toProduce : remaining;
+        memcpy(m_pending->buffer + m_pending->len, STREAM_CONTENTS + m_produced, toProduce);
+        m_pending->len += toProduce;
+        m_produced += toProduce;
+        m_pending = nullptr;
+        CompleteRead(m_produced == strlen(STREAM_CONTENTS));
+    }
+
+  protected:
+    void ReadAsyncImpl(Aws::Crt::ByteBuf &buffer) noexcept override { m_pending = &buffer; }
+
+  private:
+    Aws::Crt::ByteBuf *m_pending;
+    size_t m_produced;
+};
+
+/* A non-blocking source: reads return nothing, without reaching the end, until the test releases the contents. */
+class StalledInputStream : public Aws::Crt::Io::InputStream
+{
+  public:
+    explicit StalledInputStream(struct aws_allocator *allocator)
+        : InputStream(allocator), m_released(false), m_done(false), m_reads(0)
+    {
+    }
+
+    bool IsValid() const noexcept override { return true; }
+
+    void Release() noexcept { m_released = true; }
+
+    size_t GetReadCount() const noexcept { return m_reads; }
+
+  protected:
+    bool ReadImpl(Aws::Crt::ByteBuf &buffer) noexcept override
+    {
+        ++m_reads;
+        if (m_released && !m_done)
+        {
+            Aws::Crt::ByteCursor contents = Aws::Crt::ByteCursorFromCString(STREAM_CONTENTS);
+            aws_byte_buf_write_from_whole_cursor(&buffer, contents);
+            m_done = true;
+        }
+        return true;
+    }
+
+    Aws::Crt::Io::StreamStatus GetStatusImpl() const noexcept override
+    {
+        Aws::Crt::Io::StreamStatus status;
+        status.is_valid = true;
+        status.is_end_of_stream = m_done;
+        return status;
+    }
+
+    int64_t GetLengthImpl() const noexcept override { return -1; }
+
+    bool SeekImpl(Aws::Crt::Io::OffsetType, Aws::Crt::Io::StreamSeekBasis) noexcept override
+    {
+        aws_raise_error(AWS_ERROR_STREAM_UNSEEKABLE);
+        return false;
+    }
+
+  private:
+    std::atomic<bool> m_released;
+    bool m_done;
+    std::atomic<size_t> m_reads;
+};
+
+static int s_StreamTestAsyncInputStream(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        aws_byte_buf buffer;
+        AWS_ZERO_STRUCT(buffer);
+        aws_byte_buf_init(&buffer, allocator, 256);
+        aws_stream_status status;
+        AWS_ZERO_STRUCT(status);
+
+        ManualAsyncInputStream manualStream(allocator);
+        ASSERT_TRUE(static_cast<bool>(manualStream));
+
+        /* nothing produced yet: the read succeeds empty, and the stream is neither done nor broken */
+        ASSERT_SUCCESS(aws_input_stream_read(manualStream.GetUnderlyingStream(), &buffer));
+        ASSERT_UINT_EQUALS(0, buffer.len);
+        ASSERT_TRUE(manualStream.HasPendingRead());
+        ASSERT_SUCCESS(aws_input_stream_get_status(manualStream.GetUnderlyingStream(), &status));
+        ASSERT_TRUE(status.is_valid);
+        ASSERT_FALSE(status.is_end_of_stream);
+
+        /* still pending, polling again must not start a second read */
+        ASSERT_SUCCESS(aws_input_stream_read(manualStream.GetUnderlyingStream(), &buffer));
+        ASSERT_UINT_EQUALS(0, buffer.len);
+
+        while (!status.is_end_of_stream)
+        {
+            if (manualStream.HasPendingRead())
+            {
+                manualStream.Produce();
+            }
+            ASSERT_SUCCESS(aws_input_stream_read(manualStream.GetUnderlyingStream(), &buffer));
+            ASSERT_SUCCESS(aws_input_stream_get_status(manualStream.GetUnderlyingStream(), &status));
+        }
+        ASSERT_BIN_ARRAYS_EQUALS(STREAM_CONTENTS, strlen(STREAM_CONTENTS), buffer.buffer, buffer.len);
+        ASSERT_FAILS(aws_input_stream_seek(manualStream.GetUnderlyingStream(), 0, AWS_SSB_BEGIN));
+
+        /* the adapter pushes a blocking stream's reads onto another thread */
+        auto stringStream = Aws::Crt::MakeShared<Aws::Crt::StringStream>(allocator, STREAM_CONTENTS);
+        auto blockingStream = Aws::Crt::MakeShared<Aws::Crt::Io::StdIOStreamInputStream>(allocator, stringStream);
+        Aws::Crt::Io::AsyncInputStreamAdapter adapter(blockingStream, 5, allocator);
+        ASSERT_TRUE(static_cast<bool>(adapter));
+
+        for (size_t pass = 0; pass < 2; ++pass)
+        {
+            buffer.len = 0;
+            AWS_ZERO_STRUCT(status);
+            while (!status.is_end_of_stream)
+            {
+                ASSERT_SUCCESS(aws_input_stream_read(adapter.GetUnderlyingStream(), &buffer));
+                ASSERT_SUCCESS(aws_input_stream_get_status(adapter.GetUnderlyingStream(), &status));
+                ASSERT_TRUE(status.is_valid);
+                std::this_thread::yield();
+            }
+            ASSERT_BIN_ARRAYS_EQUALS(STREAM_CONTENTS, strlen(STREAM_CONTENTS), buffer.buffer, buffer.len);
+
+            /* once the reads have finished, the stream can be rewound for a retry */
+            ASSERT_SUCCESS(aws_input_stream_seek(adapter.GetUnderlyingStream(), 0, AWS_SSB_BEGIN));
+        }
+
+        /* a source with nothing ready is asked again less and less often, not spun on */
+        auto stalledStream = Aws::Crt::MakeShared<StalledInputStream>(allocator, allocator);
+        {
+            Aws::Crt::Io::AsyncInputStreamAdapter stalledAdapter(stalledStream, 64, allocator);
+            buffer.len = 0;
+            auto pollUntil = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+            while (std::chrono::steady_clock::now() < pollUntil)
+            {
+                ASSERT_SUCCESS(aws_input_stream_read(stalledAdapter.GetUnderlyingStream(), &buffer));
+                ASSERT_UINT_EQUALS(0, buffer.len);
+                std::this_thread::yield();
+            }
+            ASSERT_TRUE(stalledStream->GetReadCount() > 0);
+            ASSERT_TRUE(stalledStream->GetReadCount() < 20);
+
+            stalledStream->Release();
+            AWS_ZERO_STRUCT(status);
+            while (!status.is_end_of_stream)
+            {
+                ASSERT_SUCCESS(aws_input_stream_read(stalledAdapter.GetUnderlyingStream(), &buffer));
+                ASSERT_SUCCESS(aws_input_stream_get_status(stalledAdapter.GetUnderlyingStream(), &status));
+                std::this_thread::yield();
+            }
+            ASSERT_BIN_ARRAYS_EQUALS(STREAM_CONTENTS, strlen(STREAM_CONTENTS), buffer.buffer, buffer.len);
+        }
+
+        aws_byte_buf_clean_up(&buffer);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(StreamTestAsyncInputStream, s_StreamTestAsyncInputStream)
+
+static const char *RANGE_STREAM_CONTENTS = "abcdefghijklmnopqrstuvwxyz";
+
+static int s_ReadRanges(
+    struct aws_allocator *allocator,
+    const std::shared_ptr<Aws::Crt::Io::PositionalInputSource> &source)
+{
+    Aws::Crt::Vector<std::shared_ptr<Aws::Crt::Io::RangeInputStream>> parts;
+    ASSERT_TRUE(Aws::Crt::Io::RangeInputStream::Split(source, 10, parts, allocator));
+    ASSERT_UINT_EQUALS(3, parts.size());
+
+    /* every part reads on its own thread, all through the one source */
+    Aws::Crt::Vector<Aws::Crt::String> partContents(parts.size());
+    Aws::Crt::Vector<int> partResults(parts.size(), AWS_OP_ERR);
+    Aws::Crt::Vector<std::thread> readers;
+    for (size_t i = 0; i < parts.size(); ++i)
+    {
+        readers.emplace_back([&, i]() {
+            uint8_t storage[4];
+            aws_stream_status status;
+            AWS_ZERO_STRUCT(status);
+            while (!status.is_end_of_stream)
+            {
+                aws_byte_buf buffer = aws_byte_buf_from_empty_array(storage, sizeof(storage));
+                if (aws_input_stream_read(parts[i]->GetUnderlyingStream(), &buffer) ||
+                    aws_input_stream_get_status(parts[i]->GetUnderlyingStream(), &status))
+                {
+                    return;
+                }
+                partContents[i].append((const char *)buffer.buffer, buffer.len);
+            }
+            partResults[i] = AWS_OP_SUCCESS;
+        });
+    }
+
+    Aws::Crt::String joined;
+    for (size_t i = 0; i < parts.size(); ++i)
+    {
+        readers[i].join();
+        ASSERT_SUCCESS(partResults[i]);
+        joined += partContents[i];
+    }
+    ASSERT_STR_EQUALS(RANGE_STREAM_CONTENTS, joined.c_str());
+
+    int64_t length = 0;
+    ASSERT_SUCCESS(aws_input_stream_get_length(parts[2]->GetUnderlyingStream(), &length));
+    ASSERT_TRUE(length == 6);
+    ASSERT_TRUE(parts[2]->GetOffset() == 20);
+
+    /* seeks are relative to the range, and cannot leave it */
+    ASSERT_SUCCESS(aws_input_stream_seek(parts[1]->GetUnderlyingStream(), -3, AWS_SSB_END));
+    uint8_t storage[16];
+    aws_byte_buf buffer = aws_byte_buf_from_empty_array(storage, sizeof(storage));
+    ASSERT_SUCCESS(aws_input_stream_read(parts[1]->GetUnderlyingStream(), &buffer));
+    ASSERT_BIN_ARRAYS_EQUALS("rst", 3, buffer.buffer, buffer.len);
+    ASSERT_FAILS(aws_input_stream_seek(parts[1]->GetUnderlyingStream(), 11, AWS_SSB_BEGIN));
+
+    Aws::Crt::Io::RangeInputStream outOfBounds(source, 20, 7, allocator);
+    ASSERT_FALSE(static_cast<bool>(outOfBounds));
+    ASSERT_INT_EQUALS(AWS_ERROR_INVALID_ARGUMENT, outOfBounds.LastError());
+
+    return AWS_OP_SUCCESS;
+}
+
+static int s_StreamTestRangeInputStream(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+        {
+            std::ofstream testFile(FILE_STREAM_TEST_FILE, std::ios_base::binary);
+            testFile << RANGE_STREAM_CONTENTS;
+        }
+
+        auto fileStream = Aws::Crt::MakeShared<Aws::Crt::Io::FileInputStream>(allocator, FILE_STREAM_TEST_FILE);
+        ASSERT_TRUE(static_cast<bool>(*fileStream));
+        ASSERT_SUCCESS(s_ReadRanges(allocator, fileStream));
+
+        auto mappedStream = Aws::Crt::MakeShared<Aws::Crt::Io::MmapFileInputStream>(allocator, FILE_STREAM_TEST_FILE);
+        ASSERT_TRUE(static_cast<bool>(*mappedStream));
+        ASSERT_SUCCESS(s_ReadRanges(allocator, mappedStream));
+    }
+
+    remove(FILE_STREAM_TEST_FILE);
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(StreamTestRangeInputStream, s_StreamTestRangeInputStream)
+
+static int s_ReadAll(Aws::Crt::Io::InputStream &stream, Aws::Crt::String &outContents)
+{
+    uint8_t storage[5];
+    aws_stream_status status;
+    AWS_ZERO_STRUCT(status);
+    outContents.clear();
+    while (!status.is_end_of_stream)
+    {
+        aws_byte_buf buffer = aws_byte_buf_from_empty_array(storage, sizeof(storage));
+        ASSERT_SUCCESS(aws_input_stream_read(stream.GetUnderlyingStream(), &buffer));
+        ASSERT_SUCCESS(aws_input_stream_get_status(stream.GetUnderlyingStream(), &status));
+        outContents.append((const char *)buffer.buffer, buffer.len);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+static int s_StreamTestChainedInputStream(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        auto stringStream = Aws::Crt::MakeShared<Aws::Crt::StringStream>(allocator, STREAM_CONTENTS);
+        auto childStream = Aws::Crt::MakeShared<Aws::Crt::Io::StdIOStreamInputStream>(allocator, stringStream);
+
+        Aws::Crt::Io::ChainedInputStream chainedStream(allocator);
+        chainedStream.AddSegment(Aws::Crt::ByteCursorFromCString("--header--"));
+        chainedStream.AddSegment(childStream);
+        chainedStream.AddSegment(Aws::Crt::ByteCursorFromCString(""));
+        chainedStream.AddSegment(Aws::Crt::ByteCursorFromCString("--trailer--"));
+        ASSERT_TRUE(static_cast<bool>(chainedStream));
+        ASSERT_UINT_EQUALS(4, chainedStream.GetSegmentCount());
+
+        Aws::Crt::String expected = Aws::Crt::String("--header--") + STREAM_CONTENTS + "--trailer--";
+        int64_t length = 0;
+        ASSERT_SUCCESS(aws_input_stream_get_length(chainedStream.GetUnderlyingStream(), &length));
+        ASSERT_TRUE(length == (int64_t)expected.size());
+
+        Aws::Crt::String contents;
+        ASSERT_SUCCESS(s_ReadAll(chainedStream, contents));
+        ASSERT_STR_EQUALS(expected.c_str(), contents.c_str());
+
+        /* rewinding replays every segment, child streams included */
+        ASSERT_SUCCESS(aws_input_stream_seek(chainedStream.GetUnderlyingStream(), 0, AWS_SSB_BEGIN));
+        ASSERT_SUCCESS(s_ReadAll(chainedStream, contents));
+        ASSERT_STR_EQUALS(expected.c_str(), contents.c_str());
+
+        /* seeks can land in the middle of any segment */
+        ASSERT_SUCCESS(aws_input_stream_seek(chainedStream.GetUnderlyingStream(), 12, AWS_SSB_BEGIN));
+        ASSERT_SUCCESS(s_ReadAll(chainedStream, contents));
+        ASSERT_STR_EQUALS(expected.c_str() + 12, contents.c_str());
+
+        ASSERT_SUCCESS(aws_input_stream_seek(chainedStream.GetUnderlyingStream(), -5, AWS_SSB_END));
+        ASSERT_SUCCESS(s_ReadAll(chainedStream, contents));
+        ASSERT_STR_EQUALS(expected.c_str() + expected.size() - 5, contents.c_str());
+
+        ASSERT_SUCCESS(aws_input_stream_seek(chainedStream.GetUnderlyingStream(), 3, AWS_SSB_BEGIN));
+        ASSERT_SUCCESS(s_ReadAll(chainedStream, contents));
+        ASSERT_STR_EQUALS(expected.c_str() + 3, contents.c_str());
+
+        ASSERT_FAILS(aws_input_stream_seek(chainedStream.GetUnderlyingStream(), length + 1, AWS_SSB_BEGIN));
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(StreamTestChainedInputStream, s_StreamTestChainedInputStream)
+
+static int s_StreamTestByteCursorInputStream(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::Io::ByteCursorInputStream cursorStream(Aws::Crt::ByteCursorFromCString(STREAM_CONTENTS), allocator);
+        ASSERT_TRUE(static_cast<bool>(cursorStream));
+
+        int64_t length = 0;
+        ASSERT_SUCCESS(aws_input_stream_get_length(cursorStream.GetUnderlyingStream(), &length));
+        ASSERT_TRUE(length == (int64_t)strlen(STREAM_CONTENTS));
+
+        Aws::Crt::String contents;
+        ASSERT_SUCCESS(s_ReadAll(cursorStream, contents));
+        ASSERT_STR_EQUALS(STREAM_CONTENTS, contents.c_str());
+
+        ASSERT_SUCCESS(aws_input_stream_seek(cursorStream.GetUnderlyingStream(), END_SEEK_OFFSET, AWS_SSB_END));
+        ASSERT_SUCCESS(s_ReadAll(cursorStream, contents));
+        ASSERT_STR_EQUALS(STREAM_CONTENTS + strlen(STREAM_CONTENTS) + END_SEEK_OFFSET, contents.c_str());
+        ASSERT_FAILS(aws_input_stream_seek(cursorStream.GetUnderlyingStream(), length + 1, AWS_SSB_BEGIN));
+
+        /* the stream keeps a shared owner's data alive after everyone else lets go of it */
+        std::shared_ptr<Aws::Crt::Io::ByteCursorInputStream> ownedStream;
+        {
+            auto payload = Aws::Crt::MakeShared<Aws::Crt::String>(allocator, "{\"key\":\"value\"}");
+            Aws::Crt::ByteCursor payloadCursor = Aws::Crt::ByteCursorFromArray(
+                reinterpret_cast<const uint8_t *>(payload->data()), payload->size());
+            ownedStream =
+                Aws::Crt::MakeShared<Aws::Crt::Io::ByteCursorInputStream>(allocator, payload, payloadCursor, allocator);
+        }
+        ASSERT_SUCCESS(s_ReadAll(*ownedStream, contents));
+        ASSERT_STR_EQUALS("{\"key\":\"value\"}", contents.c_str());
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(StreamTestByteCursorInputStream, s_StreamTestByteCursorInputStream)
+
+static int s_StreamTestChecksumInputStream(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        const uint8_t expectedCrc32[] = {0xe9, 0x5f, 0xcb, 0x0e};
+        const uint8_t expectedCrc32c[] = {0x85, 0xae, 0x07, 0xf9};
+        const uint8_t expectedSha256[] = {0xb5, 0x7c, 0xe6, 0xf9, 0xd8, 0x66, 0x47, 0x6f, 0xd3, 0x5d, 0xe8,
+                                          0xa8, 0x2f, 0x9d, 0x96, 0x35, 0x78, 0x41, 0x3e, 0x1c, 0xbc, 0x77,
+                                          0xb1, 0xb6, 0xe4, 0xbe, 0x14, 0x82, 0x0c, 0x0b, 0xb1, 0x8d};
+
+        uint8_t digestStorage[Aws::Crt::Crypto::SHA256_DIGEST_SIZE];
+        Aws::Crt::String contents;
+
+        auto source = Aws::Crt::MakeShared<Aws::Crt::Io::ByteCursorInputStream>(
+            allocator, Aws::Crt::ByteCursorFromCString(STREAM_CONTENTS), allocator);
+        Aws::Crt::Io::ChecksumInputStream crcStream(source, Aws::Crt::Io::StreamChecksumAlgorithm::Crc32, allocator);
+        ASSERT_TRUE(static_cast<bool>(crcStream));
+        ASSERT_UINT_EQUALS(Aws::Crt::Io::CRC32_CHECKSUM_SIZE, crcStream.GetChecksumSize());
+
+        /* the checksum is computed by the reads themselves, and starts over when a retry rewinds the stream */
+        for (size_t pass = 0; pass < 2; ++pass)
+        {
+            ASSERT_SUCCESS(s_ReadAll(crcStream, contents));
+            ASSERT_STR_EQUALS(STREAM_CONTENTS, contents.c_str());
+            ASSERT_UINT_EQUALS(strlen(STREAM_CONTENTS), crcStream.GetBytesChecksummed());
+
+            aws_byte_buf digest = aws_byte_buf_from_empty_array(digestStorage, sizeof(digestStorage));
+            ASSERT_TRUE(crcStream.Digest(digest));
+            ASSERT_BIN_ARRAYS_EQUALS(expectedCrc32, sizeof(expectedCrc32), digest.buffer, digest.len);
+
+            ASSERT_SUCCESS(aws_input_stream_seek(crcStream.GetUnderlyingStream(), 0, AWS_SSB_BEGIN));
+        }
+
+        /* skipping bytes would leave them out of the checksum */
+        ASSERT_FAILS(aws_input_stream_seek(crcStream.GetUnderlyingStream(), 2, AWS_SSB_BEGIN));
+
+        ASSERT_SUCCESS(aws_input_stream_seek(source->GetUnderlyingStream(), 0, AWS_SSB_BEGIN));
+        Aws::Crt::Io::ChecksumInputStream crccStream(source, Aws::Crt::Io::StreamChecksumAlgorithm::Crc32c, allocator);
+        ASSERT_SUCCESS(s_ReadAll(crccStream, contents));
+        aws_byte_buf digest = aws_byte_buf_from_empty_array(digestStorage, sizeof(digestStorage));
+        ASSERT_TRUE(crccStream.Digest(digest));
+        ASSERT_BIN_ARRAYS_EQUALS(expectedCrc32c, sizeof(expectedCrc32c), digest.buffer, digest.len);
+
+        ASSERT_SUCCESS(aws_input_stream_seek(source->GetUnderlyingStream(), 0, AWS_SSB_BEGIN));
+        Aws::Crt::Io::ChecksumInputStream shaStream(source, Aws::Crt::Io::StreamChecksumAlgorithm::Sha256, allocator);
+        ASSERT_TRUE(static_cast<bool>(shaStream));
+        ASSERT_SUCCESS(s_ReadAll(shaStream, contents));
+        digest = aws_byte_buf_from_empty_array(digestStorage, sizeof(digestStorage));
+        ASSERT_TRUE(shaStream.Digest(digest));
+        ASSERT_BIN_ARRAYS_EQUALS(expectedSha256, sizeof(expectedSha256), digest.buffer, digest.len);
+
+        /* the hash is spent until the stream is rewound */
+        digest.len = 0;
+        ASSERT_FALSE(shaStream.Digest(digest));
+        ASSERT_INT_EQUALS(AWS_ERROR_INVALID_STATE, shaStream.LastError());
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(StreamTestChecksumInputStream, s_StreamTestChecksumInputStream)
+
+static int s_StreamTestThrottledInputStream(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        /* a slow enough rate that nothing is earned back while the test runs */
+        auto bucket = Aws::Crt::MakeShared<Aws::Crt::Io::TokenBucket>(allocator, 1, 5);
+        ASSERT_UINT_EQUALS(1, bucket->GetRate());
+
+        auto source = Aws::Crt::MakeShared<Aws::Crt::Io::ByteCursorInputStream>(
+            allocator, Aws::Crt::ByteCursorFromCString(STREAM_CONTENTS), allocator);
+        Aws::Crt::Io::ThrottledInputStream throttledStream(source, bucket, allocator);
+        ASSERT_TRUE(static_cast<bool>(throttledStream));
+
+        int64_t length = 0;
+        ASSERT_SUCCESS(aws_input_stream_get_length(throttledStream.GetUnderlyingStream(), &length));
+        ASSERT_TRUE(length == (int64_t)strlen(STREAM_CONTENTS));
+
+        uint8_t storage[64];
+        aws_byte_buf buffer = aws_byte_buf_from_empty_array(storage, sizeof(storage));
+        aws_stream_status status;
+        AWS_ZERO_STRUCT(status);
+
+        /* the burst goes out right away */
+        ASSERT_SUCCESS(aws_input_stream_read(throttledStream.GetUnderlyingStream(), &buffer));
+        ASSERT_BIN_ARRAYS_EQUALS(STREAM_CONTENTS, 5, buffer.buffer, buffer.len);
+
+        /* then reads come back empty, rather than blocking, until tokens are earned */
+        ASSERT_SUCCESS(aws_input_stream_read(throttledStream.GetUnderlyingStream(), &buffer));
+        ASSERT_UINT_EQUALS(5, buffer.len);
+        ASSERT_SUCCESS(aws_input_stream_get_status(throttledStream.GetUnderlyingStream(), &status));
+        ASSERT_TRUE(status.is_valid);
+        ASSERT_FALSE(status.is_end_of_stream);
+        ASSERT_TRUE(bucket->GetDelayNs(1) > 0);
+
+        /* raising the rate lets the rest through */
+        bucket->SetRate(1024 * 1024 * 1024, 64);
+        while (!status.is_end_of_stream)
+        {
+            ASSERT_SUCCESS(aws_input_stream_read(throttledStream.GetUnderlyingStream(), &buffer));
+            ASSERT_SUCCESS(aws_input_stream_get_status(throttledStream.GetUnderlyingStream(), &status));
+        }
+        ASSERT_BIN_ARRAYS_EQUALS(STREAM_CONTENTS, strlen(STREAM_CONTENTS), buffer.buffer, buffer.len);
+
+        /* a read that comes up short gives back the tokens it did not use */
+        ASSERT_SUCCESS(aws_input_stream_seek(throttledStream.GetUnderlyingStream(), END_SEEK_OFFSET, AWS_SSB_END));
+        bucket->SetRate(1, 64);
+        buffer.len = 0;
+        ASSERT_SUCCESS(aws_input_stream_read(throttledStream.GetUnderlyingStream(), &buffer));
+        ASSERT_UINT_EQUALS((size_t)-END_SEEK_OFFSET, buffer.len);
+        ASSERT_UINT_EQUALS(64 - buffer.len, bucket->TryAcquire(64));
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(StreamTestThrottledInputStream, s_StreamTestThrottledInputStream)
+
+/* Hands out STREAM_CONTENTS at most three bytes at a time, like a slow network or decompressing source. */
+class TrickleInputStream : public Aws::Crt::Io::InputStream
+{
+  public:
+    explicit TrickleInputStream(struct aws_allocator *allocator) : InputStream(allocator), m_position(0), m_reads(0) {}
+
+    bool IsValid() const noexcept override { return true; }
+
+    size_t GetReadCount() const noexcept { return m_reads; }
+
+  protected:
+    bool ReadImpl(Aws::Crt::ByteBuf &buffer) noexcept override
+    {
+        ++m_reads;
+        size_t remaining = strlen(STREAM_CONTENTS) - m_position;
+        size_t toRead = buffer.capacity - buffer.len;
+        toRead = toRead < remaining ? toRead : remaining;
+        toRead = toRead < 3 ? toRead : 3;
+        memcpy(buffer.buffer + buffer.len, STREAM_CONTENTS + m_position, toRead);
+        buffer.len += toRead;
+        m_position += toRead;
+        return true;
+    }
+
+    Aws::Crt::Io::StreamStatus GetStatusImpl() const noexcept override
+    {
+        Aws::Crt::Io::StreamStatus status;
+        status.is_valid = true;
+        status.is_end_of_stream = m_position == strlen(STREAM_CONTENTS);
+        return status;
+    }
+
+    int64_t GetLengthImpl() const noexcept override { return (int64_t)strlen(STREAM_CONTENTS); }
+
+    bool SeekImpl(Aws::Crt::Io::OffsetType offset, Aws::Crt::Io::StreamSeekBasis seekBasis) noexcept override
+    {
+        int64_t position = 0;
+        if (!ResolveSeekPosition(offset, seekBasis, GetLengthImpl(), position))
+        {
+            return false;
+        }
+        m_position = (size_t)position;
+        return true;
+    }
+
+  private:
+    size_t m_position;
+    std::atomic<size_t> m_reads;
+};
+
+static int s_StreamTestReadAheadInputStream(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        for (bool prefetch : {false, true})
+        {
+            auto source = Aws::Crt::MakeShared<TrickleInputStream>(allocator, allocator);
+            Aws::Crt::Io::ReadAheadInputStream readAheadStream(source, 8, prefetch, allocator);
+            ASSERT_TRUE(static_cast<bool>(readAheadStream));
+            ASSERT_UINT_EQUALS(8, readAheadStream.GetBlockSize());
+
+            int64_t length = 0;
+            ASSERT_SUCCESS(aws_input_stream_get_length(readAheadStream.GetUnderlyingStream(), &length));
+            ASSERT_TRUE(length == (int64_t)strlen(STREAM_CONTENTS));
+
+            /* a whole block is gathered however small the source's reads are */
+            uint8_t storage[16];
+            aws_byte_buf buffer = aws_byte_buf_from_empty_array(storage, 8);
+            ASSERT_SUCCESS(aws_input_stream_read(readAheadStream.GetUnderlyingStream(), &buffer));
+            ASSERT_BIN_ARRAYS_EQUALS(STREAM_CONTENTS, 8, buffer.buffer, buffer.len);
+
+            Aws::Crt::String contents;
+            ASSERT_SUCCESS(s_ReadAll(readAheadStream, contents));
+            ASSERT_STR_EQUALS(STREAM_CONTENTS + 8, contents.c_str());
+
+            /* rewinding discards whatever was read ahead */
+            ASSERT_SUCCESS(aws_input_stream_seek(readAheadStream.GetUnderlyingStream(), 2, AWS_SSB_BEGIN));
+            ASSERT_SUCCESS(s_ReadAll(readAheadStream, contents));
+            ASSERT_STR_EQUALS(STREAM_CONTENTS + 2, contents.c_str());
+            ASSERT_TRUE(source->GetReadCount() >= 8);
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(StreamTestReadAheadInputStream, s_StreamTestReadAheadInputStream)
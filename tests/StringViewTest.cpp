@@ -6,6 +6,9 @@
 #include <aws/crt/Types.h>
 #include <aws/testing/aws_test_harness.h>
 
+#include <map>
+#include <unordered_map>
+
 static int s_test_string_view(struct aws_allocator *allocator, void *ctx)
 {
     (void)ctx;
@@ -123,3 +126,61 @@ static int s_test_string_view(struct aws_allocator *allocator, void *ctx)
 }
 
 AWS_TEST_CASE(StringViewTest, s_test_string_view)
+
+static int s_test_string_view_case_insensitive(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::StringView lower("content-type");
+        Aws::Crt::StringView mixed("Content-Type");
+
+        // test hashes
+        {
+            ASSERT_UINT_EQUALS(14695981039346656037ULL, Aws::Crt::HashStringView(Aws::Crt::StringView()));
+            ASSERT_TRUE(Aws::Crt::HashStringView(lower) != Aws::Crt::HashStringView(mixed));
+            ASSERT_UINT_EQUALS(Aws::Crt::HashStringView(lower), Aws::Crt::HashStringViewCaseInsensitive(mixed));
+            ASSERT_UINT_EQUALS(
+                Aws::Crt::HashStringViewCaseInsensitive(lower), Aws::Crt::HashStringViewCaseInsensitive(mixed));
+        }
+
+        // test comparison
+        {
+            ASSERT_TRUE(Aws::Crt::EqualsCaseInsensitive(lower, mixed));
+            ASSERT_FALSE(Aws::Crt::EqualsCaseInsensitive(lower, Aws::Crt::StringView("content-typ")));
+            ASSERT_INT_EQUALS(0, Aws::Crt::CompareCaseInsensitive(lower, mixed));
+            ASSERT_TRUE(Aws::Crt::CompareCaseInsensitive(Aws::Crt::StringView("ABC"), Aws::Crt::StringView("abd")) < 0);
+            ASSERT_TRUE(Aws::Crt::CompareCaseInsensitive(Aws::Crt::StringView("abc"), Aws::Crt::StringView("AB")) > 0);
+        }
+
+        // test lookup without building a key
+        {
+            std::unordered_map<Aws::Crt::StringView, int, Aws::Crt::StringViewHash, Aws::Crt::StringViewEqual> topics;
+            topics[Aws::Crt::StringView("a/b")] = 1;
+            const char *data = "a/b/c";
+            ASSERT_UINT_EQUALS(1u, topics.count(Aws::Crt::StringView(data, 3)));
+            ASSERT_UINT_EQUALS(0u, topics.count(Aws::Crt::StringView(data, 5)));
+
+            std::unordered_map<
+                Aws::Crt::String,
+                int,
+                Aws::Crt::StringViewCaseInsensitiveHash,
+                Aws::Crt::StringViewCaseInsensitiveEqual>
+                headers;
+            headers["Content-Type"] = 2;
+            ASSERT_UINT_EQUALS(1u, headers.count("content-type"));
+            ASSERT_INT_EQUALS(2, headers["CONTENT-TYPE"]);
+
+            std::map<Aws::Crt::String, int, Aws::Crt::StringViewCaseInsensitiveLess> ordered;
+            ordered["Host"] = 3;
+            ordered["accept"] = 4;
+            ASSERT_UINT_EQUALS(1u, ordered.count("HOST"));
+            ASSERT_TRUE(ordered.begin()->first == "accept");
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(StringViewCaseInsensitive, s_test_string_view_case_insensitive)
@@ -5,6 +5,8 @@
 #include <aws/crt/Api.h>
 
 #include <aws/testing/aws_test_harness.h>
+
+#include <chrono>
 #include <utility>
 #if !BYO_CRYPTO
 static int s_TestTLSContextResourceSafety(Aws::Crt::Allocator *allocator, void *ctx)
@@ -50,4 +52,117 @@ static int s_TestTLSContextUninitializedNewConnectionOptions(Aws::Crt::Allocator
 }
 
 AWS_TEST_CASE(TLSContextUninitializedNewConnectionOptions, s_TestTLSContextUninitializedNewConnectionOptions)
+
+static int s_TestTLSContextGetOrCreateShared(Aws::Crt::Allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+        Aws::Crt::Io::TlsContextOptions tlsCtxOptions = Aws::Crt::Io::TlsContextOptions::InitDefaultClient();
+        Aws::Crt::Io::TlsContextOptions sameTlsCtxOptions = Aws::Crt::Io::TlsContextOptions::InitDefaultClient();
+        Aws::Crt::Io::TlsContextOptions alpnTlsCtxOptions = Aws::Crt::Io::TlsContextOptions::InitDefaultClient();
+        alpnTlsCtxOptions.SetAlpnList("h2;http/1.1");
+
+        auto tlsContext =
+            Aws::Crt::Io::TlsContext::GetOrCreate(tlsCtxOptions, Aws::Crt::Io::TlsMode::CLIENT, allocator);
+        ASSERT_TRUE(tlsContext);
+
+        /* identical options share the context, others get their own */
+        auto sameTlsContext =
+            Aws::Crt::Io::TlsContext::GetOrCreate(sameTlsCtxOptions, Aws::Crt::Io::TlsMode::CLIENT, allocator);
+        ASSERT_TRUE(sameTlsContext);
+        ASSERT_PTR_EQUALS(tlsContext.GetUnderlyingHandle(), sameTlsContext.GetUnderlyingHandle());
+
+        auto alpnTlsContext =
+            Aws::Crt::Io::TlsContext::GetOrCreate(alpnTlsCtxOptions, Aws::Crt::Io::TlsMode::CLIENT, allocator);
+        ASSERT_TRUE(alpnTlsContext);
+        ASSERT_FALSE(tlsContext.GetUnderlyingHandle() == alpnTlsContext.GetUnderlyingHandle());
+
+        auto tlsConnectionOptions = sameTlsContext.NewConnectionOptions();
+        ASSERT_TRUE(tlsConnectionOptions);
+
+        /* the cache does not keep contexts alive, and can be cleared while they are in use */
+        Aws::Crt::Io::TlsContext::ClearCache();
+        auto rebuiltTlsContext =
+            Aws::Crt::Io::TlsContext::GetOrCreate(tlsCtxOptions, Aws::Crt::Io::TlsMode::CLIENT, allocator);
+        ASSERT_TRUE(rebuiltTlsContext);
+        ASSERT_FALSE(tlsContext.GetUnderlyingHandle() == rebuiltTlsContext.GetUnderlyingHandle());
+        ASSERT_TRUE(tlsContext);
+    }
+
+    return AWS_ERROR_SUCCESS;
+}
+
+AWS_TEST_CASE(TLSContextGetOrCreateShared, s_TestTLSContextGetOrCreateShared)
 #endif // !BYO_CRYPTO
+
+static int s_TestTLSSessionCache(Aws::Crt::Allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::Io::TlsSessionCacheOptions cacheOptions;
+        cacheOptions.MaxEntries = 2;
+        auto cache = Aws::Crt::MakeShared<Aws::Crt::Io::TlsSessionCache>(allocator, cacheOptions);
+
+        Aws::Crt::ByteBuf session;
+        ASSERT_SUCCESS(aws_byte_buf_init(&session, allocator, 0));
+        ASSERT_FALSE(cache->Retrieve("a.example.com", session));
+
+        cache->Store("a.example.com", Aws::Crt::ByteCursorFromCString("session-a"));
+        cache->Store("b.example.com", Aws::Crt::ByteCursorFromCString("session-b"));
+        ASSERT_TRUE(cache->Retrieve("a.example.com", session));
+        ASSERT_BIN_ARRAYS_EQUALS("session-a", 9, session.buffer, session.len);
+
+        /* a was used last, so b is the one evicted */
+        cache->Store("c.example.com", Aws::Crt::ByteCursorFromCString("session-c"));
+        ASSERT_UINT_EQUALS(2, cache->GetSize());
+        session.len = 0;
+        ASSERT_FALSE(cache->Retrieve("b.example.com", session));
+        ASSERT_TRUE(cache->Retrieve("a.example.com", session));
+        ASSERT_TRUE(cache->Retrieve("c.example.com", session));
+        ASSERT_BIN_ARRAYS_EQUALS("session-asession-c", 18, session.buffer, session.len);
+
+        /* storing again replaces the session */
+        cache->Store("c.example.com", Aws::Crt::ByteCursorFromCString("session-c2"));
+        session.len = 0;
+        ASSERT_TRUE(cache->Retrieve("c.example.com", session));
+        ASSERT_BIN_ARRAYS_EQUALS("session-c2", 10, session.buffer, session.len);
+
+        cache->Remove("c.example.com");
+        ASSERT_FALSE(cache->Retrieve("c.example.com", session));
+
+        Aws::Crt::Io::TlsSessionCacheStatistics statistics = cache->GetStatistics();
+        ASSERT_UINT_EQUALS(4, statistics.Stores);
+        ASSERT_UINT_EQUALS(4, statistics.Hits);
+        ASSERT_UINT_EQUALS(3, statistics.Misses);
+        ASSERT_UINT_EQUALS(1, statistics.Evictions);
+
+        cache->Clear();
+        ASSERT_UINT_EQUALS(0, cache->GetSize());
+
+        /* sessions do not outlive the configured lifetime */
+        cacheOptions.SessionLifetime = std::chrono::seconds(0);
+        Aws::Crt::Io::TlsSessionCache expiringCache(cacheOptions);
+        expiringCache.Store("a.example.com", Aws::Crt::ByteCursorFromCString("session-a"));
+        ASSERT_FALSE(expiringCache.Retrieve("a.example.com", session));
+        ASSERT_UINT_EQUALS(0, expiringCache.GetSize());
+
+        /* the cache moves with the options, where there is a TLS implementation that uses it */
+        Aws::Crt::Io::TlsContextOptions tlsCtxOptions;
+        tlsCtxOptions.SetSessionCache(cache);
+        Aws::Crt::Io::TlsContextOptions movedOptions = std::move(tlsCtxOptions);
+#if BYO_CRYPTO
+        ASSERT_PTR_EQUALS(cache.get(), movedOptions.GetSessionCache().get());
+#else
+        ASSERT_NULL(movedOptions.GetSessionCache().get());
+#endif
+
+        aws_byte_buf_clean_up(&session);
+    }
+
+    return AWS_ERROR_SUCCESS;
+}
+
+AWS_TEST_CASE(TLSSessionCache, s_TestTLSSessionCache)
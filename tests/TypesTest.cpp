@@ -32,6 +32,47 @@ static int s_base64_round_trip(struct aws_allocator *allocator, void *ctx)
 
 AWS_TEST_CASE(Base64RoundTrip, s_base64_round_trip)
 
+static int s_base64_round_trip_into_buffer(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::String test_data = "foobar";
+        Aws::Crt::String expected = "Zm9vYmFy";
+
+        size_t encodedLength = 0;
+        ASSERT_TRUE(Aws::Crt::Base64ComputeEncodedLength(test_data.size(), encodedLength));
+
+        uint8_t encodedStorage[32];
+        ASSERT_TRUE(encodedLength <= sizeof(encodedStorage));
+        Aws::Crt::ByteBuf encoded = Aws::Crt::ByteBufFromEmptyArray(encodedStorage, encodedLength);
+        ASSERT_TRUE(Aws::Crt::Base64Encode(Aws::Crt::ByteCursorFromString(test_data), encoded));
+        ASSERT_BIN_ARRAYS_EQUALS(expected.data(), expected.size(), encoded.buffer, encoded.len);
+
+        Aws::Crt::ByteCursor encodedCursor = Aws::Crt::ByteCursorFromByteBuf(encoded);
+        size_t decodedLength = 0;
+        ASSERT_TRUE(Aws::Crt::Base64ComputeDecodedLength(encodedCursor, decodedLength));
+        ASSERT_UINT_EQUALS(test_data.size(), decodedLength);
+
+        /* decoding appends after whatever is already in the buffer */
+        uint8_t decodedStorage[16] = {'>'};
+        Aws::Crt::ByteBuf decoded = Aws::Crt::ByteBufFromEmptyArray(decodedStorage, sizeof(decodedStorage));
+        decoded.len = 1;
+        ASSERT_TRUE(Aws::Crt::Base64Decode(encodedCursor, decoded));
+        Aws::Crt::String expectedDecoded = ">" + test_data;
+        ASSERT_BIN_ARRAYS_EQUALS(expectedDecoded.data(), expectedDecoded.size(), decoded.buffer, decoded.len);
+
+        Aws::Crt::ByteBuf tooSmall = Aws::Crt::ByteBufFromEmptyArray(decodedStorage, 2);
+        ASSERT_FALSE(Aws::Crt::Base64Decode(encodedCursor, tooSmall));
+        ASSERT_UINT_EQUALS(0, tooSmall.len);
+    }
+
+    return 0;
+}
+
+AWS_TEST_CASE(Base64RoundTripIntoBuffer, s_base64_round_trip_into_buffer)
+
 static int s_int_array_list_to_vector(struct aws_allocator *allocator, void *ctx)
 {
     (void)ctx;
@@ -119,3 +160,155 @@ static int s_byte_cursor_array_list_to_vector(struct aws_allocator *allocator, v
 }
 
 AWS_TEST_CASE(TestByteCursorArrayListToVector, s_byte_cursor_array_list_to_vector)
+
+static int s_array_list_view(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+        int values[] = {1, 2, 3, 4, 5};
+        aws_array_list intList;
+        aws_array_list_init_static(&intList, values, 5, sizeof(int));
+        intList.length = 5;
+
+        Aws::Crt::ArrayListView<int> view(&intList);
+        ASSERT_UINT_EQUALS(5u, view.size());
+        ASSERT_PTR_EQUALS(values, view.data());
+
+        int sum = 0;
+        for (int value : view)
+        {
+            sum += value;
+        }
+        ASSERT_INT_EQUALS(15, sum);
+        ASSERT_INT_EQUALS(4, view[3]);
+
+        Aws::Crt::Vector<Aws::Crt::String> strings =
+            Aws::Crt::ArrayListToVector<int, Aws::Crt::String>(&intList, [](int value) {
+                return Aws::Crt::String(static_cast<size_t>(value), 'x');
+            });
+        ASSERT_UINT_EQUALS(5u, strings.size());
+        ASSERT_UINT_EQUALS(3u, strings[2].size());
+
+        Aws::Crt::ArrayListView<int> empty(nullptr);
+        ASSERT_TRUE(empty.empty());
+        ASSERT_TRUE(empty.begin() == empty.end());
+    }
+
+    return 0;
+}
+
+AWS_TEST_CASE(TestArrayListView, s_array_list_view)
+
+static int s_TestFunctionInlineAndHeapStorage(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        int calls = 0;
+        Aws::Crt::Function<int(int)> small = [&calls](int value) {
+            ++calls;
+            return value + 1;
+        };
+        Aws::Crt::Function<int(int)> smallCopy = small;
+        ASSERT_INT_EQUALS(2, small(1));
+        ASSERT_INT_EQUALS(3, smallCopy(2));
+        ASSERT_INT_EQUALS(2, calls);
+
+        uint8_t padding[Aws::Crt::Function<int(int)>::InlineSize * 2] = {7};
+        Aws::Crt::Function<int(int)> large([padding](int value) { return value + padding[0]; }, allocator);
+        Aws::Crt::Function<int(int)> largeCopy = large;
+        Aws::Crt::Function<int(int)> largeMoved = std::move(large);
+        ASSERT_FALSE(large);
+        ASSERT_INT_EQUALS(8, largeCopy(1));
+        ASSERT_INT_EQUALS(9, largeMoved(2));
+
+        Aws::Crt::Function<void()> empty = std::function<void()>();
+        ASSERT_FALSE(empty);
+        ASSERT_TRUE(empty == nullptr);
+        empty = [&calls]() { ++calls; };
+        empty();
+        ASSERT_INT_EQUALS(3, calls);
+        empty = nullptr;
+        ASSERT_FALSE(empty);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(FunctionInlineAndHeapStorage, s_TestFunctionInlineAndHeapStorage)
+
+static int s_TestFunctionMoveOnlyCallable(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        struct MoveOnlyCallable
+        {
+            std::unique_ptr<int> value;
+            int operator()() const { return *value; }
+        };
+
+        /* a copyable Function must reject the callable up front instead of failing when copied */
+        static_assert(!std::is_constructible<Aws::Crt::Function<int()>, MoveOnlyCallable>::value, "");
+
+        MoveOnlyCallable callable{std::unique_ptr<int>(new int(42))};
+        Aws::Crt::MoveOnlyFunction<int()> function(std::move(callable));
+        Aws::Crt::MoveOnlyFunction<int()> moved(std::move(function));
+        ASSERT_FALSE(function);
+        ASSERT_INT_EQUALS(42, moved());
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(FunctionMoveOnlyCallable, s_TestFunctionMoveOnlyCallable)
+
+static int s_TestSmallVectorInlineAndSpill(struct aws_allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+
+        Aws::Crt::SmallVector<Aws::Crt::String, 4> strings(allocator);
+        strings.push_back("a");
+        strings.emplace_back("b");
+        strings.push_back(strings[0]);
+        ASSERT_TRUE(strings.IsInline());
+        ASSERT_UINT_EQUALS(3u, strings.size());
+
+        Aws::Crt::SmallVector<Aws::Crt::String, 4> inlineMoved(std::move(strings));
+        ASSERT_TRUE(strings.empty());
+        ASSERT_TRUE(inlineMoved.IsInline());
+        ASSERT_TRUE(inlineMoved[2] == "a");
+
+        for (int i = 0; i < 10; ++i)
+        {
+            /* growing while pushing an element of the container itself must not read freed storage */
+            inlineMoved.push_back(inlineMoved.back());
+        }
+        ASSERT_FALSE(inlineMoved.IsInline());
+        ASSERT_UINT_EQUALS(13u, inlineMoved.size());
+        ASSERT_TRUE(inlineMoved.back() == "a");
+
+        const Aws::Crt::String *spilledData = inlineMoved.data();
+        Aws::Crt::SmallVector<Aws::Crt::String, 4> heapMoved(std::move(inlineMoved));
+        ASSERT_PTR_EQUALS(spilledData, heapMoved.data());
+        ASSERT_TRUE(inlineMoved.IsInline());
+
+        Aws::Crt::SmallVector<Aws::Crt::String, 4> copy = heapMoved;
+        ASSERT_UINT_EQUALS(13u, copy.size());
+        copy.resize(2);
+        ASSERT_TRUE(copy[1] == "b");
+
+        Aws::Crt::SmallVector<int, 2> ints = {1, 2, 3};
+        ASSERT_UINT_EQUALS(3u, ints.size());
+        ASSERT_INT_EQUALS(3, ints.back());
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(SmallVectorInlineAndSpill, s_TestSmallVectorInlineAndSpill)
@@ -9,6 +9,7 @@
 #include <aws/testing/aws_test_harness.h>
 
 #include <iostream>
+#include <set>
 #include <utility>
 
 static int s_UUIDToString(Aws::Crt::Allocator *allocator, void *ctx)
@@ -26,3 +27,46 @@ static int s_UUIDToString(Aws::Crt::Allocator *allocator, void *ctx)
 }
 
 AWS_TEST_CASE(UUIDToString, s_UUIDToString)
+
+static int s_UUIDGeneratorBulk(Aws::Crt::Allocator *allocator, void *ctx)
+{
+    (void)ctx;
+    {
+        Aws::Crt::ApiHandle apiHandle(allocator);
+        Aws::Crt::UUIDGenerator generator;
+
+        /* more than one block of randomness */
+        const size_t count = 3 * Aws::Crt::UUIDGenerator::RandomBlockSize / 16 + 7;
+        Aws::Crt::Vector<char> strings(count * Aws::Crt::UUIDGenerator::StringLength);
+        ASSERT_TRUE(generator.Generate(strings.data(), count));
+
+        std::set<Aws::Crt::String> seen;
+        for (size_t i = 0; i < count; ++i)
+        {
+            Aws::Crt::String uuidStr(
+                strings.data() + i * Aws::Crt::UUIDGenerator::StringLength, Aws::Crt::UUIDGenerator::StringLength);
+            ASSERT_TRUE(uuidStr[8] == '-' && uuidStr[13] == '-' && uuidStr[18] == '-' && uuidStr[23] == '-');
+            ASSERT_TRUE(uuidStr[14] == '4');
+            ASSERT_TRUE(uuidStr[19] == '8' || uuidStr[19] == '9' || uuidStr[19] == 'a' || uuidStr[19] == 'b');
+
+            /* formats the same as aws_uuid_to_str() */
+            Aws::Crt::UUID parsed(uuidStr);
+            ASSERT_TRUE(parsed);
+            ASSERT_TRUE(uuidStr == parsed.ToString());
+            ASSERT_TRUE(seen.insert(uuidStr).second);
+        }
+
+        aws_uuid uuid;
+        ASSERT_TRUE(generator.Generate(uuid));
+        char formatted[Aws::Crt::UUIDGenerator::StringLength];
+        Aws::Crt::UUIDGenerator::Format(uuid, formatted);
+        uint8_t expected[AWS_UUID_STR_LEN];
+        Aws::Crt::ByteBuf expectedBuf = Aws::Crt::ByteBufFromEmptyArray(expected, sizeof(expected));
+        ASSERT_SUCCESS(aws_uuid_to_str(&uuid, &expectedBuf));
+        ASSERT_BIN_ARRAYS_EQUALS(expectedBuf.buffer, expectedBuf.len, formatted, sizeof(formatted));
+    }
+
+    return AWS_ERROR_SUCCESS;
+}
+
+AWS_TEST_CASE(UUIDGeneratorBulk, s_UUIDGeneratorBulk)